@@ -0,0 +1,215 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_amplifier.c
+ * Description:  host test of the gain, mute and ramps of arm_stream_amplifier
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    Checks of arm_stream_amplifier_process :
+    - a linear ramp of 100 frames reaches its targets exactly and is monotonic
+    - saturation of S16 and S32
+    - exponential mute and unmute of FP32 end on 0 and 1.0
+    - constant gains of 8 channels equal to a per-sample baseline, which dispatches on the
+      format and indexes the gain by channel as a script would
+    Then the TSC cycles per sample, stereo, 960 samples, of the constant gains, of a ramp
+    and of the baseline (fastest of 200 calls). Returns the number of failed checks.
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/arm/amplifier \
+        stream_make/computer/stream_test/bench_amplifier.c \
+        stream_nodes/arm/amplifier/arm_stream_amplifier_process.c -o bench_amplifier
+    ./bench_amplifier
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_amplifier.h"
+
+#define N 960
+
+static arm_amplifier_memory TCM;
+static arm_amplifier_instance instance;
+static int16_t x16[N], y16[N];
+static int32_t x32[N], y32[N];
+static float xf[N], yf[N];
+static uint8_t ref[N * 4];
+
+static void setup (int raw, int nchan, int ramp_frames, int ramp_type, int exp_shift)
+{   int c;
+
+    memset(&instance, 0, sizeof(instance));
+    instance.TCM = &TCM;
+    instance.raw = (uint8_t)raw;
+    instance.nchan = (uint8_t)nchan;
+    for (c = 0; c < AMPLIFIER_MAX_NCHAN; c++)
+        instance.config.gain[c] = AMPLIFIER_UNITY;
+    instance.config.ramp_frames = (uint16_t)ramp_frames;
+    instance.config.ramp_type = (uint8_t)ramp_type;
+    instance.config.exp_shift = (uint8_t)exp_shift;
+    arm_stream_amplifier_init(&instance);
+}
+
+/* per sample, dispatch on the format, gain from a per-channel array */
+static void baseline (int raw, int nchan, void *in, void *out, int n, int32_t *gain)
+{   int64_t v;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {   if (raw == STREAM_S16)
+        {   v = ((int64_t)((int16_t *)in)[i] * gain[i % nchan] + 32768) >> 16;
+            ((int16_t *)out)[i] = (int16_t)((v > 32767) ? 32767 : (v < -32768) ? -32768 : v);
+        } else if (raw == STREAM_S32)
+        {   v = ((int64_t)((int32_t *)in)[i] * gain[i % nchan] + 32768) >> 16;
+            ((int32_t *)out)[i] = (int32_t)((v > 2147483647LL) ? 2147483647LL : (v < -2147483648LL) ? -2147483648LL : v);
+        } else
+            ((float *)out)[i] = ((float *)in)[i] * (gain[i % nchan] / 65536.f);
+    }
+}
+
+static int checks (void)
+{   static const int32_t gains[8] = { 40000, 70000, 12345, -65536, 65536 * 3, 100, 50000, 65535 };
+    static const int raws[3] = { STREAM_S16, STREAM_S32, STREAM_FP32 };
+    void *in, *out;
+    int i, f, k, r, err = 0;
+
+    /* linear ramp of 100 stereo frames, from 0dB to x2 and to 0 */
+    setup(STREAM_S16, 2, 100, AMPLIFIER_RAMP_LINEAR, 0);
+    for (i = 0; i < N; i++)
+        x16[i] = 10000;
+    instance.config.gain[0] = AMPLIFIER_UNITY * 2;
+    instance.config.gain[1] = 0;
+    arm_stream_amplifier_target(&instance);
+    arm_stream_amplifier_process(&instance, (uint8_t *)x16, (uint8_t *)y16, N);
+    printf("linear ramp : frame 99 %d %d, frame 100 %d %d, ramping %d\n", y16[198], y16[199], y16[200], y16[201], instance.ramping);
+    err += (y16[198] != 20000 || y16[199] != 0 || instance.ramping);
+    for (f = 1; f < 100; f++)
+        err += (y16[2 * f] < y16[2 * f - 2] || y16[2 * f + 1] > y16[2 * f - 1]);
+
+    /* saturation */
+    setup(STREAM_S16, 1, 0, AMPLIFIER_RAMP_LINEAR, 0);
+    instance.config.gain[0] = AMPLIFIER_UNITY * 4;
+    arm_stream_amplifier_target(&instance);
+    x16[0] = 20000; x16[1] = -20000;
+    arm_stream_amplifier_process(&instance, (uint8_t *)x16, (uint8_t *)y16, 2);
+    setup(STREAM_S32, 1, 0, AMPLIFIER_RAMP_LINEAR, 0);
+    instance.config.gain[0] = AMPLIFIER_UNITY * 4;
+    arm_stream_amplifier_target(&instance);
+    x32[0] = 1 << 30; x32[1] = -(1 << 30);
+    arm_stream_amplifier_process(&instance, (uint8_t *)x32, (uint8_t *)y32, 2);
+    printf("saturation : S16 %d %d, S32 %d %d\n", y16[0], y16[1], y32[0], y32[1]);
+    err += (y16[0] != 32767 || y16[1] != -32768 || y32[0] != 2147483647 || y32[1] != (int32_t)0x80000000);
+
+    /* exponential mute and unmute */
+    setup(STREAM_FP32, 1, 0, AMPLIFIER_RAMP_EXP, 4);
+    for (i = 0; i < N; i++)
+        xf[i] = 1.f;
+    instance.config.mute = 1;
+    arm_stream_amplifier_target(&instance);
+    for (k = 0; k < 4; k++)
+        arm_stream_amplifier_process(&instance, (uint8_t *)xf, (uint8_t *)yf, N);
+    printf("muted : %g, ramping %d", yf[N - 1], instance.ramping);
+    err += (yf[N - 1] != 0 || instance.ramping);
+    instance.config.mute = 0;
+    arm_stream_amplifier_target(&instance);
+    for (k = 0; k < 4; k++)
+        arm_stream_amplifier_process(&instance, (uint8_t *)xf, (uint8_t *)yf, N);
+    printf(", unmuted : %g, ramping %d\n", yf[N - 1], instance.ramping);
+    err += (yf[N - 1] != 1.f || instance.ramping);
+
+    /* constant gains against the baseline */
+    for (i = 0; i < N; i++)
+    {   x16[i] = (int16_t)rand();
+        x32[i] = rand() * 2 - RAND_MAX;
+        xf[i] = rand() / (float)RAND_MAX - 0.5f;
+    }
+    for (r = 0; r < 3; r++)
+    {   setup(raws[r], 8, 0, AMPLIFIER_RAMP_LINEAR, 0);
+        memcpy(instance.config.gain, gains, sizeof(gains));
+        arm_stream_amplifier_target(&instance);
+        in = (r == 0) ? (void *)x16 : (r == 1) ? (void *)x32 : (void *)xf;
+        out = (r == 0) ? (void *)y16 : (r == 1) ? (void *)y32 : (void *)yf;
+        arm_stream_amplifier_process(&instance, in, out, N);
+        arm_stream_amplifier_process(&instance, in, out, N);
+        baseline(raws[r], 8, in, ref, N, (int32_t *)gains);
+        if (memcmp(ref, out, N * ((r == 0) ? 2 : 4)))
+        {   printf("format %d : constant gains different from the baseline\n", raws[r]);
+            err++;
+        }
+    }
+    return err;
+}
+
+static void timing (void)
+{   static const int raws[3] = { STREAM_S16, STREAM_S32, STREAM_FP32 };
+    static const char *names[3] = { "q15", "q31", "f32" };
+    int32_t gains[2] = { 50000, 70000 };
+    unsigned long long t0, best[3];
+    void *in, *out;
+    int r, rep;
+
+    for (r = 0; r < 3; r++)
+    {   in = (r == 0) ? (void *)x16 : (r == 1) ? (void *)x32 : (void *)xf;
+        out = (r == 0) ? (void *)y16 : (r == 1) ? (void *)y32 : (void *)yf;
+        best[0] = best[1] = best[2] = ~0ull;
+        for (rep = 0; rep < 200; rep++)
+        {   setup(raws[r], 2, 0, AMPLIFIER_RAMP_LINEAR, 0);
+            instance.config.gain[0] = gains[0];
+            instance.config.gain[1] = gains[1];
+            arm_stream_amplifier_target(&instance);
+            arm_stream_amplifier_process(&instance, in, out, N);
+            t0 = __rdtsc();
+            arm_stream_amplifier_process(&instance, in, out, N);
+            t0 = __rdtsc() - t0;
+            if (t0 < best[0]) best[0] = t0;
+
+            instance.config.ramp_frames = 60000;
+            instance.config.gain[0] = 20000;
+            arm_stream_amplifier_target(&instance);
+            t0 = __rdtsc();
+            arm_stream_amplifier_process(&instance, in, out, N);
+            t0 = __rdtsc() - t0;
+            if (t0 < best[1]) best[1] = t0;
+
+            t0 = __rdtsc();
+            baseline(raws[r], 2, in, out, N, gains);
+            t0 = __rdtsc() - t0;
+            if (t0 < best[2]) best[2] = t0;
+        }
+        printf("%s stereo : constant %.2f, ramp %.2f, baseline %.2f cycles per sample\n",
+            names[r], best[0] / (double)N, best[1] / (double)N, best[2] / (double)N);
+    }
+}
+
+int main (void)
+{   int err = checks();
+
+    timing();
+    printf(err ? "%d checks failed\n" : "checks passed\n", err);
+    return err;
+}
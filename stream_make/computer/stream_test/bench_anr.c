@@ -0,0 +1,208 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_anr.c
+ * Description:  host benchmark of the speex noise reduction of arm_stream_anr
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    2000 frames of 256 samples at 16kHz (tones gated at 1.3Hz in white noise) are given to
+    speex_preprocess_run. Prints the heap used by the instance, the median TSC cycles per
+    frame outside the FFT (scaled to 10ms), and the best cycles of the filterbank functions.
+    With a file name argument the denoised samples are written to the file, to compare two
+    versions of the sources (cmp -l), the former one built from a git worktree with the same
+    command line.
+
+    The CMSIS twiddle tables are not in the tree : arm_rfft_fast_f32 is replaced here by a
+    radix-2 FFT with the same packed format {DC, Nyquist, re1, im1 ..}, the inverse scaled
+    by 1/N, and its cycles are removed from the measurements.
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O2 -D__GNUC_PYTHON__ -Istream_nodes/arm/anr/speexdsp \
+        -Istream_nodes/arm/anr/speexdsp/Include -Istream_nodes/arm/anr/speexdsp/PrivateInclude \
+        stream_make/computer/stream_test/bench_anr.c \
+        stream_nodes/arm/anr/speexdsp/preprocess.c stream_nodes/arm/anr/speexdsp/filterbank.c \
+        stream_nodes/arm/anr/speexdsp/fftwrap.c -lm -o bench_anr
+    ./bench_anr denoised.raw
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+#include "Include/arm_math.h"
+#include "speex_preprocess.h"
+#include "filterbank.h"
+
+#define FS 16000
+#define FRAME 256
+#define NFRAMES 2000
+#define MAXFFT 1024
+
+static uint64_t fft_cycles;
+static intptr_t heap[60000 / sizeof(intptr_t)];
+static int16_t x[NFRAMES * FRAME];
+static uint64_t cycles[NFRAMES];
+
+static void cfft (float *re, float *im, int n, int inverse)
+{   int i, j, b, len, k, p, q;
+    float t, wr, wi, cr, ci, tr, ti, nr;
+    double a;
+
+    for (i = 1, j = 0; i < n; i++)
+    {   for (b = n >> 1; j & b; b >>= 1)
+            j ^= b;
+        j ^= b;
+        if (i < j)
+        {   t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (len = 2; len <= n; len <<= 1)
+    {   a = 2 * M_PI / len * (inverse ? 1 : -1);
+        wr = (float)cos(a);
+        wi = (float)sin(a);
+        for (i = 0; i < n; i += len)
+        {   cr = 1; ci = 0;
+            for (k = 0; k < len / 2; k++)
+            {   p = i + k; q = p + len / 2;
+                tr = re[q] * cr - im[q] * ci;
+                ti = re[q] * ci + im[q] * cr;
+                re[q] = re[p] - tr; im[q] = im[p] - ti;
+                re[p] += tr;        im[p] += ti;
+                nr = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = nr;
+            }
+        }
+    }
+}
+
+arm_status arm_rfft_fast_init_f32 (arm_rfft_fast_instance_f32 *S, uint16_t fftLen)
+{   S->fftLenRFFT = fftLen;
+    return ARM_MATH_SUCCESS;
+}
+
+/* same contract as CMSIS : packed format, inverse scaled by 1/N, the input is destroyed */
+void arm_rfft_fast_f32 (const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag)
+{   static float re[MAXFFT], im[MAXFFT];
+    uint64_t t0 = __rdtsc();
+    int n = S->fftLenRFFT, i, k;
+
+    if (ifftFlag == 0)
+    {   for (i = 0; i < n; i++)
+        {   re[i] = p[i]; im[i] = 0;
+        }
+        cfft(re, im, n, 0);
+        pOut[0] = re[0];
+        pOut[1] = re[n / 2];
+        for (k = 1; k < n / 2; k++)
+        {   pOut[2 * k] = re[k]; pOut[2 * k + 1] = im[k];
+        }
+    } else
+    {   re[0] = p[0];     im[0] = 0;
+        re[n / 2] = p[1]; im[n / 2] = 0;
+        for (k = 1; k < n / 2; k++)
+        {   re[k] = p[2 * k];     im[k] = p[2 * k + 1];
+            re[n - k] = p[2 * k]; im[n - k] = -p[2 * k + 1];
+        }
+        cfft(re, im, n, 1);
+        for (i = 0; i < n; i++)
+            pOut[i] = re[i] / n;
+    }
+    for (i = 0; i < n; i++)
+        p[i] = 1e30f;
+    fft_cycles += __rdtsc() - t0;
+}
+
+static int compare (const void *a, const void *b)
+{   uint64_t u = *(const uint64_t *)a, v = *(const uint64_t *)b;
+    return (u < v) ? -1 : (u > v);
+}
+
+/* best cycles of the bark accumulation and of its interpolation back to the bins */
+static void filterbank_cycles (void)
+{   static intptr_t fheap[4000];
+    uint64_t t, best_bank = ~0ull, best_psd = ~0ull;
+    float ps[FRAME], mel[24], out[FRAME];
+    FilterBank *bank;
+    int i, r;
+
+    fheap[0] = (intptr_t)&fheap[2];
+    bank = filterbank_new((uint8_t *)fheap, 24, FS, FRAME, 1);
+    for (i = 0; i < FRAME; i++)
+        ps[i] = (float)(i % 17 + 1);
+    for (r = 0; r < 2000; r++)
+    {   t = __rdtsc();
+        filterbank_compute_bank32(bank, ps, mel);
+        t = __rdtsc() - t;
+        if (t < best_bank) best_bank = t;
+        t = __rdtsc();
+        filterbank_compute_psd16(bank, mel, out);
+        t = __rdtsc() - t;
+        if (t < best_psd) best_psd = t;
+        ps[r & (FRAME - 1)] += out[3] * 1e-9f;
+    }
+    printf("filterbank : bank32 %llu cycles, psd16 %llu cycles\n", (unsigned long long)best_bank, (unsigned long long)best_psd);
+}
+
+int main (int argc, char **argv)
+{   SpeexPreprocessState *st;
+    uint64_t t0, total = 0;
+    double t, env, v;
+    FILE *f;
+    int n, k;
+
+    srand(7);
+    for (n = 0; n < NFRAMES * FRAME; n++)
+    {   t = n / (double)FS;
+        env = (sin(2 * M_PI * 1.3 * t) > 0) ? 1 : 0.05;
+        v = env * (3000 * sin(2 * M_PI * 220 * t) + 2000 * sin(2 * M_PI * 660 * t + sin(7 * t)) + 1000 * sin(2 * M_PI * 1800 * t));
+        x[n] = (int16_t)(v + 1600 * (rand() / (double)RAND_MAX - 0.5));
+    }
+
+    /* [0] = pointer, [1] = bytes allocated, [2] = start of the heap */
+    memset(heap, 0x55, sizeof(heap));
+    heap[0] = (intptr_t)&heap[2];
+    heap[1] = 0;
+    st = speex_preprocess_state_init((uint8_t *)heap, FRAME, FS);
+    printf("instance heap : %ld bytes\n", (long)heap[1]);
+
+    for (k = 0; k < NFRAMES; k++)
+    {   fft_cycles = 0;
+        t0 = __rdtsc();
+        speex_preprocess_run(st, &x[k * FRAME]);
+        cycles[k] = __rdtsc() - t0 - fft_cycles;
+        total += cycles[k];
+    }
+    qsort(cycles, NFRAMES, sizeof(uint64_t), compare);
+    printf("cycles outside the FFT per 10ms : median %.0f, mean %.0f\n",
+        cycles[NFRAMES / 2] * 160.0 / FRAME, (double)total / NFRAMES * 160.0 / FRAME);
+    filterbank_cycles();
+
+    if (argc > 1 && (f = fopen(argv[1], "wb")) != 0)
+    {   fwrite(x, sizeof(int16_t), NFRAMES * FRAME, f);
+        fclose(f);
+    }
+    return 0;
+}
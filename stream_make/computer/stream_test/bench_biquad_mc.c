@@ -0,0 +1,126 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_biquad_mc.c
+ * Description:  host benchmark of the multichannel interleaved biquad cascade
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    Compares, on 2 stages and 256 frames, the deinterleave + scalar DF1 q15 + reinterleave
+    path with the interleaved q15 / q31 / f32 services, in ns per sample, and checks the
+    interleaved q15 output is bit-exact with the per-channel one.
+
+    Build and run from the root of the repository (host gcc) :
+    gcc -O2 -D__GNUC_PYTHON__ -o bench_biquad_mc stream_make/computer/stream_test/bench_biquad_mc.c \
+        stream_platform/platform_services/stream_libraries/CMSIS-DSP/Source/FilteringFunctions/generic_biquad_cascade_mc.c -lm
+    ./bench_biquad_mc
+*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../../../stream_platform/platform_services/stream_libraries/CMSIS-DSP/Include/dsp/generic_filtering_functions.h"
+
+#define NFRAMES 256
+#define NLOOPS 4000
+#define NSTAGES 2
+#define MAXCHAN 16
+
+/* scalar DF1 q15 (the mono path of arm_stream_filter) */
+static void mono_q15 (const q15_t *c, q15_t *st, int nstages, int postshift, const q15_t *in, q15_t *out, int n)
+{   int s, i, x, y, acc;
+
+    for (s = 0; s < nstages; s++, c += 6, st += 4)
+    {   const q15_t *src = (s == 0) ? in : out;
+        for (i = 0; i < n; i++)
+        {   x = src[i];
+            acc = c[0]*x + c[2]*st[0] + c[3]*st[1] + c[4]*st[2] + c[5]*st[3];
+            y = acc >> (15 - postshift);
+            y = (y > 32767) ? 32767 : (y < -32768) ? -32768 : y;
+            st[1] = st[0]; st[0] = (q15_t)x; st[3] = st[2]; st[2] = (q15_t)y;
+            out[i] = (q15_t)y;
+        }
+    }
+}
+
+static double now (void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main (void)
+{
+    /* 2 stages low-pass, coefficients of the q15 DF1 layout and of the q31/f32 layout */
+    static const q15_t c15[6*NSTAGES] = { 4657,0,7464,4657,25576,-11147, 4657,0,2868,4657,9328,-26591 };
+    static const float cf[5*NSTAGES] = { .284277f,.4555821f,.284277f,.7805347f,-.3401758f,
+                                         .284277f,.1750586f,.284277f,.2846693f,-.8115139f };
+    static q15_t in[MAXCHAN*NFRAMES], out[MAXCHAN*NFRAMES], ref[MAXCHAN*NFRAMES];
+    static q15_t mono_in[NFRAMES], mono_out[NFRAMES], mono_st[MAXCHAN][4*NSTAGES], st15[4*NSTAGES*MAXCHAN];
+    static q31_t in31[MAXCHAN*NFRAMES], out31[MAXCHAN*NFRAMES], st31[4*NSTAGES*MAXCHAN], c31[5*NSTAGES];
+    static float inf[MAXCHAN*NFRAMES], outf[MAXCHAN*NFRAMES], stf[4*NSTAGES*MAXCHAN];
+    static const int chans[] = { 1, 2, 4, 8, 16 };
+    generic_biquad_cascade_mc_inst S;
+    double t0, t1, t2, t3, t4;
+    int i, k, C, loop, ch;
+
+    for (i = 0; i < MAXCHAN*NFRAMES; i++)
+    {   in[i] = (q15_t)((i * 7919) % 8000 - 4000);
+        in31[i] = (q31_t)in[i] << 16;
+        inf[i] = in[i] / 32768.f;
+    }
+    for (i = 0; i < 5*NSTAGES; i++)
+        c31[i] = (q31_t)(cf[i] * (1 << 30));
+
+    printf("  ch   per-channel   mc q15   mc q31   mc f32   (ns/sample)\n");
+    for (k = 0; k < (int)(sizeof(chans)/sizeof(chans[0])); k++)
+    {   C = chans[k];
+
+        memset(mono_st, 0, sizeof(mono_st));
+        t0 = now();
+        for (loop = 0; loop < NLOOPS; loop++)
+        {   for (ch = 0; ch < C; ch++)
+            {   for (i = 0; i < NFRAMES; i++) mono_in[i] = in[i*C + ch];
+                mono_q15(c15, mono_st[ch], NSTAGES, 2, mono_in, mono_out, NFRAMES);
+                for (i = 0; i < NFRAMES; i++) ref[i*C + ch] = mono_out[i];
+            }
+        }
+        t1 = now();
+        generic_biquad_cascade_mc_init(&S, NSTAGES, (uint8_t)C, c15, st15, 2, 2);
+        for (loop = 0; loop < NLOOPS; loop++)
+            generic_biquad_cascade_mc_q15(&S, in, out, NFRAMES);
+        t2 = now();
+        generic_biquad_cascade_mc_init(&S, NSTAGES, (uint8_t)C, c31, st31, 1, 4);
+        for (loop = 0; loop < NLOOPS; loop++)
+            generic_biquad_cascade_mc_q31(&S, in31, out31, NFRAMES);
+        t3 = now();
+        generic_biquad_cascade_mc_init(&S, NSTAGES, (uint8_t)C, cf, stf, 0, 4);
+        for (loop = 0; loop < NLOOPS; loop++)
+            generic_biquad_cascade_mc_f32(&S, inf, outf, NFRAMES);
+        t4 = now();
+
+        printf("  %2d   %8.1f   %8.1f %8.1f %8.1f   q15 bit-exact %s\n", C,
+            (t1-t0) * 1e9 / (NLOOPS*NFRAMES*C), (t2-t1) * 1e9 / (NLOOPS*NFRAMES*C),
+            (t3-t2) * 1e9 / (NLOOPS*NFRAMES*C), (t4-t3) * 1e9 / (NLOOPS*NFRAMES*C),
+            memcmp(ref, out, sizeof(q15_t)*NFRAMES*C) ? "NO" : "yes");
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_demodulator.c
+ * Description:  host test of the AM, FM, BPSK and QPSK modes of arm_stream_demodulator
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    The signals are made by arm_stream_modulator at 48kHz on a 12kHz carrier, Gaussian noise
+    is added, and arm_stream_demodulator_process is called with random input and output
+    sizes :
+    - AM, index 0.5, 500Hz, decimation 6 : DC, amplitude and SNR of the 8kHz envelope, with
+      the NCO phase at 0 and with an offset
+    - FM, deviation 2kHz, 400Hz, NCO 100Hz above the carrier : amplitude and DC offset
+    - BPSK (carrier +5Hz) and QPSK (carrier +1Hz), phase 1 rad, 1200 symbols/s (D=40) :
+      bit error rate from 0 to 9dB Eb/N0 against 0.5 erfc(sqrt(Eb/N0)), with the best of
+      the rotations of the Costas loop ambiguity, after 200 symbols of acquisition
+    Then the TSC cycles per input sample of each mode (fastest of 15 calls of 20s).
+    Returns the number of failed checks.
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/arm/modulator -Istream_nodes/arm/demodulator \
+        stream_make/computer/stream_test/bench_demodulator.c \
+        stream_nodes/arm/demodulator/arm_stream_demodulator_process.c \
+        stream_nodes/arm/modulator/arm_stream_modulator_process.c \
+        stream_nodes/arm/modulator/arm_stream_modulator_vgm.c \
+        stream_nodes/arm/modulator/arm_stream_nco.c -lm -o bench_demodulator
+    ./bench_demodulator
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_modulator.h"
+#include "arm_stream_demodulator.h"
+
+#define FS 48000
+#define NMAX 4000000
+#define YMAX 400000
+
+static arm_stream_modulator_instance modulator;
+static arm_stream_demodulator_instance demodulator;
+static int16_t in[2 * NMAX], x[NMAX], y[YMAX];
+static uint8_t bits[200000];
+static uint64_t rng = 88172645463325252ull;
+
+/* xorshift, uniform in ]0 1[ and Gaussian */
+static double urand (void)
+{   rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return ((rng >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static double grand (void)
+{   return sqrt(-2 * log(urand())) * cos(2 * M_PI * urand());
+}
+
+static int16_t sat (double v)
+{   v = floor(v + 0.5);
+    return (int16_t)((v > 32767) ? 32767 : (v < -32768) ? -32768 : v);
+}
+
+static void modulate (int mode, double fc, int amplitude, int nin, int n)
+{   int32_t nout = n;
+
+    memset(&modulator, 0, sizeof(modulator));
+    modulator.raw = STREAM_S16;
+    modulator.config.mode = (uint8_t)mode;
+    modulator.config.nb_tones = 1;
+    modulator.config.sampling_rate = FS;
+    modulator.config.increment[0] = MODULATOR_INCREMENT(fc, FS);
+    modulator.config.amplitude[0] = (int16_t)amplitude;
+    modulator.config.am_index = 16384;
+    modulator.config.fm_deviation = MODULATOR_INCREMENT(2000, FS);
+    if (mode == MODULATOR_MODE_IQ)
+        modulator.phase[0] = (uint32_t)(1.0 / (2 * M_PI) * 4294967296.0);
+    arm_stream_modulator_init(&modulator);
+    arm_stream_modulator_process(&modulator, (uint8_t *)in, nin, (uint8_t *)x, &nout);
+}
+
+static void setup (int mode, double fc, int decimation, int kp, int ki)
+{   memset(&demodulator, 0, sizeof(demodulator));
+    demodulator.config.increment = MODULATOR_INCREMENT(fc, FS);
+    demodulator.config.decimation = (uint16_t)decimation;
+    demodulator.config.mode = (uint8_t)mode;
+    demodulator.config.kp_shift = (uint8_t)kp;
+    demodulator.config.ki_shift = (uint8_t)ki;
+    arm_stream_demodulator_init(&demodulator);
+}
+
+/* random input and output sizes, returns the number of outputs */
+static int demodulate (int n)
+{   int32_t nin, nout, consumed;
+    int i = 0, o = 0;
+
+    while (i < n && o < YMAX)
+    {   nin = 1 + (int)(urand() * 700);
+        nout = 1 + (int)(urand() * 20);
+        if (nin > n - i) nin = n - i;
+        if (nout > YMAX - o) nout = YMAX - o;
+        consumed = arm_stream_demodulator_process(&demodulator, &x[i], nin, &y[o], &nout);
+        i += consumed;
+        o += nout;
+    }
+    return o;
+}
+
+/* DC, amplitude and SNR of a tone f at 8kHz, after 100 outputs */
+static void tone (int o, double f, double *dc, double *ac, double *snr)
+{   double s = 0, c = 0, t, e, res = 0;
+    int i, n = o - 100;
+
+    for (*dc = 0, i = 100; i < o; i++)
+    {   t = 2 * M_PI * f * i / 8000;
+        *dc += y[i];
+        s += y[i] * sin(t);
+        c += y[i] * cos(t);
+    }
+    *dc /= n;
+    *ac = 2 * sqrt(s * s + c * c) / n;
+    for (i = 100; i < o; i++)
+    {   t = 2 * M_PI * f * i / 8000;
+        e = y[i] - *dc - 2 * (s * sin(t) + c * cos(t)) / n;
+        res += e * e;
+    }
+    *snr = 10 * log10(*ac * *ac / 2 / (res / n));
+}
+
+static int analog (void)
+{   double dc, ac, snr, sinc = sin(M_PI * 500 / 8000) / (M_PI * 500 / 8000);
+    int err = 0, n = FS, i, o, offset;
+
+    for (i = 0; i < n; i++)
+        in[i] = sat(32767 * sin(2 * M_PI * 500 * i / FS));
+    modulate(MODULATOR_MODE_AM, 12000, 16384, n, n);
+    for (offset = 0; offset < 2; offset++)
+    {   setup(DEMODULATOR_MODE_AM, 12000, 6, 0, 0);
+        demodulator.phase = offset ? 0x5A000000u : 0;
+        o = demodulate(n);
+        tone(o, 500, &dc, &ac, &snr);
+        printf("AM NCO phase %s : %d outputs, dc %.0f (16384), ac %.0f (%.0f), SNR %.1f dB\n",
+            offset ? "offset" : "0", o, dc, ac, 8192 * sinc, snr);
+        err += (o != 8000 || fabs(dc - 16384) > 100 || fabs(ac - 8192 * sinc) > 100);
+    }
+
+    for (i = 0; i < n; i++)
+        in[i] = sat(32767 * sin(2 * M_PI * 400 * i / FS));
+    modulate(MODULATOR_MODE_FM, 12000, 16384, n, n);
+    for (i = 0; i < n; i++)
+        x[i] = sat(x[i] + 300 * grand());
+    setup(DEMODULATOR_MODE_FM, 12100, 6, 0, 0);
+    o = demodulate(n);
+    tone(o, 400, &dc, &ac, &snr);
+    printf("FM : %d outputs, ac %.0f (16384 = 2kHz), dc %.0f (-819 = -100Hz), SNR %.1f dB\n", o, ac, dc, snr);
+    err += (o != 8000 || fabs(ac - 16384) > 300 || fabs(dc + 819) > 60);
+    return err;
+}
+
+static int digital (int qpsk)
+{   int D = 40, bps = qpsk ? 2 : 1, nsym = 100000, skip = 200, n = nsym * D;
+    int kp = qpsk ? 6 : 5, ki = qpsk ? 13 : 11, a = qpsk ? 5793 : 8192;
+    double offset = qpsk ? 1 : 5, ps, ebn0, sigma, ber, theory;
+    int err = 0, e, i, k, r, o, I, Q, t;
+    long errors, best;
+
+    printf("%s, carrier +%gHz, kp 2^-%d ki 2^-%d\n Eb/N0  BER         theory\n", qpsk ? "QPSK" : "BPSK", offset, kp, ki);
+    for (e = 0; e <= 9; e++)
+    {   for (i = 0; i < nsym * bps; i++)
+            bits[i] = (urand() < 0.5);
+        for (i = 0; i < nsym; i++)
+        {   for (k = 0; k < D; k++)
+            {   in[2 * (i * D + k)] = (int16_t)(bits[i * bps] ? a : -a);
+                in[2 * (i * D + k) + 1] = (int16_t)(qpsk ? (bits[i * bps + 1] ? a : -a) : 0);
+            }
+        }
+        modulate(MODULATOR_MODE_IQ, 12000 + offset, 32767, 2 * n, n);
+        for (ps = 0, i = 0; i < n; i++)
+            ps += (double)x[i] * x[i];
+        ps /= n;
+        ebn0 = pow(10, e / 10.0);
+        sigma = sqrt(ps * D / (2 * bps * ebn0));
+        for (i = 0; i < n; i++)
+            x[i] = sat(x[i] + sigma * grand());
+
+        setup(qpsk ? DEMODULATOR_MODE_QPSK : DEMODULATOR_MODE_BPSK, 12000, D, kp, ki);
+        o = demodulate(n);
+        for (best = -1, r = 0; r < (qpsk ? 4 : 2); r++)
+        {   for (errors = 0, i = skip; i < nsym; i++)
+            {   if (!qpsk)
+                    errors += ((y[i] * (r ? -1 : 1) > 0) != bits[i]);
+                else
+                {   I = y[2 * i];
+                    Q = y[2 * i + 1];
+                    for (k = 0; k < r; k++)     /* rotation by 90 degrees */
+                    {   t = I; I = -Q; Q = t;
+                    }
+                    errors += ((I > 0) != bits[2 * i]) + ((Q > 0) != bits[2 * i + 1]);
+                }
+            }
+            if (best < 0 || errors < best) best = errors;
+        }
+        ber = (double)best / ((nsym - skip) * bps);
+        theory = 0.5 * erfc(sqrt(ebn0));
+        printf(" %2d dB  %.3e   %.3e%s\n", e, ber, theory, (o != nsym * bps) ? "  wrong number of outputs" : "");
+        err += (o != nsym * bps || (e <= 8 && ber > 1.6 * theory + 3e-5));
+    }
+    return err;
+}
+
+static void timing (void)
+{   static const char *names[4] = { "AM   D=6 ", "FM   D=6 ", "BPSK D=40", "QPSK D=40" };
+    static const int D[4] = { 6, 6, 40, 40 };
+    unsigned long long t0, best;
+    int32_t nout;
+    int i, mode, rep, n = FS * 20;
+
+    for (i = 0; i < n; i++)
+        x[i] = sat(8000 * sin(0.3 * i) + 100 * grand());
+    printf("TSC cycles per input sample\n");
+    for (mode = 0; mode < 4; mode++)
+    {   best = ~0ull;
+        for (rep = 0; rep < 15; rep++)
+        {   setup(mode, 12000, D[mode], 5, 11);
+            nout = YMAX;
+            t0 = __rdtsc();
+            arm_stream_demodulator_process(&demodulator, x, n, y, &nout);
+            t0 = __rdtsc() - t0;
+            if (t0 < best) best = t0;
+        }
+        printf("%s %5.2f\n", names[mode], best / (double)n);
+    }
+}
+
+int main (void)
+{   int err = analog();
+
+    err += digital(0);
+    err += digital(1);
+    timing();
+    printf(err ? "%d checks failed\n" : "checks passed\n", err);
+    return err;
+}
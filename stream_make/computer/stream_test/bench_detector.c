@@ -0,0 +1,145 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_detector.c
+ * Description:  host benchmark of the voice activity detector sigp_stream_detector
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    8 seconds of 16kHz noise with 440Hz tone bursts in the first half of the odd seconds, mono,
+    given to the node in calls of 64 samples through its entry point. Prints the time per
+    sample, the number of calls with a detection and a decision timeline (one character per
+    25 calls). With a file name argument the decision of each call is written to the file.
+
+    The harness only uses the node entry point, so it also builds against the sources of the
+    per-sample detector (parent of the block-based version) to compare the two :
+    git worktree add ../detector_ref <commit before the block detector>
+    This version needs "-include stdio.h" for its debug file. With -DBENCH_NO_FWRITE -flto the
+    writes to the debug file are replaced by an empty function and removed by the linker.
+
+    Build and run from the root of the repository (or of the worktree) (host gcc) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        stream_make/computer/stream_test/bench_detector.c \
+        stream_nodes/signal-processingFR/detector/sigp_stream_detector.c \
+        stream_nodes/signal-processingFR/detector/sigp_stream_detector_process.c -lm -o bench_detector
+    ./bench_detector decisions.txt
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+
+extern void sigp_stream_detector (unsigned int command, void *instance, void *data, unsigned int *status);
+
+#define FS 16000
+#define NSAMPLES (8 * FS)
+#define CALL 64
+#define NCALLS (NSAMPLES / CALL)
+#define NLOOPS 20
+
+FILE *ptf_debug_detector;               /* per-sample debug file of the former detector */
+
+#ifdef BENCH_NO_FWRITE
+/* the former detector without the cost of its debug file */
+size_t fwrite (const void *ptr, size_t size, size_t n, FILE *f)
+{   return n;
+}
+#endif
+
+/* the memory banks are larger than the instances of both versions of the node */
+static uint64_t instance[256], backup[64], trace[256];
+static int16_t x[NSAMPLES];
+static int32_t decision[NCALLS];
+
+static double now (void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* memresults = {instance, backup, trace ring, 4 format words of arc 0 ..} */
+static void reset (void)
+{   intptr_t memresults[8] = { (intptr_t)instance, (intptr_t)backup, (intptr_t)trace };
+    uint32_t command = 0, status;
+
+    memset(instance, 0, sizeof(instance));
+    memset(backup, 0, sizeof(backup));
+    ST(memresults[3 + NCHANDOMAIN_FMT1], NCHANM1_FMT1, 0);
+    ST(command, COMMAND_CMD, STREAM_RESET);
+    ST(command, COMMDEXT_CMD, COMMDEXT_COLD_BOOT);
+    sigp_stream_detector(command, memresults, 0, &status);
+}
+
+static void run_all (void)
+{   stream_xdmbuffer_t data[2];
+    uint32_t command = 0, status;
+    int k;
+
+    ST(command, COMMAND_CMD, STREAM_RUN);
+    for (k = 0; k < NCALLS; k++)
+    {   data[0].address = (intptr_t)&x[k * CALL]; data[0].size = CALL * sizeof(int16_t);
+        data[1].address = (intptr_t)&decision[k]; data[1].size = sizeof(int32_t);
+        sigp_stream_detector(command, instance, data, &status);
+    }
+}
+
+int main (int argc, char **argv)
+{   double t0, t1, v;
+    int i, k, on = 0;
+    FILE *f;
+
+    ptf_debug_detector = fopen("/dev/null", "wb");
+
+    srand(1);
+    for (i = 0; i < NSAMPLES; i++)
+    {   v = 200.0 * ((rand() / (double)RAND_MAX) - 0.5);
+        if (((i / FS) & 1) && (i % FS) < FS/2)
+            v += 8000 * sin(2 * M_PI * 440 * i / FS);
+        x[i] = (int16_t)v;
+    }
+
+    reset();
+    run_all();
+    for (k = 0; k < NCALLS; k++)
+        on += (decision[k] != 0);
+    for (k = 0; k < NCALLS; k += 25)
+        putchar(decision[k] ? '#' : '.');
+    printf("\n%d calls of %d samples, %d with a detection\n", NCALLS, CALL, on);
+
+    if (argc > 1 && (f = fopen(argv[1], "w")) != 0)
+    {   for (k = 0; k < NCALLS; k++)
+            fprintf(f, "%d\n", decision[k] != 0);
+        fclose(f);
+    }
+
+    t0 = now();
+    for (i = 0; i < NLOOPS; i++)
+        run_all();
+    t1 = now();
+    printf("%.2f ns/sample\n", (t1 - t0) * 1e9 / ((double)NLOOPS * NSAMPLES));
+    return 0;
+}
@@ -0,0 +1,141 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_detector2D.c
+ * Description:  host test of the motion detector sigp_stream_detector2D
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    For each preset, 12 synthetic frames of a textured background are given in chunks of
+    about 1000 pixels : a 40x40 square moves in frames 4 to 6 and frame 9 has a global
+    luminance step of +25. The events are printed with the frame index. Then the same frame
+    is given 50 times in one call per frame and the TSC cycles per pixel of the fastest call
+    are printed.
+
+    Build and run from the root of the repository (host gcc, x86), -O2 for the scalar code
+    and -O3 for the vectorized column sums :
+    gcc -O3 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        stream_make/computer/stream_test/bench_detector2D.c \
+        stream_nodes/signal-processingFR/detector2D/sigp_stream_detector2D.c \
+        stream_nodes/signal-processingFR/detector2D/sigp_stream_detector2D_process.c -o bench_detector2D
+    ./bench_detector2D
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "signal-processingFR/detector2D/sigp_stream_detector2D.h"
+
+extern void sigp_stream_detector2D (unsigned int command, void *instance, void *data, unsigned int *status);
+
+#define NPRESETS 5
+#define NFRAMES 12
+
+static sigp_detector2D_instance instance;
+static sigp_detector2D_strip strip;     /* node_mem 1 */
+static sigp_detector2D_cells cells;     /* node_mem 2 */
+static uint8_t image[640*480];
+
+static void reset (int preset)
+{   intptr_t memresults[3] = { (intptr_t)&instance, (intptr_t)&strip, (intptr_t)&cells };
+    uint32_t command = 0, status;
+
+    ST(command, COMMAND_CMD, STREAM_RESET);
+    ST(command, PRESET_CMD, preset);
+    sigp_stream_detector2D(command, memresults, 0, &status);
+}
+
+/* returns the pixels consumed, *nevents is the room in events and the events produced */
+static int run (uint8_t *in, int npixels, int16_t *events, int *nevents)
+{   stream_xdmbuffer_t data[2];
+    uint32_t command = 0, status;
+
+    data[0].address = (intptr_t)in;     data[0].size = npixels;
+    data[1].address = (intptr_t)events; data[1].size = *nevents * DETECTOR2D_EVENT_SIZE * sizeof(int16_t);
+    ST(command, COMMAND_CMD, STREAM_RUN);
+    sigp_stream_detector2D(command, &instance, data, &status);
+    *nevents = (int)(data[1].size / (DETECTOR2D_EVENT_SIZE * sizeof(int16_t)));
+    return (int)data[0].size;
+}
+
+/* textured background, optional bright square at (sqx, sqy), global luminance offset */
+static void make_frame (int w, int h, int sqx, int sqy, int light)
+{   int x, y, v;
+
+    srand(7);
+    for (y = 0; y < h; y++)
+    {   for (x = 0; x < w; x++)
+        {   v = 60 + ((x/7 + y/5) % 3) * 30 + (rand() % 9);
+            if (sqx >= 0 && x >= sqx && x < sqx + 40 && y >= sqy && y < sqy + 40)
+                v = 220 - ((x + y) & 8) * 4;
+            v += light + (rand() % 5) - 2;
+            image[y*w + x] = (uint8_t)((v < 0) ? 0 : (v > 255) ? 255 : v);
+        }
+    }
+}
+
+int main (void)
+{   int16_t events[4 * DETECTOR2D_EVENT_SIZE];
+    unsigned long long best, t0, t1;
+    long pixels;
+    int preset, frame, w, h, offset, chunk, n, nevents, detected, r;
+
+    for (preset = 0; preset < NPRESETS; preset++)
+    {   reset(preset);
+        w = instance.config.width;
+        h = instance.config.height;
+        printf("preset %d : %dx%d, %dx%d cells\n", preset, w, h, instance.ncell_x, instance.ncell_y);
+
+        for (frame = 0; frame < NFRAMES; frame++)
+        {   make_frame(w, h, (frame >= 4 && frame < 7) ? 20 + frame * 25 : -1, h / 3, (frame == 9) ? 25 : 0);
+            chunk = 1000 + frame * 37;
+            detected = 0;
+            for (offset = 0; offset < w * h; )
+            {   n = (w * h - offset < chunk) ? w * h - offset : chunk;
+                nevents = 4;
+                offset += run(image + offset, n, events, &nevents);
+                if (nevents)
+                {   detected = 1;
+                    printf("  frame %2d : flag %d, %3d cells, box %d %d %d %d\n", frame,
+                        events[0], events[1], events[2], events[3], events[4], events[5]);
+                }
+            }
+            if (!detected)
+                printf("  frame %2d : no event\n", frame);
+        }
+
+        make_frame(w, h, -1, 0, 0);
+        best = ~0ull;
+        for (r = 0; r < 50; r++)
+        {   nevents = 1;
+            t0 = __rdtsc();
+            pixels = run(image, w * h, events, &nevents);
+            t1 = __rdtsc();
+            if (t1 - t0 < best) best = t1 - t0;
+        }
+        printf("  %.2f TSC cycles per pixel\n", (double)best / pixels);
+    }
+    return 0;
+}
@@ -0,0 +1,198 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_filter2D.c
+ * Description:  host test of the line-streaming 2D filter arm_stream_filter2D
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    The output of arm_stream_filter2D_process is compared with a full-frame 2D convolution
+    with replicated borders, for the 6 presets :
+    - U8 97x61, 1 and 3 components, 3 lines per call and an output arc of 2 lines
+    - S16 64x5, 1 line per call
+    - U8 33x2 (frame shorter than the kernel), 2 components, 7 lines per call
+    Then the TSC cycles per pixel of the fastest of 20 VGA frames, 16 lines per call, for the
+    presets and for the separable blurs applied as general kernels.
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O3 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/arm/filter2D \
+        stream_make/computer/stream_test/bench_filter2D.c \
+        stream_nodes/arm/filter2D/arm_stream_filter2D.c \
+        stream_nodes/arm/filter2D/arm_stream_filter2D_process.c -o bench_filter2D
+    ./bench_filter2D
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_filter2D.h"
+
+extern const filter2D_parameters filter2D_preset [];
+
+static const char *names[] = { "blur3", "blur5", "blur7", "box5", "sharpen3", "sobel3" };
+static arm_filter2D_memory TCM;
+
+static int clampi (int v, int lo, int hi)
+{   return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+/* full frame convolution, replicated borders */
+static void reference (filter2D_parameters *c, int raw, int nchan, void *img, void *out)
+{   int w = c->width, h = c->height, k = c->taps, r = k / 2, x, y, ch, i, j, p;
+    long a1, a2, acc, res;
+
+    for (y = 0; y < h; y++)
+    for (x = 0; x < w; x++)
+    for (ch = 0; ch < nchan; ch++)
+    {   a1 = a2 = 0;
+        for (j = 0; j < k; j++)
+        {   for (i = 0; i < k; i++)
+            {   int yy = clampi(y - r + j, 0, h - 1), xx = clampi(x - r + i, 0, w - 1);
+                p = (raw == STREAM_U8) ? ((uint8_t *)img)[(yy * w + xx) * nchan + ch] : ((int16_t *)img)[(yy * w + xx) * nchan + ch];
+                if (c->mode == FILTER2D_GENERAL)
+                    a1 += c->coef[j * k + i] * p;
+                else
+                {   a1 += c->coef[i] * c->coef[k + j] * p;
+                    if (c->mode == FILTER2D_GRADIENT)
+                        a2 += c->coef[2 * k + i] * c->coef[3 * k + j] * p;
+                }
+            }
+        }
+        acc = (c->mode == FILTER2D_GRADIENT) ? labs(a1) + labs(a2) : a1;
+        res = ((acc + ((1 << c->shift) >> 1)) >> c->shift) + c->offset;
+        if (raw == STREAM_U8)
+            ((uint8_t *)out)[(y * w + x) * nchan + ch] = (uint8_t)clampi((int)res, 0, 255);
+        else
+            ((int16_t *)out)[(y * w + x) * nchan + ch] = (int16_t)clampi((int)res, -32768, 32767);
+    }
+}
+
+/* returns the frames different from the reference, *cpp = TSC cycles per pixel of the fastest frame */
+static int run (filter2D_parameters cfg, int raw, int nchan, int chunk_lines, int room_lines, int frames, int check, double *cpp)
+{   arm_filter2D_instance instance;
+    long frame_bytes, line_bytes, ip, op = 0, i;
+    unsigned long long t0, t1, best = ~0ull;
+    int32_t available, room, consumed;
+    uint8_t *img, *out, *ref;
+    int w, h, f, v, bad = 0;
+
+    memset(&instance, 0, sizeof(instance));
+    instance.TCM = &TCM;
+    instance.raw = (uint8_t)raw;
+    instance.nchan = (uint8_t)nchan;
+    instance.config = cfg;
+    arm_stream_filter2D_init(&instance);
+
+    w = instance.config.width;
+    h = instance.config.height;
+    line_bytes = (long)w * nchan * ((raw == STREAM_U8) ? 1 : 2);
+    frame_bytes = line_bytes * h;
+    img = malloc(frame_bytes);
+    out = calloc(frame_bytes * frames, 1);
+    ref = malloc(frame_bytes);
+
+    srand(5);
+    for (i = 0; i < (long)w * h * nchan; i++)
+    {   v = (int)(128 + 100 * ((i / nchan % w) * 7 % 13 - 6) / 6.0 * ((i / nchan / w) % 9 - 4) / 4.0) + rand() % 40 - 20;
+        if (raw == STREAM_U8)
+            img[i] = (uint8_t)clampi(v, 0, 255);
+        else
+            ((int16_t *)img)[i] = (int16_t)(v * 2 - 256);
+    }
+
+    for (f = 0; f < frames; f++)
+    {   ip = 0;
+        t0 = __rdtsc();
+        while (ip < frame_bytes)
+        {   available = (int32_t)MIN(frame_bytes - ip, line_bytes * chunk_lines);
+            room = (int32_t)(line_bytes * MAX(room_lines, instance.config.taps / 2 + 1));
+            consumed = arm_stream_filter2D_process(&instance, img + ip, available, out + op, &room);
+            ip += consumed;
+            op += room;
+        }
+        t1 = __rdtsc();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    *cpp = (double)best / ((double)w * h);
+
+    if (op != frame_bytes * frames)
+    {   printf("produced %ld bytes instead of %ld\n", op, frame_bytes * frames);
+        bad = frames;
+    } else if (check)
+    {   reference(&instance.config, raw, nchan, img, ref);
+        for (f = 0; f < frames; f++)
+            bad += (memcmp(out + f * frame_bytes, ref, frame_bytes) != 0);
+    }
+    free(img);
+    free(out);
+    free(ref);
+    return bad;
+}
+
+int main (void)
+{   filter2D_parameters c, g;
+    double cpp;
+    int p, k, i, j;
+
+    for (p = 0; p < 6; p++)
+    {   c = filter2D_preset[p];
+        c.width = 97; c.height = 61;
+        printf("%-9s U8  97x61 1 comp. : %d frames differ", names[p], run(c, STREAM_U8, 1, 3, 2, 2, 1, &cpp));
+        printf(", 3 comp. : %d\n", run(c, STREAM_U8, 3, 3, 2, 2, 1, &cpp));
+        c.width = 64; c.height = 5; c.shift += 6;
+        printf("%-9s S16 64x5  1 comp. : %d frames differ\n", names[p], run(c, STREAM_S16, 1, 1, 1, 3, 1, &cpp));
+        c = filter2D_preset[p];
+        c.width = 33; c.height = 2;
+        printf("%-9s U8  33x2  2 comp. : %d frames differ\n", names[p], run(c, STREAM_U8, 2, 7, 9, 2, 1, &cpp));
+    }
+
+    printf("\nVGA 640x480 U8 gray, TSC cycles per pixel\n");
+    for (p = 0; p < 6; p++)
+    {   c = filter2D_preset[p];
+        run(c, STREAM_U8, 1, 16, 16, 20, 0, &cpp);
+        printf("  %-9s %s %dx%d : %.2f\n", names[p], (c.mode == FILTER2D_SEPARABLE) ? "separable" :
+            (c.mode == FILTER2D_GENERAL) ? "general  " : "gradient ", c.taps, c.taps, cpp);
+    }
+    for (p = 0; p < 3; p++)
+    {   c = filter2D_preset[p];
+        k = c.taps;
+        g = c;
+        g.mode = FILTER2D_GENERAL;
+        for (j = 0; j < k; j++)
+            for (i = 0; i < k; i++)
+                g.coef[j * k + i] = (int16_t)(c.coef[i] * c.coef[k + j]);
+        run(g, STREAM_U8, 1, 16, 16, 20, 0, &cpp);
+        printf("  %-9s general   %dx%d : %.2f\n", names[p], k, k, cpp);
+    }
+    c = filter2D_preset[FILTER2D_PRESET_BLUR5];
+    run(c, STREAM_U8, 3, 16, 16, 10, 0, &cpp);
+    printf("  blur5 RGB888 : %.2f\n", cpp);
+    c.hshift = 4; c.shift = 4;
+    run(c, STREAM_S16, 1, 16, 16, 10, 0, &cpp);
+    printf("  blur5 S16    : %.2f\n", cpp);
+    return 0;
+}
@@ -0,0 +1,190 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_fixedbf.c
+ * Description:  host test of the delay-and-sum beamformer arm_stream_fixedbf
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    For 4 and 8 microphones and 1 to 4 beams with random fractional delays and gains, one
+    second at 16kHz is given in pieces of 1 to 300 samples. The beams are compared with a
+    double-precision delay-and-sum using the same Lagrange interpolator, and the TSC cycles
+    of the fastest of 200 calls of 256 samples are printed.
+    Then a tone is steered twice (the second table arrives during the cross-fade of the
+    first one) and the largest second difference of the output is compared with the one of
+    a hard switch of the coefficients.
+
+    Build and run from the root of the repository (host gcc, x86), -O3 for the vectorized
+    loops and -O2 for the scalar code :
+    gcc -O3 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/arm/fixedbf \
+        stream_make/computer/stream_test/bench_fixedbf.c \
+        stream_nodes/arm/fixedbf/arm_stream_fixedbf_process.c -lm -o bench_fixedbf
+    ./bench_fixedbf
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+#include "arm_stream_fixedbf.h"
+
+#define FS 16000
+
+static arm_fixedbf_memory TCM;
+static int16_t in[FS * FIXEDBF_MAX_MICS], out[FS * FIXEDBF_MAX_BEAMS];
+
+/* Lagrange coefficient k of the taps at -1, 0, 1, 2 for the fractional delay t */
+static double lagrange (double t, int k)
+{   static const double p[4] = { -1, 0, 1, 2 };
+    double r = 1;
+    int j;
+
+    for (j = 0; j < 4; j++)
+        if (j != k)
+            r *= (t - p[j]) / (p[k] - p[j]);
+    return r;
+}
+
+static void test (int nmics, int nbeams)
+{   arm_fixedbf_instance instance;
+    int n, m, b, k, n0, d, nn, len;
+    double y, e, gsum, t, maxe = 0;
+    uint64_t t0, best = ~0ull;
+    int32_t consumed, olen;
+
+    for (n = 0; n < FS; n++)
+        for (m = 0; m < nmics; m++)
+            in[n * nmics + m] = (int16_t)(8000 * sin(n * 0.05 + m * 0.7) + 3000 * sin(n * 0.31 * (m + 1)) + (rand() % 2001 - 1000));
+
+    memset(&instance, 0, sizeof(instance));
+    instance.TCM = &TCM;
+    instance.nmics = (uint8_t)nmics;
+    instance.nbeams = (uint8_t)nbeams;
+    for (b = 0; b < FIXEDBF_MAX_BEAMS; b++)
+    {   for (m = 0; m < FIXEDBF_MAX_MICS; m++)
+        {   instance.config.delay[b][m] = (int16_t)(256 + rand() % (20 * 256));
+            instance.config.gain[b][m] = (int16_t)(1000 + rand() % 30000);
+        }
+    }
+    arm_stream_fixedbf_init(&instance);
+
+    for (n0 = 0; n0 < FS; n0 += len)
+    {   len = 1 + rand() % 300;
+        if (len > FS - n0) len = FS - n0;
+        olen = len * nbeams * 2;
+        consumed = arm_stream_fixedbf_process(&instance, &in[n0 * nmics], len * nmics * 2, &out[n0 * nbeams], &olen);
+        if (consumed != len * nmics * 2 || olen != len * nbeams * 2)
+        {   printf("%d mics %d beams : %d bytes consumed, %d produced for %d samples\n", nmics, nbeams, consumed, olen, len);
+            return;
+        }
+    }
+
+    /* the gains are normalized to a sum of 1.0 */
+    for (b = 0; b < nbeams; b++)
+    {   for (gsum = 0, m = 0; m < nmics; m++)
+            gsum += abs(instance.config.gain[b][m]);
+        for (n = 0; n < FS; n++)
+        {   y = 0;
+            for (m = 0; m < nmics; m++)
+            {   d = instance.config.delay[b][m];
+                t = (d & 255) / 256.0;
+                for (k = 0; k < 4; k++)
+                {   nn = n - ((d >> 8) - 1 + k);
+                    y += instance.config.gain[b][m] / gsum * lagrange(t, k) * ((nn >= 0) ? in[nn * nmics + m] : 0);
+                }
+            }
+            e = fabs(y - out[n * nbeams + b]);
+            if (e > maxe) maxe = e;
+        }
+    }
+
+    for (k = 0; k < 200; k++)
+    {   olen = 256 * nbeams * 2;
+        t0 = __rdtsc();
+        arm_stream_fixedbf_process(&instance, in, 256 * nmics * 2, out, &olen);
+        t0 = __rdtsc() - t0;
+        if (t0 < best) best = t0;
+    }
+    printf("%d mics %d beams : max error %.2f LSB, %llu cycles per frame of 256\n", nmics, nbeams, maxe, (unsigned long long)best);
+}
+
+/* largest second difference of the output of a tone steered at sample 1000 and 1100 */
+static int steering (int hard)
+{   arm_fixedbf_instance instance;
+    int n, m, step, maxstep = 0, nmics = 4, N = 4096;
+    int32_t olen;
+
+    for (n = 0; n < N; n++)
+        for (m = 0; m < nmics; m++)
+            in[n * nmics + m] = (int16_t)(10000 * sin(n * 0.02));
+
+    memset(&instance, 0, sizeof(instance));
+    instance.TCM = &TCM;
+    instance.nmics = (uint8_t)nmics;
+    instance.nbeams = 1;
+    for (m = 0; m < FIXEDBF_MAX_MICS; m++)
+    {   instance.config.delay[0][m] = 256;
+        instance.config.gain[0][m] = 32767;
+    }
+    arm_stream_fixedbf_init(&instance);
+    olen = 1000 * 2;
+    arm_stream_fixedbf_process(&instance, in, 1000 * nmics * 2, out, &olen);
+
+    for (m = 0; m < FIXEDBF_MAX_MICS; m++)
+        instance.config.delay[0][m] = (int16_t)(256 + m * 1000);
+    arm_stream_fixedbf_steer(&instance);
+    if (hard)
+    {   instance.ramp = FIXEDBF_RAMP;           /* new bank without cross-fade */
+        instance.bank ^= 1;
+        olen = (N - 1000) * 2;
+        arm_stream_fixedbf_process(&instance, &in[1000 * nmics], (N - 1000) * nmics * 2, &out[1000], &olen);
+    } else
+    {   olen = 100 * 2;
+        arm_stream_fixedbf_process(&instance, &in[1000 * nmics], 100 * nmics * 2, &out[1000], &olen);
+        for (m = 0; m < FIXEDBF_MAX_MICS; m++)
+            instance.config.delay[0][m] = (int16_t)(256 + m * 300);
+        arm_stream_fixedbf_steer(&instance);    /* pending during the cross-fade */
+        olen = (N - 1100) * 2;
+        arm_stream_fixedbf_process(&instance, &in[1100 * nmics], (N - 1100) * nmics * 2, &out[1100], &olen);
+    }
+
+    for (n = 2; n < N; n++)
+    {   step = abs(out[n] - 2 * out[n - 1] + out[n - 2]);
+        if (step > maxstep) maxstep = step;
+    }
+    return maxstep;
+}
+
+int main (void)
+{   int nmics, nbeams;
+
+    srand(1);
+    for (nmics = 4; nmics <= 8; nmics += 4)
+        for (nbeams = 1; nbeams <= FIXEDBF_MAX_BEAMS; nbeams++)
+            test(nmics, nbeams);
+
+    printf("tone steered twice : max second difference %d with the cross-fade, %d with a hard switch (tone alone %.0f)\n",
+        steering(0), steering(1), 10000 * 0.02 * 0.02);
+    return 0;
+}
@@ -0,0 +1,229 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_imadpcm.c
+ * Description:  host test of the IMA-ADPCM encoder and decoder of the compressor nodes
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2026 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    Compares the table-driven IMA-ADPCM of sigp_stream_compressor / sigp_stream_decompressor
+    with the per-sample reference algorithm (IMA recommended practices, branches per bit) :
+    - stream mode : codes and decoded samples against the reference
+    - block mode, 1/2/4/8 interleaved channels, blocks of 256 bytes : decoded samples against
+      the reference restarted on each block, SNR, recovery after a corrupted block
+    - samples per second of the block encoder and decoder, and of the reference
+
+    Build and run from the root of the repository (host gcc) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/signal-processingFR/compressor -Istream_nodes/signal-processingFR/decompressor \
+        stream_make/computer/stream_test/bench_imadpcm.c \
+        stream_nodes/signal-processingFR/compressor/sigp_stream_compressor_imadpcm.c \
+        stream_nodes/signal-processingFR/decompressor/sigp_stream_decompressor_imadpcm.c -lm -o bench_imadpcm
+    ./bench_imadpcm
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* both codec headers use the same include guard */
+#define IMADPCM_TABLE_SIZE (89 * 16)
+#define BLOCK_BYTES 256
+#define SAMPLES_PER_BLOCK (((BLOCK_BYTES - 4) * 2) + 1)
+extern void encode_imadpcm_table_init (uint32_t *table);
+extern void encode_imadpcm (uint32_t *state, const uint32_t *table, int16_t *input, uint32_t numSamples, uint8_t *output);
+extern void encode_imadpcm_block (uint32_t *state, const uint32_t *table, int16_t *input, uint32_t nchan, uint32_t block_bytes, uint8_t *output);
+extern void decode_imadpcm_table_init (uint32_t *table);
+extern void decode_imadpcm (int32_t *state, const uint32_t *table, uint8_t *input, uint32_t numSamples, int16_t *output, uint8_t decoder_state);
+extern void decode_imadpcm_block (const uint32_t *table, uint8_t *input, uint32_t nchan, uint32_t block_bytes, int16_t *output);
+
+#define MAXCHAN 8
+#define NFRAMES (SAMPLES_PER_BLOCK * 200)
+
+static uint32_t table_enc[IMADPCM_TABLE_SIZE], table_dec[IMADPCM_TABLE_SIZE];
+static int16_t in[NFRAMES * MAXCHAN], out[NFRAMES * MAXCHAN];
+static uint8_t bits[NFRAMES * MAXCHAN];
+
+/* reference IMA-ADPCM, one sample at a time, low nibble first */
+static const int8_t ref_index[16] = { -1,-1,-1,-1,2,4,6,8,-1,-1,-1,-1,2,4,6,8 };
+static const int16_t ref_step[89] = { 7,8,9,10,11,12,13,14,16,17,19,21,23,25,28,31,34,37,41,45,50,55,60,
+    66,73,80,88,97,107,118,130,143,157,173,190,209,230,253,279,307,337,371,408,449,494,544,598,658,724,
+    796,876,963,1060,1166,1282,1411,1552,1707,1878,2066,2272,2499,2749,3024,3327,3660,4026,4428,4871,
+    5358,5894,6484,7132,7845,8630,9493,10442,11487,12635,13899,15289,16818,18500,20350,22385,24623,
+    27086,29794,32767 };
+
+static void ref_update (int *valpred, int *index, int code, int vpdiff)
+{   *valpred = (code & 8) ? *valpred - vpdiff : *valpred + vpdiff;
+    if (*valpred > 32767) *valpred = 32767;
+    if (*valpred < -32768) *valpred = -32768;
+    *index += ref_index[code];
+    if (*index < 0) *index = 0;
+    if (*index > 88) *index = 88;
+}
+
+static int ref_encode (int *valpred, int *index, int sample)
+{   int diff = sample - *valpred, code = 0, step = ref_step[*index], vpdiff = step >> 3;
+
+    if (diff < 0) { code = 8; diff = -diff; }
+    if (diff >= step) { code |= 4; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; vpdiff += step; }
+    ref_update(valpred, index, code, vpdiff);
+    return code;
+}
+
+static int ref_decode (int *valpred, int *index, int code)
+{   int step = ref_step[*index], vpdiff = step >> 3;
+
+    if (code & 4) vpdiff += step;
+    if (code & 2) vpdiff += step >> 1;
+    if (code & 1) vpdiff += step >> 2;
+    ref_update(valpred, index, code, vpdiff);
+    return *valpred;
+}
+
+static double now (void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void test_stream (void)
+{   uint32_t state[2] = { 0, 0 };
+    int32_t dstate[2] = { 0, 0 };
+    int n = 20000, valpred = 0, index = 0, i, code, code_errors = 0, decode_errors = 0;
+
+    encode_imadpcm(state, table_enc, in, n, bits);
+    for (i = 0; i < n; i++)
+    {   code = ref_encode(&valpred, &index, in[i]);
+        code_errors += (code != ((bits[i >> 1] >> ((i & 1) * 4)) & 15));
+    }
+    decode_imadpcm(dstate, table_dec, bits, n, out, 2);
+    valpred = index = 0;
+    for (i = 0; i < n; i++)
+        decode_errors += (out[i] != ref_decode(&valpred, &index, (bits[i >> 1] >> ((i & 1) * 4)) & 15));
+    printf("stream : %d code and %d sample mismatches with the reference\n", code_errors, decode_errors);
+}
+
+static void test_blocks (int nchan)
+{   uint32_t state[2 * MAXCHAN] = { 0 };
+    int nblocks = NFRAMES / SAMPLES_PER_BLOCK, b, c, k, i, errors = 0, large = 0;
+    int valpred, index[MAXCHAN] = { 0 };
+    double se = 0, ss = 0, e;
+    int16_t *x, *y;
+
+    for (b = 0; b < nblocks; b++)
+        encode_imadpcm_block(state, table_enc, in + b * SAMPLES_PER_BLOCK * nchan, nchan, BLOCK_BYTES, bits + b * BLOCK_BYTES * nchan);
+    for (b = 0; b < nblocks; b++)
+        decode_imadpcm_block(table_dec, bits + b * BLOCK_BYTES * nchan, nchan, BLOCK_BYTES, out + b * SAMPLES_PER_BLOCK * nchan);
+
+    /* the reference restarts each block from the first sample, the step index continues */
+    for (b = 0; b < nblocks; b++)
+    {   x = in + b * SAMPLES_PER_BLOCK * nchan;
+        y = out + b * SAMPLES_PER_BLOCK * nchan;
+        for (c = 0; c < nchan; c++)
+        {   valpred = x[c];
+            errors += (y[c] != valpred);
+            for (k = 1; k < SAMPLES_PER_BLOCK; k++)
+            {   ref_encode(&valpred, &index[c], x[k * nchan + c]);
+                errors += (y[k * nchan + c] != valpred);
+            }
+        }
+    }
+    for (i = 0; i < nblocks * SAMPLES_PER_BLOCK * nchan; i++)
+    {   e = in[i] - out[i];
+        se += e * e;
+        ss += (double)in[i] * in[i];
+    }
+
+    /* corrupted header of block 5 and payload of block 6 : blocks 7 and 8 decode normally */
+    memset(bits + 5 * BLOCK_BYTES * nchan, 0xFF, 4);
+    memset(bits + 6 * BLOCK_BYTES * nchan + 40, 0x5A, 20);
+    for (b = 4; b < 9; b++)
+        decode_imadpcm_block(table_dec, bits + b * BLOCK_BYTES * nchan, nchan, BLOCK_BYTES, out + b * SAMPLES_PER_BLOCK * nchan);
+    for (i = 7 * SAMPLES_PER_BLOCK * nchan; i < 9 * SAMPLES_PER_BLOCK * nchan; i++)
+        large += (abs(in[i] - out[i]) > 6000);
+
+    printf("blocks %d ch : %d mismatches with the reference, SNR %.1f dB, after corruption : block 5 sample 0 = %d, %d large errors in blocks 7-8\n",
+        nchan, errors, 10 * log10(ss / se), out[5 * SAMPLES_PER_BLOCK * nchan], large);
+}
+
+static void throughput (void)
+{   uint32_t state[2 * MAXCHAN] = { 0 };
+    int nchan, nblocks, r, b, i, valpred, index, n = NFRAMES * MAXCHAN;
+    const int loops = 10;
+    double t0, t1, t2, nsamples;
+    unsigned check = 0;
+
+    for (nchan = 1; nchan <= MAXCHAN; nchan *= 2)
+    {   nblocks = NFRAMES * MAXCHAN / (SAMPLES_PER_BLOCK * nchan);
+        nsamples = (double)nblocks * SAMPLES_PER_BLOCK * nchan * loops;
+        t0 = now();
+        for (r = 0; r < loops; r++)
+            for (b = 0; b < nblocks; b++)
+                encode_imadpcm_block(state, table_enc, in + b * SAMPLES_PER_BLOCK * nchan, nchan, BLOCK_BYTES, bits + b * BLOCK_BYTES * nchan);
+        t1 = now();
+        for (r = 0; r < loops; r++)
+            for (b = 0; b < nblocks; b++)
+                decode_imadpcm_block(table_dec, bits + b * BLOCK_BYTES * nchan, nchan, BLOCK_BYTES, out + b * SAMPLES_PER_BLOCK * nchan);
+        t2 = now();
+        printf("%d ch : encode %.0f M, decode %.0f M samples/s\n", nchan, nsamples / (t1 - t0) / 1e6, nsamples / (t2 - t1) / 1e6);
+    }
+
+    t0 = now();
+    for (r = 0; r < loops; r++)
+        for (valpred = index = 0, i = 0; i < n; i++)
+            check += ref_encode(&valpred, &index, in[i]);
+    t1 = now();
+    for (r = 0; r < loops; r++)
+        for (valpred = index = 0, i = 0; i < n; i++)
+            check += ref_decode(&valpred, &index, (bits[i >> 1] >> ((i & 1) * 4)) & 15);
+    t2 = now();
+    printf("per-sample reference : encode %.0f M, decode %.0f M samples/s (%u)\n",
+        (double)n * loops / (t1 - t0) / 1e6, (double)n * loops / (t2 - t1) / 1e6, check & 1);
+}
+
+int main (void)
+{   int i, c, nchan;
+    double v;
+
+    encode_imadpcm_table_init(table_enc);
+    decode_imadpcm_table_init(table_dec);
+
+    srand(3);
+    for (i = 0; i < NFRAMES * MAXCHAN; i++)
+    {   c = i % MAXCHAN;
+        v = 12000 * sin(0.01 * (c + 1) * (i / MAXCHAN)) + 8000 * sin(0.37 * (i / MAXCHAN) + c) + (rand() % 2001 - 1000);
+        if (i % 50000 < 10) v = 32767;
+        in[i] = (int16_t)v;
+    }
+
+    test_stream();
+    for (nchan = 1; nchan <= MAXCHAN; nchan *= 2)
+        test_blocks(nchan);
+    throughput();
+    return 0;
+}
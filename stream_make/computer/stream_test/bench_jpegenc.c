@@ -0,0 +1,216 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_jpegenc.c
+ * Description:  host test of the strip JPEG encoder bitbank_JPEGENC
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    A synthetic 640x480 image (gradients, checkerboard, noise) is converted to the pixel
+    format of each configuration and encoded 20 times, one MCU row per call, in an output
+    arc of 1 kB. The last frame is decoded with TJpgDec R0.03 of the TjpgDec node.
+    Prints the bytes per frame, the bits per pixel, the frames per second and the PSNR of
+    the decoded frame against the encoder input.
+
+    Build and run from the root of the repository (host gcc) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/bitbank/JPEGENC -Istream_nodes/elm-lang/TJpgDec/tjpgd3/src \
+        stream_make/computer/stream_test/bench_jpegenc.c \
+        stream_nodes/bitbank/JPEGENC/bitbank_JPEGENC_process.c \
+        stream_nodes/elm-lang/TJpgDec/tjpgd3/src/tjpgd.c -lm -o bench_jpegenc
+    ./bench_jpegenc
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "bitbank_JPEGENC.h"
+#include "tjpgd.h"
+
+#define NFRAMES 20
+#define OUT_ARC 1024
+
+typedef struct
+{   const char *name;
+    int width, height, pixel_type, subsample, quality;
+} config_t;
+
+static const config_t configs[] =
+{   { "VGA gray HIGH",        640, 480, JPEGENC_PIXEL_GRAYSCALE, JPEGENC_SUBSAMPLE_444, JPEGENC_Q_HIGH },
+    { "VGA 565 4:2:0 HIGH",   640, 480, JPEGENC_PIXEL_RGB565,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_HIGH },
+    { "QVGA 565 4:2:0 MED",   320, 240, JPEGENC_PIXEL_RGB565,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_MED  },
+    { "VGA 888 4:4:4 BEST",   640, 480, JPEGENC_PIXEL_RGB888,    JPEGENC_SUBSAMPLE_444, JPEGENC_Q_BEST },
+    { "VGA 888 4:2:0 LOW",    640, 480, JPEGENC_PIXEL_RGB888,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_LOW  },
+    { "333x201 888 4:2:0",    333, 201, JPEGENC_PIXEL_RGB888,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_HIGH },
+};
+
+static bitbank_JPEGENC_tables tables;
+static uint8_t staging[JPEGENC_OUT_BYTES];
+static uint8_t rgb[640*480*3], image[640*480*3], decoded[640*480*3];
+static uint8_t jpeg[NFRAMES * 640*480*3];
+static uint8_t pool[8192];
+
+static const uint8_t *src;              /* TJpgDec input and output */
+static size_t srcpos, srclen;
+static int dec_width;
+
+static double now (void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static size_t tjpgd_input (JDEC *jd, uint8_t *buf, size_t n)
+{   if (srcpos + n > srclen) n = srclen - srcpos;
+    if (buf) memcpy(buf, src + srcpos, n);
+    srcpos += n;
+    return n;
+}
+
+static int tjpgd_output (JDEC *jd, void *bitmap, JRECT *rect)
+{   uint8_t *s = bitmap;
+    int y, w = rect->right - rect->left + 1;
+
+    for (y = rect->top; y <= rect->bottom; y++, s += w * 3)
+        memcpy(&decoded[(y * dec_width + rect->left) * 3], s, w * 3);
+    return 1;
+}
+
+static int clip (int v)
+{   return (v < 0) ? 0 : (v > 255) ? 255 : v;
+}
+
+/* RGB of the source pixel (x, y) of the encoder input, after the RGB565 and gray conversions */
+static void input_rgb (const config_t *c, int x, int y, int *r, int *g, int *b)
+{   uint8_t *p;
+    uint16_t v;
+
+    if (c->pixel_type == JPEGENC_PIXEL_GRAYSCALE)
+    {   *r = *g = *b = image[y * c->width + x];
+    } else if (c->pixel_type == JPEGENC_PIXEL_RGB565)
+    {   p = &image[(y * c->width + x) * 2];
+        v = (uint16_t)(p[0] | (p[1] << 8));
+        *r = ((v >> 8) & 0xF8) | (v >> 13);
+        *g = ((v >> 3) & 0xFC) | ((v >> 9) & 3);
+        *b = ((v << 3) & 0xF8) | ((v >> 2) & 7);
+    } else
+    {   p = &image[(y * c->width + x) * 3];
+        *r = p[0]; *g = p[1]; *b = p[2];
+    }
+}
+
+static void test (const config_t *c)
+{   bitbank_JPEGENC_instance instance;
+    int bpp = (c->pixel_type == JPEGENC_PIXEL_GRAYSCALE) ? 1 : (c->pixel_type == JPEGENC_PIXEL_RGB565) ? 2 : 3;
+    int lines = (c->pixel_type != JPEGENC_PIXEL_GRAYSCALE && c->subsample == JPEGENC_SUBSAMPLE_420) ? 16 : 8;
+    long total = (long)c->width * c->height * bpp, length = 0, ip, frame_length;
+    int32_t room, available;
+    int f, x, y, r, g, b, rc, k, in[3];
+    double t0, t1, mse = 0, d;
+    uint8_t *p;
+    uint16_t v;
+    JDEC jd;
+
+    for (y = 0; y < c->height; y++)
+    {   for (x = 0; x < c->width; x++)
+        {   p = &rgb[(y * 640 + x) * 3];
+            if (bpp == 1)
+                image[y * c->width + x] = (uint8_t)((p[0] * 77 + p[1] * 150 + p[2] * 29) >> 8);
+            else if (bpp == 2)
+            {   v = (uint16_t)(((p[0] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[2] >> 3));
+                image[(y * c->width + x) * 2] = (uint8_t)v;
+                image[(y * c->width + x) * 2 + 1] = (uint8_t)(v >> 8);
+            } else
+                memcpy(&image[(y * c->width + x) * 3], p, 3);
+        }
+    }
+
+    memset(&instance, 0, sizeof(instance));
+    instance.tables = &tables;
+    instance.out = staging;
+    instance.config.width = (uint16_t)c->width;
+    instance.config.height = (uint16_t)c->height;
+    instance.config.pixel_type = (uint8_t)c->pixel_type;
+    instance.config.subsample = (uint8_t)c->subsample;
+    instance.config.quality = (uint8_t)c->quality;
+    bitbank_JPEGENC_init(&instance);
+
+    t0 = now();
+    for (f = 0; f < NFRAMES; f++)
+    {   ip = 0;
+        do
+        {   room = OUT_ARC;
+            available = (int32_t)((total - ip < lines * c->width * bpp) ? total - ip : lines * c->width * bpp);
+            ip += bitbank_JPEGENC_process(&instance, &image[ip], available, &jpeg[length], &room);
+            length += room;
+        } while (ip < total || instance.state != JPEGENC_STATE_HEADER || instance.out_write != 0);
+    }
+    t1 = now();
+
+    /* all the frames have the same length, the last one is decoded */
+    frame_length = length / NFRAMES;
+    src = &jpeg[length - frame_length];
+    srclen = frame_length;
+    srcpos = 0;
+    dec_width = c->width;
+    rc = jd_prepare(&jd, tjpgd_input, pool, sizeof(pool), 0);
+    if (rc == JDR_OK)
+        rc = jd_decomp(&jd, tjpgd_output, 0);
+
+    for (y = 0; y < c->height; y++)
+    {   for (x = 0; x < c->width; x++)
+        {   input_rgb(c, x, y, &r, &g, &b);
+            in[0] = r; in[1] = g; in[2] = b;
+            for (k = 0; k < 3; k++)
+            {   d = in[k] - decoded[(y * c->width + x) * 3 + k];
+                mse += d * d;
+            }
+        }
+    }
+    mse /= (double)c->width * c->height * 3;
+
+    printf("%-20s %7ld B/frame %5.2f bpp %6.0f fps %6.1f Mpix/s, TJpgDec rc %d, PSNR %.1f dB\n",
+        c->name, frame_length, frame_length * 8.0 / ((double)c->width * c->height), NFRAMES / (t1 - t0),
+        NFRAMES * (double)c->width * c->height / (t1 - t0) / 1e6, rc, 10 * log10(255.0 * 255.0 / mse));
+}
+
+int main (void)
+{   int x, y, n, i;
+    double v;
+
+    srand(2);
+    for (y = 0; y < 480; y++)
+    {   for (x = 0; x < 640; x++)
+        {   v = 128 + 60 * sin(x * 0.03) * cos(y * 0.02) + ((((x / 40) + (y / 40)) & 1) ? 30 : -30);
+            n = rand() % 9 - 4;
+            rgb[(y * 640 + x) * 3 + 0] = (uint8_t)clip((int)(v + x * 64 / 640));
+            rgb[(y * 640 + x) * 3 + 1] = (uint8_t)clip((int)(v * 0.8 + y * 0.1) + n);
+            rgb[(y * 640 + x) * 3 + 2] = (uint8_t)clip((int)(255 - v * 0.7));
+        }
+    }
+
+    for (i = 0; i < (int)(sizeof(configs) / sizeof(configs[0])); i++)
+        test(&configs[i]);
+    return 0;
+}
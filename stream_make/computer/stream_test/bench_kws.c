@@ -0,0 +1,370 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_kws.c
+ * Description:  host test of the keyword spotting node sigp_stream_kws
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2026 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    The processing file is included to reach its static functions :
+    - accuracy of kws_log2 and kws_exp2_neg
+    - log-mel bands of the last hop against a double-precision DFT at input levels 20000,
+      300 and 8, and the TSC cycles of the front end (kws_features)
+    - int8 maps and posteriors of a random 32-channel 4-block model against an independent
+      reference, and the cycles of each step of the inference (kws_step)
+    - events of 5 seconds of noise given in pieces of 173 samples, and the stalls of the
+      input when the output arc has no room for the event of a hop
+    The real FFT of the service is generic_rfft_q31 of CMSIS-DSP.
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O3 -D__GNUC_PYTHON__ -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/signal-processingFR/kws \
+        -Istream_platform/platform_services/stream_libraries/CMSIS-DSP/Include \
+        stream_make/computer/stream_test/bench_kws.c \
+        stream_platform/platform_services/stream_libraries/CMSIS-DSP/Source/TransformFunctions/generic_fft.c \
+        -lm -o bench_kws
+    ./bench_kws
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+#include "sigp_stream_kws_process.c"
+
+/* dsp/generic_transform_functions.h declares again generic_fft_plan of presets.h */
+extern void generic_fft_table_init (void *pTable, uint32_t tableLen, uint8_t arith);
+extern void generic_fft_plan_init (generic_fft_plan *S, uint16_t fftLen, uint8_t arith, const void *pTable, uint32_t tableLen);
+extern void generic_rfft_q31 (const generic_fft_plan *S, const int32_t *pSrc, int32_t *pDst);
+
+#define FS 16000
+
+static sigp_kws_memory TCM;
+static kws_model model;
+static sigp_kws_instance instance;
+static uint8_t fft_table[1 << 16];
+static generic_fft_plan plan;
+static int16_t sig[FS], ev[15 * 100];
+
+/* reference network */
+static int8_t features[KWS_NB_FRAMES][KWS_NB_MFCC];
+static int8_t map0[KWS_MAP_T][KWS_MAP_F][KWS_MAX_CHANNELS], map1[KWS_MAP_T][KWS_MAP_F][KWS_MAX_CHANNELS];
+
+/* SERV_DSP_INIT returns the plan, the other commands are the real FFT */
+static void services (uint32_t command, intptr_t ptr1, intptr_t ptr2, intptr_t ptr3, intptr_t n)
+{   if (RD(command, COMMAND_SSRV) == SERV_DSP_INIT)
+    {   generic_fft_table_init(fft_table, (uint32_t)n, GENERIC_FFT_Q31);
+        generic_fft_plan_init(&plan, (uint16_t)n, GENERIC_FFT_Q31, fft_table, (uint32_t)n);
+        *(void **)ptr1 = &plan;
+    } else
+        generic_rfft_q31((generic_fft_plan *)ptr1, (const int32_t *)ptr2, (int32_t *)ptr3);
+}
+
+static uint32_t seed = 1;
+static int rnd (int a)
+{   seed = seed * 1103515245 + 12345;
+    return (int)((seed >> 8) % (2 * a + 1)) - a;
+}
+static double urand (void)
+{   seed = seed * 1103515245 + 12345;
+    return ((seed >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+static int relu (int64_t a, int shift)
+{   int64_t r = shift ? (a + (1LL << (shift - 1))) >> shift : a;
+    return (r < 0) ? 0 : (r > 127) ? 127 : (int)r;
+}
+
+/* convolution 10x4 stride 2, depthwise 3x3 and pointwise blocks, average pool, softmax */
+static void reference (kws_model *m, double *post)
+{   int c = m->channels, t, f, ch, ci, i, j, b, k, tt, ff, s, shift = m->shift[9];
+    double logit[KWS_MAX_CLASSES], mx = -1e30, sum = 0;
+    int avg[KWS_MAX_CHANNELS];
+    int64_t a;
+
+    for (t = 0; t < KWS_MAP_T; t++)
+    for (f = 0; f < KWS_MAP_F; f++)
+    for (ch = 0; ch < c; ch++)
+    {   a = m->conv_bias[ch];
+        for (i = 0; i < KWS_CONV_T; i++)
+            for (j = 0; j < KWS_CONV_F; j++)
+            {   tt = 2 * t - KWS_PAD_T + i; ff = 2 * f - KWS_PAD_F + j;
+                if (tt >= 0 && tt < KWS_NB_FRAMES && ff >= 0 && ff < KWS_NB_MFCC)
+                    a += m->conv_weight[ch][i * KWS_CONV_F + j] * features[tt][ff];
+            }
+        map0[t][f][ch] = (int8_t)relu(a, m->shift[0]);
+    }
+    for (b = 0; b < m->nblocks; b++)
+    {   for (t = 0; t < KWS_MAP_T; t++)
+        for (f = 0; f < KWS_MAP_F; f++)
+        for (ch = 0; ch < c; ch++)
+        {   a = m->dw_bias[b][ch];
+            for (i = -1; i <= 1; i++)
+                for (j = -1; j <= 1; j++)
+                {   tt = t + i; ff = f + j;
+                    if (tt >= 0 && tt < KWS_MAP_T && ff >= 0 && ff < KWS_MAP_F)
+                        a += m->dw_weight[b][(i + 1) * 3 + j + 1][ch] * map0[tt][ff][ch];
+                }
+            map1[t][f][ch] = (int8_t)relu(a, m->shift[1 + 2 * b]);
+        }
+        for (t = 0; t < KWS_MAP_T; t++)
+        for (f = 0; f < KWS_MAP_F; f++)
+        for (ch = 0; ch < c; ch++)
+        {   a = m->pw_bias[b][ch];
+            for (ci = 0; ci < c; ci++)
+                a += m->pw_weight[b][ch][ci] * map1[t][f][ci];
+            map0[t][f][ch] = (int8_t)relu(a, m->shift[2 + 2 * b]);
+        }
+    }
+    for (ch = 0; ch < c; ch++)
+    {   for (s = 0, t = 0; t < KWS_MAP_T; t++)
+            for (f = 0; f < KWS_MAP_F; f++)
+                s += map0[t][f][ch];
+        avg[ch] = (s + KWS_MAP_SIZE / 2) / KWS_MAP_SIZE;
+    }
+    for (k = 0; k < m->nclasses; k++)
+    {   a = m->fc_bias[k];
+        for (ch = 0; ch < c; ch++)
+            a += m->fc_weight[k][ch] * avg[ch];
+        logit[k] = (double)((a + ((1LL << shift) >> 1)) >> shift) / 256.0;
+        if (logit[k] > mx) mx = logit[k];
+    }
+    for (k = 0; k < m->nclasses; k++)
+    {   post[k] = exp(logit[k] - mx);
+        sum += post[k];
+    }
+    for (k = 0; k < m->nclasses; k++)
+        post[k] /= sum;
+}
+
+static void random_model (kws_model *m)
+{   int8_t *w = &(m->conv_weight[0][0]);
+    size_t i, nw = sizeof(m->conv_weight) + sizeof(m->dw_weight) + sizeof(m->pw_weight) + sizeof(m->fc_weight);
+    int b, c, k;
+
+    memset(m, 0, sizeof(*m));
+    m->nclasses = 12;
+    m->channels = 32;
+    m->nblocks = 4;
+    m->shift[0] = 8;
+    for (b = 0; b < 4; b++)
+    {   m->shift[1 + 2 * b] = 6;
+        m->shift[2 + 2 * b] = 8;
+    }
+    m->shift[9] = 4;
+    for (k = 0; k < KWS_NB_MFCC; k++)
+    {   m->feature_offset[k] = (k == 0) ? 20 * 1024 : 0;
+        m->feature_mult[k] = (k == 0) ? 256 * 8 : 256 * 16;
+    }
+    for (i = 0; i < nw; i++)
+        w[i] = (int8_t)rnd(60);
+    for (c = 0; c < 32; c++)
+    {   m->conv_bias[c] = rnd(2000);
+        for (b = 0; b < 4; b++)
+        {   m->dw_bias[b][c] = rnd(500);
+            m->pw_bias[b][c] = rnd(2000);
+        }
+    }
+    for (k = 0; k < 12; k++)
+        m->fc_bias[k] = rnd(3000);
+}
+
+static void test_math (void)
+{   double e = 0, d;
+    uint64_t x;
+    int i;
+
+    for (i = 0; i < 200000; i++)
+    {   x = ((uint64_t)seed << 20) ^ ((uint64_t)(seed * 7) << 40);
+        seed = seed * 1103515245 + 12345;
+        x >>= (seed >> 27) % 60;
+        if (x == 0)
+            continue;
+        d = fabs(kws_log2(x) / 1024.0 - log2((double)x));
+        if (d > e) e = d;
+    }
+    printf("kws_log2 max error %.5f\n", e);
+    for (e = 0, i = 0; i < 16 * 256; i++)
+    {   d = fabs(kws_exp2_neg(i) / 32768.0 - pow(2, -i / 256.0));
+        if (d > e) e = d;
+    }
+    printf("kws_exp2_neg max error %.6f\n", e);
+}
+
+static void test_front_end (void)
+{   static const double levels[3] = { 20000, 300, 8 };
+    double E[KWS_NB_MEL + 2], re, im, v, lf, lr, d, emax, emean, a;
+    const int16_t *x = &sig[FS - KWS_WINDOW];
+    uint64_t t0, best = ~0ull;
+    int lev, n, i, k, b, s, r;
+    int32_t m, nev;
+
+    for (lev = 0; lev < 3; lev++)
+    {   a = levels[lev];
+        for (n = 0; n < FS; n++)
+            sig[n] = (int16_t)lrint(a * (0.5 * sin(2 * M_PI * 440 * n / FS) + 0.3 * sin(2 * M_PI * 2500 * n / FS + 1) + 0.2 * (urand() - 0.5)));
+        nev = 100;
+        sigp_stream_kws_process(&instance, sig, FS, ev, &nev);
+
+        /* normalization shift of the last window */
+        for (m = 0, i = 0; i < KWS_WINDOW; i++)
+            m |= ABS(x[i] * kws_window[i]);
+        for (s = 0; s < 30 && 0 == (m >> (29 - s)); s++)
+            ;
+        memset(E, 0, sizeof(E));
+        for (i = 0; i < KWS_MEL_NB_BINS; i++)
+        {   k = i + 2;
+            re = im = 0;
+            for (n = 0; n < KWS_WINDOW; n++)
+            {   v = x[n] * (kws_window[n] / 32768.0);
+                re += v * cos(2 * M_PI * k * n / KWS_FFT_LEN);
+                im -= v * sin(2 * M_PI * k * n / KWS_FFT_LEN);
+            }
+            b = kws_mel_segment[i];
+            E[b] += (re * re + im * im) * kws_mel_weight[i] / 32768.0;
+            E[b + 1] += (re * re + im * im) * (32768 - kws_mel_weight[i]) / 32768.0;
+        }
+        emax = emean = 0;
+        for (b = 0; b < KWS_NB_MEL; b++)
+        {   lf = (kws_log2(TCM.mel[b + 1]) - ((2 * s + KWS_LOG2_OFFSET) << 10)) / 1024.0;
+            lr = log2(E[b + 1]);
+            d = fabs(lf - lr);
+            emean += d / KWS_NB_MEL;
+            if (d > emax) emax = d;
+        }
+        printf("level %5.0f, shift %2d : log-mel error max %.4f mean %.4f (log2)\n", a, s, emax, emean);
+    }
+
+    for (n = 0; n < FS; n++)
+        sig[n] = (int16_t)rnd(8000);
+    for (r = 0; r < 20; r++)
+    {   instance.fill = 0;
+        t0 = __rdtsc();
+        kws_features(&instance);
+        t0 = __rdtsc() - t0;
+        if (t0 < best) best = t0;
+    }
+    printf("front end : %llu cycles per hop\n", (unsigned long long)best);
+}
+
+static void test_network (void)
+{   uint64_t cycles[KWS_MAX_BLOCKS + 2], t0, total;
+    double post[KWS_MAX_CLASSES], d, perr = 0;
+    int trial, t, f, r, k, nsteps, bad = 0;
+
+    random_model(&model);
+    sigp_stream_kws_load(&instance);
+    for (trial = 0; trial < 20; trial++)
+    {   for (t = 0; t < KWS_NB_FRAMES; t++)
+            for (f = 0; f < KWS_NB_MFCC; f++)
+                features[t][f] = (int8_t)rnd(100);
+
+        /* ring of features written twice, the window starts at instance.write */
+        instance.write = (uint8_t)(trial % KWS_NB_FRAMES);
+        for (t = 0; t < KWS_NB_FRAMES; t++)
+        {   r = (instance.write + t) % KWS_NB_FRAMES;
+            for (f = 0; f < KWS_NB_MFCC; f++)
+                TCM.features[r][f] = TCM.features[r + KWS_NB_FRAMES][f] = features[t][f];
+        }
+
+        instance.step = 0;
+        for (nsteps = 0; instance.step < model.nblocks + 2; nsteps++)
+        {   t0 = __rdtsc();
+            kws_step(&instance);
+            cycles[nsteps] = __rdtsc() - t0;
+        }
+        reference(&model, post);
+        bad += (memcmp(TCM.map[0], map0, sizeof(map0)) != 0);
+        for (k = 0; k < model.nclasses; k++)
+        {   d = fabs(instance.posterior[k] / 32768.0 - post[k]);
+            if (d > perr) perr = d;
+        }
+    }
+    printf("maps different from the reference : %d/20, posterior max error %.5f\n", bad, perr);
+    printf("cycles of the steps of the inference :");
+    for (total = 0, k = 0; k < nsteps; k++)
+    {   printf(" %llu", (unsigned long long)cycles[k]);
+        total += cycles[k];
+    }
+    printf(", total %llu\n", (unsigned long long)total);
+}
+
+static void test_events (void)
+{   int r, pos, chunk, consumed, hop_end, total = 0, flags = 0, sph, stalls, events;
+    int32_t nev;
+
+    sigp_stream_kws_init(&instance);
+    for (r = 0; r < 5; r++)
+    {   for (pos = 0; pos < FS; pos++)
+            sig[pos] = (int16_t)rnd(8000);
+        for (pos = 0; pos < FS; pos += consumed)
+        {   chunk = MIN(FS - pos, 173);
+            nev = 1;
+            consumed = sigp_stream_kws_process(&instance, &sig[pos], chunk, ev, &nev);
+            total += nev;
+            flags += (nev && ev[0]);
+        }
+    }
+    printf("5 s of noise, period of %d hops : %d events, %d detections\n", instance.config.period, total, flags);
+
+    /* no room for events : the input is consumed up to the hop which ends an inference */
+    for (sph = 0; sph <= 2; sph += 2)
+    {   instance.config.steps_per_hop = (uint8_t)sph;
+        sigp_stream_kws_init(&instance);
+        stalls = events = 0;
+        for (r = 0; r < 3; r++)
+        {   for (pos = 0; pos < FS; pos++)
+                sig[pos] = (int16_t)rnd(8000);
+            for (pos = 0; pos < FS; pos += consumed)
+            {   chunk = MIN(FS - pos, 173);
+                nev = 0;
+                consumed = sigp_stream_kws_process(&instance, &sig[pos], chunk, ev, &nev);
+                if (consumed < chunk)
+                {   stalls++;
+                    hop_end = instance.fill;
+                    pos += consumed;
+                    nev = 1;
+                    consumed = sigp_stream_kws_process(&instance, &sig[pos], KWS_HOP - hop_end, ev, &nev);
+                    events += nev;
+                }
+            }
+        }
+        printf("3 s, steps_per_hop %d, no room for events : %d stalls, %d followed by an event\n", sph, stalls, events);
+    }
+}
+
+int main (void)
+{   kws_parameters config = { 10, 0, 1, 2, 22938, 4, 0 };
+
+    test_math();
+
+    instance.TCM = &TCM;
+    instance.model = &model;
+    instance.services = (stream_services *)services;
+    instance.config = config;
+    sigp_stream_kws_init(&instance);
+
+    test_front_end();
+    test_network();
+    test_events();
+    return 0;
+}
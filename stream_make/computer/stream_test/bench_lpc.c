@@ -0,0 +1,160 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_lpc.c
+ * Description:  host test of the lossless LPC/Rice mode of the compressor nodes
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2026 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    Round trip of encode_lpc_frame / decode_lpc_frame :
+    - the WAV files of this folder (16-bit mono) in frames of 1024 and 2048 samples, with LPC up
+      to order 8 and with the fixed predictors only (max order 0), and as stereo frames of 512
+    - a synthetic 3-axis accelerometer, zeros and white noise, frames of 256
+    Prints the compression ratio, the encoder and decoder speed and the samples that differ
+    from the input. The last test flips bits in the stream and counts the bytes skipped by
+    the decoder to find the next valid header.
+
+    Build and run from the root of the repository (host gcc) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/signal-processingFR/compressor -Istream_nodes/signal-processingFR/decompressor \
+        stream_make/computer/stream_test/bench_lpc.c \
+        stream_nodes/signal-processingFR/compressor/sigp_stream_compressor_lpc.c \
+        stream_nodes/signal-processingFR/decompressor/sigp_stream_decompressor_lpc.c -lm -o bench_lpc
+    ./bench_lpc stream_make/computer/stream_test/
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "sigp_stream_compressor_lpc.h"
+#include "sigp_stream_decompressor_lpc.h"
+
+static int32_t scratch[2048];
+
+static double now (void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* 16-bit samples after the 44-byte header of a WAV file */
+static int16_t *load_wav (const char *folder, const char *name, long *nsamples)
+{   char path[512];
+    int16_t *samples;
+    long size;
+    FILE *f;
+
+    snprintf(path, sizeof(path), "%s%s", folder, name);
+    if ((f = fopen(path, "rb")) == 0)
+    {   printf("%s not found\n", path);
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 44, SEEK_SET);
+    *nsamples = (size - 44) / 2;
+    samples = malloc(size);
+    *nsamples = (long)fread(samples, 2, *nsamples, f);
+    fclose(f);
+    return samples;
+}
+
+/* encode then decode nframes of nchan x frame_length samples, corrupt : bits flipped in the stream */
+static void round_trip (const char *name, int16_t *x, long nsamples, int nchan, int frame_length, int max_order, int corrupt)
+{   long nframes = nsamples / nchan / frame_length, n = nframes * frame_length * nchan;
+    long pos = 0, ip = 0, op = 0, f, i;
+    uint8_t *encoded = malloc(n * 2 + nframes * 64);
+    int16_t *decoded = calloc(n + 4096, sizeof(int16_t));
+    int mismatches = 0, skipped = 0;
+    double t0, t1, t2, t3;
+    uint32_t nsamp;
+    int32_t consumed;
+
+    t0 = now();
+    for (f = 0; f < nframes; f++)
+        pos += encode_lpc_frame(scratch, x + f * frame_length * nchan, nchan, frame_length, (uint8_t)max_order, encoded + pos);
+    t1 = now();
+
+    if (corrupt)
+        for (i = 1; i <= 5; i++)
+            encoded[(pos / 7) * i] ^= 0x10;
+
+    t2 = now();
+    while (ip < pos)
+    {   consumed = decode_lpc_frame(scratch, encoded + ip, (uint32_t)(pos - ip), 0, nchan, decoded + op, (uint32_t)(n + 4096 - op), 0, &nsamp);
+        if (consumed == 0)
+            break;
+        if (nsamp == 0)
+            skipped += consumed;
+        ip += consumed;
+        op += nsamp * nchan;
+    }
+    t3 = now();
+
+    for (i = 0; i < n && i < op; i++)
+        mismatches += (decoded[i] != x[i]);
+    printf("%-14s %dch frames %4d order %d : ratio %.2f, encode %5.1f Ms/s, decode %5.1f Ms/s, %d mismatches",
+        name, nchan, frame_length, max_order, (double)n * 2 / pos, n / (t1 - t0) / 1e6, n / (t3 - t2) / 1e6, mismatches);
+    if (corrupt)
+        printf(", %ld/%ld samples decoded, %d bytes skipped", op, n, skipped);
+    printf("\n");
+    free(encoded);
+    free(decoded);
+}
+
+int main (int argc, char **argv)
+{   static const char *files[] = { "test0.wav", "test3.wav", "data_in_0.wav", "buff.wav" };
+    const char *folder = (argc > 1) ? argv[1] : "";
+    long n, i;
+    int16_t *x;
+    int k, c;
+
+    for (k = 0; k < 4; k++)
+    {   if ((x = load_wav(folder, files[k], &n)) == 0)
+            continue;
+        round_trip(files[k], x, n, 1, 1024, 8, 0);
+        round_trip(files[k], x, n, 1, 1024, 0, 0);
+        round_trip(files[k], x, n, 1, 2048, 8, 0);
+        round_trip(files[k], x, n, 2, 512, 8, 0);
+        if (k == 0)
+            round_trip("corrupted", x, n, 1, 1024, 8, 1);
+        free(x);
+    }
+
+    n = 300000;
+    x = malloc(n * 3 * sizeof(int16_t));
+    srand(1);
+    for (i = 0; i < n; i++)
+        for (c = 0; c < 3; c++)
+            x[i*3 + c] = (int16_t)(4000 * sin(i * 0.01 * (c + 1)) + (c == 2 ? 16384 : 0) + rand() % 64 - 32);
+    round_trip("accelerometer", x, n * 3, 3, 256, 8, 0);
+    round_trip("accelerometer", x, n * 3, 3, 256, 0, 0);
+    memset(x, 0, n * 3 * sizeof(int16_t));
+    round_trip("zeros", x, n * 3, 3, 256, 8, 0);
+    for (i = 0; i < n * 3; i++)
+        x[i] = (int16_t)rand();
+    round_trip("noise", x, n * 3, 3, 256, 8, 0);
+    free(x);
+    return 0;
+}
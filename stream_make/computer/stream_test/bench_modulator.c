@@ -0,0 +1,266 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_modulator.c
+ * Description:  host test of the NCO and of the AM/FM/IQ modes of arm_stream_modulator
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    Checks of arm_stream_modulator_process at 48kHz, 100ms per call :
+    - error of the NCO against sin() on 430000 phases (S32, amplitude 32767)
+    - rising zero crossings of a 1kHz tone and of FM with constant inputs
+    - AM envelope with the inputs -1, 0, +1 and an index of 0.8, in the 3 formats
+    - I/Q : a 1kHz baseband on a 11kHz carrier against the ideal 12kHz upper sideband
+    Then the TSC cycles per sample of each mode (fastest of 300 calls of 4800 samples) and
+    the corresponding samples per second. Returns the number of failed checks.
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/arm/modulator \
+        stream_make/computer/stream_test/bench_modulator.c \
+        stream_nodes/arm/modulator/arm_stream_modulator_process.c \
+        stream_nodes/arm/modulator/arm_stream_modulator_vgm.c \
+        stream_nodes/arm/modulator/arm_stream_nco.c -lm -o bench_modulator
+    ./bench_modulator
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_modulator.h"
+
+#define FS 48000
+#define N 4800
+
+static arm_stream_modulator_instance instance;
+static int16_t x16[2 * N], y16[N];
+static int32_t x32[2 * N], y32[N];
+static float xf[2 * N], yf[N];
+
+static const int raws[3] = { STREAM_S16, STREAM_S32, STREAM_FP32 };
+static const char *names[3] = { "s16", "s32", "f32" };
+
+static void setup (int raw, int mode, double f, int amplitude)
+{   memset(&instance, 0, sizeof(instance));
+    instance.raw = (uint8_t)raw;
+    instance.config.mode = (uint8_t)mode;
+    instance.config.nb_tones = 1;
+    instance.config.increment[0] = MODULATOR_INCREMENT(f, FS);
+    instance.config.amplitude[0] = (int16_t)amplitude;
+    arm_stream_modulator_init(&instance);
+}
+
+static void *input (int r)
+{   return (r == 0) ? (void *)x16 : (r == 1) ? (void *)x32 : (void *)xf;
+}
+
+static void *output (int r)
+{   return (r == 0) ? (void *)y16 : (r == 1) ? (void *)y32 : (void *)yf;
+}
+
+static double sample (int r, int i)
+{   return (r == 0) ? y16[i] / 32768.0 : (r == 1) ? y32[i] / 2147483648.0 : yf[i];
+}
+
+static int crossings (int r)
+{   int i, n = 0;
+
+    for (i = 1; i < N; i++)
+        n += (sample(r, i - 1) < 0 && sample(r, i) >= 0);
+    return n;
+}
+
+static int checks (void)
+{   double emax = 0, e, ref, peak[3], v, a, b, g, xv;
+    int32_t nout, nin;
+    int err = 0, zc, mx, i, r, level;
+    uint32_t p;
+
+    /* NCO accuracy */
+    for (p = 0; p < 0xFFFFFF00u; p += 9973)
+    {   setup(STREAM_S32, MODULATOR_MODE_TONES, 0, 32767);
+        instance.phase[0] = p;
+        nout = 1;
+        arm_stream_modulator_process(&instance, 0, 0, (uint8_t *)y32, &nout);
+        ref = sin(p * (2 * M_PI / 4294967296.0)) * 32767 / 32768.0;
+        e = fabs(y32[0] / 2147483648.0 - ref);
+        if (e > emax) emax = e;
+    }
+    printf("NCO max error %.2e (%.1f dB)\n", emax, 20 * log10(emax));
+    err += (emax > 6e-6);
+
+    /* 1kHz tone */
+    setup(STREAM_S16, MODULATOR_MODE_TONES, 1000, 16384);
+    nout = N;
+    nin = arm_stream_modulator_process(&instance, (uint8_t *)x16, 0, (uint8_t *)y16, &nout);
+    for (mx = 0, i = 0; i < N; i++)
+        if (abs(y16[i]) > mx) mx = abs(y16[i]);
+    zc = crossings(0);
+    printf("1kHz s16 : %d crossings, peak %d, consumed %d produced %d\n", zc, mx, nin, nout);
+    err += (abs(zc - 100) > 1 || mx < 16380 || mx > 16384);
+
+    /* FM, carrier 10kHz, deviation 2kHz, inputs 0.5, -0.5 and 1.0 */
+    setup(STREAM_FP32, MODULATOR_MODE_FM, 10000, 32767);
+    instance.config.fm_deviation = MODULATOR_INCREMENT(2000, FS);
+    arm_stream_modulator_init(&instance);
+    for (i = 0; i < N; i++) xf[i] = 0.5f;
+    nout = N;
+    arm_stream_modulator_process(&instance, (uint8_t *)xf, N, (uint8_t *)yf, &nout);
+    zc = crossings(2);
+    printf("FM f32 11kHz : %d crossings\n", zc);
+    err += (abs(zc - 1100) > 1);
+
+    setup(STREAM_S16, MODULATOR_MODE_FM, 10000, 32767);
+    instance.config.fm_deviation = MODULATOR_INCREMENT(2000, FS);
+    arm_stream_modulator_init(&instance);
+    for (i = 0; i < N; i++) x16[i] = -16384;
+    nout = N;
+    arm_stream_modulator_process(&instance, (uint8_t *)x16, N, (uint8_t *)y16, &nout);
+    zc = crossings(0);
+    printf("FM s16 9kHz : %d crossings\n", zc);
+    err += (abs(zc - 900) > 1);
+
+    setup(STREAM_S32, MODULATOR_MODE_FM, 10000, 32767);
+    instance.config.fm_deviation = MODULATOR_INCREMENT(2000, FS);
+    arm_stream_modulator_init(&instance);
+    for (i = 0; i < N; i++) x32[i] = 0x7FFFFFFF;
+    nout = N;
+    arm_stream_modulator_process(&instance, (uint8_t *)x32, N, (uint8_t *)y32, &nout);
+    zc = crossings(1);
+    printf("FM s32 12kHz : %d crossings\n", zc);
+    err += (abs(zc - 1200) > 1);
+
+    /* AM envelope */
+    for (r = 0; r < 3; r++)
+    {   for (level = 0; level < 3; level++)
+        {   setup(raws[r], MODULATOR_MODE_AM, 1000, 16384);
+            instance.config.am_index = 26214;
+            xv = level - 1.0;
+            for (i = 0; i < N; i++)
+            {   x16[i] = (int16_t)((xv > 0) ? 32767 : xv * 32768);
+                x32[i] = (int32_t)((xv > 0) ? 0x7FFFFFFF : xv * 2147483648.0);
+                xf[i] = (float)xv;
+            }
+            nout = N;
+            arm_stream_modulator_process(&instance, input(r), N, output(r), &nout);
+            for (peak[level] = 0, i = 0; i < N; i++)
+                if (fabs(sample(r, i)) > peak[level]) peak[level] = fabs(sample(r, i));
+        }
+        printf("AM %s : peaks %.4f %.4f %.4f\n", names[r], peak[0], peak[1], peak[2]);
+        err += (fabs(peak[0] - 0.1) > 1e-3 || fabs(peak[1] - 0.5) > 1e-3 || fabs(peak[2] - 0.9) > 1e-3);
+    }
+
+    /* I/Q : I = cos, Q = sin of the baseband, projection on the upper sideband */
+    for (r = 0; r < 3; r++)
+    {   setup(raws[r], MODULATOR_MODE_IQ, 11000, 32767);
+        for (i = 0; i < N; i++)
+        {   a = 0.5 * cos(2 * M_PI * 1000 * i / FS);
+            b = 0.5 * sin(2 * M_PI * 1000 * i / FS);
+            x16[2 * i] = (int16_t)(a * 32767); x16[2 * i + 1] = (int16_t)(b * 32767);
+            x32[2 * i] = (int32_t)(a * 2147483647); x32[2 * i + 1] = (int32_t)(b * 2147483647);
+            xf[2 * i] = (float)a; xf[2 * i + 1] = (float)b;
+        }
+        nout = N;
+        nin = arm_stream_modulator_process(&instance, input(r), 2 * N, output(r), &nout);
+        for (a = b = 0, i = 0; i < N; i++)
+        {   ref = cos(2 * M_PI * 12000.0 * i / FS);
+            b += sample(r, i) * ref;
+            a += ref * ref;
+        }
+        g = b / a;
+        for (a = e = 0, i = 0; i < N; i++)
+        {   ref = g * cos(2 * M_PI * 12000.0 * i / FS);
+            v = sample(r, i) - ref;
+            e += v * v;
+            a += ref * ref;
+        }
+        printf("IQ %s : consumed %d produced %d, SNR %.1f dB\n", names[r], nin, nout, 10 * log10(a / e));
+        err += (10 * log10(a / e) < ((r == 0) ? 80 : 95));
+    }
+    return err;
+}
+
+/* TSC frequency, to convert the cycles to samples per second */
+static double tsc_ghz (void)
+{   struct timespec t0, t1;
+    unsigned long long c0;
+    double ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    c0 = __rdtsc();
+    do
+    {   clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+    } while (ns < 2e8);
+    return (__rdtsc() - c0) / ns;
+}
+
+static void timing (void)
+{   static const char *modes[5] = { "1 tone", "4 tones", "AM", "FM", "IQ" };
+    unsigned long long t, best;
+    double ghz = tsc_ghz(), cps;
+    int md, r, rep, k, mode;
+    int32_t nout;
+
+    printf("TSC %.2f GHz, cycles per sample and Msamples/s\n", ghz);
+    for (md = 0; md < 5; md++)
+    {   printf("%-8s", modes[md]);
+        mode = (md < 2) ? MODULATOR_MODE_TONES : md - 1;
+        for (r = 0; r < 3; r++)
+        {   best = ~0ull;
+            for (rep = 0; rep < 300; rep++)
+            {   setup(raws[r], mode, 1000, 16384);
+                if (md == 1)
+                {   instance.config.nb_tones = 4;
+                    for (k = 1; k < 4; k++)
+                    {   instance.config.increment[k] = MODULATOR_INCREMENT(1000 * (k + 2), FS);
+                        instance.config.amplitude[k] = 4000;
+                    }
+                }
+                instance.config.fm_deviation = 1 << 26;
+                instance.config.am_index = 20000;
+                nout = N;
+                t = __rdtsc();
+                arm_stream_modulator_process(&instance, input(r), (mode == MODULATOR_MODE_IQ) ? 2 * N : N, output(r), &nout);
+                t = __rdtsc() - t;
+                if (t < best) best = t;
+            }
+            cps = best / (double)N;
+            printf("  %s %5.2f %5.0f", names[r], cps, ghz * 1e3 / cps);
+        }
+        printf("\n");
+    }
+}
+
+int main (void)
+{   int err = checks();
+
+    timing();
+    printf(err ? "%d checks failed\n" : "checks passed\n", err);
+    return err;
+}
@@ -0,0 +1,310 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_resampler_ssrc.c
+ * Description:  host test of the polyphase L/M preset of sigp_stream_resampler
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    RESAMPLER_PRESET_SSRC on the host (x86) :
+    - SNR of a 997Hz tone for each ratio, S16 / S32 / FP32, the group delay is searched
+    - 600s simulation of two clock domains with the fill-level drift compensation
+      (RESAMPLER_DRIFT_FILL) : 1ms blocks at Fs_in x (1 + ppm) and at Fs_out
+    - TSC cycles per output sample, 1 to 8 channels, and the cycles of a folded FIR
+      decimator of the same length for comparison
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        stream_make/computer/stream_test/bench_resampler_ssrc.c \
+        stream_nodes/signal-processingFR/resampler/sigp_stream_resampler.c \
+        stream_nodes/signal-processingFR/resampler/sigp_stream_resampler_process.c \
+        stream_nodes/stream_common_fill_control.c -lm -o bench_resampler_ssrc
+    ./bench_resampler_ssrc
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "signal-processingFR/resampler/sigp_stream_resampler.h"
+
+extern void sigp_stream_resampler (unsigned int command, void *instance, void *data, unsigned int *status);
+
+#define FIFO_FRAMES 8192
+#define MAXCHAN 8
+
+static sigp_stream_resampler_instance instance;
+static int32_t coefs[RESAMPLER_MAX_COEFS];                  /* node_mem 1 */
+static int32_t delay[RESAMPLER_DELAY_FRAMES * MAXCHAN];     /* node_mem 2 */
+static uint32_t reset_status;
+
+static const char *raw_name (int raw)
+{   return (raw == STREAM_S16) ? "s16" : (raw == STREAM_S32) ? "s32" : "f32";
+}
+
+/* memresults = {instance, node_mem 1, node_mem 2, 4 format words of arc 0, 4 format words of arc 1,
+    input buffer size}, then the drift mode with SET_PARAMETER */
+static void reset (int raw, int nchan, float fs_in, float fs_out, int in_frames, int out_frames, int drift)
+{   intptr_t memresults[13] = { (intptr_t)&instance, (intptr_t)coefs, (intptr_t)delay };
+    uint32_t fmt1 = 0, command = 0, status;
+    int sample = (raw == STREAM_S16) ? 2 : 4;
+
+    ST(fmt1, RAW_FMT1, raw);
+    ST(fmt1, NCHANM1_FMT1, nchan - 1);
+    memresults[3] = in_frames * nchan * sample;
+    memresults[4] = fmt1;
+    memcpy(&memresults[5], &fs_in, sizeof(float));
+    memresults[7] = out_frames * nchan * sample;
+    memresults[8] = fmt1;
+    memcpy(&memresults[9], &fs_out, sizeof(float));
+    memresults[11] = 4096 * nchan * sample;
+
+    ST(command, COMMAND_CMD, STREAM_RESET);
+    ST(command, PRESET_CMD, RESAMPLER_PRESET_SSRC);
+    sigp_stream_resampler(command, memresults, 0, &reset_status);
+
+    command = 0;
+    ST(command, COMMAND_CMD, STREAM_SET_PARAMETER);
+    ST(command, NODE_TAG_CMD, drift);
+    sigp_stream_resampler(command, &instance, 0, &status);
+}
+
+/* one call : sizes in bytes, updated with the consumed and produced bytes */
+static void run (void *in, intptr_t *nin, void *out, intptr_t *nout)
+{   stream_xdmbuffer_t data[2];
+    uint32_t command = 0, status;
+
+    data[0].address = (intptr_t)in;  data[0].size = *nin;
+    data[1].address = (intptr_t)out; data[1].size = *nout;
+    ST(command, COMMAND_CMD, STREAM_RUN);
+    sigp_stream_resampler(command, &instance, data, &status);
+    *nin = data[0].size;
+    *nout = data[1].size;
+}
+
+static double snr (const float *out, int nout, double ratio, double group_delay, double f0, double fs_in)
+{   double ps = 0, pe = 0, ideal;
+    int k;
+
+    for (k = nout / 4; k < nout - 50; k++)
+    {   ideal = 0.7 * sin(2 * M_PI * f0 * (k * ratio - group_delay) / fs_in);
+        ps += ideal * ideal;
+        pe += (out[k] - ideal) * (out[k] - ideal);
+    }
+    return 10 * log10(ps / pe);
+}
+
+/* tone SNR, the group delay is searched by steps of 1/8 then 1/500 of input sample */
+static void quality (int raw, double fs_in, double fs_out, double f0)
+{   enum { N = 24000 };
+    static float in[N], out[6*N];
+    static int16_t in16[N], out16[6*N];
+    static int32_t in32[N], out32[6*N];
+    double ratio, best = -1e9, best_delay = 0, s, dl;
+    intptr_t nin, nout;
+    int i, nout_samples, sample = (raw == STREAM_S16) ? 2 : 4;
+
+    reset(raw, 1, (float)fs_in, (float)fs_out, 0, 0, RESAMPLER_DRIFT_OFF);
+    if (instance.disabled)
+    {   printf("  %s %5.0f -> %5.0f : not supported (reset status %u)\n", raw_name(raw), fs_in, fs_out, reset_status);
+        return;
+    }
+    for (i = 0; i < N; i++)
+        in[i] = (float)(0.7 * sin(2 * M_PI * f0 * i / fs_in));
+
+    nin = N * sample; nout = 6 * N * sample;
+    if (raw == STREAM_S16)
+    {   for (i = 0; i < N; i++) in16[i] = (int16_t)lrint(in[i] * 32767);
+        run(in16, &nin, out16, &nout);
+        for (i = 0; i < nout/2; i++) out[i] = out16[i] / 32767.f;
+    }
+    else if (raw == STREAM_S32)
+    {   for (i = 0; i < N; i++) in32[i] = (int32_t)(in[i] * 2147483647.0);
+        run(in32, &nin, out32, &nout);
+        for (i = 0; i < nout/4; i++) out[i] = (float)(out32[i] / 2147483647.);
+    }
+    else
+    {   run(in, &nin, out, &nout);
+    }
+
+    nout_samples = (int)(nout / sample);
+    ratio = (double)instance.step / ((double)instance.Q * 4294967296.0);    /* input samples per output */
+    for (dl = -2; dl <= instance.T + 4; dl += 0.125)
+    {   s = snr(out, nout_samples, ratio, dl, f0, fs_in);
+        if (s > best) { best = s; best_delay = dl; }
+    }
+    for (dl = best_delay - 0.125; dl <= best_delay + 0.125; dl += 0.002)
+    {   s = snr(out, nout_samples, ratio, dl, f0, fs_in);
+        if (s > best) best = s;
+    }
+    printf("  %s %5.0f -> %5.0f (L=%d M=%d) : SNR %.1f dB\n", raw_name(raw), fs_in, fs_out, instance.L, instance.M, best);
+}
+
+/* two clock domains, 600 seconds, stereo, blocks of 1ms */
+static void drift (int raw, double fs_in, double fs_out, double ppm)
+{   static float fifo[FIFO_FRAMES * 2], outf[FIFO_FRAMES];
+    static int16_t in16[FIFO_FRAMES * 2], out16[FIFO_FRAMES];
+    static int32_t in32[FIFO_FRAMES * 2], out32[FIFO_FRAMES];
+    const int nchan = 2, sample = (raw == STREAM_S16) ? 2 : 4;
+    const int block_in = (int)(fs_in / 1000), block_out = (int)(fs_out / 1000);
+    double t_in = 0, t_out = 0, phase = 0, consumed = 0, produced = 0, sum = 0, sum2 = 0, rel;
+    double period_in = block_in / (fs_in * (1 + ppm * 1e-6)), period_out = block_out / fs_out;
+    long ncall = 0, nstat = 0;
+    int fill = 0, underflows = 0, i, c;
+    intptr_t nin, nout;
+
+    reset(raw, nchan, (float)fs_in, (float)fs_out, block_in, block_out, RESAMPLER_DRIFT_FILL);
+    while (t_in < 600 || t_out < 600)
+    {   if (t_in <= t_out)
+        {   if (fill > FIFO_FRAMES - block_in)
+            {   printf("  %s overflow\n", raw_name(raw));
+                return;
+            }
+            for (i = 0; i < block_in; i++, fill++, phase++)
+                for (c = 0; c < nchan; c++)
+                    fifo[fill * nchan + c] = (float)(0.5 * sin(2 * M_PI * 500 * phase / fs_in + c));
+            t_in += period_in;
+            continue;
+        }
+
+        nin = fill * nchan * sample; nout = block_out * nchan * sample;
+        if (raw == STREAM_S16)
+        {   for (i = 0; i < fill * nchan; i++) in16[i] = (int16_t)(fifo[i] * 32767);
+            run(in16, &nin, out16, &nout);
+        }
+        else if (raw == STREAM_S32)
+        {   for (i = 0; i < fill * nchan; i++) in32[i] = (int32_t)(fifo[i] * 2147483647.0);
+            run(in32, &nin, out32, &nout);
+        }
+        else
+        {   run(fifo, &nin, outf, &nout);
+        }
+        nin /= nchan * sample;
+        nout /= nchan * sample;
+        memmove(fifo, fifo + nin * nchan, (fill - nin) * nchan * sizeof(float));
+        fill -= (int)nin;
+
+        if (nout < block_out && ncall > 5)
+            underflows++;
+        if (ncall > 60000)                          /* after the acquisition */
+        {   consumed += nin; produced += nout;
+            rel = (double)instance.step / instance.step_nominal - 1;
+            sum += rel; sum2 += rel * rel; nstat++;
+        }
+        ncall++;
+        t_out += period_out;
+    }
+    sum /= nstat;
+    printf("  %s %5.0f -> %5.0f drift %+4.0f ppm : underflows %d, input/output %+6.1f ppm, mean step %+6.1f ppm, rms %4.1f ppm\n",
+        raw_name(raw), fs_in, fs_out, ppm, underflows, (consumed * instance.L / (produced * instance.M) - 1) * 1e6,
+        sum * 1e6, sqrt(sum2 / nstat - sum * sum) * 1e6);
+}
+
+static void cycles (int raw, double fs_in, double fs_out)
+{   enum { N = 4800 };
+    static int32_t in[N * MAXCHAN], out[6 * N * MAXCHAN];
+    unsigned long long best, t0, t1;
+    int nchan, i, r, sample = (raw == STREAM_S16) ? 2 : 4;
+    intptr_t nin, nout = 0;
+
+    printf("  %s %5.0f -> %5.0f", raw_name(raw), fs_in, fs_out);
+    for (nchan = 1; nchan <= MAXCHAN; nchan *= 2)
+    {   for (i = 0; i < N * nchan; i++)
+        {   if (raw == STREAM_FP32) ((float *)in)[i] = sinf(i * 0.01f);
+            else if (raw == STREAM_S16) ((int16_t *)in)[i] = (int16_t)((i * 2654435761u) >> 16);
+            else in[i] = (int32_t)((i * 2654435761u) >> 2);
+        }
+        best = ~0ull;
+        for (r = 0; r < 20; r++)
+        {   reset(raw, nchan, (float)fs_in, (float)fs_out, 0, 0, RESAMPLER_DRIFT_OFF);
+            nin = N * nchan * sample; nout = 6 * N * nchan * sample;
+            t0 = __rdtsc();
+            run(in, &nin, out, &nout);
+            t1 = __rdtsc();
+            if (t1 - t0 < best) best = t1 - t0;
+        }
+        printf("   %dch %5.1f", nchan, (double)best / (nout / sample));
+    }
+    printf("\n");
+}
+
+/* reference : folded symmetric FIR decimator, q31 */
+static void cycles_reference (int M, int taps)
+{   enum { N = 4800 };
+    static int32_t in[N + 256], out[N];
+    static volatile int32_t hv[512];
+    int32_t h[512];
+    unsigned long long best = ~0ull, t0, t1;
+    long long check = 0;
+    int64_t acc;
+    int i, n, t, r, nout = 0;
+
+    for (i = 0; i < taps; i++) { hv[i] = i * 1000; h[i] = hv[i]; }
+    for (i = 0; i < N + 256; i++) in[i] = (int32_t)((i * 2654435761u) >> 2);
+    for (r = 0; r < 20; r++)
+    {   t0 = __rdtsc();
+        for (nout = 0, n = taps; n < N; n += M)
+        {   acc = (int64_t)h[taps/2] * in[n - taps/2];
+            for (t = 0; t < taps/2; t++)
+                acc += (int64_t)h[t] * ((int64_t)in[n - t] + in[n - taps + 1 + t]);
+            out[nout++] = (int32_t)(acc >> 30);
+        }
+        t1 = __rdtsc();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    for (i = 0; i < nout; i++) check += out[i];
+    printf("  reference folded FIR decimator M=%d, %d taps : %.1f (checksum %lld)\n", M, taps, (double)best / nout, check);
+}
+
+int main (void)
+{   static const int raws[3] = { STREAM_S16, STREAM_S32, STREAM_FP32 };
+    static const double rates[][2] = { {48000,24000}, {24000,48000}, {48000,16000}, {16000,48000},
+        {48000,32000}, {32000,48000}, {48000,40000}, {40000,48000}, {48000,8000}, {8000,48000}, {44100,48000} };
+    int r, p;
+
+    printf("tone SNR\n");
+    for (p = 0; p < (int)(sizeof(rates)/sizeof(rates[0])); p++)
+        for (r = 0; r < 3; r++)
+            quality(raws[r], rates[p][0], rates[p][1], 997);
+
+    printf("drift, fill-level compensation\n");
+    for (r = 0; r < 3; r++)
+    {   drift(raws[r], 48000, 48000, +300);
+        drift(raws[r], 48000, 48000, -300);
+    }
+    drift(STREAM_S16, 16000, 48000, +200);
+    drift(STREAM_S16, 48000, 16000, -200);
+    drift(STREAM_FP32, 48000, 8000, +100);
+    drift(STREAM_FP32, 8000, 48000, -100);
+
+    printf("TSC cycles per output sample\n");
+    for (r = 0; r < 3; r++)
+        cycles(raws[r], 48000, 16000);
+    cycles(STREAM_S16, 48000, 24000);
+    cycles(STREAM_S16, 16000, 48000);
+    cycles_reference(3, 49);
+    cycles_reference(2, 33);
+    return 0;
+}
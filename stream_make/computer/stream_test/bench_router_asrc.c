@@ -0,0 +1,248 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_router_asrc.c
+ * Description:  host test of the Farrow ASRC preset of arm_stream_router
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    ROUTER_PRESET_ASRC on the host (x86) :
+    - SNR of a 997Hz tone converted with a fixed ratio, S16 / S32 / FP32
+    - 600s simulation of two clock domains with a drift : a producer writes blocks of 48 frames
+      at Fs_in x (1 + ppm), the consumer asks blocks of 48 frames at Fs_out. Reports the
+      underflows, the consumed / produced ratio against the nominal one, the mean step
+      correction and its rms jitter
+    - TSC cycles per output sample, 1 to 8 channels (best of 20 calls)
+
+    Build and run from the root of the repository (host gcc, x86) :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        stream_make/computer/stream_test/bench_router_asrc.c stream_nodes/arm/router/arm_stream_router.c \
+        stream_nodes/arm/router/arm_stream_router_asrc.c stream_nodes/arm/router/arm_stream_router_process.c \
+        stream_nodes/stream_common_fill_control.c -lm -o bench_router_asrc
+    ./bench_router_asrc
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm/router/arm_stream_router.h"
+
+extern void arm_stream_router (unsigned int command, void *instance, void *data, unsigned int *status);
+
+#define BLOCK 48                    /* frames of the producer and of the consumer */
+#define FIFO_FRAMES 4096
+#define MAXCHAN 8
+
+static arm_stream_router_instance instance;
+static router_asrc asrc;            /* node_mem 1 */
+
+static const char *raw_name (int raw)
+{   return (raw == STREAM_S16) ? "s16" : (raw == STREAM_S32) ? "s32" : "f32";
+}
+
+/* memresults = {instance, node_mem 1, 4 format words of arc 0, 4 format words of arc 1, input buffer size} */
+static void reset (int raw, int nchan, float fs_in, float fs_out, int out_frames)
+{   intptr_t memresults[12] = { (intptr_t)&instance, (intptr_t)&asrc };
+    uint32_t fmt1 = 0, command = 0, status;
+    int sample = (raw == STREAM_S16) ? 2 : 4;
+
+    ST(fmt1, RAW_FMT1, raw);
+    ST(fmt1, NCHANM1_FMT1, nchan - 1);
+    memresults[2] = out_frames * nchan * sample;
+    memresults[3] = fmt1;
+    memcpy(&memresults[4], &fs_in, sizeof(float));
+    memresults[6] = out_frames * nchan * sample;
+    memresults[7] = fmt1;
+    memcpy(&memresults[8], &fs_out, sizeof(float));
+    memresults[10] = FIFO_FRAMES * nchan * sample;
+
+    ST(command, COMMAND_CMD, STREAM_RESET);
+    ST(command, PRESET_CMD, ROUTER_PRESET_ASRC);
+    arm_stream_router(command, memresults, 0, &status);
+}
+
+/* one call : sizes in bytes, updated with the consumed and produced bytes */
+static void run (void *in, intptr_t *nin, void *out, intptr_t *nout)
+{   stream_xdmbuffer_t data[2];
+    uint32_t command = 0, status;
+
+    data[0].address = (intptr_t)in;  data[0].size = *nin;
+    data[1].address = (intptr_t)out; data[1].size = *nout;
+    ST(command, COMMAND_CMD, STREAM_RUN);
+    arm_stream_router(command, &instance, data, &status);
+    *nin = data[0].size;
+    *nout = data[1].size;
+}
+
+/* pure tone through a fixed ratio, SNR against the ideal sine */
+static void quality (int raw, double fs_in, double fs_out)
+{   enum { N = 16384 };
+    static float in[N], out[2*N];
+    static int16_t in16[N], out16[2*N];
+    static int32_t in32[N], out32[2*N];
+    const double f0 = 997;
+    double ps = 0, pe = 0, step = fs_in / fs_out, ideal;
+    intptr_t nin, nout;
+    int i, k, nout_samples, sample = (raw == STREAM_S16) ? 2 : 4;
+
+    reset(raw, 1, (float)fs_in, (float)fs_out, 0);
+    asrc.fill.fill_target = N << 8;             /* no pre-roll, no ratio correction */
+    for (i = 0; i < N; i++)
+        in[i] = (float)(0.7 * sin(2 * M_PI * f0 * i / fs_in));
+
+    nin = N * sample; nout = 2 * N * sample;
+    if (raw == STREAM_S16)
+    {   for (i = 0; i < N; i++) in16[i] = (int16_t)(in[i] * 32767);
+        run(in16, &nin, out16, &nout);
+        for (i = 0; i < nout/2; i++) out[i] = out16[i] / 32767.f;
+    }
+    else if (raw == STREAM_S32)
+    {   for (i = 0; i < N; i++) in32[i] = (int32_t)(in[i] * 2147483647.0);
+        run(in32, &nin, out32, &nout);
+        for (i = 0; i < nout/4; i++) out[i] = (float)(out32[i] / 2147483647.);
+    }
+    else
+    {   run(in, &nin, out, &nout);
+    }
+
+    /* output k is the input at time k x step - 2 (interpolation between taps 1 and 2) */
+    nout_samples = (int)(nout / sample);
+    for (k = 100; k < nout_samples - 100; k++)
+    {   ideal = 0.7 * sin(2 * M_PI * f0 * (k * step - 2.0) / fs_in);
+        ps += ideal * ideal;
+        pe += (out[k] - ideal) * (out[k] - ideal);
+    }
+    printf("  %s %5.0f -> %5.0f : SNR %.1f dB\n", raw_name(raw), fs_in, fs_out, 10 * log10(ps / pe));
+}
+
+/* two clock domains, 600 seconds, stereo */
+static void drift (int raw, double fs_in, double fs_out, double ppm)
+{   static float fifo[FIFO_FRAMES * MAXCHAN], outf[BLOCK * MAXCHAN];
+    static int16_t in16[FIFO_FRAMES * MAXCHAN], out16[BLOCK * MAXCHAN];
+    static int32_t in32[FIFO_FRAMES * MAXCHAN], out32[BLOCK * MAXCHAN];
+    const int nchan = 2, sample = (raw == STREAM_S16) ? 2 : 4;
+    double t_in = 0, t_out = 0, phase = 0, consumed = 0, produced = 0, sum = 0, sum2 = 0, ratio;
+    double period_in = BLOCK / (fs_in * (1 + ppm * 1e-6)), period_out = BLOCK / fs_out;
+    long ncall = 0, nstat = 0;
+    int fill = 0, underflows = 0, i, c;
+    intptr_t nin, nout;
+
+    reset(raw, nchan, (float)fs_in, (float)fs_out, BLOCK);
+    while (t_in < 600 || t_out < 600)
+    {   if (t_in <= t_out)
+        {   if (fill > FIFO_FRAMES - BLOCK)
+            {   printf("  %s overflow\n", raw_name(raw));
+                return;
+            }
+            for (i = 0; i < BLOCK; i++, fill++, phase++)
+                for (c = 0; c < nchan; c++)
+                    fifo[fill * nchan + c] = (float)(0.5 * sin(2 * M_PI * 1000 * phase / fs_in + c));
+            t_in += period_in;
+            continue;
+        }
+
+        nin = fill * nchan * sample; nout = BLOCK * nchan * sample;
+        if (raw == STREAM_S16)
+        {   for (i = 0; i < fill * nchan; i++) in16[i] = (int16_t)(fifo[i] * 32767);
+            run(in16, &nin, out16, &nout);
+        }
+        else if (raw == STREAM_S32)
+        {   for (i = 0; i < fill * nchan; i++) in32[i] = (int32_t)(fifo[i] * 2147483647.0);
+            run(in32, &nin, out32, &nout);
+        }
+        else
+        {   run(fifo, &nin, outf, &nout);
+        }
+        nin /= nchan * sample;
+        nout /= nchan * sample;
+        memmove(fifo, fifo + nin * nchan, (fill - nin) * nchan * sizeof(float));
+        fill -= (int)nin;
+
+        if (nout < BLOCK && ncall > 20)             /* after the pre-roll */
+            underflows++;
+        if (ncall > 30000)                          /* after the acquisition */
+        {   consumed += nin; produced += nout;
+            ratio = (double)asrc.step / asrc.step_nominal - 1;
+            sum += ratio; sum2 += ratio * ratio; nstat++;
+        }
+        ncall++;
+        t_out += period_out;
+    }
+    sum /= nstat;
+    printf("  %s %5.0f -> %5.0f drift %+4.0f ppm : underflows %d, input/output %+6.1f ppm, mean step %+6.1f ppm, rms %4.1f ppm\n",
+        raw_name(raw), fs_in, fs_out, ppm, underflows, (consumed * fs_out / (produced * fs_in) - 1) * 1e6, sum * 1e6,
+        sqrt(sum2 / nstat - sum * sum) * 1e6);
+}
+
+static void cycles (int raw)
+{   enum { N = 4096 };
+    static int32_t in[N * MAXCHAN], out[2 * N * MAXCHAN];
+    unsigned long long best, t0, t1;
+    int nchan, i, r, sample = (raw == STREAM_S16) ? 2 : 4;
+    intptr_t nin, nout = 0;
+
+    printf("  %s", raw_name(raw));
+    for (nchan = 1; nchan <= MAXCHAN; nchan *= 2)
+    {   reset(raw, nchan, 44100, 48000, 0);
+        for (i = 0; i < N * nchan; i++)
+        {   if (raw == STREAM_FP32) ((float *)in)[i] = sinf(i * 0.01f);
+            else in[i] = (int32_t)((i * 2654435761u) >> 8);
+        }
+        best = ~0ull;
+        for (r = 0; r < 20; r++)
+        {   nin = N * nchan * sample; nout = 2 * N * nchan * sample;
+            t0 = __rdtsc();
+            run(in, &nin, out, &nout);
+            t1 = __rdtsc();
+            if (t1 - t0 < best) best = t1 - t0;
+        }
+        printf("   %dch %5.1f", nchan, (double)best / (nout / sample));
+    }
+    printf("   (TSC cycles per output sample)\n");
+}
+
+int main (void)
+{   static const int raws[3] = { STREAM_S16, STREAM_S32, STREAM_FP32 };
+    int r;
+
+    printf("tone SNR\n");
+    for (r = 0; r < 3; r++)
+    {   quality(raws[r], 44100, 48000);
+        quality(raws[r], 48000, 44100);
+    }
+    printf("drift\n");
+    for (r = 0; r < 3; r++)
+    {   drift(raws[r], 48000, 48000, +300);
+        drift(raws[r], 48000, 48000, -300);
+        drift(raws[r], 44100, 48000, +150);
+    }
+    drift(STREAM_FP32, 48000, 48000, +500);
+    drift(STREAM_S16, 48000, 16000, -200);
+    printf("cycles, 44.1k -> 48k\n");
+    for (r = 0; r < 3; r++)
+        cycles(raws[r]);
+    return 0;
+}
@@ -0,0 +1,231 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_tjpgdec.c
+ * Description:  host test of the MCU-row streaming JPEG decoder TjpgDec
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    A synthetic image is encoded with bitbank_JPEGENC, the bit-stream of 10 frames separated
+    by 37 bytes of garbage is given to TjpgDec_process in chunks (8 kB by default) through an
+    input arc of 16 kB, with an output arc of two rows of MCU. Each decoded frame is compared
+    with jd_decomp() of the whole frame, at the scales 1/1 to 1/8. Prints the frames found,
+    the frames that differ, the frames per second of the node and of jd_decomp() and the
+    bytes of the work area used by TJpgDec. A row of MCU larger than the input arc cannot be
+    decoded : with "700 4096" the 4:2:0 frames (more than 4 kB per row) are all skipped.
+
+    Build and run from the root of the repository (host gcc), the optional arguments are the
+    chunk and the input arc sizes in bytes :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/bitbank/JPEGENC -Istream_nodes/elm-lang/TJpgDec \
+        stream_make/computer/stream_test/bench_tjpgdec.c \
+        stream_nodes/bitbank/JPEGENC/bitbank_JPEGENC_process.c \
+        stream_nodes/elm-lang/TJpgDec/TjpgDec_process.c \
+        stream_nodes/elm-lang/TJpgDec/tjpgd3/src/tjpgd.c -lm -o bench_tjpgdec
+    ./bench_tjpgdec 8192 16384
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "bitbank_JPEGENC.h"
+#include "TjpgDec.h"
+
+#define NFRAMES 10
+#define GARBAGE 37
+
+typedef struct
+{   const char *name;
+    int width, height, pixel_type, subsample, quality;
+} config_t;
+
+static const config_t configs[] =
+{   { "QVGA gray",   320, 240, JPEGENC_PIXEL_GRAYSCALE, JPEGENC_SUBSAMPLE_444, JPEGENC_Q_HIGH },
+    { "QVGA 4:2:0",  320, 240, JPEGENC_PIXEL_RGB565,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_HIGH },
+    { "VGA gray",    640, 480, JPEGENC_PIXEL_GRAYSCALE, JPEGENC_SUBSAMPLE_444, JPEGENC_Q_HIGH },
+    { "VGA 4:2:0",   640, 480, JPEGENC_PIXEL_RGB565,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_HIGH },
+    { "VGA 4:4:4",   640, 480, JPEGENC_PIXEL_RGB888,    JPEGENC_SUBSAMPLE_444, JPEGENC_Q_BEST },
+    { "333x201",     333, 201, JPEGENC_PIXEL_RGB888,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_HIGH },
+};
+
+static bitbank_JPEGENC_tables tables;
+static uint8_t staging[JPEGENC_OUT_BYTES];
+static uint8_t image[640*480*3];
+static uint8_t jpeg[640*480*3];
+static uint8_t stream[NFRAMES * (640*480*3 + GARBAGE)];
+static uint8_t reference[640*480*TJPGDEC_BYTES_PER_PIXEL];
+static uint8_t decoded[NFRAMES * 640*480*TJPGDEC_BYTES_PER_PIXEL];
+static uint8_t pool[TJPGDEC_POOL_BYTES], node_pool[TJPGDEC_POOL_BYTES], saved_inbuf[JD_SZBUF];
+
+static const uint8_t *src;              /* jd_decomp() input and output */
+static size_t srcpos, srclen;
+static int ref_width;
+
+static double now (void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static size_t ref_input (JDEC *jd, uint8_t *buf, size_t n)
+{   if (srcpos + n > srclen) n = srclen - srcpos;
+    if (buf) memcpy(buf, src + srcpos, n);
+    srcpos += n;
+    return n;
+}
+
+static int ref_output (JDEC *jd, void *bitmap, JRECT *rect)
+{   int w = (rect->right - rect->left + 1) * TJPGDEC_BYTES_PER_PIXEL, y;
+    uint8_t *s = bitmap;
+
+    for (y = rect->top; y <= rect->bottom; y++, s += w)
+        memcpy(&reference[(y * ref_width + rect->left) * TJPGDEC_BYTES_PER_PIXEL], s, w);
+    return 1;
+}
+
+/* one frame of a synthetic image, output arc of 1 kB */
+static long encode (const config_t *c)
+{   bitbank_JPEGENC_instance instance;
+    int bpp = (c->pixel_type == JPEGENC_PIXEL_GRAYSCALE) ? 1 : (c->pixel_type == JPEGENC_PIXEL_RGB565) ? 2 : 3;
+    int strip = ((c->pixel_type != JPEGENC_PIXEL_GRAYSCALE && c->subsample == JPEGENC_SUBSAMPLE_420) ? 16 : 8) * c->width * bpp;
+    long total = (long)c->width * c->height * bpp, length = 0, ip = 0;
+    int32_t room, available;
+    int x, y, k, t;
+    double v;
+
+    srand(3);
+    for (y = 0; y < c->height; y++)
+    {   for (x = 0; x < c->width; x++)
+        {   v = 128 + 60 * sin(x * 0.03) * cos(y * 0.02) + ((((x / 40) + (y / 40)) & 1) ? 30 : -30);
+            for (k = 0; k < bpp; k++)
+            {   t = (int)(v * (1 - 0.2 * k)) + rand() % 9 - 4;
+                image[(y * c->width + x) * bpp + k] = (uint8_t)((t < 0) ? 0 : (t > 255) ? 255 : t);
+            }
+        }
+    }
+
+    memset(&instance, 0, sizeof(instance));
+    instance.tables = &tables;
+    instance.out = staging;
+    instance.config.width = (uint16_t)c->width;
+    instance.config.height = (uint16_t)c->height;
+    instance.config.pixel_type = (uint8_t)c->pixel_type;
+    instance.config.subsample = (uint8_t)c->subsample;
+    instance.config.quality = (uint8_t)c->quality;
+    bitbank_JPEGENC_init(&instance);
+    do
+    {   room = 1024;
+        available = (int32_t)((total - ip < strip) ? total - ip : strip);
+        ip += bitbank_JPEGENC_process(&instance, &image[ip], available, &jpeg[length], &room);
+        length += room;
+    } while (ip < total || instance.state != JPEGENC_STATE_HEADER || instance.out_write != 0);
+    return length;
+}
+
+static void test (const config_t *c, int chunk, int arc_size)
+{   long length = encode(c), stream_length = 0, sp = 0, op = 0, frame_bytes;
+    int f, g, scale, mx, my, height, alen, add, calls, bad;
+    int32_t room, consumed, row_bytes;
+    double t0, t1, t2;
+    TjpgDec_instance instance;
+    uint8_t *arc = malloc(arc_size);
+    JDEC jd;
+
+    for (f = 0; f < NFRAMES; f++)
+    {   for (g = 0; g < GARBAGE; g++)
+            stream[stream_length++] = (uint8_t)(g * 7 + f);
+        memcpy(&stream[stream_length], jpeg, length);
+        stream_length += length;
+    }
+
+    for (scale = 0; scale < 4; scale++)
+    {   /* reference : jd_decomp() of one frame in memory */
+        src = jpeg; srclen = length; srcpos = 0;
+        jd_prepare(&jd, ref_input, pool, sizeof(pool), 0);
+        mx = jd.msx * 8;
+        my = jd.msy * 8;
+        ref_width = ((jd.width / mx * mx) >> scale) + ((jd.width % mx) >> scale);
+        height = ((jd.height / my * my) >> scale) + ((jd.height % my) >> scale);
+        frame_bytes = (long)ref_width * height * TJPGDEC_BYTES_PER_PIXEL;
+        jd_decomp(&jd, ref_output, (uint8_t)scale);
+        t0 = now();
+        for (f = 0; f < NFRAMES; f++)
+        {   srcpos = 0;
+            jd_prepare(&jd, ref_input, pool, sizeof(pool), 0);
+            jd_decomp(&jd, ref_output, (uint8_t)scale);
+        }
+        t1 = now();
+
+        /* node : the arc is refilled by chunks, consumed bytes are removed from its start */
+        memset(&instance, 0, sizeof(instance));
+        instance.pool = node_pool;
+        instance.saved_inbuf = saved_inbuf;
+        instance.config.scale = (uint8_t)scale;
+        TjpgDec_init(&instance);
+        instance.in_bufsize = (uint32_t)arc_size;
+        row_bytes = ref_width * (my >> scale) * TJPGDEC_BYTES_PER_PIXEL;
+        if (row_bytes == 0)
+            row_bytes = ref_width * TJPGDEC_BYTES_PER_PIXEL;
+        alen = 0; sp = 0; op = 0; calls = 0;
+        for (;;)
+        {   add = chunk;
+            if (add > arc_size - alen) add = arc_size - alen;
+            if (add > stream_length - sp) add = (int)(stream_length - sp);
+            memcpy(&arc[alen], &stream[sp], add);
+            alen += add;
+            sp += add;
+            room = 2 * row_bytes;
+            if (room > frame_bytes * NFRAMES - op) room = (int32_t)(frame_bytes * NFRAMES - op);
+            consumed = TjpgDec_process(&instance, arc, alen, &decoded[op], &room);
+            op += room;
+            memmove(arc, &arc[consumed], alen - consumed);
+            alen -= consumed;
+            if (sp >= stream_length && consumed == 0 && room == 0)
+                break;
+            if (++calls > 1000000)
+            {   printf("stuck in state %d\n", instance.state);
+                break;
+            }
+        }
+        t2 = now();
+
+        for (bad = f = 0; f < NFRAMES; f++)
+            bad += (memcmp(&decoded[f * frame_bytes], reference, frame_bytes) != 0);
+        printf("%-11s %6ld B scale 1/%d %3dx%3d : %ld/%d frames, %d differ, %6.0f fps (jd_decomp %6.0f), work area used %u\n",
+            c->name, length, 1 << scale, ref_width, height, op / frame_bytes, NFRAMES, bad,
+            NFRAMES / (t2 - t1), NFRAMES / (t1 - t0), (unsigned)(TJPGDEC_POOL_BYTES - instance.jd.sz_pool));
+    }
+    free(arc);
+}
+
+int main (int argc, char **argv)
+{   int chunk = (argc > 1) ? atoi(argv[1]) : 8192;
+    int arc_size = (argc > 2) ? atoi(argv[2]) : 16384;
+    int i;
+
+    printf("chunks of %d bytes, input arc of %d bytes, instance of %u bytes\n", chunk, arc_size, (unsigned)sizeof(TjpgDec_instance));
+    for (i = 0; i < (int)(sizeof(configs) / sizeof(configs[0])); i++)
+        test(&configs[i], chunk, arc_size);
+    return 0;
+}
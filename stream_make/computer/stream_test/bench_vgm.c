@@ -0,0 +1,267 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        bench_vgm.c
+ * Description:  host test of the VGM player (SN76489) of arm_stream_modulator
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2026 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/*
+    A VGM 1.51 stream is built in memory : a 440Hz tone for 0.5s, white noise for 0.25s,
+    two tones for 0.25s. Checks of the MODULATOR_MODE_VGM of arm_stream_modulator_process :
+    - zero crossings and peak of the tone, both signs of the noise, silence after the end
+    - the same samples from calls of 37 samples and from one call, and from the S16, S32
+      and FP32 outputs
+    - loop offset of the header, loop without wait, stream without header
+    Then the TSC cycles per output sample (fastest of 100 calls of 960 samples) with 0, 1,
+    3 tones and 3 tones with noise, at 8, 16 and 48kHz. Returns the number of failed checks.
+
+    Build and run from the root of the repository (host gcc, x86), -Os or -O2 :
+    gcc -O2 -Istream_platform -Istream_src -Istream_nodes -Istream_platform/computer \
+        -Istream_nodes/arm/modulator \
+        stream_make/computer/stream_test/bench_vgm.c \
+        stream_nodes/arm/modulator/arm_stream_modulator_process.c \
+        stream_nodes/arm/modulator/arm_stream_modulator_vgm.c \
+        stream_nodes/arm/modulator/arm_stream_nco.c -lm -o bench_vgm
+    ./bench_vgm
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <x86intrin.h>
+#include "presets.h"
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_modulator.h"
+
+#define N 48000
+#define CLOCK 3579545.0
+
+static arm_stream_modulator_instance instance;
+static uint8_t vgm[4096];
+static int vgm_length;
+static int16_t y[N], a[N], b[N];
+static int32_t y32[N];
+static float yf[N];
+
+static void w32 (int offset, uint32_t v)
+{   vgm[offset] = (uint8_t)v;
+    vgm[offset + 1] = (uint8_t)(v >> 8);
+    vgm[offset + 2] = (uint8_t)(v >> 16);
+    vgm[offset + 3] = (uint8_t)(v >> 24);
+}
+
+static void psg (int data)
+{   vgm[vgm_length++] = 0x50;
+    vgm[vgm_length++] = (uint8_t)data;
+}
+
+/* waits in samples at 44.1kHz */
+static void wait (int n)
+{   int k;
+
+    for (; n > 0; n -= k)
+    {   k = (n > 65535) ? 65535 : n;
+        vgm[vgm_length++] = 0x61;
+        vgm[vgm_length++] = (uint8_t)k;
+        vgm[vgm_length++] = (uint8_t)(k >> 8);
+    }
+}
+
+/* 10-bit period and attenuation of a tone channel */
+static void tone (int channel, int period, int attenuation)
+{   psg(0x80 | (channel << 5) | (period & 15));
+    psg((period >> 4) & 0x3F);
+    psg(0x90 | (channel << 5) | attenuation);
+}
+
+static void setup (int raw, int fs, const uint8_t *data, int size)
+{   memset(&instance, 0, sizeof(instance));
+    instance.raw = (uint8_t)raw;
+    instance.config.mode = MODULATOR_MODE_VGM;
+    instance.config.sampling_rate = (uint32_t)fs;
+    arm_stream_modulator_init(&instance);
+    instance.vgm.data = data;
+    instance.vgm.size = (uint32_t)size;
+}
+
+static int play (void *out, int n)
+{   int32_t nout = n;
+
+    arm_stream_modulator_process(&instance, 0, 0, (uint8_t *)out, &nout);
+    return nout;
+}
+
+static int crossings (const int16_t *x, int from, int to)
+{   int i, n = 0;
+
+    for (i = from + 1; i < to; i++)
+        n += (x[i - 1] < 0 && x[i] >= 0);
+    return n;
+}
+
+static int peak (const int16_t *x, int from, int to)
+{   int i, m = 0;
+
+    for (i = from; i < to; i++)
+        if (abs(x[i]) > m) m = abs(x[i]);
+    return m;
+}
+
+static int checks (void)
+{   uint8_t nowait[3] = { 0x50, 0x90, 0x66 };
+    uint8_t headerless[8] = { 0x50, 0x80 | 14, 0x50, 0x0F, 0x50, 0x90, 0x62, 0x66 };
+    int err = 0, z, m, pos, neg, i;
+    double f = CLOCK / 32 / 254;
+
+    /* header 1.51 : clock, data offset, noise feedback 9, shift register width 16 */
+    memset(vgm, 0, sizeof(vgm));
+    memcpy(vgm, "Vgm ", 4);
+    w32(0x08, 0x151);
+    w32(0x0C, (uint32_t)CLOCK);
+    w32(0x34, 0x40 - 0x34);
+    vgm[0x28] = 9;
+    vgm[0x2A] = 16;
+    vgm_length = 0x40;
+    tone(0, 254, 0);
+    wait(44100 / 2);
+    tone(0, 254, 15);
+    psg(0xE4);
+    psg(0xF0);
+    wait(44100 / 4);
+    psg(0xFF);
+    tone(1, 127, 2);
+    tone(2, 64, 4);
+    wait(44100 / 4);
+    vgm[vgm_length++] = 0x66;
+    w32(0x04, vgm_length - 4);
+
+    setup(STREAM_S16, 48000, vgm, vgm_length);
+    play(y, N);
+    z = crossings(y, 0, 24000);
+    m = peak(y, 0, 24000);
+    printf("tone : %d crossings in 0.5s (%.1f), peak %d\n", z, f / 2, m);
+    err += (fabs(z - f / 2) > 1.5 || m != 8191);
+    for (pos = neg = 0, i = 24100; i < 35900; i++)
+    {   pos += (y[i] > 0);
+        neg += (y[i] < 0);
+    }
+    printf("noise : %d positive, %d negative samples\n", pos, neg);
+    err += (pos < 3000 || neg < 3000);
+    printf("two tones : %d crossings in 0.25s\n", crossings(y, 36100, 47900));
+    play(y, N);
+    m = peak(y, 0, N);
+    printf("after the end : peak %d\n", m);
+    err += (m != 0);
+
+    /* calls of 37 samples, S32 and FP32 outputs */
+    setup(STREAM_S16, 48000, vgm, vgm_length);
+    play(a, N);
+    setup(STREAM_S16, 48000, vgm, vgm_length);
+    for (i = 0; i < N; i += 37)
+        play(&b[i], (i + 37 > N) ? N - i : 37);
+    if (memcmp(a, b, sizeof(a)))
+    {   printf("calls of 37 samples : different samples\n");
+        err++;
+    }
+    setup(STREAM_S32, 48000, vgm, vgm_length);
+    play(y32, N);
+    setup(STREAM_FP32, 48000, vgm, vgm_length);
+    play(yf, N);
+    for (i = 0; i < N; i++)
+    {   if (y32[i] != a[i] * 65536 || yf[i] != a[i] / 32768.f)
+        {   printf("sample %d : S32 or FP32 different from S16\n", i);
+            err++;
+            break;
+        }
+    }
+
+    /* loop on the first tone, the third second still plays */
+    w32(0x1C, 0x40 - 0x1C);
+    setup(STREAM_S16, 16000, vgm, vgm_length);
+    for (i = 0; i < 3; i++)
+        play(y, 16000);
+    m = peak(y, 0, 16000);
+    printf("loop : peak of the third second %d\n", m);
+    err += (m == 0);
+
+    setup(STREAM_S16, 48000, nowait, sizeof(nowait));
+    play(y, 100);
+    printf("stream without wait : state %d\n", instance.vgm.state);
+
+    /* 1/60s at 8kHz of a stream without header */
+    setup(STREAM_S16, 8000, headerless, sizeof(headerless));
+    play(y, 400);
+    printf("stream without header : %d crossings in 1/60s (%.1f)\n", crossings(y, 0, 133), f / 60);
+    return err;
+}
+
+static void timing (void)
+{   static const int rates[3] = { 8000, 16000, 48000 };
+    static const char *names[4] = { "silence", "1 tone", "3 tones", "3 tones + noise" };
+    unsigned long long t0, best;
+    int cfg, k, rep;
+
+    printf("TSC cycles per output sample\n");
+    for (cfg = 0; cfg < 4; cfg++)
+    {   vgm_length = 0x40;
+        memset(&vgm[0x40], 0, 100);
+        w32(0x1C, 0);
+        if (cfg >= 1)
+            tone(0, 254, 0);
+        if (cfg >= 2)
+        {   tone(1, 127, 2);
+            tone(2, 100, 4);
+        }
+        if (cfg == 3)
+        {   psg(0xE4);
+            psg(0xF2);
+        } else
+            psg(0xFF);
+        wait(44100 * 2);
+        vgm[vgm_length++] = 0x66;
+
+        printf("%-16s", names[cfg]);
+        for (k = 0; k < 3; k++)
+        {   best = ~0ull;
+            for (rep = 0; rep < 100; rep++)
+            {   setup(STREAM_S16, rates[k], vgm, vgm_length);
+                play(y, 480);
+                t0 = __rdtsc();
+                play(y, 960);
+                t0 = __rdtsc() - t0;
+                if (t0 < best) best = t0;
+            }
+            printf("  %5dHz %5.2f", rates[k], best / 960.0);
+        }
+        printf("\n");
+    }
+}
+
+int main (void)
+{   int err = checks();
+
+    timing();
+    printf(err ? "%d checks failed\n" : "checks passed\n", err);
+    return err;
+}
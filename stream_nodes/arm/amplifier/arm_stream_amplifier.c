@@ -1,13 +1,7 @@
 /* ----------------------------------------------------------------------
-
-
-        WORK ON GOING
-
-
-
  * Project:      CMSIS Stream
  * Title:        arm_stream_amplifier.c
- * Description:  filters
+ * Description:  per-channel gain, mute and smoothed gain changes
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -28,7 +22,7 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 
@@ -43,7 +37,7 @@ extern void arm_stream_amplifier (unsigned int command, void *instance, void *da
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 #include <stdint.h>
 #include "stream_common_const.h"
 #include "stream_common_types.h"
@@ -54,30 +48,48 @@ extern void arm_stream_amplifier (unsigned int command, void *instance, void *da
 ;----------------------------------------------------------------------------------------
 ;4.	arm_stream_amplifier
 ;----------------------------------------------------------------------------------------
-;   Operation : control of the amplitude of the input stream with controlled time of ramp-up/ramp-down. 
-;   The gain control "mute" is used to store the current gain setting, being reloaded with the command "unmute"
-;   Parameters :  new gain/mute/unmute, ramp-up/down slope, delay before starting the slope.
+;   Operation : gain of each channel of an interleaved stream (STREAM_S16, STREAM_S32,
+;   STREAM_FP32) with rounding and saturation, mute and unmute. The changes of gains and of
+;   the mute state are smoothed with a linear ramp (duration in frames) or an exponential ramp
+;   (time-constant 2^shift frames) from the gains in use.
+;   Parameters : gains of 8 channels (Q16, 65536 = 0dB), ramp duration, ramp type and
+;   time-constant, mute state.
+;   The reset returns NODE_TASKS_ERROR and the node is disabled with STREAM_FP32 arcs when
+;   STREAM_FLOAT_ALLOWED is 0.
 ;
-;   parameters of amplifier (variable size): 
-;   TAG_CMD = 1, uint8_t, 1st-order IIR shifter coefficient value (0..75k samples)
-;   TAG_CMD = 2, uint16_t, desired gain FP_8m4e, 0dB=0x0805
+;   parameters of amplifier (variable size):
+;   TAG_CMD = 1, uint16_t ramp duration (frames), uint8_t ramp type (0 linear, 1 exponential), uint8_t shift
+;   TAG_CMD = 2, int32_t x 8, gains Q16
 ;   TAG_CMD = 3, uint8_t, set/reset mute state
-;   TAG_CMD = 4, uint16_t, delay before applying unmute, in samples
-;   TAG_CMD = 5, uint16_t, delay before applying mute, in samples
 ;
-node arm_stream_amplifier; 
-    3  i8; 0 0 0        instance, no preset, tag=unmute
-    parameter_start <optional label for scripts>
-    1  i8;  1           rising/falling coefficient slope
-    1 h16;  805         gain -100dB .. +36dB (+/- 1%)
-    1  i8;  0           muted state
-    2 i16;  0 0         delay-up/down
-    parameter_end    
+;   presets control
+;   #0 : 0dB, linear ramps of 256 frames
+;   #1 : 0dB, exponential ramps, time-constant 128 frames
+;   #2 : 0dB muted, linear ramps of 1024 frames (fade-in with the unmute)
+;
+arm_stream_amplifier
+    3  i8; 0 0 0        instance, preset, tag
+    PARSTART
+    8; i32; 32768 32768 65536 65536 65536 65536 65536 65536;   gains -6dB -6dB 0dB ..
+    1; i16; 480;        linear ramp of 10ms at 48kHz
+    4; i8;  0 0 0 0;    ramp type, shift, mute, pad
+    PARSTOP
 */
 
+#define NB_PRESET 3
+#define AMPLIFIER_0DB {AMPLIFIER_UNITY, AMPLIFIER_UNITY, AMPLIFIER_UNITY, AMPLIFIER_UNITY, \
+                       AMPLIFIER_UNITY, AMPLIFIER_UNITY, AMPLIFIER_UNITY, AMPLIFIER_UNITY}
+
+const amplifier_parameters amplifier_preset [NB_PRESET] =
+{   /* gains, ramp_frames, ramp_type, exp_shift, mute */
+    {AMPLIFIER_0DB,  256, AMPLIFIER_RAMP_LINEAR, 0, 0, {0,0,0}},   /* #0 */
+    {AMPLIFIER_0DB,    0, AMPLIFIER_RAMP_EXP,    7, 0, {0,0,0}},   /* #1 */
+    {AMPLIFIER_0DB, 1024, AMPLIFIER_RAMP_LINEAR, 0, 1, {0,0,0}},   /* #2 */
+};
+
 
 /**
-  @brief         
+  @brief
   @param[in]     command    bit-field
   @param[in]     pinst      instance of the component
   @param[in/out] pdata      address and size of buffers
@@ -89,111 +101,128 @@ void arm_stream_amplifier (uint32_t command, void *instance, void *data, uint32_
     *status = NODE_TASKS_COMPLETED;    /* default return status, unless processing is not finished */
 
     switch (RD(command,COMMAND_CMD))
-    { 
+    {
         /* func(command = (STREAM_RESET, COLD, PRESET, TRACEID tag, NB ARCS IN/OUT)
-                instance = *memory_results,  
+                instance = *memory_results,
                 data = address of Stream function
-                
-                memresults are followed by 2 words of STREAM_FORMAT_SIZE_W32 of all the arcs 
-                memory pointers are in the same order as described in the NODE manifest
-        */
-        case STREAM_RESET: 
-        {
-            //stream_services *stream_entry = (stream_services *)data;
-            intptr_t *memresults = (intptr_t *)instance;
-            //uint16_t preset = RD(command, PRESET_CMD);
 
-            /* here reset */
-            arm_amplitude_instance *pinstance = (arm_amplitude_instance *) *memresults;
-            //pinstance->services = (stream_services *)data;
-
-            memresults++;   /* memresult points to the */
+                memresults are followed by 2 words of STREAM_FORMAT_SIZE_W32 of all the arcs
+                memory pointers are in the same order as described in the NODE manifest
 
-            /* copy the frame-size, interleaving scheme and nb of channels of each arc */
-            uint32_t tmp32;
+                memresult[0] : instance of the component
+                memresult[1] : line of gains
+                memresult[2] : input arc Word 0 SIZSFTRAW_FMT0 (frame size..)
+                memresult[3] : input arc Word 1 SAMPINGNCHANM1_FMT1
+        */
+        case STREAM_RESET:
+        {   intptr_t *memresult = (intptr_t *)instance;
+            uint16_t preset = RD(command, PRESET_CMD);
+            uint8_t *pt8bdst;
+            uint32_t i, n;
 
-            tmp32 = RD(memresults[0], FRAMESIZE_FMT0);
-            ST(pinstance->channel_fmt, FRAMESIZE_FMT0_FMT, tmp32);
+            arm_amplifier_instance *pinstance = (arm_amplifier_instance *) memresult[0];
 
-            tmp32 = RD(memresults[1], INTERLEAV_FMT1);
-            ST(pinstance->channel_fmt, INTERLEAVING_FMT, tmp32);
+            /* here reset */
+            pt8bdst = (uint8_t *) pinstance;
+            n = sizeof(arm_amplifier_instance);
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = 0;
+            }
+            pinstance->TCM = (arm_amplifier_memory *) memresult[1];
+            pinstance->nchan = (uint8_t)(RD(memresult[3], NCHANM1_FMT1) + 1u);   /* input arc format word 1 */
+            pinstance->raw = (uint8_t)(RD(memresult[3], RAW_FMT1));
+
+            /* no silent conversion of the other formats to STREAM_S16 */
+            pinstance->disabled = (uint8_t)(pinstance->raw != STREAM_S16 && pinstance->raw != STREAM_S32);
+#if STREAM_FLOAT_ALLOWED==1
+            pinstance->disabled &= (uint8_t)(pinstance->raw != STREAM_FP32);
+#endif
+            if (pinstance->disabled)
+            {   *status = NODE_TASKS_ERROR;
+            }
 
-            tmp32 = RD(memresults[1], NCHANM1_FMT1);
-            ST(pinstance->channel_fmt, NBCHANM1_AMPLI_FMT, tmp32);
-            
-            /* reset here */
+            pinstance->config = amplifier_preset[MIN(preset, NB_PRESET-1)];    /* preset data move */
+            arm_stream_amplifier_init(pinstance);
+            break;
         }
-        break;
-            
+
 
         /* func(command = bitfield (STREAM_SET_PARAMETER, PRESET, TAG, NB ARCS IN/OUT)
                     TAG of a parameter to set, NODE_ALL_PARAM means "set all the parameters" in a raw
-                *instance, 
+                *instance,
                 data = (one or all)
-        */ 
-        case STREAM_SET_PARAMETER:  
-        {
-            uint8_t *pt8bsrc;
-            uint8_t *pt8bdst;
-            uint8_t i;
-            uint8_t n;
-            arm_amplitude_instance *pinstance = (arm_amplitude_instance *) instance;
+        */
+        case STREAM_SET_PARAMETER:
+        {   arm_amplifier_instance *pinstance = (arm_amplifier_instance *) instance;
+            uint8_t *pt8bsrc, *pt8bdst;
+            uint8_t i, n;
 
-            pt8bsrc = (uint8_t *) data;     
-            pt8bdst = (uint8_t *) &(pinstance->parameters[0]); 
+            pt8bsrc = (uint8_t *) data;
+            pt8bdst = (uint8_t *) &(pinstance->config);
 
             switch (RD(command,NODE_TAG_CMD))
-            {   default : n = 1; break;
-                case TAG_CMD_RAMP :         pt8bdst = &pt8bdst[2]; n = 1; break;
-                case TAG_CMD_DESIRED_GAIN:                         n = 2; break;
-                case TAG_CMG_MUTE:          pt8bdst = &pt8bdst[3]; n = 1; break;
-                case TAG_CMD_DELAY_RAMPUP:  pt8bdst = &pt8bdst[6]; n = 2; break;
-                case TAG_CMD_DELAY_RAMPDOWN:pt8bdst = &pt8bdst[4]; n = 2; break;
-                case NODE_ALL_PARAM:             n = 8;               break;
+            {   default : n = 0; break;
+                case TAG_CMD_RAMP :         pt8bdst = (uint8_t *) &(pinstance->config.ramp_frames); n = 4; break;
+                case TAG_CMD_DESIRED_GAIN:  pt8bdst = (uint8_t *) &(pinstance->config.gain[0]); n = sizeof(pinstance->config.gain); break;
+                case TAG_CMG_MUTE:          pt8bdst = (uint8_t *) &(pinstance->config.mute); n = 1; break;
+                case NODE_ALL_PARAM:        n = sizeof(amplifier_parameters); break;
             }
-           
+
             for (i = 0; i < n; i++)
             {   pt8bdst[i] = pt8bsrc[i];
             }
+
+            /* ramp from the gains in use */
+            arm_stream_amplifier_target(pinstance);
+            break;
         }
-        break;
-   
+
         /* func(command = STREAM_RUN, PRESET, TAG, NB ARCS IN/OUT)
-               instance,  
+               instance,
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
-        */         
-        case STREAM_RUN:   
+               the same format on both arcs, interleaved channels,
+               the processing can be in-place
+        */
+        case STREAM_RUN:
         {
-            arm_amplitude_instance *pinstance = (arm_amplitude_instance *) instance;
-            intptr_t nb_data;
-            intptr_t stream_xdmbuffer_size;
+            arm_amplifier_instance *pinstance = (arm_amplifier_instance *) instance;
+            intptr_t nb_data, stream_xdmbuffer_size, bufferout_free;
             stream_xdmbuffer_t *pt_pt;
-            #define SAMP_IN uint8_t 
-            #define SAMP_OUT int16_t
-            SAMP_IN *inBuf;
-            SAMP_OUT *outBuf;
+            uint8_t *inBuf, *outBuf;
+            uint32_t bytes = (pinstance->raw == STREAM_S16) ? 2 : 4;
+
+            if (pinstance->disabled)
+            {   pt_pt = data;
+                pt_pt[0].size = 0;                  /* nothing consumed, nothing produced */
+                pt_pt[1].size = 0;
+                break;
+            }
 
             pt_pt = data;
-            inBuf  = (SAMP_IN *)pt_pt->address;   
+            inBuf  = (uint8_t *)pt_pt->address;
             stream_xdmbuffer_size    = pt_pt->size;
             pt_pt++;
-            outBuf = (SAMP_OUT *)(pt_pt->address); 
+            outBuf = (uint8_t *)(pt_pt->address);
+            bufferout_free        = pt_pt->size;
+
+            nb_data = MIN(stream_xdmbuffer_size, bufferout_free) / bytes;
+            nb_data = arm_stream_amplifier_process(pinstance, inBuf, outBuf, (int32_t)nb_data);
 
-            nb_data = stream_xdmbuffer_size / sizeof(SAMP_IN);
-            arm_stream_amplitude_process(pinstance, inBuf, outBuf /*, &nb_data*/);
+            pt_pt = data;
+            *(&(pt_pt->size)) = nb_data * bytes;    /* amount of data consumed */
+            pt_pt ++;
+            *(&(pt_pt->size)) = nb_data * bytes;    /* amount of data produced */
+            break;
         }
-        break;
 
 
 
         /* func(command = STREAM_STOP, PRESET, TAG, NB ARCS IN/OUT)
-               instance,  
+               instance,
                data = unused
-        */  
-        case STREAM_STOP:  break;    
+        */
+        case STREAM_STOP:  break;
         default : break;
     }
 }
@@ -1,13 +1,7 @@
 /* ----------------------------------------------------------------------
-
-
-        WORK ON GOING
-
-
-
  * Project:      CMSIS Stream
- * Title:        arm_stream_amplitude.h
- * Description:  filters
+ * Title:        arm_stream_amplifier.h
+ * Description:  per-channel gain, mute and smoothed gain changes
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -28,7 +22,7 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 
@@ -40,72 +34,82 @@
 #define CARM_STREAM_AMPLIFIER_H
 
 #include <stdint.h>
-//#include "../stream_nodes/stream_common_const.h"      
-//#include "../stream_nodes/stream_common_types.h"  
-#include "stream_common_const.h"      
-#include "stream_common_types.h"  
+#include "stream_common_const.h"
+#include "stream_common_types.h"
 
-#define TAG_CMD_RAMP 1
-#define TAG_CMD_DESIRED_GAIN 2
-#define TAG_CMG_MUTE 3              
-#define TAG_CMD_DELAY_RAMPUP 4
-#define TAG_CMD_DELAY_RAMPDOWN 5    
 
-typedef struct
+/*
+    Interleaved STREAM_S16, STREAM_S32 or STREAM_FP32 samples (same format on both arcs) are
+    multiplied by the gain of their channel (Q16, 65536 = 0dB) with rounding and saturation.
+    A change of the gains or of the mute state is applied with a ramp, per frame (one sample
+    of each channel) :
+        AMPLIFIER_RAMP_LINEAR : constant increment during ramp_frames, the target is reached exactly
+        AMPLIFIER_RAMP_EXP    : gain += (target - gain) >> exp_shift, at least one LSB per frame
+    The mute is a ramp to 0, the unmute a ramp back to the gains of the parameters.
+    The reset returns NODE_TASKS_ERROR and the node is disabled with other formats, and with
+    STREAM_FP32 when STREAM_FLOAT_ALLOWED is 0.
+*/
+
+#define TAG_CMD_RAMP                    1   /* SET_PARAMETER : uint16 ramp_frames, uint8 ramp_type, uint8 exp_shift */
+#define TAG_CMD_DESIRED_GAIN            2   /* SET_PARAMETER : int32 gain[AMPLIFIER_MAX_NCHAN], Q16 */
+#define TAG_CMG_MUTE                    3   /* SET_PARAMETER : uint8 mute state */
+
+#define AMPLIFIER_RAMP_LINEAR           0
+#define AMPLIFIER_RAMP_EXP              1
+
+#define AMPLIFIER_PRESET_UNITY          0   /* 0dB, linear ramps of 256 frames */
+#define AMPLIFIER_PRESET_UNITY_EXP      1   /* 0dB, exponential ramps, time-constant 128 frames */
+#define AMPLIFIER_PRESET_MUTED          2   /* 0dB muted, linear ramps of 1024 frames */
+
+#define AMPLIFIER_MAX_NCHAN             8
+#define AMPLIFIER_GAIN_Q               16   /* 65536 = 0dB */
+#define AMPLIFIER_UNITY                (1L << AMPLIFIER_GAIN_Q)
+#define AMPLIFIER_CHUNK               240   /* samples processed with a line of gains (multiple of nchan) */
+
+typedef struct          /* 40 Bytes  */
 {
+    int32_t gain [AMPLIFIER_MAX_NCHAN]; /* Q16 */
+    uint16_t ramp_frames;       /* duration of the linear ramps, 0 = immediate changes */
+    uint8_t ramp_type;          /* AMPLIFIER_RAMP_LINEAR, AMPLIFIER_RAMP_EXP */
+    uint8_t exp_shift;          /* time-constant of the exponential ramps = 2^exp_shift frames */
+    uint8_t mute;               /* 1 = muted */
+    uint8_t pad___[3];
+} amplifier_parameters;
 
-        /* word 0 : one word of 16bits + 2 bytes */
-#define         MUTED_MSB 24  
-#define         MUTED_LSB 24  /* 1 muted */   
-
-#define         SLOPE_MSB 19  
-#define         SLOPE_LSB 16  /* 4  slope of gain ramp-down */
-
-#define  DESIRED_GAIN_MSB 11 
-#define GAIN_EXPONENT_MSB 11  
-#define GAIN_EXPONENT_LSB  8  /* 4   */  
-#define GAIN_MANTISSA_MSB  7  
-#define GAIN_MANTISSA_LSB  0  /* 8 FP_8m4em : 8b mantissa, e=4b exponent, gain=(m)>>(e+2) */  
-#define  DESIRED_GAIN_LSB  0
-
-        /* word 1 : two words of 16bits */
-#define      DELAY_UP_MSB 31  
-#define      DELAY_UP_LSB 16 /* 16 delay before applying unmute state */   
-#define    DELAY_DOWN_MSB 15  
-#define    DELAY_DOWN_LSB 0  /* 16 delay before applying mute state */   
 
-    uint32_t parameters[2];
-
-        /* word 1 format */
-    uint32_t current_delay;
-
-        /* state of the IIR filter used for the slope computation */
-    uint32_t ampli_current_mantissa;
-
-    /*
-        multi-channel format 
-    */
-#define    AMPLICHAN___FMT_MSB 31  
-#define    AMPLICHAN___FMT_LSB 30  
-#define FRAMESIZE_FMT0_FMT_MSB 29   
-#define FRAMESIZE_FMT0_FMT_LSB  6  /* 24 copy of arc's format FRAMESIZE_FMT0 */
-#define   INTERLEAVING_FMT_MSB  5  
-#define   INTERLEAVING_FMT_LSB  5  /* 1 interleaving "frame_format_type"  */  
-#define NBCHANM1_AMPLI_FMT_MSB  4  
-#define NBCHANM1_AMPLI_FMT_LSB  0  /* 5 up to 32 channels */  
-    uint32_t channel_fmt;
-
-    /* CMSIS-STREAM "services" : debug traces, compute library, .. */
-    //stream_services *services;
-
-} arm_amplitude_instance;
+typedef struct
+{
+    int32_t line [AMPLIFIER_CHUNK];     /* gains of the samples of a chunk */
+#if STREAM_FLOAT_ALLOWED==1
+    float line_f32 [AMPLIFIER_CHUNK];
+#endif
+} arm_amplifier_memory;
 
 
-extern void arm_stream_amplitude_process (arm_amplitude_instance *instance, void *input, void *output /*, intptr_t *nsamp*/);
+typedef struct
+{
+    amplifier_parameters config;        /* 40 bytes */
+    int32_t current [AMPLIFIER_MAX_NCHAN];  /* gains applied to the last frame, Q16 */
+    int32_t increment [AMPLIFIER_MAX_NCHAN];/* linear ramp */
+    uint16_t remaining;         /* frames of the linear ramp */
+    uint8_t raw;                /* STREAM_S16, STREAM_S32, STREAM_FP32 */
+    uint8_t nchan;              /* interleaved channels */
+    uint8_t ramping;            /* 1 = gains updated on each frame */
+    uint8_t line_valid;         /* 1 = the line of gains has the constant gains */
+    uint8_t disabled;           /* format not supported : no processing */
+    uint16_t chunk;             /* samples per chunk, multiple of nchan */
+    arm_amplifier_memory *TCM;
+} arm_amplifier_instance;
+
+
+extern void arm_stream_amplifier_init (arm_amplifier_instance *instance);
+extern void arm_stream_amplifier_target (arm_amplifier_instance *instance);
+
+extern int32_t arm_stream_amplifier_process (arm_amplifier_instance *instance,
+                     uint8_t *in, uint8_t *out, int32_t nbSamples);
 
 #endif
 
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
@@ -1,13 +1,7 @@
 /* ----------------------------------------------------------------------
-
-
-        WORK ON GOING
-
-
-
  * Project:      CMSIS Stream
- * Title:        arm_amplifier_process.c
- * Description:  filters
+ * Title:        arm_stream_amplifier_process.c
+ * Description:  per-channel gain, mute and smoothed gain changes
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -28,17 +22,15 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 #include "presets.h"
 #ifdef CODE_ARM_STREAM_AMPLIFIER
 
-
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
 
 #include <stdint.h>
 #include "stream_common_const.h"
@@ -46,120 +38,250 @@
 #include "arm_stream_amplifier.h"
 
 
-  inline int32_t __SSAT(int32_t val, uint32_t sat)
-  {
-    if ((sat >= 1U) && (sat <= 32U))
-    {
-      const int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
-      const int32_t min = -1 - max ;
-      if (val > max)
-      {
-        val = max;
-      }
-      else if (val < min)
-      {
-        val = min;
-      }
+/*
+    The samples are processed in chunks with a "line" of gains : the gain of each sample of the
+    chunk, channels interleaved like the samples. With constant gains the line is computed once
+    and reused, during a ramp it is recomputed frame by frame for each chunk. The multiplication
+    loops have no test on the channel or on the ramp and are vectorized by the compiler.
+    Constant gains of 0dB (copy) and of 0 (mute) have their own loops.
+*/
+
+#define AMPLIFIER_MAX_GAIN     ((1L << 30) - 1) /* +84dB, the differences of gains stay in 32bits */
+
+
+/*
+    target gains, from the parameters and the mute state
+*/
+static void amplifier_targets (arm_amplifier_instance *pinstance, int32_t *target)
+{
+    uint32_t c;
+
+    for (c = 0; c < pinstance->nchan; c++)
+    {   target[c] = (pinstance->config.mute) ? 0 : pinstance->config.gain[c];
     }
+}
 
-    return val;
-  }
 
-/**
-  @brief         
-  @param[in]     pinst      instance of the component
-  @param[in/out] pdata      address and size of buffers
-  @param[out]    pstatus    execution state (0=processing not finished)
-  @return        status     finalized processing
- */
-void arm_stream_amplitude_process (arm_amplitude_instance *instance, void *input, void *output /*, intptr_t *nsamp */)
+/*
+    line of gains of "frames" frames, the gains are updated on each frame during a ramp
+*/
+static void amplifier_line (arm_amplifier_instance *pinstance, uint32_t frames)
 {
-    uint8_t slope, ichan;
-    int16_t *psrc, *pdst, exp, delayup, delaydown;
-    uint32_t format, incsrc, incdst, isamp, W0, W1;
-    int32_t current_mantissa, target_mantissa;
-
-    delayup = (int16_t)RD(instance->current_delay, DELAY_UP);
-    delaydown = (int16_t)RD(instance->current_delay, DELAY_DOWN);
-    format = (instance->channel_fmt);
-    W0 = instance->parameters[0];
-    W1 = instance->parameters[1];
-
-    /* input */
-    psrc = (int16_t *)(input);
-    //if (RD(format, INTERLEAVING_FMT) == FMT_INTERLEAVED)
-    //{   psrc = psrc + RD(W0, SUBCHANID_W0_IN);
-    //    incsrc = 1+ RD(format, NBCHANM1_AMPLI_FMT);
-    //}
-    //else
-    //{   psrc = psrc + RD(format, FRAMESIZE_FMT0_FMT);
-    //    incsrc = 1;
-    //}
-    incsrc = 1;
-    /*
-        decrease delay until 0 then mute or unmute
-    */
-
-    /* output = last arc */
-    pdst = (int16_t *)(output);
-    //if (RD(format, INTERLEAVING_FMT) == FMT_INTERLEAVED)
-    //{   pdst = pdst + RD(param, SUBCHANID_IN);
-    //    incdst = 1+ RD(format, NBCHANM1_AMPLI_FMT);
-    //}
-    //else
-    //{   pdst = pdst + RD(format, FRAMESIZE_FMT0_FMT);
-    //    incdst = 1;
-    //}
-    incdst = 1;
-
-    /* prepare the update of the gain */
-    slope = (uint8_t)(16 - RD(W0, SLOPE));
-
-    /* example with 0dB = 0x805
-       target_mantissa = 0x40000000 
-    *  current_mantissa after shift = 0x4000
-    *  post-multiplication shift = 14 (9 + target exponent)
-    */
-    exp = 9 + RD(W0, GAIN_EXPONENT);
-
-    for (isamp = 0; isamp < RD(format, FRAMESIZE_FMT0_FMT); isamp++)
-    {   *pdst = 0;
-        pdst += incdst;
+    amplifier_parameters *config = &(pinstance->config);
+    int32_t *line = pinstance->TCM->line;
+    int32_t target [AMPLIFIER_MAX_NCHAN], cur [AMPLIFIER_MAX_NCHAN], inc [AMPLIFIER_MAX_NCHAN], d, s;
+    uint32_t f, k, c, i, C = pinstance->nchan;
+    uint8_t constant = (uint8_t)(0 == pinstance->ramping);
+
+    if (constant)
+    {   if (pinstance->line_valid)
+        {   return;
+        }
+        frames = pinstance->chunk / C;      /* the whole line, used until the next change */
+    }
+
+    amplifier_targets (pinstance, target);
+    for (c = 0; c < C; c++)         /* local copies, not aliased with the line */
+    {   cur[c] = pinstance->current[c];
+        inc[c] = pinstance->increment[c];
     }
-    
+    f = 0; i = 0;
 
-    if (RD(W0, MUTED))
-    {   target_mantissa = (RD(W0, GAIN_MANTISSA)) << 23;
+    /* linear ramp : increments up to the last frame of the ramp, which is set to the target */
+    if (pinstance->ramping && config->ramp_type == AMPLIFIER_RAMP_LINEAR)
+    {   k = MIN(frames, (uint32_t)pinstance->remaining - 1u);
+        for (f = 0; f < k; f++)
+        {   for (c = 0; c < C; c++)
+            {   cur[c] += inc[c];
+                line[i++] = cur[c];
+            }
+        }
+        pinstance->remaining = (uint16_t)(pinstance->remaining - k);
+        if (f < frames)
+        {   for (c = 0; c < C; c++)
+            {   cur[c] = target[c];
+            }
+            pinstance->remaining = 0;
+            pinstance->ramping = 0;
+        }
     }
-    else /* muting is going through ramp-down filter with a faster slope */
-    {   target_mantissa = 0;
-        slope = (uint8_t)(16 - (RD(W0, SLOPE) >> 1));
+
+    for (; f < frames; f++)
+    {   if (pinstance->ramping)     /* exponential ramp */
+        {   for (c = 0, pinstance->ramping = 0; c < C; c++)
+            {   d = target[c] - cur[c];
+                s = d >> config->exp_shift;
+                if (s == 0 && d != 0)
+                {   s = (d > 0) ? 1 : -1;
+                }
+                cur[c] += s;
+                pinstance->ramping |= (uint8_t)(cur[c] != target[c]);
+            }
+        }
+        for (c = 0; c < C; c++)
+        {   line[i++] = cur[c];
+        }
+    }
+    for (c = 0; c < C; c++)
+    {   pinstance->current[c] = cur[c];
     }
 
-    current_mantissa = instance->ampli_current_mantissa;
-
-    for (isamp = 0; isamp < RD(format, FRAMESIZE_FMT0_FMT); isamp++)
-    {
-        for (ichan = 0; ichan < RD(format, NBCHANM1_AMPLI_FMT); ichan++)
-        {   int32_t acc, tmp;
-            acc = (*pdst);
-            tmp = ((int32_t)(*psrc) * (current_mantissa >> 16)) >> exp;
-            acc = acc + tmp;
-            *pdst = (int16_t)(__SSAT (acc, 16));
-            psrc += incsrc;
-            pdst += incdst;
-
-            /* gain slope created with a first order IIR filter */
-            current_mantissa += (target_mantissa - current_mantissa) >> slope;
+#if STREAM_FLOAT_ALLOWED==1
+    if (pinstance->raw == STREAM_FP32)
+    {   for (c = 0; c < i; c++)
+        {   pinstance->TCM->line_f32[c] = (float)line[c] * (1.0f / (float)AMPLIFIER_UNITY);
         }
     }
+#endif
 
-    /* update the filter */
-    instance->ampli_current_mantissa = current_mantissa;
+    /* at the end of a ramp the line of the constant gains is computed on the next chunk */
+    pinstance->line_valid = constant;
+}
+
+
+static void amplifier_q15 (const int16_t *x, int16_t *y, const int32_t *g, uint32_t n)
+{
+    uint32_t i;
+    int64_t v;
+
+    for (i = 0; i < n; i++)
+    {   v = ((int64_t)x[i] * g[i] + (1 << (AMPLIFIER_GAIN_Q - 1))) >> AMPLIFIER_GAIN_Q;
+        y[i] = (int16_t)MIN(32767, MAX(-32768, v));
+    }
+}
+
+
+static void amplifier_q31 (const int32_t *x, int32_t *y, const int32_t *g, uint32_t n)
+{
+    uint32_t i;
+    int64_t v;
+
+    for (i = 0; i < n; i++)
+    {   v = ((int64_t)x[i] * g[i] + (1 << (AMPLIFIER_GAIN_Q - 1))) >> AMPLIFIER_GAIN_Q;
+        y[i] = (int32_t)MIN(0x7FFFFFFFL, MAX(-0x7FFFFFFFL - 1, v));
+    }
+}
+
+
+#if STREAM_FLOAT_ALLOWED==1
+static void amplifier_f32 (const float *x, float *y, const float *g, uint32_t n)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {   y[i] = x[i] * g[i];
+    }
+}
+#endif
+
+
+/*
+    initialization of the gains, without ramp, after a reset
+*/
+void arm_stream_amplifier_init (arm_amplifier_instance *pinstance)
+{
+    pinstance->nchan = (uint8_t)MAX(1, MIN(AMPLIFIER_MAX_NCHAN, pinstance->nchan));
+    pinstance->chunk = (uint16_t)((AMPLIFIER_CHUNK / pinstance->nchan) * pinstance->nchan);
+    arm_stream_amplifier_target (pinstance);
+
+    amplifier_targets (pinstance, pinstance->current);
+    pinstance->remaining = 0;
+    pinstance->ramping = 0;
+}
+
+
+/*
+    new parameters : ramp from the current gains to the new targets
+*/
+void arm_stream_amplifier_target (arm_amplifier_instance *pinstance)
+{
+    amplifier_parameters *config = &(pinstance->config);
+    int32_t target [AMPLIFIER_MAX_NCHAN];
+    uint32_t c;
+
+    for (c = 0; c < AMPLIFIER_MAX_NCHAN; c++)
+    {   config->gain[c] = MAX(-AMPLIFIER_MAX_GAIN, MIN(AMPLIFIER_MAX_GAIN, config->gain[c]));
+    }
+    config->exp_shift = (uint8_t)MIN(15, config->exp_shift);
+    amplifier_targets (pinstance, target);
+
+    pinstance->ramping = 0;
+    for (c = 0; c < pinstance->nchan; c++)
+    {   pinstance->ramping |= (uint8_t)(target[c] != pinstance->current[c]);
+    }
+    pinstance->remaining = 0;
+    if (pinstance->ramping && config->ramp_type == AMPLIFIER_RAMP_LINEAR)
+    {   if (config->ramp_frames > 1)
+        {   for (c = 0; c < pinstance->nchan; c++)
+            {   pinstance->increment[c] = (target[c] - pinstance->current[c]) / (int32_t)(config->ramp_frames);
+            }
+            pinstance->remaining = config->ramp_frames;
+        }
+        else
+        {   pinstance->remaining = 1;   /* immediate change on the next frame */
+        }
+    }
+    pinstance->line_valid = 0;
+}
+
+
+/**
+  @brief         Processing function
+  @param[in]     instance     points to an instance of the amplifier
+  @param[in]     in           interleaved samples
+  @param[out]    out          interleaved samples, can be "in"
+  @param[in]     nbSamples    samples (all channels) to process
+  @return        number of samples processed (complete frames)
+ */
+int32_t arm_stream_amplifier_process (arm_amplifier_instance *pinstance,
+                     uint8_t *in, uint8_t *out, int32_t nbSamples)
+{
+    uint32_t n, i0, m, i, c, C = pinstance->nchan, unity = 1, zero = 1;
+    uint32_t bytes = (pinstance->raw == STREAM_S16) ? 2 : 4;
+
+    n = (uint32_t)nbSamples - ((uint32_t)nbSamples % C);
+
+    /* constant gains : copy or mute */
+    if (0 == pinstance->ramping)
+    {   for (c = 0; c < C; c++)
+        {   unity &= (uint32_t)(pinstance->current[c] == AMPLIFIER_UNITY);
+            zero &= (uint32_t)(pinstance->current[c] == 0);
+        }
+        if (unity || zero)
+        {   if (zero || in != out)
+            {   for (i = 0; i < n * bytes; i++)
+                {   out[i] = (zero) ? 0 : in[i];
+                }
+            }
+            return (int32_t)n;
+        }
+    }
+
+    for (i0 = 0; i0 < n; i0 += m)
+    {   m = MIN(n - i0, pinstance->chunk);
+        amplifier_line (pinstance, m / C);
+
+        switch (pinstance->raw)
+        {
+        case STREAM_S32:
+            amplifier_q31 ((int32_t *)&(in[i0 * 4]), (int32_t *)&(out[i0 * 4]), pinstance->TCM->line, m);
+            break;
+#if STREAM_FLOAT_ALLOWED==1
+        case STREAM_FP32:
+            amplifier_f32 ((float *)&(in[i0 * 4]), (float *)&(out[i0 * 4]), pinstance->TCM->line_f32, m);
+            break;
+#endif
+        default:
+        case STREAM_S16:
+            amplifier_q15 ((int16_t *)&(in[i0 * 2]), (int16_t *)&(out[i0 * 2]), pinstance->TCM->line, m);
+            break;
+        }
+    }
+    return (int32_t)n;
 }
 
 #ifdef __cplusplus
 }
 #endif
- 
-#endif  // #ifndef CODE_ARM_STREAM_AMPLIFIER
\ No newline at end of file
+
+#endif  // CODE_ARM_STREAM_AMPLIFIER
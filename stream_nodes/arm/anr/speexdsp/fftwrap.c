@@ -55,8 +55,6 @@ struct cmsis_fft_config {
     arm_rfft_fast_instance_f32 inst;
     /* need copy as CMSIS DSP rFFT corrupts input */
     float* scratchIn;
-    /* need another copy as CMSIS DSP rFFT issue unwanted symmetric part */
-    float* scratchOut;
 #endif
     int  N;
 };
@@ -67,10 +65,8 @@ void* spx_fft_init(uint8_t *spxGlobalHeapPtr, int size)
     struct cmsis_fft_config* table;
     table = (struct cmsis_fft_config*)speex_alloc(spxGlobalHeapPtr, sizeof(struct cmsis_fft_config));
 
-    table->scratchIn = (float*)speex_alloc(spxGlobalHeapPtr, size * 2 * sizeof(float));
-    table->scratchOut = (float*)speex_alloc(spxGlobalHeapPtr, size * 2 * sizeof(float));
+    table->scratchIn = (float*)speex_alloc(spxGlobalHeapPtr, size * sizeof(float));
     //speex_assert(table->scratchIn != NULL);
-    //speex_assert(table->scratchOut != NULL);
 
     arm_rfft_fast_init_f32(&table->inst, (uint16_t)size);
 
@@ -95,34 +91,45 @@ void spx_fft(void* table, float* in, float* out)
 
     int N = t->N;
     float* scratchIn = t->scratchIn;
-    float* scratchOut = t->scratchOut;
-
+    float nyquist;
 
     /* copy to avoid RFFT input corruption */
     memcopy_32(in, scratchIn, N);
-    arm_rfft_fast_f32(&t->inst, scratchIn, scratchOut, 0);
+    arm_rfft_fast_f32(&t->inst, scratchIn, out, 0);
 
-    /* CMSIS DSP to libspeex float RFFT reshufling and rescaling */
-    out[0] = scratchOut[0] / (float)N;
-    out[N - 1] = scratchOut[1] / (float)N;
-    memcopy_scale_32(scratchOut + 2, 1.0f / (float)N, out + 1, N - 2);
+    /* CMSIS DSP to libspeex float RFFT reshufling and rescaling, in place */
+    nyquist = out[1];
+    out[0] = out[0] / (float)N;
+    memcopy_scale_32(out + 2, 1.0f / (float)N, out + 1, N - 2);
+    out[N - 1] = nyquist / (float)N;
 }
 
 void spx_ifft(void* table, float* in, float* out)
 {
     struct cmsis_fft_config* t = (struct cmsis_fft_config*)table;
     float* scratchIn = t->scratchIn;
-    float* scratchOut = t->scratchOut;
     int N = t->N;
 
     /* CMSIS DSP RFFT float reshuffling */
-    memcopy_32(in + 1, scratchIn + 2, (N - 2) * sizeof(float));
+    memcopy_32(in + 1, scratchIn + 2, N - 2);
     scratchIn[0] = in[0];
     scratchIn[1] = in[N - 1];
 
-    arm_rfft_fast_f32(&t->inst, scratchIn, scratchOut, 1);
+    arm_rfft_fast_f32(&t->inst, scratchIn, out, 1);
     /* CMSIS RIFFT scale down, need to compensate */
-    memcopy_scale_32(scratchOut, (float)N, out, N);
+    memcopy_scale_32(out, (float)N, out, N);
+
+}
 
+/* the callers working in the CMSIS format save the copies and the scaling passes */
+void spx_fft_packed(void* table, float* in, float* out)
+{
+    struct cmsis_fft_config* t = (struct cmsis_fft_config*)table;
+    arm_rfft_fast_f32(&t->inst, in, out, 0);
 }
 
+void spx_ifft_packed(void* table, float* in, float* out)
+{
+    struct cmsis_fft_config* t = (struct cmsis_fft_config*)table;
+    arm_rfft_fast_f32(&t->inst, in, out, 1);
+}
@@ -46,6 +46,13 @@ void spx_fft(void *table, float *in, float *out);
 /** Backward (half-complex to real) transform */
 void spx_ifft(void *table, float *in, float *out);
 
+/** Forward transform in the packed format {DC, Nyquist, re1, im1, re2, im2 ..}, without
+    scaling, the input is used as scratch */
+void spx_fft_packed(void *table, float *in, float *out);
+
+/** Backward transform of the packed format, scaled by 1/N, the input is used as scratch */
+void spx_ifft_packed(void *table, float *in, float *out);
+
 /** Forward (real to half-complex) transform of float data */
 void spx_fft_float(void *table, float *in, float *out);
 
@@ -52,9 +52,8 @@ FilterBank *filterbank_new(uint8_t *spxGlobalHeapPtr, int banks, float sampling,
    FilterBank *bank;
    float df;
    float max_mel, mel_interval;
-   int i;
+   int i, b;
    int id1;
-   int id2;
    df = DIV32(SHL32(sampling,15),MULT16_16(2,len));
    max_mel = toBARK(EXTRACT16(sampling/2));
    mel_interval = PDIV32(max_mel,banks-1);
@@ -62,13 +61,13 @@ FilterBank *filterbank_new(uint8_t *spxGlobalHeapPtr, int banks, float sampling,
    bank = (FilterBank*)speex_alloc(spxGlobalHeapPtr, sizeof(FilterBank));
    bank->nb_banks = banks;
    bank->len = len;
-   bank->bank_left = (int*)speex_alloc(spxGlobalHeapPtr, len*sizeof(int));
-   bank->bank_right = (int*)speex_alloc(spxGlobalHeapPtr, len*sizeof(int));
+   bank->bank_start = (int*)speex_alloc(spxGlobalHeapPtr, banks*sizeof(int));
    bank->filter_left = (float*)speex_alloc(spxGlobalHeapPtr, len*sizeof(float));
-   bank->filter_right = (float*)speex_alloc(spxGlobalHeapPtr, len*sizeof(float));
    /* Think I can safely disable normalisation that for fixed-point (and probably float as well) */
    bank->scaling = (float*)speex_alloc(spxGlobalHeapPtr, banks*sizeof(float));
 
+   /* the left band of the bins is increasing with the frequency */
+   b = 0;
    for (i=0;i<len;i++)
    {
       float curr_freq;
@@ -88,99 +87,103 @@ FilterBank *filterbank_new(uint8_t *spxGlobalHeapPtr, int banks, float sampling,
       } else {
          val = DIV32_16(mel - id1*mel_interval,EXTRACT16(PSHR32(mel_interval,15)));
       }
-      id2 = id1+1;
-      bank->bank_left[i] = id1;
+      while (b <= id1)
+         bank->bank_start[b++] = i;
       bank->filter_left[i] = SUB16(Q15_ONE,val);
-      bank->bank_right[i] = id2;
-      bank->filter_right[i] = val;
    }
+   while (b < banks)
+      bank->bank_start[b++] = i;
 
    /* Think I can safely disable normalisation for fixed-point (and probably float as well) */
-   for (i=0;i<bank->nb_banks;i++)
-      bank->scaling[i] = 0;
-   for (i=0;i<bank->len;i++)
+   for (b=0;b<banks;b++)
+      bank->scaling[b] = 0;
+   for (b=0;b<banks-1;b++)
    {
-      int id = bank->bank_left[i];
-      bank->scaling[id] += bank->filter_left[i];
-      id = bank->bank_right[i];
-      bank->scaling[id] += bank->filter_right[i];
+      for (i=bank->bank_start[b];i<bank->bank_start[b+1];i++)
+      {
+         bank->scaling[b] += bank->filter_left[i];
+         bank->scaling[b+1] += SUB16(Q15_ONE,bank->filter_left[i]);
+      }
    }
-   for (i=0;i<bank->nb_banks;i++)
-      bank->scaling[i] = Q15_ONE/(bank->scaling[i]);
+   for (b=0;b<banks;b++)
+      bank->scaling[b] = Q15_ONE/(bank->scaling[b]);
 
    return bank;
 }
 //
 //void filterbank_destroy(FilterBank *bank)
 //{
-//   speex_free(bank->bank_left);
-//   speex_free(bank->bank_right);
+//   speex_free(bank->bank_start);
 //   speex_free(bank->filter_left);
-//   speex_free(bank->filter_right);
 //   speex_free(bank->scaling);
 //   speex_free(bank);
 //}
 
-void filterbank_compute_bank32(FilterBank *bank, float *ps, float *mel)
+/* sum of ps[] and sum of w[] x ps[] on a range of bins, four partial sums for the SIMD units */
+static void filterbank_sum_dot(const float *ps, const float *w, int n, float *sum, float *dot)
 {
    int i;
-   for (i=0;i<bank->nb_banks;i++)
-      mel[i] = 0;
+   float s0=0, s1=0, s2=0, s3=0;
+   float d0=0, d1=0, d2=0, d3=0;
 
-   for (i=0;i<bank->len;i++)
+   for (i=0;i+3<n;i+=4)
+   {
+      s0 += ps[i];    d0 += w[i]*ps[i];
+      s1 += ps[i+1];  d1 += w[i+1]*ps[i+1];
+      s2 += ps[i+2];  d2 += w[i+2]*ps[i+2];
+      s3 += ps[i+3];  d3 += w[i+3]*ps[i+3];
+   }
+   for (;i<n;i++)
    {
-      int id;
-      id = bank->bank_left[i];
-      mel[id] += MULT16_32_P15(bank->filter_left[i],ps[i]);
-      id = bank->bank_right[i];
-      mel[id] += MULT16_32_P15(bank->filter_right[i],ps[i]);
+      s0 += ps[i];    d0 += w[i]*ps[i];
    }
+   *sum = (s0+s1)+(s2+s3);
+   *dot = (d0+d1)+(d2+d3);
+}
 
+/* each range of bins gives sum(w x ps) to the band b and sum(ps) - sum(w x ps) to the band b+1 */
+void filterbank_compute_bank32(FilterBank *bank, float *ps, float *mel)
+{
+   int b, first;
+   float sum, dot;
+
+   mel[0] = 0;
+   for (b=0;b<bank->nb_banks-1;b++)
+   {
+      first = bank->bank_start[b];
+      filterbank_sum_dot(&ps[first], &bank->filter_left[first], bank->bank_start[b+1]-first, &sum, &dot);
+      mel[b] += dot;
+      mel[b+1] = sum - dot;
+   }
 }
 
+/* linear interpolation between the bands b+1 and b on the range of bins */
 void filterbank_compute_psd16(FilterBank *bank, float *mel, float *ps)
 {
-   int i;
-   for (i=0;i<bank->len;i++)
+   int i, b;
+   for (b=0;b<bank->nb_banks-1;b++)
    {
-      float tmp;
-      int id1, id2;
-      id1 = bank->bank_left[i];
-      id2 = bank->bank_right[i];
-      tmp = MULT16_16(mel[id1],bank->filter_left[i]);
-      tmp += MULT16_16(mel[id2],bank->filter_right[i]);
-      ps[i] = EXTRACT16(PSHR32(tmp,15));
+      float right = mel[b+1];
+      float diff = mel[b] - mel[b+1];
+      for (i=bank->bank_start[b];i<bank->bank_start[b+1];i++)
+         ps[i] = right + bank->filter_left[i]*diff;
    }
+   for (i=bank->bank_start[bank->nb_banks-1];i<bank->len;i++)
+      ps[i] = 0;
 }
 
 
 void filterbank_compute_bank(FilterBank *bank, float *ps, float *mel)
 {
    int i;
-   for (i=0;i<bank->nb_banks;i++)
-      mel[i] = 0;
-
-   for (i=0;i<bank->len;i++)
-   {
-      int id = bank->bank_left[i];
-      mel[id] += bank->filter_left[i]*ps[i];
-      id = bank->bank_right[i];
-      mel[id] += bank->filter_right[i]*ps[i];
-   }
+   filterbank_compute_bank32(bank, ps, mel);
    for (i=0;i<bank->nb_banks;i++)
       mel[i] *= bank->scaling[i];
 }
 
 void filterbank_compute_psd(FilterBank *bank, float *mel, float *ps)
 {
-   int i;
-   for (i=0;i<bank->len;i++)
-   {
-      int id = bank->bank_left[i];
-      ps[i] = mel[id]*bank->filter_left[i];
-      id = bank->bank_right[i];
-      ps[i] += mel[id]*bank->filter_right[i];
-   }
+   filterbank_compute_psd16(bank, mel, ps);
 }
 
 void filterbank_psy_smooth(FilterBank *bank, float *ps, float *mask)
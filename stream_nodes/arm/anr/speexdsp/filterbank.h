@@ -36,11 +36,12 @@
 
 #include "arch.h"
 
+/* The bins between the centers of the bands b and b+1 are the contiguous range
+   bank_start[b] .. bank_start[b+1]-1, with the weight filter_left[i] for the band b and
+   1-filter_left[i] for the band b+1. bank_start[nb_banks-1] is the end of the bins used. */
 typedef struct {
-   int *bank_left;
-   int *bank_right;
+   int *bank_start;
    float *filter_left;
-   float *filter_right;
    float *scaling;
    int nb_banks;
    int len;
@@ -67,6 +67,7 @@
 #include "fftwrap.h"
 #include "filterbank.h"
 #include "math_approx.h"
+#include "preprocess_window.h"
 
 #define LOUDNESS_EXP 5.f
 #define AMP_SCALE .001f
@@ -149,7 +150,7 @@ struct SpeexPreprocessState_ {
    float *ps;         /**< Current power spectrum */
    float *gain2;      /**< Adjusted gains */
    float *gain_floor; /**< Minimum gain allowed */
-   float *window;     /**< Analysis/Synthesis window */
+   const float *window; /**< Analysis/Synthesis window, shared table for the frames of 256 samples */
    float *noise;      /**< Noise estimate */
    //float *reverb_estimate; /**< Estimate of reverb energy */
    float *old_ps;     /**< Power spectrum for last frame */
@@ -295,7 +296,6 @@ SpeexPreprocessState *speex_preprocess_state_init(uint8_t *spxGlobalHeapPtr, int
    st->bank = filterbank_new(spxGlobalHeapPtr, M, (float)sampling_rate, N, 1);
 
    st->frame = (float*)speex_alloc(spxGlobalHeapPtr, 2*N*sizeof(float));
-   st->window = (float*)speex_alloc(spxGlobalHeapPtr, 2*N*sizeof(float));
    st->ft = (float*)speex_alloc(spxGlobalHeapPtr, 2*N*sizeof(float));
 
    st->ps = (float*)speex_alloc(spxGlobalHeapPtr, (N+M)*sizeof(float));
@@ -316,17 +316,25 @@ SpeexPreprocessState *speex_preprocess_state_init(uint8_t *spxGlobalHeapPtr, int
    st->inbuf = (float*)speex_alloc(spxGlobalHeapPtr, N3*sizeof(float));
    st->outbuf = (float*)speex_alloc(spxGlobalHeapPtr, N3*sizeof(float));
 
-   conj_window(st->window, 2*N3);
-   for (i=2*N3;i<2*st->ps_size;i++)
-      st->window[i]=Q15_ONE;
-
-   if (N4>0)
+   if (2*N3 == CONJ_WINDOW_TABLE_SIZE && N4 == 0)
+   {
+      st->window = conj_window_512;
+   } else
    {
-      for (i=N3-1;i>=0;i--)
+      float *window = (float*)speex_alloc(spxGlobalHeapPtr, 2*N*sizeof(float));
+      conj_window(window, 2*N3);
+      for (i=2*N3;i<2*st->ps_size;i++)
+         window[i]=Q15_ONE;
+
+      if (N4>0)
       {
-         st->window[i+N3+N4]=st->window[i+N3];
-         st->window[i+N3]=1;
+         for (i=N3-1;i>=0;i--)
+         {
+            window[i+N3+N4]=window[i+N3];
+            window[i+N3]=1;
+         }
       }
+      st->window = window;
    }
 
    for (i=0;i<N+M;i++)
@@ -465,30 +473,27 @@ static void preprocess_analysis(SpeexPreprocessState *st, int16_t *x)
    int N3 = 2*N - st->frame_size;
    int N4 = st->frame_size - N3;
    float *ps=st->ps;
+   float *ft=st->ft;
+   /* the FFT is not scaled : power spectrum scaled by 1/(2N)^2 */
+   float scale = 1.f/(4.f*N*N);
 
-   /* 'Build' input frame */
+   /* 'Build' input frame with the windowing */
    for (i=0;i<N3;i++)
-      st->frame[i]=st->inbuf[i];
+      st->frame[i] = MULT16_16_Q15(st->inbuf[i], st->window[i]);
    for (i=0;i<st->frame_size;i++)
-      st->frame[N3+i]=x[i];
+      st->frame[N3+i] = MULT16_16_Q15((float)x[i], st->window[N3+i]);
 
    /* Update inbuf */
    for (i=0;i<N3;i++)
       st->inbuf[i]=x[N4+i];
 
-   /* Windowing */
-   for (i=0;i<2*N;i++)
-      st->frame[i] = MULT16_16_Q15(st->frame[i], st->window[i]);
-
-   /* Perform FFT */
-   spx_fft(st->fft_lookup, st->frame, st->ft);
+   /* Perform FFT, the frame is scratch : ft = {DC, Nyquist, re1, im1, re2, im2 ..} */
+   spx_fft_packed(st->fft_lookup, st->frame, ft);
 
    /* Power spectrum */
-   ps[0]=MULT16_16(st->ft[0],st->ft[0]);
+   ps[0]=MULT16_16(ft[0],ft[0]) * scale;
    for (i=1;i<N;i++)
-      ps[i]=MULT16_16(st->ft[2*i-1],st->ft[2*i-1]) + MULT16_16(st->ft[2*i],st->ft[2*i]);
-   for (i=0;i<N;i++)
-      st->ps[i] = PSHR32(st->ps[i], 2*st->frame_shift);
+      ps[i]=(MULT16_16(ft[2*i],ft[2*i]) + MULT16_16(ft[2*i+1],ft[2*i+1])) * scale;
 
    filterbank_compute_bank32(st->bank, ps, ps+N);
 }
@@ -743,11 +748,11 @@ int speex_preprocess_run(SpeexPreprocessState *st, int16_t *x)
    /* Apply computed gain */
    for (i=1;i<N;i++)
    {
-      st->ft[2*i-1] = MULT16_16_P15(st->gain2[i],st->ft[2*i-1]);
       st->ft[2*i] = MULT16_16_P15(st->gain2[i],st->ft[2*i]);
+      st->ft[2*i+1] = MULT16_16_P15(st->gain2[i],st->ft[2*i+1]);
    }
    st->ft[0] = MULT16_16_P15(st->gain2[0],st->ft[0]);
-   st->ft[2*N-1] = MULT16_16_P15(st->gain2[N-1],st->ft[2*N-1]);
+   st->ft[1] = MULT16_16_P15(st->gain2[N-1],st->ft[1]);
 
    /*FIXME: This *will* not work for fixed-point */
 
@@ -755,11 +760,8 @@ int speex_preprocess_run(SpeexPreprocessState *st, int16_t *x)
       speex_compute_agc(st, Pframe, st->ft);
 
 
-   /* Inverse FFT with 1/N scaling */
-   spx_ifft(st->fft_lookup, st->ft, st->frame);
-   /* Scale back to original (lower) amplitude */
-   for (i=0;i<2*N;i++)
-      st->frame[i] = PSHR16(st->frame[i], st->frame_shift);
+   /* Inverse FFT with 1/N scaling, compensates the forward FFT without scaling */
+   spx_ifft_packed(st->fft_lookup, st->ft, st->frame);
 
    /*FIXME: This *will* not work for fixed-point */
 
@@ -778,19 +780,15 @@ int speex_preprocess_run(SpeexPreprocessState *st, int16_t *x)
    }
 
 
-   /* Synthesis window (for WOLA) */
-   for (i=0;i<2*N;i++)
-      st->frame[i] = MULT16_16_Q15(st->frame[i], st->window[i]);
-
-   /* Perform overlap and add */
+   /* Synthesis window (for WOLA) and overlap and add */
    for (i=0;i<N3;i++)
-      x[i] = WORD2INT(ADD32(EXTEND32(st->outbuf[i]), EXTEND32(st->frame[i])));
+      x[i] = WORD2INT(ADD32(EXTEND32(st->outbuf[i]), EXTEND32(MULT16_16_Q15(st->frame[i], st->window[i]))));
    for (i=0;i<N4;i++)
-      x[N3+i] = (int16_t)(st->frame[N3+i]);
+      x[N3+i] = (int16_t)(MULT16_16_Q15(st->frame[N3+i], st->window[N3+i]));
 
    /* Update outbuf */
    for (i=0;i<N3;i++)
-      st->outbuf[i] = st->frame[st->frame_size+i];
+      st->outbuf[i] = MULT16_16_Q15(st->frame[st->frame_size+i], st->window[st->frame_size+i]);
 
    /* FIXME: This VAD is a kludge */
    st->speech_prob = Pframe;
@@ -0,0 +1,128 @@
+/* Copyright (C) 2003 Epic Games (written by Jean-Marc Valin)
+   File: preprocess_window.h
+
+   Analysis/synthesis window of the preprocessor for the frames of 256 samples (FFT of 512
+   points), the values of conj_window (w, 512) shared by all the instances
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+   STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+   POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef PREPROCESS_WINDOW_H
+#define PREPROCESS_WINDOW_H
+
+#define CONJ_WINDOW_TABLE_SIZE 512
+
+static const float conj_window_512[CONJ_WINDOW_TABLE_SIZE] = {
+    0.000000000e+00f, 6.091594696e-05f, 2.436041832e-04f, 5.480647087e-04f, 9.742081165e-04f, 1.521915197e-03f,
+    2.191066742e-03f, 2.981483936e-03f, 3.892987967e-03f, 4.925370216e-03f, 6.078362465e-03f, 7.351666689e-03f,
+    8.745014668e-03f, 1.025801897e-02f, 1.189035177e-02f, 1.364159584e-02f, 1.551133394e-02f, 1.749911904e-02f,
+    1.960441470e-02f, 2.182677388e-02f, 2.416563034e-02f, 2.662038803e-02f, 2.919051051e-02f, 3.187528253e-02f,
+    3.467413783e-02f, 3.758636117e-02f, 4.061120749e-02f, 4.374799132e-02f, 4.699590802e-02f, 5.035421252e-02f,
+    5.382204056e-02f, 5.739858747e-02f, 6.108295918e-02f, 6.487426162e-02f, 6.877157092e-02f, 7.277393341e-02f,
+    7.688039541e-02f, 8.108991385e-02f, 8.540147543e-02f, 8.981406689e-02f, 9.432658553e-02f, 9.893795848e-02f,
+    1.036470234e-01f, 1.084526181e-01f, 1.133536398e-01f, 1.183488667e-01f, 1.234370172e-01f, 1.286169589e-01f,
+    1.338873804e-01f, 1.392469704e-01f, 1.446944475e-01f, 1.502285004e-01f, 1.558477581e-01f, 1.615508199e-01f,
+    1.673363745e-01f, 1.732029915e-01f, 1.791492105e-01f, 1.851736307e-01f, 1.912747025e-01f, 1.974509954e-01f,
+    2.037009597e-01f, 2.100231647e-01f, 2.164160013e-01f, 2.228779197e-01f, 2.294073403e-01f, 2.360027134e-01f,
+    2.426624298e-01f, 2.493847609e-01f, 2.561682165e-01f, 2.630109787e-01f, 2.699115574e-01f, 2.768681645e-01f,
+    2.838791609e-01f, 2.909427583e-01f, 2.980573475e-01f, 3.052210808e-01f, 3.124322891e-01f, 3.196892142e-01f,
+    3.269900084e-01f, 3.343330324e-01f, 3.417163491e-01f, 3.491382897e-01f, 3.565969467e-01f, 3.640905619e-01f,
+    3.716172576e-01f, 3.791751862e-01f, 3.867625892e-01f, 3.943776488e-01f, 4.020183980e-01f, 4.096829891e-01f,
+    4.173696339e-01f, 4.250763655e-01f, 4.328013062e-01f, 4.405426681e-01f, 4.482985437e-01f, 4.560669661e-01f,
+    4.638461471e-01f, 4.716340899e-01f, 4.794290066e-01f, 4.872288406e-01f, 4.950318635e-01f, 5.028360486e-01f,
+    5.106396079e-01f, 5.184404850e-01f, 5.262369514e-01f, 5.340269804e-01f, 5.418086052e-01f, 5.495802760e-01f,
+    5.573396683e-01f, 5.650852919e-01f, 5.728148818e-01f, 5.805268884e-01f, 5.882190466e-01f, 5.958898664e-01f,
+    6.035373807e-01f, 6.111595631e-01f, 6.187547445e-01f, 6.263208985e-01f, 6.338564157e-01f, 6.413591504e-01f,
+    6.488275528e-01f, 6.562596560e-01f, 6.636537313e-01f, 6.710079312e-01f, 6.783204079e-01f, 6.855895519e-01f,
+    6.928133965e-01f, 6.999903321e-01f, 7.070950866e-01f, 7.141523361e-01f, 7.211169600e-01f, 7.279883027e-01f,
+    7.347662449e-01f, 7.414501905e-01f, 7.480399609e-01f, 7.545351386e-01f, 7.609354258e-01f, 7.672408223e-01f,
+    7.734507322e-01f, 7.795653939e-01f, 7.855842113e-01f, 7.915074229e-01f, 7.973347306e-01f, 8.030661345e-01f,
+    8.087016344e-01f, 8.142411113e-01f, 8.196847439e-01f, 8.250324726e-01f, 8.302845955e-01f, 8.354409337e-01f,
+    8.405019045e-01f, 8.454673886e-01f, 8.503379822e-01f, 8.551137447e-01f, 8.597948551e-01f, 8.643817902e-01f,
+    8.688748479e-01f, 8.732743263e-01f, 8.775806427e-01f, 8.817943931e-01f, 8.859158158e-01f, 8.899454474e-01f,
+    8.938838840e-01f, 8.977316618e-01f, 9.014893770e-01f, 9.051575065e-01f, 9.087368250e-01f, 9.122279882e-01f,
+    9.156315923e-01f, 9.189484715e-01f, 9.221793413e-01f, 9.253249168e-01f, 9.283860326e-01f, 9.313635826e-01f,
+    9.342583418e-01f, 9.370712042e-01f, 9.398031235e-01f, 9.424549937e-01f, 9.450278282e-01f, 9.475224614e-01f,
+    9.499400258e-01f, 9.522815347e-01f, 9.545480013e-01f, 9.567404985e-01f, 9.588600397e-01f, 9.609079361e-01f,
+    9.628851414e-01f, 9.647928476e-01f, 9.666322470e-01f, 9.684044719e-01f, 9.701107740e-01f, 9.717524052e-01f,
+    9.733304977e-01f, 9.748463631e-01f, 9.763012528e-01f, 9.776964188e-01f, 9.790331721e-01f, 9.803127646e-01f,
+    9.815365672e-01f, 9.827058315e-01f, 9.838219285e-01f, 9.848861694e-01f, 9.858998656e-01f, 9.868643880e-01f,
+    9.877811074e-01f, 9.886513352e-01f, 9.894763827e-01f, 9.902576804e-01f, 9.909965396e-01f, 9.916943312e-01f,
+    9.923524261e-01f, 9.929720759e-01f, 9.935547113e-01f, 9.941016436e-01f, 9.946141243e-01f, 9.950936437e-01f,
+    9.955413342e-01f, 9.959585071e-01f, 9.963466525e-01f, 9.967067838e-01f, 9.970403314e-01f, 9.973484874e-01f,
+    9.976324439e-01f, 9.978934526e-01f, 9.981327057e-01f, 9.983513355e-01f, 9.985505342e-01f, 9.987314343e-01f,
+    9.988951087e-01f, 9.990425706e-01f, 9.991750121e-01f, 9.992933869e-01f, 9.993986487e-01f, 9.994918704e-01f,
+    9.995738268e-01f, 9.996455908e-01f, 9.997079372e-01f, 9.997617602e-01f, 9.998078346e-01f, 9.998468757e-01f,
+    9.998796582e-01f, 9.999069571e-01f, 9.999293089e-01f, 9.999473691e-01f, 9.999617338e-01f, 9.999729395e-01f,
+    9.999815226e-01f, 9.999878407e-01f, 9.999924302e-01f, 9.999955297e-01f, 9.999975562e-01f, 9.999988079e-01f,
+    9.999995232e-01f, 9.999998212e-01f, 9.999999404e-01f, 1.000000000e+00f, 1.000000000e+00f, 1.000000000e+00f,
+    9.999999404e-01f, 9.999998212e-01f, 9.999995232e-01f, 9.999988079e-01f, 9.999975562e-01f, 9.999955297e-01f,
+    9.999924302e-01f, 9.999878407e-01f, 9.999815226e-01f, 9.999729395e-01f, 9.999617338e-01f, 9.999473691e-01f,
+    9.999293089e-01f, 9.999069571e-01f, 9.998796582e-01f, 9.998468757e-01f, 9.998078346e-01f, 9.997617602e-01f,
+    9.997079372e-01f, 9.996455908e-01f, 9.995738268e-01f, 9.994918704e-01f, 9.993986487e-01f, 9.992933869e-01f,
+    9.991750121e-01f, 9.990425706e-01f, 9.988951087e-01f, 9.987314343e-01f, 9.985505342e-01f, 9.983513355e-01f,
+    9.981327057e-01f, 9.978934526e-01f, 9.976324439e-01f, 9.973484874e-01f, 9.970403314e-01f, 9.967067838e-01f,
+    9.963466525e-01f, 9.959585071e-01f, 9.955413342e-01f, 9.950936437e-01f, 9.946141243e-01f, 9.941016436e-01f,
+    9.935547113e-01f, 9.929720759e-01f, 9.923524261e-01f, 9.916943312e-01f, 9.909965396e-01f, 9.902576804e-01f,
+    9.894763827e-01f, 9.886513352e-01f, 9.877811074e-01f, 9.868643880e-01f, 9.858998656e-01f, 9.848861694e-01f,
+    9.838219285e-01f, 9.827058315e-01f, 9.815365672e-01f, 9.803127646e-01f, 9.790331721e-01f, 9.776964188e-01f,
+    9.763012528e-01f, 9.748463631e-01f, 9.733304977e-01f, 9.717524052e-01f, 9.701107740e-01f, 9.684044719e-01f,
+    9.666322470e-01f, 9.647928476e-01f, 9.628851414e-01f, 9.609079361e-01f, 9.588600397e-01f, 9.567404985e-01f,
+    9.545480013e-01f, 9.522815347e-01f, 9.499400258e-01f, 9.475224614e-01f, 9.450278282e-01f, 9.424549937e-01f,
+    9.398031235e-01f, 9.370712042e-01f, 9.342583418e-01f, 9.313635826e-01f, 9.283860326e-01f, 9.253249168e-01f,
+    9.221793413e-01f, 9.189484715e-01f, 9.156315923e-01f, 9.122279882e-01f, 9.087368250e-01f, 9.051575065e-01f,
+    9.014893770e-01f, 8.977316618e-01f, 8.938838840e-01f, 8.899454474e-01f, 8.859158158e-01f, 8.817943931e-01f,
+    8.775806427e-01f, 8.732743263e-01f, 8.688748479e-01f, 8.643817902e-01f, 8.597948551e-01f, 8.551137447e-01f,
+    8.503379822e-01f, 8.454673886e-01f, 8.405019045e-01f, 8.354409337e-01f, 8.302845955e-01f, 8.250324726e-01f,
+    8.196847439e-01f, 8.142411113e-01f, 8.087016344e-01f, 8.030661345e-01f, 7.973347306e-01f, 7.915074229e-01f,
+    7.855842113e-01f, 7.795653939e-01f, 7.734507322e-01f, 7.672408223e-01f, 7.609354258e-01f, 7.545351386e-01f,
+    7.480399609e-01f, 7.414501905e-01f, 7.347662449e-01f, 7.279883027e-01f, 7.211169600e-01f, 7.141523361e-01f,
+    7.071184516e-01f, 6.999903321e-01f, 6.928133965e-01f, 6.855895519e-01f, 6.783204079e-01f, 6.710079312e-01f,
+    6.636537313e-01f, 6.562596560e-01f, 6.488275528e-01f, 6.413591504e-01f, 6.338564157e-01f, 6.263208985e-01f,
+    6.187547445e-01f, 6.111595631e-01f, 6.035373807e-01f, 5.958898664e-01f, 5.882190466e-01f, 5.805268884e-01f,
+    5.728148818e-01f, 5.650852919e-01f, 5.573396683e-01f, 5.495802760e-01f, 5.418086052e-01f, 5.340269804e-01f,
+    5.262369514e-01f, 5.184404850e-01f, 5.106396079e-01f, 5.028360486e-01f, 4.950318635e-01f, 4.872288406e-01f,
+    4.794290066e-01f, 4.716340899e-01f, 4.638461471e-01f, 4.560669661e-01f, 4.482985437e-01f, 4.405426681e-01f,
+    4.328013062e-01f, 4.250763655e-01f, 4.173696339e-01f, 4.096829891e-01f, 4.020183980e-01f, 3.943776488e-01f,
+    3.867625892e-01f, 3.791751862e-01f, 3.716172576e-01f, 3.640905619e-01f, 3.565969467e-01f, 3.491382897e-01f,
+    3.417163491e-01f, 3.343330324e-01f, 3.269900084e-01f, 3.196892142e-01f, 3.124322891e-01f, 3.052210808e-01f,
+    2.980573475e-01f, 2.909427583e-01f, 2.838791609e-01f, 2.768681645e-01f, 2.699115574e-01f, 2.630109787e-01f,
+    2.561682165e-01f, 2.493847609e-01f, 2.426624298e-01f, 2.360027134e-01f, 2.294073403e-01f, 2.228779197e-01f,
+    2.164160013e-01f, 2.100231647e-01f, 2.037009597e-01f, 1.974509954e-01f, 1.912747025e-01f, 1.851736307e-01f,
+    1.791492105e-01f, 1.732029915e-01f, 1.673363745e-01f, 1.615508199e-01f, 1.558477581e-01f, 1.502285004e-01f,
+    1.446944475e-01f, 1.392469704e-01f, 1.338873804e-01f, 1.286169589e-01f, 1.234370172e-01f, 1.183488667e-01f,
+    1.133536398e-01f, 1.084526181e-01f, 1.036470234e-01f, 9.893795848e-02f, 9.432658553e-02f, 8.981406689e-02f,
+    8.540147543e-02f, 8.108991385e-02f, 7.688039541e-02f, 7.277393341e-02f, 6.877157092e-02f, 6.487426162e-02f,
+    6.108295918e-02f, 5.739858747e-02f, 5.382204056e-02f, 5.035421252e-02f, 4.699590802e-02f, 4.374799132e-02f,
+    4.061120749e-02f, 3.758636117e-02f, 3.467413783e-02f, 3.187528253e-02f, 2.919051051e-02f, 2.662038803e-02f,
+    2.416563034e-02f, 2.182677388e-02f, 1.960441470e-02f, 1.749911904e-02f, 1.551133394e-02f, 1.364159584e-02f,
+    1.189035177e-02f, 1.025801897e-02f, 8.745014668e-03f, 7.351666689e-03f, 6.078362465e-03f, 4.925370216e-03f,
+    3.892987967e-03f, 2.981483936e-03f, 2.191066742e-03f, 1.521915197e-03f, 9.742081165e-04f, 5.480647087e-04f,
+    2.436041832e-04f, 6.091594696e-05f
+};
+
+#endif
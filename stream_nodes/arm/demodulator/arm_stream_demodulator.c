@@ -1,13 +1,7 @@
 /* ----------------------------------------------------------------------
-
-
-        WORK ON GOING
-
-
-
  * Project:      CMSIS Stream
  * Title:        arm_stream_demodulator.c
- * Description:  filters
+ * Description:  AM envelope, FM discriminator, BPSK and QPSK Costas loop
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -28,154 +22,194 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
+
 #include "presets.h"
-#ifdef CODE_ARM_STREAM_DEMODULATOR
+
+extern void arm_stream_demodulator (unsigned int command, void *instance, void *data, unsigned int *status);
 
 
+#ifdef CODE_ARM_STREAM_DEMODULATOR
+
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
+
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
 #include "arm_stream_demodulator.h"
 
-//
+
 //;----------------------------------------------------------------------------------------
 //;12. arm_stream_demodulator
 //;----------------------------------------------------------------------------------------
-//;    Operation : decode a bit-stream from analog data. Use-case: IR decoder, UART on 
-//;       SPI/I2S audio, frequency detector.
-//;    Parameters : clock and parity setting or let the algorithm discover the frame setting after 
-//;        some time. https://en.wikipedia.org/wiki/Universal_asynchronous_receiver-transmitter
+//;    Operation : down-conversion of a STREAM_S16 signal with the NCO of the modulator,
+//;       decimation by integrate-and-dump (one output sample per symbol) and demodulation :
+//;       AM envelope, FM discriminator, BPSK and QPSK with a Costas loop (fixed-point
+//;       proportional-integral loop filter on the NCO, updated once per symbol).
+//;       The output is STREAM_S16, mono or I/Q interleaved (QPSK soft decisions).
+//;       The symbols are rectangular and aligned on the first input sample, the carrier
+//;       image is cancelled when 2 x carrier is a multiple of the output rate.
+//;    use-case : narrow-band sensor links, AM/FM audio on a low IF, tone detection
 //;
-//;   presets control :
-//;   #1 : frequency estimator
-//;    Operation : input signal frequency estimator. Best-effort accuracy on time-stamped streams. 
-//;    Use second-order autoregression
-//;    Use-case example: measure 50Hz from power lines on the three phases (a -1% deviation means "power-down").
-//;    Parameters : none. output data estimate sampling rate is provided at reset
-//;   #2 .. 10: provision for other demodulators
+//;   Parameters :
+//;u32    carrier phase increment f/FS x 2^32
+//;u16    decimation : input samples per output sample (symbol)
+//;u8     mode : 0 AM, 1 FM, 2 BPSK, 3 QPSK
+//;u8     proportional gain of the loop filter 2^-kp_shift
+//;u8     integral gain of the loop filter 2^-ki_shift (per symbol)
 //;
-//;   Metadata information can be extracted with the command "parameter-read":
-//;   TAG_CMD = 1 read the signal amplitude
-//;   TAG_CMD = 2 read the signal to noise ratio
+//;   Tags of the SET_PARAMETER command :
+//;   1 : carrier phase increment (u32), 2 : loop gains (2 x u8)
 //;
-//arm_stream_demodulator 
-//    3  i8; 0 1 0        instance, preset frequency estimator, tag
+//;   presets control
+//;   #0 : AM, carrier 12kHz at 48kHz, output 8kHz
+//;   #1 : FM, carrier 12kHz at 48kHz, output 8kHz (full-scale = 4kHz deviation)
+//;   #2 : BPSK, carrier 12kHz at 48kHz, 1200 symbols/s, loop gains 2^-5 2^-11 (pull-in +/-9Hz)
+//;   #3 : QPSK, carrier 12kHz at 48kHz, 1200 symbols/s (2400 bits/s), loop gains 2^-6 2^-13
+//;        (pull-in +/-2Hz)
+//
+//arm_stream_demodulator
+//    3  i8; 0 2 0        instance, preset BPSK, tag
+//    PARSTART
+//    1 u32; 1073741824               12kHz at 48kHz
+//    1 u16; 40                       1200 symbols/s
+//    3  u8; 2 5 11                   BPSK, kp = 2^-5, ki = 2^-11
+//    PARSTOP
 //;
 
+#define NB_PRESET 4
+const demodulator_parameters demodulator_preset [NB_PRESET] =
+{   /* increment, decimation, mode, kp_shift, ki_shift */
+    {1073741824,  6, DEMODULATOR_MODE_AM,   0, 0, {0,0,0}},  /* #0 */
+    {1073741824,  6, DEMODULATOR_MODE_FM,   0, 0, {0,0,0}},  /* #1 */
+    {1073741824, 40, DEMODULATOR_MODE_BPSK, 5, 11, {0,0,0}}, /* #2 */
+    {1073741824, 40, DEMODULATOR_MODE_QPSK, 6, 13, {0,0,0}}, /* #3 */
+};
+
 
 /**
-  @brief         
+  @brief
   @param[in]     command    bit-field
   @param[in]     pinst      instance of the component
   @param[in/out] pdata      address and size of buffers
   @param[out]    pstatus    execution state (0=processing not finished)
   @return        status     finalized processing
  */
-void arm_stream_demodulator (uint32_t command, void *instance, void *data, uint32_t *status)
+void arm_stream_demodulator (unsigned int command, void *instance, void *data, unsigned int *status)
 {
     *status = NODE_TASKS_COMPLETED;    /* default return status, unless processing is not finished */
 
     switch (RD(command,COMMAND_CMD))
-    { 
+    {
         /* func(command = (STREAM_RESET, COLD, PRESET, TRACEID tag, NB ARCS IN/OUT)
-                instance = *memory_results,  
+                instance = *memory_results,
                 data = address of Stream function
-                
-                memresults are followed by 2 words of STREAM_FORMAT_SIZE_W32 of all the arcs 
+
+                memresults are followed by 2 words of STREAM_FORMAT_SIZE_W32 of all the arcs
                 memory pointers are in the same order as described in the NODE manifest
+
+                memresult[0] : instance of the component
         */
-        case STREAM_RESET: 
-        {   stream_services *stream_entry = (stream_services *)data;
-            intptr_t *memresults = (intptr_t *)instance;
+        case STREAM_RESET:
+        {   intptr_t *memresult = (intptr_t *)instance;
             uint16_t preset = RD(command, PRESET_CMD);
-            uint16_t tag = RD(command, NODE_TAG_CMD);        /* extra parameters */
+            uint8_t *pt8bdst;
+            uint32_t i, n;
 
-            arm_stream_demodulator_instance *pinstance = (arm_stream_demodulator_instance *) *memresults;
-            memresults++;
-            /* here reset */
+            arm_stream_demodulator_instance *pinstance = (arm_stream_demodulator_instance *) memresult[0];
 
+            /* here reset */
+            pt8bdst = (uint8_t *) pinstance;
+            n = sizeof(arm_stream_demodulator_instance);
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = 0;
+            }
+
+            pinstance->config = demodulator_preset[MIN(preset, NB_PRESET-1)];    /* preset data move */
+            arm_stream_demodulator_init(pinstance);
             break;
-        }    
+        }
 
         /* func(command = bitfield (STREAM_SET_PARAMETER, PRESET, TAG, NB ARCS IN/OUT)
                     TAG of a parameter to set, NODE_ALL_PARAM means "set all the parameters" in a raw
-                *instance, 
+                *instance,
                 data = (one or all)
-        */ 
-        case STREAM_SET_PARAMETER:  
-        {   
-            uint8_t *new_parameters = (uint8_t *)data;
-            break;
-        }
-
-
-
-        /* func(command = STREAM_READ_PARAMETER, PRESET, TAG, NB ARCS IN/OUT)
-                    TAG/index of a parameter to read (Metadata, Needle), 0xFF means "read all the parameters"
-                *instance, 
-                data = *parameter(s) to read
-        */ 
-        case STREAM_READ_PARAMETER:  
-        {   
-            uint8_t *new_parameters = (uint8_t *)data;
-
+        */
+        case STREAM_SET_PARAMETER:
+        {   arm_stream_demodulator_instance *pinstance = (arm_stream_demodulator_instance *) instance;
+            uint8_t *pt8bsrc, *pt8bdst;
+            uint8_t i, n;
+
+            pt8bsrc = (uint8_t *) data;
+            pt8bdst = (uint8_t *) &(pinstance->config);
+
+            switch (RD(command,NODE_TAG_CMD))
+            {   default : n = 0; break;
+                case DEMODULATOR_TAG_INCREMENT: pt8bdst = (uint8_t *) &(pinstance->config.increment); n = 4; break;
+                case DEMODULATOR_TAG_LOOP:      pt8bdst = (uint8_t *) &(pinstance->config.kp_shift); n = 2; break;
+                case NODE_ALL_PARAM:            n = sizeof(demodulator_parameters); break;
+            }
+
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = pt8bsrc[i];
+            }
+
+            /* the symbol in progress and the frequency correction of the loop are cleared */
+            arm_stream_demodulator_init(pinstance);
             break;
         }
-        
 
 
         /* func(command = STREAM_RUN, PRESET, TAG, NB ARCS IN/OUT)
-               instance,  
+               instance,
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
-        */         
-        case STREAM_RUN:   
+               one output sample per "decimation" input samples (two in QPSK mode)
+        */
+        case STREAM_RUN:
         {
             arm_stream_demodulator_instance *pinstance = (arm_stream_demodulator_instance *) instance;
-            intptr_t nb_data, stream_xdmbuffer_size, bufferout_free;
+            intptr_t stream_xdmbuffer_size, bufferout_free;
+            int32_t nb_in, nb_out;
             stream_xdmbuffer_t *pt_pt;
-            #define SAMP_IN uint8_t 
-            #define SAMP_OUT int16_t
-            SAMP_IN *inBuf;
-            SAMP_OUT *outBuf;
+            int16_t *inBuf, *outBuf;
 
             pt_pt = data;
-            inBuf  = (SAMP_IN *)pt_pt->address;   
+            inBuf  = (int16_t *)pt_pt->address;
             stream_xdmbuffer_size    = pt_pt->size;
             pt_pt++;
-            outBuf = (SAMP_OUT *)(pt_pt->address); 
+            outBuf = (int16_t *)(pt_pt->address);
             bufferout_free        = pt_pt->size;
 
-            nb_data = stream_xdmbuffer_size / sizeof(SAMP_IN);
+            nb_out = (int32_t)(bufferout_free / sizeof(int16_t));
+            nb_in = arm_stream_demodulator_process(pinstance, inBuf, (int32_t)(stream_xdmbuffer_size / sizeof(int16_t)), outBuf, &nb_out);
 
-            // arm_stream_demodulator_process(pinstance, inBuf, outBuf, &nb_data);
+            pt_pt = data;   *(&(pt_pt->size)) = nb_in * sizeof(int16_t);    /* amount of data consumed */
+            pt_pt ++;       *(&(pt_pt->size)) = nb_out * sizeof(int16_t);   /* amount of data produced */
 
-            pt_pt = data;   *(&(pt_pt->size)) = nb_data * sizeof(SAMP_IN);     /* amount of data consumed */
-            pt_pt ++;       *(&(pt_pt->size)) = nb_data * sizeof(SAMP_OUT);    /* amount of data produced */
-            
             break;
         }
 
 
 
         /* func(command = STREAM_STOP, PRESET, TAG, NB ARCS IN/OUT)
-               instance,  
+               instance,
                data = unused
-           used to free memory allocated with the C standard library
-        */  
-        case STREAM_STOP:  break;    
+        */
+        case STREAM_STOP:  break;
+        default : break;
     }
 }
 
 #ifdef __cplusplus
 }
 #endif
- 
+
 #else
 void arm_stream_demodulator (unsigned int command, void *instance, void *data, unsigned int *status) { /* fake access */ if(command || instance || data || status) return;}
 #endif  // #ifndef CODE_ARM_STREAM_DEMODULATOR
@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
  * Title:        arm_stream_demodulator.h
- * Description:  filters
+ * Description:  AM envelope, FM discriminator, BPSK and QPSK Costas loop
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -22,37 +22,85 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 
 #ifndef cARM_STREAM_DEMODULATOR_H
 #define cARM_STREAM_DEMODULATOR_H
 
 
-#include "stream_common_const.h"      
-#include "stream_common_types.h"  
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
 
 
-typedef struct
+/*
+    The STREAM_S16 input is translated to base-band with the NCO of the modulator (I = x cos,
+    Q = -x sin) and decimated by an integrate-and-dump of "decimation" samples. The carrier
+    image at 2fc is cancelled when 2fc is a multiple of FS/decimation. The loop runs once per
+    output sample (one symbol) :
+        DEMODULATOR_MODE_AM   : envelope sqrt(I^2 + Q^2), non-coherent (no carrier tracking)
+        DEMODULATOR_MODE_FM   : phase difference of two successive I/Q, full-scale = FS_out/2
+        DEMODULATOR_MODE_BPSK : Costas loop, output I (soft decision)
+        DEMODULATOR_MODE_QPSK : Costas loop, output I and Q interleaved (soft decisions)
+    The phase error of the Costas loop is the angle of I/Q modulo pi (BPSK) or pi/2 (QPSK),
+    independent of the amplitude. The loop filter is proportional (2^-kp_shift) on the phase
+    and integral (2^-ki_shift per symbol) on the phase increment of the NCO, the pull-in range
+    is about 2^-kp_shift x symbol rate / 4 (BPSK) or / 8 (QPSK), lower gains give less cycle
+    slips at low SNR. The symbols are rectangular, of "decimation" samples, and
+    the first input sample is the start of a symbol (no symbol timing recovery). The
+    constellation has the phase ambiguity of the Costas loops (pi for BPSK, pi/2 for QPSK).
+*/
+
+#define DEMODULATOR_MODE_AM             0
+#define DEMODULATOR_MODE_FM             1
+#define DEMODULATOR_MODE_BPSK           2
+#define DEMODULATOR_MODE_QPSK           3
+
+#define DEMODULATOR_TAG_INCREMENT       1   /* SET_PARAMETER : uint32 increment, the loop is reset */
+#define DEMODULATOR_TAG_LOOP            2   /* SET_PARAMETER : uint8 kp_shift, uint8 ki_shift */
+
+#define DEMODULATOR_PRESET_AM           0   /* carrier 12kHz at 48kHz, output 8kHz */
+#define DEMODULATOR_PRESET_FM           1   /* carrier 12kHz at 48kHz, output 8kHz */
+#define DEMODULATOR_PRESET_BPSK         2   /* carrier 12kHz at 48kHz, 1200 symbols/s */
+#define DEMODULATOR_PRESET_QPSK         3   /* carrier 12kHz at 48kHz, 1200 symbols/s */
+
+#define DEMODULATOR_MAX_DECIMATION  32768   /* the sums of D samples Q15 stay in 32 bits */
+#define DEMODULATOR_MAX_PULL      (1L << 26)    /* frequency correction of the loop : FS/64 */
+
+typedef struct          /* 12 Bytes  */
 {
-    int *stream_entry;
+    uint32_t increment;         /* carrier phase increment f/FS x 2^32 */
+    uint16_t decimation;        /* input samples per output sample (symbol) */
+    uint8_t mode;               /* DEMODULATOR_MODE_ */
+    uint8_t kp_shift;           /* proportional gain of the loop filter 2^-kp_shift */
+    uint8_t ki_shift;           /* integral gain of the loop filter 2^-ki_shift */
+    uint8_t pad___[3];
+} demodulator_parameters;
 
-} arm_stream_demodulator_instance;
 
+typedef struct
+{
+    demodulator_parameters config;      /* 12 bytes */
+    uint32_t phase;             /* NCO */
+    int32_t correction;         /* integral of the loop filter, added to the phase increment */
+    int32_t acc_i, acc_q;       /* integrate and dump */
+    int32_t last_i, last_q;     /* previous I/Q of the FM discriminator */
+    int32_t gain;               /* 2 / decimation, Q16 */
+    uint16_t count;             /* input samples in the accumulators */
+    uint8_t pad___[2];
+} arm_stream_demodulator_instance;
 
 
-extern void arm_stream_demodulator_process1 (arm_stream_demodulator_instance *instance, 
-    void *input, void *output, intptr_t*nsamp);
-extern void arm_stream_demodulator_process2 (arm_stream_demodulator_instance *instance, 
-    void *input, void *output, intptr_t*nsamp);
-extern void arm_stream_demodulator_process3 (arm_stream_demodulator_instance *instance, 
-    void *input, void *output, intptr_t *nsamp);
+extern void arm_stream_demodulator_init (arm_stream_demodulator_instance *instance);
 
+extern int32_t arm_stream_demodulator_process (arm_stream_demodulator_instance *instance,
+                     int16_t *in, int32_t nbSamplesIn, int16_t *out, int32_t *nbSamplesOut);
 
 
 #endif  //cARM_STREAM_DEMODULATOR_H
@@ -60,4 +108,3 @@ extern void arm_stream_demodulator_process3 (arm_stream_demodulator_instance *in
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
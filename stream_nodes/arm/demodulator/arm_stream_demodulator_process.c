@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
  * Title:        arm_stream_demodulator_process.c
- * Description:  filters
+ * Description:  AM envelope, FM discriminator, BPSK and QPSK Costas loop
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -22,37 +22,224 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
+
+#include "presets.h"
 #ifdef CODE_ARM_STREAM_DEMODULATOR
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 #include <stdint.h>
 #include "stream_common_const.h"
 #include "stream_common_types.h"
 #include "arm_stream_demodulator.h"
+#include "../modulator/arm_stream_nco.h"
+
+
+/*
+    The NCO, the down-conversion and the accumulations are the only operations on the input
+    samples. The loop filter, the normalization, the angles and the output are computed once
+    per output sample (decimation folded in the loop) : the NCO increment is constant during
+    the integration of a symbol and the arithmetic of the inner loop is 32 bits.
+*/
+
+#define SAT16(v) ((int16_t)MIN(32767, MAX(-32767, (v))))
+
+#define DEMODULATOR_PI          0x80000000UL    /* angles : 2^32 per turn */
+#define DEMODULATOR_HALF_PI     0x40000000UL
+#define DEMODULATOR_QUARTER_PI  0x20000000UL
+
+
+/*
+    atan2(y, x) in 2^32 units per turn : octant reduction, z = min/max in Q15 and
+    atan(z) = pi/4 z + z (1 - z)(0.2447 + 0.0663 z), error below 0.0017 rad (0.1 degree)
+*/
+static int32_t demodulator_atan2 (int32_t y, int32_t x)
+{
+    uint32_t ax = (x < 0) ? 0u - (uint32_t)x : (uint32_t)x;
+    uint32_t ay = (y < 0) ? 0u - (uint32_t)y : (uint32_t)y;
+    uint32_t mx = MAX(ax, ay), mn = MIN(ax, ay), z, t, a;
+
+    if (mx == 0)
+    {   return 0;
+    }
+    if (mx >= (1uL << 31)) { mx >>= 16; mn >>= 16; }  /* 2^14 <= mx < 2^15 */
+    if (mx >= (1uL << 23)) { mx >>= 8;  mn >>= 8; }
+    if (mx >= (1uL << 19)) { mx >>= 4;  mn >>= 4; }
+    if (mx >= (1uL << 17)) { mx >>= 2;  mn >>= 2; }
+    if (mx >= (1uL << 16)) { mx >>= 1;  mn >>= 1; }
+    if (mx >= (1uL << 15)) { mx >>= 1;  mn >>= 1; }
+    z = (mn << 15) / mx;                                /* Q15, 0 .. 1 */
+    t = (z * (32768u - z)) >> 15;                       /* z (1 - z) */
+    t = (t * (8018u + ((2172u * z) >> 15))) >> 15;      /* 0.2447, 0.0663 */
+    a = (z << 14) + t * 20861u;                         /* 2^29 = pi/4, 20861 = 2^31/pi/2^15 */
+
+    if (ay > ax) a = DEMODULATOR_HALF_PI - a;
+    if (x < 0)   a = DEMODULATOR_PI - a;
+    if (y < 0)   a = 0u - a;
+    return (int32_t)a;
+}
+
+
+/*
+    integer square root of a positive 32-bit value
+*/
+static int32_t demodulator_sqrt (uint32_t v)
+{
+    uint32_t r = 0, b, t, mask;
+
+    for (b = 1uL << 30; b != 0; b >>= 2)     /* without branch, 16 iterations */
+    {   t = r + b;
+        mask = 0u - (uint32_t)(v >= t);
+        v -= t & mask;
+        r = (r >> 1) + (b & mask);
+    }
+    return (int32_t)r;
+}
+
+
+/*
+    down-conversion and accumulation of n samples, the NCO increment is constant
+*/
+static void demodulator_mix (arm_stream_demodulator_instance *pinstance, const int16_t *x, uint32_t n)
+{
+    uint32_t i, ph = pinstance->phase;
+    uint32_t inc = pinstance->config.increment + (uint32_t)(pinstance->correction);
+    int32_t ai = pinstance->acc_i, aq = pinstance->acc_q, c, s;
+
+    for (i = 0; i < n; i++)
+    {   c = arm_stream_nco_sine (ph + ARM_STREAM_NCO_QUARTER) >> 16;   /* Q15 */
+        s = arm_stream_nco_sine (ph) >> 16;
+        ai += (x[i] * c) >> 15;
+        aq -= (x[i] * s) >> 15;
+        ph += inc;
+    }
+    pinstance->phase = ph;
+    pinstance->acc_i = ai;
+    pinstance->acc_q = aq;
+}
+
+
+/*
+    end of a symbol : loop filter and output samples, returns the number of samples written
+*/
+static uint32_t demodulator_dump (arm_stream_demodulator_instance *pinstance, int16_t *y)
+{
+    demodulator_parameters *config = &(pinstance->config);
+    int32_t i, q, err, cross, dot;
+    uint32_t n = 1;
+
+    /* mean of the symbol x 2 (the mixer halves the amplitude), saturated */
+    i = (int32_t)(((int64_t)(pinstance->acc_i) * pinstance->gain) >> 16);
+    q = (int32_t)(((int64_t)(pinstance->acc_q) * pinstance->gain) >> 16);
+    i = SAT16(i);
+    q = SAT16(q);
+    pinstance->acc_i = 0;
+    pinstance->acc_q = 0;
+    pinstance->count = 0;
+
+    switch (config->mode)
+    {
+    default:
+    case DEMODULATOR_MODE_AM:
+        y[0] = SAT16(demodulator_sqrt ((uint32_t)(i * i + q * q)));
+        break;
+
+    case DEMODULATOR_MODE_FM:
+        /* angle of (i + jq) x conj(last), the products of 15 bits stay in 32 bits */
+        cross = q * pinstance->last_i - i * pinstance->last_q;
+        dot   = i * pinstance->last_i + q * pinstance->last_q;
+        y[0] = (int16_t)(demodulator_atan2 (cross, dot) >> 16);
+        pinstance->last_i = i;
+        pinstance->last_q = q;
+        break;
+
+    case DEMODULATOR_MODE_BPSK:
+    case DEMODULATOR_MODE_QPSK:
+        err = demodulator_atan2 (q, i);
+        if (config->mode == DEMODULATOR_MODE_BPSK)
+        {   /* distance to 0 or pi */
+            err = (int32_t)(((uint32_t)err + DEMODULATOR_HALF_PI) & (DEMODULATOR_PI - 1u)) - (int32_t)DEMODULATOR_HALF_PI;
+            y[0] = (int16_t)i;
+        }
+        else
+        {   /* distance to pi/4 + k pi/2 */
+            err = (int32_t)((uint32_t)err & (DEMODULATOR_HALF_PI - 1u)) - (int32_t)DEMODULATOR_QUARTER_PI;
+            y[0] = (int16_t)i;
+            y[1] = (int16_t)q;
+            n = 2;
+        }
+
+        /* loop filter : the NCO phase follows the carrier */
+        pinstance->phase += (uint32_t)(err >> config->kp_shift);
+        pinstance->correction += (err >> config->ki_shift) / (int32_t)(config->decimation);
+        pinstance->correction = MAX(-DEMODULATOR_MAX_PULL, MIN(DEMODULATOR_MAX_PULL, pinstance->correction));
+        break;
+    }
+    return n;
+}
+
+
+/*
+    initialization after a reset or new parameters
+*/
+void arm_stream_demodulator_init (arm_stream_demodulator_instance *pinstance)
+{
+    demodulator_parameters *config = &(pinstance->config);
+
+    config->decimation = (uint16_t)MAX(1, MIN(DEMODULATOR_MAX_DECIMATION, config->decimation));
+    config->mode = (uint8_t)MIN(DEMODULATOR_MODE_QPSK, config->mode);
+    config->kp_shift = (uint8_t)MIN(31, config->kp_shift);
+    config->ki_shift = (uint8_t)MIN(31, config->ki_shift);
+
+    pinstance->gain = (int32_t)(131072L / config->decimation);
+    pinstance->correction = 0;
+    pinstance->acc_i = 0;
+    pinstance->acc_q = 0;
+    pinstance->count = 0;
+}
 
 
 /**
-  @brief         
-  @param[in]     pinst      instance of the component
-  @param[in/out] pdata      address and size of buffers
-  @param[out]    pstatus    execution state (0=processing not finished)
-  @return        status     finalized processing
+  @brief         Processing function
+  @param[in]     instance       points to an instance of the demodulator
+  @param[in]     in             STREAM_S16 samples
+  @param[in]     nbSamplesIn    input samples
+  @param[out]    out            STREAM_S16 samples, I/Q interleaved in QPSK mode
+  @param[in/out] nbSamplesOut   free space / samples written
+  @return        number of input samples consumed
  */
-void arm_stream_demodulator_process (arm_stream_demodulator_instance *instance, void *input, void *output, intptr_t *nsamp)
+int32_t arm_stream_demodulator_process (arm_stream_demodulator_instance *pinstance,
+                     int16_t *in, int32_t nbSamplesIn, int16_t *out, int32_t *nbSamplesOut)
 {
+    uint32_t i, m, o, D = pinstance->config.decimation;
+    uint32_t N = (uint32_t)nbSamplesIn, O = (uint32_t)(*nbSamplesOut);
+    uint32_t width = (pinstance->config.mode == DEMODULATOR_MODE_QPSK) ? 2 : 1;
 
+    for (i = 0, o = 0; i < N; i += m)
+    {   m = MIN(N - i, D - pinstance->count);
 
+        /* the chunk ending a symbol needs free space for its output */
+        if (m == D - pinstance->count && o + width > O)
+        {   break;
+        }
+        demodulator_mix (pinstance, &(in[i]), m);
+        pinstance->count = (uint16_t)(pinstance->count + m);
+
+        if (pinstance->count == D)
+        {   o += demodulator_dump (pinstance, &(out[o]));
+        }
+    }
+
+    *nbSamplesOut = (int32_t)o;
+    return (int32_t)i;
 }
+
 #ifdef __cplusplus
 }
 #endif
-#else
-void arm_stream_demodulator_process (void)
-{
-}
-#endif
\ No newline at end of file
+
+#endif  // CODE_ARM_STREAM_DEMODULATOR
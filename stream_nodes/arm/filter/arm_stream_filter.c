@@ -36,19 +36,145 @@
 
 
 #include <stdint.h>
+#include <string.h> // memcpy
 #include "presets.h"
 #include "stream_common_const.h"
 #include "stream_common_types.h"
 #include "arm_stream_filter.h"
+#if STREAM_FLOAT_ALLOWED==1
+#include <math.h>
+#endif
 
 void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *status);
 
+/* multichannel service and sample size selected from the raw format of the arcs */
+#define FILTER_MC_FUNCTION(raw) ((raw) == STREAM_FP32 ? SERV_DSP_CASCADE_MC_F32 : \
+                                ((raw) == STREAM_S32 ? SERV_DSP_CASCADE_MC_Q31 : SERV_DSP_CASCADE_MC_Q15))
+#define FILTER_DF2T_FUNCTION(raw) ((raw) == STREAM_FP64 ? SERV_DSP_CASCADE_DF2T_F64 : SERV_DSP_CASCADE_DF2T_F32)
+#define FILTER_USE_MC(p) ((p)->nchan > 1 || (p)->raw == STREAM_S32)     /* q31 is only in the multichannel service */
+#define FILTER_SAMPLE_BYTES(raw) ((raw) == STREAM_S16 ? 2u : ((raw) == STREAM_FP64 ? 8u : 4u))
+
+#ifdef CODE_ARM_STREAM_FILTER
+/**
+  @brief         initialization of the kernels from the coefficients in TCM->coefs (q15), coefs32 (q31, f32) and coefs64 (f64)
+  @param[in]     pinstance  node instance
+  @param[in]     numStages  number of biquads
+  @param[in]     postShift  q15 and q31 accumulator shift
+ */
+static void filter_kernels_init (arm_filter_instance *pinstance, uint8_t numStages, uint8_t postShift)
+{
+    /* optimized kernels INIT */
+    pinstance->iir_service = PACK_SERVICE(SERV_DSP_INIT,NOOPTION_SSRV,NOTAG_SSRV, SERV_DSP_CASCADE_DF1_Q15,SERV_GROUP_DSP_ML);
+
+    pinstance->services(                                            // void arm_stream_services (      
+        pinstance->iir_service,                                     //      uint32_t command, 
+        (intptr_t)&(pinstance->TCM->biquad_cascade_df1_inst_q15),   //      intptr_t ptr1, 
+        (intptr_t)&(pinstance->TCM->coefs),                         //      intptr_t ptr2, 
+        (intptr_t)&(pinstance->TCM->state),                         //      intptr_t ptr3, 
+        (intptr_t)(numStages << 8u) | postShift                     //      intptr_t n)
+        );
+
+    /* interleaved multichannel and q31 : one state per channel */
+    if (FILTER_USE_MC(pinstance))
+    {   pinstance->iir_service = PACK_SERVICE(SERV_DSP_INIT,NOOPTION_SSRV,NOTAG_SSRV, FILTER_MC_FUNCTION(pinstance->raw),SERV_GROUP_DSP_ML);
+
+        pinstance->services(
+            pinstance->iir_service,
+            (intptr_t)&(pinstance->TCM->biquad_cascade_mc_inst),
+            (pinstance->raw == STREAM_S16) ? (intptr_t)(pinstance->TCM->coefs) : (intptr_t)(pinstance->TCM->coefs32),
+            (intptr_t)(pinstance->TCM + 1),                         /* states after the fixed memory */
+            (intptr_t)(pinstance->nchan << 16u) | (numStages << 8u) | postShift
+            );
+    }
+    /* mono floating-point : transposed DF2 with denormal flushing */
+    else if (pinstance->raw == STREAM_FP32 || pinstance->raw == STREAM_FP64)
+    {   pinstance->iir_service = PACK_SERVICE(SERV_DSP_INIT,NOOPTION_SSRV,NOTAG_SSRV, FILTER_DF2T_FUNCTION(pinstance->raw),SERV_GROUP_DSP_ML);
+
+        pinstance->services(
+            pinstance->iir_service,
+            (intptr_t)&(pinstance->TCM->biquad_cascade_df2T_inst),
+            (pinstance->raw == STREAM_FP32) ? (intptr_t)(pinstance->TCM->coefs32) : (intptr_t)(pinstance->TCM->coefs64),
+            (intptr_t)(pinstance->TCM->state64),
+            (intptr_t)(numStages << 8u)
+            );
+    }
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+/**
+  @brief         designed coefficients : search in the cache, compute when missing, load in the arc arithmetics
+  @param[in]     pinstance  node instance
+  @param[in]     type       FILTER_DESIGN_xx
+  @param[in]     numStages  number of biquads
+  @param[in]     fnorm      frequency / sampling rate
+  @param[in]     Q          quality factor
+  @param[in]     gain_dB    gain of shelf and peaking filters
+ */
+static void filter_design_load (arm_filter_instance *pinstance, uint8_t type, uint8_t numStages, float fnorm, float Q, float gain_dB)
+{
+    arm_filter_memory *TCM = pinstance->TCM;
+    arm_filter_design_cache *C;
+    float maxc;
+    uint8_t i, j, postShift;
+
+    /* presets switching and retuning to a previous setting do not recompute */
+    for (i = 0; i < FILTER_DESIGN_CACHE; i++)
+    {   C = &(TCM->cache[i]);
+        if (C->type == type && C->numStages == numStages && C->fnorm == fnorm && C->Q == Q && C->gain_dB == gain_dB)
+        {   break;
+        }
+    }
+    if (i == FILTER_DESIGN_CACHE)
+    {   C = &(TCM->cache[TCM->cache_next]);
+        TCM->cache_next = (uint8_t)((TCM->cache_next + 1u) % FILTER_DESIGN_CACHE);
+        C->type = type;     C->numStages = numStages;
+        C->fnorm = fnorm;   C->Q = Q;   C->gain_dB = gain_dB;
+        C->nbDesigned = arm_filter_design(type, numStages, fnorm, Q, gain_dB, C->coefs);
+    }
+    numStages = C->nbDesigned;
+
+    /* q15 : common postShift giving |coef| < 1 */
+    maxc = 0.0f;
+    for (i = 0; i < 5u * numStages; i++) { maxc = MAX(maxc, fabsf(C->coefs[i])); }
+    for (postShift = 0; postShift < 7u && maxc >= 32767.0f / 32768.0f * (float)(1 << postShift); postShift++) { }
+
+    for (i = 0; i < numStages; i++)
+    {   float *c = &(C->coefs[5*i]);
+        q15_t *q15 = &(TCM->coefs[6*i]);
+
+        q15[1] = 0;
+        for (j = 0; j < 5u; j++)
+        {   float x = c[j] * 32768.0f / (float)(1 << postShift);
+            q15[(j == 0) ? 0 : j + 1] = (q15_t)lrintf(MIN(MAX(x, -32768.0f), 32767.0f));
+
+            if (pinstance->raw == STREAM_S32)
+            {   double y = (double)c[j] * 2147483648.0 / (double)(1 << postShift);
+                TCM->coefs32[5*i + j] = (int32_t)lrint(MIN(MAX(y, -2147483648.0), 2147483647.0));
+            }
+            if (pinstance->raw == STREAM_FP32)
+            {   ((float *)(TCM->coefs32))[5*i + j] = c[j];
+            }
+            if (pinstance->raw == STREAM_FP64)
+            {   ((double *)(TCM->coefs64))[5*i + j] = (double)c[j];
+            }
+        }
+    }
+
+    filter_kernels_init(pinstance, numStages, postShift);
+}
+#endif  /* STREAM_FLOAT_ALLOWED */
+#endif  /* CODE_ARM_STREAM_FILTER */
+
 /*
 ;----------------------------------------------------------------------------------------
 ;6.	arm_stream_filter
 ;----------------------------------------------------------------------------------------
 ;   Operation : receives one multichannel stream and produces one filtered multichannel stream. 
 ;   Parameters : biquad filters coefficients used in cascade. Implementation is 2 Biquads max.
+;   Mono int16 streams use the DF1 service, mono fp32/fp64 streams use the transposed DF2
+;   service (denormals flushed), interleaved multichannel streams use the multichannel
+;   service (q15/q31/f32 depending on the arc raw format) with one state per channel.
+;   fp64 streams are mono.
 ;   (see www.w3.org/TR/audio-eq-cookbook)
 ;
 ;   preset 0 = by-pass
@@ -127,6 +253,7 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
                 in the case of arm_filter : 
                     memresult[0] : instance of the component
                     memresult[1] : pointer to the allocated memory (biquad states and coefs)
+                                    followed by the multichannel states (node_mem_nbchan)
 
                     memresult[2] : input arc Word 0 FRAMESZ_FMT0 (frame size..)
                     memresult[ ] : input arc Word 3 DOMAINSPECIFIC_FMT3 
@@ -134,7 +261,7 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
                     memresult[6] : output arc Word 0 FRAMESZ_FMT0 
                     memresult[ ] : output arc Word 1 DOMAINSPECIFIC_FMT3 
 
-                preset (8bits) : number of biquads in cascade, max = 4, from NODE manifest 
+                preset (8bits) : designed filter, from NODE manifest (0 = by-pass, see below)
                 tag (8bits)  : unused
         */
         case STREAM_RESET: 
@@ -144,13 +271,14 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
             uint8_t n;
             arm_filter_instance *pinstance;
             uint8_t preset;
-            uint16_t *pt16dst;
             intptr_t * memresult;
 
             preset = (uint8_t) RD(command, PRESET_CMD);
             memresult = (intptr_t * )instance;
             pinstance = (arm_filter_instance *)(memresult[0]);    /* first bank = node instance */
             pinstance->TCM = (arm_filter_memory *)(memresult[1]); /* second bank = fast memory allocation */
+            pinstance->raw = (uint8_t)RD(memresult[3], RAW_FMT1);    /* input arc format word 1 */
+            pinstance->nchan = (uint8_t)(RD(memresult[3], NCHANM1_FMT1) + 1u);
 
             // DYNAMIC ALLOCATION EXAMPLE, CAN DEPEND ON ARCS FORMAT
             // if (STREAM_DYN_MALLOC == RD(command, COMMDEXT_CMD))
@@ -163,19 +291,38 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
             n = sizeof(pinstance->TCM->state);
             for (i = 0; i < n; i++) { pt8b[i] = 0; }
 
-            /* load presets */
-            pt16dst = (uint16_t *)(&(pinstance->TCM->coefs[0]));
+            pinstance->services = (stream_services *)data;
+
+            /* the design cache is empty */
+            for (i = 0; i < FILTER_DESIGN_CACHE; i++) { pinstance->TCM->cache[i].type = 0xFF; }
+            pinstance->TCM->cache_next = 0;
+
+            /* load presets, frequencies normalized to the sampling rate */
+#if STREAM_FLOAT_ALLOWED==1
             switch (preset)
             {   default: 
                 case 0:     /* by-pass*/
+                    filter_design_load(pinstance, FILTER_DESIGN_BYPASS, 1, 0.0f, 0.0f, 0.0f);
                     break;
-                case 1:     /* LPF fc=fs/4 */
+                case 1:     /* LPF fc=fs/4, Butterworth order 4 */
+                    filter_design_load(pinstance, FILTER_DESIGN_BUTTER_LPF, 2, 0.25f, 0.0f, 0.0f);
                     break;
-                case 2:     /* HPF fc=fs/8 */
+                case 2:     /* HPF fc=fs/8, Butterworth order 4 */
+                    filter_design_load(pinstance, FILTER_DESIGN_BUTTER_HPF, 2, 0.125f, 0.0f, 0.0f);
+                    break;
+                case 3:     /* crossover low side fc=fs/8, Linkwitz-Riley order 4 */
+                    filter_design_load(pinstance, FILTER_DESIGN_LR_LPF, 2, 0.125f, 0.0f, 0.0f);
+                    break;
+                case 4:     /* crossover high side fc=fs/8, Linkwitz-Riley order 4 */
+                    filter_design_load(pinstance, FILTER_DESIGN_LR_HPF, 2, 0.125f, 0.0f, 0.0f);
                     break;
             }
-
-            pinstance->services = (stream_services *)data;
+#else
+            {   q15_t *pt16dst = pinstance->TCM->coefs;     /* by-pass : b0 = 0.5 and postShift = 1 */
+                pt16dst[0] = 16384; pt16dst[1] = pt16dst[2] = pt16dst[3] = pt16dst[4] = pt16dst[5] = 0;
+                filter_kernels_init(pinstance, 1, 1);
+            }
+#endif
             break;
         }       
 
@@ -201,6 +348,15 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
                 5 s16; 681   422   681 23853 -15161     ; INT16 elliptic band-pass 1450..1900/16kHz
                 5 s16; 681 -1342   681 26261 -15331     ; 
                 parameter_end                
+
+                or the designer format, the coefficients are computed and cached by the node :
+                parameter_start
+                1  u8;  1                               ; designer format
+                1  u8;  8                               ; FILTER_DESIGN_BUTTER_LPF
+                1  u8;  2                               ; numStages
+                1  u8;  0                               ; 
+                4 f32;  16000 1200 0.707 0              ; sampling rate, frequency, Q, gain dB
+                parameter_end                
             */
             pt8bsrc = (uint8_t *) data;
             pt16src = (uint16_t *) data;
@@ -210,6 +366,20 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
             numStages = *pt8bsrc++;
             postShift = *pt8bsrc++;
 
+            numStages = MIN(numStages, MAX_NB_BIQUAD_Q15);
+            if (cmsisFormat == FILTER_PARAM_DESIGNER)
+            {
+#if STREAM_FLOAT_ALLOWED==1
+                float design[4];        /* sampling rate, frequency, Q, gain dB : unaligned in the parameters */
+
+                memcpy(design, pt8bsrc, sizeof(design));
+                if (design[0] > 0.0f)   /* the previous coefficients are kept on a wrong sampling rate (and NaN) */
+                {   filter_design_load(pinstance, rawFormat, numStages, design[1] / design[0], design[2], design[3]);
+                }
+#endif
+                break;
+            }
+
             pt16src = &(pt16src[2]);    /* skip the above 4bytes header */
             pt16dst = (uint16_t *)(&(pinstance->TCM->coefs[0]));
 
@@ -223,16 +393,32 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
                 *pt16dst++ = *pt16src++;    // a12
             }
 
-            /* optimized kernels INIT */
-            pinstance->iir_service = PACK_SERVICE(SERV_DSP_INIT,NOOPTION_SSRV,NOTAG_SSRV, SERV_DSP_CASCADE_DF1_Q15,SERV_GROUP_DSP_ML);
+            /* coefficients in the arithmetics of the arc : q31 and f32 in coefs32[], f64 in coefs64[] */
+            {   int16_t *pt16coef = (int16_t *)(&(pinstance->TCM->coefs[0]));
+                int32_t *pt32dst = pinstance->TCM->coefs32;
+                int64_t *pt64dst = pinstance->TCM->coefs64;
+                uint8_t j, k;
+
+                for (i = 0; i < numStages; i++)
+                {   for (j = 0; j < 6; j++)
+                    {   if (j == 1) continue;       /* skip the 0 of the q15 format */
+                        k = (uint8_t)(i * 6 + j);
+                        if (pinstance->raw == STREAM_S32)
+                        {   *pt32dst++ = (int32_t)pt16coef[k] << 16;     /* same postShift in Q31 */
+                        }
+#if STREAM_FLOAT_ALLOWED==1
+                        if (pinstance->raw == STREAM_FP32)
+                        {   *(float *)pt32dst++ = (float)pt16coef[k] * (float)(1 << postShift) / 32768.0f;
+                        }
+                        if (pinstance->raw == STREAM_FP64)
+                        {   *(double *)pt64dst++ = (double)pt16coef[k] * (double)(1 << postShift) / 32768.0;
+                        }
+#endif
+                    }
+                }
+            }
 
-            pinstance->services(                                            // void arm_stream_services (      
-                pinstance->iir_service,                                     //      uint32_t command, 
-                (intptr_t)&(pinstance->TCM->biquad_cascade_df1_inst_q15),   //      intptr_t ptr1, 
-                (intptr_t)&(pinstance->TCM->coefs),                         //      intptr_t ptr2, 
-                (intptr_t)&(pinstance->TCM->state),                         //      intptr_t ptr3, 
-                (intptr_t)(numStages << 8u) | postShift                     //      intptr_t n)
-                );
+            filter_kernels_init(pinstance, numStages, postShift);
             break;
         }
 
@@ -255,6 +441,53 @@ void arm_stream_filter (uint32_t command, void *instance, void *data, uint32_t *
 
             pinstance = (arm_filter_instance *) instance;
 
+            if (FILTER_USE_MC(pinstance))
+            {   uint32_t sample_bytes = FILTER_SAMPLE_BYTES(pinstance->raw) * pinstance->nchan;
+                intptr_t nb_frames;
+
+                pt_pt = data;   inBuf = (int16_t *)pt_pt->address;      stream_xdmbuffer_size_in = pt_pt->size; 
+                pt_pt++;        outBuf = (int16_t *)pt_pt->address;     stream_xdmbuffer_size_out = pt_pt->size;
+
+                nb_frames = MIN(stream_xdmbuffer_size_in, stream_xdmbuffer_size_out) / sample_bytes;
+
+                pinstance->iir_service = PACK_SERVICE(SERV_DSP_RUN,NOOPTION_SSRV,NOTAG_SSRV,FILTER_MC_FUNCTION(pinstance->raw),SERV_GROUP_DSP_ML);
+
+                pinstance->services(
+                    pinstance->iir_service,
+                    (intptr_t)(&(pinstance->TCM->biquad_cascade_mc_inst)),
+                    (intptr_t)inBuf, 
+                    (intptr_t)outBuf,
+                    (intptr_t)nb_frames
+                    );
+
+                pt_pt = data;   *(&(pt_pt->size)) = nb_frames * sample_bytes;   /* amount of data consumed */
+                pt_pt ++;       *(&(pt_pt->size)) = nb_frames * sample_bytes;   /* amount of data produced */
+                break;
+            }
+
+            if (pinstance->raw == STREAM_FP32 || pinstance->raw == STREAM_FP64)
+            {   uint32_t sample_bytes = FILTER_SAMPLE_BYTES(pinstance->raw);
+
+                pt_pt = data;   inBuf = (int16_t *)pt_pt->address;      stream_xdmbuffer_size_in = pt_pt->size; 
+                pt_pt++;        outBuf = (int16_t *)pt_pt->address;     stream_xdmbuffer_size_out = pt_pt->size;
+
+                nb_data = MIN(stream_xdmbuffer_size_in, stream_xdmbuffer_size_out) / sample_bytes;
+
+                pinstance->iir_service = PACK_SERVICE(SERV_DSP_RUN,NOOPTION_SSRV,NOTAG_SSRV,FILTER_DF2T_FUNCTION(pinstance->raw),SERV_GROUP_DSP_ML);
+
+                pinstance->services(
+                    pinstance->iir_service,
+                    (intptr_t)(&(pinstance->TCM->biquad_cascade_df2T_inst)),
+                    (intptr_t)inBuf, 
+                    (intptr_t)outBuf,
+                    (intptr_t)nb_data
+                    );
+
+                pt_pt = data;   *(&(pt_pt->size)) = nb_data * sample_bytes;     /* amount of data consumed */
+                pt_pt ++;       *(&(pt_pt->size)) = nb_data * sample_bytes;     /* amount of data produced */
+                break;
+            }
+
             pt_pt = data;   inBuf = (int16_t *)pt_pt->address;   
                             stream_xdmbuffer_size_in = pt_pt->size;  /* data amount in the input buffer */
             pt_pt++;        outBuf = (int16_t *)(pt_pt->address); 
@@ -52,11 +52,66 @@
             int8_t numStages;        /**< number of 2nd order stages in the filter.  Overall order is 2*numStages. */
             int8_t postShift;        /**< Additional shift, in bits, applied to each output sample. */
     } platform_arm_biquad_cascade_df1_inst_q15; 
+
+    /**
+     * @brief Copy of the Instance structure for the multichannel interleaved Biquad cascade filter.
+     */
+    typedef struct
+    {
+            void *pState;            /**< Points to the array of states.  The array is of length 4*numStages*numChannels. */
+      const void *pCoeffs;           /**< Points to the array of coefficients (q15 : 6*numStages, q31/f32 : 5*numStages). */
+            uint8_t numStages;       /**< number of 2nd order stages in the filter. */
+            uint8_t numChannels;     /**< number of interleaved channels. */
+            int8_t postShift;        /**< Additional shift, in bits, applied to each output sample. */
+    } platform_biquad_cascade_mc_inst; 
+
+    /**
+     * @brief Copy of the Instance structure for the f32/f64 transposed DF2 Biquad cascade filter.
+     */
+    typedef struct
+    {
+            uint8_t numStages;       /**< number of 2nd order stages in the filter. */
+            void *pState;            /**< Points to the array of states.  The array is of length 2*numStages. */
+      const void *pCoeffs;           /**< Points to the array of coefficients.  The array is of length 5*numStages. */
+    } platform_biquad_cascade_df2T_inst; 
   
 /* ----------------------------- */
 
 #define MAX_NB_BIQUAD_Q15 2
 
+/* ----------------------------- */
+/*  designer types (parameter "designer" format and presets), see arm_stream_filter_design.c */
+
+#define FILTER_DESIGN_BYPASS      0
+#define FILTER_DESIGN_LPF         1     /* RBJ cookbook sections */
+#define FILTER_DESIGN_HPF         2
+#define FILTER_DESIGN_BPF         3
+#define FILTER_DESIGN_NOTCH       4
+#define FILTER_DESIGN_PEAKING     5
+#define FILTER_DESIGN_LOWSHELF    6
+#define FILTER_DESIGN_HIGHSHELF   7
+#define FILTER_DESIGN_BUTTER_LPF  8     /* Butterworth order 2 x numStages */
+#define FILTER_DESIGN_BUTTER_HPF  9
+#define FILTER_DESIGN_LR_LPF     10     /* Linkwitz-Riley order 2 x numStages */
+#define FILTER_DESIGN_LR_HPF     11
+
+#define FILTER_PARAM_CMSIS        0     /* first byte of the parameters : coefficients given in q15 */
+#define FILTER_PARAM_DESIGNER     1     /* first byte of the parameters : coefficients computed by the node */
+
+#define FILTER_DESIGN_CACHE       4     /* number of designs kept in memory */
+
+typedef struct
+{   float fnorm;                        /* frequency / sampling rate */
+    float Q;
+    float gain_dB;
+    uint8_t type;                       /* FILTER_DESIGN_xx, 0xFF = free entry */
+    uint8_t numStages;                  /* requested */
+    uint8_t nbDesigned;                 /* result */
+    float coefs[MAX_NB_BIQUAD_Q15*5];   /* {b0 b1 b2 a1 a2} */
+} arm_filter_design_cache;
+
+extern uint8_t arm_filter_design (uint8_t type, uint8_t numStages, float fnorm, float Q, float gain_dB, float *coefs);
+
 /* ----------------------------- */
 /*
     format:  {b10, 0, b11, b12, a11, a12, b20, 0, b21, b22, a21, a22, ...}
@@ -69,16 +124,30 @@ typedef struct
 {   
     platform_arm_biquad_cascade_df1_inst_q15 biquad_cascade_df1_inst_q15;
 
+    platform_biquad_cascade_mc_inst biquad_cascade_mc_inst;
+    platform_biquad_cascade_df2T_inst biquad_cascade_df2T_inst;
+
     q15_t coefs[MAX_NB_BIQUAD_Q15*6];
     q15_t state[MAX_NB_BIQUAD_Q15*4];        
+    int32_t coefs32[MAX_NB_BIQUAD_Q15*5];   /* q31 or f32 {b0 b1 b2 a1 a2} of the multichannel and TDF2 filters */
+    int64_t coefs64[MAX_NB_BIQUAD_Q15*5];   /* f64 {b0 b1 b2 a1 a2} of the TDF2 filter */
+    int64_t state64[MAX_NB_BIQUAD_Q15*2];   /* f32 or f64 {d1 d2} of the TDF2 filter */
 
+    arm_filter_design_cache cache[FILTER_DESIGN_CACHE];
+    uint8_t cache_next;                 /* next entry to replace */
+
+    /* followed by the multichannel state : MAX_NB_BIQUAD_Q15 x 4 x nb channels x 4 bytes */
 } arm_filter_memory;
 
+#define FILTER_MC_STATE_BYTES_PER_CHANNEL (MAX_NB_BIQUAD_Q15*4*4)
+
 
 typedef struct
 {   uint32_t iir_service;
     stream_services *services;
     arm_filter_memory *TCM;
+    uint8_t raw;                /* raw format of the input arc */
+    uint8_t nchan;              /* number of interleaved channels, the multichannel service is used when > 1 */
 } arm_filter_instance;
 
 #endif
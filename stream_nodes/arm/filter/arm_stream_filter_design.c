@@ -0,0 +1,162 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        arm_stream_filter_design.c
+ * Description:  biquad coefficients designer of arm_stream_filter
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "presets.h"
+#ifdef CODE_ARM_STREAM_FILTER
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_filter.h"
+
+#if STREAM_FLOAT_ALLOWED==1
+#include <math.h>
+
+#define FILTER_PI 3.14159265358979f
+
+/*
+    RBJ "audio EQ cookbook" (www.w3.org/TR/audio-eq-cookbook) section, normalized by a0 and
+    returned in the CMSIS order {b0 b1 b2 a1 a2} with a1 a2 negated
+        w0 = 2 pi f0/Fs     alpha = sin(w0)/2Q      A = 10^(dBgain/40)
+*/
+static void rbj_biquad (uint8_t type, float fnorm, float Q, float gain_dB, float *c)
+{
+    float w0, cw, sw, alpha, A, sqA, b0, b1, b2, a0, a1, a2;
+
+    w0 = 2.0f * FILTER_PI * fnorm;
+    cw = cosf(w0);
+    sw = sinf(w0);
+    alpha = sw / (2.0f * Q);
+    A = powf(10.0f, gain_dB / 40.0f);
+    sqA = 2.0f * sqrtf(A) * alpha;
+
+    a0 = 1.0f + alpha;  a1 = -2.0f * cw;  a2 = 1.0f - alpha;
+    switch (type)
+    {
+    default:
+    case FILTER_DESIGN_LPF:
+        b1 = 1.0f - cw;     b0 = b1 * 0.5f;     b2 = b0;                break;
+    case FILTER_DESIGN_HPF:
+        b1 = -(1.0f + cw);  b0 = -b1 * 0.5f;    b2 = b0;                break;
+    case FILTER_DESIGN_BPF:         /* constant 0dB peak gain */
+        b0 = alpha;         b1 = 0.0f;          b2 = -alpha;            break;
+    case FILTER_DESIGN_NOTCH:
+        b0 = 1.0f;          b1 = -2.0f * cw;    b2 = 1.0f;              break;
+    case FILTER_DESIGN_PEAKING:
+        b0 = 1.0f + alpha * A;  b1 = -2.0f * cw;    b2 = 1.0f - alpha * A;
+        a0 = 1.0f + alpha / A;                      a2 = 1.0f - alpha / A;
+        break;
+    case FILTER_DESIGN_LOWSHELF:
+        b0 =        A * ((A + 1.0f) - (A - 1.0f) * cw + sqA);
+        b1 = 2.0f * A * ((A - 1.0f) - (A + 1.0f) * cw);
+        b2 =        A * ((A + 1.0f) - (A - 1.0f) * cw - sqA);
+        a0 =             (A + 1.0f) + (A - 1.0f) * cw + sqA;
+        a1 =    -2.0f * ((A - 1.0f) + (A + 1.0f) * cw);
+        a2 =             (A + 1.0f) + (A - 1.0f) * cw - sqA;
+        break;
+    case FILTER_DESIGN_HIGHSHELF:
+        b0 =        A * ((A + 1.0f) + (A - 1.0f) * cw + sqA);
+        b1 =-2.0f * A * ((A - 1.0f) + (A + 1.0f) * cw);
+        b2 =        A * ((A + 1.0f) + (A - 1.0f) * cw - sqA);
+        a0 =             (A + 1.0f) - (A - 1.0f) * cw + sqA;
+        a1 =     2.0f * ((A - 1.0f) - (A + 1.0f) * cw);
+        a2 =             (A + 1.0f) - (A - 1.0f) * cw - sqA;
+        break;
+    }
+
+    c[0] = b0 / a0;     c[1] = b1 / a0;     c[2] = b2 / a0;
+    c[3] = -a1 / a0;    c[4] = -a2 / a0;
+}
+
+
+/**
+  @brief         Design a cascade of biquads
+  @param[in]     type       FILTER_DESIGN_xx
+  @param[in]     numStages  number of biquads (Butterworth : order = 2 x numStages,
+                            Linkwitz-Riley : order = 2 x numStages made of two Butterworth of order numStages)
+  @param[in]     fnorm      cutoff or center frequency / sampling rate
+  @param[in]     Q          quality factor of the RBJ sections
+  @param[in]     gain_dB    gain of the shelf and peaking sections
+  @param[out]    coefs      numStages x {b0 b1 b2 a1 a2}, a1 a2 with the opposite sign given by Matlab
+  @return        number of biquads designed
+ */
+uint8_t arm_filter_design (uint8_t type, uint8_t numStages, float fnorm, float Q, float gain_dB, float *coefs)
+{
+    uint8_t i, n, rbj;
+
+    numStages = (uint8_t)MIN(MAX(numStages, 1u), MAX_NB_BIQUAD_Q15);
+    fnorm = MIN(MAX(fnorm, 1e-5f), 0.49f);
+    if (Q <= 0.0f) { Q = 0.7071068f; }
+
+    switch (type)
+    {
+    case FILTER_DESIGN_BYPASS:
+        coefs[0] = 1.0f; coefs[1] = coefs[2] = coefs[3] = coefs[4] = 0.0f;
+        return 1;
+
+    case FILTER_DESIGN_BUTTER_LPF:
+    case FILTER_DESIGN_BUTTER_HPF:
+        /* order 2N : section k has Q = 1 / (2 cos((2k+1) pi / 4N)) */
+        rbj = (type == FILTER_DESIGN_BUTTER_LPF) ? FILTER_DESIGN_LPF : FILTER_DESIGN_HPF;
+        for (i = 0; i < numStages; i++)
+        {   Q = 1.0f / (2.0f * cosf((float)(2*i + 1) * FILTER_PI / (float)(4 * numStages)));
+            rbj_biquad(rbj, fnorm, Q, 0.0f, &(coefs[5*i]));
+        }
+        return numStages;
+
+    case FILTER_DESIGN_LR_LPF:
+    case FILTER_DESIGN_LR_HPF:
+        /* Butterworth of order numStages squared : the pairs of conjugated poles are doubled
+            and the two real poles of odd orders are merged in one section with Q = 1/2 */
+        rbj = (type == FILTER_DESIGN_LR_LPF) ? FILTER_DESIGN_LPF : FILTER_DESIGN_HPF;
+        n = 0;
+        for (i = 0; i < numStages / 2; i++)
+        {   Q = 1.0f / (2.0f * cosf((float)(2*i + 1) * FILTER_PI / (float)(2 * numStages)));
+            rbj_biquad(rbj, fnorm, Q, 0.0f, &(coefs[5*n])); n++;
+            rbj_biquad(rbj, fnorm, Q, 0.0f, &(coefs[5*n])); n++;
+        }
+        if (numStages & 1u)
+        {   rbj_biquad(rbj, fnorm, 0.5f, 0.0f, &(coefs[5*n])); n++;
+        }
+        return n;
+
+    default:
+        rbj_biquad(type, fnorm, Q, gain_dB, coefs);
+        return 1;
+    }
+}
+#endif  /* STREAM_FLOAT_ALLOWED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  //CODE_ARM_STREAM_FILTER
@@ -1,13 +1,7 @@
 /* ----------------------------------------------------------------------
- 
-
-        WORK ON GOING
-
-
-
-* Project:      CMSIS Stream
+ * Project:      CMSIS Stream
  * Title:        arm_stream_filter2D.c
- * Description:  filter2Ds
+ * Description:  2D filters of images received line after line
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -47,59 +41,45 @@
 ;----------------------------------------------------------------------------------------
 ;6.	arm_stream_filter2D
 ;----------------------------------------------------------------------------------------
-;   Operation : receives one multichannel stream and produces one filtered multichannel stream. 
-;   Parameters : biquad filters coefficients used in cascade. Implementation is 2 Biquads max.
-;   (see www.w3.org/TR/audio-eq-cookbook)
-;
-;   preset 0 = by-pass
-;
-;   parameter of filter2D : 
-;   - number of biquads in cascade (1 or 2)
-;   - coefficients in Q15
+;   Operation : 2D filter of images (STREAM_U8 or STREAM_S16, 1..3 interleaved components)
+;   received line after line in raster order. The frame is never stored : a rolling buffer
+;   keeps the last "taps" lines, the output line y is produced when the input line y+taps/2 
+;   is received (the last lines of the frame are produced with the last input line), the
+;   borders are replicated. The format of the output arc is the format of the input arc, the
+;   output arc has room for taps/2+1 lines (flush of the end of the frame).
+;   Separable kernels are applied in two passes : the horizontal kernel once per input line, 
+;   the vertical kernel on the filtered lines (2 x taps products per pixel instead of taps^2).
+;   Gradients are two separable kernels combined with |K1| + |K2|.
+;   Parameters : image size, mode, number of taps, coefficients in 16bits, shifts and offset
 ;
+;   presets control (VGA 640x480)
+;   #0 : 3x3 binomial blur        [1 2 1] x [1 2 1] / 16
+;   #1 : 5x5 binomial blur        [1 4 6 4 1] x [1 4 6 4 1] / 256
+;   #2 : 7x7 binomial blur        [1 6 15 20 15 6 1] x [1 6 15 20 15 6 1] / 4096
+;   #3 : 5x5 box average          [1 1 1 1 1] x [41 41 41 41 41] / 1024
+;   #4 : 3x3 sharpening           [0 -1 0; -1 5 -1; 0 -1 0]  (non-separable kernel)
+;   #5 : 3x3 Sobel magnitude      (|Gx| + |Gy|) / 4
 ;
-node 
-    arm_stream_dsp_filter2D 0     instance
-    S 0        preset
-    parameters
-        2  u8; 0 0                          no preset, TAG = "all parameters"
-
-        1  u8;  2                           Two biquads
-        1  u8;  0                           postShift
-        5 h16; 1231 1D28 1231 63E8 D475     b0/b1/b2/-a1/-a2  ellip(4, 1, 40, 3600/8000, 'low') 
-        5 h16; 1231 0B34 1231 2470 9821     second biquad
-        ;  _include    1   arm_stream_filter2D_parameters_x.txt      
-        end
-
-    Half-band low-pass filter2D :
-    [b,a] = ellip(4, 1, 40, 3600/8000, 'low')  MATLAB
-    b = [ 0.0808134359 0.1792766 0.241380 0.179276 0.080813435960181 ]
-    a = [ 1 -1.06520401 1.3738840 -0.730252 0.27605 ]
-
-    decomposed/split in 2 Biquads (b0 b1 b2 a1 a2) :
-    2.842770e-01,  4.555821e-01,  2.842770e-01,  7.805347e-01, -3.401758e-01 
-    2.842770e-01,  1.750586e-01,  2.842770e-01,  2.846693e-01, -8.115139e-01 
-
-    Translation in Q15 without looking at saturations in the recursive paths:
-    9315, 14928,  9315, 25576, -11147, 
-    9315,  5736,  9315,  9328, -26591, 
-
-    Translation to q15 fixed-point arithmetics using a 32bits accumulator (16x16=>32bits)
-    First stage :
-        postShift = 1 to compensate for a 6dB attenuation in b0/b1/b2 
-            added because of the 6dB gain in the recursive path (a1 a2 are untouched)
-    Second stage :
-        6dB attenuation in b0/b1/b2 
-            because of 16dB gain in the recursive path at frequencies but the first 
-            stage is attenuating by ~4dB and we kept -6dB from the first stage 
-            => 16dB -4 - 6 = 6dB attenuation on the numerator
-
-    Translation in Q15 + postShift to manage saturation:
-     4657,  7464,  4657, 25576, -11147,  (pre shifted by 1 on the numerator)
-     4657,  2868,  4657,  9328, -26591,  (additional pre shift by 1 on the numerator)
-     postShift = 2       to compensate the attenuations put on the two stages
+arm_stream_filter2D
+    3  i8; 0 0 0        instance, preset, tag
+    PARSTART
+    2; i16; 320 240;                width and height
+    4; i8; 0 3 0 4;                 separable, 3 taps, hshift, shift
+    2; i16; 0 0;                    offset
+    6; i16; 1 2 1 1 2 1;            horizontal and vertical kernels
+    PARSTOP  
 */
 
+#define NB_PRESET 6
+const filter2D_parameters filter2D_preset [NB_PRESET] = 
+{   /*  width, height, mode, taps, hshift, shift, offset, pad, coefficients */
+    {640, 480, FILTER2D_SEPARABLE, 3, 0,  4, 0, 0, {1, 2, 1,  1, 2, 1}},
+    {640, 480, FILTER2D_SEPARABLE, 5, 0,  8, 0, 0, {1, 4, 6, 4, 1,  1, 4, 6, 4, 1}},
+    {640, 480, FILTER2D_SEPARABLE, 7, 0, 12, 0, 0, {1, 6, 15, 20, 15, 6, 1,  1, 6, 15, 20, 15, 6, 1}},
+    {640, 480, FILTER2D_SEPARABLE, 5, 0, 10, 0, 0, {1, 1, 1, 1, 1,  41, 41, 41, 41, 41}},
+    {640, 480, FILTER2D_GENERAL,   3, 0,  0, 0, 0, {0, -1, 0,  -1, 5, -1,  0, -1, 0}},
+    {640, 480, FILTER2D_GRADIENT,  3, 0,  2, 0, 0, {-1, 0, 1,  1, 2, 1,  1, 2, 1,  -1, 0, 1}},
+};
 
 /**
   @brief         
@@ -119,45 +99,42 @@ void arm_stream_filter2D (int32_t command, stream_handle_t instance, stream_xdmb
                 instance = memory_results and all memory banks following
                 data = address of Stream function
                 
-                memresults are followed by 2 words of STREAM_FORMAT_SIZE_W32 of all the arcs 
+                memresults are followed by the STREAM_FORMAT_SIZE_W32 words of all the arcs 
                 memory pointers are in the same order as described in the NODE manifest
 
                 memresult[0] : instance of the component
-                memresult[1] : pointer to the allocated memory (biquad states and coefs)
+                memresult[1] : pointer to the allocated memory (rolling buffer of lines)
                 memresult[2] : input arc Word 0 SIZSFTRAW_FMT0 (frame size..)
                 memresult[3] : input arc Word 1 SAMPINGNCHANM1_FMT1 
-                memresult[4] : output arc Word 0 SIZSFTRAW_FMT0 
-                memresult[5] : output arc Word 1 SAMPINGNCHANM1_FMT1 
+                memresult[4..5] : input arc Words 2 and 3, domain-dependent
+                memresult[6..9] : output arc Words 0 .. 3
 
-                preset (8bits) : number of biquads in cascade, max = 4, from NODE manifest 
+                preset (8bits) : kernel, from NODE manifest 
                 tag (8bits)  : unused
         */
         case STREAM_RESET: 
-        {   
-            uint8_t *pt8b, i, n;
-            intptr_t *memreq;
-            arm_filter2D_instance *pinstance;
-            uint32_t preset = RD(command, PRESET_CMD);
-            uint16_t *pt16dst;
+        {   intptr_t *memresult = (intptr_t *)instance;
+            uint16_t preset = RD(command, PRESET_CMD);
+            uint8_t *pt8bdst;
+            uint32_t i, n;
 
-            memreq = (intptr_t *)instance;
-            pinstance = (arm_filter2D_instance *) (*memreq++);
+            arm_filter2D_instance *pinstance = (arm_filter2D_instance *) memresult[0];
 
             /* here reset */
-            pt8b = (uint8_t *) (pinstance->TCM->state);
-            n = sizeof(pinstance->TCM->state);
-            for (i = 0; i < n; i++) { pt8b[i] = 0; }
-
-            /* load presets */
-            pt16dst = (uint16_t *)(&(pinstance->TCM->coefs[0]));
-            switch (preset)
-            {   default: 
-                case 0:     /* by-pass*/
-                    pt16dst[0] = 0x7FFF;
-                    break;
+            pt8bdst = (uint8_t *) pinstance;
+            n = sizeof(arm_filter2D_instance);
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = 0;
+            }
+            pinstance->TCM = (arm_filter2D_memory *) memresult[1];
+            pinstance->raw = (uint8_t)RD(memresult[3], RAW_FMT1);     /* input arc format word 1 */
+            pinstance->nchan = (uint8_t)(RD(memresult[3], NCHANM1_FMT1) + 1u);
+            if (pinstance->raw != STREAM_S16)
+            {   pinstance->raw = STREAM_U8;
             }
 
-            pinstance->services = (stream_services *)data;
+            pinstance->config = filter2D_preset[MIN(preset, NB_PRESET-1)];    /* preset data move */
+            arm_stream_filter2D_init(pinstance);
             break;
         }       
 
@@ -167,34 +144,25 @@ void arm_stream_filter2D (int32_t command, stream_handle_t instance, stream_xdmb
                 data = (one or all)
         */ 
         case STREAM_SET_PARAMETER:  
-        {   uint8_t *pt8bsrc, i, numStages;
-            uint16_t *pt16src, *pt16dst;
-            int8_t postShift;
-            arm_filter2D_instance *pinstance = (arm_filter2D_instance *) instance;
+        {   arm_filter2D_instance *pinstance = (arm_filter2D_instance *) instance;
 
-            /* copy the parameters 
-                parameter_start
-                1  i8;  2                           Two biquads
-                1  i8;  0                           postShift
-                5 h16; 5678 2E5B 71DD 2166 70B0     b0/b1/b2/a1/a2 
-                5 h16; 5678 2E5B 71DD 2166 70B0     second biquad
-                parameter_end                
-            */
-            pt8bsrc = (uint8_t *) data;
-            numStages = (*pt8bsrc++);
-            postShift = (*pt8bsrc++);
-
-            pt16src = (uint16_t *)pt8bsrc;
-            pt16dst = (uint16_t *)(&(pinstance->TCM->coefs[0]));
-            for (i = 0; i < numStages; i++)
-            {   /* format:  {b10, 0, b11, b12, a11, a12, b20, 0, b21, b22, a21, a22, ...} */
-                *pt16dst++ = *pt16src++;    // b10
-                *pt16dst++ = 0;             // 0
-                *pt16dst++ = *pt16src++;    // b11    
-                *pt16dst++ = *pt16src++;    // b12
-                *pt16dst++ = *pt16src++;    // a11
-                *pt16dst++ = *pt16src++;    // a12
+            if (RD(command,NODE_TAG_CMD) < NB_PRESET)
+            {   pinstance->config = filter2D_preset[RD(command,NODE_TAG_CMD)];
+            }
+            if (RD(command,NODE_TAG_CMD) == NODE_ALL_PARAM) 
+            {   uint8_t *pt8bsrc, *pt8bdst, i, n;
+
+                /* copy the parameters */
+                n = sizeof(filter2D_parameters);   
+                pt8bsrc = (uint8_t *) data;     
+                pt8bdst = (uint8_t *) &(pinstance->config);
+                for (i = 0; i < n; i++)
+                {   pt8bdst[i] = pt8bsrc[i];
+                }
             }
+
+            /* the kernel or the geometry can change : restart from the next frame */
+            arm_stream_filter2D_init(pinstance);
             break;
         }
 
@@ -203,24 +171,29 @@ void arm_stream_filter2D (int32_t command, stream_handle_t instance, stream_xdmb
                instance,  
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
+               the input arc receives complete lines (any number per call), the output arc 
+               receives the filtered lines with the same format
         */         
         case STREAM_RUN:   
         {
             arm_filter2D_instance *pinstance = (arm_filter2D_instance *) instance;
             intptr_t nb_data, stream_xdmbuffer_size;
+            int32_t bufferout_free;
             stream_xdmbuffer_t *pt_pt;
-            int16_t *inBuf, *outBuf;
+            uint8_t *inBuf, *outBuf;
 
-            pt_pt = data;   inBuf = (int16_t *)pt_pt->address;   
+            pt_pt = data;   inBuf = (uint8_t *)pt_pt->address;   
                             stream_xdmbuffer_size = pt_pt->size;  /* data amount in the input buffer */
+            pt_pt++;        outBuf = (uint8_t *)(pt_pt->address); 
+                            bufferout_free = (int32_t)(pt_pt->size);
 
-            pt_pt++;        outBuf = (int16_t *)(pt_pt->address); 
-
-            nb_data = stream_xdmbuffer_size / sizeof(int16_t);
-            ST(pinstance->iir_service, FUNCTION_SSRV, SERV_DSP_CASCADE_DF1_Q15);
+            nb_data = arm_stream_filter2D_process (pinstance, inBuf, (int32_t)stream_xdmbuffer_size, 
+                        outBuf, &bufferout_free);
 
+            pt_pt = data;
+            *(&(pt_pt->size)) = nb_data;            /* amount of data consumed */
+            pt_pt ++;
+            *(&(pt_pt->size)) = bufferout_free;     /* amount of data produced */
             break;
         }
 
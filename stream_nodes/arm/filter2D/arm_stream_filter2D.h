@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
- * Title:        arm_stream_filter2D.c
- * Description:  filter2Ds
+ * Title:        arm_stream_filter2D.h
+ * Description:  2D filters of images received line after line
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -22,62 +22,100 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 
 #ifndef cARM_DSP_filter2D_H
 #define cARM_DSP_filter2D_H
 
 
-#include "stream_const.h"      
-#include "stream_types.h"  
-
+#include "stream_const.h"
+#include "stream_types.h"
 
 
-typedef int16_t q15_t;
-#define MAX_NB_BIQUAD_Q15 2
-
-/* ----------------------------- */
 /*
-    format:  {b10, 0, b11, b12, a11, a12, b20, 0, b21, b22, a21, a22, ...}
-    y[n] = 2^postShift (b0 * x[n] + b1 * x[n-1] + b2 * x[n-2]) + a1 * y[n-1] + a2 * y[n-2]
-    a1 and a2 have the opposite sign given by Matlab
+    Images (STREAM_U8 or STREAM_S16, interleaved color components) are received in raster order.
+    The last lines are kept in a rolling buffer of "taps" lines of 16bits samples, the output
+    line y is computed when the input line y + taps/2 is received, the borders are replicated.
+
+    FILTER2D_SEPARABLE : the horizontal kernel is applied once per input line, the buffer keeps
+                         the filtered lines and the vertical kernel gives the output line
+                         coef = {h[0..taps-1], v[0..taps-1]}
+    FILTER2D_GENERAL   : the buffer keeps the input lines (with borders), taps x taps kernel
+                         coef = {k[0][0..taps-1], k[1][0..taps-1], .. }
+    FILTER2D_GRADIENT  : two separable kernels, result = |K1| + |K2| (Sobel, Prewitt, Scharr)
+                         coef = {h1[], v1[], h2[], v2[]}
+
+    result = saturate (((sum of the products) + rounding) >> shift) + offset), the horizontal
+    pass of the separable kernels is shifted by hshift to keep 16bits intermediate lines.
 */
 
-typedef struct
+#define FILTER2D_SEPARABLE              0
+#define FILTER2D_GENERAL                1
+#define FILTER2D_GRADIENT               2
+
+#define FILTER2D_PRESET_BLUR3           0   /* 3x3 binomial */
+#define FILTER2D_PRESET_BLUR5           1   /* 5x5 binomial */
+#define FILTER2D_PRESET_BLUR7           2   /* 7x7 binomial */
+#define FILTER2D_PRESET_BOX5            3   /* 5x5 box average */
+#define FILTER2D_PRESET_SHARPEN3        4   /* 3x3 Laplacian sharpening */
+#define FILTER2D_PRESET_SOBEL3          5   /* 3x3 Sobel magnitude |Gx| + |Gy| */
+
+#define FILTER2D_MAX_TAPS               7
+#define FILTER2D_MAX_NCHAN              3   /* interleaved color components */
+#define FILTER2D_MAX_WIDTH            640
+#define FILTER2D_MAX_SAMPLES          (FILTER2D_MAX_WIDTH * FILTER2D_MAX_NCHAN)
+#define FILTER2D_LINE_STRIDE          (FILTER2D_MAX_SAMPLES + (FILTER2D_MAX_TAPS - 1) * FILTER2D_MAX_NCHAN)
+#define FILTER2D_LINES                (FILTER2D_MAX_TAPS + 1)    /* rolling buffer and the input line with its borders */
+#define FILTER2D_CHUNK                128   /* output samples computed in 32bits before the saturation */
+
+typedef struct          /* 110 Bytes  */
 {
-    int8_t numStages;        
-    q15_t  coefs[MAX_NB_BIQUAD_Q15*6];        
-    int8_t postShift;        
-} arm_biquad_casd_df1_q15_preset;
+    uint16_t width;             /* pixels per line */
+    uint16_t height;            /* lines per frame */
+    uint8_t mode;               /* FILTER2D_SEPARABLE, _GENERAL, _GRADIENT */
+    uint8_t taps;               /* kernel width and height, odd, 1 .. FILTER2D_MAX_TAPS (3 with FILTER2D_GRADIENT) */
+    uint8_t hshift;             /* right shift of the horizontal pass (separable kernels) */
+    uint8_t shift;              /* right shift of the result */
+    int16_t offset;             /* added to the shifted result */
+    int16_t pad___;
+    int16_t coef [FILTER2D_MAX_TAPS * FILTER2D_MAX_TAPS];
+} filter2D_parameters;
 
 
 typedef struct
 {
-    q15_t coefs[MAX_NB_BIQUAD_Q15*6];
-    q15_t state[MAX_NB_BIQUAD_Q15*4];    
-    
-
+    int16_t line [FILTER2D_LINES][FILTER2D_LINE_STRIDE];
+    int32_t acc [2][FILTER2D_CHUNK];
 } arm_filter2D_memory;
 
 
-
 typedef struct
 {
-    uint32_t iir_service;
-    stream_services *services;
+    filter2D_parameters config; /* 110 bytes */
+    uint8_t raw;                /* STREAM_U8 or STREAM_S16, from the input arc format */
+    uint8_t nchan;              /* interleaved components per pixel */
+    uint8_t nbuf;               /* line buffers of a rolling buffer (= taps) */
+    uint16_t y;                 /* next input line of the frame */
+    uint32_t samples;           /* samples per line = width x nchan */
     arm_filter2D_memory *TCM;
-
 } arm_filter2D_instance;
 
+
+extern void arm_stream_filter2D_init (arm_filter2D_instance *instance);
+
+extern int32_t arm_stream_filter2D_process (arm_filter2D_instance *instance,
+                     uint8_t *in, int32_t inputLength,
+                     uint8_t *out, int32_t *outputLength);
+
 #endif
 
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
+
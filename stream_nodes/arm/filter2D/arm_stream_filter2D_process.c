@@ -0,0 +1,287 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        arm_stream_filter2D_process.c
+ * Description:  2D filters of images received line after line
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "presets.h"
+#ifdef CODE_ARM_STREAM_FILTER2D
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_filter2D.h"
+
+
+/*
+    The input line r is stored in the buffer r % taps of the rolling buffer, the output line y
+    uses the input lines y-taps/2 .. y+taps/2 clamped to the frame (replicated borders) : they are
+    the last "taps" lines received, nothing is copied when the buffer rolls.
+    The lines are processed in chunks of FILTER2D_CHUNK samples, one tap of the kernel at a time :
+    the inner loop is a multiply-accumulate of 16bits samples in 32bits accumulators with no
+    border test, vectorized by the compiler (zero coefficients are skipped).
+*/
+
+#define FILTER2D_CLAMP_U8(x)  (uint8_t)MIN(255, MAX(0, (x)))
+#define FILTER2D_CLAMP_S16(x) (int16_t)MIN(32767, MAX(-32768, (x)))
+
+
+/*
+    input line with taps/2 replicated pixels on both sides
+*/
+static void filter2D_load (arm_filter2D_instance *pinstance, uint8_t *in, int16_t *dst)
+{
+    uint32_t border = (pinstance->config.taps / 2u) * pinstance->nchan;
+    uint32_t i, n = pinstance->samples, nchan = pinstance->nchan;
+    int16_t *pt = &(dst[border]);
+
+    if (pinstance->raw == STREAM_U8)
+    {   for (i = 0; i < n; i++) { pt[i] = in[i]; }
+    }
+    else
+    {   int16_t *in16 = (int16_t *)in;
+        for (i = 0; i < n; i++) { pt[i] = in16[i]; }
+    }
+    for (i = 0; i < border; i++)
+    {   dst[i] = pt[i % nchan];
+        pt[n + i] = pt[n - nchan + (i % nchan)];
+    }
+}
+
+
+/*
+    acc[0..n-1] (+)= c x src[0..n-1] : one tap of a kernel on a chunk of a line
+*/
+static void filter2D_mac (int32_t *acc, const int16_t *src, int32_t c, uint32_t n, uint8_t first)
+{
+    uint32_t i;
+
+    if (first)
+    {   for (i = 0; i < n; i++) { acc[i] = c * src[i]; }
+    }
+    else if (c != 0)
+    {   for (i = 0; i < n; i++) { acc[i] += c * src[i]; }
+    }
+}
+
+
+/*
+    horizontal kernel of an input line with borders, 16bits result
+*/
+static void filter2D_hpass (int32_t *acc, const int16_t *src, int16_t *dst, const int16_t *h,
+                    uint32_t n, uint32_t nchan, uint8_t hshift, uint32_t taps)
+{
+    int32_t rnd = (1 << hshift) >> 1;
+    uint32_t i, k, m;
+
+    for (; n > 0; n -= m, src += m, dst += m)
+    {   m = MIN(n, FILTER2D_CHUNK);
+        for (k = 0; k < taps; k++)
+        {   filter2D_mac (acc, &(src[k * nchan]), h[k], m, (uint8_t)(k == 0));
+        }
+        for (i = 0; i < m; i++)
+        {   dst[i] = (int16_t)((acc[i] + rnd) >> hshift);
+        }
+    }
+}
+
+
+/*
+    vertical kernel on the lines of the rolling buffer, from the sample "offset"
+*/
+static void filter2D_vpass (int32_t *acc, int16_t **L, uint32_t offset, const int16_t *v, uint32_t m, uint32_t taps)
+{
+    uint32_t k;
+
+    for (k = 0; k < taps; k++)
+    {   filter2D_mac (acc, &(L[k][offset]), v[k], m, (uint8_t)(k == 0));
+    }
+}
+
+
+/*
+    taps x taps kernel on the lines with borders, from the sample "offset"
+*/
+static void filter2D_general (int32_t *acc, int16_t **L, uint32_t offset, const int16_t *c, 
+                    uint32_t m, uint32_t nchan, uint32_t taps)
+{
+    uint32_t j, k;
+
+    for (j = 0; j < taps; j++)
+    {   for (k = 0; k < taps; k++)
+        {   filter2D_mac (acc, &(L[j][offset + k * nchan]), c[j * taps + k], m, (uint8_t)(j == 0 && k == 0));
+        }
+    }
+}
+
+
+/*
+    rounding, shift, offset and saturation to the format of the arc
+*/
+static void filter2D_store (arm_filter2D_instance *pinstance, int32_t *acc, uint8_t *out, uint32_t n)
+{
+    uint32_t i;
+    uint8_t shift = pinstance->config.shift;
+    int32_t rnd = (1 << shift) >> 1, offset = pinstance->config.offset;
+
+    if (pinstance->raw == STREAM_U8)
+    {   for (i = 0; i < n; i++) { out[i] = FILTER2D_CLAMP_U8(((acc[i] + rnd) >> shift) + offset); }
+    }
+    else
+    {   int16_t *out16 = (int16_t *)out;
+        for (i = 0; i < n; i++) { out16[i] = FILTER2D_CLAMP_S16(((acc[i] + rnd) >> shift) + offset); }
+    }
+}
+
+
+/*
+    one output line from the lines L1 (and L2 for the gradients) of the rolling buffer,
+    computed in chunks of FILTER2D_CHUNK samples
+*/
+static void filter2D_line (arm_filter2D_instance *pinstance, int16_t **L1, int16_t **L2, uint8_t *out)
+{
+    filter2D_parameters *config = &(pinstance->config);
+    int32_t *acc = pinstance->TCM->acc[0], *acc2 = pinstance->TCM->acc[1];
+    uint32_t i, j, m, n = pinstance->samples, K = pinstance->nbuf;
+    uint32_t bytes = (pinstance->raw == STREAM_U8) ? 1 : 2;
+
+    for (i = 0; i < n; i += m)
+    {   m = MIN(n - i, FILTER2D_CHUNK);
+        switch (config->mode)
+        {   case FILTER2D_GENERAL:
+                filter2D_general (acc, L1, i, config->coef, m, pinstance->nchan, K);
+                break;
+            case FILTER2D_GRADIENT:
+                filter2D_vpass (acc, L1, i, &(config->coef[K]), m, K);
+                filter2D_vpass (acc2, L2, i, &(config->coef[3*K]), m, K);
+                for (j = 0; j < m; j++)
+                {   acc[j] = ABS(acc[j]) + ABS(acc2[j]);
+                }
+                break;
+            default:
+            case FILTER2D_SEPARABLE:
+                filter2D_vpass (acc, L1, i, &(config->coef[K]), m, K);
+                break;
+        }
+        filter2D_store (pinstance, acc, &(out[i * bytes]), m);
+    }
+}
+
+
+/*
+    initialization of the geometry and restart of the frame, after a reset or a change of parameters
+*/
+void arm_stream_filter2D_init (arm_filter2D_instance *pinstance)
+{
+    filter2D_parameters *config = &(pinstance->config);
+    uint8_t max_taps = (config->mode == FILTER2D_GRADIENT) ? 3 : FILTER2D_MAX_TAPS;
+
+    config->taps = (uint8_t)(MAX(1, MIN(max_taps, config->taps)) | 1u);
+    config->width = (uint16_t)MAX(1, MIN(FILTER2D_MAX_WIDTH, config->width));
+    config->height = (uint16_t)MAX(1, config->height);
+    config->hshift = (uint8_t)MIN(15, config->hshift);
+    config->shift = (uint8_t)MIN(31, config->shift);
+    pinstance->nchan = (uint8_t)MAX(1, MIN(FILTER2D_MAX_NCHAN, pinstance->nchan));
+    pinstance->samples = (uint32_t)config->width * pinstance->nchan;
+    pinstance->nbuf = config->taps;
+    pinstance->y = 0;
+}
+
+
+/**
+  @brief         Processing function
+  @param[in]     instance     points to an instance of the filter
+  @param[in]     in           image lines in raster order
+  @param[in]     inputLength  bytes in the input arc
+  @param[out]    out          filtered lines, delayed by taps/2 lines
+  @param[in/out] outputLength free bytes in the output arc / bytes produced
+  @return        number of bytes consumed (complete lines)
+ */
+int32_t arm_stream_filter2D_process (arm_filter2D_instance *pinstance,
+                     uint8_t *in, int32_t inputLength,
+                     uint8_t *out, int32_t *outputLength)
+{
+    filter2D_parameters *config = &(pinstance->config);
+    arm_filter2D_memory *TCM = pinstance->TCM;
+    int32_t line_bytes, consumed = 0, produced = 0, room = *outputLength;
+    int32_t r, yo, y_first, y_last, k, row;
+    int32_t R = config->taps / 2, H = config->height, K = pinstance->nbuf;
+    int16_t *pad = TCM->line[FILTER2D_LINES - 1];
+    int16_t *L1[FILTER2D_MAX_TAPS], *L2[FILTER2D_MAX_TAPS];
+
+    line_bytes = (int32_t)pinstance->samples * ((pinstance->raw == STREAM_U8) ? 1 : 2);
+
+    while (inputLength - consumed >= line_bytes)
+    {
+        /* output lines computed with this input line : all the remaining lines at the end of the frame */
+        r = pinstance->y;
+        y_first = MAX(0, r - R);
+        y_last = (r == H - 1) ? H - 1 : r - R;
+        if (room - produced < MAX(0, y_last - y_first + 1) * line_bytes)
+        {   break;
+        }
+
+        /* new line in the rolling buffer */
+        switch (config->mode)
+        {   case FILTER2D_GENERAL:
+                filter2D_load (pinstance, &(in[consumed]), TCM->line[r % K]);
+                break;
+            case FILTER2D_GRADIENT:
+                filter2D_load (pinstance, &(in[consumed]), pad);
+                filter2D_hpass (TCM->acc[0], pad, TCM->line[r % K], &(config->coef[0]), pinstance->samples, pinstance->nchan, config->hshift, K);
+                filter2D_hpass (TCM->acc[0], pad, TCM->line[K + r % K], &(config->coef[2*K]), pinstance->samples, pinstance->nchan, config->hshift, K);
+                break;
+            default:
+            case FILTER2D_SEPARABLE:
+                filter2D_load (pinstance, &(in[consumed]), pad);
+                filter2D_hpass (TCM->acc[0], pad, TCM->line[r % K], &(config->coef[0]), pinstance->samples, pinstance->nchan, config->hshift, K);
+                break;
+        }
+        consumed += line_bytes;
+        pinstance->y = (uint16_t)((r + 1 >= H) ? 0 : r + 1);
+
+        for (yo = y_first; yo <= y_last; yo++)
+        {   for (k = 0; k < K; k++)
+            {   row = MIN(H - 1, MAX(0, yo - R + k));
+                L1[k] = TCM->line[row % K];
+                L2[k] = TCM->line[(config->mode == FILTER2D_GRADIENT ? K : 0) + row % K];
+            }
+            filter2D_line (pinstance, L1, L2, &(out[produced]));
+            produced += line_bytes;
+        }
+    }
+
+    *outputLength = produced;
+    return consumed;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CODE_ARM_STREAM_FILTER2D
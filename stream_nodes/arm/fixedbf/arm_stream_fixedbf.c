@@ -24,21 +24,57 @@
  * limitations under the License.
  * 
  */
+#include "presets.h"
+#ifdef CODE_ARM_FIXEDBF
+
 #ifdef __cplusplus
  extern "C" {
 #endif
 
-#include "presets.h"
-#ifdef CODE_ARM_FIXEDBF
-
 #include <stdint.h>
-
 #include "stream_common_const.h"
 #include "stream_common_types.h"
 #include "arm_stream_fixedbf.h"
 
-void arm_stream_fixedbf (uint32_t command, void *instance, void *data, uint32_t *status);
-
+/*
+;----------------------------------------------------------------------------------------
+;7.	arm_stream_fixedbf
+;----------------------------------------------------------------------------------------
+;   Operation : delay-and-sum beamformer. The input arc has the interleaved STREAM_S16 samples
+;   of 1..8 microphones, the output arc has 1..4 interleaved beams. Each beam is the sum of the
+;   microphones delayed by fractional delays (4-taps Lagrange interpolators) and weighted by
+;   gains normalized to a sum of 1.0. A new steering table is applied with a cross-fade of
+;   256 samples from the previous one (no discontinuity).
+;   Parameters : steering table, delays (Q8 samples, from 1.0 to 32.99) and gains (Q15) of 
+;   4 beams x 8 microphones, beam-major.
+;
+;   presets control : beams at 0, 30, 60, 90 degrees from the broadside of a linear array,
+;   16kHz, steered to the side of the last microphone
+;   #0 : spacing 2cm       (0.933 samples x sin(angle) per microphone)
+;   #1 : spacing 4.25cm    (1.98 samples x sin(angle) per microphone)
+;
+arm_stream_fixedbf
+    3  i8; 0 0 0        instance, preset, tag
+    PARSTART
+    32; i16; 256 256 256 256 256 256 256 256  256 375 494 613 732 851 970 1089 ...  delays
+    32; i16; 32767 32767 ...                                                           gains
+    PARSTOP  
+*/
+
+#define NB_PRESET 2
+#define FIXEDBF_G 32767
+#define FIXEDBF_BEAM(k) {256, 256+(k), 256+2*(k), 256+3*(k), 256+4*(k), 256+5*(k), 256+6*(k), 256+7*(k)}
+#define FIXEDBF_GAINS {FIXEDBF_G, FIXEDBF_G, FIXEDBF_G, FIXEDBF_G, FIXEDBF_G, FIXEDBF_G, FIXEDBF_G, FIXEDBF_G}
+
+const fixedbf_parameters fixedbf_preset [NB_PRESET] = 
+{   /* delays of the beams 0, 30, 60, 90 degrees, gains */
+    {   {FIXEDBF_BEAM(0), FIXEDBF_BEAM(119), FIXEDBF_BEAM(207), FIXEDBF_BEAM(239)},
+        {FIXEDBF_GAINS, FIXEDBF_GAINS, FIXEDBF_GAINS, FIXEDBF_GAINS},
+    },
+    {   {FIXEDBF_BEAM(0), FIXEDBF_BEAM(254), FIXEDBF_BEAM(439), FIXEDBF_BEAM(507)},
+        {FIXEDBF_GAINS, FIXEDBF_GAINS, FIXEDBF_GAINS, FIXEDBF_GAINS},
+    },
+};
 
 /**
   @brief         
@@ -50,7 +86,6 @@ void arm_stream_fixedbf (uint32_t command, void *instance, void *data, uint32_t
  */
 void arm_stream_fixedbf (uint32_t command, void *instance, void *data, uint32_t *status)
 {
-
     *status = NODE_TASKS_COMPLETED;    /* default return status, unless processing is not finished */
 
     switch (RD(command,COMMAND_CMD))
@@ -59,63 +94,41 @@ void arm_stream_fixedbf (uint32_t command, void *instance, void *data, uint32_t
                 instance = memory_results and all memory banks following
                 data = address of Stream function
                 
-                memresults are followed by 4 words of STREAM_FORMAT_SIZE_W32 of all the arcs 
+                memresults are followed by the STREAM_FORMAT_SIZE_W32 words of all the arcs 
                 memory pointers are in the same order as described in the NODE manifest
 
                 memresult[0] : instance of the component
-                memresult[1] : pointer to the allocated memory (biquad states and coefs)
-
+                memresult[1] : pointer to the allocated memory (history and coefficients)
                 memresult[2] : input arc Word 0 SIZSFTRAW_FMT0 (frame size..)
-                memresult[ ] : input arc Word 1 SAMPINGNCHANM1_FMT1 
-                ..
-                memresult[ ] : output arc Word 0 SIZSFTRAW_FMT0 
-                memresult[ ] : output arc Word 1 SAMPINGNCHANM1_FMT1 
+                memresult[3] : input arc Word 1 SAMPINGNCHANM1_FMT1 
+                memresult[4] : input arc Word 2 domain-dependent (sampling rate)
+                memresult[5] : input arc Word 3 domain-dependent (audio mapping)
+                memresult[6] : output arc Word 0 SIZSFTRAW_FMT0 
+                memresult[7] : output arc Word 1 SAMPINGNCHANM1_FMT1 
 
-                preset (8bits) : number of biquads in cascade, max = 4, from NODE manifest 
+                preset (8bits) : array geometry, from NODE manifest 
                 tag (8bits)  : unused
         */
         case STREAM_RESET: 
-        {   
-            uint8_t *pt8b;
-            uint8_t i;
-            uint8_t n;
-            arm_fixedbf_memory **memreq;
-            arm_fixedbf_instance *pinstance;
-            uint8_t preset;
-            uint16_t *pt16dst;
-
-            preset = (uint8_t) RD(command, PRESET_CMD);
-
-            /* read memory banks */
-            pinstance = *((arm_fixedbf_instance **) instance);           /* main instance */
-            memreq = (arm_fixedbf_memory **) instance;
-            memreq = &(memreq[1]);
-            pinstance->TCM = (*memreq);       /* second bank = fast memory */
-
-            // DYNAMIC ALLOCATION EXAMPLE, CAN DEPEND ON ARCS FORMAT
-            // if (STREAM_DYN_MALLOC == RD(command, COMMDEXT_CMD))
-            // {   memreq[0] = sizeof(arm_fixedbf_instance);    // memory allocation segment 0
-            //     memreq[1] = 2* sizeof(arm_fixedbf_memory);   // malloc of segment 1 for 2 biquads
-            // }
+        {   intptr_t *memresult = (intptr_t *)instance;
+            uint16_t preset = RD(command, PRESET_CMD);
+            uint8_t *pt8bdst;
+            uint32_t i, n;
+
+            arm_fixedbf_instance *pinstance = (arm_fixedbf_instance *) memresult[0];
 
             /* here reset */
-            pt8b = (uint8_t *) (pinstance->TCM->state);
-            n = sizeof(pinstance->TCM->state);
-            for (i = 0; i < n; i++) { pt8b[i] = 0; }
-
-            /* load presets */
-            pt16dst = (uint16_t *)(&(pinstance->TCM->coefs[0]));
-            switch (preset)
-            {   default: 
-                case 0:     /* by-pass*/
-                    break;
-                case 1:     /* LPF fc=fs/4 */
-                    break;
-                case 2:     /* HPF fc=fs/8 */
-                    break;
+            pt8bdst = (uint8_t *) pinstance;
+            n = sizeof(arm_fixedbf_instance);
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = 0;
             }
+            pinstance->TCM = (arm_fixedbf_memory *) memresult[1];
+            pinstance->nmics = (uint8_t)(RD(memresult[2 + NCHANDOMAIN_FMT1], NCHANM1_FMT1) + 1u);
+            pinstance->nbeams = (uint8_t)(RD(memresult[2 + STREAM_FORMAT_SIZE_W32 + NCHANDOMAIN_FMT1], NCHANM1_FMT1) + 1u);
 
-            pinstance->services = (stream_services *)data;
+            pinstance->config = fixedbf_preset[MIN(preset, NB_PRESET-1)];    /* preset data move */
+            arm_stream_fixedbf_init(pinstance);
             break;
         }       
 
@@ -125,54 +138,25 @@ void arm_stream_fixedbf (uint32_t command, void *instance, void *data, uint32_t
                 data = (one or all)
         */ 
         case STREAM_SET_PARAMETER:  
-        {   uint8_t *pt8bsrc;
-            uint8_t i; 
-            uint8_t cmsisFormat, rawFormat, numStages, postShift;
-            uint16_t *pt16src, *pt16dst;
-            arm_fixedbf_instance *pinstance;
-
-            pinstance = (arm_fixedbf_instance *) instance;
-            /* copy the parameters 
-                parameter_start
-                1  u8;  0                               ; CMSIS format
-                1  u8;  1                               ; q15 format
-                1  u8;  2                               ; numStages
-                1  s8;  1                               ; postShift
-                5 s16; 681   422   681 23853 -15161     ; INT16 elliptic band-pass 1450..1900/16kHz
-                5 s16; 681 -1342   681 26261 -15331     ; 
-                parameter_end                
-            */
-            pt8bsrc = (uint8_t *) data;
-            pt16src = (uint16_t *) data;
-
-            cmsisFormat = *pt8bsrc++;
-            rawFormat = *pt8bsrc++;
-            numStages = *pt8bsrc++;
-            postShift = *pt8bsrc++;
-
-            pt16src = &(pt16src[2]);    /* skip the above 4bytes header */
-            pt16dst = (uint16_t *)(&(pinstance->TCM->coefs[0]));
-
-            for (i = 0; i < numStages; i++)
-            {   /* destination format:  {b10, 0, b11, b12, a11, a12,   b20, 0, b21, b22, a21, a22, ...} */
-                *pt16dst++ = *pt16src++;    // b10
-                *pt16dst++ = 0;             // 0
-                *pt16dst++ = *pt16src++;    // b11    
-                *pt16dst++ = *pt16src++;    // b12
-                *pt16dst++ = *pt16src++;    // a11
-                *pt16dst++ = *pt16src++;    // a12
-            }
+        {   arm_fixedbf_instance *pinstance = (arm_fixedbf_instance *) instance;
 
-            /* optimized kernels INIT */
-            pinstance->iir_service = PACK_SERVICE(SERV_DSP_INIT,NOOPTION_SSRV,NOTAG_SSRV, SERV_DSP_CASCADE_DF1_Q15,SERV_GROUP_DSP_ML);
+            if (RD(command,NODE_TAG_CMD) < NB_PRESET)
+            {   pinstance->config = fixedbf_preset[RD(command,NODE_TAG_CMD)];
+            }
+            if (RD(command,NODE_TAG_CMD) == NODE_ALL_PARAM) 
+            {   uint8_t *pt8bsrc, *pt8bdst, i, n;
+
+                /* copy the steering table */
+                n = sizeof(fixedbf_parameters);   
+                pt8bsrc = (uint8_t *) data;     
+                pt8bdst = (uint8_t *) &(pinstance->config);
+                for (i = 0; i < n; i++)
+                {   pt8bdst[i] = pt8bsrc[i];
+                }
+            }
 
-            //pinstance->services(                                            // void arm_stream_services (      
-            //    pinstance->iir_service,                                     //      uint32_t command, 
-            //    (intptr_t)&(pinstance->TCM->biquad_cascade_df1_inst_q15),   //      intptr_t ptr1, 
-            //    (intptr_t)&(pinstance->TCM->coefs),                         //      intptr_t ptr2, 
-            //    (intptr_t)&(pinstance->TCM->state),                         //      intptr_t ptr3, 
-            //    (intptr_t)(numStages << 8u) | postShift                     //      intptr_t n)
-            //    );
+            /* cross-fade to the new steering, the history of the microphones is kept */
+            arm_stream_fixedbf_steer(pinstance);
             break;
         }
 
@@ -181,59 +165,41 @@ void arm_stream_fixedbf (uint32_t command, void *instance, void *data, uint32_t
                instance,  
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
+               the input arc has the interleaved microphones, the output arc the interleaved beams
         */         
         case STREAM_RUN:   
         {
-            arm_fixedbf_instance *pinstance;
-            intptr_t nb_data;
-            intptr_t stream_xdmbuffer_size_in, stream_xdmbuffer_size_out;
+            arm_fixedbf_instance *pinstance = (arm_fixedbf_instance *) instance;
+            intptr_t nb_data, stream_xdmbuffer_size;
+            int32_t bufferout_free;
             stream_xdmbuffer_t *pt_pt;
-            int16_t *inBuf;
-            int16_t *outBuf;
-
-            pinstance = (arm_fixedbf_instance *) instance;
+            int16_t *inBuf, *outBuf;
 
             pt_pt = data;   inBuf = (int16_t *)pt_pt->address;   
-                            stream_xdmbuffer_size_in = pt_pt->size;  /* data amount in the input buffer */
+                            stream_xdmbuffer_size = pt_pt->size;  /* data amount in the input buffer */
             pt_pt++;        outBuf = (int16_t *)(pt_pt->address); 
-                            stream_xdmbuffer_size_out = pt_pt->size;  /* data free in the input buffer */
-                            
-            if (stream_xdmbuffer_size_in > stream_xdmbuffer_size_out) {
-                nb_data = stream_xdmbuffer_size_out / sizeof(int16_t);
-            } else  {
-                nb_data = stream_xdmbuffer_size_in / sizeof(int16_t);
-            }
-
-            /* optimized kernels RUN */
-            pinstance->iir_service = PACK_SERVICE(SERV_DSP_RUN,NOOPTION_SSRV,NOTAG_SSRV,SERV_DSP_CASCADE_DF1_Q15,SERV_GROUP_DSP_ML);
+                            bufferout_free = (int32_t)(pt_pt->size);
 
-            //pinstance->services(
-            //    pinstance->iir_service,
-            //    (intptr_t)(&(pinstance->TCM->biquad_cascade_df1_inst_q15)),
-            //    (intptr_t)inBuf, 
-            //    (intptr_t)outBuf,
-            //    (intptr_t)nb_data
-            //    );
+            nb_data = arm_stream_fixedbf_process (pinstance, inBuf, (int32_t)stream_xdmbuffer_size, 
+                        outBuf, &bufferout_free);
 
-            pt_pt = data;   *(&(pt_pt->size)) = nb_data * sizeof(int16_t); /* amount of data consumed */
-            pt_pt ++;       *(&(pt_pt->size)) = nb_data * sizeof(int16_t); /* amount of data produced */
-            
+            pt_pt = data;
+            *(&(pt_pt->size)) = nb_data;            /* amount of data consumed */
+            pt_pt ++;
+            *(&(pt_pt->size)) = bufferout_free;     /* amount of data produced */
             break;
-
-
         }
 
         case STREAM_READ_PARAMETER:
         case STREAM_UPDATE_RELOCATABLE:
         default : break;
     }
-
 }
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // ifdef
\ No newline at end of file
+#else
+void arm_stream_fixedbf (uint32_t command, void *instance, void *data, uint32_t *status) { /* fake access */ if(command || instance || data || status) return;}
+#endif  // CODE_ARM_FIXEDBF
@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
- * Title:        arm_stream_fixedbf.c
- * Description:  filters
+ * Title:        arm_stream_fixedbf.h
+ * Description:  delay-and-sum beamformer with fractional delays
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -22,68 +22,87 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 
 #ifndef cARM_DSP_FIXEDBF_H
 #define cARM_DSP_FIXEDBF_H
 
 
-//#include "../../stream_const.h"      
-//#include "../../stream_types.h"  
-
+#include "stream_const.h"
+#include "stream_types.h"
 
-    /* with MVE assembly or coprocessor acceleration */
-    /* --------------------------------------------- */
-    typedef int16_t q15_t;
 
-    /**
-     * @brief Copy of the Instance structure for the Q15 Biquad cascade filter.
-     */
-    typedef struct
-    {
-            q15_t *pState;           /**< Points to the array of state coefficients.  The array is of length 4*numStages. */
-      const q15_t *pCoeffs;          /**< Points to the array of coefficients.  The array is of length 5*numStages. */
-            int8_t numStages;        /**< number of 2nd order stages in the filter.  Overall order is 2*numStages. */
-            int8_t postShift;        /**< Additional shift, in bits, applied to each output sample. */
-    } platform_arm_biquad_cascade_df1_inst_q15; 
-  
-/* ----------------------------- */
+/*
+    The input arc has the interleaved STREAM_S16 samples of the microphones, the output arc
+    has the interleaved beams. Each beam is the weighted sum of the microphones delayed by
+    delay[beam][mic] (samples in Q8, from 1.0 to FIXEDBF_MAX_DELAY + 255/256) :
 
-#define MAX_NB_BIQUAD_Q15 2
+        beam[n] = sum on the mics of gain[mic] x x_mic[n - delay]
 
-/* ----------------------------- */
-/*
-    format:  {b10, 0, b11, b12, a11, a12, b20, 0, b21, b22, a21, a22, ...}
-    y[n] = 2^postShift (b0 * x[n] + b1 * x[n-1] + b2 * x[n-2]) + a1 * y[n-1] + a2 * y[n-2]
-    a1 and a2 have the opposite sign given by Matlab
+    The fractional delays are 4-taps Lagrange interpolators on the samples n-I+1 .. n-I-2
+    (I = integer part of the delay), the gains (Q15) of a beam are normalized to a sum of 1.0
+    and combined with the interpolators in 4 coefficients Q14 per microphone.
+    A new steering table is applied with a cross-fade of FIXEDBF_RAMP samples between the
+    beams computed with the previous and the new coefficients.
 */
 
+#define FIXEDBF_MAX_MICS                8
+#define FIXEDBF_MAX_BEAMS               4
+#define FIXEDBF_TAPS                    4   /* Lagrange interpolators of order 3 */
+#define FIXEDBF_MAX_DELAY              32   /* integer part of the delays, in samples */
+#define FIXEDBF_HISTORY                (FIXEDBF_MAX_DELAY + FIXEDBF_TAPS - 2)
+#define FIXEDBF_CHUNK                 128   /* samples per microphone processed in 32bits */
+#define FIXEDBF_RAMP                  256   /* cross-fade of the steering changes, power of 2 */
+#define FIXEDBF_RAMP_SHIFT              8
+#define FIXEDBF_COEF_SHIFT             14
 
-typedef struct
-{   
-    //platform_arm_biquad_cascade_df1_inst_q15 biquad_cascade_df1_inst_q15;
+#define FIXEDBF_PRESET_LINEAR_2CM       0   /* 0, 30, 60, 90 degrees, linear array 2cm, 16kHz */
+#define FIXEDBF_PRESET_LINEAR_4CM       1   /* 0, 30, 60, 90 degrees, linear array 4.25cm, 16kHz */
 
-    q15_t coefs[MAX_NB_BIQUAD_Q15*6];
-    q15_t state[MAX_NB_BIQUAD_Q15*4];        
+typedef struct          /* 128 Bytes  */
+{
+    int16_t delay [FIXEDBF_MAX_BEAMS][FIXEDBF_MAX_MICS];  /* Q8 samples */
+    int16_t gain [FIXEDBF_MAX_BEAMS][FIXEDBF_MAX_MICS];   /* Q15 weights of the microphones */
+} fixedbf_parameters;
 
+
+typedef struct
+{
+    int16_t history [FIXEDBF_MAX_MICS][FIXEDBF_HISTORY + FIXEDBF_CHUNK];  /* deinterleaved microphones */
+    int16_t coef [2][FIXEDBF_MAX_BEAMS][FIXEDBF_MAX_MICS][FIXEDBF_TAPS];  /* current and next steering */
+    uint8_t delay [2][FIXEDBF_MAX_BEAMS][FIXEDBF_MAX_MICS];               /* integer part of the delays */
+    int32_t acc [2][FIXEDBF_CHUNK];
 } arm_fixedbf_memory;
 
 
 typedef struct
-{   uint32_t iir_service;
-    stream_services *services;
+{
+    fixedbf_parameters config;  /* 128 bytes, last steering table received */
+    uint8_t nmics;              /* interleaved channels of the input arc */
+    uint8_t nbeams;             /* interleaved channels of the output arc */
+    uint8_t bank;               /* coefficients in use */
+    uint8_t pending;            /* steering table received during a cross-fade */
+    uint16_t ramp;              /* samples of the cross-fade done, FIXEDBF_RAMP = no cross-fade */
     arm_fixedbf_memory *TCM;
 } arm_fixedbf_instance;
 
+
+extern void arm_stream_fixedbf_init (arm_fixedbf_instance *instance);
+extern void arm_stream_fixedbf_steer (arm_fixedbf_instance *instance);
+
+extern int32_t arm_stream_fixedbf_process (arm_fixedbf_instance *instance,
+                     int16_t *in, int32_t inputLength,
+                     int16_t *out, int32_t *outputLength);
+
 #endif
 
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
+
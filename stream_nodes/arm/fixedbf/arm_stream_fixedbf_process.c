@@ -0,0 +1,242 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        arm_stream_fixedbf_process.c
+ * Description:  delay-and-sum beamformer with fractional delays
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "presets.h"
+#ifdef CODE_ARM_FIXEDBF
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_fixedbf.h"
+
+
+/*
+    The microphones are deinterleaved in lines of FIXEDBF_CHUNK samples preceded by the last
+    FIXEDBF_HISTORY samples of the previous chunk : the sample n delayed by D is at the index
+    FIXEDBF_HISTORY + n - D. A beam is accumulated one tap of one microphone at a time : the
+    inner loop is a multiply-accumulate of 16bits samples in 32bits accumulators on contiguous
+    samples, vectorized by the compiler. The integer delays have a single non-zero tap, the
+    zero coefficients are skipped.
+*/
+
+#define FIXEDBF_CLAMP_S16(x) (int16_t)MIN(32767, MAX(-32768, (x)))
+
+
+/*
+    acc[0..n-1] (+)= c x src[0..n-1]
+*/
+static void fixedbf_mac (int32_t *acc, const int16_t *src, int32_t c, uint32_t n, uint8_t first)
+{
+    uint32_t i;
+
+    if (first)
+    {   for (i = 0; i < n; i++) { acc[i] = c * src[i]; }
+    }
+    else if (c != 0)
+    {   for (i = 0; i < n; i++) { acc[i] += c * src[i]; }
+    }
+}
+
+
+/*
+    4-taps Lagrange interpolator (Q14) of the delay I + t/256, on the samples delayed by I-1 .. I+2
+*/
+static void fixedbf_lagrange (int32_t t, int32_t *h)
+{
+    int64_t a = t + 256, b = t, c = t - 256, d = t - 512;
+
+    h[0] = (int32_t)((-b * c * d + 3072) / 6144);
+    h[1] = (int32_t)(( a * c * d + 1024) / 2048);
+    h[2] = (int32_t)((-a * b * d + 1024) / 2048);
+    h[3] = (int32_t)(( a * b * c + 3072) / 6144);
+}
+
+
+/*
+    coefficients of the steering table in the bank "bank"
+*/
+static void fixedbf_coefficients (arm_fixedbf_instance *pinstance, uint8_t bank)
+{
+    fixedbf_parameters *config = &(pinstance->config);
+    arm_fixedbf_memory *TCM = pinstance->TCM;
+    int32_t h[FIXEDBF_TAPS], delay, gain, sum;
+    uint32_t b, m, k;
+
+    for (b = 0; b < FIXEDBF_MAX_BEAMS; b++)
+    {   sum = 0;
+        for (m = 0; m < pinstance->nmics; m++)
+        {   sum += ABS(config->gain[b][m]);
+        }
+        for (m = 0; m < FIXEDBF_MAX_MICS; m++)
+        {   delay = MAX(256, MIN(FIXEDBF_MAX_DELAY * 256 + 255, config->delay[b][m]));
+            fixedbf_lagrange (delay & 255, h);
+            TCM->delay[bank][b][m] = (uint8_t)(delay >> 8);
+
+            /* gain normalized to a sum of 1.0 (Q15) */
+            gain = (sum == 0 || m >= pinstance->nmics) ? 0 : (int32_t)(((int64_t)config->gain[b][m] << 15) / sum);
+            for (k = 0; k < FIXEDBF_TAPS; k++)
+            {   TCM->coef[bank][b][m][k] = (int16_t)((h[k] * gain + (1 << 14)) >> 15);
+            }
+        }
+    }
+}
+
+
+/*
+    one beam on the chunk of m samples
+*/
+static void fixedbf_beam (arm_fixedbf_instance *pinstance, int32_t *acc, uint8_t bank, uint32_t b, uint32_t m)
+{
+    arm_fixedbf_memory *TCM = pinstance->TCM;
+    uint32_t mic, k;
+    int16_t *src;
+
+    for (mic = 0; mic < pinstance->nmics; mic++)
+    {   src = &(TCM->history[mic][FIXEDBF_HISTORY + 1 - TCM->delay[bank][b][mic]]);
+        for (k = 0; k < FIXEDBF_TAPS; k++)
+        {   fixedbf_mac (acc, src - k, TCM->coef[bank][b][mic][k], m, (uint8_t)(mic == 0 && k == 0));
+        }
+    }
+}
+
+
+/*
+    initialization of the history and of the coefficients, after a reset
+*/
+void arm_stream_fixedbf_init (arm_fixedbf_instance *pinstance)
+{
+    int16_t *pt = &(pinstance->TCM->history[0][0]);
+    uint32_t i, n = sizeof(pinstance->TCM->history) / sizeof(int16_t);
+
+    for (i = 0; i < n; i++)
+    {   pt[i] = 0;
+    }
+    pinstance->nmics = (uint8_t)MAX(1, MIN(FIXEDBF_MAX_MICS, pinstance->nmics));
+    pinstance->nbeams = (uint8_t)MAX(1, MIN(FIXEDBF_MAX_BEAMS, pinstance->nbeams));
+    pinstance->bank = 0;
+    pinstance->pending = 0;
+    pinstance->ramp = FIXEDBF_RAMP;
+    fixedbf_coefficients (pinstance, 0);
+}
+
+
+/*
+    new steering table : cross-fade to the new coefficients, or after the cross-fade in progress
+*/
+void arm_stream_fixedbf_steer (arm_fixedbf_instance *pinstance)
+{
+    if (pinstance->ramp < FIXEDBF_RAMP)
+    {   pinstance->pending = 1;
+    }
+    else
+    {   fixedbf_coefficients (pinstance, (uint8_t)(1u - pinstance->bank));
+        pinstance->ramp = 0;
+    }
+}
+
+
+/**
+  @brief         Processing function
+  @param[in]     instance     points to an instance of the beamformer
+  @param[in]     in           interleaved microphones
+  @param[in]     inputLength  bytes in the input arc
+  @param[out]    out          interleaved beams
+  @param[in/out] outputLength free bytes in the output arc / bytes produced
+  @return        number of bytes consumed
+ */
+int32_t arm_stream_fixedbf_process (arm_fixedbf_instance *pinstance,
+                     int16_t *in, int32_t inputLength,
+                     int16_t *out, int32_t *outputLength)
+{
+    arm_fixedbf_memory *TCM = pinstance->TCM;
+    uint32_t M = pinstance->nmics, B = pinstance->nbeams;
+    int32_t *acc = TCM->acc[0], *acc2 = TCM->acc[1];
+    int32_t y, y2, rnd = 1 << (FIXEDBF_COEF_SHIFT - 1);
+    uint32_t frames, n0, m, i, b, mic, a;
+
+    frames = MIN((uint32_t)inputLength / (M * sizeof(int16_t)), (uint32_t)(*outputLength) / (B * sizeof(int16_t)));
+
+    for (n0 = 0; n0 < frames; n0 += m)
+    {   m = MIN(frames - n0, FIXEDBF_CHUNK);
+
+        for (mic = 0; mic < M; mic++)
+        {   for (i = 0; i < m; i++)
+            {   TCM->history[mic][FIXEDBF_HISTORY + i] = in[(n0 + i) * M + mic];
+            }
+        }
+
+        for (b = 0; b < B; b++)
+        {   fixedbf_beam (pinstance, acc, pinstance->bank, b, m);
+            if (pinstance->ramp < FIXEDBF_RAMP)
+            {   /* cross-fade from the previous steering */
+                fixedbf_beam (pinstance, acc2, (uint8_t)(1u - pinstance->bank), b, m);
+                for (i = 0; i < m; i++)
+                {   a = MIN(FIXEDBF_RAMP, pinstance->ramp + i);
+                    y = FIXEDBF_CLAMP_S16((acc[i] + rnd) >> FIXEDBF_COEF_SHIFT);
+                    y2 = FIXEDBF_CLAMP_S16((acc2[i] + rnd) >> FIXEDBF_COEF_SHIFT);
+                    out[(n0 + i) * B + b] = (int16_t)(y + (((y2 - y) * (int32_t)a) >> FIXEDBF_RAMP_SHIFT));
+                }
+            }
+            else
+            {   for (i = 0; i < m; i++)
+                {   out[(n0 + i) * B + b] = FIXEDBF_CLAMP_S16((acc[i] + rnd) >> FIXEDBF_COEF_SHIFT);
+                }
+            }
+        }
+
+        if (pinstance->ramp < FIXEDBF_RAMP)
+        {   pinstance->ramp = (uint16_t)MIN(FIXEDBF_RAMP, pinstance->ramp + m);
+            if (pinstance->ramp == FIXEDBF_RAMP)
+            {   pinstance->bank = (uint8_t)(1u - pinstance->bank);
+                if (pinstance->pending)
+                {   pinstance->pending = 0;
+                    arm_stream_fixedbf_steer (pinstance);
+                }
+            }
+        }
+
+        /* the last samples become the history of the next chunk */
+        for (mic = 0; mic < M; mic++)
+        {   for (i = 0; i < FIXEDBF_HISTORY; i++)
+            {   TCM->history[mic][i] = TCM->history[mic][m + i];
+            }
+        }
+    }
+
+    *outputLength = (int32_t)(frames * B * sizeof(int16_t));
+    return (int32_t)(frames * M * sizeof(int16_t));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CODE_ARM_FIXEDBF
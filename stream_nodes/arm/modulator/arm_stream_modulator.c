@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
  * Title:        arm_stream_modulator.c
- * Description:  wave synthesis
+ * Description:  NCO, tone generator, AM FM and I/Q modulator
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -26,6 +26,10 @@
  */
 
 #include "presets.h"
+
+extern void arm_stream_modulator (unsigned int command, void *instance, void *data, unsigned int *status);
+
+
 #ifdef CODE_ARM_STREAM_MODULATOR
 
 #ifdef __cplusplus
@@ -39,57 +43,68 @@
 #include "stream_common_types.h"
 #include "arm_stream_modulator.h"
 
-const int16_t sinewave_pattern[PATTERN_SIZE] = 
-{
-   3212,   6393,   9512,  12539,  15446,  18204,  20787,  23170,
-  25329,  27245,  28898,  30273,  31356,  32137,  32609,  32767,
-  32609,  32137,  31356,  30273,  28898,  27245,  25329,  23170,
-  20787,  18204,  15446,  12539,   9512,   6393,   3212,      0,
-  -3212,  -6393,  -9512, -12539, -15446, -18204, -20787, -23170,
- -25329, -27245, -28898, -30273, -31356, -32137, -32609, -32767,
- -32609, -32137, -31356, -30273, -28898, -27245, -25329, -23170,
- -20787, -18204, -15446, -12539,  -9512,  -6393,  -3212,      0,
-};
 
 //;----------------------------------------------------------------------------------------
-//;11.	arm_signal_modulator
+//;11.	arm_stream_modulator
 //;----------------------------------------------------------------------------------------
-//;    Operation : sine, noise, square, saw tooth with amplitude or frequency modulation
-//;    use-case : ring modulator, sweep generation with a cascade of a ramp generator and
-//;       a frequency modulator
+//;    Operation : NCO with a 32-bit phase accumulator and a quarter-wave sine table with
+//;       linear interpolation. Sum of up to 4 tones (test signals), amplitude, frequency
+//;       and I/Q modulation of the input arc on the carrier (tone 0).
+//;       The input and output arcs have the same format : STREAM_S16, STREAM_S32, STREAM_FP32.
+//;       The output is mono, the input is mono (AM, FM) or I/Q interleaved, it is not used
+//;       in the tone generator mode.
+//;       The mode 4 plays a VGM command stream with an emulated SN76489 (3 tones, noise),
+//;       the stream is read from the third arc (parameter arc, not modified by the node) and
+//;       restarts on each SET_PARAMETER, the output is silent at the end of the stream.
+//;    use-case : factory test signals, FSK and sweeps with the FM of a ramp, up-conversion,
+//;       tunes and alerts on small devices
+//;
+//;   Parameters (frequencies are phase increments f/FS x 2^32) :
+//;u32 x4 phase increments of the tones, tone 0 is the carrier
+//;s16 x4 amplitudes of the tones, Q15
+//;u32    FM deviation : phase increment added for a full-scale input (max FS/4)
+//;s16    AM modulation index, Q15
+//;u8     mode : 0 tones, 1 AM, 2 FM, 3 I/Q, 4 VGM
+//;u8     number of tones of the mode 0
+//;u32    sampling rate of the output arc [Hz], used by the VGM player
 //;
-//;   Parameters types and Tags:
-//;u8  #1 wave type : 1=sine 2=square 3=white noise 4=pink noise 
-//;               5=sawtooth 6=triangle 7=pulse
-//;               8=prerecorded pattern playback from arc 
-//;               9=sigma-delta with OSR control for audio on PWM ports and 8b DAC
-//;               10=PWM 11=ramp 12=step
-//;u16 #2 linear amplitude, format UQ16 0dB .. -96dB
-//;u16 #3 amplitude offset, format Q15 [-1 .. +1]
-//;f32 #4 wave frequency [Hz], 0Hz translates to DC level.
-//;s16 #5 starting phase, format Q15 [-pi .. +pi]/pi
-//;u8  #6 modulation type, 0:amplitude, 1:frequency (reserved 2:FSK, ..)
-//;u8  #7 modulation, 0:none 1=from arc bit stream, 2=from arc q15 words
-//;u16 #8 modulation index (a) and offset (b), in q15 as fraction of frequency or amplitude
-//;       modulation y=ax+b, x=input data.
-//;f32 #9 modulation frequency [Hz] separating two data bits/samples from the arc
+//;   Tags of the SET_PARAMETER command :
+//;   1 : phase increments (4 x u32), 2 : amplitudes (4 x s16), 3 : FM deviation (u32)
+//;
+//;   presets control
+//;   #0 : 1kHz -6dB at 48kHz
+//;   #1 : SMPTE IMD test signal, 60Hz + 7kHz 4:1 at 48kHz
+//;   #2 : FM, carrier 10kHz -6dB, deviation 2.5kHz at 48kHz
+//;   #3 : AM, carrier 10kHz -6dB, modulation index 0.8 at 48kHz
+//;   #4 : I/Q up-conversion on a carrier at 12kHz (FS/4) at 48kHz
+//;   #5 : VGM player at 48kHz
 //
-//arm_signal_modulator 
+//arm_stream_modulator
 //    3  i8; 0 0 0        instance, preset, tag
 //    PARSTART
-//    1  u8;  1       sinewave
-//    2 h16;  FFFF 0  full-scale, no offset
-//    1 f32;  1200    1200Hz
-//    1 u16;  0       initial phase
-//    2  u8;  1 1     frequency modulation from bit-stream
-//    2 h16;  8000 0  full amplitude modulation with sign inversion of the bit-stream
-//    1 f32;  300     300Hz modulation => (900Hz .. 1500Hz modulation)
+//    4 u32; 89478485 0 0 0           1kHz at 48kHz
+//    4 i16; 16384 0 0 0              -6dB
+//    1 u32; 0                        no FM
+//    1 i16; 0                        no AM
+//    2  u8; 0 1                      one tone
+//    1 u32; 48000
 //    PARSTOP
 //;
 
+#define NB_PRESET 6
+const modulator_parameters modulator_preset [NB_PRESET] =
+{   /* increments, amplitudes, fm_deviation, am_index, mode, nb_tones, sampling_rate */
+    {{  89478485,         0, 0, 0}, {16384,    0, 0, 0},         0,     0, MODULATOR_MODE_TONES, 1, 48000},  /* #0 */
+    {{   5368709, 626349397, 0, 0}, {26214, 6554, 0, 0},         0,     0, MODULATOR_MODE_TONES, 2, 48000},  /* #1 */
+    {{ 894784853,         0, 0, 0}, {16384,    0, 0, 0}, 223696213,     0, MODULATOR_MODE_FM,    1, 48000},  /* #2 */
+    {{ 894784853,         0, 0, 0}, {16384,    0, 0, 0},         0, 26214, MODULATOR_MODE_AM,    1, 48000},  /* #3 */
+    {{1073741824,         0, 0, 0}, {32767,    0, 0, 0},         0,     0, MODULATOR_MODE_IQ,    1, 48000},  /* #4 */
+    {{         0,         0, 0, 0}, {    0,    0, 0, 0},         0,     0, MODULATOR_MODE_VGM,   1, 48000},  /* #5 */
+};
+
 
 /**
-  @brief         
+  @brief
   @param[in]     command    bit-field
   @param[in]     pinst      instance of the component
   @param[in/out] pdata      address and size of buffers
@@ -101,83 +116,107 @@ void arm_stream_modulator (unsigned int command, void *instance, void *data, uns
     *status = NODE_TASKS_COMPLETED;    /* default return status, unless processing is not finished */
 
     switch (RD(command,COMMAND_CMD))
-    { 
+    {
         /* func(command = (STREAM_RESET, COLD, PRESET, TRACEID tag, NB ARCS IN/OUT)
-                instance = *memory_results,  
+                instance = *memory_results,
                 data = address of Stream function
-                
-                memresults are followed by 2 words of STREAM_FORMAT_SIZE_W32 of all the arcs 
+
+                memresults are followed by 2 words of STREAM_FORMAT_SIZE_W32 of all the arcs
                 memory pointers are in the same order as described in the NODE manifest
+
+                memresult[0] : instance of the component
+                memresult[1] : input arc Word 0 SIZSFTRAW_FMT0 (frame size..)
+                memresult[2] : input arc Word 1 SAMPINGNCHANM1_FMT1
         */
-        case STREAM_RESET: 
-        {   stream_services *stream_entry = (stream_services *)data;
-            intptr_t *memresults = (intptr_t *)instance;
+        case STREAM_RESET:
+        {   intptr_t *memresult = (intptr_t *)instance;
             uint16_t preset = RD(command, PRESET_CMD);
+            uint8_t *pt8bdst;
+            uint32_t i, n;
+
+            arm_stream_modulator_instance *pinstance = (arm_stream_modulator_instance *) memresult[0];
 
-            arm_stream_modulator_instance *pinstance = (arm_stream_modulator_instance *)  *memresults;
-            memresults++;
-            /* here reset */
+            /* here reset, the phases start at 0 */
+            pt8bdst = (uint8_t *) pinstance;
+            n = sizeof(arm_stream_modulator_instance);
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = 0;
+            }
+            pinstance->raw = (uint8_t)(RD(memresult[2], RAW_FMT1));
 
+            pinstance->config = modulator_preset[MIN(preset, NB_PRESET-1)];    /* preset data move */
+            arm_stream_modulator_init(pinstance);
             break;
-        }    
+        }
 
         /* func(command = bitfield (STREAM_SET_PARAMETER, PRESET, TAG, NB ARCS IN/OUT)
                     TAG of a parameter to set, NODE_ALL_PARAM means "set all the parameters" in a raw
-                *instance, 
+                *instance,
                 data = (one or all)
-        */ 
-        case STREAM_SET_PARAMETER:  
-        {   
-            uint8_t *new_parameters = (uint8_t *)data;
-            break;
-        }
-
-
-
-        /* func(command = STREAM_READ_PARAMETER, PRESET, TAG, NB ARCS IN/OUT)
-                    TAG/index of a parameter to read (Metadata, Needle), 0xFF means "read all the parameters"
-                *instance, 
-                data = *parameter(s) to read
-        */ 
-        case STREAM_READ_PARAMETER:  
-        {   
-            uint8_t *new_parameters = (uint8_t *)data;
-
+        */
+        case STREAM_SET_PARAMETER:
+        {   arm_stream_modulator_instance *pinstance = (arm_stream_modulator_instance *) instance;
+            uint8_t *pt8bsrc, *pt8bdst;
+            uint8_t i, n;
+
+            pt8bsrc = (uint8_t *) data;
+            pt8bdst = (uint8_t *) &(pinstance->config);
+
+            switch (RD(command,NODE_TAG_CMD))
+            {   default : n = 0; break;
+                case MODULATOR_TAG_INCREMENT:    pt8bdst = (uint8_t *) &(pinstance->config.increment[0]); n = sizeof(pinstance->config.increment); break;
+                case MODULATOR_TAG_AMPLITUDE:    pt8bdst = (uint8_t *) &(pinstance->config.amplitude[0]); n = sizeof(pinstance->config.amplitude); break;
+                case MODULATOR_TAG_FM_DEVIATION: pt8bdst = (uint8_t *) &(pinstance->config.fm_deviation); n = 4; break;
+                case NODE_ALL_PARAM:             n = sizeof(modulator_parameters); break;
+            }
+
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = pt8bsrc[i];
+            }
+
+            /* the phases are kept : continuous phase changes of frequency */
+            arm_stream_modulator_init(pinstance);
             break;
         }
-        
 
 
         /* func(command = STREAM_RUN, PRESET, TAG, NB ARCS IN/OUT)
-               instance,  
+               instance,
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
-        */         
-        case STREAM_RUN:   
+               the output buffer is filled in the tone generator and VGM modes, the input
+               samples are consumed without being used. The third arc is the VGM stream, it is 
+               never consumed : the player reads it with absolute offsets (loop offset).
+        */
+        case STREAM_RUN:
         {
             arm_stream_modulator_instance *pinstance = (arm_stream_modulator_instance *) instance;
-            intptr_t nb_data, stream_xdmbuffer_size, bufferout_free;
+            intptr_t stream_xdmbuffer_size, bufferout_free;
+            int32_t nb_in, nb_out;
             stream_xdmbuffer_t *pt_pt;
-            #define SAMP_IN uint8_t 
-            #define SAMP_OUT int16_t
-            SAMP_IN *inBuf;
-            SAMP_OUT *outBuf;
+            uint8_t *inBuf, *outBuf;
+            uint32_t bytes = (pinstance->raw == STREAM_S16) ? 2 : 4;
 
             pt_pt = data;
-            inBuf  = (SAMP_IN *)pt_pt->address;   
+            inBuf  = (uint8_t *)pt_pt->address;
             stream_xdmbuffer_size    = pt_pt->size;
             pt_pt++;
-            outBuf = (SAMP_OUT *)(pt_pt->address); 
+            outBuf = (uint8_t *)(pt_pt->address);
             bufferout_free        = pt_pt->size;
+            if (RD(command, NARC_CMD) > 2)
+            {   pt_pt++;
+                pinstance->vgm.data = (const uint8_t *)(pt_pt->address);
+                pinstance->vgm.size = (uint32_t)(pt_pt->size);
+            }
 
-            nb_data = stream_xdmbuffer_size / sizeof(SAMP_IN);
-
-            arm_stream_modulator_process(pinstance, inBuf, outBuf, &nb_data);
+            nb_out = (int32_t)(bufferout_free / bytes);
+            nb_in = arm_stream_modulator_process(pinstance, inBuf, (int32_t)(stream_xdmbuffer_size / bytes), outBuf, &nb_out);
 
-            pt_pt = data;   *(&(pt_pt->size)) = nb_data * sizeof(SAMP_IN);     /* amount of data consumed */
-            pt_pt ++;       *(&(pt_pt->size)) = nb_data * sizeof(SAMP_OUT);    /* amount of data produced */
+            pt_pt = data;   *(&(pt_pt->size)) = nb_in * bytes;      /* amount of data consumed */
+            pt_pt ++;       *(&(pt_pt->size)) = nb_out * bytes;     /* amount of data produced */
+            if (RD(command, NARC_CMD) > 2)
+            {   pt_pt ++;   *(&(pt_pt->size)) = 0;                  /* the VGM stream stays in its arc */
+            }
 
             break;
         }
@@ -185,11 +224,12 @@ void arm_stream_modulator (unsigned int command, void *instance, void *data, uns
 
 
         /* func(command = STREAM_STOP, PRESET, TAG, NB ARCS IN/OUT)
-               instance,  
+               instance,
                data = unused
            used to free memory allocated with the C standard library
-        */  
-        case STREAM_STOP:  break;    
+        */
+        case STREAM_STOP:  break;
+        default : break;
     }
 }
 
@@ -198,9 +238,5 @@ void arm_stream_modulator (unsigned int command, void *instance, void *data, uns
 #endif
 
 #else
-extern void arm_stream_modulator (unsigned int command, void *instance, void *data, unsigned int *status);
- void arm_stream_modulator (unsigned int command, void *instance, void *data, unsigned int *status)
-{
-}
+void arm_stream_modulator (unsigned int command, void *instance, void *data, unsigned int *status) { /* fake access */ if(command || instance || data || status) return;}
 #endif  // #ifndef CODE_ARM_STREAM_MODULATOR
-    
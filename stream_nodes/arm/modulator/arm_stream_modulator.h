@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
  * Title:        arm_stream_modulator.h
- * Description:  filters
+ * Description:  NCO, tone generator, AM FM and I/Q modulator
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -22,50 +22,130 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 
 #ifndef cARM_STREAM_MODULATOR_H
 #define cARM_STREAM_MODULATOR_H
 
 
-#include "stream_const.h"      
-#include "stream_types.h"  
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+
+
+/*
+    NCO (arm_stream_nco.h) : 32-bit phase accumulator, the phase increment of a frequency f is
+    f / FS x 2^32, sine from a quarter-wave table with a linear interpolation (SFDR > 100dB).
+
+    The output arc is mono, STREAM_S16, STREAM_S32 or STREAM_FP32, the input arc has the
+    same format :
+        MODULATOR_MODE_TONES : sum of nb_tones sines, the input arc is consumed and not used
+        MODULATOR_MODE_AM    : carrier (tone 0) x (1 + am_index x input)
+        MODULATOR_MODE_FM    : carrier (tone 0) with the phase increment + fm_deviation x input
+        MODULATOR_MODE_IQ    : input I/Q (2 interleaved channels) translated on the carrier,
+                               y = I cos - Q sin
+        MODULATOR_MODE_VGM   : VGM command stream played with an emulated SN76489, the input
+                               arc is consumed and not used
+    A change of the parameters keeps the phase of the tones (continuous phase FSK and sweeps).
+*/
+
+#define MODULATOR_MODE_TONES            0
+#define MODULATOR_MODE_AM               1
+#define MODULATOR_MODE_FM               2
+#define MODULATOR_MODE_IQ               3
+#define MODULATOR_MODE_VGM              4
+
+#define MODULATOR_TAG_INCREMENT         1   /* SET_PARAMETER : uint32 increment[MODULATOR_NB_TONES] */
+#define MODULATOR_TAG_AMPLITUDE         2   /* SET_PARAMETER : int16 amplitude[MODULATOR_NB_TONES] */
+#define MODULATOR_TAG_FM_DEVIATION      3   /* SET_PARAMETER : uint32 fm_deviation */
+
+#define MODULATOR_PRESET_1KHZ           0   /* 1kHz -6dB at 48kHz */
+#define MODULATOR_PRESET_SMPTE_IMD      1   /* 60Hz + 7kHz 4:1 at 48kHz */
+#define MODULATOR_PRESET_FM             2   /* carrier 10kHz, deviation 2.5kHz at 48kHz */
+#define MODULATOR_PRESET_AM             3   /* carrier 10kHz, modulation index 0.8 at 48kHz */
+#define MODULATOR_PRESET_IQ             4   /* I/Q on a carrier of 12kHz at 48kHz */
+#define MODULATOR_PRESET_VGM            5   /* VGM player at 48kHz */
 
-#define PATTERN_SIZE 64
+#define MODULATOR_NB_TONES              4
+#define MODULATOR_INCREMENT(f, fs)      ((uint32_t)(((double)(f) / (double)(fs)) * 4294967296.0))
+
+typedef struct          /* 36 Bytes  */
+{
+    uint32_t increment [MODULATOR_NB_TONES];    /* phase increments, tone 0 is the carrier */
+    int16_t amplitude [MODULATOR_NB_TONES];     /* Q15 */
+    uint32_t fm_deviation;      /* phase increment of a full-scale input */
+    int16_t am_index;           /* Q15 */
+    uint8_t mode;               /* MODULATOR_MODE_ */
+    uint8_t nb_tones;           /* MODULATOR_MODE_TONES : 1 .. MODULATOR_NB_TONES */
+    uint32_t sampling_rate;     /* MODULATOR_MODE_VGM : FS of the output arc [Hz] */
+} modulator_parameters;
+
+
+/*
+    SN76489 : three square wave tone generators and a noise generator (LFSR), attenuation of
+    2dB steps. The chip counters run at clock/16, they are decremented by "step" on each output
+    sample (Q12 chip ticks). A tone transition inside a sample is weighted by its position in
+    the sample (box filter), the tones above FS/2 give a constant level like the chip does with
+    the period 1 used for the playback of samples.
+
+    VGM stream : the commands 0x50 (PSG write), 0x61 0x62 0x63 0x7n (waits in 1/44100s) and 0x66
+    (end, or jump to the loop offset) are used, the other commands and the data blocks are
+    skipped. The header "Vgm " gives the clock, the loop offset and the LFSR, a stream without
+    header is played at 3579545Hz from its first byte.
+*/
+
+#define VGM_NB_CHANNELS             4
+#define VGM_Q                      12       /* fractional bits of the counters and of the waits */
+#define VGM_DEFAULT_CLOCK     3579545
+#define VGM_WAIT_RATE           44100
 
 typedef struct
 {
-   float_t f0;          //;f32 wave frequency [Hz], 0Hz translates to DC level.
-                        //;f32 modulation frequency [Hz] separating two data bits/samples from the arc
-                        //;u16 wave type : 1=sine 2=square 3=white noise 4=pink noise 
-                        //;            5=sawtooth 6=triangle 7=pulse
-                        //;            8=prerecorded pattern playback from arc 
-                        //;            9=sigma-delta with OSR control for audio on PWM ports and 8b DAC
-                        //;            10=PWM 11=ramp 12=step
-                        //;u16 modulation index (a) and offset (b), in q15 as fraction of frequency or amplitude
-                        //;    modulation y=ax+b, x=input data.
-                        //;u16 linear amplitude, format UQ16 0dB .. -96dB
-                        //;u16 amplitude offset, format Q15 [-1 .. +1]
-                        //;s16 starting phase, format Q15 [-pi .. +pi]/pi
-                        //;u16 modulation type, 0:amplitude, 1:frequency (reserved 2:FSK, ..)
-                        //;u16 modulation, 0:none 1=from arc bit stream, 2=from arc q15 words
-} stream_modulator_parameters;
+    const uint8_t *data;        /* command stream (parameter arc) */
+    uint32_t size;
+    uint32_t position;          /* offsets in the command stream */
+    uint32_t loop;              /* 0 : no loop */
+    int32_t wait;               /* output samples before the next command, Q12 */
+    int32_t wait_ratio;         /* FS/44100, Q12 */
+    int32_t step;               /* chip ticks per output sample, Q12 */
+    int32_t inv_step;           /* 2^31 / step */
+    uint32_t sampling_rate;
+    int32_t counter [VGM_NB_CHANNELS];  /* Q12 chip ticks before the next transition */
+    uint16_t period [VGM_NB_CHANNELS - 1];  /* tone registers (10 bits) */
+    uint16_t lfsr;
+    uint16_t feedback;          /* taps of the white noise */
+    uint8_t width;              /* LFSR length */
+    uint8_t flags;              /* VGM header 0x2B */
+    uint8_t attenuation [VGM_NB_CHANNELS];
+    uint8_t noise;              /* noise control register */
+    uint8_t latch;              /* latched register : channel x 2 + volume */
+    uint8_t polarity;           /* bit c : output of the channel c is high */
+    uint8_t state;              /* 0 : header not read, 1 : playing, 2 : end */
+} modulator_vgm;
+
 
 typedef struct
 {
-    stream_services *stream_entry;
-    stream_modulator_parameters param;
+    modulator_parameters config;        /* 36 bytes */
+    uint32_t phase [MODULATOR_NB_TONES];
+    uint8_t raw;                /* STREAM_S16, STREAM_S32, STREAM_FP32 */
+    uint8_t pad___[3];
+    modulator_vgm vgm;
 } arm_stream_modulator_instance;
 
 
+extern void arm_stream_modulator_init (arm_stream_modulator_instance *instance);
+extern void arm_stream_modulator_vgm_init (modulator_vgm *vgm, uint32_t sampling_rate);
+extern void arm_stream_modulator_vgm (modulator_vgm *vgm, int16_t *y, uint32_t n);
 
-extern void arm_stream_modulator_process (arm_stream_modulator_instance *instance, void *input, void *output, intptr_t *nsamp);
+extern int32_t arm_stream_modulator_process (arm_stream_modulator_instance *instance,
+                     uint8_t *in, int32_t nbSamplesIn, uint8_t *out, int32_t *nbSamplesOut);
 
 
 #endif
@@ -73,4 +153,3 @@ extern void arm_stream_modulator_process (arm_stream_modulator_instance *instanc
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
  * Title:        arm_stream_modulator_process.c
- * Description:  filters
+ * Description:  NCO, tone generator, AM FM and I/Q modulator
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -25,33 +25,345 @@
  * 
  */
 
+
 #include "presets.h"
 #ifdef CODE_ARM_STREAM_MODULATOR
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 #include <stdint.h>
 #include "stream_common_const.h"
 #include "stream_common_types.h"
 #include "arm_stream_modulator.h"
+#include "arm_stream_nco.h"
+
+
+#define MODULATOR_MAX_DEVIATION     (1UL << 30)     /* FS/4 */
+
+#define SAT16(v) ((int16_t)MIN(32767, MAX(-32768, (v))))
+#define SAT32(v) ((int32_t)MIN(0x7FFFFFFFL, MAX(-0x7FFFFFFFL - 1, (v))))
+
+
+/*
+    sum of tones
+*/
+static void modulator_tones_s16 (arm_stream_modulator_instance *pinstance, int16_t *y, uint32_t n)
+{
+    uint32_t ph [MODULATOR_NB_TONES], i, k, K = pinstance->config.nb_tones;
+    int32_t acc;
+
+    for (k = 0; k < K; k++)
+    {   ph[k] = pinstance->phase[k];
+    }
+    for (i = 0; i < n; i++)
+    {   for (k = 0, acc = 0; k < K; k++)
+        {   acc += ((arm_stream_nco_sine(ph[k]) >> 16) * pinstance->config.amplitude[k]) >> 15;
+            ph[k] += pinstance->config.increment[k];
+        }
+        y[i] = SAT16(acc);
+    }
+    for (k = 0; k < K; k++)
+    {   pinstance->phase[k] = ph[k];
+    }
+}
+
+static void modulator_tones_s32 (arm_stream_modulator_instance *pinstance, int32_t *y, uint32_t n)
+{
+    uint32_t ph [MODULATOR_NB_TONES], i, k, K = pinstance->config.nb_tones;
+    int64_t acc;
+
+    for (k = 0; k < K; k++)
+    {   ph[k] = pinstance->phase[k];
+    }
+    for (i = 0; i < n; i++)
+    {   for (k = 0, acc = 0; k < K; k++)
+        {   acc += ((int64_t)arm_stream_nco_sine(ph[k]) * pinstance->config.amplitude[k]) >> 15;
+            ph[k] += pinstance->config.increment[k];
+        }
+        y[i] = SAT32(acc);
+    }
+    for (k = 0; k < K; k++)
+    {   pinstance->phase[k] = ph[k];
+    }
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static void modulator_tones_f32 (arm_stream_modulator_instance *pinstance, float *y, uint32_t n)
+{
+    uint32_t ph [MODULATOR_NB_TONES], i, k, K = pinstance->config.nb_tones;
+    float a [MODULATOR_NB_TONES], acc;
+
+    for (k = 0; k < K; k++)
+    {   ph[k] = pinstance->phase[k];
+        a[k] = (float)(pinstance->config.amplitude[k]) * (1.0f / 70368744177664.0f);    /* 2^-46 */
+    }
+    for (i = 0; i < n; i++)
+    {   for (k = 0, acc = 0.0f; k < K; k++)
+        {   acc += (float)arm_stream_nco_sine(ph[k]) * a[k];
+            ph[k] += pinstance->config.increment[k];
+        }
+        y[i] = acc;
+    }
+    for (k = 0; k < K; k++)
+    {   pinstance->phase[k] = ph[k];
+    }
+}
+#endif
+
+
+/*
+    amplitude modulation of the carrier : y = A sin(ph) (1 + m x)
+*/
+static void modulator_am_s16 (arm_stream_modulator_instance *pinstance, const int16_t *x, int16_t *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    int32_t a = pinstance->config.amplitude[0], m = pinstance->config.am_index, c, g;
+
+    for (i = 0; i < n; i++)
+    {   c = ((arm_stream_nco_sine(ph) >> 16) * a) >> 15;
+        g = 32768 + ((m * x[i]) >> 15);         /* 1 + m x, Q15 */
+        y[i] = SAT16((c * g) >> 15);
+        ph += inc;
+    }
+    pinstance->phase[0] = ph;
+}
+
+static void modulator_am_s32 (arm_stream_modulator_instance *pinstance, const int32_t *x, int32_t *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    int32_t a = pinstance->config.amplitude[0], m = pinstance->config.am_index, g;
+    int64_t c;
+
+    for (i = 0; i < n; i++)
+    {   c = ((int64_t)arm_stream_nco_sine(ph) * a) >> 15;
+        g = 32768 + ((m * (x[i] >> 16)) >> 15);
+        y[i] = SAT32((c * g) >> 15);
+        ph += inc;
+    }
+    pinstance->phase[0] = ph;
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static void modulator_am_f32 (arm_stream_modulator_instance *pinstance, const float *x, float *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    float a = (float)(pinstance->config.amplitude[0]) * (1.0f / 70368744177664.0f);
+    float m = (float)(pinstance->config.am_index) * (1.0f / 32768.0f);
+
+    for (i = 0; i < n; i++)
+    {   y[i] = (float)arm_stream_nco_sine(ph) * a * (1.0f + m * x[i]);
+        ph += inc;
+    }
+    pinstance->phase[0] = ph;
+}
+#endif
+
+
+/*
+    frequency modulation : the phase increment of the carrier is inc + deviation x
+*/
+static void modulator_fm_s16 (arm_stream_modulator_instance *pinstance, const int16_t *x, int16_t *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    int32_t a = pinstance->config.amplitude[0];
+    int32_t dev = (int32_t)(pinstance->config.fm_deviation >> 15);    /* <= 2^15 */
+
+    for (i = 0; i < n; i++)
+    {   y[i] = (int16_t)(((arm_stream_nco_sine(ph) >> 16) * a) >> 15);
+        ph += inc + (uint32_t)(dev * x[i]);
+    }
+    pinstance->phase[0] = ph;
+}
+
+static void modulator_fm_s32 (arm_stream_modulator_instance *pinstance, const int32_t *x, int32_t *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    int32_t a = pinstance->config.amplitude[0];
+    int64_t dev = pinstance->config.fm_deviation;
+
+    for (i = 0; i < n; i++)
+    {   y[i] = (int32_t)(((int64_t)arm_stream_nco_sine(ph) * a) >> 15);
+        ph += inc + (uint32_t)(int32_t)((dev * x[i]) >> 31);
+    }
+    pinstance->phase[0] = ph;
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static void modulator_fm_f32 (arm_stream_modulator_instance *pinstance, const float *x, float *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    float a = (float)(pinstance->config.amplitude[0]) * (1.0f / 70368744177664.0f);
+    float dev = (float)(pinstance->config.fm_deviation);
+
+    for (i = 0; i < n; i++)
+    {   y[i] = (float)arm_stream_nco_sine(ph) * a;
+        ph += inc + (uint32_t)(int32_t)(dev * MIN(1.0f, MAX(-1.0f, x[i])));
+    }
+    pinstance->phase[0] = ph;
+}
+#endif
+
+
+/*
+    I/Q translated on the carrier : y = A (I cos(ph) - Q sin(ph))
+*/
+static void modulator_iq_s16 (arm_stream_modulator_instance *pinstance, const int16_t *x, int16_t *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    int32_t a = pinstance->config.amplitude[0], c, s, v;
+
+    for (i = 0; i < n; i++)
+    {   c = arm_stream_nco_sine(ph + ARM_STREAM_NCO_QUARTER) >> 16;
+        s = arm_stream_nco_sine(ph) >> 16;
+        v = ((x[2*i] * c) >> 1) - ((x[2*i + 1] * s) >> 1);     /* Q29 */
+        y[i] = SAT16(((v >> 14) * a) >> 15);
+        ph += inc;
+    }
+    pinstance->phase[0] = ph;
+}
+
+static void modulator_iq_s32 (arm_stream_modulator_instance *pinstance, const int32_t *x, int32_t *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    int32_t a = pinstance->config.amplitude[0];
+    int64_t v;
+
+    for (i = 0; i < n; i++)
+    {   v = ((int64_t)x[2*i] * arm_stream_nco_sine(ph + ARM_STREAM_NCO_QUARTER)
+           - (int64_t)x[2*i + 1] * arm_stream_nco_sine(ph)) >> 31;
+        y[i] = SAT32((v * a) >> 15);
+        ph += inc;
+    }
+    pinstance->phase[0] = ph;
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static void modulator_iq_f32 (arm_stream_modulator_instance *pinstance, const float *x, float *y, uint32_t n)
+{
+    uint32_t ph = pinstance->phase[0], inc = pinstance->config.increment[0], i;
+    float a = (float)(pinstance->config.amplitude[0]) * (1.0f / 70368744177664.0f);
+
+    for (i = 0; i < n; i++)
+    {   y[i] = a * (x[2*i] * (float)arm_stream_nco_sine(ph + ARM_STREAM_NCO_QUARTER)
+                  - x[2*i + 1] * (float)arm_stream_nco_sine(ph));
+        ph += inc;
+    }
+    pinstance->phase[0] = ph;
+}
+#endif
+
+
+/*
+    check of the parameters, the phases are not changed, the VGM player restarts
+*/
+void arm_stream_modulator_init (arm_stream_modulator_instance *pinstance)
+{
+    modulator_parameters *config = &(pinstance->config);
+
+    config->mode = (uint8_t)MIN(MODULATOR_MODE_VGM, config->mode);
+    config->nb_tones = (uint8_t)MAX(1, MIN(MODULATOR_NB_TONES, config->nb_tones));
+    config->fm_deviation = MIN(MODULATOR_MAX_DEVIATION, config->fm_deviation);
+
+    if (config->mode == MODULATOR_MODE_VGM)
+    {   arm_stream_modulator_vgm_init (&(pinstance->vgm), config->sampling_rate);
+    }
+}
 
 
 /**
-  @brief         
-  @param[in]     pinst      instance of the component
-  @param[in/out] pdata      address and size of buffers
-  @param[out]    pstatus    execution state (0=processing not finished)
-  @return        status     finalized processing
+  @brief         Processing function
+  @param[in]     instance       points to an instance of the modulator
+  @param[in]     in             modulating signal (I/Q interleaved in MODULATOR_MODE_IQ)
+  @param[in]     nbSamplesIn    samples in the input buffer
+  @param[out]    out            modulated signal
+  @param[in/out] nbSamplesOut   free samples in the output buffer / samples produced
+  @return        number of input samples consumed
  */
-void arm_stream_modulator_process (arm_stream_modulator_instance *instance, void *input, void *output, intptr_t *nsamp)
+int32_t arm_stream_modulator_process (arm_stream_modulator_instance *pinstance,
+                     uint8_t *in, int32_t nbSamplesIn, uint8_t *out, int32_t *nbSamplesOut)
 {
+    uint32_t n, consumed;
+    uint8_t mode = pinstance->config.mode;
 
+    if (mode == MODULATOR_MODE_VGM)
+    {   /* Q15 samples extended in place, from the end */
+        n = (uint32_t)(*nbSamplesOut);
+        arm_stream_modulator_vgm (&(pinstance->vgm), (int16_t *)out, n);
+        switch (pinstance->raw)
+        {
+        case STREAM_S32:
+            for (consumed = n; consumed > 0; consumed--)
+            {   ((int32_t *)out)[consumed - 1] = (int32_t)((uint32_t)(((int16_t *)out)[consumed - 1]) << 16);
+            }
+            break;
+#if STREAM_FLOAT_ALLOWED==1
+        case STREAM_FP32:
+            for (consumed = n; consumed > 0; consumed--)
+            {   ((float *)out)[consumed - 1] = (float)(((int16_t *)out)[consumed - 1]) * (1.0f / 32768.0f);
+            }
+            break;
+#endif
+        default:
+            break;
+        }
+        *nbSamplesOut = (int32_t)n;
+        return nbSamplesIn;             /* not used */
+    }
+    else if (mode == MODULATOR_MODE_TONES)
+    {   n = (uint32_t)(*nbSamplesOut);
+        consumed = (uint32_t)nbSamplesIn;   /* not used */
+    }
+    else if (mode == MODULATOR_MODE_IQ)
+    {   n = (uint32_t)MIN(nbSamplesIn / 2, *nbSamplesOut);
+        consumed = 2 * n;
+    }
+    else
+    {   n = (uint32_t)MIN(nbSamplesIn, *nbSamplesOut);
+        consumed = n;
+    }
 
+    switch (pinstance->raw)
+    {
+    case STREAM_S32:
+        switch (mode)
+        {   default:
+            case MODULATOR_MODE_TONES: modulator_tones_s32 (pinstance, (int32_t *)out, n); break;
+            case MODULATOR_MODE_AM:    modulator_am_s32 (pinstance, (int32_t *)in, (int32_t *)out, n); break;
+            case MODULATOR_MODE_FM:    modulator_fm_s32 (pinstance, (int32_t *)in, (int32_t *)out, n); break;
+            case MODULATOR_MODE_IQ:    modulator_iq_s32 (pinstance, (int32_t *)in, (int32_t *)out, n); break;
+        }
+        break;
+#if STREAM_FLOAT_ALLOWED==1
+    case STREAM_FP32:
+        switch (mode)
+        {   default:
+            case MODULATOR_MODE_TONES: modulator_tones_f32 (pinstance, (float *)out, n); break;
+            case MODULATOR_MODE_AM:    modulator_am_f32 (pinstance, (float *)in, (float *)out, n); break;
+            case MODULATOR_MODE_FM:    modulator_fm_f32 (pinstance, (float *)in, (float *)out, n); break;
+            case MODULATOR_MODE_IQ:    modulator_iq_f32 (pinstance, (float *)in, (float *)out, n); break;
+        }
+        break;
+#endif
+    default:
+    case STREAM_S16:
+        switch (mode)
+        {   default:
+            case MODULATOR_MODE_TONES: modulator_tones_s16 (pinstance, (int16_t *)out, n); break;
+            case MODULATOR_MODE_AM:    modulator_am_s16 (pinstance, (int16_t *)in, (int16_t *)out, n); break;
+            case MODULATOR_MODE_FM:    modulator_fm_s16 (pinstance, (int16_t *)in, (int16_t *)out, n); break;
+            case MODULATOR_MODE_IQ:    modulator_iq_s16 (pinstance, (int16_t *)in, (int16_t *)out, n); break;
+        }
+        break;
+    }
+
+    *nbSamplesOut = (int32_t)n;
+    return (int32_t)consumed;
 }
+
 #ifdef __cplusplus
 }
 #endif
- 
-#endif // CODE_ARM_STREAM_MODULATOR
\ No newline at end of file
+
+#endif // CODE_ARM_STREAM_MODULATOR
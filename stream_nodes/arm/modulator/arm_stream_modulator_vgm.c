@@ -0,0 +1,344 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        arm_stream_modulator_vgm.c
+ * Description:  SN76489 emulation and VGM command stream player
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ */
+
+
+#include "presets.h"
+#ifdef CODE_ARM_STREAM_MODULATOR
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_modulator.h"
+
+
+/*
+    attenuation of 2dB per step, 15 = off, the four channels sum without saturation
+*/
+static const int16_t vgm_volume [16] =
+{   8191, 6506, 5168, 4105, 3261, 2590, 2057, 1634, 1298, 1031, 819, 651, 517, 411, 326, 0,
+};
+
+#define VGM_MAX_CLOCK           8000000     /* clock << 8 stays in 32 bits */
+#define VGM_STATE_HEADER        0
+#define VGM_STATE_PLAY          1
+#define VGM_STATE_END           2
+
+static uint32_t vgm_read32 (const uint8_t *d)
+{
+    return (uint32_t)d[0] | ((uint32_t)d[1] << 8) | ((uint32_t)d[2] << 16) | ((uint32_t)d[3] << 24);
+}
+
+
+/*
+    chip ticks (clock/16) per output sample, Q12
+*/
+static void vgm_clock (modulator_vgm *vgm, uint32_t clock)
+{
+    clock &= 0x7FFFFFFFUL;                  /* bit 31 : T6W28 flag */
+    if (clock == 0)
+    {   clock = VGM_DEFAULT_CLOCK;
+    }
+    clock = MIN(VGM_MAX_CLOCK, clock);
+    vgm->step = (int32_t)MAX(2, (clock << (VGM_Q - 4)) / vgm->sampling_rate);
+    vgm->inv_step = (int32_t)(0x80000000UL / (uint32_t)(vgm->step));
+}
+
+
+/*
+    header "Vgm " : clock, loop, LFSR and start of the commands, a stream without header
+    starts at its first byte
+*/
+static void vgm_header (modulator_vgm *vgm)
+{
+    const uint8_t *d = vgm->data;
+    uint32_t version, offset;
+
+    vgm->position = 0;
+    vgm->loop = 0;
+    if (vgm->size >= 0x40 && d[0] == 'V' && d[1] == 'g' && d[2] == 'm' && d[3] == ' ')
+    {   version = vgm_read32(&d[0x08]);
+        vgm_clock (vgm, vgm_read32(&d[0x0C]));
+
+        offset = vgm_read32(&d[0x1C]);
+        vgm->loop = (offset != 0) ? offset + 0x1C : 0;
+
+        if (version >= 0x110 && d[0x2A] != 0)
+        {   vgm->feedback = (uint16_t)(d[0x28] | (d[0x29] << 8));
+            vgm->width = (uint8_t)MIN(16, d[0x2A]);
+        }
+        if (version >= 0x151)
+        {   vgm->flags = d[0x2B];
+        }
+        offset = (version >= 0x150) ? vgm_read32(&d[0x34]) : 0;
+        vgm->position = (offset != 0) ? offset + 0x34 : 0x40;
+    }
+    vgm->lfsr = (uint16_t)(1u << (vgm->width - 1));
+    vgm->state = VGM_STATE_PLAY;
+}
+
+
+/*
+    PSG write : latch/data byte (1 ccc t dddd) or data byte (0 x dddddd)
+*/
+static void vgm_write (modulator_vgm *vgm, uint8_t b)
+{
+    uint8_t c;
+
+    if (b & 0x80)
+    {   vgm->latch = (uint8_t)((b >> 4) & 7);
+    }
+    c = (uint8_t)(vgm->latch >> 1);
+
+    if (vgm->latch & 1)                     /* attenuation */
+    {   vgm->attenuation[c] = (uint8_t)(b & 0x0F);
+    }
+    else if (c < VGM_NB_CHANNELS - 1)       /* tone period, 4 LSB then 6 MSB */
+    {   if (b & 0x80)
+        {   vgm->period[c] = (uint16_t)((vgm->period[c] & 0x3F0) | (b & 0x0F));
+        }
+        else
+        {   vgm->period[c] = (uint16_t)((vgm->period[c] & 0x00F) | ((b & 0x3F) << 4));
+        }
+    }
+    else                                    /* noise control, the LFSR is reset */
+    {   vgm->noise = (uint8_t)(b & 7);
+        vgm->lfsr = (uint16_t)(1u << (vgm->width - 1));
+    }
+}
+
+
+/*
+    commands up to the next wait of at least one output sample
+*/
+static void vgm_commands (modulator_vgm *vgm)
+{
+    const uint8_t *d = vgm->data;
+    uint32_t pos = vgm->position, size = vgm->size, len;
+    int32_t ratio = vgm->wait_ratio;
+    uint8_t cmd, waited = 0, jumped = 0;
+
+    while (vgm->wait < (1 << VGM_Q))
+    {   if (pos >= size)
+        {   vgm->state = VGM_STATE_END;
+            break;
+        }
+
+        /* length of the command */
+        cmd = d[pos];
+        if      (cmd == 0x67)                { len = (pos + 7 <= size) ? 7 + (vgm_read32(&d[pos + 3]) & 0x7FFFFFFFUL) : 7; }
+        else if (cmd == 0x68)                { len = 12; }
+        else if (cmd == 0x64)                { len = 4; }
+        else if (cmd == 0x93)                { len = 11; }
+        else if (cmd == 0x92)                { len = 6; }
+        else if (cmd == 0x94)                { len = 2; }
+        else if (cmd >= 0x90 && cmd <= 0x95) { len = 5; }
+        else if (cmd == 0x61)                { len = 3; }
+        else if (cmd >= 0x30 && cmd <= 0x50) { len = (cmd < 0x40 || cmd == 0x4F || cmd == 0x50) ? 2 : 3; }
+        else if (cmd >= 0x51 && cmd <= 0x5F) { len = 3; }
+        else if (cmd >= 0xA0 && cmd <= 0xBF) { len = 3; }
+        else if (cmd >= 0xC0 && cmd <= 0xDF) { len = 4; }
+        else if (cmd >= 0xE0)                { len = 5; }
+        else                                 { len = 1; }
+
+        if (pos + len > size)
+        {   vgm->state = VGM_STATE_END;
+            break;
+        }
+
+        if (cmd == 0x50)
+        {   vgm_write (vgm, d[pos + 1]);
+        }
+        else if (cmd == 0x61)
+        {   vgm->wait += (int32_t)(d[pos + 1] | (d[pos + 2] << 8)) * ratio; waited = 1;
+        }
+        else if (cmd == 0x62)
+        {   vgm->wait += 735 * ratio; waited = 1;
+        }
+        else if (cmd == 0x63)
+        {   vgm->wait += 882 * ratio; waited = 1;
+        }
+        else if ((cmd & 0xF0) == 0x70)
+        {   vgm->wait += (int32_t)((cmd & 0x0F) + 1) * ratio; waited = 1;
+        }
+        else if ((cmd & 0xF0) == 0x80)      /* YM2612 DAC write and wait */
+        {   vgm->wait += (int32_t)(cmd & 0x0F) * ratio; waited = 1;
+        }
+        else if (cmd == 0x66)
+        {   if (vgm->loop == 0 || vgm->loop >= size || (jumped && !waited))    /* no loop, or a loop without wait */
+            {   vgm->state = VGM_STATE_END;
+                break;
+            }
+            pos = vgm->loop;
+            jumped = 1;
+            waited = 0;
+            continue;
+        }
+        pos += len;
+    }
+    vgm->position = pos;
+}
+
+
+/*
+    the four channels added to the output, the registers are constant during n samples
+*/
+static void vgm_render (modulator_vgm *vgm, int16_t *y, uint32_t n)
+{
+    int32_t step = vgm->step, inv = vgm->inv_step, cnt, per, v, s, f;
+    uint32_t c, i, x;
+
+    for (c = 0; c < VGM_NB_CHANNELS - 1; c++)
+    {   v = vgm_volume[vgm->attenuation[c]];
+        if (v == 0)
+        {   continue;
+        }
+        per = vgm->period[c];
+        if (per == 0)
+        {   per = (vgm->flags & 1) ? 0x400 : 1;
+        }
+        per = per << VGM_Q;
+
+        if (per <= step)                    /* above FS/2 : constant level */
+        {   for (i = 0; i < n; i++)
+            {   y[i] = (int16_t)(y[i] + v);
+            }
+            continue;
+        }
+
+        cnt = vgm->counter[c];
+        s = (vgm->polarity & (1u << c)) ? v : -v;
+        for (i = 0; i < n; i++)
+        {   cnt -= step;
+            if (cnt <= 0)
+            {   /* f : part of the sample after the transition, Q15 */
+                f = (int32_t)(((uint32_t)(-cnt) * (uint32_t)inv) >> 16);
+                cnt += per;
+                s = -s;
+                y[i] = (int16_t)(y[i] - s + (((2 * s) * f) >> 15));
+            }
+            else
+            {   y[i] = (int16_t)(y[i] + s);
+            }
+        }
+        vgm->counter[c] = cnt;
+        vgm->polarity = (uint8_t)((vgm->polarity & ~(1u << c)) | ((s > 0) ? (1u << c) : 0));
+    }
+
+    /* noise : the LFSR is shifted every two transitions of its counter */
+    v = vgm_volume[vgm->attenuation[VGM_NB_CHANNELS - 1]];
+    if (v != 0)
+    {   x = vgm->noise & 3;
+        per = (x == 3) ? MAX(1, vgm->period[2]) : (0x10 << x);
+        per = per << (VGM_Q + 1);
+        cnt = vgm->counter[VGM_NB_CHANNELS - 1];
+        s = (vgm->lfsr & 1) ? v : -v;
+        for (i = 0; i < n; i++)
+        {   cnt -= step;
+            if (cnt <= 0)
+            {   cnt = MAX(1, cnt + per);
+                if (vgm->noise & 4)         /* white noise */
+                {   x = vgm->lfsr & vgm->feedback;
+                    x ^= x >> 8; x ^= x >> 4; x ^= x >> 2; x ^= x >> 1;
+                }
+                else                        /* periodic noise */
+                {   x = vgm->lfsr;
+                }
+                vgm->lfsr = (uint16_t)((vgm->lfsr >> 1) | ((x & 1) << (vgm->width - 1)));
+                s = (vgm->lfsr & 1) ? v : -v;
+            }
+            y[i] = (int16_t)(y[i] + s);
+        }
+        vgm->counter[VGM_NB_CHANNELS - 1] = cnt;
+    }
+}
+
+
+/*
+    reset of the chip and of the player, the stream is read again from the start
+*/
+void arm_stream_modulator_vgm_init (modulator_vgm *vgm, uint32_t sampling_rate)
+{
+    uint8_t *pt8bdst = (uint8_t *)vgm;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(modulator_vgm); i++)
+    {   pt8bdst[i] = 0;
+    }
+    vgm->sampling_rate = (sampling_rate == 0) ? 48000 : MAX(1000, MIN(192000, sampling_rate));
+    vgm->wait_ratio = (int32_t)((vgm->sampling_rate << VGM_Q) / VGM_WAIT_RATE);
+    vgm_clock (vgm, VGM_DEFAULT_CLOCK);
+    vgm->feedback = 0x0009;
+    vgm->width = 16;
+    for (i = 0; i < VGM_NB_CHANNELS; i++)
+    {   vgm->attenuation[i] = 15;
+    }
+    vgm->state = VGM_STATE_HEADER;
+}
+
+
+/**
+  @brief         VGM player
+  @param[in/out] vgm        chip and player, vgm->data and vgm->size give the command stream
+  @param[out]    y          n samples, Q15
+  @param[in]     n          number of samples
+ */
+void arm_stream_modulator_vgm (modulator_vgm *vgm, int16_t *y, uint32_t n)
+{
+    uint32_t i, k;
+
+    for (i = 0; i < n; i++)
+    {   y[i] = 0;
+    }
+    if (vgm->data == 0 || vgm->size == 0)
+    {   return;
+    }
+    if (vgm->state == VGM_STATE_HEADER)
+    {   vgm_header (vgm);
+    }
+
+    while (n > 0)
+    {   if (vgm->state == VGM_STATE_END)
+        {   return;
+        }
+        vgm_commands (vgm);
+        k = MIN(n, (uint32_t)(vgm->wait >> VGM_Q));
+        vgm_render (vgm, y, k);
+        vgm->wait -= (int32_t)(k << VGM_Q);
+        y += k;
+        n -= k;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CODE_ARM_STREAM_MODULATOR
@@ -0,0 +1,77 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        arm_stream_nco.h
+ * Description:  numerically controlled oscillator shared by the modulator and demodulator
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+
+#ifndef cARM_STREAM_NCO_H
+#define cARM_STREAM_NCO_H
+
+
+#include <stdint.h>
+
+
+/*
+    NCO : 32-bit phase accumulator, the phase increment of a frequency f is f / FS x 2^32.
+    The sine is read in a quarter-wave table of 257 points (Q31) with a linear interpolation,
+    the error is below 5e-6 of full-scale (spurious-free dynamic range better than 100dB).
+    The cosine is the sine of phase + ARM_STREAM_NCO_QUARTER.
+*/
+
+#define ARM_STREAM_NCO_BITS             8   /* 256 intervals per quarter-wave */
+#define ARM_STREAM_NCO_QUARTER          0x40000000UL
+
+extern const int32_t arm_stream_nco_table [(1 << ARM_STREAM_NCO_BITS) + 1];
+
+
+/*
+    sine of the phase, Q31 : the quarter-wave index is given by the bits 29..22 of the phase,
+    the interpolation by the next 15 bits. The multiplication stays in 32 bits and the
+    quarters are selected without branch (mirror and sign masks).
+*/
+static inline int32_t arm_stream_nco_sine (uint32_t phase)
+{
+    uint32_t mirror = 0u - ((phase >> 30) & 1u), p, i, f;
+    int32_t sign = (int32_t)phase >> 31, s, d;
+
+    p = (phase ^ mirror) & (ARM_STREAM_NCO_QUARTER - 1);    /* second and fourth quarters : mirrored */
+    i = p >> (30 - ARM_STREAM_NCO_BITS);
+    f = (p >> (30 - ARM_STREAM_NCO_BITS - 15)) & 0x7FFFu;
+    d = arm_stream_nco_table[i + 1] - arm_stream_nco_table[i];
+    s = arm_stream_nco_table[i] + (((d >> 8) * (int32_t)f) >> 7);
+
+    return (s ^ sign) - sign;
+}
+
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
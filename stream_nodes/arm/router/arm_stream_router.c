@@ -178,10 +178,24 @@ void arm_stream_router (unsigned int command, void *instance, void *data, unsign
                 the number of arcs (NARC_CMD) is used to configure arm_stream_router_instance.configuration
         */
         case STREAM_RESET: 
-        {   //stream_services *stream_entry = (stream_services *)data;
-            //intptr_t *memresults = (intptr_t *)instance;
-            //uint16_t preset = RD(command, PRESET_CMD);
-            //arm_stream_router_instance *pinstance = (arm_stream_router_instance *) *memresults;
+        {   stream_services *stream_entry = (stream_services *)data;
+            intptr_t *memresults = (intptr_t *)instance;
+            uint16_t preset = RD(command, PRESET_CMD);
+            arm_stream_router_instance *pinstance = (arm_stream_router_instance *) *memresults;
+
+            pinstance->stream_entry = stream_entry;
+            pinstance->preset = (uint8_t)preset;
+
+            /* ASRC : memresults = {instance, node_mem 1, 4 format words of arc 0, 4 format words of arc 1,
+                buffer size of arc 0, buffer size of arc 1} */
+            if (preset == ROUTER_PRESET_ASRC)
+            {   uint32_t format[8];
+                uint8_t i;
+
+                for (i = 0; i < 8; i++) { format[i] = (uint32_t)memresults[2 + i]; }
+                pinstance->asrc = (router_asrc *)(memresults[1]);
+                arm_stream_router_asrc_reset(pinstance->asrc, &(format[0]), &(format[4]), (uint32_t)memresults[2 + 8]);
+            }
             break;
         }    
 
@@ -208,6 +222,15 @@ void arm_stream_router (unsigned int command, void *instance, void *data, unsign
             /* copy the parameters from preset or from the graph */
             pt8bsrc = (uint8_t *) data;
 
+            /* ASRC : u16 target fill of the input arc in frames, 0 = default from the frame sizes */
+            if (pinstance->preset == ROUTER_PRESET_ASRC)
+            {   int32_t target = (int32_t)(pt8bsrc[0] | (pt8bsrc[1] << 8));
+                if (target > 0)
+                {   stream_fill_control_target(&(pinstance->asrc->fill), target << 8);
+                }
+                break;
+            }
+
             //for (i = 0; i < n; i++)
             //{   pt16bdst[i] = pt16bsrc[i];
             //}
@@ -244,6 +267,10 @@ void arm_stream_router (unsigned int command, void *instance, void *data, unsign
 
 
             pt_pt = data;
+            if (pinstance->preset == ROUTER_PRESET_ASRC)
+            {   arm_stream_router_asrc_run (pinstance->asrc, pt_pt);
+                break;
+            }
             arm_stream_router_process (pinstance, pt_pt);
             break;
         }
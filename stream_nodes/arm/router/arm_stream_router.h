@@ -87,6 +87,49 @@
 
 
 
+/*
+    node_preset
+*/
+#define ROUTER_PRESET_INTERLEAVE    0       /* just interleaving */
+#define ROUTER_PRESET_CONVERSION    1       /* just format conversion */
+#define ROUTER_PRESET_ASRC          2       /* with ASRC */
+#define ROUTER_PRESET_SSRC          3       /* with SSRC */
+
+/*
+    ASRC : arc 0 resampled to arc 1 with a cubic Lagrange interpolator in Farrow structure,
+    same raw format (S16, S32, FP32) and same number of interleaved channels on both arcs.
+    The ratio Fs(arc 0)/Fs(arc 1) is corrected by a PI loop on the input arc fill level : 
+    the producer and the consumer of the arcs can be on different clocks.
+    The output is silence until the input arc reaches the target fill (pre-roll), the default 
+    target is two input frames + the input consumed for one output frame, limited to the 
+    input arc capacity minus one frame.
+*/
+#define ROUTER_ASRC_MAX_NCHAN       8
+#define ROUTER_ASRC_NTAPS           4       /* x[-1] x[0] x[1] x[2], output between x[0] and x[1] */
+#define ROUTER_ASRC_ONE    ((uint64_t)1 << 32)  /* phase and step format Q32 */
+
+#define ROUTER_ASRC_DEFAULT_FILL  256       /* target fill when the frame sizes are not known */
+#define ROUTER_ASRC_ACQ_CALLS    4096       /* acquisition after the pre-roll with a faster loop */
+#define ROUTER_ASRC_ACQ_GEAR        3       /* acquisition : KP x8, integral gain x64, smoothing 1/32 */
+#define ROUTER_ASRC_RANGE_SHIFT     7       /* correction limited to +/- 1/128 (7800ppm) of the nominal step */
+
+typedef struct
+{
+    union                                   /* per-channel interpolator taps, oldest first */
+    {   int32_t q[ROUTER_ASRC_MAX_NCHAN][ROUTER_ASRC_NTAPS];    /* S16 << 16, S32 */
+        float   f[ROUTER_ASRC_MAX_NCHAN][ROUTER_ASRC_NTAPS];
+    } taps;
+
+    uint64_t step_nominal;                  /* Fs in / Fs out in Q32 */
+    uint64_t step;                          /* step corrected by the fill control */
+    uint64_t phase;                         /* position of the next output from x[0], Q32 */
+    stream_fill_control_t fill;             /* target default from the frame sizes, or set with parameters */
+    uint32_t out_frames;                    /* frames produced per call, 0 = all the free space */
+    uint8_t  raw;
+    uint8_t  nchan;
+} router_asrc;
+
+
 /*
     input streams control parameters :
 */
@@ -138,9 +181,14 @@ typedef struct
     float_t past_samples[NBPASTSAMPLES];             // samples used for the rate conversion (polynomial)
     float_t output_gain;                             // linear gain applied on mixer output
 
+    uint8_t preset;
+    router_asrc *asrc;                              // node_mem 1 with ROUTER_PRESET_ASRC
+
 } arm_stream_router_instance;
 
 extern void arm_stream_router_process (arm_stream_router_instance *instance, stream_xdmbuffer_t *in_out);
+extern void arm_stream_router_asrc_reset (router_asrc *S, uint32_t *format_in, uint32_t *format_out, uint32_t bufsize_in);
+extern void arm_stream_router_asrc_run (router_asrc *S, stream_xdmbuffer_t *in_out);
 
 #endif
 
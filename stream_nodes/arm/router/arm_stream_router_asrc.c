@@ -0,0 +1,313 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        arm_stream_router_asrc.c
+ * Description:  asynchronous sample-rate converter of arm_stream_router
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "presets.h"
+#ifdef CODE_ARM_STREAM_ROUTER
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_router.h"
+
+/*
+    Cubic Lagrange interpolation in Farrow structure (see Experiment/Farrow_Filter.pdf), the
+    output at x[0] + mu (0 <= mu < 1) is a polynomial of mu whose coefficients are computed
+    from the 4 taps once per output sample :
+
+        c0 = x[0]
+        c1 = x[1] - x[0]/2 - x[-1]/3 - x[2]/6
+        c2 = (x[-1] + x[1])/2 - x[0]
+        c3 = (x[2] - x[-1])/6 + (x[0] - x[1])/2
+        y  = ((c3 mu + c2) mu + c1) mu + c0
+
+    Fixed-point : taps in Q31 (S16 are shifted by 16), coefficients in 64 bits and mu in Q28,
+    the products stay below 2^62 for full-scale signals.
+*/
+#define ASRC_MU_SHIFT       28
+#define ASRC_DIV6(d)        (((d) * 715827883) >> 32)   /* (2^32 / 6) : |d| < 2^33 */
+
+static int32_t farrow_q31 (const int32_t *t, int64_t mu)
+{
+    int64_t xm1 = t[0], x0 = t[1], x1 = t[2], x2 = t[3];
+    int64_t c1, c2, c3, y;
+
+    c3 = ASRC_DIV6(x2 - xm1) + ((x0 - x1) >> 1);
+    c2 = ((xm1 + x1) >> 1) - x0;
+    c1 = x1 - (x0 >> 1) - ASRC_DIV6(2 * xm1 + x2);
+
+    y = (c3 * mu) >> ASRC_MU_SHIFT;
+    y = ((y + c2) * mu) >> ASRC_MU_SHIFT;
+    y = ((y + c1) * mu) >> ASRC_MU_SHIFT;
+    y = y + x0;
+
+    return (int32_t)MIN(MAX(y, -0x7FFFFFFFLL - 1), 0x7FFFFFFFLL);
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static float farrow_f32 (const float *t, float mu)
+{
+    float xm1 = t[0], x0 = t[1], x1 = t[2], x2 = t[3];
+    float c1, c2, c3;
+
+    c3 = (x2 - xm1) * (1.0f/6.0f) + (x0 - x1) * 0.5f;
+    c2 = (xm1 + x1) * 0.5f - x0;
+    c1 = x1 - 0.5f * x0 - (2.0f * xm1 + x2) * (1.0f/6.0f);
+
+    return ((c3 * mu + c2) * mu + c1) * mu + x0;
+}
+#endif
+
+
+/*
+    Fs from FMT2 (IEEE-754) to Q32 ratio, without floating-point :
+        Fs = m x 2^e,  Fs_in/Fs_out = (m_in/m_out) x 2^(e_in - e_out)
+    0 ("any" or asynchronous) gives the ratio 1, corrected by the fill control
+*/
+static uint64_t asrc_ratio_q32 (uint32_t fs_in, uint32_t fs_out)
+{
+    uint64_t m_in, m_out, r;
+    int32_t e;
+
+    if (0 == (fs_in & 0x7FFFFFFFu) || 0 == (fs_out & 0x7FFFFFFFu))
+    {   return ROUTER_ASRC_ONE;
+    }
+    m_in  = (fs_in  & 0x7FFFFFu) | 0x800000u;
+    m_out = (fs_out & 0x7FFFFFu) | 0x800000u;
+    e = (int32_t)((fs_in >> 23) & 0xFFu) - (int32_t)((fs_out >> 23) & 0xFFu);
+    e = MIN(MAX(e, -24), 4);                /* ratios in [2^-24 .. 32[ */
+
+    r = (m_in << 32) / m_out;               /* [0.5 .. 2[ in Q32 */
+    return (e >= 0) ? (r << e) : (r >> (-e));
+}
+
+
+/**
+  @brief         ASRC initialization from the formats of the input and output arcs
+  @param[out]    S           ASRC state (node_mem 1)
+  @param[in]     format_in   the 4 format words of arc 0 (FRAMESZ_FMT0 .. DOMAINSPECIFIC_FMT3)
+  @param[in]     format_out  the 4 format words of arc 1
+  @param[in]     bufsize_in  buffer size of arc 0 in Bytes, 0 when unknown
+  @return        none
+ */
+void arm_stream_router_asrc_reset (router_asrc *S, uint32_t *format_in, uint32_t *format_out, uint32_t bufsize_in)
+{
+    uint8_t *pt8 = (uint8_t *)S;
+    uint32_t i, frame_bytes, in_frames;
+    int32_t target, fill_max;
+
+    for (i = 0; i < sizeof(router_asrc); i++) { pt8[i] = 0; }   /* taps cleared to 0 and 0.0f */
+
+    S->raw = (uint8_t)RD(format_in[NCHANDOMAIN_FMT1], RAW_FMT1);
+    S->nchan = (uint8_t)MIN(1 + RD(format_in[NCHANDOMAIN_FMT1], NCHANM1_FMT1), ROUTER_ASRC_MAX_NCHAN);
+
+    S->step_nominal = asrc_ratio_q32(format_in[SAMPLINGRATE_FMT2], format_out[SAMPLINGRATE_FMT2]);
+    S->step = S->step_nominal;
+    S->phase = ROUTER_ASRC_ONE;             /* the first output needs one new input sample */
+
+    frame_bytes = S->nchan * ((S->raw == STREAM_S16) ? sizeof(int16_t) : sizeof(int32_t));
+    S->out_frames = RD(format_out[FRAMESZ_FMT0], FRAMESIZE_FMT0) / frame_bytes;
+
+    /* the input consumed by one output frame + two input frames of margin, in Q8 : when the two 
+        clocks are in phase the node can see zero or two new input frames between two calls */
+    in_frames = RD(format_in[FRAMESZ_FMT0], FRAMESIZE_FMT0) / frame_bytes;
+    target = (int32_t)(in_frames << 9) + (int32_t)((S->out_frames * S->step_nominal) >> 24);
+    if (target == 0)
+    {   target = ROUTER_ASRC_DEFAULT_FILL << 8;
+    }
+
+    /* the producer writes a frame only when there is space for it : the fill cannot exceed the 
+        capacity minus one frame when the node consumes nothing (pre-roll) */
+    fill_max = 0;
+    if (bufsize_in / frame_bytes > in_frames)
+    {   fill_max = (int32_t)((bufsize_in / frame_bytes - in_frames) << 8);
+    }
+    stream_fill_control_reset(&(S->fill), target, fill_max, (int64_t)(S->step_nominal >> ROUTER_ASRC_RANGE_SHIFT), 
+        ROUTER_ASRC_ACQ_CALLS, ROUTER_ASRC_ACQ_GEAR);
+}
+
+
+/*
+    Interpolation loops : new input frames are shifted in the taps while phase >= 1,
+    the loop stops when the output is full or the input is empty. Returns the frames produced.
+*/
+static uint32_t asrc_q31 (router_asrc *S, const int32_t *in, uint32_t nin, uint32_t *consumed, int32_t *out, uint32_t nout)
+{
+    uint32_t nch = S->nchan, ch, iin = 0, iout;
+
+    for (iout = 0; iout < nout; iout++)
+    {   while (S->phase >= ROUTER_ASRC_ONE)
+        {   if (iin == nin)
+            {   *consumed = iin;
+                return iout;
+            }
+            for (ch = 0; ch < nch; ch++)
+            {   int32_t *t = S->taps.q[ch];
+                t[0] = t[1];  t[1] = t[2];  t[2] = t[3];  t[3] = in[ch];
+            }
+            in += nch;
+            iin++;
+            S->phase -= ROUTER_ASRC_ONE;
+        }
+
+        for (ch = 0; ch < nch; ch++)
+        {   out[ch] = farrow_q31(S->taps.q[ch], (int64_t)(S->phase >> (32 - ASRC_MU_SHIFT)));
+        }
+        out += nch;
+        S->phase += S->step;
+    }
+    *consumed = iin;
+    return iout;
+}
+
+static uint32_t asrc_q15 (router_asrc *S, const int16_t *in, uint32_t nin, uint32_t *consumed, int16_t *out, uint32_t nout)
+{
+    uint32_t nch = S->nchan, ch, iin = 0, iout;
+
+    for (iout = 0; iout < nout; iout++)
+    {   while (S->phase >= ROUTER_ASRC_ONE)
+        {   if (iin == nin)
+            {   *consumed = iin;
+                return iout;
+            }
+            for (ch = 0; ch < nch; ch++)
+            {   int32_t *t = S->taps.q[ch];
+                t[0] = t[1];  t[1] = t[2];  t[2] = t[3];  t[3] = (int32_t)((uint32_t)in[ch] << 16);
+            }
+            in += nch;
+            iin++;
+            S->phase -= ROUTER_ASRC_ONE;
+        }
+
+        for (ch = 0; ch < nch; ch++)
+        {   int32_t y = farrow_q31(S->taps.q[ch], (int64_t)(S->phase >> (32 - ASRC_MU_SHIFT)));
+            out[ch] = (int16_t)((MIN(y, 0x7FFF7FFF) + 0x8000) >> 16);
+        }
+        out += nch;
+        S->phase += S->step;
+    }
+    *consumed = iin;
+    return iout;
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static uint32_t asrc_f32 (router_asrc *S, const float *in, uint32_t nin, uint32_t *consumed, float *out, uint32_t nout)
+{
+    uint32_t nch = S->nchan, ch, iin = 0, iout;
+
+    for (iout = 0; iout < nout; iout++)
+    {   float mu;
+
+        while (S->phase >= ROUTER_ASRC_ONE)
+        {   if (iin == nin)
+            {   *consumed = iin;
+                return iout;
+            }
+            for (ch = 0; ch < nch; ch++)
+            {   float *t = S->taps.f[ch];
+                t[0] = t[1];  t[1] = t[2];  t[2] = t[3];  t[3] = in[ch];
+            }
+            in += nch;
+            iin++;
+            S->phase -= ROUTER_ASRC_ONE;
+        }
+
+        mu = (float)(uint32_t)(S->phase) * (1.0f / 4294967296.0f);
+        for (ch = 0; ch < nch; ch++)
+        {   out[ch] = farrow_f32(S->taps.f[ch], mu);
+        }
+        out += nch;
+        S->phase += S->step;
+    }
+    *consumed = iin;
+    return iout;
+}
+#endif
+
+
+/**
+  @brief         ASRC processing of arc 0 to arc 1
+  @param[in]     S           ASRC state
+  @param[in/out] in_out      XDM buffers of arc 0 (data available) and arc 1 (free space)
+                             updated with the amount of data consumed and produced
+  @return        none
+ */
+void arm_stream_router_asrc_run (router_asrc *S, stream_xdmbuffer_t *in_out)
+{
+    uint32_t frame_bytes = S->nchan * ((S->raw == STREAM_S16) ? sizeof(int16_t) : sizeof(int32_t));
+    uint32_t nin = (uint32_t)(in_out[0].size) / frame_bytes;
+    uint32_t nout = (uint32_t)(in_out[1].size) / frame_bytes;
+    uint32_t consumed = 0, produced = 0;
+    int64_t corr;
+
+    if (S->out_frames != 0)
+    {   nout = MIN(nout, S->out_frames);
+    }
+
+    /* step corrected from the fill level of the input arc, see stream_common_fill_control.c */
+    if (0 == stream_fill_control(&(S->fill), nin, &corr))
+    {   uint8_t *pt8 = (uint8_t *)(in_out[1].address);
+        uint32_t i;
+
+        for (i = 0; i < nout * frame_bytes; i++) { pt8[i] = 0; }  /* pre-roll : silence */
+        in_out[0].size = 0;
+        in_out[1].size = nout * frame_bytes;
+        return;
+    }
+    S->step = (uint64_t)((int64_t)S->step_nominal + corr);
+
+    switch (S->raw)
+    {
+    case STREAM_S16:
+        produced = asrc_q15(S, (const int16_t *)(in_out[0].address), nin, &consumed, (int16_t *)(in_out[1].address), nout);
+        break;
+    case STREAM_S32:
+        produced = asrc_q31(S, (const int32_t *)(in_out[0].address), nin, &consumed, (int32_t *)(in_out[1].address), nout);
+        break;
+#if STREAM_FLOAT_ALLOWED==1
+    case STREAM_FP32:
+        produced = asrc_f32(S, (const float *)(in_out[0].address), nin, &consumed, (float *)(in_out[1].address), nout);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    in_out[0].size = consumed * frame_bytes;    /* amount of data consumed */
+    in_out[1].size = produced * frame_bytes;    /* amount of data produced */
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CODE_ARM_STREAM_ROUTER
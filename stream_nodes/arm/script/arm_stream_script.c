@@ -125,11 +125,34 @@ void arm_stream_script (uint32_t command, void *instance, void *data, uint32_t *
             pinstance->nstack = RD(pinstance->arc_desc[DBGFMT_SCRARCW4], NSTACK_SCRARCW4);
             pinstance->nregs = (uint8_t)RD(pinstance->arc_desc[DBGFMT_SCRARCW4], NREGS_SCRARCW4);
             pinstance->SP = pinstance->nregs;     // after { R0 .. R(nregs),R12 }
+            pinstance->params = (uint16_t)RD(pinstance->arc_desc[RDFLOW_SCRARCW2], PARAMSIZE_SCRARCW2);
+            pinstance->heap = (uint16_t)RD(pinstance->arc_desc[DBGFMT_SCRARCW4], RAMTOTALW32_SCRARCW4);
+            pinstance->heap = (uint16_t)((pinstance->heap > 2 * (pinstance->nregs + pinstance->nstack)) ?
+                            pinstance->heap - 2 * (pinstance->nregs + pinstance->nstack) : 0);
             pinstance->PC = 0;         // PC pre-incremented before read
             pinstance->test_flag = 0;
             pinstance->debug = 0;
             pinstance->cycles_downcounter = MAXCYCLES;
 
+            /* the script table tells if the byte codes have a native C translation : the running
+                script is the entry associated to the arc of the node, the first offset of the table
+                is the number of scripts */
+            pinstance->script_index = 0;
+            pinstance->format = SCRIPT_FORMAT_BYTECODE;
+            if (0 != pinstance->S->script)
+            {   uint32_t iscript, nscripts, iarc;
+
+                iarc = ARC_RX0TX1_CLEAR & (uint32_t)(pinstance->S->arcID[0]);
+                nscripts = RD(pinstance->S->script[0], OFFSET_SCROFF0);
+                for (iscript = 0; iscript < nscripts; iscript++)
+                {   if (RD(pinstance->S->script[iscript], ARC_SCROFF0) == iarc)
+                    {   pinstance->script_index = (uint8_t)iscript;
+                        pinstance->format = (uint8_t)RD(pinstance->S->script[iscript], FORMAT_SCROFF0);
+                        break;
+                    }
+                }
+            }
+
             /*
             *  BYTECODE 
             *         v
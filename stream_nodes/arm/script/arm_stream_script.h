@@ -83,6 +83,7 @@ typedef union
 #define ERROR_STACK_UNDERFLOW   (1 << 0)
 #define ERROR_STACK_OVERFLOW    (1 << 1)
 #define ERROR_TIME_UNDERFLOW    (1 << 2)
+#define ERROR_VECTOR_FORMAT     (1 << 3)
 
 /*
     THIS GOES IN ARC DESC 
@@ -113,6 +114,8 @@ typedef union
         uint32_t instruction;           /* current instruction */
         uint16_t PC;                    /* in uint32 */
         uint16_t codes;                 /* code size */          
+        uint16_t params;                /* parameters size in W32, after the code */
+        uint16_t heap;                  /* heap size in W32, after the stack */
         uint16_t cycles_downcounter;    /* error detection */
 #define MAXCYCLES 100
         uint8_t SP;                     /* in REGS unit */          
@@ -123,11 +126,25 @@ typedef union
         uint8_t compact;                /* indexes are packed in a single W32 */
         uint8_t inst_nbw32;             /* number of words of the instruction */
         uint8_t debug;                  /* register dump in each cycle */
+        uint8_t format;                 /* FORMAT_SCROFF0 : byte codes or native C */
+        uint8_t script_index;           /* index in the script table and in arm_stream_script_native[] */
     } arm_script_instance_t;
 
 
 extern void arm_stream_script_interpreter (arm_script_instance_t *I);
 
+/*
+    scripts translated to C by the graph compiler (SCRIPT_FORMAT_NATIVE_C), the table is 
+    generated in the "graph_xx_scripts.c" file of the platform and indexed like the script table,
+    a null entry means the script is interpreted
+*/
+typedef void (*p_script_native) (arm_script_instance_t *I);
+
+#ifdef PLATFORM_SCRIPT_NATIVE
+extern const p_script_native arm_stream_script_native[];
+extern const uint8_t arm_stream_script_nb_native;
+#endif
+
 
 #endif  // if carm_stream_script_H
 
@@ -156,6 +156,15 @@
     r2 <> r3                       OP_ALU OPAR_SWAP     R2-11.0 R3-11.0 R14-00.0
     p2[1]+ <> r3[-1]+              OP_ALU OPAR_SWAP     R2-01.1 R3-10.1 R14-00.0
     r2 = bswap r3 bitreverse       OP_ALU OPAR_BSWAP    R2-00.0 R3-00.0 code
+    r2 = sqrt r3                   OP_ALU OPAR_SQRT     R2-00.0 R3-00.0 FUNC_SQRT
+    r2 = dB r3                     OP_ALU OPAR_LOG10    R2-00.0 R3-00.0 FUNC_DB20      fp32 result
+    r2 = r3 * -3.14                OP_ALU OPAR_MUL      R2-00.0 R3-00.0 R14-10.0 0xc048f5c3   fp32 when one operand is a float
+
+    vector operations, P = pointer register, length N from a constant or a register
+    p1[] = p2[] + p3[]   n 64      OP_ALU OPAR_VADD     P1-00.0 P2-00.0 P3-00.0  0x00000040 
+    p1[] = p2[] * r4     n r5      OP_ALU OPAR_VSCALE   P1-00.0 P2-00.0 R4-00.0  0x80000005 
+    r1   = sumsq p2[]    n 64      OP_ALU OPAR_VSUMSQ   R1-00.0 P2-00.0 R14-00.0 0x00000040 
+    p1[] = p2[]          n 64      OP_ALU OPAR_VCOPY    P1-00.0 P2-00.0 R14-00.0 0x00000040  p1 fp32, p2 int16 
 
 
     OP_SETJUMP family              NO_COND_EXE                ab.c    ab.c    ab.c
@@ -210,6 +219,7 @@
 #define PTR_MEMBANK_PARAM  1u
 #define PTR_MEMBANK_HEAP   2u
 #define PTR_MEMBANK_GRAPH  3u
+#define PTR_MEMBANK_ARC    4u /* data from the arc buffer, BASE_PTR = arc index, offset from the read index */
 
 #define    BASE_PTR_MSB U(27) /* 12 Base */
 #define    BASE_PTR_LSB U(16) 
@@ -266,6 +276,12 @@
 #define K_DECREMENT 2
 
 
+/* VECTOR LENGTH extension word of OPAR_Vxx instructions */
+#define   VLENREG_INST_MSB 31       
+#define   VLENREG_INST_LSB 31 /* 1   0:constant length, 1:length in register */
+#define     VLEN_INST_MSB 23       
+#define     VLEN_INST_LSB  0 /* 24  number of elements or register index */
+
 /* BIT-FIELD second instruction */
 #define   BITFMSB_INST_MSB 15       
 #define   BITFMSB_INST_LSB  8 /* 8   MSB 0..31 */
@@ -327,9 +343,20 @@
 #define OPAR_RDBF        20 // DST = SRC1 | LEN POS |     read a bit-field
 #define OPAR_SWAP        21 // - SRC1-- - SRC2-- - swap r2 r3                Swap registers
 #define OPAR_BSWAP       22 // - SRC1-- - SRC2-- - byteswap r2 r3 XX         Byte swap ABCD->BADC / DCBA / BitReverse
-#define OPAR_SQRT        23 // - DST -- - SRC1--   r2 = sqrt r3         invsqrt r3
-#define OPAR_LOG10       24 // - DST -- - SRC1--   r2 = log10 r3/r4     20xlog10 r3/r4
+#define OPAR_SQRT        23 // - DST -- - SRC1--   r2 = sqrt r3         invsqrt r3         SRC2 = FUNC_SQRT/INVSQRT
+#define OPAR_LOG10       24 // - DST -- - SRC1--   r2 = log10 r3        20xlog10 r3 ..     SRC2 = FUNC_xx (list below)
 #define OPAR_ABS         25 // - DST -- - SRC1--   r2 = abs r3
+
+// vector operations on pointer/length pairs, executed with native loops (pointers to the heap, 
+//  the parameters, or to the arc buffer with PTR_MEMBANK_ARC), the vector length is in the extension word
+#define OPAR_VCOPY        3 // DST[] = SRC1[]              copy with conversion to the DST type
+#define OPAR_VADD         6 // DST[] = SRC1[] + SRC2[]     
+#define OPAR_VMUL        26 // DST[] = SRC1[] * SRC2[]     fractional product for integers (Q7 Q15 Q31)
+#define OPAR_VMAC        27 // DST[] += SRC1[] * SRC2[]    
+#define OPAR_VMAX        28 // DST[] = max(SRC1[], SRC2[]) 
+#define OPAR_VMIN        29 // DST[] = min(SRC1[], SRC2[]) 
+#define OPAR_VSUMSQ      30 // DST = sum(SRC1[]^2)        DST is a register (energy of a frame)
+#define OPAR_VSCALE      31 // DST[] = SRC1[] * SRC2       SRC2 is a register (gain Q31 or fp32)
 // SIN COS TAN ASIN ACOS ATAN, exp 10^x ln log, round up/down to 3 decimal, PI sqrt(2) sqrt(0.5), is_even/odd, 
 // forced in this range (min/max), rescale y=ax+b, random integer in this range, toggle bit, little/big endian
 // convert to int/float
@@ -337,6 +364,41 @@
 
 #define OPAR_NONE        32  
 
+/* unary functions of OPAR_SQRT and OPAR_LOG10, the code is in the SRC2 field (not a register) 
+    the computation is made in fp32, the result is fp16 when the operand is fp16 */
+#define FUNC_SQRT         0 // OPAR_SQRT  sqrt(x), 0 for x <= 0
+#define FUNC_INVSQRT      1 // OPAR_SQRT  1/sqrt(x)
+#define FUNC_LOG10        0 // OPAR_LOG10 log10(x)
+#define FUNC_DB20         1 //            20 log10(x)   amplitude to dB
+#define FUNC_DB10         2 //            10 log10(x)   power to dB
+#define FUNC_LN           3 //            ln(x)
+#define FUNC_LOG2         4 //            log2(x)
+#define FUNC_EXP          5 //            e^x
+#define FUNC_EXP10        6 //            10^x
+#define FUNC_DB2LIN       7 //            10^(x/20)     dB to amplitude
+#define FUNC_SIN          8 //            sin(x)
+#define FUNC_COS          9 //            cos(x)
+#define FUNC_TANH        10 //            tanh(x)
+#define FUNC_ATAN        11 //            atan(x)
+#define FUNC_RECIP       12 //            1/x
+#define FUNC_I2F         13 //            int32 to fp32
+#define FUNC_F2I         14 //            fp32/fp16 to int32, rounded to nearest
+#define FUNC_F2H         15 //            fp32 to fp16
+#define FUNC_H2F         16 //            fp16 to fp32
+
+/* 
+    COST of the scalar instructions, in units of one integer instruction of the interpreter (the 
+    decoding overhead dominates the arithmetic). The cycle budget of the script (cycles_downcounter) 
+    is decremented by these costs. The fp16 operations are computed in fp32 with two conversions.
+*/
+#define SCRIPT_COST_INT         1   // integer tests and ALU, jumps, moves
+#define SCRIPT_COST_FP32        1   // fp32 + - * max min abs, tests, conversions
+#define SCRIPT_COST_FP32_DIV    2   // fp32 / % 1/x
+#define SCRIPT_COST_FP16        1   // added to the fp32 cost with fp16 operands
+#define SCRIPT_COST_SQRT        3   // sqrt 1/sqrt
+#define SCRIPT_COST_LOG_EXP     4   // log10 ln log2 dB exp 10^x
+#define SCRIPT_COST_TRIGO       5   // sin cos tanh atan
+
 /*----------------------------------------OP_SETJUMP-------------------------------------------------------*/
 
 #define OPLJ_SETREG       0 // setreg 
@@ -373,7 +435,7 @@
 #define DTYPE_UINT64   8  /* u64 last integer type */
 #define DTYPE_FP8_E4M3 9  /* fp8 reserved */
 #define DTYPE_FP8_E5M2 10 /* fp8 reserved */
-#define DTYPE_FP16     11 /* fp16 reserved */
+#define DTYPE_FP16     11 /* fp16 */
 #define DTYPE_FP32     12 /* fp32 */
 #define DTYPE_FP64     13 /* fp64 reserved */
 #define DTYPE_PTR28B   14 /* pointer with software MMU */
@@ -43,6 +43,7 @@
 #include "stream_common_types.h"
 #include "arm_stream_script.h"
 #include "arm_stream_script_instructions.h"
+#include "stream_extern.h"      // pack2lin
 
 static void arithmetic_operation(arm_script_instance_t* I, uint8_t opcode, uint8_t opar, uint8_t *t, int32_t *dst, int32_t src1, int32_t src2);
 static void test_and_arithmetic_operation(arm_script_instance_t *I);
@@ -833,6 +834,829 @@ static void test_and_arithmetic_and_save (arm_script_instance_t *I, uint8_t id0,
 #endif
 }
 
+/* ---------------------------------------------------------------------------------------------
+    VECTOR INSTRUCTIONS 
+        operands are pointer registers, the length is given in the extension word
+        integers are fractional (Q7, Q15, Q31), the generic path converts the data to Q31 or fp32
+*/
+#define SAT32(x) (int32_t)MIN(MAX((x), (int64_t)INT32_MIN), (int64_t)INT32_MAX)
+#define SAT16(x) (int16_t)MIN(MAX((x), INT16_MIN), INT16_MAX)
+
+/**
+  @brief  address of the data pointed by a pointer register, and the number of bytes up to 
+          the end of the memory bank (arc buffer, heap, parameters)
+*/
+static uint8_t * vector_address (arm_script_instance_t *I, uint8_t regID, uint8_t *dtype, uint32_t *nbytes)
+{
+    uint32_t type, offset, *arc, size;
+    uintptr_t long_base;
+    uint8_t *base;
+
+    if (regID >= RegNoneK)
+    {   return 0;
+    }
+    type = (uint32_t)(I->REGS[regID].v_i32[REGS_TYPE]);
+    offset = (uint32_t)(I->REGS[regID].v_i32[REGS_DATA]);
+
+    if (0 == RD(type, PTR1_REGS0))
+    {   return 0;
+    }
+    *dtype = (uint8_t)RD(type, DTYPE_PTR);
+
+    switch (RD(type, PTRH_PTR))
+    {
+    case PTR_MEMBANK_ABS:                               /* no size information */
+        base = 0;
+        size = 0xFFFFFFFFu;
+        break;
+    case PTR_MEMBANK_PARAM: 
+    case PTR_MEMBANK_GRAPH: 
+        base = (uint8_t *)&(I->byte_code[I->codes]);
+        size = 4u * I->params;
+        break;
+    case PTR_MEMBANK_HEAP:  
+        base = (uint8_t *)&(I->REGS[I->nregs + I->nstack]);
+        size = 4u * I->heap;
+        break;
+    case PTR_MEMBANK_ARC:                               /* BASE_PTR = arc index */
+        arc = &(I->S->all_arcs[SIZEOF_ARCDESC_W32 * RD(type, BASE_PTR)]);
+        pack2lin(&long_base, arc[BUF_PTR_ARCW0], I->S->long_offset);
+        base = (uint8_t *)long_base + RD(arc[RDFLOW_ARCW2], READ_ARCW2);
+        size = RD(arc[BUFSIZE_ARCW1], BUFF_SIZE_ARCW1);
+        size = (size > RD(arc[RDFLOW_ARCW2], READ_ARCW2)) ? size - RD(arc[RDFLOW_ARCW2], READ_ARCW2) : 0;
+        break;
+    default: 
+        return 0;
+    }
+    *nbytes = (size > offset) ? size - offset : 0;
+    return base + offset;
+}
+
+/**
+  @brief  number of elements limited to the size of the memory bank
+*/
+static uint32_t vector_clamp (uint32_t n, uint32_t nbytes, uint8_t dtype)
+{
+    uint32_t nmax;
+
+    switch (dtype)
+    {
+    case DTYPE_INT8:  nmax = nbytes; break;
+    case DTYPE_INT16: nmax = nbytes / 2; break;
+    default:          nmax = nbytes / 4; break;
+    }
+    return MIN(n, nmax);
+}
+
+/**
+  @brief  generic path : data converted to Q31 
+*/
+static int32_t vector_load_q31 (uint8_t *p, uint8_t dtype, uint32_t i)
+{
+    switch (dtype)
+    {
+    case DTYPE_INT8:  return (int32_t)(U(((int8_t *)p)[i]) << 24);
+    case DTYPE_INT16: return (int32_t)(U(((int16_t *)p)[i]) << 16);
+    default:
+    case DTYPE_INT32: return ((int32_t *)p)[i];
+#if STREAM_FLOAT_ALLOWED==1
+    case DTYPE_FP32:  return SAT32((int64_t)(((float *)p)[i] * 2147483648.0f));
+#endif
+    }
+}
+
+static void vector_store_q31 (uint8_t *p, uint8_t dtype, uint32_t i, int32_t x)
+{
+    switch (dtype)
+    {
+    case DTYPE_INT8:  ((int8_t *)p)[i] = (int8_t)(x >> 24); break;
+    case DTYPE_INT16: ((int16_t *)p)[i] = (int16_t)(x >> 16); break;
+    default:
+    case DTYPE_INT32: ((int32_t *)p)[i] = x; break;
+#if STREAM_FLOAT_ALLOWED==1
+    case DTYPE_FP32:  ((float *)p)[i] = (float)x * (1.0f / 2147483648.0f); break;
+#endif
+    }
+}
+
+static int32_t vector_op_q31 (uint8_t opar, int32_t d, int32_t a, int32_t b)
+{
+    switch (opar)
+    {
+    default:
+    case OPAR_VCOPY:  return a;
+    case OPAR_VADD:   return SAT32((int64_t)a + b);
+    case OPAR_VSCALE:
+    case OPAR_VMUL:   return SAT32(((int64_t)a * b) >> 31);
+    case OPAR_VMAC:   return SAT32((int64_t)d + (((int64_t)a * b) >> 31));
+    case OPAR_VMAX:   return MAX(a, b);
+    case OPAR_VMIN:   return MIN(a, b);
+    }
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static float vector_load_f32 (uint8_t *p, uint8_t dtype, uint32_t i)
+{
+    if (dtype == DTYPE_FP32) 
+    {   return ((float *)p)[i];
+    }
+    return (float)vector_load_q31(p, dtype, i) * (1.0f / 2147483648.0f);
+}
+
+static float vector_gain_f32 (arm_script_instance_t *I, uint8_t regID, int32_t gain_q31)
+{
+    if (regID < RegNoneK && RD(I->REGS[regID].v_i32[REGS_TYPE], DTYPE_PTR) == DTYPE_FP32)
+    {   return I->REGS[regID].v_f32[REGS_DATA];
+    }
+    return (float)gain_q31 * (1.0f / 2147483648.0f);
+}
+
+static float vector_op_f32 (uint8_t opar, float d, float a, float b)
+{
+    switch (opar)
+    {
+    default:
+    case OPAR_VCOPY:  return a;
+    case OPAR_VADD:   return a + b;
+    case OPAR_VSCALE:
+    case OPAR_VMUL:   return a * b;
+    case OPAR_VMAC:   return d + a * b;
+    case OPAR_VMAX:   return MAX(a, b);
+    case OPAR_VMIN:   return MIN(a, b);
+    }
+}
+#endif
+
+/**
+  @brief  vector instructions : DST[] = SRC1[] OPAR SRC2[] on N elements
+          fast loops when the types are identical (int16 and fp32), else a generic loop with 
+          conversions 
+*/
+static void vector_operation (arm_script_instance_t *I, uint8_t opar, uint8_t db0, uint8_t db1, uint8_t db2)
+{
+    uint8_t *pd, *pa, *pb, td, ta, tb;
+    uint32_t i, n, vlen, nbytes;
+    int32_t gain_q31;
+
+    vlen = I->byte_code[I->PC++];                           /* length in the extension word */
+    if (RD(vlen, VLENREG_INST))
+    {   if ((RD(vlen, VLEN_INST) & 0xF) >= RegNoneK)        /* R0 .. R13 only */
+        {   I->errors |= ERROR_VECTOR_FORMAT;
+            return;
+        }
+        n = (uint32_t)(I->REGS[RD(vlen, VLEN_INST) & 0xF].v_i32[REGS_DATA]);
+    } 
+    else
+    {   n = RD(vlen, VLEN_INST);
+    }
+
+    db0 = (uint8_t)RD(db0, REG_INDEX);
+    db1 = (uint8_t)RD(db1, REG_INDEX);
+    db2 = (uint8_t)RD(db2, REG_INDEX);
+    if (db0 >= RegNoneK || db1 >= RegNoneK || (opar == OPAR_VSCALE && db2 >= RegNoneK))
+    {   I->errors |= ERROR_VECTOR_FORMAT;
+        return;
+    }
+    pa = vector_address(I, db1, &ta, &nbytes);
+    if (pa == 0)
+    {   I->errors |= ERROR_VECTOR_FORMAT;
+        return;
+    }
+    n = vector_clamp(n, nbytes, ta);
+
+    /* ---------------------------------------- DST = sum (SRC1[]^2) */
+    if (opar == OPAR_VSUMSQ)
+    {   
+#if STREAM_FLOAT_ALLOWED==1
+        if (ta == DTYPE_FP32)
+        {   float *x = (float *)pa, acc = 0;
+            for (i = 0; i < n; i++) { acc += x[i] * x[i]; }
+            I->REGS[db0].v_f32[REGS_DATA] = acc;
+            I->REGS[db0].v_i32[REGS_TYPE] = DTYPE_FP32;
+            return;
+        }
+#endif
+        {   int64_t acc = 0; 
+            if (ta == DTYPE_INT16)
+            {   int16_t *x = (int16_t *)pa;
+                for (i = 0; i < n; i++) { acc += (int32_t)x[i] * x[i]; }    /* Q30 */
+                acc = acc << 1;
+            }
+            else
+            {   for (i = 0; i < n; i++) 
+                {   int32_t x = vector_load_q31(pa, ta, i);
+                    acc += ((int64_t)x * x) >> 31;
+                }
+            }
+            I->REGS[db0].v_i32[REGS_DATA] = SAT32(acc);                     /* Q31 */
+            I->REGS[db0].v_i32[REGS_TYPE] = DTYPE_INT32;
+        }
+        return;
+    }
+
+    pd = vector_address(I, db0, &td, &nbytes);
+    if (pd == 0)
+    {   I->errors |= ERROR_VECTOR_FORMAT;
+        return;
+    }
+    n = vector_clamp(n, nbytes, td);
+
+    /* the second operand is a scalar register (VSCALE) or absent (VCOPY) */
+    if (opar == OPAR_VSCALE || opar == OPAR_VCOPY)
+    {   pb = 0; tb = ta;
+    }
+    else
+    {   pb = vector_address(I, db2, &tb, &nbytes);
+        if (pb == 0)
+        {   I->errors |= ERROR_VECTOR_FORMAT;
+            return;
+        }
+        n = vector_clamp(n, nbytes, tb);
+    }
+
+    /* the gain of VSCALE is an integer Q31 or a fp32 register */
+    gain_q31 = (db2 < RegNoneK) ? I->REGS[db2].v_i32[REGS_DATA] : 0;
+#if STREAM_FLOAT_ALLOWED==1
+    if (opar == OPAR_VSCALE && RD(I->REGS[db2].v_i32[REGS_TYPE], DTYPE_PTR) == DTYPE_FP32)
+    {   gain_q31 = SAT32((int64_t)(I->REGS[db2].v_f32[REGS_DATA] * 2147483648.0f));
+    }
+#endif
+
+    /* ---------------------------------------- int16 fast loops */
+    if (td == DTYPE_INT16 && ta == DTYPE_INT16 && tb == DTYPE_INT16)
+    {   int16_t *d = (int16_t *)pd, *a = (int16_t *)pa, *b = (int16_t *)pb;
+        switch (opar)
+        {
+        case OPAR_VCOPY:  MEMCPY(pd, pa, n * sizeof(int16_t)); break;
+        case OPAR_VADD:   for (i = 0; i < n; i++) { d[i] = SAT16((int32_t)a[i] + b[i]); } break;
+        case OPAR_VMUL:   for (i = 0; i < n; i++) { d[i] = SAT16(((int32_t)a[i] * b[i]) >> 15); } break;
+        case OPAR_VMAC:   for (i = 0; i < n; i++) { d[i] = SAT16(d[i] + (((int32_t)a[i] * b[i]) >> 15)); } break;
+        case OPAR_VMAX:   for (i = 0; i < n; i++) { d[i] = MAX(a[i], b[i]); } break;
+        case OPAR_VMIN:   for (i = 0; i < n; i++) { d[i] = MIN(a[i], b[i]); } break;
+        case OPAR_VSCALE: for (i = 0; i < n; i++) { d[i] = (int16_t)SAT16(((int64_t)a[i] * gain_q31) >> 31); } break;
+        }
+        return;
+    }
+
+#if STREAM_FLOAT_ALLOWED==1
+    /* ---------------------------------------- fp32 fast loops */
+    if (td == DTYPE_FP32 && ta == DTYPE_FP32 && tb == DTYPE_FP32)
+    {   float *d = (float *)pd, *a = (float *)pa, *b = (float *)pb, g = vector_gain_f32(I, db2, gain_q31);
+        switch (opar)
+        {
+        case OPAR_VCOPY:  MEMCPY(pd, pa, n * sizeof(float)); break;
+        case OPAR_VADD:   for (i = 0; i < n; i++) { d[i] = a[i] + b[i]; } break;
+        case OPAR_VMUL:   for (i = 0; i < n; i++) { d[i] = a[i] * b[i]; } break;
+        case OPAR_VMAC:   for (i = 0; i < n; i++) { d[i] += a[i] * b[i]; } break;
+        case OPAR_VMAX:   for (i = 0; i < n; i++) { d[i] = MAX(a[i], b[i]); } break;
+        case OPAR_VMIN:   for (i = 0; i < n; i++) { d[i] = MIN(a[i], b[i]); } break;
+        case OPAR_VSCALE: for (i = 0; i < n; i++) { d[i] = a[i] * g; } break;
+        }
+        return;
+    }
+
+    /* ---------------------------------------- mixed types with a float : computation in fp32 */
+    if (td == DTYPE_FP32 || ta == DTYPE_FP32 || tb == DTYPE_FP32)
+    {   float g = vector_gain_f32(I, db2, gain_q31), x;
+        for (i = 0; i < n; i++)
+        {   x = vector_op_f32(opar, 
+                    (opar == OPAR_VMAC) ? vector_load_f32(pd, td, i) : 0, 
+                    vector_load_f32(pa, ta, i), 
+                    (pb == 0) ? g : vector_load_f32(pb, tb, i));
+            if (td == DTYPE_FP32) 
+            {   ((float *)pd)[i] = x;
+            }
+            else
+            {   vector_store_q31(pd, td, i, SAT32((int64_t)(x * 2147483648.0f)));
+            }
+        }
+        return;
+    }
+#endif
+
+    /* ---------------------------------------- generic integer loop in Q31 */
+    for (i = 0; i < n; i++)
+    {   vector_store_q31(pd, td, i, vector_op_q31(opar, 
+                (opar == OPAR_VMAC) ? vector_load_q31(pd, td, i) : 0, 
+                vector_load_q31(pa, ta, i), 
+                (pb == 0) ? gain_q31 : vector_load_q31(pb, tb, i)));
+    }
+}
+
+
+/* ---------------------------------------------------------------------------------------------
+    SCALAR INSTRUCTIONS ON REGISTERS, CONSTANTS AND STACK 
+        integer, fp32 and fp16 (the type is in REGS_TYPE), the operations are made in fp32 
+        when one of the operands is a float
+*/
+typedef struct 
+{   int32_t i;
+#if STREAM_FLOAT_ALLOWED==1
+    float f;
+#endif
+    uint8_t dtype;                  /* DTYPE_INT32, DTYPE_FP32, DTYPE_FP16 */
+    uint8_t constant;               /* constants take the precision of the other operand */
+} script_value_t;
+
+#define SCALAR_IS_FLOAT(v) ((v)->dtype == DTYPE_FP32 || (v)->dtype == DTYPE_FP16)
+
+#if STREAM_FLOAT_ALLOWED==1
+typedef union { float f; uint32_t u; int32_t i; } script_f32_t;
+
+/**
+  @brief  IEEE-754 half precision conversions, with the hardware when the compiler has __fp16
+*/
+static float fp16_to_f32 (uint16_t h)
+{
+#ifdef __ARM_FP16_FORMAT_IEEE
+    __fp16 x;
+    MEMCPY((uint8_t *)&x, (uint8_t *)&h, sizeof(x));
+    return (float)x;
+#else
+    script_f32_t x;
+    uint32_t e = (h >> 10) & 0x1F, m = h & 0x3FF;
+
+    if (e == 0)                                     /* zero and subnormals : m x 2^-24 */
+    {   x.f = (float)m * (1.0f / 16777216.0f);
+        x.u |= (uint32_t)(h & 0x8000) << 16;
+        return x.f;
+    }
+    if (e == 31)                                    /* infinity and NaN */
+    {   x.u = ((uint32_t)(h & 0x8000) << 16) | 0x7F800000 | (m << 13);
+        return x.f;
+    }
+    x.u = ((uint32_t)(h & 0x8000) << 16) | ((e - 15 + 127) << 23) | (m << 13);
+    return x.f;
+#endif
+}
+
+static uint16_t f32_to_fp16 (float f)
+{
+#ifdef __ARM_FP16_FORMAT_IEEE
+    __fp16 x = (__fp16)f;
+    uint16_t h;
+    MEMCPY((uint8_t *)&h, (uint8_t *)&x, sizeof(h));
+    return h;
+#else
+    script_f32_t x;
+    uint32_t sign, m, h, rem, half, shift;
+    int32_t e;
+
+    x.f = f;
+    sign = (x.u >> 16) & 0x8000;
+    e = (int32_t)((x.u >> 23) & 0xFF) - 127 + 15;
+    m = x.u & 0x7FFFFF;
+
+    if ((x.u & 0x7FFFFFFF) > 0x7F800000) return (uint16_t)(sign | 0x7E00);     /* NaN */
+    if (e >= 31) return (uint16_t)(sign | 0x7C00);                              /* overflow */
+    if (e <= 0)                                                                 /* subnormal */
+    {   if (e < -10) return (uint16_t)sign;
+        m |= 0x800000;
+        shift = (uint32_t)(14 - e);
+        h = m >> shift;
+        rem = m & ((1u << shift) - 1);
+        half = 1u << (shift - 1);
+    }
+    else
+    {   h = ((uint32_t)e << 10) | (m >> 13);
+        rem = m & 0x1FFF;
+        half = 0x1000;
+    }
+    if (rem > half || (rem == half && (h & 1)))     /* round to nearest even, the carry can reach infinity */
+    {   h++;
+    }
+    return (uint16_t)(sign | h);
+#endif
+}
+
+/**
+  @brief  approximations of the transcendental functions, fp32 accuracy (polynomials of the Cephes library)
+*/
+#define SCRIPT_LN2     0.693147180f
+#define SCRIPT_PI      3.141592654f
+
+static float script_invsqrt (float x)
+{   script_f32_t y;
+    float h;
+
+    if (x <= 0) return 0;
+    y.f = x;
+    y.u = 0x5F3759DF - (y.u >> 1);
+    h = 0.5f * x;
+    y.f = y.f * (1.5f - h * y.f * y.f);             /* Newton iterations */
+    y.f = y.f * (1.5f - h * y.f * y.f);
+    y.f = y.f * (1.5f - h * y.f * y.f);
+    return y.f;
+}
+
+static float script_ln (float x)
+{   script_f32_t y;
+    float z, p;
+    int32_t e;
+
+    if (x <= 0) return -87.3f;                      /* ln(1.2e-38) */
+    y.f = x;
+    e = (int32_t)((y.u >> 23) & 0xFF) - 126;
+    y.u = (y.u & 0x807FFFFF) | 0x3F000000;          /* mantissa in [0.5 1[ */
+    if (y.f < 0.707106781f) { e--; y.f = y.f + y.f - 1.0f; } 
+    else                    { y.f = y.f - 1.0f; }
+    x = y.f;
+    z = x * x;
+    p = 7.0376836292e-2f;
+    p = p * x - 1.1514610310e-1f;
+    p = p * x + 1.1676998740e-1f;
+    p = p * x - 1.2420140846e-1f;
+    p = p * x + 1.4249322787e-1f;
+    p = p * x - 1.6668057665e-1f;
+    p = p * x + 2.0000714765e-1f;
+    p = p * x - 2.4999993993e-1f;
+    p = p * x + 3.3333331174e-1f;
+    return x + (x * z * p - 0.5f * z) + (float)e * SCRIPT_LN2;
+}
+
+static float script_exp (float x)
+{   script_f32_t y;
+    float p;
+    int32_t n;
+
+    if (x > 88.0f) x = 88.0f;
+    if (x < -87.0f) return 0;
+    n = (int32_t)(x * 1.442695041f + ((x < 0) ? -0.5f : 0.5f));
+    x = x - (float)n * 0.693359375f + (float)n * 2.12194440e-4f;
+    p = 1.9875691500e-4f;
+    p = p * x + 1.3981999507e-3f;
+    p = p * x + 8.3334519073e-3f;
+    p = p * x + 4.1665795894e-2f;
+    p = p * x + 1.6666665459e-1f;
+    p = p * x + 5.0000001201e-1f;
+    p = p * x * x + x + 1.0f;
+    y.u = (uint32_t)(n + 127) << 23;                /* 2^n */
+    return p * y.f;
+}
+
+/* sin(x) (sin0cos1 = 0) or cos(x) (sin0cos1 = 1) */
+static float script_sincos (float x, uint8_t sin0cos1)
+{   float z, r;
+    int32_t q;
+
+    q = (int32_t)(x * (2.0f / SCRIPT_PI) + ((x < 0) ? -0.5f : 0.5f));  /* quadrant */
+    x = x - (float)q * 1.570796327f;                                     /* |x| <= pi/4 */
+    q = (q + sin0cos1) & 3;
+    z = x * x;
+    if (q & 1)
+    {   r = 1.0f - 0.5f * z + z * z * ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f);
+    }
+    else
+    {   r = x + x * z * ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f);
+    }
+    return (q & 2) ? -r : r;
+}
+
+static float script_atan (float x)
+{   float y0, z, s;
+
+    s = (x < 0) ? -1.0f : 1.0f;
+    x = FABS(x);
+    if (x > 2.414213562f)      { y0 = 0.5f * SCRIPT_PI;  x = -1.0f / x; }
+    else if (x > 0.414213562f) { y0 = 0.25f * SCRIPT_PI; x = (x - 1.0f) / (x + 1.0f); }
+    else                       { y0 = 0; }
+    z = x * x;
+    y0 += (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * x + x;
+    return s * y0;
+}
+
+static float script_function (uint8_t opar, uint8_t code, float x)
+{   float y;
+
+    if (opar == OPAR_SQRT)
+    {   y = script_invsqrt(x);
+        return (code == FUNC_INVSQRT) ? y : x * y;
+    }
+    switch (code)
+    {
+    default:
+    case FUNC_LOG10:  return script_ln(x) * 0.434294482f;
+    case FUNC_DB20:   return script_ln(x) * 8.685889638f;
+    case FUNC_DB10:   return script_ln(x) * 4.342944819f;
+    case FUNC_LN:     return script_ln(x);
+    case FUNC_LOG2:   return script_ln(x) * 1.442695041f;
+    case FUNC_EXP:    return script_exp(x);
+    case FUNC_EXP10:  return script_exp(x * 2.302585093f);
+    case FUNC_DB2LIN: return script_exp(x * 0.115129255f);
+    case FUNC_SIN:    return script_sincos(x, 0);
+    case FUNC_COS:    return script_sincos(x, 1);
+    case FUNC_TANH:   if (FABS(x) > 9.0f) { return (x > 0) ? 1.0f : -1.0f; }
+                      return 1.0f - 2.0f / (script_exp(x + x) + 1.0f);
+    case FUNC_ATAN:   return script_atan(x);
+    case FUNC_RECIP:  FDIV(y, 1.0f, x); return y;
+    }
+}
+#endif
+
+/**
+  @brief  the operand is a register (not a pointer), a constant, the null register or the stack 
+*/
+static uint8_t scalar_format (arm_script_instance_t *I, uint8_t field, uint8_t R0W1)
+{   uint8_t reg = (uint8_t)RD(field, REG_INDEX), ab = (uint8_t)RD(field, AB_FIELD), c = (uint8_t)RD(field, C_FIELD);
+
+    if (reg < RegNoneK)
+    {   return (ab == 0 && c == 0 && 0 == RD(I->REGS[reg].v_i32[REGS_TYPE], PTR1_REGS0));
+    }
+    if (reg == RegNoneK)
+    {   return (R0W1 == 0 && c == 0 && ab != 1);
+    }
+    return (ab == 0 || (ab == 3 && c == 0));            /* top, pop/push, stack[K] */
+}
+
+/**
+  @brief  address of the register or stack element, the extension words are read from SRC2 to SRC0
+*/
+static regdata_t * scalar_register (arm_script_instance_t *I, uint8_t field, uint8_t R0W1)
+{   uint8_t reg = (uint8_t)RD(field, REG_INDEX), ab = (uint8_t)RD(field, AB_FIELD), c = (uint8_t)RD(field, C_FIELD);
+    uint32_t K;
+
+    if (reg < RegNoneK)
+    {   return &(I->REGS[reg]);
+    }
+    if (ab == 3)                                        /* stack[K] from the top */
+    {   K = I->byte_code[I->PC++];
+        if (I->SP < I->nregs + 1 + K)
+        {   I->errors |= ERROR_STACK_UNDERFLOW;
+            return 0;
+        }
+        return &(I->REGS[I->SP - 1 - K]);
+    }
+    if (c == 0)                                         /* top of stack */
+    {   if (I->SP <= I->nregs)
+        {   I->errors |= ERROR_STACK_UNDERFLOW;
+            return 0;
+        }
+        return &(I->REGS[I->SP - 1]);
+    }
+    if (R0W1 == 0)                                      /* pop */
+    {   if (I->SP <= I->nregs)
+        {   I->errors |= ERROR_STACK_UNDERFLOW;
+            return 0;
+        }
+        return &(I->REGS[--(I->SP)]);
+    }
+    if (I->SP >= I->nregs + I->nstack)                  /* push */
+    {   I->errors |= ERROR_STACK_OVERFLOW;
+        return 0;
+    }
+    return &(I->REGS[(I->SP)++]);
+}
+
+static uint8_t scalar_read (arm_script_instance_t *I, uint8_t field, script_value_t *v)
+{   regdata_t *R;
+#if STREAM_FLOAT_ALLOWED==1
+    uint8_t dtype;
+#endif
+
+    v->i = 0; v->dtype = DTYPE_INT32; v->constant = 0;
+
+    if (RD(field, REG_INDEX) == RegNoneK)               /* null register and constants */
+    {   v->constant = 1;
+        if (RD(field, AB_FIELD) == K_INT32) 
+        {   v->i = (int32_t)(I->byte_code[I->PC++]);
+        }
+        if (RD(field, AB_FIELD) == K_FP32) 
+        {   v->i = (int32_t)(I->byte_code[I->PC++]);
+#if STREAM_FLOAT_ALLOWED==1
+            {   script_f32_t x; x.i = v->i; v->f = x.f; }
+            v->dtype = DTYPE_FP32;
+#endif
+        }
+        return 1;
+    }
+
+    if (0 == (R = scalar_register(I, field, 0)))
+    {   return 0;
+    }
+    v->i = R->v_i32[REGS_DATA];
+#if STREAM_FLOAT_ALLOWED==1
+    dtype = (uint8_t)RD(R->v_i32[REGS_TYPE], DTYPE_PTR);
+    if (dtype == DTYPE_FP32) 
+    {   v->f = R->v_f32[REGS_DATA]; v->dtype = DTYPE_FP32;
+    }
+    if (dtype == DTYPE_FP16) 
+    {   v->f = fp16_to_f32((uint16_t)(v->i)); v->dtype = DTYPE_FP16;
+    }
+#endif
+    return 1;
+}
+
+static uint8_t scalar_write (arm_script_instance_t *I, uint8_t field, script_value_t *v)
+{   regdata_t *R;
+
+    if (0 == (R = scalar_register(I, field, 1)))
+    {   return 0;
+    }
+#if STREAM_FLOAT_ALLOWED==1
+    if (v->dtype == DTYPE_FP32) 
+    {   R->v_f32[REGS_DATA] = v->f; R->v_i32[REGS_TYPE] = DTYPE_FP32;
+        return 1;
+    }
+    if (v->dtype == DTYPE_FP16) 
+    {   R->v_i32[REGS_DATA] = f32_to_fp16(v->f); R->v_i32[REGS_TYPE] = DTYPE_FP16;
+        return 1;
+    }
+#endif
+    R->v_i32[REGS_DATA] = v->i; R->v_i32[REGS_TYPE] = DTYPE_INT32;
+    return 1;
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+/* float value of an integer operand */
+static void scalar_to_float (script_value_t *v)
+{   if (0 == SCALAR_IS_FLOAT(v)) 
+    {   v->f = (float)(v->i); 
+    }
+}
+#endif
+
+/**
+  @brief  r = a OPAR b, returns the cost of the operation or 0 when the operator is not a scalar one
+*/
+static uint8_t scalar_compute (uint8_t opar, uint8_t code, script_value_t *a, script_value_t *b, script_value_t *r)
+{   int32_t x = a->i, y = b->i;
+
+#if STREAM_FLOAT_ALLOWED==1
+    uint8_t cost;
+
+    /* unary functions computed in fp32 */
+    if (opar == OPAR_SQRT || opar == OPAR_LOG10)
+    {   scalar_to_float(a);
+        r->dtype = (a->dtype == DTYPE_FP16) ? DTYPE_FP16 : DTYPE_FP32;
+        cost = (uint8_t)((a->dtype == DTYPE_FP16) ? SCRIPT_COST_FP16 : 0);
+
+        if (opar == OPAR_LOG10 && code >= FUNC_I2F)             /* conversions */
+        {   switch (code)
+            {
+            default:
+            case FUNC_I2F: r->dtype = DTYPE_FP32; r->f = a->f; break;
+            case FUNC_H2F: r->dtype = DTYPE_FP32; r->f = a->f; break;
+            case FUNC_F2H: r->dtype = DTYPE_FP16; r->f = a->f; break;
+            case FUNC_F2I: r->dtype = DTYPE_INT32; 
+                r->i = (a->dtype == DTYPE_INT32) ? a->i : (int32_t)(a->f + ((a->f < 0) ? -0.5f : 0.5f)); break;
+            }
+            return (uint8_t)(cost + SCRIPT_COST_FP32);
+        }
+        r->f = script_function(opar, code, a->f);
+        if (opar == OPAR_SQRT)                  return (uint8_t)(cost + SCRIPT_COST_SQRT);
+        if (code == FUNC_RECIP)                 return (uint8_t)(cost + SCRIPT_COST_FP32_DIV);
+        if (code >= FUNC_SIN)                   return (uint8_t)(cost + SCRIPT_COST_TRIGO);
+        return (uint8_t)(cost + SCRIPT_COST_LOG_EXP);
+    }
+
+    /* float operators, the result is fp16 when there is no fp32 register operand */
+    if ((SCALAR_IS_FLOAT(a) || SCALAR_IS_FLOAT(b)) && 
+        opar != OPAR_LRSHFT && opar != OPAR_OR && opar != OPAR_NOR && opar != OPAR_AND && opar != OPAR_XOR)
+    {   float s1, s2, t;
+
+        if (opar == OPAR_NOP)                                   /* move : keep the type */
+        {   *r = *a;
+            return SCRIPT_COST_FP32;
+        }
+        scalar_to_float(a); 
+        scalar_to_float(b);
+        s1 = a->f; s2 = b->f; t = 0;
+        r->dtype = DTYPE_FP32;
+        if ((a->dtype == DTYPE_FP16 || b->dtype == DTYPE_FP16) &&
+            (a->dtype != DTYPE_FP32 || a->constant) && (b->dtype != DTYPE_FP32 || b->constant))
+        {   r->dtype = DTYPE_FP16;
+        }
+        cost = (uint8_t)((r->dtype == DTYPE_FP16) ? SCRIPT_COST_FP16 + SCRIPT_COST_FP32 : SCRIPT_COST_FP32);
+
+        switch (opar)
+        {
+        case OPAR_ADD: FADD(t, s1, s2); break;
+        case OPAR_SUB: FSUB(t, s1, s2); break;
+        case OPAR_MUL: FMUL(t, s1, s2); break;
+        case OPAR_DIV: FDIV(t, s1, s2); cost++; break;
+        case OPAR_MOD: FDIV(t, s1, s2); t = (s2 == 0) ? 0 : s1 - s2 * (float)(int32_t)t; cost++; break;
+        case OPAR_MAX: FMAX(t, s2, s1); break;
+        case OPAR_MIN: FMIN(t, s2, s1); break;
+        case OPAR_ABS: t = FABS(s1); break;
+        default: return 0;
+        }
+        r->f = t;
+        return cost;
+    }
+
+    /* bit operators on floats are made on integers */
+    if (SCALAR_IS_FLOAT(a)) { x = (int32_t)(a->f); }
+    if (SCALAR_IS_FLOAT(b)) { y = (int32_t)(b->f); }
+#else
+    (void)code;
+    if (opar == OPAR_SQRT || opar == OPAR_LOG10) 
+    {   return 0;
+    }
+#endif
+
+    r->dtype = DTYPE_INT32;
+    switch (opar)
+    {
+    case OPAR_NOP:    r->i = x; break;
+    case OPAR_ADD:    r->i = (int32_t)((uint32_t)x + (uint32_t)y); break;
+    case OPAR_SUB:    r->i = (int32_t)((uint32_t)x - (uint32_t)y); break;
+    case OPAR_MUL:    r->i = (int32_t)((uint32_t)x * (uint32_t)y); break;
+    case OPAR_DIV:    r->i = (y == 0) ? 0 : x / y; break;
+    case OPAR_MOD:    r->i = (y == 0) ? 0 : x % y; break;
+    case OPAR_LRSHFT: r->i = (int32_t)((uint32_t)x >> (31 & y)); break;
+    case OPAR_OR:     r->i = x | y; break;
+    case OPAR_NOR:    r->i = ~(x | y); break;
+    case OPAR_AND:    r->i = x & y; break;
+    case OPAR_XOR:    r->i = x ^ y; break;
+    case OPAR_MAX:    r->i = MAX(x, y); break;
+    case OPAR_MIN:    r->i = MIN(x, y); break;
+    case OPAR_ABS:    r->i = (x < 0) ? -x : x; break;
+    default: return 0;
+    }
+    return SCRIPT_COST_INT;
+}
+
+/**
+  @brief  tests and ALU operations on registers, constants and stack 
+          returns 0 when the instruction has other operands (pointers, bit-fields ..)
+*/
+static uint8_t scalar_operation (arm_script_instance_t *I, int32_t cond, int32_t opcode, int32_t opar)
+{
+    uint8_t db0, db1, db2, unary, cost, t;
+    script_value_t a, b, d, r = { 0 };
+
+    db0 = (uint8_t)RD(I->instruction, OP_SRC0_INST);
+    db1 = (uint8_t)RD(I->instruction, OP_SRC1_INST);
+    db2 = (uint8_t)RD(I->instruction, OP_SRC2_INST);
+    unary = (uint8_t)(opar == OPAR_SQRT || opar == OPAR_LOG10);      /* SRC2 is a function code */
+
+    switch (opar)
+    {
+    case OPAR_NOP: case OPAR_ADD: case OPAR_SUB: case OPAR_MUL: case OPAR_DIV: case OPAR_MOD:
+    case OPAR_LRSHFT: case OPAR_OR: case OPAR_NOR: case OPAR_AND: case OPAR_XOR: 
+    case OPAR_MAX: case OPAR_MIN: case OPAR_ABS: case OPAR_SQRT: case OPAR_LOG10:
+        break;
+    default: 
+        return 0;
+    }
+    if (cond >= NO_COND_EXE_PACK ||
+        0 == scalar_format(I, db0, (uint8_t)(opcode == OP_ALU)) ||
+        0 == scalar_format(I, db1, 0) ||
+        (0 == unary && 0 == scalar_format(I, db2, 0)))
+    {   return 0;
+    }
+
+    b.i = 0; b.dtype = DTYPE_INT32; b.constant = 1;
+    if (0 == unary && 0 == scalar_read(I, db2, &b)) return 1;
+    if (0 == scalar_read(I, db1, &a)) return 1;
+    if (0 == (cost = scalar_compute((uint8_t)opar, db2, &a, &b, &r)))
+    {   return 1;
+    }
+
+    if (opcode == OP_ALU)
+    {   scalar_write(I, db0, &r);
+    }
+    else
+    {   if (0 == scalar_read(I, db0, &d)) return 1;
+#if STREAM_FLOAT_ALLOWED==1
+        if (SCALAR_IS_FLOAT(&d) || SCALAR_IS_FLOAT(&r))
+        {   scalar_to_float(&d);
+            scalar_to_float(&r);
+            switch (opcode)
+            {
+            default:
+            case OP_TESTEQU: t = (uint8_t)FTESTEQU(r.f, d.f); break;
+            case OP_TESTLEQ: t = (uint8_t)FTESTLEQ(r.f, d.f); break;
+            case OP_TESTLT:  t = (uint8_t)FTESTLT (r.f, d.f); break;
+            case OP_TESTNEQ: t = (uint8_t)FTESTNEQ(r.f, d.f); break;
+            case OP_TESTGEQ: t = (uint8_t)FTESTGEQ(r.f, d.f); break;
+            case OP_TESTGT:  t = (uint8_t)FTESTGT (r.f, d.f); break;
+            }
+        }
+        else
+#endif
+        {   switch (opcode)
+            {
+            default:
+            case OP_TESTEQU: t = (uint8_t)(d.i == r.i); break;
+            case OP_TESTLEQ: t = (uint8_t)(d.i <= r.i); break;
+            case OP_TESTLT:  t = (uint8_t)(d.i <  r.i); break;
+            case OP_TESTNEQ: t = (uint8_t)(d.i != r.i); break;
+            case OP_TESTGEQ: t = (uint8_t)(d.i >= r.i); break;
+            case OP_TESTGT:  t = (uint8_t)(d.i >  r.i); break;
+            }
+        }
+        if (cond == AND_IF)     { I->test_flag = (uint8_t)(I->test_flag && t); }
+        else if (cond == OR_IF) { I->test_flag = (uint8_t)(I->test_flag || t); }
+        else                    { I->test_flag = t; }
+    }
+
+    /* cycle budget */
+    I->cycles_downcounter = (uint16_t)((I->cycles_downcounter > cost) ? I->cycles_downcounter - cost : 1);
+    return 1;
+}
+
+
 /**
   @brief         arm_stream_script : 16bits virtual machine, or Cortex-M0 binary codes
   @param[in]     pinst      instance of the component
@@ -862,6 +1686,15 @@ void arm_stream_script_interpreter (arm_script_instance_t *I)
     int32_t  cond, opcode, opar;
     uint8_t db0, db1, db2;
     
+#ifdef PLATFORM_SCRIPT_NATIVE
+    /* scripts compiled ahead of time by the graph compiler : call the C translation of the byte codes */
+    if (I->format == SCRIPT_FORMAT_NATIVE_C && I->script_index < arm_stream_script_nb_native)
+    {   if (0 != arm_stream_script_native[I->script_index])
+        {   (arm_stream_script_native[I->script_index])(I);
+            return;
+        }
+    }
+#endif
 
     while (1)
     {
@@ -905,6 +1738,21 @@ void arm_stream_script_interpreter (arm_script_instance_t *I)
             }
         }
 
+        /* vector instructions : native loops on pointer/length pairs */
+        if (opcode == OP_ALU && (opar == OPAR_VCOPY || opar == OPAR_VADD || (opar >= OPAR_VMUL && opar <= OPAR_VSCALE)))
+        {   vector_operation(I, (uint8_t)opar, 
+                (uint8_t)RD(I->instruction, OP_SRC0_INST), 
+                (uint8_t)RD(I->instruction, OP_SRC1_INST), 
+                (uint8_t)RD(I->instruction, OP_SRC2_INST));
+            I->cycles_downcounter--;
+            continue;
+        }
+
+        /* tests and arithmetics on registers, constants and stack : integer, fp32 and fp16 */
+        if (opcode != OP_SETJUMP && scalar_operation(I, cond, opcode, opar))
+        {   continue;
+        }
+
         /* read the two arguments and put the result in R14/K or R0-R13 */
         db2 = (uint8_t)RD(I->instruction, OP_SRC2_INST); readreg(I, db2, 1);
         db1 = (uint8_t)RD(I->instruction, OP_SRC1_INST); readreg(I, db1, 2);
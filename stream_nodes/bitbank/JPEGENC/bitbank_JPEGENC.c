@@ -1,6 +1,6 @@
 /* ----------------------------------------------------------------------
- * Title:        sigp_stream_detector2D.c
- * Description:  detector2D
+ * Title:        bitbank_JPEGENC.c
+ * Description:  baseline JPEG encoder, image received in strips of MCU rows
  *
  * $Date:        15 February 2024
  * $Revision:    V0.0.1
@@ -37,6 +37,42 @@
 #include "stream_common_types.h"
 #include "bitbank_JPEGENC.h"
 
+
+/*
+;----------------------------------------------------------------------------------------
+;16.	bitbank_JPEGENC
+;----------------------------------------------------------------------------------------
+;   Operation : baseline JPEG encoder (grayscale, RGB565, RGB888, subsampling 4:4:4 or 4:2:0,
+;   4 quality levels). The image is received in strips of one row of MCU (8 or 16 lines) and 
+;   encoded without a frame buffer : a strip is consumed from the input arc when all its MCU 
+;   are encoded, the bit-stream goes through a staging buffer of JPEGENC_OUT_BYTES to the 
+;   output arc (variable size, any free space is used). The headers are written with the first 
+;   strip of each frame, EOI after the last strip.
+;   Parameters : width, height, pixel type, subsampling, quality
+;
+;   presets control
+;   #0 : VGA 640x480 grayscale, quality HIGH
+;   #1 : VGA 640x480 RGB565, 4:2:0, quality HIGH
+;   #2 : QVGA 320x240 RGB565, 4:2:0, quality MED
+;   #3 : VGA 640x480 RGB888, 4:4:4, quality BEST
+;
+bitbank_JPEGENC
+    3  i8; 0 0 0        instance, preset, tag
+    PARSTART
+    2; i16; 640 480;    width and height
+    4; i8; 1 1 2 0;     pixel type, subsampling, quality
+    PARSTOP  
+*/
+
+#define NB_PRESET 4
+const JPEGENC_parameters JPEGENC_preset [NB_PRESET] = 
+{   /*  width, height, pixel_type, subsample, quality */
+    {640, 480, JPEGENC_PIXEL_GRAYSCALE, JPEGENC_SUBSAMPLE_444, JPEGENC_Q_HIGH, 0},   /* #0 */
+    {640, 480, JPEGENC_PIXEL_RGB565,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_HIGH, 0},   /* #1 */
+    {320, 240, JPEGENC_PIXEL_RGB565,    JPEGENC_SUBSAMPLE_420, JPEGENC_Q_MED,  0},   /* #2 */
+    {640, 480, JPEGENC_PIXEL_RGB888,    JPEGENC_SUBSAMPLE_444, JPEGENC_Q_BEST, 0},   /* #3 */
+};
+
 /**
   @brief         
   @param[in]     command    bit-field
@@ -58,7 +94,23 @@ void bitbank_JPEGENC (unsigned int command, void *instance, void *data, unsigned
                 memory pointers are in the same order as described in the NODE manifest
         */
         case STREAM_RESET: 
-        {   
+        {   intptr_t *memresults = (intptr_t *)instance;
+            uint16_t preset = RD(command, PRESET_CMD);
+            uint8_t *pt8bdst;
+            uint32_t i, n;
+
+            bitbank_JPEGENC_instance *pinstance = (bitbank_JPEGENC_instance *) *memresults++;
+
+            pt8bdst = (uint8_t *) pinstance;
+            n = sizeof(bitbank_JPEGENC_instance);
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = 0;
+            }
+            pinstance->tables = (bitbank_JPEGENC_tables *) *memresults++;
+            pinstance->out = (uint8_t *) *memresults++;
+
+            pinstance->config = JPEGENC_preset[MIN(preset, NB_PRESET-1)];   /* preset data move */
+            bitbank_JPEGENC_init(pinstance);
             break;
         }  
         
@@ -68,7 +120,25 @@ void bitbank_JPEGENC (unsigned int command, void *instance, void *data, unsigned
                 data = (one or all)
         */ 
         case STREAM_SET_PARAMETER:
-        {   
+        {   bitbank_JPEGENC_instance *pinstance = (bitbank_JPEGENC_instance *) instance;
+
+            if (RD(command,NODE_TAG_CMD) < NB_PRESET)
+            {   pinstance->config = JPEGENC_preset[RD(command,NODE_TAG_CMD)];
+            }
+            if (RD(command,NODE_TAG_CMD) == NODE_ALL_PARAM) 
+            {   uint8_t *pt8bsrc, *pt8bdst, i, n;
+
+                /* copy the parameters */
+                n = sizeof(JPEGENC_parameters);   
+                pt8bsrc = (uint8_t *) data;     
+                pt8bdst = (uint8_t *) &(pinstance->config);
+                for (i = 0; i < n; i++)
+                {   pt8bdst[i] = pt8bsrc[i];
+                }
+            }
+
+            /* new tables, restart from the next frame */
+            bitbank_JPEGENC_init(pinstance);
             break;
         }
 
@@ -76,12 +146,35 @@ void bitbank_JPEGENC (unsigned int command, void *instance, void *data, unsigned
                instance,  
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
+               the input arc holds at least one strip (width x 8 or 16 lines), the output arc
+               receives the bit-stream in the free space
         */         
         case STREAM_RUN:   
         {
-             break;
+            bitbank_JPEGENC_instance *pinstance = (bitbank_JPEGENC_instance *) instance;
+            intptr_t nb_data, stream_xdmbuffer_size;
+            int32_t bufferout_free;
+            stream_xdmbuffer_t *pt_pt;
+            #define SAMP_IN uint8_t 
+            #define SAMP_OUT uint8_t
+            SAMP_IN *inBuf;
+            SAMP_OUT *outBuf;
+
+            pt_pt = data;
+            inBuf  = (SAMP_IN *)pt_pt->address;
+            stream_xdmbuffer_size = pt_pt->size;
+            pt_pt++;
+            outBuf = (SAMP_OUT *)(pt_pt->address); 
+            bufferout_free = (int32_t)(pt_pt->size);
+
+            nb_data = bitbank_JPEGENC_process (pinstance, inBuf, (int32_t)stream_xdmbuffer_size, 
+                        outBuf, &bufferout_free);
+
+            pt_pt = data;
+            *(&(pt_pt->size)) = nb_data * sizeof(SAMP_IN);              /* amount of data consumed */
+            pt_pt ++;
+            *(&(pt_pt->size)) = bufferout_free * sizeof(SAMP_OUT);      /* amount of data produced */
+            break;
         }
         case STREAM_STOP :
         {
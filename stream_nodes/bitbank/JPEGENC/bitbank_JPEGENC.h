@@ -1,6 +1,6 @@
 /* ----------------------------------------------------------------------
  * Title:        bitbank_JPEGENC.h
- * Description:  filters
+ * Description:  baseline JPEG encoder, image received in strips of MCU rows
  *
  * $Date:        15 February 2024
  * $Revision:    V0.0.1
@@ -31,17 +31,86 @@
 #ifndef bitbank_JPEGENC_H
 #define bitbank_JPEGENC_H
 
+#include <stdint.h>
+
+/*
+    Baseline JPEG encoder (ITU T.81, Huffman tables of Annex K) of images received in strips
+    of one row of MCU : 8 lines (grayscale, 4:4:4) or 16 lines (4:2:0). The strips are encoded 
+    from the input arc without copy, the bit-stream is written in a small staging buffer and 
+    moved to the output arc when it has room. The last strip of the frame can have less lines.
+*/
+
+#define JPEGENC_PIXEL_GRAYSCALE     0   /* 1 byte per pixel */
+#define JPEGENC_PIXEL_RGB565        1   /* 2 bytes per pixel, little-endian */
+#define JPEGENC_PIXEL_RGB888        2   /* 3 bytes per pixel, R first */
+
+#define JPEGENC_SUBSAMPLE_444       0   /* MCU of 8x8 pixels */
+#define JPEGENC_SUBSAMPLE_420       1   /* MCU of 16x16 pixels, color only */
+
+#define JPEGENC_Q_LOW               0   /* quality factors of the Annex K tables : 50 */
+#define JPEGENC_Q_MED               1   /* 75 */
+#define JPEGENC_Q_HIGH              2   /* 90 */
+#define JPEGENC_Q_BEST              3   /* 95 */
+
+#define JPEGENC_PRESET_VGA_GRAY     0   /* 640x480 grayscale, quality HIGH */
+#define JPEGENC_PRESET_VGA_420      1   /* 640x480 RGB565, 4:2:0, quality HIGH */
+#define JPEGENC_PRESET_QVGA_420     2   /* 320x240 RGB565, 4:2:0, quality MED */
+#define JPEGENC_PRESET_VGA_444      3   /* 640x480 RGB888, 4:4:4, quality BEST */
+
+#define JPEGENC_OUT_BYTES        4096   /* staging buffer of the bit-stream */
+#define JPEGENC_MCU_MAX_BYTES    2560   /* worst case of a 4:2:0 MCU (6 blocks of 1670 bits, byte stuffing) */
+
+#define JPEGENC_STATE_HEADER        0   /* the next strip starts a frame */
+#define JPEGENC_STATE_SCAN          1
+
+typedef struct          /* 8 Bytes  */
+{
+    uint16_t width;             /* pixels per line */
+    uint16_t height;            /* lines per frame */
+    uint8_t pixel_type;         /* JPEGENC_PIXEL_xx */
+    uint8_t subsample;          /* JPEGENC_SUBSAMPLE_xx */
+    uint8_t quality;            /* JPEGENC_Q_xx */
+    uint8_t pad___;
+} JPEGENC_parameters;
+
 
 typedef struct
 {
-    int i;
+    int16_t mcu [6][64];        /* samples and coefficients of the blocks of one MCU */
+    uint16_t recip [2][64];     /* 2^16 / (8 x quantizer), zigzag order, luminance and chrominance */
+    uint16_t bias [2][64];      /* half quantizer, rounding */
+    uint8_t qtable [2][64];     /* quantizers in zigzag order for the DQT marker */
+    uint32_t dc_code [2][12];   /* Huffman code << 8 | size */
+    uint32_t ac_code [2][256];
+} bitbank_JPEGENC_tables;
+
 
+typedef struct
+{
+    JPEGENC_parameters config;  /* 8 bytes */
+    uint16_t y;                 /* first line of the current MCU row */
+    uint16_t mcu_x;             /* next MCU of the strip, the strip is consumed when it is complete */
+    uint8_t state;              /* JPEGENC_STATE_xx */
+    uint8_t nblocks;            /* blocks per MCU */
+    int16_t dc [3];             /* DC predictors */
+    uint32_t acc;               /* bit accumulator */
+    int32_t nbits;
+    uint16_t out_read;          /* staging buffer */
+    uint16_t out_write;
+    bitbank_JPEGENC_tables *tables;
+    uint8_t *out;
 } bitbank_JPEGENC_instance;
 
 
+extern void bitbank_JPEGENC_init (bitbank_JPEGENC_instance *instance);
+
+extern int32_t bitbank_JPEGENC_process (bitbank_JPEGENC_instance *instance, 
+                     uint8_t *in, int32_t inputLength,
+                     uint8_t *out, int32_t *outputLength);
+
 #endif
 
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
+ 
@@ -0,0 +1,576 @@
+/* ----------------------------------------------------------------------
+ * Title:        bitbank_JPEGENC_process.c
+ * Description:  baseline JPEG encoder, image received in strips of MCU rows
+ *
+ * $Date:        15 February 2024
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2024 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ */
+
+#include "presets.h"
+#ifdef CODE_BITBANK_JPEGENC
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "bitbank_JPEGENC.h"
+
+
+/* natural index of the zigzag order */
+static const uint8_t jpegenc_zigzag [64] = 
+{    0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+/* Annex K.1 quantization tables, natural order */
+static const uint8_t jpegenc_qbase [2][64] = 
+{   {   16, 11, 10, 16, 24, 40, 51, 61,     12, 12, 14, 19, 26, 58, 60, 55,
+        14, 13, 16, 24, 40, 57, 69, 56,     14, 17, 22, 29, 51, 87, 80, 62,
+        18, 22, 37, 56, 68,109,103, 77,     24, 35, 55, 64, 81,104,113, 92,
+        49, 64, 78, 87,103,121,120,101,     72, 92, 95, 98,112,100,103, 99, },
+    {   17, 18, 24, 47, 99, 99, 99, 99,     18, 21, 26, 66, 99, 99, 99, 99,
+        24, 26, 56, 99, 99, 99, 99, 99,     47, 66, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,     99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,     99, 99, 99, 99, 99, 99, 99, 99, },
+};
+
+static const uint8_t jpegenc_quality [4] = { 50, 75, 90, 95 };
+
+/* Annex K.3 Huffman tables : number of codes of each length, symbols */
+static const uint8_t jpegenc_dc_bits [2][16] = 
+{   { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+};
+static const uint8_t jpegenc_dc_vals [12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+static const uint8_t jpegenc_ac_bits [2][16] = 
+{   { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d },
+    { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 },
+};
+static const uint8_t jpegenc_ac_vals [2][162] = 
+{   {   0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+        0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+        0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+        0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+        0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+        0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+        0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+        0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+        0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+        0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+        0xf9, 0xfa, },
+    {   0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+        0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+        0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+        0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+        0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+        0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+        0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+        0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+        0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+        0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+        0xf9, 0xfa, },
+};
+
+
+/* Annex C : code of each symbol */
+static void jpegenc_huffman_codes (const uint8_t *bits, const uint8_t *vals, uint32_t *code)
+{
+    uint32_t c = 0, len, i, k = 0;
+
+    for (len = 1; len <= 16; len++)
+    {   for (i = 0; i < bits[len - 1]; i++)
+        {   code[vals[k++]] = (c << 8) | len;
+            c++;
+        }
+        c <<= 1;
+    }
+}
+
+
+/* 
+    tables of the quality level, geometry of the MCU
+*/
+void bitbank_JPEGENC_init (bitbank_JPEGENC_instance *pinstance)
+{
+    bitbank_JPEGENC_tables *t = pinstance->tables;
+    uint32_t itab, k, q, scale, quality;
+
+    if (pinstance->config.pixel_type == JPEGENC_PIXEL_GRAYSCALE)
+    {   pinstance->config.subsample = JPEGENC_SUBSAMPLE_444;
+        pinstance->nblocks = 1;
+    }
+    else
+    {   pinstance->nblocks = (pinstance->config.subsample == JPEGENC_SUBSAMPLE_420) ? 6 : 3;
+    }
+
+    /* IJG scaling of the Annex K tables */
+    quality = jpegenc_quality[MIN(pinstance->config.quality, JPEGENC_Q_BEST)];
+    scale = (quality < 50) ? (5000 / quality) : (200 - 2 * quality);
+    for (itab = 0; itab < 2; itab++)
+    {   for (k = 0; k < 64; k++)
+        {   q = (jpegenc_qbase[itab][jpegenc_zigzag[k]] * scale + 50) / 100;
+            q = MAX(1, MIN(255, q));
+            t->qtable[itab][k] = (uint8_t)q;
+            t->recip[itab][k] = (uint16_t)((65536 + 4 * q) / (8 * q));
+            t->bias[itab][k] = (uint16_t)(4 * q);
+        }
+        jpegenc_huffman_codes(jpegenc_dc_bits[itab], jpegenc_dc_vals, t->dc_code[itab]);
+        jpegenc_huffman_codes(jpegenc_ac_bits[itab], jpegenc_ac_vals[itab], t->ac_code[itab]);
+    }
+
+    pinstance->y = 0;
+    pinstance->mcu_x = 0;
+    pinstance->state = JPEGENC_STATE_HEADER;
+    pinstance->out_read = 0;
+    pinstance->out_write = 0;
+    pinstance->acc = 0;
+    pinstance->nbits = 0;
+}
+
+
+/* 
+    forward DCT, integer Loeffler-Ligtenberg-Moschytz, the output is 8 x the DCT
+*/
+#define DCT_CONST_BITS  13
+#define DCT_PASS1_BITS  2
+#define DCT_DESCALE(x,n) (((x) + (1 << ((n) - 1))) >> (n))
+
+#define FIX_0_298631336  2446
+#define FIX_0_390180644  3196
+#define FIX_0_541196100  4433
+#define FIX_0_765366865  6270
+#define FIX_0_899976223  7373
+#define FIX_1_175875602  9633
+#define FIX_1_501321110  12299
+#define FIX_1_847759065  15137
+#define FIX_1_961570560  16069
+#define FIX_2_053119869  16819
+#define FIX_2_562915447  20995
+#define FIX_3_072711026  25172
+
+static void jpegenc_fdct (int16_t *blk)
+{
+    int32_t tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+    int32_t tmp10, tmp11, tmp12, tmp13, z1, z2, z3, z4, z5;
+    int32_t ws [64], *w;
+    int16_t *d;
+    int32_t i;
+
+    /* rows, results scaled up by 2^PASS1_BITS */
+    for (i = 0, d = blk, w = ws; i < 8; i++, d += 8, w += 8)
+    {   tmp0 = d[0] + d[7];     tmp7 = d[0] - d[7];
+        tmp1 = d[1] + d[6];     tmp6 = d[1] - d[6];
+        tmp2 = d[2] + d[5];     tmp5 = d[2] - d[5];
+        tmp3 = d[3] + d[4];     tmp4 = d[3] - d[4];
+
+        tmp10 = tmp0 + tmp3;    tmp13 = tmp0 - tmp3;
+        tmp11 = tmp1 + tmp2;    tmp12 = tmp1 - tmp2;
+        w[0] = (tmp10 + tmp11) << DCT_PASS1_BITS;
+        w[4] = (tmp10 - tmp11) << DCT_PASS1_BITS;
+        z1 = (tmp12 + tmp13) * FIX_0_541196100;
+        w[2] = DCT_DESCALE(z1 + tmp13 * FIX_0_765366865, DCT_CONST_BITS - DCT_PASS1_BITS);
+        w[6] = DCT_DESCALE(z1 - tmp12 * FIX_1_847759065, DCT_CONST_BITS - DCT_PASS1_BITS);
+
+        z1 = tmp4 + tmp7;       z2 = tmp5 + tmp6;
+        z3 = tmp4 + tmp6;       z4 = tmp5 + tmp7;
+        z5 = (z3 + z4) * FIX_1_175875602;
+        tmp4 *= FIX_0_298631336;    tmp5 *= FIX_2_053119869;
+        tmp6 *= FIX_3_072711026;    tmp7 *= FIX_1_501321110;
+        z1 *= -FIX_0_899976223;     z2 *= -FIX_2_562915447;
+        z3 = z3 * -FIX_1_961570560 + z5;
+        z4 = z4 * -FIX_0_390180644 + z5;
+        w[7] = DCT_DESCALE(tmp4 + z1 + z3, DCT_CONST_BITS - DCT_PASS1_BITS);
+        w[5] = DCT_DESCALE(tmp5 + z2 + z4, DCT_CONST_BITS - DCT_PASS1_BITS);
+        w[3] = DCT_DESCALE(tmp6 + z2 + z3, DCT_CONST_BITS - DCT_PASS1_BITS);
+        w[1] = DCT_DESCALE(tmp7 + z1 + z4, DCT_CONST_BITS - DCT_PASS1_BITS);
+    }
+
+    /* columns, the PASS1_BITS are removed */
+    for (i = 0, d = blk, w = ws; i < 8; i++, d++, w++)
+    {   tmp0 = w[0*8] + w[7*8];     tmp7 = w[0*8] - w[7*8];
+        tmp1 = w[1*8] + w[6*8];     tmp6 = w[1*8] - w[6*8];
+        tmp2 = w[2*8] + w[5*8];     tmp5 = w[2*8] - w[5*8];
+        tmp3 = w[3*8] + w[4*8];     tmp4 = w[3*8] - w[4*8];
+
+        tmp10 = tmp0 + tmp3;    tmp13 = tmp0 - tmp3;
+        tmp11 = tmp1 + tmp2;    tmp12 = tmp1 - tmp2;
+        d[0*8] = (int16_t)DCT_DESCALE(tmp10 + tmp11, DCT_PASS1_BITS);
+        d[4*8] = (int16_t)DCT_DESCALE(tmp10 - tmp11, DCT_PASS1_BITS);
+        z1 = (tmp12 + tmp13) * FIX_0_541196100;
+        d[2*8] = (int16_t)DCT_DESCALE(z1 + tmp13 * FIX_0_765366865, DCT_CONST_BITS + DCT_PASS1_BITS);
+        d[6*8] = (int16_t)DCT_DESCALE(z1 - tmp12 * FIX_1_847759065, DCT_CONST_BITS + DCT_PASS1_BITS);
+
+        z1 = tmp4 + tmp7;       z2 = tmp5 + tmp6;
+        z3 = tmp4 + tmp6;       z4 = tmp5 + tmp7;
+        z5 = (z3 + z4) * FIX_1_175875602;
+        tmp4 *= FIX_0_298631336;    tmp5 *= FIX_2_053119869;
+        tmp6 *= FIX_3_072711026;    tmp7 *= FIX_1_501321110;
+        z1 *= -FIX_0_899976223;     z2 *= -FIX_2_562915447;
+        z3 = z3 * -FIX_1_961570560 + z5;
+        z4 = z4 * -FIX_0_390180644 + z5;
+        d[7*8] = (int16_t)DCT_DESCALE(tmp4 + z1 + z3, DCT_CONST_BITS + DCT_PASS1_BITS);
+        d[5*8] = (int16_t)DCT_DESCALE(tmp5 + z2 + z4, DCT_CONST_BITS + DCT_PASS1_BITS);
+        d[3*8] = (int16_t)DCT_DESCALE(tmp6 + z2 + z3, DCT_CONST_BITS + DCT_PASS1_BITS);
+        d[1*8] = (int16_t)DCT_DESCALE(tmp7 + z1 + z4, DCT_CONST_BITS + DCT_PASS1_BITS);
+    }
+}
+
+
+/*
+    bit writer on the staging buffer, 0xFF bytes are followed by a stuffed 0x00
+*/
+typedef struct
+{   uint8_t *p;
+    uint32_t acc;
+    int32_t nbits;
+} jpegenc_bitwriter;
+
+/* n <= 16 bits */
+static void jpegenc_put (jpegenc_bitwriter *bw, uint32_t v, int32_t n)
+{
+    bw->acc = (bw->acc << n) | (v & ((1u << n) - 1u));
+    bw->nbits += n;
+    while (bw->nbits >= 8)
+    {   uint8_t byte;
+        bw->nbits -= 8;
+        byte = (uint8_t)(bw->acc >> bw->nbits);
+        *(bw->p)++ = byte;
+        if (byte == 0xFF)
+        {   *(bw->p)++ = 0;
+        }
+    }
+}
+
+static int32_t jpegenc_category (int32_t v)
+{
+    int32_t s = 0;
+
+    v = (v < 0) ? -v : v;
+    while (v != 0)
+    {   v >>= 1;
+        s++;
+    }
+    return s;
+}
+
+
+/* 
+    DCT, quantization and Huffman coding of one block
+*/
+static void jpegenc_block (jpegenc_bitwriter *bw, bitbank_JPEGENC_tables *t, int16_t *blk, int32_t itab, int16_t *dc)
+{
+    const uint16_t *recip = t->recip[itab], *bias = t->bias[itab];
+    const uint32_t *ac_code = t->ac_code[itab];
+    int32_t k, v, s, run, diff;
+    uint32_t a, code;
+
+    jpegenc_fdct(blk);
+
+    /* DC difference */
+    v = blk[0];
+    a = (uint32_t)((v < 0) ? -v : v);
+    v = (int32_t)(((a + bias[0]) * recip[0]) >> 16) * ((v < 0) ? -1 : 1);
+    diff = v - *dc;
+    *dc = (int16_t)v;
+    s = jpegenc_category(diff);
+    code = t->dc_code[itab][s];
+    jpegenc_put(bw, code >> 8, (int32_t)(code & 0xFF));
+    if (s > 0)
+    {   jpegenc_put(bw, (uint32_t)((diff < 0) ? diff - 1 : diff), s);
+    }
+
+    /* AC coefficients in zigzag order */
+    for (run = 0, k = 1; k < 64; k++)
+    {   v = blk[jpegenc_zigzag[k]];
+        a = (uint32_t)((v < 0) ? -v : v);
+        a = MIN(1023, ((a + bias[k]) * recip[k]) >> 16);
+        if (a == 0)
+        {   run++;
+            continue;
+        }
+        while (run > 15)
+        {   code = ac_code[0xF0];                       /* ZRL */
+            jpegenc_put(bw, code >> 8, (int32_t)(code & 0xFF));
+            run -= 16;
+        }
+        v = (v < 0) ? -(int32_t)a : (int32_t)a;
+        s = jpegenc_category(v);
+        code = ac_code[(run << 4) | s];
+        jpegenc_put(bw, code >> 8, (int32_t)(code & 0xFF));
+        jpegenc_put(bw, (uint32_t)((v < 0) ? v - 1 : v), s);
+        run = 0;
+    }
+    if (run > 0)
+    {   code = ac_code[0x00];                           /* EOB */
+        jpegenc_put(bw, code >> 8, (int32_t)(code & 0xFF));
+    }
+}
+
+
+/* 
+    samples of one MCU, the pixels out of the image are replicated from the edges 
+*/
+#define JPEGENC_RGB(p, r, g, b)                                                 \
+    if (pixel_type == JPEGENC_PIXEL_RGB565)                                     \
+    {   uint32_t c = (uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8);                \
+        r = (int32_t)(((c >> 8) & 0xF8) | (c >> 13));                           \
+        g = (int32_t)(((c >> 3) & 0xFC) | ((c >> 9) & 3));                      \
+        b = (int32_t)(((c << 3) & 0xF8) | ((c >> 2) & 7));                      \
+    } else                                                                      \
+    {   r = (p)[0]; g = (p)[1]; b = (p)[2];                                     \
+    }
+
+/* JFIF YCbCr, Q16, centered on 0 */
+#define JPEGENC_Y(r,g,b)  (int16_t)(((19595 * (r) + 38470 * (g) + 7471 * (b) + 32768) >> 16) - 128)
+#define JPEGENC_CB(r,g,b) (int16_t)((-11059 * (r) - 21709 * (g) + 32768 * (b) + 32768) >> 16)
+#define JPEGENC_CR(r,g,b) (int16_t)(( 32768 * (r) - 27439 * (g) -  5329 * (b) + 32768) >> 16)
+
+static void jpegenc_fetch (bitbank_JPEGENC_instance *pinstance, const uint8_t *strip, int32_t lines, int32_t x0)
+{
+    int16_t (*mcu)[64] = pinstance->tables->mcu;
+    uint8_t pixel_type = pinstance->config.pixel_type;
+    int32_t bpp = (pixel_type == JPEGENC_PIXEL_GRAYSCALE) ? 1 : (pixel_type == JPEGENC_PIXEL_RGB565) ? 2 : 3;
+    int32_t size = (pinstance->nblocks == 6) ? 16 : 8;
+    int32_t width = pinstance->config.width, line_bytes = width * bpp;
+    int32_t xoff [16], i, j, r, g, b;
+    const uint8_t *row;
+
+    for (i = 0; i < size; i++)
+    {   xoff[i] = MIN(x0 + i, width - 1) * bpp;
+    }
+
+    if (pixel_type == JPEGENC_PIXEL_GRAYSCALE)
+    {   for (j = 0; j < 8; j++)
+        {   row = &(strip[MIN(j, lines - 1) * line_bytes]);
+            for (i = 0; i < 8; i++)
+            {   mcu[0][j * 8 + i] = (int16_t)(row[xoff[i]] - 128);
+            }
+        }
+    }
+    else if (size == 8)
+    {   for (j = 0; j < 8; j++)
+        {   row = &(strip[MIN(j, lines - 1) * line_bytes]);
+            for (i = 0; i < 8; i++)
+            {   JPEGENC_RGB(&(row[xoff[i]]), r, g, b)
+                mcu[0][j * 8 + i] = JPEGENC_Y(r, g, b);
+                mcu[1][j * 8 + i] = JPEGENC_CB(r, g, b);
+                mcu[2][j * 8 + i] = JPEGENC_CR(r, g, b);
+            }
+        }
+    }
+    else
+    {   /* 4:2:0 : four luminance blocks, chrominance of the 2x2 averages */
+        const uint8_t *row2;
+        int32_t r2, g2, b2, sr, sg, sb, blk;
+
+        for (j = 0; j < 16; j += 2)
+        {   row = &(strip[MIN(j, lines - 1) * line_bytes]);
+            row2 = &(strip[MIN(j + 1, lines - 1) * line_bytes]);
+            for (i = 0; i < 16; i += 2)
+            {   blk = ((j >> 3) << 1) | (i >> 3);
+                JPEGENC_RGB(&(row[xoff[i]]), r, g, b)
+                JPEGENC_RGB(&(row[xoff[i+1]]), r2, g2, b2)
+                mcu[blk][(j & 7) * 8 + (i & 7)] = JPEGENC_Y(r, g, b);
+                mcu[blk][(j & 7) * 8 + (i & 7) + 1] = JPEGENC_Y(r2, g2, b2);
+                sr = r + r2; sg = g + g2; sb = b + b2;
+                JPEGENC_RGB(&(row2[xoff[i]]), r, g, b)
+                JPEGENC_RGB(&(row2[xoff[i+1]]), r2, g2, b2)
+                mcu[blk][(j & 7) * 8 + (i & 7) + 8] = JPEGENC_Y(r, g, b);
+                mcu[blk][(j & 7) * 8 + (i & 7) + 9] = JPEGENC_Y(r2, g2, b2);
+                sr = (sr + r + r2 + 2) >> 2; sg = (sg + g + g2 + 2) >> 2; sb = (sb + b + b2 + 2) >> 2;
+                mcu[4][(j >> 1) * 8 + (i >> 1)] = JPEGENC_CB(sr, sg, sb);
+                mcu[5][(j >> 1) * 8 + (i >> 1)] = JPEGENC_CR(sr, sg, sb);
+            }
+        }
+    }
+}
+
+
+/*
+    markers SOI, APP0, DQT, SOF0, DHT, SOS
+*/
+static uint8_t *jpegenc_marker (uint8_t *p, uint8_t marker, uint32_t length)
+{
+    p[0] = 0xFF; p[1] = marker;
+    p[2] = (uint8_t)(length >> 8); p[3] = (uint8_t)(length);
+    return &(p[4]);
+}
+
+static uint8_t *jpegenc_header (bitbank_JPEGENC_instance *pinstance, uint8_t *p)
+{
+    static const uint8_t jfif [14] = { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 };
+    int32_t ncomp = (pinstance->nblocks == 1) ? 1 : 3, ntab = (ncomp == 1) ? 1 : 2, i, k, n;
+
+    p[0] = 0xFF; p[1] = 0xD8;                                   /* SOI */
+    p = jpegenc_marker(&(p[2]), 0xE0, 16);                      /* APP0 */
+    for (i = 0; i < 14; i++) *p++ = jfif[i];
+
+    p = jpegenc_marker(p, 0xDB, 2 + 65 * ntab);                 /* DQT */
+    for (i = 0; i < ntab; i++)
+    {   *p++ = (uint8_t)i;
+        for (k = 0; k < 64; k++) *p++ = pinstance->tables->qtable[i][k];
+    }
+
+    p = jpegenc_marker(p, 0xC0, 8 + 3 * ncomp);                 /* SOF0 */
+    *p++ = 8;
+    *p++ = (uint8_t)(pinstance->config.height >> 8); *p++ = (uint8_t)(pinstance->config.height);
+    *p++ = (uint8_t)(pinstance->config.width >> 8);  *p++ = (uint8_t)(pinstance->config.width);
+    *p++ = (uint8_t)ncomp;
+    for (i = 0; i < ncomp; i++)
+    {   *p++ = (uint8_t)(i + 1);
+        *p++ = (i == 0 && pinstance->nblocks == 6) ? 0x22 : 0x11;
+        *p++ = (i == 0) ? 0 : 1;
+    }
+
+    for (i = 0, n = 0; i < ntab; i++)                           /* DHT */
+    {   for (k = 0; k < 16; k++) n += jpegenc_dc_bits[i][k] + jpegenc_ac_bits[i][k];
+    }
+    p = jpegenc_marker(p, 0xC4, 2 + ntab * 2 * 17 + n);
+    for (i = 0; i < ntab; i++)
+    {   *p++ = (uint8_t)i;
+        for (k = 0, n = 0; k < 16; k++) { *p++ = jpegenc_dc_bits[i][k]; n += jpegenc_dc_bits[i][k]; }
+        for (k = 0; k < n; k++) *p++ = jpegenc_dc_vals[k];
+        *p++ = (uint8_t)(0x10 | i);
+        for (k = 0, n = 0; k < 16; k++) { *p++ = jpegenc_ac_bits[i][k]; n += jpegenc_ac_bits[i][k]; }
+        for (k = 0; k < n; k++) *p++ = jpegenc_ac_vals[i][k];
+    }
+
+    p = jpegenc_marker(p, 0xDA, 6 + 2 * ncomp);                 /* SOS */
+    *p++ = (uint8_t)ncomp;
+    for (i = 0; i < ncomp; i++)
+    {   *p++ = (uint8_t)(i + 1);
+        *p++ = (i == 0) ? 0x00 : 0x11;
+    }
+    *p++ = 0; *p++ = 63; *p++ = 0;
+    return p;
+}
+
+
+/* staging buffer to the output arc */
+static int32_t jpegenc_flush (bitbank_JPEGENC_instance *pinstance, uint8_t *out, int32_t room)
+{
+    int32_t n = MIN(room, pinstance->out_write - pinstance->out_read), i;
+    uint8_t *src = &(pinstance->out[pinstance->out_read]);
+
+    for (i = 0; i < n; i++)
+    {   out[i] = src[i];
+    }
+    pinstance->out_read = (uint16_t)(pinstance->out_read + n);
+
+    /* the remaining bytes are moved to the start */
+    if (pinstance->out_read > 0)
+    {   int32_t remain = pinstance->out_write - pinstance->out_read;
+        for (i = 0; i < remain; i++)
+        {   pinstance->out[i] = pinstance->out[pinstance->out_read + i];
+        }
+        pinstance->out_write = (uint16_t)remain;
+        pinstance->out_read = 0;
+    }
+    return n;
+}
+
+
+/**
+  @brief         Processing function 
+  @param[in]     instance     points to an instance of the encoder
+  @param[in]     in           image strips (one row of MCU, the input is consumed per complete strip)
+  @param[in]     inputLength  bytes in the input arc
+  @param[out]    out          JPEG bit-stream
+  @param[in/out] outputLength free bytes in the output arc / bytes produced
+  @return        number of bytes consumed
+ */
+int32_t bitbank_JPEGENC_process (bitbank_JPEGENC_instance *pinstance, 
+                     uint8_t *in, int32_t inputLength,
+                     uint8_t *out, int32_t *outputLength)
+{
+    int32_t mcu_size = (pinstance->nblocks == 6) ? 16 : 8;
+    int32_t bpp = (pinstance->config.pixel_type == JPEGENC_PIXEL_GRAYSCALE) ? 1 : 
+                  (pinstance->config.pixel_type == JPEGENC_PIXEL_RGB565) ? 2 : 3;
+    int32_t nmcu = (pinstance->config.width + mcu_size - 1) / mcu_size;
+    int32_t consumed = 0, produced, room = *outputLength, lines, strip_bytes, b;
+    jpegenc_bitwriter bw;
+
+    produced = jpegenc_flush(pinstance, out, room);
+
+    while (pinstance->out_write == 0)
+    {   lines = MIN(mcu_size, pinstance->config.height - pinstance->y);
+        strip_bytes = lines * pinstance->config.width * bpp;
+        if (inputLength - consumed < strip_bytes)
+        {   break;
+        }
+
+        /* the headers are written with the first strip of the frame */
+        if (pinstance->state == JPEGENC_STATE_HEADER)
+        {   pinstance->out_write = (uint16_t)(jpegenc_header(pinstance, pinstance->out) - pinstance->out);
+            pinstance->dc[0] = pinstance->dc[1] = pinstance->dc[2] = 0;
+            pinstance->state = JPEGENC_STATE_SCAN;
+        }
+
+        /* MCU of the strip while the staging buffer has the room of the worst case */
+        bw.p = &(pinstance->out[pinstance->out_write]);
+        bw.acc = pinstance->acc;
+        bw.nbits = pinstance->nbits;
+        while (pinstance->mcu_x < nmcu && (bw.p - pinstance->out) <= JPEGENC_OUT_BYTES - JPEGENC_MCU_MAX_BYTES)
+        {   jpegenc_fetch(pinstance, &(in[consumed]), lines, pinstance->mcu_x * mcu_size);
+            for (b = 0; b < pinstance->nblocks; b++)
+            {   int32_t comp = (b < pinstance->nblocks - 2 || pinstance->nblocks == 1) ? 0 : b - (pinstance->nblocks - 3);
+                jpegenc_block(&bw, pinstance->tables, pinstance->tables->mcu[b], (comp > 0), &(pinstance->dc[comp]));
+            }
+            pinstance->mcu_x++;
+        }
+
+        /* end of strip, end of frame : padding with 1s and EOI */
+        if (pinstance->mcu_x == nmcu)
+        {   consumed += strip_bytes;
+            pinstance->mcu_x = 0;
+            pinstance->y = (uint16_t)(pinstance->y + lines);
+            if (pinstance->y >= pinstance->config.height)
+            {   if (bw.nbits > 0)
+                {   jpegenc_put(&bw, 0x7F, 8 - bw.nbits);
+                }
+                *(bw.p)++ = 0xFF;
+                *(bw.p)++ = 0xD9;
+                pinstance->y = 0;
+                pinstance->state = JPEGENC_STATE_HEADER;
+            }
+        }
+        pinstance->acc = bw.acc;
+        pinstance->nbits = bw.nbits;
+        pinstance->out_write = (uint16_t)(bw.p - pinstance->out);
+
+        produced += jpegenc_flush(pinstance, &(out[produced]), room - produced);
+    }
+
+    *outputLength = produced;
+    return consumed;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CODE_BITBANK_JPEGENC
@@ -1,6 +1,6 @@
 /* ----------------------------------------------------------------------
- * Title:        sigp_stream_detector2D.c
- * Description:  detector2D
+ * Title:        TjpgDec.c
+ * Description:  JPEG decoder, output in rows of MCU
  *
  * $Date:        15 February 2024
  * $Revision:    V0.0.1
@@ -37,6 +37,36 @@
 #include "stream_common_types.h"
 #include "TjpgDec.h"
 
+
+/*
+;----------------------------------------------------------------------------------------
+;17.	TjpgDec
+;----------------------------------------------------------------------------------------
+;   Operation : JPEG decoder (baseline, grayscale or color 4:4:4, 4:2:2, 4:2:0) of a bit-stream 
+;   arc, the output arc receives the decoded image one row of MCU at a time (8 or 16 lines, 
+;   divided by the scaling), in the pixel format JD_FORMAT of tjpgdcnf.h. There is no frame 
+;   buffer : the working memory is the TJpgDec pool (TJPGDEC_POOL_BYTES) and a copy of its 
+;   input buffer (JD_SZBUF). The input arc must hold the headers of a frame and the coded 
+;   data of one row of MCU plus JD_SZBUF bytes, the output arc one decoded row.
+;   The bytes before a SOI marker are skipped, a corrupted frame is dropped. A frame whose
+;   headers or row of MCU do not fit in the input arc is dropped like a corrupted frame.
+;   Parameters : output scaling 1/1, 1/2, 1/4, 1/8 (preview)
+;
+;   presets control
+;   #0 : scaling 1/1
+;   #1 : scaling 1/2
+;   #2 : scaling 1/4
+;   #3 : scaling 1/8
+;
+TjpgDec
+    3  i8; 0 0 0        instance, preset, tag
+    PARSTART
+    4; i8; 0 0 0 0;     scaling
+    PARSTOP  
+*/
+
+#define NB_PRESET 4
+
 /**
   @brief         
   @param[in]     command    bit-field
@@ -58,7 +88,24 @@ void TjpgDec(unsigned int command, void *instance, void *data, unsigned int *sta
                 memory pointers are in the same order as described in the NODE manifest
         */
         case STREAM_RESET: 
-        {   
+        {   intptr_t *memresults = (intptr_t *)instance;
+            uint16_t preset = RD(command, PRESET_CMD);
+            uint8_t *pt8bdst;
+            uint32_t i, n;
+
+            TjpgDec_instance *pinstance = (TjpgDec_instance *) *memresults++;
+
+            pt8bdst = (uint8_t *) pinstance;
+            n = sizeof(TjpgDec_instance);
+            for (i = 0; i < n; i++)
+            {   pt8bdst[i] = 0;
+            }
+            pinstance->pool = (void *) *memresults++;
+            pinstance->saved_inbuf = (uint8_t *) *memresults++;
+            pinstance->in_bufsize = (uint32_t) memresults[8];      /* after the 4 format words of the 2 arcs */
+
+            pinstance->config.scale = (uint8_t)MIN(preset, NB_PRESET-1);
+            TjpgDec_init(pinstance);
             break;
         }  
         
@@ -68,7 +115,25 @@ void TjpgDec(unsigned int command, void *instance, void *data, unsigned int *sta
                 data = (one or all)
         */ 
         case STREAM_SET_PARAMETER:
-        {   
+        {   TjpgDec_instance *pinstance = (TjpgDec_instance *) instance;
+
+            if (RD(command,NODE_TAG_CMD) < NB_PRESET)
+            {   pinstance->config.scale = (uint8_t)RD(command,NODE_TAG_CMD);
+            }
+            if (RD(command,NODE_TAG_CMD) == NODE_ALL_PARAM) 
+            {   uint8_t *pt8bsrc, *pt8bdst, i, n;
+
+                /* copy the parameters */
+                n = sizeof(TjpgDec_parameters);   
+                pt8bsrc = (uint8_t *) data;     
+                pt8bdst = (uint8_t *) &(pinstance->config);
+                for (i = 0; i < n; i++)
+                {   pt8bdst[i] = pt8bsrc[i];
+                }
+            }
+
+            /* restart from the next frame */
+            TjpgDec_init(pinstance);
             break;
         }
 
@@ -76,12 +141,35 @@ void TjpgDec(unsigned int command, void *instance, void *data, unsigned int *sta
                instance,  
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
+               the input arc is the JPEG bit-stream (any amount of bytes per call), the output 
+               arc receives complete rows of MCU
         */         
         case STREAM_RUN:   
         {
-             break;
+            TjpgDec_instance *pinstance = (TjpgDec_instance *) instance;
+            intptr_t nb_data, stream_xdmbuffer_size;
+            int32_t bufferout_free;
+            stream_xdmbuffer_t *pt_pt;
+            #define SAMP_IN uint8_t 
+            #define SAMP_OUT uint8_t
+            SAMP_IN *inBuf;
+            SAMP_OUT *outBuf;
+
+            pt_pt = data;
+            inBuf  = (SAMP_IN *)pt_pt->address;
+            stream_xdmbuffer_size = pt_pt->size;
+            pt_pt++;
+            outBuf = (SAMP_OUT *)(pt_pt->address); 
+            bufferout_free = (int32_t)(pt_pt->size);
+
+            nb_data = TjpgDec_process (pinstance, inBuf, (int32_t)stream_xdmbuffer_size, 
+                        outBuf, &bufferout_free);
+
+            pt_pt = data;
+            *(&(pt_pt->size)) = nb_data * sizeof(SAMP_IN);              /* amount of data consumed */
+            pt_pt ++;
+            *(&(pt_pt->size)) = bufferout_free * sizeof(SAMP_OUT);      /* amount of data produced */
+            break;
         }
         case STREAM_STOP :
         {
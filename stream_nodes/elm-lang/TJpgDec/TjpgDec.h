@@ -1,6 +1,6 @@
 /* ----------------------------------------------------------------------
- * Title:        JPG decoder.h
- * Description:  JPG
+ * Title:        TjpgDec.h
+ * Description:  JPEG decoder, output in rows of MCU
  *
  * $Date:        15 February 2024
  * $Revision:    V0.0.1
@@ -28,20 +28,68 @@
  extern "C" {
 #endif
    
-#ifndef bitbank_TjpgDec_H
-#define bitbank_TjpgDec_H
+#ifndef TjpgDec_H
+#define TjpgDec_H
+
+#include <stdint.h>
+#include "tjpgd3/src/tjpgd.h"
+
+/*
+    JPEG bit-streams decoded with TJpgDec one row of MCU at a time : the decoder object and 
+    its input buffer are saved before each row and restored when the input arc does not hold 
+    the complete row, the row is decoded again at the next call. The decoded rows are written 
+    directly in the output arc (pixel format JD_FORMAT of tjpgdcnf.h), there is no frame buffer.
+*/
+
+#define TJPGDEC_PRESET_FULL         0   /* output scaling 1/1 */
+#define TJPGDEC_PRESET_HALF         1   /* 1/2 */
+#define TJPGDEC_PRESET_QUARTER      2   /* 1/4 */
+#define TJPGDEC_PRESET_EIGHTH       3   /* 1/8, DC only, preview */
+
+#define TJPGDEC_POOL_BYTES       4096   /* work area of TJpgDec : input buffer, tables, MCU buffers */
+#define TJPGDEC_BYTES_PER_PIXEL  ((JD_FORMAT == 0) ? 3 : (JD_FORMAT == 1) ? 2 : 1)
+
+#define TJPGDEC_STATE_SYNC          0   /* search of the SOI marker */
+#define TJPGDEC_STATE_HEADER        1   /* headers decoded when they are complete in the input arc */
+#define TJPGDEC_STATE_ROWS          2
+
+typedef struct          /* 4 Bytes  */
+{
+    uint8_t scale;              /* 0..3 : output scaling 1/2^scale */
+    uint8_t pad___[3];
+} TjpgDec_parameters;
 
 
 typedef struct
 {
-    int i;
+    TjpgDec_parameters config;  /* 4 bytes */
+    uint8_t state;              /* TJPGDEC_STATE_xx */
+    uint16_t out_width;         /* pixels per line of the output, after scaling */
+    uint16_t row_top;           /* first output line of the row being decoded */
+    uint32_t pending;           /* bytes given to TJpgDec and not yet released to the input arc */
+    uint32_t released;          /* bytes released to the input arc during the current call */
+    uint32_t saved_pending;
+    uint32_t wait_bytes;        /* input arc of the last incomplete row, decoded again when it grows */
+    uint32_t in_bufsize;        /* buffer size of the input arc in bytes, 0 when unknown */
+    uint8_t *in;                /* input and output arcs of the current call */
+    uint32_t in_bytes;
+    uint8_t *out;
+    JDEC jd;                    /* decoder object, and its copy before the decoding of a row */
+    JDEC saved;
+    void *pool;                 /* TJPGDEC_POOL_BYTES */
+    uint8_t *saved_inbuf;       /* JD_SZBUF */
+} TjpgDec_instance;
+
 
-} bitbank_TjpgDec_instance;
+extern void TjpgDec_init (TjpgDec_instance *instance);
 
+extern int32_t TjpgDec_process (TjpgDec_instance *instance, 
+                     uint8_t *in, int32_t inputLength,
+                     uint8_t *out, int32_t *outputLength);
 
 #endif
 
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
+ 
@@ -0,0 +1,222 @@
+/* ----------------------------------------------------------------------
+ * Title:        TjpgDec_process.c
+ * Description:  JPEG decoder, output in rows of MCU
+ *
+ * $Date:        15 February 2024
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2024 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ */
+
+#include "presets.h"
+#ifdef CODE_TJPGDEC
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "TjpgDec.h"
+
+
+/* TJpgDec input function : bytes of the input arc after the ones already given */
+static size_t tjpgdec_input (JDEC *jd, uint8_t *buf, size_t n)
+{
+    TjpgDec_instance *pinstance = (TjpgDec_instance *)(jd->device);
+    uint32_t offset = pinstance->released + pinstance->pending, i;
+
+    n = MIN(n, (size_t)(pinstance->in_bytes - offset));
+    if (buf != 0)
+    {   for (i = 0; i < n; i++)
+        {   buf[i] = pinstance->in[offset + i];
+        }
+    }
+    pinstance->pending += (uint32_t)n;
+    return n;
+}
+
+
+/* TJpgDec output function : the MCU is written in the row of the output arc */
+static int tjpgdec_output (JDEC *jd, void *bitmap, JRECT *rect)
+{
+    TjpgDec_instance *pinstance = (TjpgDec_instance *)(jd->device);
+    uint8_t *src = (uint8_t *)bitmap, *dst;
+    uint32_t nbytes = (rect->right - rect->left + 1) * TJPGDEC_BYTES_PER_PIXEL, y, i;
+
+    for (y = rect->top; y <= rect->bottom; y++)
+    {   dst = &(pinstance->out[((y - pinstance->row_top) * pinstance->out_width + rect->left) * TJPGDEC_BYTES_PER_PIXEL]);
+        for (i = 0; i < nbytes; i++)
+        {   dst[i] = src[i];
+        }
+        src += nbytes;
+    }
+    return 1;
+}
+
+
+/* the bytes no more needed by TJpgDec are given back to the input arc */
+static void tjpgdec_release (TjpgDec_instance *pinstance, int32_t n)
+{
+    if (n > 0)
+    {   n = MIN(n, (int32_t)pinstance->pending);
+        pinstance->released += (uint32_t)n;
+        pinstance->pending -= (uint32_t)n;
+    }
+}
+
+
+/* the input arc is full and nothing was released : the headers or the row will never be complete */
+static uint8_t tjpgdec_arc_full (TjpgDec_instance *pinstance)
+{
+    return (uint8_t)(pinstance->in_bufsize != 0 && pinstance->released == 0 && 
+                     pinstance->in_bytes >= pinstance->in_bufsize);
+}
+
+
+void TjpgDec_init (TjpgDec_instance *pinstance)
+{
+    pinstance->config.scale = (uint8_t)MIN(3, pinstance->config.scale);
+    pinstance->state = TJPGDEC_STATE_SYNC;
+    pinstance->pending = 0;
+    pinstance->wait_bytes = 0;
+}
+
+
+/**
+  @brief         Processing function 
+  @param[in]     instance     points to an instance of the decoder
+  @param[in]     in           JPEG bit-stream
+  @param[in]     inputLength  bytes in the input arc
+  @param[out]    out          decoded rows of MCU, in raster order
+  @param[in/out] outputLength free bytes in the output arc / bytes produced
+  @return        number of bytes consumed
+ */
+int32_t TjpgDec_process (TjpgDec_instance *pinstance, 
+                     uint8_t *in, int32_t inputLength,
+                     uint8_t *out, int32_t *outputLength)
+{
+    JDEC *jd = &(pinstance->jd);
+    int32_t produced = 0, room = *outputLength, i, rows, row_bytes;
+    uint8_t scale = pinstance->config.scale;
+    JRESULT rc;
+
+    pinstance->in = in;
+    pinstance->in_bytes = (uint32_t)inputLength;
+    pinstance->released = 0;
+
+    if (pinstance->state == TJPGDEC_STATE_ROWS && (uint32_t)inputLength <= pinstance->wait_bytes)
+    {   *outputLength = 0;                          /* no new data since the last incomplete row */
+        return 0;
+    }
+    pinstance->wait_bytes = 0;
+
+    for (;;)
+    {
+        if (pinstance->state == TJPGDEC_STATE_SYNC)
+        {   for (i = (int32_t)pinstance->released; i + 1 < inputLength; i++)
+            {   if (in[i] == 0xFF && in[i + 1] == 0xD8)
+                {   break;
+                }
+            }
+            if (i + 1 >= inputLength)
+            {   pinstance->released = (uint32_t)MAX(0, inputLength - 1);   /* the last byte can be the start of SOI */
+                break;
+            }
+            pinstance->released = (uint32_t)i;
+            pinstance->pending = 0;
+            pinstance->state = TJPGDEC_STATE_HEADER;
+        }
+
+        if (pinstance->state == TJPGDEC_STATE_HEADER)
+        {   uint32_t mx;
+
+            rc = jd_prepare(jd, tjpgdec_input, pinstance->pool, TJPGDEC_POOL_BYTES, pinstance);
+            if (rc == JDR_INP && 0 == tjpgdec_arc_full(pinstance))
+            {   pinstance->pending = 0;             /* the headers are parsed again with more data */
+                break;
+            }
+            if (rc != JDR_OK)
+            {   pinstance->pending = 0;             /* not supported : skip the SOI */
+                pinstance->released += 2;
+                pinstance->state = TJPGDEC_STATE_SYNC;
+                continue;
+            }
+            jd_decomp_start(jd, scale);
+            mx = jd->msx * 8u;
+            pinstance->out_width = (uint16_t)((((jd->width / mx) * mx) >> scale) + ((jd->width % mx) >> scale));
+            pinstance->state = TJPGDEC_STATE_ROWS;
+        }
+
+        /* end of frame : the bytes after the last MCU (EOI, next frame) go back to the input arc */
+        if (jd->ypos >= jd->height)
+        {   tjpgdec_release(pinstance, (int32_t)pinstance->pending - (int32_t)jd->dctr - 4);
+            pinstance->pending = 0;
+            pinstance->state = TJPGDEC_STATE_SYNC;
+            continue;
+        }
+
+        rows = MIN(jd->msy * 8, jd->height - jd->ypos) >> scale;
+        row_bytes = rows * pinstance->out_width * TJPGDEC_BYTES_PER_PIXEL;
+        if (room - produced < row_bytes)
+        {   break;
+        }
+
+        /* copy of the decoder before the row */
+        pinstance->saved = *jd;
+        for (i = 0; i < JD_SZBUF; i++)
+        {   pinstance->saved_inbuf[i] = jd->inbuf[i];
+        }
+        pinstance->saved_pending = pinstance->pending;
+
+        pinstance->out = &(out[produced]);
+        pinstance->row_top = (uint16_t)(jd->ypos >> scale);
+        rc = jd_decomp_row(jd, tjpgdec_output);
+
+        if (rc == JDR_INP && 0 == tjpgdec_arc_full(pinstance))
+        {   *jd = pinstance->saved;                 /* incomplete row : decoded again with more data */
+            for (i = 0; i < JD_SZBUF; i++)
+            {   jd->inbuf[i] = pinstance->saved_inbuf[i];
+            }
+            pinstance->pending = pinstance->saved_pending;
+            pinstance->wait_bytes = (uint32_t)inputLength - pinstance->released;
+            break;
+        }
+        if (rc != JDR_OK)
+        {   tjpgdec_release(pinstance, MAX(2, (int32_t)pinstance->pending - JD_SZBUF - 4));
+            pinstance->pending = 0;                 /* corrupted frame : search of the next one */
+            pinstance->state = TJPGDEC_STATE_SYNC;
+            continue;
+        }
+        produced += row_bytes;
+
+        /* TJpgDec keeps at most JD_SZBUF bytes in its input buffer and 4 in its shift register */
+        tjpgdec_release(pinstance, (int32_t)pinstance->pending - JD_SZBUF - 4);
+    }
+
+    *outputLength = produced;
+    return (int32_t)pinstance->released;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CODE_TJPGDEC
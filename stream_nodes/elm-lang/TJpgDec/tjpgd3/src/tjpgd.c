@@ -25,7 +25,7 @@
 /----------------------------------------------------------------------------*/
 
 
-#include "platform.h"
+#include "presets.h"
 #ifdef CODE_TJPGDEC
 
 
@@ -1157,4 +1157,58 @@ JRESULT jd_decomp (
 	return rc;
 }
 
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Decompress the JPEG picture one MCU row at a time                     */
+/*-----------------------------------------------------------------------*/
+/* The caller can save the decompression object and the input buffer     */
+/* before a row and restore them when the input stream is not complete. */
+
+JRESULT jd_decomp_start (
+	JDEC* jd,								/* Initialized decompression object */
+	uint8_t scale							/* Output de-scaling factor (0 to 3) */
+)
+{
+	if (scale > (JD_USE_SCALE ? 3 : 0)) return JDR_PAR;
+	jd->scale = scale;
+
+	jd->dcv[2] = jd->dcv[1] = jd->dcv[0] = 0;	/* Initialize DC values */
+	jd->ypos = 0;
+	jd->rst = jd->rsc = 0;
+
+	return JDR_OK;
+}
+
+
+JRESULT jd_decomp_row (
+	JDEC* jd,								/* Decompression object started by jd_decomp_start() */
+	int (*outfunc)(JDEC*, void*, JRECT*)	/* RGB output function */
+)
+{
+	unsigned int x, mx, my;
+	JRESULT rc;
+
+
+	mx = jd->msx * 8; my = jd->msy * 8;			/* Size of the MCU (pixel) */
+	if (jd->ypos >= jd->height) return JDR_PAR;	/* Err: the picture is completed */
+
+	for (x = 0; x < jd->width; x += mx) {		/* Horizontal loop of MCUs */
+		if (jd->nrst && jd->rst++ == jd->nrst) {	/* Process restart interval if enabled */
+			rc = restart(jd, jd->rsc++);
+			if (rc != JDR_OK) return rc;
+			jd->rst = 1;
+		}
+		rc = mcu_load(jd);						/* Load an MCU (decompress huffman coded stream, dequantize and apply IDCT) */
+		if (rc != JDR_OK) return rc;
+		rc = mcu_output(jd, outfunc, x, jd->ypos);	/* Output the MCU (YCbCr to RGB, scaling and output) */
+		if (rc != JDR_OK) return rc;
+	}
+	jd->ypos = (uint16_t)(jd->ypos + my);
+
+	return JDR_OK;
+}
+
 #endif
\ No newline at end of file
@@ -86,6 +86,8 @@ struct JDEC {
 	size_t sz_pool;				/* Size of momory pool (bytes available) */
 	size_t (*infunc)(JDEC*, uint8_t*, size_t);	/* Pointer to jpeg stream input function */
 	void* device;				/* Pointer to I/O device identifiler for the session */
+	uint16_t ypos;				/* Next MCU row of jd_decomp_row() (pixel) */
+	uint16_t rst, rsc;			/* Restart interval counters of jd_decomp_row() */
 };
 
 
@@ -93,6 +95,8 @@ struct JDEC {
 /* TJpgDec API functions */
 JRESULT jd_prepare (JDEC* jd, size_t (*infunc)(JDEC*,uint8_t*,size_t), void* pool, size_t sz_pool, void* dev);
 JRESULT jd_decomp (JDEC* jd, int (*outfunc)(JDEC*,void*,JRECT*), uint8_t scale);
+JRESULT jd_decomp_start (JDEC* jd, uint8_t scale);
+JRESULT jd_decomp_row (JDEC* jd, int (*outfunc)(JDEC*,void*,JRECT*));
 
 
 #ifdef __cplusplus
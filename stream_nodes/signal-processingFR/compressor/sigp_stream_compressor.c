@@ -45,6 +45,19 @@
 ;   Operation : compression 
 ;   Parameters : coding scheme and a block of 16 parameter bytes for codecs
 ;
+;   IMA-ADPCM stream mode (#1) is mono, 2 samples per byte.
+;   IMA-ADPCM block mode (#13) uses the WAV layout : a header per channel (first sample and step 
+;   index) and groups of 8 samples of each interleaved channel. Each block is decoded without the 
+;   previous ones (resynchronization after lost data, skip of blocks). Only complete blocks are 
+;   consumed : the input arc must hold IMADPCM_SAMPLES_PER_BLOCK frames (505 with 256 bytes).
+;   The block size per channel is set with the tag COMPRESSOR_TAG_BLOCK (multiple of 4 bytes).
+;
+;   LPC lossless mode (#2) : frames of COMPRESSOR_TAG_LPC_BLOCK samples per channel (default 1024),
+;   each decoded without the previous ones (sync word, CRC-8 header, CRC-16 of the frame). Per 
+;   channel : fixed polynomial predictor (order 0..4) or linear predictor (order up to 
+;   COMPRESSOR_TAG_LPC_ORDER, floating-point platforms), Rice coded residuals in partitions.
+;   Only complete frames are consumed, the output arc must have the room of LPC_MAX_FRAME_BYTES.
+;
 ;       Example of data to share with the application
 ;           outputFormat: AndroidOutputFormat.MPEG_4,
 ;           audioEncoder: AndroidAudioEncoder.AAC,
@@ -54,7 +67,7 @@
 ;
 ;   presets provision
 ;   #1 : decoder IMADPCM
-;   #2 : decoder LPC
+;   #2 : encoder LPC, lossless
 ;   #3 : MIDI player / tone sequencer
 ;   #4 : decoder CVSD for BT speech 
 ;   #5 : decoder LC3 
@@ -65,6 +78,7 @@
 ;   #9 : decoder MPEG-4 aacPlus v2 
 ;   #10: decoder OPUS CELT
 ;   #11: decoder JPEG 
+;   #13: encoder IMADPCM in blocks, multichannel
 */
 
 /**
@@ -103,6 +117,18 @@ void sigp_stream_compressor (unsigned int command, void *instance, intptr_t data
 
             sigp_stream_compressor_instance *pinstance = (sigp_stream_compressor_instance *) (memreq[0]);
             pinstance->TCM = (uint32_t *) (memreq[1]);       /* second bank = fast memory */
+            pinstance->nchan = (uint8_t)MIN(IMADPCM_MAX_NCHAN, 1 + RD(memreq[2 + NCHANDOMAIN_FMT1], NCHANM1_FMT1));
+            pinstance->block_bytes = IMADPCM_BLOCK_BYTES;
+            pinstance->lpc_block = LPC_BLOCK;
+#if STREAM_FLOAT_ALLOWED==1
+            pinstance->lpc_order = LPC_MAX_ORDER;
+#else
+            pinstance->lpc_order = 0;
+#endif
+            MEMSET(&(pinstance->state[0]), 0, sizeof(pinstance->state));
+
+            /* quantization and reconstruction table in fast memory */
+            encode_imadpcm_table_init(pinstance->TCM);
 
             //pinstance->output_format[0] = (memreq[6]);
             //pinstance->output_format[1] = (memreq[7]);
@@ -146,7 +172,8 @@ void sigp_stream_compressor (unsigned int command, void *instance, intptr_t data
                 case ENCODER_IMADPCM            :
                     nb_bytes = (nb_samp >> 1);   /* two samples generates 1 byte */ 
 
-                    encode_imadpcm(&(pinstance->state[0]), inBuf, (uint32_t)nb_samp, outBuf);
+                    nb_samp = nb_samp & ~1;     /* two samples per byte */
+                    encode_imadpcm(&(pinstance->state[0]), pinstance->TCM, inBuf, (uint32_t)nb_samp, outBuf);
 
                     /*  update only the size field 
                         the NODE is producing an amount of data different from the consumed one (see xdm11 in the manifest) 
@@ -156,8 +183,44 @@ void sigp_stream_compressor (unsigned int command, void *instance, intptr_t data
 
                     break;
 
-                default:
+                case ENCODER_IMADPCM_BLOCK      :
+                {   intptr_t nb_block, iblock, block_samp, block_bytes;
+
+                    block_samp = pinstance->nchan * IMADPCM_SAMPLES_PER_BLOCK(pinstance->block_bytes);
+                    block_bytes = pinstance->nchan * pinstance->block_bytes;
+
+                    /* only complete blocks */
+                    nb_block = MIN(nb_samp / block_samp, bufferout_free / block_bytes);
+                    for (iblock = 0; iblock < nb_block; iblock++)
+                    {   encode_imadpcm_block(&(pinstance->state[0]), pinstance->TCM, 
+                            &(inBuf[iblock * block_samp]), pinstance->nchan, pinstance->block_bytes, 
+                            &(outBuf[iblock * block_bytes]));
+                    }
+
+                    pt_pt = (stream_xdmbuffer_t *)data;   *(&(pt_pt->size)) = nb_block * block_samp * sizeof(SAMP_IN);
+                    pt_pt ++;       *(&(pt_pt->size)) = nb_block * block_bytes * sizeof(SAMP_OUT);
+                    break;
+                }
+
                 case ENCODER_LPC                :
+                {   intptr_t frame_samp, frame_bytes, nb_consumed = 0, nb_produced = 0;
+
+                    frame_samp = pinstance->nchan * pinstance->lpc_block;
+                    frame_bytes = LPC_MAX_FRAME_BYTES(pinstance->nchan, pinstance->lpc_block);
+
+                    /* only complete frames, with the room of the worst case */
+                    while (nb_samp - nb_consumed >= frame_samp && bufferout_free - nb_produced >= frame_bytes)
+                    {   nb_produced += encode_lpc_frame((int32_t *)(pinstance->TCM), &(inBuf[nb_consumed]), 
+                            pinstance->nchan, pinstance->lpc_block, pinstance->lpc_order, &(outBuf[nb_produced]));
+                        nb_consumed += frame_samp;
+                    }
+
+                    pt_pt = (stream_xdmbuffer_t *)data;   *(&(pt_pt->size)) = nb_consumed * sizeof(SAMP_IN);
+                    pt_pt ++;       *(&(pt_pt->size)) = nb_produced * sizeof(SAMP_OUT);
+                    break;
+                }
+
+                default:
                 case ENCODER_CVSD               :
                 case ENCODER_LC3                :
                 case ENCODER_SBC                :
@@ -176,8 +239,36 @@ void sigp_stream_compressor (unsigned int command, void *instance, intptr_t data
             break;
         }
 
-        default:
+        /* func(command = bitfield (STREAM_SET_PARAMETER, PRESET, TAG, NB ARCS IN/OUT)
+                TAG of a parameter to set
+                data = parameter bytes
+        */ 
         case STREAM_SET_PARAMETER:  
+        {   sigp_stream_compressor_instance *pinstance = (sigp_stream_compressor_instance *) instance;
+            uint8_t *pt8b = (uint8_t *) data;
+
+            switch (RD(command,NODE_TAG_CMD))
+            {   case COMPRESSOR_TAG_BLOCK:
+                {   uint16_t bytes = (uint16_t)(pt8b[0] | (pt8b[1] << 8));
+                    bytes = (uint16_t)MAX(IMADPCM_MIN_BLOCK_BYTES, MIN(IMADPCM_MAX_BLOCK_BYTES, bytes));
+                    pinstance->block_bytes = (uint16_t)(bytes & ~3);
+                    break;
+                }
+                case COMPRESSOR_TAG_LPC_BLOCK:
+                {   uint16_t samples = (uint16_t)(pt8b[0] | (pt8b[1] << 8));
+                    pinstance->lpc_block = (uint16_t)MAX(LPC_MIN_BLOCK, MIN(LPC_MAX_BLOCK, samples));
+                    break;
+                }
+                case COMPRESSOR_TAG_LPC_ORDER:
+                    pinstance->lpc_order = (uint8_t)MIN(LPC_MAX_ORDER, pt8b[0]);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+
+        default:
         case STREAM_READ_PARAMETER:  
         case STREAM_STOP:  
             break;       
@@ -38,6 +38,7 @@
 //#include "stream_const.h"      
 //#include "stream_types.h"  
 #include "sigp_stream_compressor_imadpcm.h"
+#include "sigp_stream_compressor_lpc.h"
 
 #define ENCODER_IMADPCM          1  
 #define ENCODER_LPC              2  
@@ -51,9 +52,13 @@
 #define ENCODER_MPEG4_AACPLUS_V2 10  
 #define ENCODER_OPUS_CELT        11 
 #define ENCODER_JPEG             12 
+#define ENCODER_IMADPCM_BLOCK    13             /* IMA-ADPCM blocks with headers, interleaved channels */
 
+#define COMPRESSOR_TAG_BLOCK      3             /* SET_PARAMETER : uint16 block size per channel in bytes */
+#define COMPRESSOR_TAG_LPC_BLOCK  4             /* SET_PARAMETER : uint16 samples per channel in a frame (ENCODER_LPC) */
+#define COMPRESSOR_TAG_LPC_ORDER  5             /* SET_PARAMETER : uint8 maximum LPC order, 0 = fixed predictors only */
 
-#define STATE_generic_SIZE 4                    /* node_malloc_E defines the effective size, depending on presets/Codec selection  */
+#define STATE_generic_SIZE (2 * IMADPCM_MAX_NCHAN)  /* node_malloc_E defines the effective size, depending on presets/Codec selection  */
 
 typedef struct
 {
@@ -63,11 +68,15 @@ typedef struct
     stream_services *stream_service_entry;
     uint32_t output_format[STREAM_FORMAT_SIZE_W32];
 
+    uint8_t nchan;                              /* interleaved channels of the input arc */
+    uint16_t block_bytes;                       /* block size per channel (ENCODER_IMADPCM_BLOCK) */
+    uint16_t lpc_block;                         /* samples per channel in a frame (ENCODER_LPC) */
+    uint8_t lpc_order;                          /* maximum order of the linear predictor */
+
     uint32_t state[STATE_generic_SIZE];      /* LAST FIELD OF THE DECLARATION !! */
 } sigp_stream_compressor_instance;
 
 
-extern void encode_imadpcm(uint32_t *state, int16_t* input, uint32_t numSamples, uint8_t* output);
 
 #endif
 
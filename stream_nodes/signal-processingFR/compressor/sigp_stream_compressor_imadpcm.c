@@ -81,24 +81,6 @@
 #include "stream_common_types.h"
 #include "sigp_stream_compressor_imadpcm.h"
 
-  inline int32_t __SSAT(int32_t val, uint32_t sat)
-  {
-    if ((sat >= 1U) && (sat <= 32U))
-    {
-      const int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
-      const int32_t min = -1 - max ;
-      if (val > max)
-      {
-        return max;
-      }
-      else if (val < min)
-      {
-        return min;
-      }
-    }
-    return val;
-  }
-
 /* Intel ADPCM step variation table */
 static int8_t indexTable[16] = {
 	-1, -1, -1, -1, 2, 4, 6, 8,
@@ -118,92 +100,124 @@ static int16_t stepsizeTable[89] = {
 };
 
 
-    
+
+
 /*
-        The "state" keeps encoded data until there is enough to send a byte to outp
+    table[16 x index + code] = (signed difference added to the predictor << 12) | (16 x next index)
+    the decoder and the reconstruction of the encoder are one load, one add and one saturation
 */
-void encode_imadpcm(uint32_t *state, int16_t* input, uint32_t numSamples, uint8_t* output)
+void encode_imadpcm_table_init(uint32_t *table)
 {
-    int8_t sign;			/* Current adpcm sign bit #TODO Remove if sign bit of diff can be used directly */
-    int16_t delta;			/* Current adpcm output value */
-    int16_t diff;			/* Difference between val and valprev */
-    int16_t step;			/* Stepsize */
-    int16_t valpred;		/* Predicted output value */
-    int16_t vpdiff;			/* Current change to valpred */
-    int16_t index;			/* Current step change index */
-    int16_t outputbuffer;	/* place to keep previous 4-bit value */
-    int16_t bufferstep;		/* toggle between outputbuffer/output */
+    int32_t index, code, step, vpdiff, next;
+
+    for (index = 0; index < IMADPCM_NB_INDEX; index++)
+    {   step = stepsizeTable[index];
+        for (code = 0; code < 16; code++)
+        {   vpdiff = step >> 3;
+            if (code & 4) vpdiff += step;
+            if (code & 2) vpdiff += step >> 1;
+            if (code & 1) vpdiff += step >> 2;
+            if (code & 8) vpdiff = -vpdiff;
+
+            next = MAX(0, MIN(IMADPCM_NB_INDEX - 1, index + indexTable[code]));
+            table[(index << 4) + code] = ((uint32_t)vpdiff << 12) | (uint32_t)(next << 4);
+        }
+    }
+}
 
-	// Note: Initial states are 0 which gives step = 7
-    valpred = (int16_t)state[VALPREV];
-    index = (int16_t)state[INDEX];
-    step = stepsizeTable[index];
-    
-    bufferstep = 1;
-    outputbuffer = 0;
-
-    for ( ; numSamples > 0 ; numSamples-- ) 
-    {
-	    /* Step 1 - compute difference with previous value */
-	    diff = *input++ - valpred; 
-	    sign = (diff < 0) ? 8 : 0;
-	    if ( sign ) diff = (-diff);
-
-	    delta = 0;
-	    vpdiff = (step >> 3);
-
-	    if ( diff >= step ) {
-	        delta = 4;
-	        diff -= step;
-	        vpdiff += step;
-	    }
-	    step >>= 1;
-	    if ( diff >= step  ) {
-	        delta |= 2;
-	        diff -= step;
-	        vpdiff += step;
-	    }
-	    step >>= 1;
-	    if ( diff >= step ) {
-	        delta |= 1;
-	        vpdiff += step;
-	    }
-
-	    /* Step 3 - Assemble value, update index and step values */
-	    delta |= sign;
-	
-	    index += indexTable[delta];
-	    if ( index < 0 ) index = 0;
-	    if ( index > 88 )
-	    index = 88;
-	    step = stepsizeTable[index];
-
-	    /* Step 4 - Update previous value and clamp to 16 bits */
-	    /* Note: If valpred is less than MIN_INT16 + vpdiff then underflow is impossible
-	       and likewise when valpred is greater than MAX_INT16 + vpdiff */
-	
-        if (sign)
-	        valpred = valpred - vpdiff;
-        else
-	        valpred = valpred + vpdiff;
-
-        __SSAT(valpred,16);
-
-	    /* Step 5 - Output value */
-	    if ( bufferstep ) {
-	        outputbuffer = delta & 0x0f;
-	    } else {
-	        *output++ = (uint8_t)(((delta << 4) & 0xf0) | outputbuffer);
-	    }
-	    bufferstep = !bufferstep;
+
+/*
+    quantization of one sample without branch, row = 16 x step index
+*/
+static int32_t imadpcm_quantize(const uint32_t *table, int32_t *valpred, int32_t *row, int32_t sample)
+{
+    int32_t diff, sign, step, code, b, e;
+
+    diff = sample - *valpred;
+    sign = diff >> 31;
+    diff = (diff ^ sign) - sign;
+    step = stepsizeTable[*row >> 4];
+
+    b = (diff >= step);  code = b << 2;  diff -= step & (-b);  step >>= 1;
+    b = (diff >= step);  code |= b << 1; diff -= step & (-b);  step >>= 1;
+    b = (diff >= step);  code |= b;
+    code |= sign & 8;
+
+    /* same reconstruction as the decoder */
+    e = (int32_t)table[*row + code];
+    *valpred = MAX(-32768, MIN(32767, *valpred + (e >> 12)));
+    *row = e & 0xFFF;
+    return code;
+}
+
+
+/*
+    2 x nbytes samples read with a stride, first sample in the low nibble,
+    the output pointer jumps after each group of 4 bytes (interleaved channels of the blocks)
+*/
+static void imadpcm_encode_nibbles(const uint32_t *table, int32_t *valpred, int32_t *row, 
+                int16_t *input, int32_t in_stride, uint8_t *output, int32_t nbytes, int32_t out_jump)
+{
+    int32_t b, lo, hi;
+
+    for (b = 0; b < nbytes; b++)
+    {   lo = imadpcm_quantize(table, valpred, row, input[0]);
+        hi = imadpcm_quantize(table, valpred, row, input[in_stride]);
+        input += 2 * in_stride;
+        *output++ = (uint8_t)(lo | (hi << 4));
+        if ((b & 3) == 3)
+        {   output += out_jump;
+        }
     }
+}
 
-    /* Output last step, if needed */
-    if ( !bufferstep )
-      *output++ = (uint8_t)outputbuffer;
     
-    state[VALPREV] = valpred;
-    state[INDEX] = index;
+/*
+        Stream mode (mono) : two samples per byte, the "state" keeps the predictor between calls
+        an odd last sample is not consumed
+*/
+void encode_imadpcm(uint32_t *state, const uint32_t *table, int16_t* input, uint32_t numSamples, uint8_t* output)
+{
+    int32_t valpred, row;
+
+	// Note: Initial states are 0 which gives step = 7
+    valpred = (int32_t)state[VALPREV];
+    row = (int32_t)state[INDEX] << 4;
+
+    imadpcm_encode_nibbles(table, &valpred, &row, input, 1, output, (int32_t)(numSamples >> 1), 0);
+
+    state[VALPREV] = (uint32_t)valpred;
+    state[INDEX] = (uint32_t)(row >> 4);
+}
+
+
+/*
+        Block mode (WAV IMA-ADPCM layout) : one header of 4 bytes per channel (first sample of the 
+        block, step index), followed by groups of 4 bytes (8 samples) of each channel in turn.
+        The blocks are decoded without the previous ones, only the step index is kept between blocks.
+        input : IMADPCM_SAMPLES_PER_BLOCK(block_bytes) interleaved frames, output : nchan x block_bytes
+*/
+void encode_imadpcm_block(uint32_t *state, const uint32_t *table, int16_t* input, uint32_t nchan, uint32_t block_bytes, uint8_t* output)
+{
+    int32_t valpred, row;
+    uint32_t ch;
+
+    for (ch = 0; ch < nchan; ch++)
+    {   valpred = input[ch];
+        row = (int32_t)state[2*ch + INDEX] << 4;
+
+        output[4*ch + 0] = (uint8_t)(valpred);
+        output[4*ch + 1] = (uint8_t)(valpred >> 8);
+        output[4*ch + 2] = (uint8_t)(row >> 4);
+        output[4*ch + 3] = 0;
+
+        imadpcm_encode_nibbles(table, &valpred, &row, &(input[nchan + ch]), (int32_t)nchan, 
+                &(output[(nchan + ch) * IMADPCM_HEADER_BYTES]), 
+                (int32_t)(block_bytes - IMADPCM_HEADER_BYTES), (int32_t)(IMADPCM_HEADER_BYTES * (nchan - 1)));
+
+        state[2*ch + VALPREV] = (uint32_t)valpred;
+        state[2*ch + INDEX] = (uint32_t)(row >> 4);
+    }
 }
 
 #endif
\ No newline at end of file
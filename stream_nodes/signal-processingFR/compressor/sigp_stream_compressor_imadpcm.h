@@ -37,7 +37,20 @@
 #define VALPREV 0
 #define INDEX   1
 
-extern void encode_imadpcm(uint32_t* state, int16_t* input, uint32_t numSamples, uint8_t* outp);
+#define IMADPCM_MAX_NCHAN       16
+#define IMADPCM_NB_INDEX        89
+#define IMADPCM_TABLE_SIZE      (IMADPCM_NB_INDEX * 16)     /* uint32 words in the TCM area */
+#define IMADPCM_HEADER_BYTES    4       /* per channel : int16 predictor, step index, 0 */
+#define IMADPCM_BLOCK_BYTES     256     /* default block size per channel */
+#define IMADPCM_MIN_BLOCK_BYTES 8
+#define IMADPCM_MAX_BLOCK_BYTES 4096
+
+/* samples per channel in a block : the header sample + 2 samples per byte */
+#define IMADPCM_SAMPLES_PER_BLOCK(bytes) ((((bytes) - IMADPCM_HEADER_BYTES) * 2) + 1)
+
+extern void encode_imadpcm_table_init(uint32_t *table);
+extern void encode_imadpcm(uint32_t* state, const uint32_t *table, int16_t* input, uint32_t numSamples, uint8_t* outp);
+extern void encode_imadpcm_block(uint32_t* state, const uint32_t *table, int16_t* input, uint32_t nchan, uint32_t block_bytes, uint8_t* outp);
 
 
 #endif
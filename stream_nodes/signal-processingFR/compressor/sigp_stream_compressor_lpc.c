@@ -0,0 +1,511 @@
+/* ----------------------------------------------------------------------
+ * Title:        sigp_stream_compressor_lpc.c
+ * Description:  lossless encoder, linear prediction and Rice codes
+ *
+ * $Date:        15 February 2024
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2024 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ */
+
+/*
+    Lossless compression of S16 interleaved samples, in frames decoded without the previous ones
+    (format in sigp_stream_compressor_lpc.h). For each channel the encoder selects :
+    - a constant subframe, 
+    - the best fixed polynomial predictor (order 0..4), from the sum of the absolute residuals,
+    - a linear predictor (order 1..8, Levinson-Durbin on the Welch-windowed autocorrelation, 
+      coefficients quantized on 12 bits) when floating point is allowed and when it is smaller,
+    - a verbatim subframe when the residuals do not compress.
+    The residuals are Rice coded in 2^p partitions, the partition order and the Rice parameters
+    are chosen with the exact count of the Rice bits upper-bounded by n(k+1) + sum(u)>>k.
+*/
+
+#include "presets.h"
+#ifdef CODE_SIGP_STREAM_COMPRESSOR
+
+#include <stdint.h>
+#if STREAM_FLOAT_ALLOWED==1
+#include <math.h>
+#endif
+
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "sigp_stream_compressor_lpc.h"
+
+
+/* CRC-16 polynomial 0x8005 */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,
+    0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022,
+    0x8063, 0x0066, 0x006C, 0x8069, 0x0078, 0x807D, 0x8077, 0x0072,
+    0x0050, 0x8055, 0x805F, 0x005A, 0x804B, 0x004E, 0x0044, 0x8041,
+    0x80C3, 0x00C6, 0x00CC, 0x80C9, 0x00D8, 0x80DD, 0x80D7, 0x00D2,
+    0x00F0, 0x80F5, 0x80FF, 0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1,
+    0x00A0, 0x80A5, 0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1,
+    0x8093, 0x0096, 0x009C, 0x8099, 0x0088, 0x808D, 0x8087, 0x0082,
+    0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197, 0x0192,
+    0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE, 0x01A4, 0x81A1,
+    0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB, 0x01FE, 0x01F4, 0x81F1,
+    0x81D3, 0x01D6, 0x01DC, 0x81D9, 0x01C8, 0x81CD, 0x81C7, 0x01C2,
+    0x0140, 0x8145, 0x814F, 0x014A, 0x815B, 0x015E, 0x0154, 0x8151,
+    0x8173, 0x0176, 0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162,
+    0x8123, 0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
+    0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104, 0x8101,
+    0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D, 0x8317, 0x0312,
+    0x0330, 0x8335, 0x833F, 0x033A, 0x832B, 0x032E, 0x0324, 0x8321,
+    0x0360, 0x8365, 0x836F, 0x036A, 0x837B, 0x037E, 0x0374, 0x8371,
+    0x8353, 0x0356, 0x035C, 0x8359, 0x0348, 0x834D, 0x8347, 0x0342,
+    0x03C0, 0x83C5, 0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1,
+    0x83F3, 0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2,
+    0x83A3, 0x03A6, 0x03AC, 0x83A9, 0x03B8, 0x83BD, 0x83B7, 0x03B2,
+    0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E, 0x0384, 0x8381,
+    0x0280, 0x8285, 0x828F, 0x028A, 0x829B, 0x029E, 0x0294, 0x8291,
+    0x82B3, 0x02B6, 0x02BC, 0x82B9, 0x02A8, 0x82AD, 0x82A7, 0x02A2,
+    0x82E3, 0x02E6, 0x02EC, 0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2,
+    0x02D0, 0x82D5, 0x82DF, 0x02DA, 0x82CB, 0x02CE, 0x02C4, 0x82C1,
+    0x8243, 0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252,
+    0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264, 0x8261,
+    0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231,
+    0x8213, 0x0216, 0x021C, 0x8219, 0x0208, 0x820D, 0x8207, 0x0202
+};
+
+
+typedef struct
+{   uint8_t *p;
+    uint32_t acc;
+    int32_t nbits;
+} lpc_bitwriter;
+
+
+/* n <= 24 bits, MSB first */
+static void lpc_put (lpc_bitwriter *bw, uint32_t v, int32_t n)
+{
+    bw->acc = (bw->acc << n) | (v & ((1u << n) - 1u));
+    bw->nbits += n;
+    while (bw->nbits >= 8)
+    {   bw->nbits -= 8;
+        *(bw->p)++ = (uint8_t)(bw->acc >> bw->nbits);
+    }
+}
+
+static void lpc_put_unary (lpc_bitwriter *bw, uint32_t q)
+{
+    while (q >= 16)
+    {   lpc_put(bw, 0, 16);
+        q -= 16;
+    }
+    lpc_put(bw, 1, (int32_t)q + 1);
+}
+
+static uint8_t lpc_crc8 (const uint8_t *p, int32_t n)
+{
+    uint8_t crc = 0;
+    int32_t i, b;
+
+    for (i = 0; i < n; i++)
+    {   crc ^= p[i];
+        for (b = 0; b < 8; b++)
+        {   crc = (uint8_t)((crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1));
+        }
+    }
+    return crc;
+}
+
+static uint16_t lpc_crc16 (const uint8_t *p, int32_t n)
+{
+    uint16_t crc = 0;
+    int32_t i;
+
+    for (i = 0; i < n; i++)
+    {   crc = (uint16_t)((crc << 8) ^ crc16_table[(crc >> 8) ^ p[i]]);
+    }
+    return crc;
+}
+
+
+/* number of bits of u, signed width of a zigzag value */
+static int32_t lpc_bitlength (uint32_t u)
+{
+    int32_t w = 0;
+    while (u != 0)
+    {   u >>= 1;
+        w++;
+    }
+    return w;
+}
+
+/* Rice parameter and upper bound of the bits of a partition */
+static uint32_t lpc_rice_bits (uint64_t sum, uint32_t cnt, uint32_t umax, uint8_t *k)
+{
+    uint32_t kk = 0, bits, escape;
+
+    while (kk < 22 && ((uint64_t)cnt << (kk + 1)) <= sum)
+    {   kk++;
+    }
+    bits = cnt * (kk + 1) + (uint32_t)(sum >> kk);
+    escape = 5 + cnt * (uint32_t)lpc_bitlength(umax);
+    if (escape < bits)
+    {   *k = LPC_RICE_ESCAPE;
+        return 5 + escape;
+    }
+    *k = (uint8_t)kk;
+    return 5 + bits;
+}
+
+#define ZIGZAG(e) (((uint32_t)(e) << 1) ^ (uint32_t)((e) >> 31))
+
+
+/*
+    partition order and Rice parameters of the residuals e[order .. n-1]
+*/
+static uint32_t lpc_partition (const int32_t *e, int32_t n, int32_t order, uint8_t *pbest, uint8_t *param)
+{
+    uint64_t sum [1 << LPC_MAX_PARTITION_ORDER];
+    uint32_t umax [1 << LPC_MAX_PARTITION_ORDER];
+    uint8_t k [1 << LPC_MAX_PARTITION_ORDER];
+    uint32_t bits, best = 0xFFFFFFFFu, u;
+    int32_t pmax, p, j, i, np, len;
+
+    for (pmax = 0; pmax < LPC_MAX_PARTITION_ORDER; pmax++)
+    {   if ((n & ((1 << (pmax + 1)) - 1)) != 0 || (n >> (pmax + 1)) <= order)
+        {   break;
+        }
+    }
+
+    /* finest partitions */
+    len = n >> pmax;
+    for (j = 0; j < (1 << pmax); j++)
+    {   sum[j] = 0; umax[j] = 0;
+        for (i = (j == 0) ? order : j * len; i < (j + 1) * len; i++)
+        {   u = ZIGZAG(e[i]);
+            sum[j] += u;
+            umax[j] = MAX(umax[j], u);
+        }
+    }
+
+    /* from the finest to the coarsest partitions */
+    for (p = pmax; p >= 0; p--)
+    {   np = 1 << p;
+        len = n >> p;
+        bits = 4;
+        for (j = 0; j < np; j++)
+        {   bits += lpc_rice_bits(sum[j], (uint32_t)(len - ((j == 0) ? order : 0)), umax[j], &(k[j]));
+        }
+        if (bits < best)
+        {   best = bits;
+            *pbest = (uint8_t)p;
+            for (j = 0; j < np; j++)
+            {   param[j] = k[j];
+            }
+        }
+        for (j = 0; j < np / 2; j++)
+        {   sum[j] = sum[2*j] + sum[2*j + 1];
+            umax[j] = MAX(umax[2*j], umax[2*j + 1]);
+        }
+    }
+    return best;
+}
+
+static void lpc_put_residual (lpc_bitwriter *bw, const int32_t *e, int32_t n, int32_t order, uint8_t p, const uint8_t *param)
+{
+    int32_t j, i, len = n >> p, w;
+    uint32_t u, umax;
+
+    lpc_put(bw, p, 4);
+    for (j = 0; j < (1 << p); j++)
+    {   int32_t start = (j == 0) ? order : j * len;
+
+        if (param[j] == LPC_RICE_ESCAPE)
+        {   for (umax = 0, i = start; i < (j + 1) * len; i++)
+            {   umax = MAX(umax, ZIGZAG(e[i]));
+            }
+            w = lpc_bitlength(umax);
+            lpc_put(bw, LPC_RICE_ESCAPE, 5);
+            lpc_put(bw, (uint32_t)w, 5);
+            for (i = start; i < (j + 1) * len; i++)
+            {   lpc_put(bw, (uint32_t)e[i], w);
+            }
+        }
+        else
+        {   uint8_t k = param[j];
+            lpc_put(bw, k, 5);
+            for (i = start; i < (j + 1) * len; i++)
+            {   u = ZIGZAG(e[i]);
+                lpc_put_unary(bw, u >> k);
+                lpc_put(bw, u, k);
+            }
+        }
+    }
+}
+
+
+/* estimation of the Rice bits of a single partition */
+static uint32_t lpc_estimate (uint64_t sum_abs, int32_t cnt)
+{
+    uint32_t kk = 0;
+    uint64_t sum = 2 * sum_abs;     /* zigzag */
+
+    while (kk < 22 && ((uint64_t)cnt << (kk + 1)) <= sum)
+    {   kk++;
+    }
+    return (uint32_t)cnt * (kk + 1) + (uint32_t)(sum >> kk);
+}
+
+
+/*
+    residual of the fixed predictors, the polynomial of order "order" 
+*/
+static void lpc_fixed_residual (int32_t *e, const int16_t *x, int32_t s, int32_t n, int32_t order)
+{
+    int32_t i;
+
+    switch (order)
+    {   
+    case 0: for (i = 0; i < n; i++) e[i] = x[i*s]; break;
+    case 1: for (i = 1; i < n; i++) e[i] = x[i*s] - x[(i-1)*s]; break;
+    case 2: for (i = 2; i < n; i++) e[i] = x[i*s] - 2*x[(i-1)*s] + x[(i-2)*s]; break;
+    case 3: for (i = 3; i < n; i++) e[i] = x[i*s] - 3*x[(i-1)*s] + 3*x[(i-2)*s] - x[(i-3)*s]; break;
+    default:for (i = 4; i < n; i++) e[i] = x[i*s] - 4*x[(i-1)*s] + 6*x[(i-2)*s] - 4*x[(i-3)*s] + x[(i-4)*s]; break;
+    }
+}
+
+/* best fixed order and its estimated bits */
+static int32_t lpc_fixed_order (const int16_t *x, int32_t s, int32_t n, uint32_t *bits)
+{
+    uint64_t sum[LPC_FIXED_MAX_ORDER + 1] = {0, 0, 0, 0, 0};
+    int32_t i, e0, e1, e2, e3, e4, order, best = 0;
+
+    for (i = LPC_FIXED_MAX_ORDER; i < n; i++)
+    {   e0 = x[i*s];
+        e1 = e0 - x[(i-1)*s];
+        e2 = e1 - (x[(i-1)*s] - x[(i-2)*s]);
+        e3 = e2 - (x[(i-1)*s] - 2*x[(i-2)*s] + x[(i-3)*s]);
+        e4 = e3 - (x[(i-1)*s] - 3*x[(i-2)*s] + 3*x[(i-3)*s] - x[(i-4)*s]);
+        sum[0] += (uint32_t)ABS(e0);
+        sum[1] += (uint32_t)ABS(e1);
+        sum[2] += (uint32_t)ABS(e2);
+        sum[3] += (uint32_t)ABS(e3);
+        sum[4] += (uint32_t)ABS(e4);
+    }
+    for (order = 1; order <= LPC_FIXED_MAX_ORDER; order++)
+    {   if (sum[order] < sum[best])
+        {   best = order;
+        }
+    }
+    *bits = lpc_estimate(sum[best], n - LPC_FIXED_MAX_ORDER) + 16 * (uint32_t)best;
+    return best;
+}
+
+
+#if STREAM_FLOAT_ALLOWED==1
+/*
+    linear prediction : order selection and quantized coefficients, pred = sum(q[j] x[i-1-j]) >> shift
+*/
+static int32_t lpc_analysis (float *w, const int16_t *x, int32_t s, int32_t n, int32_t max_order, int32_t *q, int32_t *shift)
+{
+    double r [LPC_MAX_ORDER + 1], acc, err, kref;
+    double a [LPC_MAX_ORDER + 1], tmp [LPC_MAX_ORDER + 1];
+    double lpc [LPC_MAX_ORDER + 1][LPC_MAX_ORDER + 1], bits, best_bits = 1e30;
+    float c = 0.5f * (float)(n - 1), d = 0.5f * (float)(n + 1), t, cmax, v, errq;
+    int32_t i, j, m, order = 0, exponent, qmax = (1 << (LPC_COEF_BITS - 1)) - 1;
+
+    /* Welch window and autocorrelation */
+    for (i = 0; i < n; i++)
+    {   t = ((float)i - c) / d;
+        w[i] = (float)x[i*s] * (1.0f - t * t);
+    }
+    for (j = 0; j <= max_order; j++)
+    {   for (acc = 0, i = j; i < n; i++)
+        {   acc += (double)w[i] * (double)w[i-j];
+        }
+        r[j] = acc;
+    }
+    if (r[0] <= 0)
+    {   return 0;
+    }
+
+    /* Levinson-Durbin, bits estimated for each order */
+    err = r[0];
+    for (m = 1; m <= max_order; m++)
+    {   for (acc = r[m], j = 1; j < m; j++)
+        {   acc -= a[j] * r[m-j];
+        }
+        kref = acc / err;
+        for (j = 1; j < m; j++)
+        {   tmp[j] = a[j] - kref * a[m-j];
+        }
+        for (j = 1; j < m; j++)
+        {   a[j] = tmp[j];
+        }
+        a[m] = kref;
+        err *= (1.0 - kref * kref);
+        for (j = 1; j <= m; j++)
+        {   lpc[m][j] = a[j];
+        }
+
+        bits = 0.5 * (double)n * log(MAX(err, 1e-9) / (double)n) / log(2.0) + m * (LPC_COEF_BITS + 16);
+        if (bits < best_bits)
+        {   best_bits = bits;
+            order = m;
+        }
+    }
+    if (order == 0)
+    {   return 0;
+    }
+
+    /* quantization with error feedback */
+    for (cmax = 0, j = 1; j <= order; j++)
+    {   cmax = MAX(cmax, (float)fabs(lpc[order][j]));
+    }
+    if (cmax <= 0)
+    {   return 0;
+    }
+    (void)frexpf(cmax, &exponent);
+    *shift = MIN(LPC_MAX_SHIFT, LPC_COEF_BITS - 1 - exponent);
+    if (*shift < 0)
+    {   return 0;
+    }
+    for (errq = 0, j = 0; j < order; j++)
+    {   v = (float)lpc[order][j+1] * (float)(1 << *shift) + errq;
+        q[j] = MAX(-qmax, MIN(qmax, (int32_t)lrintf(v)));
+        errq = v - (float)q[j];
+    }
+    return order;
+}
+#endif
+
+static void lpc_residual (int32_t *e, const int16_t *x, int32_t s, int32_t n, int32_t order, const int32_t *q, int32_t shift)
+{
+    int32_t i, j, pred;
+
+    for (i = order; i < n; i++)
+    {   for (pred = 0, j = 0; j < order; j++)
+        {   pred += q[j] * x[(i-1-j)*s];
+        }
+        e[i] = x[i*s] - (pred >> shift);
+    }
+}
+
+
+/*
+    one frame of nsamp samples per channel, returns the number of bytes
+    scratch : nsamp words of 32 bits
+*/
+uint32_t encode_lpc_frame (int32_t *scratch, int16_t *input, uint32_t nchan, uint32_t nsamp,
+                uint8_t max_order, uint8_t *output)
+{
+    lpc_bitwriter bw;
+    uint32_t ch, length, fixed_bits, lpc_bits, res_bits;
+    int32_t n = (int32_t)nsamp, s = (int32_t)nchan, i, j, order, type, shift = 0;
+    int32_t q [LPC_MAX_ORDER];
+    uint8_t p = 0, param [1 << LPC_MAX_PARTITION_ORDER];
+    uint16_t crc;
+
+    bw.p = &(output[LPC_HEADER_BYTES]);
+    bw.acc = 0;
+    bw.nbits = 0;
+
+    for (ch = 0; ch < nchan; ch++)
+    {   int16_t *x = &(input[ch]);
+
+        for (i = 1; i < n; i++)
+        {   if (x[i*s] != x[0]) break;
+        }
+        if (i == n)
+        {   lpc_put(&bw, LPC_SUB_CONSTANT, 2);
+            lpc_put(&bw, (uint16_t)x[0], 16);
+            continue;
+        }
+
+        /* fixed predictor, linear predictor if it is smaller */
+        type = LPC_SUB_FIXED;
+        order = lpc_fixed_order(x, s, n, &fixed_bits);
+#if STREAM_FLOAT_ALLOWED==1
+        if (max_order > 0 && n > 4 * max_order)
+        {   int32_t lpc_order = lpc_analysis((float *)scratch, x, s, n, MIN(max_order, LPC_MAX_ORDER), q, &shift);
+            if (lpc_order > 0)
+            {   uint64_t sum = 0;
+                lpc_residual(scratch, x, s, n, lpc_order, q, shift);
+                for (i = lpc_order; i < n; i++)
+                {   sum += (uint32_t)ABS(scratch[i]);
+                }
+                lpc_bits = lpc_estimate(sum, n - lpc_order) + (uint32_t)lpc_order * (LPC_COEF_BITS + 16);
+                if (lpc_bits < fixed_bits)
+                {   type = LPC_SUB_LPC;
+                    order = lpc_order;
+                }
+            }
+        }
+#else
+        (void)lpc_bits;
+#endif
+        if (type == LPC_SUB_FIXED)
+        {   lpc_fixed_residual(scratch, x, s, n, order);
+        }
+        res_bits = lpc_partition(scratch, n, order, &p, param) + (uint32_t)order * 16 
+                 + ((type == LPC_SUB_LPC) ? (uint32_t)(7 + order * LPC_COEF_BITS) : 3);
+
+        if (res_bits >= 16 * (uint32_t)n)
+        {   lpc_put(&bw, LPC_SUB_VERBATIM, 2);
+            for (i = 0; i < n; i++)
+            {   lpc_put(&bw, (uint16_t)x[i*s], 16);
+            }
+            continue;
+        }
+
+        lpc_put(&bw, (uint32_t)type, 2);
+        if (type == LPC_SUB_LPC)
+        {   lpc_put(&bw, (uint32_t)(order - 1), 3);
+            lpc_put(&bw, (uint32_t)shift, 4);
+            for (j = 0; j < order; j++)
+            {   lpc_put(&bw, (uint32_t)q[j], LPC_COEF_BITS);
+            }
+        }
+        else
+        {   lpc_put(&bw, (uint32_t)order, 3);
+        }
+        for (i = 0; i < order; i++)
+        {   lpc_put(&bw, (uint16_t)x[i*s], 16);
+        }
+        lpc_put_residual(&bw, scratch, n, order, p, param);
+    }
+
+    /* padding, header and CRC */
+    if (bw.nbits > 0)
+    {   lpc_put(&bw, 0, 8 - bw.nbits);
+    }
+    length = (uint32_t)(bw.p - output) + LPC_CRC_BYTES;
+
+    output[0] = LPC_SYNC0;
+    output[1] = LPC_SYNC1;
+    output[2] = (uint8_t)(nsamp);
+    output[3] = (uint8_t)(nsamp >> 8);
+    output[4] = (uint8_t)(length);
+    output[5] = (uint8_t)(length >> 8);
+    output[6] = (uint8_t)(length >> 16);
+    output[7] = (uint8_t)(nchan);
+    output[8] = lpc_crc8(output, 8);
+
+    crc = lpc_crc16(output, (int32_t)length - LPC_CRC_BYTES);
+    output[length - 2] = (uint8_t)(crc >> 8);
+    output[length - 1] = (uint8_t)(crc);
+    return length;
+}
+
+#endif
@@ -0,0 +1,39 @@
+/* ----------------------------------------------------------------------
+ * Title:        sigp_stream_compressor_lpc.h
+ *
+ * Description:  lossless encoder, linear prediction and Rice codes
+ *
+ * $Date:        15 February 2024
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2024 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef cSIGP_STREAM_ENC_LPC_H
+#define cSIGP_STREAM_ENC_LPC_H
+
+
+#include <stdint.h>
+
+#include "../sigp_stream_lpc.h"     /* frame format shared with the decoder */
+
+extern uint32_t encode_lpc_frame(int32_t *scratch, int16_t *input, uint32_t nchan, uint32_t nsamp,
+                uint8_t max_order, uint8_t *output);
+
+#endif
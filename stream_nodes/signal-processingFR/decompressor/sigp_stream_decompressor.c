@@ -60,9 +60,27 @@
 ;           numberOfChannels: 2,
 ;           bitRate: 128000,
 ;
+;   IMA-ADPCM stream mode (#1) is mono, 2 samples per byte.
+;   IMA-ADPCM block mode (#13) uses the WAV layout, each block is decoded without the previous ones :
+;   a corrupted block header gives a block of silence and the next blocks are decoded normally.
+;   Only complete blocks are consumed. SET_PARAMETER tags :
+;       DECOMPRESSOR_TAG_STATE : STATE_RUN, STATE_PAUSE (silence), STATE_FAST_FORWARD2/4 (1 block 
+;           decoded out of 2 / 4, the others are skipped without decoding)
+;       DECOMPRESSOR_TAG_SKIP  : number of blocks to skip (seek forward in a recorded stream)
+;       DECOMPRESSOR_TAG_BLOCK : block size per channel in bytes (multiple of 4, default 256)
+;
+;   LPC lossless mode (#2) : the frames give their size and number of samples. The bytes before
+;   a valid header are skipped (resynchronization), a frame with a wrong CRC-16 or a different 
+;   number of channels gives a frame of silence. A frame is decoded when it is complete in the 
+;   input arc and when the output arc has its room. STATE_PAUSE gives silence without consuming, 
+;   STATE_FAST_FORWARD2/4 and DECOMPRESSOR_TAG_SKIP drop decoded frames. A frame longer than the 
+;   input arc or with more samples than the output arc is skipped like a wrong header. The reset 
+;   returns NODE_TASKS_ERROR and the node is disabled when the output arc is shorter than 
+;   LPC_MIN_BLOCK frames.
+;
 ;   presets provision
 ;   #1 : decoder IMADPCM
-;   #2 : decoder LPC
+;   #2 : decoder LPC, lossless
 ;   #3 : MIDI player / tone sequencer
 ;   #4 : decoder CVSD for BT speech 
 ;   #5 : decoder LC3 
@@ -73,6 +91,7 @@
 ;   #9 : decoder MPEG-4 aacPlus v2 
 ;   #10: decoder OPUS CELT
 ;   #11: decoder JPEG 
+;   #13: decoder IMADPCM in blocks, multichannel
 */
 
 /**
@@ -103,6 +122,8 @@ void sigp_stream_decompressor (unsigned int command, void *instance, void *data,
                 memresult[7] : output arc WORD 1 - time-stamp, raw format, interleaving, nchan
                 memresult[8] : output arc WORD 2  is domain-dependent : sampling rate
                 memresult[9] : output arc WORD 3  is domain-dependent : audio mapping  
+                memresult[10]: input arc buffer size in bytes
+                memresult[11]: output arc buffer size in bytes
         */
         case STREAM_RESET: 
         {   //stream_services *stream_entry = (stream_services *)data;
@@ -111,6 +132,22 @@ void sigp_stream_decompressor (unsigned int command, void *instance, void *data,
 
             sigp_stream_decompressor_instance *pinstance = (sigp_stream_decompressor_instance *) (memreq[0]);
             pinstance->TCM = (uint32_t *) (memreq[1]);       /* second bank = fast memory */
+            pinstance->nchan = (uint8_t)MIN(IMADPCM_MAX_NCHAN, 1 + RD(memreq[6 + NCHANDOMAIN_FMT1], NCHANM1_FMT1));
+            pinstance->block_bytes = IMADPCM_BLOCK_BYTES;
+            pinstance->skip_blocks = 0;
+            pinstance->in_bufsize = (uint32_t)(memreq[10]);     /* longest LPC frame */
+            pinstance->out_bufsize = (uint32_t)(memreq[11]);    /* LPC frame with the most samples */
+            pinstance->disabled = 0;
+
+            /* the output arc cannot receive the shortest LPC frame */
+            if (RD(command, PRESET_CMD) == DECODER_LPC && pinstance->out_bufsize != 0 && 
+                pinstance->out_bufsize < pinstance->nchan * LPC_MIN_BLOCK * sizeof(int16_t))
+            {   pinstance->disabled = 1;
+                *status = NODE_TASKS_ERROR;
+            }
+
+            /* reconstruction table in fast memory */
+            decode_imadpcm_table_init(pinstance->TCM);
 
             //pinstance->output_format[0] = (memreq[6]);
             //pinstance->output_format[1] = (memreq[7]);
@@ -157,7 +194,7 @@ void sigp_stream_decompressor (unsigned int command, void *instance, void *data,
             {
                 case DECODER_IMADPCM            :
                     nb_samp = (nb_data << 1);   /* one byte generates 2 samples */ 
-                    decode_imadpcm((int32_t *)&(pinstance->memory_state[0]), inBuf, (uint32_t)nb_samp, outBuf, pinstance->decoder_state);
+                    decode_imadpcm((int32_t *)&(pinstance->memory_state[0]), pinstance->TCM, inBuf, (uint32_t)nb_samp, outBuf, pinstance->decoder_state);
 
                     /*  update only the size field 
                         the NODE is producing an amount of data different from the consumed one (see xdm11 in the manifest) 
@@ -171,8 +208,88 @@ void sigp_stream_decompressor (unsigned int command, void *instance, void *data,
                     pt_pt ++;       *(&(pt_pt->size)) = nb_samp * sizeof(SAMP_OUT);     /* amount of data produced */
                     break;
 
-                default:
+                case DECODER_IMADPCM_BLOCK      :
+                {   intptr_t block_samp, block_bytes, step, nb_produced = 0;
+
+                    block_samp = pinstance->nchan * IMADPCM_SAMPLES_PER_BLOCK(pinstance->block_bytes);
+                    block_bytes = pinstance->nchan * pinstance->block_bytes;
+                    step = (pinstance->decoder_state == STATE_FAST_FORWARD2) ? 2 :
+                           (pinstance->decoder_state == STATE_FAST_FORWARD4) ? 4 : 1;
+
+                    /* seek : blocks discarded without decoding */
+                    while (pinstance->skip_blocks > 0 && nb_data >= block_bytes)
+                    {   inBuf += block_bytes;
+                        nb_data -= block_bytes;
+                        pinstance->skip_blocks--;
+                    }
+
+                    while (nb_data >= block_bytes && bufferout_free >= (intptr_t)(block_samp * sizeof(SAMP_OUT)))
+                    {   if (pinstance->decoder_state == STATE_PAUSE)
+                        {   MEMSET(outBuf, 0, block_samp * sizeof(SAMP_OUT));
+                        }
+                        else
+                        {   decode_imadpcm_block(pinstance->TCM, inBuf, pinstance->nchan, pinstance->block_bytes, outBuf);
+                            step = MIN(step, nb_data / block_bytes);    /* fast-forward : skip the next blocks */
+                            inBuf += step * block_bytes;
+                            nb_data -= step * block_bytes;
+                        }
+                        outBuf += block_samp;
+                        bufferout_free -= block_samp * sizeof(SAMP_OUT);
+                        nb_produced += block_samp;
+                    }
+
+                    pt_pt = data;   *(&(pt_pt->size)) = (stream_xdmbuffer_size - nb_data) * sizeof(SAMP_IN);    /* amount of data consumed */
+                    pt_pt ++;       *(&(pt_pt->size)) = nb_produced * sizeof(SAMP_OUT);                         /* amount of data produced */
+                    break;
+                }
+
                 case DECODER_LPC                :
+                {   intptr_t consumed, step, drop = 0, nb_produced = 0;
+                    intptr_t out_samp = bufferout_free / sizeof(SAMP_OUT);
+                    uint32_t n;
+
+                    step = (pinstance->decoder_state == STATE_FAST_FORWARD2) ? 2 :
+                           (pinstance->decoder_state == STATE_FAST_FORWARD4) ? 4 : 1;
+
+                    if (pinstance->disabled)
+                    {   nb_data = stream_xdmbuffer_size;
+                    }
+                    else if (pinstance->decoder_state == STATE_PAUSE)
+                    {   nb_produced = MIN(out_samp, pinstance->nchan * LPC_BLOCK);
+                        MEMSET(outBuf, 0, nb_produced * sizeof(SAMP_OUT));
+                        nb_data = stream_xdmbuffer_size;
+                    }
+
+                    while (0 == pinstance->disabled && pinstance->decoder_state != STATE_PAUSE && nb_data > 0)
+                    {   consumed = decode_lpc_frame((int32_t *)(pinstance->TCM), inBuf, (uint32_t)nb_data, pinstance->in_bufsize, pinstance->nchan,
+                            &(outBuf[nb_produced]), (uint32_t)(out_samp - nb_produced), pinstance->out_bufsize / sizeof(SAMP_OUT), &n);
+                        if (consumed == 0)
+                        {   break;              /* incomplete frame or output full */
+                        }
+                        inBuf += consumed;
+                        nb_data -= consumed;
+
+                        if (n == 0)             /* resynchronization */
+                        {   continue;
+                        }
+                        if (pinstance->skip_blocks > 0)
+                        {   pinstance->skip_blocks--;
+                        }
+                        else if (drop > 0)
+                        {   drop--;
+                        }
+                        else
+                        {   nb_produced += n * pinstance->nchan;
+                            drop = step - 1;
+                        }
+                    }
+
+                    pt_pt = data;   *(&(pt_pt->size)) = (stream_xdmbuffer_size - nb_data) * sizeof(SAMP_IN);    /* amount of data consumed */
+                    pt_pt ++;       *(&(pt_pt->size)) = nb_produced * sizeof(SAMP_OUT);                         /* amount of data produced */
+                    break;
+                }
+
+                default:
                 case DECODER_MIDI               :
                 case DECODER_CVSD               :
                 case DECODER_LC3                :
@@ -192,10 +309,26 @@ void sigp_stream_decompressor (unsigned int command, void *instance, void *data,
         default:
             break;
         case STREAM_SET_PARAMETER:  
-        {   //sigp_stream_decompressor_instance *pinstance = (sigp_stream_decompressor_instance *) instance;
-            //pinstance->decoder_state = STATE_PAUSE;
-            //pinstance->decoder_state = STATE_FAST_FORWARD2;
-            //pinstance->decoder_state = STATE_FAST_FORWARD4;
+        {   sigp_stream_decompressor_instance *pinstance = (sigp_stream_decompressor_instance *) instance;
+            uint8_t *pt8b = (uint8_t *) data;
+
+            switch (RD(command,NODE_TAG_CMD))
+            {   case DECOMPRESSOR_TAG_STATE:    /* STATE_RUN, STATE_PAUSE, STATE_FAST_FORWARD2/4 */
+                    pinstance->decoder_state = pt8b[0];
+                    break;
+                case DECOMPRESSOR_TAG_SKIP:
+                    pinstance->skip_blocks = (uint32_t)pt8b[0] | ((uint32_t)pt8b[1] << 8) | 
+                                             ((uint32_t)pt8b[2] << 16) | ((uint32_t)pt8b[3] << 24);
+                    break;
+                case DECOMPRESSOR_TAG_BLOCK:
+                {   uint16_t bytes = (uint16_t)(pt8b[0] | (pt8b[1] << 8));
+                    bytes = (uint16_t)MAX(IMADPCM_MIN_BLOCK_BYTES, MIN(IMADPCM_MAX_BLOCK_BYTES, bytes));
+                    pinstance->block_bytes = (uint16_t)(bytes & ~3);
+                    break;
+                }
+                default:
+                    break;
+            }
             break;
         }
         case STREAM_READ_PARAMETER:  
@@ -36,6 +36,7 @@
 //#include "stream_const.h"      
 //#include "stream_types.h"  
 #include "sigp_stream_decompressor_imadpcm.h"
+#include "sigp_stream_decompressor_lpc.h"
 
 #define DECODER_IMADPCM          1  
 #define DECODER_LPC              2  
@@ -49,6 +50,11 @@
 #define DECODER_MPEG4_AACPLUS_V2 10  
 #define DECODER_OPUS_CELT        11 
 #define DECODER_JPEG             12 
+#define DECODER_IMADPCM_BLOCK    13             /* IMA-ADPCM blocks with headers, interleaved channels */
+
+#define DECOMPRESSOR_TAG_STATE    1             /* SET_PARAMETER : uint8 decoder_state (STATE_RUN, _PAUSE, _FAST_FORWARD2/4) */
+#define DECOMPRESSOR_TAG_SKIP     2             /* SET_PARAMETER : uint32 number of blocks (LPC frames) to skip */
+#define DECOMPRESSOR_TAG_BLOCK    3             /* SET_PARAMETER : uint16 block size per channel in bytes */
 
 
 #define STATE_generic_SIZE 4                    /* node_malloc_add  defines the effective size, depending on presets/Codec selection  */
@@ -61,6 +67,13 @@ typedef struct
     stream_services *stream_service_entry;
     uint32_t output_format[STREAM_FORMAT_SIZE_W32];
 
+    uint8_t nchan;                              /* interleaved channels of the output arc */
+    uint16_t block_bytes;                       /* block size per channel (DECODER_IMADPCM_BLOCK) */
+    uint32_t skip_blocks;                       /* blocks to discard without decoding */
+    uint32_t in_bufsize;                        /* buffer size of the input arc in bytes, 0 when unknown */
+    uint32_t out_bufsize;                       /* buffer size of the output arc in bytes, 0 when unknown */
+    uint8_t disabled;                           /* reset failed (output arc too small) : no processing */
+
     /* LAST FIELD OF THE DECLARATION,  to let it grow without changing the "*TCM" field 
     
         state = decoder state + memory state  of the filters
@@ -78,7 +91,7 @@ typedef struct
 #define STATE_FAST_FORWARD4 5  // play speed x 4
 
 
-extern void decode_imadpcm(int32_t *state, uint8_t* input, uint32_t numSamples, int16_t* output, uint8_t decoder_state);
+extern void decode_imadpcm(int32_t *state, const uint32_t *table, uint8_t* input, uint32_t numSamples, int16_t* output, uint8_t decoder_state);
 
 #endif //csigp_STREAM_DECOMPRESSOR_H
 
@@ -101,92 +101,118 @@ static int16_t stepsizeTable[89] = {
 };
 
 
-  inline int32_t __SSAT(int32_t val, uint32_t sat)
-  {
-    if ((sat >= 1U) && (sat <= 32U))
-    {
-      const int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
-      const int32_t min = -1 - max ;
-      if (val > max)
-      {
-        return max;
-      }
-      else if (val < min)
-      {
-        return min;
-      }
+
+/*
+    table[16 x index + code] = (signed difference added to the predictor << 12) | (16 x next index)
+    the decoding of a sample is one load, one add and one saturation
+*/
+void decode_imadpcm_table_init(uint32_t *table)
+{
+    int32_t index, code, step, vpdiff, next;
+
+    for (index = 0; index < IMADPCM_NB_INDEX; index++)
+    {   step = stepsizeTable[index];
+        for (code = 0; code < 16; code++)
+        {   vpdiff = step >> 3;
+            if (code & 4) vpdiff += step;
+            if (code & 2) vpdiff += step >> 1;
+            if (code & 1) vpdiff += step >> 2;
+            if (code & 8) vpdiff = -vpdiff;
+
+            next = MAX(0, MIN(IMADPCM_NB_INDEX - 1, index + indexTable[code]));
+            table[(index << 4) + code] = ((uint32_t)vpdiff << 12) | (uint32_t)(next << 4);
+        }
+    }
+}
+
+
+/*
+    2 x nbytes samples written with a stride, first sample in the low nibble,
+    the input pointer jumps after each group of 4 bytes (interleaved channels of the blocks)
+*/
+static void imadpcm_decode_nibbles(const uint32_t *table, int32_t *pvalpred, int32_t *prow, 
+                uint8_t *input, int32_t nbytes, int32_t in_jump, int16_t *output, int32_t out_stride)
+{
+    int32_t b, e, valpred = *pvalpred, row = *prow;
+    uint8_t code;
+
+    for (b = 0; b < nbytes; b++)
+    {   code = *input++;
+
+        e = (int32_t)table[row + (code & 0xF)];
+        valpred = MAX(-32768, MIN(32767, valpred + (e >> 12)));
+        row = e & 0xFFF;
+        output[0] = (int16_t)valpred;
+
+        e = (int32_t)table[row + (code >> 4)];
+        valpred = MAX(-32768, MIN(32767, valpred + (e >> 12)));
+        row = e & 0xFFF;
+        output[out_stride] = (int16_t)valpred;
+
+        output += 2 * out_stride;
+        if ((b & 3) == 3)
+        {   input += in_jump;
+        }
     }
-    return val;
-  }
- 
-void decode_imadpcm(int32_t *state, uint8_t* input, uint32_t numSamples, int16_t* output, uint8_t decoder_state)
+    *pvalpred = valpred;
+    *prow = row;
+}
+
+
+/*
+        Stream mode (mono) : two samples per byte, first sample in the low nibble
+*/
+void decode_imadpcm(int32_t *state, const uint32_t *table, uint8_t* input, uint32_t numSamples, int16_t* output, uint8_t decoder_state)
 {
-    int8_t  sign;			/* Current adpcm sign bit #TODO Remove if sign bit of diff can be used directly */
-    int16_t delta;			/* Current adpcm output value */
-    //int16_t diff;			/* Difference between val and valprev */
-    int16_t step;			/* Stepsize */
-    int16_t valpred;		/* Predicted output value */
-    int16_t vpdiff;			/* Current change to valpred */
-    int16_t index;			/* Current step change index */
-	int16_t inputbuffer;		/* place to keep next 4-bit value */
-    int16_t bufferstep;		/* toggle between inputbuffer/input */
+    int32_t valpred, row;
+    uint32_t i;
    
-    valpred = (int16_t)state[VALPREV];
-    index = (int16_t)state[INDEX];
-    step = stepsizeTable[index];
-
-    inputbuffer = bufferstep = 0;
-    
-    for ( ; numSamples > 0 ; numSamples-- ) {
-	
-	    /* Step 1 - get the delta value */
-	    if ( bufferstep ) {
-	        delta = inputbuffer & 0xf;
-	    } else {
-	        inputbuffer = *input++;
-	        delta = (inputbuffer >> 4) & 0xf;
-	    }
-	    bufferstep = !bufferstep;
-
-	    /* Step 2 - Find new index value (for later) */
-	    index += indexTable[delta];
-	    if ( index < 0 ) index = 0;
-	    if ( index > 88 ) index = 88;
-
-	    /* Step 3 - Separate sign and magnitude */
-	    sign = delta & 8;
-	    delta = delta & 7;
-
-	    /* Step 4 - Compute difference and new predicted value */
-	    /*
-	    ** Computes 'vpdiff = (delta+0.5)*step/4', but see comment
-	    ** in adpcm_coder.
-	    */
-	    vpdiff = step >> 3;
-	    if ( delta & 4 ) vpdiff += step;
-	    if ( delta & 2 ) vpdiff += step>>1;
-	    if ( delta & 1 ) vpdiff += step>>2;
-
-        if (sign)
-	        valpred = valpred - vpdiff;
-        else
-	        valpred = valpred + vpdiff;
-
-        __SSAT(valpred,16);
-
-	    /* Step 6 - Update step value */
-	    step = stepsizeTable[index];
-
-	    /* Step 7 - Output value */
-        if (decoder_state == STATE_PAUSE)
-        {   *output++ = 0;
-        } else
-        {   *output++ = valpred;
+    valpred = state[VALPREV];
+    row = state[INDEX] << 4;
+
+    imadpcm_decode_nibbles(table, &valpred, &row, input, (int32_t)(numSamples >> 1), 0, output, 1);
+
+    if (decoder_state == STATE_PAUSE)
+    {   for (i = 0; i < numSamples; i++)
+        {   output[i] = 0;
         }
     }
 
     state[VALPREV] = valpred;
-    state[INDEX] = index;
+    state[INDEX] = row >> 4;
+}
+
+
+/*
+        Block mode (WAV IMA-ADPCM layout) : one header of 4 bytes per channel (first sample of the 
+        block, step index, 0), followed by groups of 4 bytes (8 samples) of each channel in turn.
+        The channels are decoded independently. A corrupted header gives a block of silence.
+        output : IMADPCM_SAMPLES_PER_BLOCK(block_bytes) interleaved frames
+*/
+void decode_imadpcm_block(const uint32_t *table, uint8_t* input, uint32_t nchan, uint32_t block_bytes, int16_t* output)
+{
+    int32_t valpred, row, nsamp;
+    uint32_t ch, i;
+
+    for (ch = 0; ch < nchan; ch++)
+    {   uint8_t *header = &(input[4*ch]);
+
+        if (header[2] >= IMADPCM_NB_INDEX || header[3] != 0)
+        {   nsamp = IMADPCM_SAMPLES_PER_BLOCK(block_bytes);
+            for (i = 0; i < (uint32_t)nsamp; i++)
+            {   output[i * nchan + ch] = 0;
+            }
+            continue;
+        }
+
+        valpred = (int16_t)(header[0] | (header[1] << 8));
+        row = header[2] << 4;
+        output[ch] = (int16_t)valpred;
+
+        imadpcm_decode_nibbles(table, &valpred, &row, &(input[(nchan + ch) * IMADPCM_HEADER_BYTES]), 
+                (int32_t)(block_bytes - IMADPCM_HEADER_BYTES), (int32_t)(IMADPCM_HEADER_BYTES * (nchan - 1)),
+                &(output[nchan + ch]), (int32_t)nchan);
+    }
 }
 
-#endif //CODE_SIGP_STREAM_DECOMPRESSOR
+#endif //CODE_SIGP_STREAM_DECOMPRESSOR
\ No newline at end of file
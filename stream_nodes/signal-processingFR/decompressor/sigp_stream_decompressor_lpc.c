@@ -0,0 +1,367 @@
+/* ----------------------------------------------------------------------
+ * Title:        sigp_stream_decompressor_lpc.c
+ * Description:  lossless decoder, linear prediction and Rice codes
+ *
+ * $Date:        15 February 2024
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2024 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ */
+
+/*
+    Decoder of the frames of sigp_stream_compressor_lpc.c. Each frame is decoded without the
+    previous ones : the bytes preceding a valid header (sync word and CRC-8) are skipped, a frame
+    with a wrong CRC-16 gives a frame of silence of the same duration.
+*/
+
+#include "presets.h"
+#ifdef CODE_SIGP_STREAM_DECOMPRESSOR
+
+#include <stdint.h>
+
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "sigp_stream_decompressor_lpc.h"
+
+
+/* CRC-16 polynomial 0x8005 */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,
+    0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022,
+    0x8063, 0x0066, 0x006C, 0x8069, 0x0078, 0x807D, 0x8077, 0x0072,
+    0x0050, 0x8055, 0x805F, 0x005A, 0x804B, 0x004E, 0x0044, 0x8041,
+    0x80C3, 0x00C6, 0x00CC, 0x80C9, 0x00D8, 0x80DD, 0x80D7, 0x00D2,
+    0x00F0, 0x80F5, 0x80FF, 0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1,
+    0x00A0, 0x80A5, 0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1,
+    0x8093, 0x0096, 0x009C, 0x8099, 0x0088, 0x808D, 0x8087, 0x0082,
+    0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197, 0x0192,
+    0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE, 0x01A4, 0x81A1,
+    0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB, 0x01FE, 0x01F4, 0x81F1,
+    0x81D3, 0x01D6, 0x01DC, 0x81D9, 0x01C8, 0x81CD, 0x81C7, 0x01C2,
+    0x0140, 0x8145, 0x814F, 0x014A, 0x815B, 0x015E, 0x0154, 0x8151,
+    0x8173, 0x0176, 0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162,
+    0x8123, 0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
+    0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104, 0x8101,
+    0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D, 0x8317, 0x0312,
+    0x0330, 0x8335, 0x833F, 0x033A, 0x832B, 0x032E, 0x0324, 0x8321,
+    0x0360, 0x8365, 0x836F, 0x036A, 0x837B, 0x037E, 0x0374, 0x8371,
+    0x8353, 0x0356, 0x035C, 0x8359, 0x0348, 0x834D, 0x8347, 0x0342,
+    0x03C0, 0x83C5, 0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1,
+    0x83F3, 0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2,
+    0x83A3, 0x03A6, 0x03AC, 0x83A9, 0x03B8, 0x83BD, 0x83B7, 0x03B2,
+    0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E, 0x0384, 0x8381,
+    0x0280, 0x8285, 0x828F, 0x028A, 0x829B, 0x029E, 0x0294, 0x8291,
+    0x82B3, 0x02B6, 0x02BC, 0x82B9, 0x02A8, 0x82AD, 0x82A7, 0x02A2,
+    0x82E3, 0x02E6, 0x02EC, 0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2,
+    0x02D0, 0x82D5, 0x82DF, 0x02DA, 0x82CB, 0x02CE, 0x02C4, 0x82C1,
+    0x8243, 0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252,
+    0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264, 0x8261,
+    0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231,
+    0x8213, 0x0216, 0x021C, 0x8219, 0x0208, 0x820D, 0x8207, 0x0202
+};
+
+
+#if defined(__GNUC__)
+#define LPC_CLZ64(x) __builtin_clzll(x)
+#else
+static int32_t LPC_CLZ64 (uint64_t x)
+{   int32_t n = 0;
+    while ((x & 0x8000000000000000ull) == 0)
+    {   x <<= 1;
+        n++;
+    }
+    return n;
+}
+#endif
+
+
+typedef struct
+{   const uint8_t *p;
+    const uint8_t *end;
+    uint64_t cache;             /* MSB aligned */
+    int32_t bits;
+    int32_t over;               /* zero bytes read after the end */
+} lpc_bitreader;
+
+
+static void lpc_refill (lpc_bitreader *br)
+{
+    while (br->bits <= 56)
+    {   uint64_t b;
+        if (br->p < br->end)
+        {   b = *(br->p)++;
+        }
+        else
+        {   b = 0;
+            br->over++;
+        }
+        br->cache |= b << (56 - br->bits);
+        br->bits += 8;
+    }
+}
+
+/* n <= 24 bits */
+static uint32_t lpc_get (lpc_bitreader *br, int32_t n)
+{
+    uint32_t v;
+
+    if (n == 0)
+    {   return 0;
+    }
+    if (br->bits < n)
+    {   lpc_refill(br);
+    }
+    v = (uint32_t)(br->cache >> (64 - n));
+    br->cache <<= n;
+    br->bits -= n;
+    return v;
+}
+
+static int32_t lpc_get_signed (lpc_bitreader *br, int32_t n)
+{
+    uint32_t v = lpc_get(br, n);
+
+    if (n == 0)
+    {   return 0;
+    }
+    return (int32_t)(v << (32 - n)) >> (32 - n);
+}
+
+/* zeros before the next one, -1 on a stream error */
+static int32_t lpc_get_unary (lpc_bitreader *br)
+{
+    int32_t q = 0, z;
+
+    if (br->bits <= 56)
+    {   lpc_refill(br);
+    }
+    while (br->cache == 0)
+    {   q += br->bits;
+        br->cache = 0;
+        br->bits = 0;
+        lpc_refill(br);
+        if (br->over > 8)
+        {   return -1;
+        }
+    }
+    z = LPC_CLZ64(br->cache);
+    br->cache <<= z;
+    br->cache <<= 1;
+    br->bits -= z + 1;
+    return q + z;
+}
+
+
+static uint8_t lpc_crc8 (const uint8_t *p, int32_t n)
+{
+    uint8_t crc = 0;
+    int32_t i, b;
+
+    for (i = 0; i < n; i++)
+    {   crc ^= p[i];
+        for (b = 0; b < 8; b++)
+        {   crc = (uint8_t)((crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1));
+        }
+    }
+    return crc;
+}
+
+static uint16_t lpc_crc16 (const uint8_t *p, int32_t n)
+{
+    uint16_t crc = 0;
+    int32_t i;
+
+    for (i = 0; i < n; i++)
+    {   crc = (uint16_t)((crc << 8) ^ crc16_table[(crc >> 8) ^ p[i]]);
+    }
+    return crc;
+}
+
+
+/* residuals e[order .. n-1], returns 0 on a stream error */
+static int32_t lpc_get_residual (lpc_bitreader *br, int32_t *e, int32_t n, int32_t order)
+{
+    int32_t p, j, i, k, len, start, q;
+    uint32_t u;
+
+    p = (int32_t)lpc_get(br, 4);
+    len = n >> p;
+    if (p > LPC_MAX_PARTITION_ORDER || (len << p) != n || len <= order)
+    {   return 0;
+    }
+    for (j = 0; j < (1 << p); j++)
+    {   start = (j == 0) ? order : j * len;
+        k = (int32_t)lpc_get(br, 5);
+
+        if (k == LPC_RICE_ESCAPE)
+        {   int32_t w = (int32_t)lpc_get(br, 5);
+            if (w > 24)
+            {   return 0;
+            }
+            for (i = start; i < (j + 1) * len; i++)
+            {   e[i] = lpc_get_signed(br, w);
+            }
+        }
+        else
+        {   if (k > 22)
+            {   return 0;
+            }
+            for (i = start; i < (j + 1) * len; i++)
+            {   q = lpc_get_unary(br);
+                if (q < 0 || q > (1 << (24 - k)))
+                {   return 0;
+                }
+                u = ((uint32_t)q << k) | lpc_get(br, k);
+                e[i] = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+            }
+        }
+    }
+    return 1;
+}
+
+
+/* one subframe into the interleaved output, returns 0 on a stream error */
+static int32_t lpc_subframe (lpc_bitreader *br, int32_t *e, int16_t *x, int32_t s, int32_t n)
+{
+    int32_t type, order, shift = 0, i, j, pred;
+    int32_t q [LPC_MAX_ORDER];
+
+    type = (int32_t)lpc_get(br, 2);
+    switch (type)
+    {
+    case LPC_SUB_CONSTANT:
+    {   int16_t v = (int16_t)lpc_get(br, 16);
+        for (i = 0; i < n; i++)
+        {   x[i*s] = v;
+        }
+        return 1;
+    }
+    case LPC_SUB_VERBATIM:
+        for (i = 0; i < n; i++)
+        {   x[i*s] = (int16_t)lpc_get(br, 16);
+        }
+        return 1;
+
+    case LPC_SUB_FIXED:
+        order = (int32_t)lpc_get(br, 3);
+        if (order > LPC_FIXED_MAX_ORDER)
+        {   return 0;
+        }
+        break;
+
+    default:
+        order = 1 + (int32_t)lpc_get(br, 3);
+        shift = (int32_t)lpc_get(br, 4);
+        for (j = 0; j < order; j++)
+        {   q[j] = lpc_get_signed(br, LPC_COEF_BITS);
+        }
+        break;
+    }
+
+    for (i = 0; i < order; i++)
+    {   x[i*s] = (int16_t)lpc_get(br, 16);
+    }
+    if (0 == lpc_get_residual(br, e, n, order))
+    {   return 0;
+    }
+
+    if (type == LPC_SUB_FIXED)
+    {   switch (order)
+        {
+        case 0: for (i = 0; i < n; i++) x[i*s] = (int16_t)e[i]; break;
+        case 1: for (i = 1; i < n; i++) x[i*s] = (int16_t)(e[i] + x[(i-1)*s]); break;
+        case 2: for (i = 2; i < n; i++) x[i*s] = (int16_t)(e[i] + 2*x[(i-1)*s] - x[(i-2)*s]); break;
+        case 3: for (i = 3; i < n; i++) x[i*s] = (int16_t)(e[i] + 3*x[(i-1)*s] - 3*x[(i-2)*s] + x[(i-3)*s]); break;
+        default:for (i = 4; i < n; i++) x[i*s] = (int16_t)(e[i] + 4*x[(i-1)*s] - 6*x[(i-2)*s] + 4*x[(i-3)*s] - x[(i-4)*s]); break;
+        }
+    }
+    else
+    {   for (i = order; i < n; i++)
+        {   for (pred = 0, j = 0; j < order; j++)
+            {   pred += q[j] * x[(i-1-j)*s];
+            }
+            x[i*s] = (int16_t)(e[i] + (pred >> shift));
+        }
+    }
+    return 1;
+}
+
+
+/*
+    decodes the frame at the start of the input 
+    returns the number of bytes consumed : 0 when the frame is incomplete or when the output is 
+        too small, the bytes before the next sync word when the header is not valid
+    max_bytes : size of the input buffer, 0 when unknown. A longer frame can never be complete
+        in the buffer, its header is not valid even with a correct CRC-8
+    max_samples : size of the output buffer in samples, 0 when unknown. A frame with more samples
+        can never be decoded in the buffer, its header is not valid either
+    *nsamp : samples per channel written in the output, silence when the CRC-16 is wrong
+    scratch : LPC_MAX_BLOCK words of 32 bits
+*/
+int32_t decode_lpc_frame (int32_t *scratch, uint8_t *input, uint32_t nb_bytes, uint32_t max_bytes, 
+                uint32_t nchan, int16_t *output, uint32_t output_samples, uint32_t max_samples, uint32_t *nsamp)
+{
+    lpc_bitreader br;
+    uint32_t n, length, ch, skip;
+    int32_t valid;
+
+    *nsamp = 0;
+    if (nb_bytes < LPC_HEADER_BYTES)
+    {   return 0;
+    }
+
+    n = (uint32_t)input[2] | ((uint32_t)input[3] << 8);
+    length = (uint32_t)input[4] | ((uint32_t)input[5] << 8) | ((uint32_t)input[6] << 16);
+
+    /* resynchronization on the next sync word */
+    if (input[0] != LPC_SYNC0 || input[1] != LPC_SYNC1 || lpc_crc8(input, 8) != input[8] ||
+        n < LPC_MIN_BLOCK || n > LPC_MAX_BLOCK || input[7] == 0 || input[7] > LPC_MAX_NCHAN ||
+        length < LPC_HEADER_BYTES + LPC_CRC_BYTES || length > LPC_MAX_FRAME_BYTES(input[7], n) ||
+        (max_bytes != 0 && length > max_bytes) || (max_samples != 0 && n * nchan > max_samples))
+    {   for (skip = 1; skip < nb_bytes - 1; skip++)
+        {   if (input[skip] == LPC_SYNC0 && input[skip + 1] == LPC_SYNC1)
+            {   break;
+            }
+        }
+        return (int32_t)skip;
+    }
+    if (length > nb_bytes || n * nchan > output_samples)
+    {   return 0;
+    }
+
+    valid = (input[7] == nchan) &&
+        (lpc_crc16(input, (int32_t)length - LPC_CRC_BYTES) == (((uint16_t)input[length - 2] << 8) | input[length - 1]));
+
+    br.p = &(input[LPC_HEADER_BYTES]);
+    br.end = &(input[length - LPC_CRC_BYTES]);
+    br.cache = 0;
+    br.bits = 0;
+    br.over = 0;
+    for (ch = 0; valid && ch < nchan; ch++)
+    {   valid = lpc_subframe(&br, scratch, &(output[ch]), (int32_t)nchan, (int32_t)n);
+    }
+    if (!valid || br.over * 8 > br.bits)
+    {   MEMSET(output, 0, n * nchan * sizeof(int16_t));
+    }
+
+    *nsamp = n;
+    return (int32_t)length;
+}
+
+#endif
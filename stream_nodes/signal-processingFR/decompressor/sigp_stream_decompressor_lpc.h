@@ -0,0 +1,39 @@
+/* ----------------------------------------------------------------------
+ * Title:        sigp_stream_decompressor_lpc.h
+ *
+ * Description:  lossless decoder, linear prediction and Rice codes
+ *
+ * $Date:        15 February 2024
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2024 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ */
+
+#ifndef cSIGP_STREAM_DEC_LPC_H
+#define cSIGP_STREAM_DEC_LPC_H
+
+
+#include <stdint.h>
+
+#include "../sigp_stream_lpc.h"     /* frame format shared with the encoder */
+
+extern int32_t decode_lpc_frame(int32_t *scratch, uint8_t *input, uint32_t nb_bytes, uint32_t max_bytes, 
+                uint32_t nchan, int16_t *output, uint32_t output_samples, uint32_t max_samples, uint32_t *nsamp);
+
+#endif
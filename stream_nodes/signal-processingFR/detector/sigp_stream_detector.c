@@ -58,6 +58,11 @@
 ;
 ;   preset parameter : 8bit sensitivity
 ;
+;   Multichannel interleaved S16 input (up to 8 channels), the decision is taken every 16 samples
+;   on one of the channels (DETECTOR_DECISION_SNR), on all the channels (DETECTOR_DECISION_SNR_ALL)
+;   or with an absolute level (DETECTOR_DECISION_LEVEL). On the platforms with PLATFORM_NODE_TRACES
+;   the traces of the decisions are saved in the ring of node_mem 2 (node_manifest_detector_trace.txt).
+;
 ;   Metadata information can be extracted with the command "TAG_CMD" from parameter-read:
 ;   0 read the floor noise level
 ;   1 read the current signal peak
@@ -66,7 +71,7 @@
 sigp_stream_detector
     3  i8; 0 0 0        instance, preset, tag
     PARSTART
-    8; i8; 1;2;3;4;5;6;7;8; the 8 bytes of "struct detector_parameters"
+    9; i8; 1;2;3;4;5;6;7;8;0; the 9 bytes of "struct detector_parameters"
     PARSTOP  
 */
 
@@ -79,12 +84,12 @@ const detector_parameters detector_preset [NB_PRESET] =
         high_pass_shifter, low_pass_shifter, low_pass_z7_z8,  
         vad_rise, vad_fall, THR */
 
-    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #0 no HPF, fast for button debouncing */
-    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #1 VAD with HPF pre-filtering, tuned for Fs <20kHz */
-    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #2 VAD with HPF pre-filtering, tuned for Fs >20kHz */
-    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #3 IMU detector : HPF, slow time constants */
-    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #4 IMU detector : HPF, fast time constants */
-    {MINIF(1,12), 6,   4, 6, 11,  MINIF(1,20), MINIF(1,22), MINIF(4,0)}, /* #5 same as #1 with faster reaction time  */
+    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0), DETECTOR_DECISION_SNR}, /* #0 no HPF, fast for button debouncing */
+    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0), DETECTOR_DECISION_SNR}, /* #1 VAD with HPF pre-filtering, tuned for Fs <20kHz */
+    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0), DETECTOR_DECISION_SNR}, /* #2 VAD with HPF pre-filtering, tuned for Fs >20kHz */
+    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0), DETECTOR_DECISION_SNR}, /* #3 IMU detector : HPF, slow time constants */
+    {MINIF(1,12), 8,   3, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0), DETECTOR_DECISION_SNR}, /* #4 IMU detector : HPF, fast time constants */
+    {MINIF(1,12), 6,   4, 6, 11,  MINIF(1,20), MINIF(1,22), MINIF(4,0), DETECTOR_DECISION_SNR}, /* #5 same as #1 with faster reaction time  */
 };
 
 /**
@@ -111,9 +116,16 @@ void sigp_stream_detector (unsigned int command, void *instance, void *data, uns
         {   //stream_services *stream_entry = (stream_services *)data;
             intptr_t *memresults = (intptr_t *)instance;
             uint16_t preset = RD(command, PRESET_CMD);
+            uint8_t ch;
 
             sigp_detector_instance *pinstance = (sigp_detector_instance *) *memresults++;
             pinstance->backup =  (sigp_backup_memory *)*memresults++;
+            pinstance->ring =  (sigp_detector_trace_ring *)*memresults++;
+
+            /* memresults = {instance, backup, trace, 4 format words of arc 0 ..} */
+            pinstance->nchan = (uint8_t)MIN(DETECTOR_MAX_NCHAN, 1 + RD(memresults[NCHANDOMAIN_FMT1], NCHANM1_FMT1));
+            pinstance->nblock = 0;
+            pinstance->ring->write_index = 0;
 
             /* trace ID */
             pinstance->traceID_tag = RD(command, NODE_TAG_CMD);
@@ -123,8 +135,10 @@ void sigp_stream_detector (unsigned int command, void *instance, void *data, uns
             if (COMMDEXT_COLD_BOOT == RD(command, COMMDEXT_CMD))
             {
                 /* here COLD reset */
-                pinstance->z1 = F2Q31(0.00001);
-                pinstance->z6 = F2Q31(0.00001);
+                for (ch = 0; ch < DETECTOR_MAX_NCHAN; ch++)
+                {   pinstance->z1[ch] = F2Q31(0.00001);
+                    pinstance->z6[ch] = F2Q31(0.00001);
+                }
             }
             else /* wsigp boot */
             {
@@ -143,9 +157,11 @@ void sigp_stream_detector (unsigned int command, void *instance, void *data, uns
 
             pinstance->config = detector_preset[preset];    /* preset data move */
             pinstance->services = (stream_services *)data;
-            pinstance->decf = decfMASK; 
-            pinstance->backup->z8 = F2Q31(0.00001);
-            pinstance->backup->z7 = F2Q31(0.001);
+            for (ch = 0; ch < DETECTOR_MAX_NCHAN; ch++)
+            {   pinstance->peak[ch] = pinstance->valley[ch] = pinstance->z6[ch];
+                pinstance->backup->z8[ch] = F2Q31(0.00001);
+                pinstance->backup->z7[ch] = F2Q31(0.001);
+            }
             pinstance->backup->down_counter = 0;
 
             break;
@@ -158,8 +174,10 @@ void sigp_stream_detector (unsigned int command, void *instance, void *data, uns
         */ 
         case STREAM_SET_PARAMETER:
         {   sigp_detector_instance *pinstance = (sigp_detector_instance *) instance;
-            pinstance->config = detector_preset[RD(command,NODE_TAG_CMD)];
 
+            if (RD(command,NODE_TAG_CMD) < NB_PRESET)
+            {   pinstance->config = detector_preset[RD(command,NODE_TAG_CMD)];
+            }
             if (RD(command,NODE_TAG_CMD) == NODE_ALL_PARAM) 
             {   uint8_t *pt8bsrc, *pt8bdst, i, n;
 
@@ -199,11 +217,12 @@ void sigp_stream_detector (unsigned int command, void *instance, void *data, uns
             bufferout_free        = pt_pt->size;
 
             nb_data = stream_xdmbuffer_size / sizeof(SAMP_IN);
+            nb_data = (nb_data / pinstance->nchan) * pinstance->nchan;     /* complete frames */
 
             sigp_stream_detector_process (pinstance, inBuf, (int32_t)nb_data, outBuf);
 
             pt_pt = data;
-            *(&(pt_pt->size)) = nb_data * sizeof(SAMP_IN); /* amount of data consumed */
+            *(&(pt_pt->size)) = nb_data * sizeof(SAMP_IN); /* amount of data consumed : nframe x nchan samples */
             pt_pt ++;
             *(&(pt_pt->size)) = 1 * sizeof(SAMP_OUT);   /* amount of data produced */
             break;
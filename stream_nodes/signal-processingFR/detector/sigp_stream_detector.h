@@ -57,7 +57,15 @@ enum STREAM_DETECTOR_PRESETS
 };
 
 
-typedef struct          /* 8 Bytes  */
+#define DETECTOR_MAX_NCHAN      8
+#define DETECTOR_BLOCK_LOG2     4           /* envelope and decisions updated every 16 samples */
+#define DETECTOR_BLOCK          (1 << DETECTOR_BLOCK_LOG2)
+
+#define DETECTOR_DECISION_SNR       0       /* envelope / floor above THR on one of the channels */
+#define DETECTOR_DECISION_LEVEL     1       /* envelope above the level MINIFLOAT2Q31(THR) */
+#define DETECTOR_DECISION_SNR_ALL   2       /* envelope / floor above THR on all the channels */
+
+typedef struct          /* 9 Bytes  */
 {
 /* 
     76543210
@@ -71,21 +79,22 @@ typedef struct          /* 8 Bytes  */
 */
     uint8_t log2counter;        /* sample counter= 2^(log2counter/8) x (2^(log2counter&7))/8  [0 .. ~2^32]
                                     maintains the "detected" flag at least for this number of samples */
-    uint8_t log2decfMASK;        /* decimation = a power of 2 (-1) */
+    uint8_t log2decfMASK;       /* slow-down of the floor tracking (power of 2) */
     uint8_t high_pass_shifter;  /* for z1 */
     uint8_t low_pass_shifter;   /* for z6 */
     uint8_t floor_peak_shifter; /* for z7 */
     uint8_t vad_rise;           /* rise time MiniFloat Mantissa 3bits Exponent 5bits */
     uint8_t vad_fall;           /* fall time Mantissa=[0..7] Exponent=(-1)x[0..31] */
     uint8_t THR;                /* detection threshold z8/z7 */
+    uint8_t decision;           /* DETECTOR_DECISION_xx */
 } detector_parameters;
 
 
 
 typedef struct
 {
-    int32_t z7;    /* memory of the floor-noise tracking low-pass filter */
-    int32_t z8;    /* memory of the envelope tracking low-pass filter */
+    int32_t z7[DETECTOR_MAX_NCHAN];     /* memory of the floor-noise tracking low-pass filter */
+    int32_t z8[DETECTOR_MAX_NCHAN];     /* memory of the envelope tracking low-pass filter */
     int32_t accvad;/* accumulator / estimation */
     int32_t Flag;  /* accumulator 2 / estimation  */
     int32_t down_counter;    /* memory of the debouncing downcounter  */
@@ -94,18 +103,48 @@ typedef struct
 } sigp_backup_memory;
 
 
+/* 
+    debug traces in memory (node_mem 2) instead of file IO : one entry per block, 
+    the oldest entry is overwritten. The platforms with PLATFORM_NODE_TRACES use 
+    node_manifest_detector_trace.txt, the others allocate the ring without entries (28 bytes)
+*/
+#ifdef PLATFORM_NODE_TRACES
+#define DETECTOR_TRACE_DEPTH    64
+#else
+#define DETECTOR_TRACE_DEPTH    0
+#endif
+
+typedef struct
+{
+    int32_t peak;           /* max of z6 in the block, channel 0 */
+    int32_t floor;          /* z7 */
+    int32_t envelope;       /* z8 */
+    int32_t accvad;
+    int32_t flag;
+    int32_t detected;       /* 0x7FFFFFFF or 0 */
+} sigp_detector_trace;
+
+typedef struct
+{
+    uint32_t write_index;   /* entries written, modulo DETECTOR_TRACE_DEPTH gives the next entry */
+    sigp_detector_trace trace[DETECTOR_TRACE_DEPTH + 1];     /* +1 : no empty array */
+} sigp_detector_trace_ring;
+
+
 typedef struct 
 {
     stream_services *services;
-    detector_parameters config; /* 8 bytes */
-    int32_t z1;    /* memory of the high-pass filter (recursive part) */
-    int32_t z2;    /* memory of the high-pass filter (direct part) */
-    int32_t z3;    /* output of the high-pass filter */
-    int32_t decf;  /* memory of the decimator for z7/floor noise estimation */
-    int32_t z6;    /* memory of the first low-pass filter */
+    detector_parameters config; /* 9 bytes */
+    uint8_t nchan;
+    uint8_t nblock;             /* samples of the current block */
+    int32_t z1[DETECTOR_MAX_NCHAN];     /* memory of the high-pass filter (recursive part) */
+    int32_t z6[DETECTOR_MAX_NCHAN];     /* memory of the first low-pass filter */
+    int32_t peak[DETECTOR_MAX_NCHAN];   /* max of z6 in the current block */
+    int32_t valley[DETECTOR_MAX_NCHAN]; /* min of z6 in the current block */
     uint32_t traceID_tag; 
 
     sigp_backup_memory *backup;
+    sigp_detector_trace_ring *ring;
 
 } sigp_detector_instance;
 
@@ -123,17 +162,12 @@ typedef struct
 #define CLAMP_MIN  F2Q31(0.0001)
 // Clamping to prevent overflow of intermediate calculations and flags
 
-// Note extra headroom required for low fs
-#define CLAMP_MAX  F2Q31(0.98)-VADRISE-VADFALL
+// Note extra headroom required for low fs, the counters are incremented once per block
+#define CLAMP_MAX  (F2Q31(0.98)-DETECTOR_BLOCK*(VADRISE+VADFALL))
 
 // Filter variables
-#define Z1 pinstance->z1
-#define Z2 pinstance->z2
-#define Z3 pinstance->z3
-#define Z6 pinstance->z6
 #define Z7 pinstance->backup->z7
 #define Z8 pinstance->backup->z8
-#define DECF pinstance->decf
 #define ACCVAD pinstance->backup->accvad
 #define FLAG pinstance->backup->Flag
 #define SHPF pinstance->config.high_pass_shifter
@@ -147,9 +181,6 @@ typedef struct
 // if we do need separate values for each
 #define SFloorPeak pinstance->config.floor_peak_shifter  // S2 in tinyvad.
 
-// Value of decremented counter is 2^log2decfMASK -1 to allow mask to be used to detect rollover
-#define decfMASK ((1 << (pinstance->config.log2decfMASK)) -1)
-
 extern void sigp_stream_detector_process (sigp_detector_instance *instance, 
                      int16_t *in, int32_t inputLength, 
                      int32_t *pResult);
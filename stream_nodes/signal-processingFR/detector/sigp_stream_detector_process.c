@@ -41,10 +41,6 @@
 
 
 
-#ifdef _MSC_VER
-#include <stdio.h>
-#endif
-
 #include "sigp_stream_detector.h"
 
 #include <inttypes.h>
@@ -60,93 +56,149 @@
 
     Parameters : select rising/falling detection, signal to noise ratio in voltage decibels, 
     time-constant in [ms] for the energy integration time, time-constant to gate the output.
+
+    Block processing : the high-pass and the first low-pass (z6) run on each sample of each
+    channel, with the max and min of z6 in blocks of DETECTOR_BLOCK samples. The envelope (z8),
+    the floor (z7), the counters and the decision are updated once per block with time 
+    constants scaled by the block length.
+*/
+
+
+/*
+    per-sample filters of one channel : no decision and no branch in the loop
+*/
+static void detector_filters (sigp_detector_instance *pinstance, const int16_t *in, int32_t nsamp, uint8_t ch)
+{
+    int32_t z1 = pinstance->z1[ch], z6 = pinstance->z6[ch];
+    int32_t peak = pinstance->peak[ch], valley = pinstance->valley[ch];
+    int32_t nch = pinstance->nchan, isamp, d;
+    uint8_t shpf = SHPF, slpf = SLPF, conv = 15 - SHPF;
+
+    for (isamp = 0; isamp < nsamp; isamp++)
+    {   /* high-pass prefilter and rectifier */
+        d = ConvertSamp((int32_t)in[isamp * nch], conv) - DIVBIN(z1, shpf);
+        z1 = z1 + d;
+        d = (d < 0) ? (-d) : d;
+
+        /* z6: raw energy estimation */
+        z6 = DIVBIN(d, slpf) + (z6 - DIVBIN(z6, slpf));
+        peak = MAX(peak, z6);
+        valley = MIN(valley, z6);
+    }
+    pinstance->z1[ch] = z1;     pinstance->z6[ch] = z6;
+    pinstance->peak[ch] = peak; pinstance->valley[ch] = valley;
+}
+
+
+/*
+    end of block : z7 floor level and z8 envelope of each channel, decision counters
 */
+static void detector_decision (sigp_detector_instance *pinstance)
+{
+    int32_t rise = DETECTOR_BLOCK * VADRISE, fall = DETECTOR_BLOCK * VADFALL;
+    int32_t thr = MINIFLOAT2Q31(THR), clamp_max = CLAMP_MAX;
+    uint8_t shift_env = (uint8_t)MAX((int32_t)SFloorPeak - DETECTOR_BLOCK_LOG2, 0);
+    uint8_t shift_floor = (uint8_t)MAX((int32_t)SFloorPeak + (int32_t)pinstance->config.log2decfMASK - DETECTOR_BLOCK_LOG2, 0);
+    int32_t peak0 = pinstance->peak[0];
+    uint8_t ch, snr_any = 0, snr_all = 1, level = 0, detect;
+
+    for (ch = 0; ch < pinstance->nchan; ch++)
+    {   int32_t peak = pinstance->peak[ch], valley = pinstance->valley[ch];
+
+        Z8[ch] = DIVBIN(peak, shift_env) + (Z8[ch] - DIVBIN(Z8[ch], shift_env));
+        Z8[ch] = MAX(peak, Z8[ch]);
+
+        Z7[ch] = DIVBIN(valley, shift_floor) + (Z7[ch] - DIVBIN(Z7[ch], shift_floor));
+        Z7[ch] = MAX(CLAMP_MIN, MIN(Z7[ch], valley));
+
+        /* SNR>THR or envelope>THR on one or all the channels */
+        detect = (uint8_t)((int64_t)Z8[ch] > (int64_t)Z7[ch] * thr);
+        snr_any |= detect;
+        snr_all &= detect;
+        level |= (uint8_t)(Z8[ch] > thr);
+
+        pinstance->peak[ch] = pinstance->z6[ch];
+        pinstance->valley[ch] = pinstance->z6[ch];
+    }
+
+    switch (pinstance->config.decision)
+    {   case DETECTOR_DECISION_LEVEL:   detect = level;     break;
+        case DETECTOR_DECISION_SNR_ALL: detect = snr_all;   break;
+        default:                        detect = snr_any;   break;
+    }
+
+    /* if SNR>THR then increment a first counter */
+    if (detect)
+    {   ACCVAD = MIN(clamp_max, ACCVAD + rise);
+    }   /* slow rise, fast fall */
+    else
+    {   ACCVAD = MAX(CLAMP_MIN, ACCVAD - fall);
+    }
+
+    /* if the VAD is confirmed then use a second counter */
+    if (ACCVAD > F2Q31(0.1))
+    {   FLAG = MIN(clamp_max, FLAG + fall);
+    }   /* fast rise, slow fall */
+    else
+    {   FLAG = MAX(CLAMP_MIN, FLAG - rise);
+    }
+
+    /* signal detected => maintain the decision for some time */
+    DOWNCOUNTER = MAX(0, DOWNCOUNTER - DETECTOR_BLOCK);
+    if (FLAG > F2Q31(0.5))
+    {   DOWNCOUNTER = MINIFLOAT2Q31(RELOADCOUNTER);
+    }
+
+#if DETECTOR_TRACE_DEPTH > 0
+    if (pinstance->ring != 0)
+    {   sigp_detector_trace *t = &(pinstance->ring->trace[pinstance->ring->write_index % DETECTOR_TRACE_DEPTH]);
+        t->peak = peak0;
+        t->floor = Z7[0];
+        t->envelope = Z8[0];
+        t->accvad = ACCVAD;
+        t->flag = FLAG;
+        t->detected = (DOWNCOUNTER > 0) ? 0x7FFFFFFF : 0;
+        pinstance->ring->write_index++;
+    }
+#endif
+}
 
 
 /**
   @brief         Processing function 
-  @param[in]     instance     points to an instance of the Biquad cascade structure
-  @param[in]     pSrc         points to the block of input data
-  @param[out]    pResult      points to the result flag = 0x7FFF when detected, else 0
-  @param[in]     inputLength  number of samples to process
+  @param[in]     instance     points to an instance of the detector
+  @param[in]     pSrc         points to the block of interleaved input data
+  @param[out]    pResult      points to the result flag = 0x7FFFFFFF when detected, else 0
+  @param[in]     inputLength  number of samples to process (all the channels)
   @return        none
  */
 void sigp_stream_detector_process (sigp_detector_instance *pinstance, 
                      int16_t *in, int32_t inputLength, 
                      int32_t *pResult)
 {
-    int32_t isamp = 0;
-    int32_t input_data;
-    int32_t DBGZ3;
-
-    while (isamp < inputLength) 
-    {
-        input_data = ConvertSamp(in[isamp], 15 - (int)(pinstance->config.high_pass_shifter));
-
-        /* high-pass prefilter */
-        Z2 = Z1 - DIVBIN(Z1 , SHPF) + input_data;
-        Z3 = Z2 - Z1;
-        Z1 = Z2;
-        DBGZ3 = Z3;
-        Z3 = (Z3 < 0) ? (-Z3) : Z3;
-
-        /* z6: raw energy estimation, z7: floor level, z8: envelope */
-        Z6 = DIVBIN(Z3, SLPF) + (Z6 - DIVBIN(Z6, SLPF));
-        Z8 = DIVBIN(Z6, SFloorPeak) + (Z8 - DIVBIN(Z8, SFloorPeak));
-        Z8 = MAX(Z6, Z8);
-
-        /* floor noise update after decimation */
-        DECF = decfMASK & (DECF -1);
-        if (DECF == 0)
-        {   Z7 = DIVBIN(Z6, SFloorPeak) + (Z7 - DIVBIN(Z7, SFloorPeak));
-            Z7 = MAX(CLAMP_MIN, MIN(Z7, Z6));
-            DECF = decfMASK;
-        }
-
-        /* if SNR>THR then increment a first counter */
-        if (Z8 > Z7 * (MINIFLOAT2Q31(THR)))
-        {   ACCVAD = MIN(CLAMP_MAX, ACCVAD + VADRISE);
-        }   /* slow rise, fast fall */
-        else
-        {   ACCVAD = MAX(CLAMP_MIN, ACCVAD - VADFALL);
-        }
+    int32_t nframe = inputLength / pinstance->nchan, n;
+    uint8_t ch;
 
-        /* if the VAD is confirmed then use a second counter */
-        if (ACCVAD > F2Q31(0.1))
-        {   FLAG = MIN(CLAMP_MAX, FLAG + VADFALL);
-        }   /* fast rise, slow fall */
-        else
-        {   FLAG = MAX(CLAMP_MIN, FLAG - VADRISE);
+    while (nframe > 0)
+    {   n = MIN(nframe, DETECTOR_BLOCK - pinstance->nblock);
+        for (ch = 0; ch < pinstance->nchan; ch++)
+        {   detector_filters(pinstance, &(in[ch]), n, ch);
         }
+        in += n * pinstance->nchan;
+        nframe -= n;
+        pinstance->nblock = (uint8_t)(pinstance->nblock + n);
 
-        /* signal detected => maintain the decision for some time */
-        if (DOWNCOUNTER > 0)
-        {   DOWNCOUNTER --;
+        if (pinstance->nblock == DETECTOR_BLOCK)
+        {   detector_decision(pinstance);
+            pinstance->nblock = 0;
         }
-        if (FLAG > F2Q31(0.5))
-        {   DOWNCOUNTER = MINIFLOAT2Q31(RELOADCOUNTER);
-        }
-
-        /* only one sample is used to the output buffer to save the VAD result */
-        if (DOWNCOUNTER > 0)
-        	pResult[0] = 0x7FFFFFFF;
-        else
-        	pResult[0] = 0x00000000;
-
-#ifdef PLATFORM_COMPUTER        
-        {   
-            extern FILE *ptf_debug_detector;
-            long x, SD=4; 
-            x = input_data<<SD;                         fwrite(&x, 1, 4, ptf_debug_detector);    //1
-            x = Z7<<SD;                                 fwrite(&x, 1, 4, ptf_debug_detector);    //2
-            x = Z8<<SD;                                 fwrite(&x, 1, 4, ptf_debug_detector);    //3
-            x = ACCVAD;                                 fwrite(&x, 1, 4, ptf_debug_detector);    //4
-            x = FLAG;                                   fwrite(&x, 1, 4, ptf_debug_detector);    //5
-            x = 0; if (DOWNCOUNTER > 0) x=0x7fffffff;   fwrite(&x, 1, 4, ptf_debug_detector);    //6
-        }
-#endif     
-        isamp++;
     }
+
+    /* only one sample is used to the output buffer to save the VAD result */
+    if (DOWNCOUNTER > 0)
+        pResult[0] = 0x7FFFFFFF;
+    else
+        pResult[0] = 0x00000000;
 }
 
 #endif  //#ifdef CODE_SIGP_STREAM_DETECTOR
@@ -43,49 +43,40 @@
 ;----------------------------------------------------------------------------------------
 ;7.	sigp_stream_detector2D
 ;----------------------------------------------------------------------------------------
-;   Operation : provides a boolean output stream from the detection of a rising 
-;   edge above a tunable signal to noise ratio. 
-;   A tunable delay allows to maintain the boolean value for a minimum amount of time 
-;   Use-case example 1: debouncing analog input and LED / user-interface.
-;   Use-case example 2: IMU and voice activity detection (VAD)
-;   Parameters : time-constant to gate the output, sensitivity of the use-case
+;   Operation : motion detection on grayscale images received in strips of lines. 
+;   The box sums of the cells are computed with the summed-area table of the strip, the 
+;   mean luminance and the gradients of each cell are compared to a background at the end 
+;   of each frame. An event of 6 words is produced on the output arc for each frame :
+;   detection flag (0x7FFF), number of moving cells, bounding box x0 y0 x1 y1 (in cells).
+;   Use-case example : wake-up of a low-power camera, people counting pre-detection.
+;   Parameters : image and cell sizes, background time-constant, sensitivity
 ;
 ;   presets control
-;   #1 : no HPF pre-filtering, fast and high sensitivity detection (button debouncing)
-;   #2 : VAD with HPF pre-filtering, time constants tuned for ~10kHz
-;   #3 : VAD with HPF pre-filtering, time constants tuned for ~44.1kHz
-;   #4 : IMU detector2D : HPF, slow time constants
-;   #5 : IMU detector2D : HPF, fast time constants
-;
-;   preset parameter : 8bit sensitivity
-;
-;   Metadata information can be extracted with the command "TAG_CMD" from parameter-read:
-;   0 read the floor noise level
-;   1 read the current signal peak
-;   2 read the signal to noise ratio
+;   #0 : QVGA 320x240, cells 16x16, running average background
+;   #1 : VGA 640x480, cells 32x32
+;   #2 : VGA 640x480, cells 16x16
+;   #3 : QQVGA 160x120, cells 8x8
+;   #4 : QVGA, difference with the previous frame
 ;
 sigp_stream_detector2D
     3  i8; 0 0 0        instance, preset, tag
     PARSTART
-    8; i8; 1;2;3;4;5;6;7;8; the 8 bytes of "struct detector2D_parameters"
+    2; i16; 320 240;                width and height
+    8; i8; 4 4 3 12 2 4 1 0;        log2 cell width/height, background, threshold, min cells, hold, illumination
     PARSTOP  
 */
 
 #define NB_PRESET 5
 const detector2D_parameters detector2D_preset [NB_PRESET] = 
-{   /*  log2counter, log2decfMASK, 
-        high_pass_shifter, low_pass_shifter, low_pass_z7_z8,  
-        vad_rise, vad_fall, THR */
-    {MINIF(1,12), 8,   2, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #1 no HPF, fast for button debouncing */
-    {MINIF(1,12), 8,   2, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #2 VAD with HPF pre-filtering, tuned for Fs <20kHz */
-    {MINIF(1,12), 8,   2, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #3 VAD with HPF pre-filtering, tuned for Fs >20kHz */
-    {MINIF(1,12), 8,   2, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #4 IMU detector2D : HPF, slow time constants */
-    {MINIF(1,12), 8,   2, 6, 11,  MINIF(1,18), MINIF(1,20), MINIF(3,0)}, /* #5 IMU detector2D : HPF, fast time constants */
+{   /*  width, height, log2_cell_width, log2_cell_height, 
+        background_shifter, threshold, min_cells, hold_frames, illumination */
+    {320, 240, 4, 4, 3, 12, 2, 4, 1, 0},    /* #0 QVGA 20x15 cells */
+    {640, 480, 5, 5, 3, 10, 2, 4, 1, 0},    /* #1 VGA 20x15 cells */
+    {640, 480, 4, 4, 3, 12, 3, 4, 1, 0},    /* #2 VGA 40x30 cells */
+    {160, 120, 3, 3, 3, 16, 2, 4, 1, 0},    /* #3 QQVGA 20x15 cells */
+    {320, 240, 4, 4, 0, 12, 2, 4, 1, 0},    /* #4 QVGA frame difference */
 };
 
-char dbg[100];
-long x;
-
 /**
   @brief         
   @param[in]     command    bit-field
@@ -107,12 +98,12 @@ void sigp_stream_detector2D (unsigned int command, void *instance, void *data, u
                 memory pointers are in the same order as described in the NODE manifest
         */
         case STREAM_RESET: 
-        {   stream_services *stream_entry = (stream_services *)data;
-            intptr_t *memresults = (intptr_t *)instance;
+        {   intptr_t *memresults = (intptr_t *)instance;
             uint16_t preset = RD(command, PRESET_CMD);
-            uint8_t *pt8bdst, i, n;
+            uint8_t *pt8bdst;
+            uint32_t i, n;
 
-            sigp_detector2D_instance *pinstance = (sigp_detector2D_instance *) *memresults;
+            sigp_detector2D_instance *pinstance = (sigp_detector2D_instance *) *memresults++;
 
             /* here reset */
             pt8bdst = (uint8_t *) pinstance;
@@ -120,10 +111,11 @@ void sigp_stream_detector2D (unsigned int command, void *instance, void *data, u
             for (i = 0; i < n; i++)
             {   pt8bdst[i] = 0;
             }
-            pinstance->z1 = pinstance->z6 = pinstance->z8 = F2Q31(0.00001);
-            pinstance->z7 = F2Q31(0.001);
+            pinstance->strip = (sigp_detector2D_strip *) *memresults++;
+            pinstance->cells = (sigp_detector2D_cells *) *memresults++;
 
-            pinstance->config = detector2D_preset[preset];    /* preset data move */
+            pinstance->config = detector2D_preset[MIN(preset, NB_PRESET-1)];    /* preset data move */
+            sigp_stream_detector2D_init(pinstance);
             break;
         }  
         
@@ -134,8 +126,10 @@ void sigp_stream_detector2D (unsigned int command, void *instance, void *data, u
         */ 
         case STREAM_SET_PARAMETER:
         {   sigp_detector2D_instance *pinstance = (sigp_detector2D_instance *) instance;
-            pinstance->config = detector2D_preset[RD(command,NODE_TAG_CMD)];
 
+            if (RD(command,NODE_TAG_CMD) < NB_PRESET)
+            {   pinstance->config = detector2D_preset[RD(command,NODE_TAG_CMD)];
+            }
             if (RD(command,NODE_TAG_CMD) == NODE_ALL_PARAM) 
             {   uint8_t *pt8bsrc, *pt8bdst, i, n;
 
@@ -147,6 +141,9 @@ void sigp_stream_detector2D (unsigned int command, void *instance, void *data, u
                 {   pt8bdst[i] = pt8bsrc[i];
                 }
             }
+
+            /* the geometry can change : restart from the next frame */
+            sigp_stream_detector2D_init(pinstance);
             break;
         }
 
@@ -154,15 +151,16 @@ void sigp_stream_detector2D (unsigned int command, void *instance, void *data, u
                instance,  
                data = array of [{*input size} {*output size}]
 
-               data format is given in the node's manifest used during the YML->graph translation
-               this format can be FMT_INTERLEAVED or FMT_DEINTERLEAVED_1PTR
+               the input arc is the grayscale image in raster order (any number of pixels per call),
+               the output arc receives DETECTOR2D_EVENT_SIZE words at the end of each frame
         */         
         case STREAM_RUN:   
         {
             sigp_detector2D_instance *pinstance = (sigp_detector2D_instance *) instance;
             intptr_t nb_data, stream_xdmbuffer_size, bufferout_free;
+            int32_t nb_events;
             stream_xdmbuffer_t *pt_pt;
-            #define SAMP_IN int16_t 
+            #define SAMP_IN uint8_t 
             #define SAMP_OUT int16_t
             SAMP_IN *inBuf;
             SAMP_OUT *outBuf;
@@ -174,19 +172,14 @@ void sigp_stream_detector2D (unsigned int command, void *instance, void *data, u
             outBuf = (SAMP_OUT *)(pt_pt->address); 
             bufferout_free        = pt_pt->size;
 
-            nb_data = stream_xdmbuffer_size / sizeof(SAMP_IN);
-            { int i; for (i=0; i< (int)nb_data; i++) outBuf[i]=0; }
-
-            sigp_stream_detector2D_process (pinstance, inBuf, (int32_t)nb_data, outBuf);
+            nb_events = (int32_t)(bufferout_free / (DETECTOR2D_EVENT_SIZE * sizeof(SAMP_OUT)));
+            nb_data = sigp_stream_detector2D_process (pinstance, inBuf, 
+                        (int32_t)(stream_xdmbuffer_size / sizeof(SAMP_IN)), outBuf, &nb_events);
 
             pt_pt = data;
             *(&(pt_pt->size)) = nb_data * sizeof(SAMP_IN); /* amount of data consumed */
             pt_pt ++;
-            *(&(pt_pt->size)) = nb_data * sizeof(SAMP_OUT);   /* amount of data produced */
-
-            //--------------------DEBUG---------------------
-            //sprintf (dbg, "Z2%5d Z7%3d Z8%4d VAD%2d", (pinstance->z2)>>12, (pinstance->z7)>>12, (pinstance->z8)>>12, outBuf[0]);
-            //sigp_stream_services(PACK_SERVICE(RD(command,INST_CMD), NOTAG_SSRV, STREAM_SERVICE_INTERNAL_DEBUG_TRACE), dbg, (uint8_t *)strlen(dbg), 0);                        
+            *(&(pt_pt->size)) = nb_events * DETECTOR2D_EVENT_SIZE * sizeof(SAMP_OUT);   /* amount of data produced */
             break;
         }
         case STREAM_STOP :
@@ -1,6 +1,6 @@
 /* ----------------------------------------------------------------------
  * Title:        sigp_stream_detector2D.h
- * Description:  filters
+ * Description:  motion detection with summed-area tables
  *
  * $Date:        15 February 2024
  * $Revision:    V0.0.1
@@ -21,141 +21,121 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
+
 #ifndef csigp_STREAM_detector2D_H
 #define csigp_STREAM_detector2D_H
 
 
-#include "stream_const.h"      
-#include "stream_types.h"  
+#include "stream_const.h"
+#include "stream_types.h"
 
 
 /*
     9.	stream_detector2D
-    Operation : provides a boolean output stream from the detection of a rising (of falling) edge above 
-    a tunable signal to noise ratio. A time constant in [ms] is used for the detection. 
-    A tunable delay allows to maintain the boolean value for a minimum amount of time 
-    for debouncing and LED / user-interface).
-    
-    Parameters : select rising/falling detection, signal to noise ratio in voltage decibels, 
-    time-constant in [ms] for the energy integration time, time-constant to gate the output.
+    Operation : motion detection on a grayscale (8bits) image received in raster order, line
+    after line, in strips of one row of cells. The image is never stored : the summed-area table
+    of the strip is kept as column sums, its rows are computed on the half-cell and last lines
+    of the strip, and the box sums of each cell give three features : the mean luminance and the
+    horizontal and vertical gradients (left-right and top-bottom half-cell differences).
+    At the end of the frame the features are compared to a background (previous frame or
+    running average), the global change of luminance is removed, and an event is produced on
+    the output arc with the number of moving cells and their bounding box.
+
+    Parameters : image size, cell size, background time-constant, threshold per cell,
+    minimum number of moving cells, number of frames the detection is maintained.
 */
 
-enum STREAM_detector2D_PRESETS 
+#define DETECTOR2D_PRESET_QVGA          0   /* 320x240, cells 16x16 */
+#define DETECTOR2D_PRESET_VGA           1   /* 640x480, cells 32x32 */
+#define DETECTOR2D_PRESET_VGA_FINE      2   /* 640x480, cells 16x16 */
+#define DETECTOR2D_PRESET_QQVGA         3   /* 160x120, cells 8x8 */
+#define DETECTOR2D_PRESET_QVGA_DIFF     4   /* 320x240, cells 16x16, difference with the previous frame */
+
+#define DETECTOR2D_MAX_WIDTH          640
+#define DETECTOR2D_MAX_CELLS_X         80   /* cells of 8 pixels at the maximum width */
+#define DETECTOR2D_MAX_CELLS         1200   /* 40x30 cells : VGA with cells 16x16 */
+#define DETECTOR2D_MIN_LOG2_CELL        3   /* cells from 8x8 .. */
+#define DETECTOR2D_MAX_LOG2_CELL        5   /* .. to 32x32 pixels (16bits column sums) */
+
+#define DETECTOR2D_FEATURE_Q            4   /* features in luminance unit x 16 */
+
+/* event written on the output arc at the end of each frame */
+#define DETECTOR2D_EVENT_FLAG           0   /* 0x7FFF when detected, else 0 */
+#define DETECTOR2D_EVENT_NB_CELLS       1   /* number of moving cells */
+#define DETECTOR2D_EVENT_X0             2   /* bounding box of the moving cells, in cells */
+#define DETECTOR2D_EVENT_Y0             3
+#define DETECTOR2D_EVENT_X1             4
+#define DETECTOR2D_EVENT_Y1             5
+#define DETECTOR2D_EVENT_SIZE           6   /* int16 words */
+
+typedef struct          /* 12 Bytes  */
 {
-    // STREAM_detector2D_PRESET_NONE,
-    STREAM_detector2D_PRESET_VAD_16kHz,
-    STREAM_detector2D_PRESET_VAD_48kHz,
-    STREAM_detector2D_PRESET_ACCEL_103Hz,
-    STREAM_detector2D_PRESET_ECG_360Hz_NOT_IMPLEMENTED,
-};
+    uint16_t width;             /* pixels per line, multiple of the cell width */
+    uint16_t height;            /* lines per frame, multiple of the cell height */
+    uint8_t log2_cell_width;    /* DETECTOR2D_MIN_LOG2_CELL .. DETECTOR2D_MAX_LOG2_CELL */
+    uint8_t log2_cell_height;   /* the strips have the height of one cell */
+    uint8_t background_shifter; /* background += (features - background) >> shifter, 0 = previous frame */
+    uint8_t threshold;          /* score of a moving cell in luminance unit */
+    uint8_t min_cells;          /* number of moving cells to trigger the detection */
+    uint8_t hold_frames;        /* the detection is maintained for this number of frames */
+    uint8_t illumination;       /* 1 : the average change of luminance is removed */
+    uint8_t pad___;
+} detector2D_parameters;
 
 
-typedef struct          /* 8 Bytes  */
+typedef struct
 {
-/* 
-    76543210
-    MMMEEEEE
-    #define MINIF(m,exp) ((uint8_t)((m)<<5 | (exp)))
-    #define MINIFLOAT2Q31(x) (((x) & 0xE0) << (23 - ((x) & 0x1F)))
-    #define     MULTIPLIER_MSB 7     
-    #define     MULTIPLIER_LSB 5
-    #define       EXPONENT_MSB 4     
-    #define       EXPONENT_LSB 0
-*/
-    uint8_t log2counter;        /* sample counter= 2^(log2counter/8) x (2^(log2counter&7))/8  [0 .. ~2^32]
-                                    maintains the "detected" flag at least for this number of samples */
-    uint8_t log2decfMASK;        /* decimation = a power of 2 (-1) */
-    uint8_t high_pass_shifter;  /* for z1 */
-    uint8_t low_pass_shifter;   /* for z6 */
-    uint8_t floor_peak_shifter; /* for z7 */
-    uint8_t vad_rise;           /* rise time MiniFloat Mantissa 3bits Exponent 5bits */
-    uint8_t vad_fall;           /* fall time Mantissa=[0..7] Exponent=(-1)x[0..31] */
-    uint8_t THR;                /* detection threshold z8/z7 */
-} detector2D_parameters;
+    int16_t mean;               /* luminance of the cell, Q DETECTOR2D_FEATURE_Q */
+    int16_t gx;                 /* left half - right half */
+    int16_t gy;                 /* top half - bottom half */
+} sigp_detector2D_features;
+
 
-typedef struct 
+typedef struct
 {
-    detector2D_parameters config; /* 8 bytes */
-    int32_t z1;    /* memory of the high-pass filter (recursive part) */
-    int32_t z2;    /* memory of the high-pass filter (direct part) */
-    int32_t z3;    /* output of the high-pass filter */
-    int32_t z6;    /* memory of the first low-pass filter */
-    int32_t z7;    /* memory of the floor-noise tracking low-pass filter */
-    int32_t z8;    /* memory of the envelope tracking low-pass filter */
-    int32_t accvad;/* accumulator / estimation */
-    int32_t Flag;  /* accumulator 2 / estimation  */
-    int32_t down_counter;    /* memory of the debouncing downcounter  */
-    int16_t decf;  /* memory of the decimator for z7/floor noise estimation */
-    uint8_t previous_vad; 
-    uint8_t pad___; 
+    sigp_detector2D_features current [DETECTOR2D_MAX_CELLS];
+    sigp_detector2D_features background [DETECTOR2D_MAX_CELLS];
+} sigp_detector2D_cells;
+
+
+typedef struct
+{
+    uint16_t colsum [DETECTOR2D_MAX_WIDTH];     /* column sums of the lines of the strip */
+    uint32_t sat [DETECTOR2D_MAX_WIDTH + 1];    /* one row of the summed-area table of the strip */
+} sigp_detector2D_strip;
+
+
+typedef struct
+{
+    detector2D_parameters config; /* 12 bytes */
+    uint16_t x;                 /* position in the frame */
+    uint16_t y;
+    uint16_t ncell_x;           /* cells per strip */
+    uint16_t ncell_y;           /* strips per frame */
+    uint8_t first_frame;        /* the background is initialized with the first frame */
+    uint8_t hold;               /* down-counter of the detection */
+    uint32_t top [DETECTOR2D_MAX_CELLS_X];      /* box sums of the top half-cells */
+    int32_t sum_mean_change;    /* sum of the luminance changes of the frame */
+    sigp_detector2D_strip *strip;
+    sigp_detector2D_cells *cells;
 } sigp_detector2D_instance;
 
-#define F2Q31(f) (long)(0x7FFFFFFFL*(f))
-#define ConvertSamp(f, s) ((f)<<(s))
-#define DIVBIN(s,n) (s>>n)
-
-
-// Time constants for VAD algorithm
-// MiniFloat 76543210
-//           MMMEEEEE x= MMM(0..7) << EEEEE(0..31) =[0..15e9] +/-1
-// just for information: OFP8_E4M3 SEEEEMMM x= (sign).(1 + M/8).(2<<(E-7)) =[-8..+8] +/-1e-6
-//#define MINIF(m,exp) ((uint8_t)((m)<<5 | (exp)))
-//#define MINIFLOAT2Q31(x) ((((x) & 0xE0)>>5) << ((x) & 0x1F))
-//#define MULTIPLIER_MSB 7     
-//#define MULTIPLIER_LSB 5
-//#define   EXPONENT_MSB 4     
-//#define   EXPONENT_LSB 0
-
-//#define VADRISE MINIFLOAT2Q31(instance->config.vad_rise)
-//#define VADFALL MINIFLOAT2Q31(instance->config.vad_fall)
-
-// Threshold/clamping to prevent the value 0 entering filter calculations
-// TODO - This prevents zero entering filter but effectively restricts us to
-// less than half of the range of Q31
-#define CLAMP_MIN  F2Q31(0.0001)
-// Clamping to prevent overflow of intermediate calculations and flags
-
-// Note extra headroom required for low fs
-#define CLAMP_MAX  F2Q31(0.98)-VADRISE-VADFALL
-
-// Filter variables
-#define Z1 instance->z1
-#define Z2 instance->z2
-#define Z3 instance->z3
-#define Z6 instance->z6
-#define Z7 instance->z7
-#define Z8 instance->z8
-#define DECF instance->decf
-#define ACCVAD instance->accvad
-#define FLAG instance->Flag
-#define SHPF instance->config.high_pass_shifter
-#define SLPF instance->config.low_pass_shifter
-#define PREVIOUSVAD instance->previous_vad
-#define THR instance->config.THR
-#define RELOADCOUNTER instance->config.log2counter
-#define DOWNCOUNTER instance->down_counter
-
-// Replace below with #define SPeak  instance->config.peak_signal_shifter and change SLPF to SFloor 
-// if we do need separate values for each
-#define SFloorPeak instance->config.floor_peak_shifter  // S2 in tinyvad.
-
-// Value of decremented counter is 2^log2decfMASK -1 to allow mask to be used to detect rollover
-#define decfMASK ((1 << (instance->config.log2decfMASK)) -1)
-
-extern void sigp_stream_detector2D_process (sigp_detector2D_instance *instance, 
-                     int16_t *in, int32_t inputLength, 
-                     int16_t *pResult);
+
+extern void sigp_stream_detector2D_init (sigp_detector2D_instance *instance);
+
+extern int32_t sigp_stream_detector2D_process (sigp_detector2D_instance *instance,
+                     uint8_t *in, int32_t inputLength,
+                     int16_t *pResult, int32_t *nbEvents);
 
 #endif //csigp_STREAM_detector2D_H
 
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
+
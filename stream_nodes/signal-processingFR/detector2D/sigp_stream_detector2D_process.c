@@ -1,6 +1,6 @@
 /* ----------------------------------------------------------------------
  * Title:        sigp__stream_detector2D_process.c
- * Description:  filters
+ * Description:  motion detection with summed-area tables
  *
  * $Date:        15 February 2024
  * $Revision:    V0.0.1
@@ -44,24 +44,234 @@
 
 /*
     16.	stream_detector2D
-    Operation : 
+    Operation : the pixels of each line are added to the column sums of the strip (one add per
+    pixel, vectorized by the compiler). A row of the summed-area table (SAT) of the strip is the 
+    prefix sum of the column sums : it is computed on the last line of the top half-cells and
+    on the last line of the strip, the box sums of the (half) cells are differences of 2 values
+    of the SAT row. 
+    The features of the cells are compared to the background at the end of the frame.
 
-    Parameters : 
+    Parameters : see detector2D_parameters
 */
 
 
+/*
+    initialization of the geometry, after a reset or a change of parameters
+*/
+void sigp_stream_detector2D_init (sigp_detector2D_instance *instance)
+{
+    detector2D_parameters *config = &(instance->config);
+    uint32_t i;
+
+    config->log2_cell_width = (uint8_t)MAX(DETECTOR2D_MIN_LOG2_CELL, MIN(DETECTOR2D_MAX_LOG2_CELL, config->log2_cell_width));
+    config->log2_cell_height = (uint8_t)MAX(DETECTOR2D_MIN_LOG2_CELL, MIN(DETECTOR2D_MAX_LOG2_CELL, config->log2_cell_height));
+    config->width = (uint16_t)MIN(DETECTOR2D_MAX_WIDTH, config->width);
+
+    instance->ncell_x = (uint16_t)(config->width >> config->log2_cell_width);
+    instance->ncell_y = (uint16_t)MIN(config->height >> config->log2_cell_height, 
+                                      DETECTOR2D_MAX_CELLS / MAX(1, instance->ncell_x));
+    instance->x = instance->y = 0;
+    instance->first_frame = 1;
+    instance->hold = 0;
+    instance->sum_mean_change = 0;
+
+    for (i = 0; i < DETECTOR2D_MAX_WIDTH; i++)
+    {   instance->strip->colsum[i] = 0;
+    }
+}
+
+
+/*
+    row of the summed-area table of the strip = prefix sum of the column sums
+*/
+static void detector2D_sat_row (sigp_detector2D_instance *instance)
+{
+    uint16_t *colsum = instance->strip->colsum;
+    uint32_t *sat = instance->strip->sat, acc = 0;
+    int32_t x;
+
+    sat[0] = 0;
+    for (x = 0; x < instance->config.width; x++)
+    {   acc += colsum[x];
+        sat[x+1] = acc;
+    }
+}
+
+
+/*
+    last line of the top half-cells : box sums of the top halves
+*/
+static void detector2D_strip_half (sigp_detector2D_instance *instance)
+{
+    uint32_t *sat = instance->strip->sat;
+    uint8_t lw = instance->config.log2_cell_width;
+    int32_t cx, x0;
+
+    detector2D_sat_row(instance);
+    for (cx = 0; cx < instance->ncell_x; cx++)
+    {   x0 = cx << lw;
+        instance->top[cx] = sat[x0 + (1 << lw)] - sat[x0];
+    }
+}
+
+
+/*
+    last line of the strip : features of the row of cells, clear of the column sums
+*/
+static void detector2D_strip_end (sigp_detector2D_instance *instance, int32_t cy)
+{
+    uint32_t *sat = instance->strip->sat;
+    uint8_t lw = instance->config.log2_cell_width;
+    uint8_t shift = (uint8_t)(lw + instance->config.log2_cell_height - DETECTOR2D_FEATURE_Q);
+    int32_t cx, x0, total, left, top, x;
+
+    if (cy < instance->ncell_y)
+    {   sigp_detector2D_features *cur = &(instance->cells->current[cy * instance->ncell_x]);
+        sigp_detector2D_features *bg = &(instance->cells->background[cy * instance->ncell_x]);
+
+        detector2D_sat_row(instance);
+        for (cx = 0; cx < instance->ncell_x; cx++)
+        {   x0 = cx << lw;
+            total = (int32_t)(sat[x0 + (1 << lw)] - sat[x0]);
+            left  = (int32_t)(sat[x0 + (1 << (lw-1))] - sat[x0]);
+            top   = (int32_t)(instance->top[cx]);
+
+            /* mean = total / area, gradients = (half - other half) / (area / 2) */
+            cur[cx].mean = (int16_t)(total >> shift);
+            cur[cx].gx = (int16_t)((2*left - total) >> (shift - 1));
+            cur[cx].gy = (int16_t)((2*top - total) >> (shift - 1));
+            instance->sum_mean_change += cur[cx].mean - bg[cx].mean;
+        }
+    }
+
+    for (x = 0; x < instance->config.width; x++)
+    {   instance->strip->colsum[x] = 0;
+    }
+}
+
+
+/*
+    end of frame : comparison with the background, event, update of the background
+*/
+static void detector2D_frame_end (sigp_detector2D_instance *instance, int16_t *event)
+{
+    sigp_detector2D_features *cur = instance->cells->current;
+    sigp_detector2D_features *bg = instance->cells->background;
+    int32_t ncell = instance->ncell_x * instance->ncell_y;
+    int32_t threshold = instance->config.threshold << DETECTOR2D_FEATURE_Q;
+    uint8_t shift = instance->config.background_shifter;
+    int32_t c, cx, cy, dm, dgx, dgy, global, count = 0;
+    int16_t x0 = 0x7FFF, y0 = 0x7FFF, x1 = -1, y1 = -1;
+
+    if (instance->first_frame)
+    {   for (c = 0; c < ncell; c++)
+        {   bg[c] = cur[c];
+        }
+        instance->first_frame = 0;
+    }
+    else
+    {   global = (instance->config.illumination && ncell > 0) ? instance->sum_mean_change / ncell : 0;
+
+        for (c = cy = 0; cy < instance->ncell_y; cy++)
+        {   for (cx = 0; cx < instance->ncell_x; cx++, c++)
+            {   dm  = cur[c].mean - bg[c].mean;
+                dgx = cur[c].gx - bg[c].gx;
+                dgy = cur[c].gy - bg[c].gy;
+
+                if (ABS(dm - global) + ((ABS(dgx) + ABS(dgy)) >> 1) > threshold)
+                {   count++;
+                    x0 = (int16_t)MIN(x0, cx);  x1 = (int16_t)MAX(x1, cx);
+                    y0 = (int16_t)MIN(y0, cy);  y1 = (int16_t)MAX(y1, cy);
+                }
+                bg[c].mean = (int16_t)(bg[c].mean + (dm >> shift));
+                bg[c].gx   = (int16_t)(bg[c].gx + (dgx >> shift));
+                bg[c].gy   = (int16_t)(bg[c].gy + (dgy >> shift));
+            }
+        }
+    }
+    instance->sum_mean_change = 0;
+
+    /* the detection is maintained hold_frames after the last moving frame */
+    if (count > 0 && count >= instance->config.min_cells)
+    {   instance->hold = (uint8_t)(instance->config.hold_frames + 1);
+    }
+    event[DETECTOR2D_EVENT_FLAG] = 0;
+    if (instance->hold > 0)
+    {   event[DETECTOR2D_EVENT_FLAG] = 0x7FFF;
+        instance->hold--;
+    }
+    event[DETECTOR2D_EVENT_NB_CELLS] = (int16_t)count;
+    event[DETECTOR2D_EVENT_X0] = (int16_t)((count > 0) ? x0 : 0);
+    event[DETECTOR2D_EVENT_Y0] = (int16_t)((count > 0) ? y0 : 0);
+    event[DETECTOR2D_EVENT_X1] = (int16_t)((count > 0) ? x1 : 0);
+    event[DETECTOR2D_EVENT_Y1] = (int16_t)((count > 0) ? y1 : 0);
+}
+
+
 /**
   @brief         Processing function 
-  @param[in]     instance     points to an instance of the Biquad cascade structure
-  @param[in]     pSrc         points to the block of input data
-  @param[out]    pResult      points to the result flag = 0x7FFF when detected, else 0
-  @param[in]     inputLength  number of samples to process
-  @return        none
+  @param[in]     instance     points to an instance of the detector
+  @param[in]     in           points to the pixels, in raster order from the current position
+  @param[in]     inputLength  number of pixels
+  @param[out]    pResult      events of DETECTOR2D_EVENT_SIZE words, one per frame
+  @param[in/out] nbEvents     room for events / number of events produced
+  @return        number of pixels consumed, the processing stops after the end of a frame 
+                 when there is no more room for events
  */
-void sigp_stream_detector2D_process (sigp_detector2D_instance *instance, 
-                     int16_t *in, int32_t inputLength, 
-                     int16_t *pResult)
+int32_t sigp_stream_detector2D_process (sigp_detector2D_instance *instance, 
+                     uint8_t *in, int32_t inputLength, 
+                     int16_t *pResult, int32_t *nbEvents)
 {
+    uint16_t *colsum = instance->strip->colsum;
+    int32_t width = instance->config.width;
+    int32_t cell_height = 1 << instance->config.log2_cell_height;
+    int32_t room = *nbEvents, consumed = 0, n, i, line;
+
+    *nbEvents = 0;
+    if (room <= 0 || width == 0 || instance->ncell_x == 0)
+    {   return 0;
+    }
+
+    while (consumed < inputLength)
+    {   /* column sums of the line */
+        uint16_t *dst = &(colsum[instance->x]);
+
+        n = MIN(inputLength - consumed, width - instance->x);
+        for (i = 0; i < n; i++)
+        {   dst[i] = (uint16_t)(dst[i] + in[i]);
+        }
+        in += n;
+        consumed += n;
+        instance->x = (uint16_t)(instance->x + n);
+        if (instance->x < width)
+        {   break;
+        }
+
+        /* end of line */
+        instance->x = 0;
+        line = instance->y & (cell_height - 1);
+        if (line == (cell_height >> 1) - 1)
+        {   detector2D_strip_half(instance);
+        }
+        if (line == cell_height - 1)
+        {   detector2D_strip_end(instance, instance->y >> instance->config.log2_cell_height);
+        }
+
+        instance->y++;
+        if (instance->y >= instance->config.height)
+        {   instance->y = 0;
+            for (i = 0; i < width; i++)     /* incomplete last strip */
+            {   colsum[i] = 0;
+            }
+            detector2D_frame_end(instance, pResult);
+            pResult += DETECTOR2D_EVENT_SIZE;
+            (*nbEvents)++;
+            if (*nbEvents == room)
+            {   break;
+            }
+        }
+    }
+    return consumed;
 }
 
 #ifdef __cplusplus
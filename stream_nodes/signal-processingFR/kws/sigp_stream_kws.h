@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------
  * Project:      CMSIS Stream
- * Title:        sigp_stream_kws.c
- * Description:  filters
+ * Title:        sigp_stream_kws.h
+ * Description:  keyword spotting : MFCC front end and int8 DS-CNN classifier
  *
  * $Date:        15 February 2023
  * $Revision:    V0.0.1
@@ -22,68 +22,150 @@
  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  * See the License for the specific language governing permissions and
  * limitations under the License.
- * 
+ *
  */
 
 #ifdef __cplusplus
  extern "C" {
 #endif
-   
 
-#ifndef cDSP_kws_H
-#define cDSP_kws_H
+#ifndef csigp_STREAM_kws_H
+#define csigp_STREAM_kws_H
 
 
-//#include "../../stream_const.h"      
-//#include "../../stream_types.h"  
+#include "stream_const.h"
+#include "stream_types.h"
 
 
-    /* with MVE assembly or coprocessor acceleration */
-    /* --------------------------------------------- */
-    typedef int16_t q15_t;
+/*
+    10.	stream_kws
+    Operation : keyword spotting on a mono STREAM_S16 stream at 16kHz.
+    Front end : windows of 40ms every 20ms (KWS_HOP), Hann window, real FFT of KWS_FFT_LEN points
+    (platform service SERV_DSP_rFFT_Q31, plan shared with the other nodes), KWS_NB_MEL mel bands
+    from 20Hz to 4kHz, log2 (Q10), DCT to KWS_NB_MFCC coefficients. The frame is normalized
+    (block floating-point) before the FFT and the shift is removed in the log domain : the
+    log-mel energies are log2(sum of weight x |DFT(frame x window)|^2) with the samples in
+    int16 unit. The MFCC are quantized to int8 with the offsets and multipliers of the model
+    and kept in a rolling map of KWS_NB_FRAMES frames (1 second).
+
+    Classifier : int8 DS-CNN with KWS_CONV_T x KWS_CONV_F convolution stride 2x2 (map of
+    KWS_MAP_T x KWS_MAP_F x channels), "nblocks" depthwise 3x3 + pointwise blocks, average pooling
+    and a fully connected layer to the logits (Q8), softmax to the posteriors (Q15).
+    Each layer : accumulation in 32bits with an int32 bias, rounding shift, ReLU saturation
+    to 0..127. The model (kws_model) is loaded with SET_PARAMETER tag KWS_TAG_MODEL, from the
+    graph parameters or from a parameter arc. No inference is done before a model is loaded.
+
+    An inference is started every "period" hops, its steps (first convolution, one step per
+    block, classifier) are spread on the next hops when "steps_per_hop" is not 0, to bound the
+    cycles of each hop. An event of KWS_EVENT_SIZE words is produced at the end of each inference.
+*/
 
-    /**
-     * @brief Copy of the Instance structure for the Q15 Biquad cascade filter.
-     */
-    typedef struct
-    {
-            q15_t *pState;           /**< Points to the array of state coefficients.  The array is of length 4*numStages. */
-      const q15_t *pCoeffs;          /**< Points to the array of coefficients.  The array is of length 5*numStages. */
-            int8_t numStages;        /**< number of 2nd order stages in the filter.  Overall order is 2*numStages. */
-            int8_t postShift;        /**< Additional shift, in bits, applied to each output sample. */
-    } platform_arm_biquad_cascade_df1_inst_q15; 
-  
-/* ----------------------------- */
+#define KWS_SAMPLING_RATE           16000
+#define KWS_WINDOW                    640   /* 40ms */
+#define KWS_HOP                       320   /* 20ms */
+#define KWS_FFT_LEN                  1024
+#define KWS_NB_MEL                     40
+#define KWS_NB_MFCC                    10
+#define KWS_NB_FRAMES                  49   /* feature map of 1 second */
+#define KWS_LOG_Q                      10   /* log-mel and MFCC in log2 unit x 1024 */
+
+#define KWS_CONV_T                     10   /* first convolution kernel (time x frequency), stride 2x2 */
+#define KWS_CONV_F                      4
+#define KWS_MAP_T                     ((KWS_NB_FRAMES + 1) / 2)
+#define KWS_MAP_F                     (KWS_NB_MFCC / 2)
+#define KWS_MAP_SIZE                  (KWS_MAP_T * KWS_MAP_F)
+#define KWS_MAX_CHANNELS               32
+#define KWS_MAX_BLOCKS                  4
+#define KWS_MAX_CLASSES                12
+#define KWS_NB_SHIFTS                 (2 + 2 * KWS_MAX_BLOCKS)  /* conv, {depthwise, pointwise} x blocks, fully connected */
+
+#define KWS_TAG_MODEL                  16   /* SET_PARAMETER : kws_model */
+
+#define KWS_PRESET_200MS                0   /* inference every 200ms in one hop */
+#define KWS_PRESET_LOW_POWER            1   /* inference every 500ms, one step per hop */
+#define KWS_PRESET_FAST                 2   /* inference every 100ms, posteriors averaged on 4 inferences */
+
+/* event written on the output arc at the end of each inference */
+#define KWS_EVENT_FLAG                  0   /* 0x7FFF when a keyword is detected, else 0 */
+#define KWS_EVENT_CLASS                 1   /* keyword with the highest averaged posterior */
+#define KWS_EVENT_SCORE                 2   /* its averaged posterior, Q15 */
+#define KWS_EVENT_POSTERIOR             3   /* posteriors of the inference, Q15, KWS_MAX_CLASSES words */
+#define KWS_EVENT_SIZE                (KWS_EVENT_POSTERIOR + KWS_MAX_CLASSES)  /* int16 words */
+
+typedef struct          /* 8 Bytes  */
+{
+    uint8_t period;             /* hops between the start of two inferences, 1 .. KWS_NB_FRAMES */
+    uint8_t steps_per_hop;      /* steps of the inference per hop, 0 = whole inference in one hop */
+    uint8_t smoothing_shift;    /* average += (posterior - average) >> shift, 0 = no averaging */
+    uint8_t first_keyword;      /* the classes below (silence, unknown) are never detected */
+    int16_t threshold;          /* averaged posterior of a detection, Q15 */
+    uint8_t hold;               /* inferences without detection after a detection */
+    uint8_t pad___;
+} kws_parameters;
+
+
+typedef struct          /* 8168 Bytes */
+{
+    uint8_t nclasses;           /* 0 = no model */
+    uint8_t channels;           /* channels of the feature maps */
+    uint8_t nblocks;            /* depthwise-separable blocks */
+    uint8_t pad___;
+    int8_t shift [KWS_NB_SHIFTS];                   /* right shifts of the accumulators */
+    int16_t feature_offset [KWS_NB_MFCC];           /* int8 features = (mfcc - offset) x mult, Q10 */
+    int16_t feature_mult [KWS_NB_MFCC];             /* Q8, int8 unit per log2 unit */
+    int16_t pad2___;
+    int32_t conv_bias [KWS_MAX_CHANNELS];
+    int32_t dw_bias [KWS_MAX_BLOCKS][KWS_MAX_CHANNELS];
+    int32_t pw_bias [KWS_MAX_BLOCKS][KWS_MAX_CHANNELS];
+    int32_t fc_bias [KWS_MAX_CLASSES];
+    int8_t conv_weight [KWS_MAX_CHANNELS][KWS_CONV_T * KWS_CONV_F];
+    int8_t dw_weight [KWS_MAX_BLOCKS][9][KWS_MAX_CHANNELS];                 /* [3x3][channel] */
+    int8_t pw_weight [KWS_MAX_BLOCKS][KWS_MAX_CHANNELS][KWS_MAX_CHANNELS];  /* [output][input] */
+    int8_t fc_weight [KWS_MAX_CLASSES][KWS_MAX_CHANNELS];
+} kws_model;
 
-#define MAX_NB_BIQUAD_Q15 2
 
-/* ----------------------------- */
-/*
-    format:  {b10, 0, b11, b12, a11, a12, b20, 0, b21, b22, a21, a22, ...}
-    y[n] = 2^postShift (b0 * x[n] + b1 * x[n-1] + b2 * x[n-2]) + a1 * y[n-1] + a2 * y[n-2]
-    a1 and a2 have the opposite sign given by Matlab
-*/
+typedef struct
+{
+    int16_t frame [KWS_WINDOW];                         /* last window, the new hop at the end */
+    int32_t fft [KWS_FFT_LEN];                          /* normalized frame, then packed spectrum */
+    uint64_t mel [KWS_NB_MEL + 2];                      /* bands with a dummy band on both sides */
+    int8_t features [2 * KWS_NB_FRAMES][KWS_NB_MFCC];   /* each frame written twice : contiguous window */
+    int8_t map [2][KWS_MAP_SIZE * KWS_MAX_CHANNELS];    /* activations [time][frequency][channel] */
+    int32_t acc [KWS_MAX_CHANNELS];
+} sigp_kws_memory;
 
 
 typedef struct
-{   
-    platform_arm_biquad_cascade_df1_inst_q15 biquad_cascade_df1_inst_q15;
+{
+    kws_parameters config;      /* 8 bytes */
+    uint16_t fill;              /* samples of the current hop */
+    uint8_t write;              /* next frame of the feature map, the oldest frame of the window */
+    uint8_t nframes;            /* frames computed, up to KWS_NB_FRAMES */
+    uint8_t hops;               /* hops since the start of the last inference */
+    uint8_t step;               /* next step of the inference in progress, KWS_IDLE = none */
+    uint8_t hold;               /* down-counter of the inferences without detection */
+    int16_t posterior [KWS_MAX_CLASSES];
+    int16_t average [KWS_MAX_CLASSES];
+    stream_services *services;
+    void *fft_plan;             /* from SERV_DSP_rFFT_Q31 / SERV_DSP_INIT */
+    sigp_kws_memory *TCM;
+    kws_model *model;
+} sigp_kws_instance;
 
-    q15_t coefs[MAX_NB_BIQUAD_Q15*6];
-    q15_t state[MAX_NB_BIQUAD_Q15*4];        
+#define KWS_IDLE                     0xFF
 
-} arm_kws_memory;
 
+extern void sigp_stream_kws_init (sigp_kws_instance *instance);
+extern void sigp_stream_kws_config (sigp_kws_instance *instance);
+extern void sigp_stream_kws_load (sigp_kws_instance *instance);
 
-typedef struct
-{   uint32_t iir_service;
-    stream_services *services;
-    arm_kws_memory *TCM;
-} arm_kws_instance;
+extern int32_t sigp_stream_kws_process (sigp_kws_instance *instance,
+                     int16_t *in, int32_t inputLength,
+                     int16_t *pResult, int32_t *nbEvents);
 
-#endif
+#endif //csigp_STREAM_kws_H
 
 #ifdef __cplusplus
 }
 #endif
- 
\ No newline at end of file
@@ -0,0 +1,526 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        sigp_stream_kws_process.c
+ * Description:  keyword spotting : MFCC front end and int8 DS-CNN classifier
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "presets.h"
+#ifdef CODE_SIGP_KWS
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "sigp_stream_kws.h"
+#include "sigp_stream_kws_tables.h"
+
+
+/*
+    Front end, once per hop : the frame is windowed in Q30, shifted left to use 30 bits and
+    transformed in place by the platform real FFT (Q31, output scaled by 1/KWS_FFT_LEN). The
+    power of each bin (>> 16) is accumulated in 64bits in the two mel bands sharing the bin.
+    The constant KWS_LOG2_OFFSET removes the scaling of the FFT, of the power and of the
+    weights : 2^(15-10) on the spectrum, 2^-16 on the power, 2^15 on the weights.
+
+    Classifier : the feature map is read directly in the rolling buffer (each frame is written
+    twice, the last second is contiguous from the oldest frame). The activations are stored
+    [time][frequency][channel] in two banks : the output of each block goes back to map[0].
+    The inner loops are multiply-accumulates of int8 in 32bits on contiguous channels.
+*/
+
+#define KWS_LOG2_OFFSET     9           /* 2 x 5 - 16 + 15 */
+
+#define KWS_PAD_T           (((KWS_MAP_T - 1) * 2 + KWS_CONV_T - KWS_NB_FRAMES) / 2)  /* "same" padding */
+#define KWS_PAD_F           (((KWS_MAP_F - 1) * 2 + KWS_CONV_F - KWS_NB_MFCC) / 2)
+
+#define KWS_LOG2_C1         46642       /* log2(1+f) = f x (c1 + f x (c2 + f x c3)), Q15, error 1.3e-3 */
+#define KWS_LOG2_C2        -19247
+#define KWS_LOG2_C3          5415
+
+#define KWS_EXP2_C0         32765       /* 2^-f = c0 + f x (c1 + f x (c2 + f x c3)), Q15, error 1e-4 */
+#define KWS_EXP2_C1        -22646
+#define KWS_EXP2_C2          7557
+#define KWS_EXP2_C3         -1295
+#define KWS_LOG2_E          23637       /* Q14 */
+
+#define KWS_CLAMP_S8(x)     (int8_t)MIN(127, MAX(-128, (x)))
+#define KWS_RELU_S8(x)      (int8_t)MIN(127, MAX(0, (x)))
+
+
+/*
+    log2(x) in Q KWS_LOG_Q
+*/
+static int32_t kws_log2 (uint64_t x)
+{
+    int32_t e = 63, f, t;
+
+    x |= 1u;
+    if (0 == (x >> 32)) { x <<= 32; e -= 32; }
+    if (0 == (x >> 48)) { x <<= 16; e -= 16; }
+    if (0 == (x >> 56)) { x <<= 8;  e -= 8; }
+    if (0 == (x >> 60)) { x <<= 4;  e -= 4; }
+    if (0 == (x >> 62)) { x <<= 2;  e -= 2; }
+    if (0 == (x >> 63)) { x <<= 1;  e -= 1; }
+
+    f = (int32_t)((x >> 48) & 0x7FFFu);     /* fractional part of the mantissa, Q15 */
+    t = (KWS_LOG2_C3 * f) >> 15;
+    t = ((KWS_LOG2_C2 + t) * f) >> 15;
+    t = ((KWS_LOG2_C1 + t) * f) >> 15;
+    return (e << KWS_LOG_Q) + (t >> (15 - KWS_LOG_Q));
+}
+
+
+/*
+    2^-x, x >= 0 in Q8, result in Q15
+*/
+static int32_t kws_exp2_neg (int32_t x)
+{
+    int32_t n = x >> 8, f = (x & 255) << 7, t;
+
+    if (n > 15)
+    {   return 0;
+    }
+    t = (KWS_EXP2_C3 * f) >> 15;
+    t = ((KWS_EXP2_C2 + t) * f) >> 15;
+    t = ((KWS_EXP2_C1 + t) * f) >> 15;
+    return (KWS_EXP2_C0 + t) >> n;
+}
+
+
+/*
+    MFCC of the last window, quantized in the feature map
+*/
+static void kws_features (sigp_kws_instance *pinstance)
+{
+    sigp_kws_memory *TCM = pinstance->TCM;
+    kws_model *model = pinstance->model;
+    int32_t *fft = TCM->fft, x, m, shift, logmel [KWS_NB_MEL];
+    int64_t mfcc;
+    uint64_t p;
+    int8_t *feat;
+    uint32_t i, b, k;
+
+    /* windowed frame, normalized to 30 bits */
+    for (i = 0, m = 0; i < KWS_WINDOW; i++)
+    {   x = TCM->frame[i] * kws_window[i];
+        fft[i] = x;
+        m |= ABS(x);
+    }
+    for (shift = 0; shift < 30 && 0 == (m >> (29 - shift)); shift++)
+    {   ;
+    }
+    for (i = 0; i < KWS_WINDOW; i++)
+    {   fft[i] = fft[i] << shift;
+    }
+    for (; i < KWS_FFT_LEN; i++)
+    {   fft[i] = 0;
+    }
+
+    pinstance->services(
+        PACK_SERVICE(SERV_DSP_RUN, NOOPTION_SSRV, NOTAG_SSRV, SERV_DSP_rFFT_Q31, SERV_GROUP_DSP_ML),
+        (intptr_t)(pinstance->fft_plan), (intptr_t)fft, (intptr_t)fft, 0);
+
+    /* mel bands : each bin is in the falling slope of a band and the rising slope of the next */
+    for (b = 0; b < KWS_NB_MEL + 2; b++)
+    {   TCM->mel[b] = 0;
+    }
+    for (i = 0, k = KWS_MEL_FIRST_BIN; i < KWS_MEL_NB_BINS; i++, k++)
+    {   p = (uint64_t)(((int64_t)fft[2*k] * fft[2*k] + (int64_t)fft[2*k+1] * fft[2*k+1]) >> 16);
+        b = kws_mel_segment[i];
+        TCM->mel[b]     += p * (uint32_t)(kws_mel_weight[i]);
+        TCM->mel[b + 1] += p * (uint32_t)(32768 - kws_mel_weight[i]);
+    }
+    for (b = 0; b < KWS_NB_MEL; b++)
+    {   logmel[b] = kws_log2 (TCM->mel[b + 1]) - ((2 * shift + KWS_LOG2_OFFSET) << KWS_LOG_Q);
+    }
+
+    /* DCT and quantization, the frame is written twice in the rolling buffer */
+    feat = TCM->features[pinstance->write];
+    for (i = 0; i < KWS_NB_MFCC; i++)
+    {   mfcc = 0;
+        for (b = 0; b < KWS_NB_MEL; b++)
+        {   mfcc += (int64_t)kws_dct[i][b] * logmel[b];
+        }
+        x = (int32_t)(mfcc >> 15) - model->feature_offset[i];
+        x = (int32_t)(((int64_t)x * model->feature_mult[i] + (1 << 17)) >> 18);
+        feat[i] = KWS_CLAMP_S8(x);
+        feat[i + KWS_NB_FRAMES * KWS_NB_MFCC] = feat[i];
+    }
+    pinstance->write = (uint8_t)((pinstance->write + 1u == KWS_NB_FRAMES) ? 0 : pinstance->write + 1u);
+    pinstance->nframes = (uint8_t)MIN(KWS_NB_FRAMES, pinstance->nframes + 1u);
+}
+
+
+/*
+    first convolution, KWS_CONV_T x KWS_CONV_F stride 2x2, on the feature map of the last second
+*/
+static void kws_conv (sigp_kws_instance *pinstance)
+{
+    kws_model *model = pinstance->model;
+    const int8_t *in = pinstance->TCM->features[pinstance->write];
+    int8_t *out = pinstance->TCM->map[0];
+    int16_t patch [KWS_CONV_T * KWS_CONV_F];
+    int32_t acc, t, f, i, j, tt, ff;
+    int32_t shift = model->shift[0], rnd = (1 << shift) >> 1;
+    uint32_t c, k, C = model->channels;
+
+    for (t = 0; t < KWS_MAP_T; t++)
+    {   for (f = 0; f < KWS_MAP_F; f++)
+        {   for (i = 0; i < KWS_CONV_T; i++)
+            {   for (j = 0; j < KWS_CONV_F; j++)
+                {   tt = 2 * t - KWS_PAD_T + i;
+                    ff = 2 * f - KWS_PAD_F + j;
+                    patch[i * KWS_CONV_F + j] = (tt < 0 || tt >= KWS_NB_FRAMES || ff < 0 || ff >= KWS_NB_MFCC) ?
+                        0 : in[tt * KWS_NB_MFCC + ff];
+                }
+            }
+            for (c = 0; c < C; c++)
+            {   acc = model->conv_bias[c];
+                for (k = 0; k < KWS_CONV_T * KWS_CONV_F; k++)
+                {   acc += model->conv_weight[c][k] * patch[k];
+                }
+                *out++ = KWS_RELU_S8((acc + rnd) >> shift);
+            }
+        }
+    }
+}
+
+
+/*
+    depthwise 3x3 stride 1, "same" padding
+*/
+static void kws_depthwise (const int8_t *in, int8_t *out, const int8_t *w, const int32_t *bias,
+                    int32_t *acc, uint32_t C, int32_t shift)
+{
+    int32_t rnd = (1 << shift) >> 1, t, f, i, j;
+    const int8_t *src, *k;
+    uint32_t c;
+
+    for (t = 0; t < KWS_MAP_T; t++)
+    {   for (f = 0; f < KWS_MAP_F; f++)
+        {   for (c = 0; c < C; c++)
+            {   acc[c] = bias[c];
+            }
+            for (i = MAX(0, t - 1); i <= MIN(KWS_MAP_T - 1, t + 1); i++)
+            {   for (j = MAX(0, f - 1); j <= MIN(KWS_MAP_F - 1, f + 1); j++)
+                {   src = &(in[(i * KWS_MAP_F + j) * C]);
+                    k = &(w[((i - t + 1) * 3 + (j - f + 1)) * KWS_MAX_CHANNELS]);
+                    for (c = 0; c < C; c++)
+                    {   acc[c] += k[c] * src[c];
+                    }
+                }
+            }
+            for (c = 0; c < C; c++)
+            {   *out++ = KWS_RELU_S8((acc[c] + rnd) >> shift);
+            }
+        }
+    }
+}
+
+
+/*
+    pointwise 1x1 : C x C matrix on each point of the map
+*/
+static void kws_pointwise (const int8_t *in, int8_t *out, const int8_t *w, const int32_t *bias,
+                    uint32_t C, int32_t shift)
+{
+    int32_t rnd = (1 << shift) >> 1, acc;
+    const int8_t *k;
+    uint32_t p, c, ci;
+
+    for (p = 0; p < KWS_MAP_SIZE; p++, in += C)
+    {   for (c = 0; c < C; c++)
+        {   k = &(w[c * KWS_MAX_CHANNELS]);
+            acc = bias[c];
+            for (ci = 0; ci < C; ci++)
+            {   acc += k[ci] * in[ci];
+            }
+            *out++ = KWS_RELU_S8((acc + rnd) >> shift);
+        }
+    }
+}
+
+
+/*
+    average pooling, fully connected layer to the logits (Q8), softmax to the posteriors (Q15)
+*/
+static void kws_classifier (sigp_kws_instance *pinstance)
+{
+    kws_model *model = pinstance->model;
+    int32_t *avg = pinstance->TCM->acc, logit [KWS_MAX_CLASSES], e [KWS_MAX_CLASSES];
+    int32_t shift = model->shift[KWS_NB_SHIFTS - 1], rnd = (1 << shift) >> 1, lmax, sum;
+    const int8_t *in = pinstance->TCM->map[0];
+    uint32_t p, c, k, C = model->channels, K = model->nclasses;
+
+    for (c = 0; c < C; c++)
+    {   avg[c] = 0;
+    }
+    for (p = 0; p < KWS_MAP_SIZE; p++, in += C)
+    {   for (c = 0; c < C; c++)
+        {   avg[c] += in[c];
+        }
+    }
+    for (c = 0; c < C; c++)
+    {   avg[c] = (avg[c] + KWS_MAP_SIZE / 2) / KWS_MAP_SIZE;
+    }
+
+    for (k = 0, lmax = INT32_MIN; k < K; k++)
+    {   logit[k] = model->fc_bias[k];
+        for (c = 0; c < C; c++)
+        {   logit[k] += model->fc_weight[k][c] * avg[c];
+        }
+        logit[k] = (logit[k] + rnd) >> shift;
+        lmax = MAX(lmax, logit[k]);
+    }
+    for (k = 0, sum = 0; k < K; k++)
+    {   e[k] = kws_exp2_neg ((MIN(1 << 16, lmax - logit[k]) * KWS_LOG2_E) >> 14);
+        sum += e[k];
+    }
+    for (k = 0; k < K; k++)
+    {   pinstance->posterior[k] = (int16_t)MIN(32767, (e[k] * 32767 + sum / 2) / sum);
+    }
+}
+
+
+/*
+    one step of the inference : first convolution, one block, or the classifier
+*/
+static void kws_step (sigp_kws_instance *pinstance)
+{
+    kws_model *model = pinstance->model;
+    sigp_kws_memory *TCM = pinstance->TCM;
+    uint32_t b = pinstance->step - 1u;
+
+    if (pinstance->step == 0)
+    {   kws_conv (pinstance);
+    }
+    else if (pinstance->step <= model->nblocks)
+    {   kws_depthwise (TCM->map[0], TCM->map[1], model->dw_weight[b][0], model->dw_bias[b], TCM->acc,
+                    model->channels, model->shift[1 + 2 * b]);
+        kws_pointwise (TCM->map[1], TCM->map[0], model->pw_weight[b][0], model->pw_bias[b],
+                    model->channels, model->shift[2 + 2 * b]);
+    }
+    else
+    {   kws_classifier (pinstance);
+    }
+    pinstance->step++;
+}
+
+
+/*
+    averaging of the posteriors and detection
+*/
+static void kws_event (sigp_kws_instance *pinstance, int16_t *event)
+{
+    kws_parameters *config = &(pinstance->config);
+    uint32_t k, K = pinstance->model->nclasses, best = config->first_keyword;
+
+    for (k = 0; k < KWS_MAX_CLASSES; k++)
+    {   if (k < K)
+        {   pinstance->average[k] = (int16_t)(pinstance->average[k] +
+                ((pinstance->posterior[k] - pinstance->average[k]) >> config->smoothing_shift));
+        }
+        event[KWS_EVENT_POSTERIOR + k] = (k < K) ? pinstance->posterior[k] : 0;
+    }
+    for (k = best; k < K; k++)
+    {   if (pinstance->average[k] > pinstance->average[best])
+        {   best = k;
+        }
+    }
+
+    event[KWS_EVENT_FLAG] = 0;
+    event[KWS_EVENT_CLASS] = (int16_t)((best < K) ? best : 0);
+    event[KWS_EVENT_SCORE] = (best < K) ? pinstance->average[best] : 0;
+    if (pinstance->hold > 0)
+    {   pinstance->hold--;
+    }
+    else if (best < K && pinstance->average[best] >= config->threshold)
+    {   event[KWS_EVENT_FLAG] = 0x7FFF;
+        pinstance->hold = config->hold;
+    }
+}
+
+
+/*
+    initialization of the front end and of the feature map, after a reset
+*/
+void sigp_stream_kws_init (sigp_kws_instance *pinstance)
+{
+    int8_t *pt8 = &(pinstance->TCM->features[0][0]);
+    uint32_t i;
+
+    for (i = 0; i < KWS_WINDOW; i++)
+    {   pinstance->TCM->frame[i] = 0;
+    }
+    for (i = 0; i < sizeof(pinstance->TCM->features); i++)
+    {   pt8[i] = 0;
+    }
+    sigp_stream_kws_config (pinstance);
+    pinstance->fill = 0;
+    pinstance->write = 0;
+    pinstance->nframes = 0;
+    pinstance->hops = 0;
+    sigp_stream_kws_load (pinstance);
+
+    if (0 == pinstance->fft_plan)
+    {   pinstance->services(
+            PACK_SERVICE(SERV_DSP_INIT, NOOPTION_SSRV, NOTAG_SSRV, SERV_DSP_rFFT_Q31, SERV_GROUP_DSP_ML),
+            (intptr_t)&(pinstance->fft_plan), 0, 0, KWS_FFT_LEN);
+    }
+}
+
+
+/*
+    new parameters : checks of the ranges, the feature map and the inference in progress are kept
+*/
+void sigp_stream_kws_config (sigp_kws_instance *pinstance)
+{
+    kws_parameters *config = &(pinstance->config);
+
+    config->period = (uint8_t)MAX(1, MIN(KWS_NB_FRAMES, config->period));
+    config->smoothing_shift = (uint8_t)MIN(15, config->smoothing_shift);
+}
+
+
+/*
+    new model : checks of the geometry and restart of the detection
+*/
+void sigp_stream_kws_load (sigp_kws_instance *pinstance)
+{
+    kws_model *model = pinstance->model;
+    uint32_t i;
+
+    model->nclasses = (uint8_t)MIN(KWS_MAX_CLASSES, model->nclasses);
+    model->channels = (uint8_t)MAX(1, MIN(KWS_MAX_CHANNELS, model->channels));
+    model->nblocks = (uint8_t)MIN(KWS_MAX_BLOCKS, model->nblocks);
+    for (i = 0; i < KWS_NB_SHIFTS; i++)
+    {   model->shift[i] = (int8_t)MAX(0, MIN(31, model->shift[i]));
+    }
+    for (i = 0; i < KWS_MAX_CLASSES; i++)
+    {   pinstance->posterior[i] = 0;
+        pinstance->average[i] = 0;
+    }
+    pinstance->step = KWS_IDLE;
+    pinstance->hold = 0;
+}
+
+
+/*
+    the next hop ends an inference and produces an event : same conditions than the
+    processing loop, with the counters incremented by the hop
+*/
+static uint8_t kws_event_at_hop_end (sigp_kws_instance *pinstance)
+{
+    kws_parameters *config = &(pinstance->config);
+    uint32_t step = pinstance->step, last = pinstance->model->nblocks + 2u;
+
+    if (0 == pinstance->model->nclasses)
+    {   return 0;
+    }
+    if (step == KWS_IDLE)
+    {   if (MIN(255, pinstance->hops + 1u) < config->period || MIN(KWS_NB_FRAMES, pinstance->nframes + 1u) < KWS_NB_FRAMES)
+        {   return 0;
+        }
+        step = 0;
+    }
+    return (uint8_t)(config->steps_per_hop == 0 || step + config->steps_per_hop >= last);
+}
+
+
+/**
+  @brief         Processing function
+  @param[in]     instance     points to an instance of the keyword spotting
+  @param[in]     in           mono samples at 16kHz
+  @param[in]     inputLength  samples in the input arc
+  @param[out]    pResult      events of KWS_EVENT_SIZE words
+  @param[in/out] nbEvents     room in the output arc / events produced
+  @return        number of samples consumed
+ */
+int32_t sigp_stream_kws_process (sigp_kws_instance *pinstance,
+                     int16_t *in, int32_t inputLength,
+                     int16_t *pResult, int32_t *nbEvents)
+{
+    sigp_kws_memory *TCM = pinstance->TCM;
+    kws_parameters *config = &(pinstance->config);
+    uint32_t nsteps, last = pinstance->model->nblocks + 2u;
+    int32_t consumed = 0, events = 0, m, i;
+
+    if (0 == pinstance->fft_plan)
+    {   *nbEvents = 0;
+        return inputLength;
+    }
+
+    while (consumed < inputLength)
+    {   m = MIN(inputLength - consumed, KWS_HOP - pinstance->fill);
+
+        /* no room for the event produced at the end of this hop */
+        if (pinstance->fill + m == KWS_HOP && events >= *nbEvents && kws_event_at_hop_end (pinstance))
+        {   break;
+        }
+        for (i = 0; i < m; i++)
+        {   TCM->frame[KWS_WINDOW - KWS_HOP + pinstance->fill + i] = in[consumed + i];
+        }
+        consumed += m;
+        pinstance->fill = (uint16_t)(pinstance->fill + m);
+        if (pinstance->fill < KWS_HOP)
+        {   break;
+        }
+
+        pinstance->fill = 0;
+        kws_features (pinstance);
+        for (i = 0; i < KWS_WINDOW - KWS_HOP; i++)
+        {   TCM->frame[i] = TCM->frame[i + KWS_HOP];
+        }
+        if (0 == pinstance->model->nclasses)
+        {   continue;
+        }
+
+        /* start of an inference, steps of the inference in progress */
+        pinstance->hops = (uint8_t)MIN(255, pinstance->hops + 1u);
+        if (pinstance->step == KWS_IDLE && pinstance->hops >= config->period && pinstance->nframes >= KWS_NB_FRAMES)
+        {   pinstance->step = 0;
+            pinstance->hops = 0;
+        }
+        for (nsteps = 0; pinstance->step < last && (config->steps_per_hop == 0 || nsteps < config->steps_per_hop); nsteps++)
+        {   kws_step (pinstance);
+        }
+        if (pinstance->step == last)
+        {   kws_event (pinstance, &(pResult[events * KWS_EVENT_SIZE]));
+            events++;
+            pinstance->step = KWS_IDLE;
+        }
+    }
+
+    *nbEvents = events;
+    return consumed;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CODE_SIGP_KWS
@@ -0,0 +1,152 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        sigp_stream_kws_tables.h
+ * Description:  constant tables of the MFCC front end of the keyword spotting
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef csigp_STREAM_kws_tables_H
+#define csigp_STREAM_kws_tables_H
+
+/*
+    16kHz, windows of KWS_WINDOW samples, FFT of KWS_FFT_LEN points, KWS_NB_MEL bands from
+    20Hz to 4kHz (mel = 2595 log10(1 + f/700)), KWS_NB_MFCC coefficients.
+
+    The bins KWS_MEL_FIRST_BIN .. KWS_MEL_LAST_BIN are between the centers of the triangles
+    kws_mel_segment[] and kws_mel_segment[] + 1 : they are in the falling slope of the band
+    kws_mel_segment[] - 1 with the weight kws_mel_weight[] (Q15), and in the rising slope of
+    the band kws_mel_segment[] with the weight 1 - kws_mel_weight[].
+*/
+
+#define KWS_MEL_FIRST_BIN       2
+#define KWS_MEL_LAST_BIN      255
+#define KWS_MEL_NB_BINS       (KWS_MEL_LAST_BIN - KWS_MEL_FIRST_BIN + 1)
+
+/* periodic Hann window, Q15 */
+static const int16_t kws_window [KWS_WINDOW] =
+{
+         0,      1,      3,      7,     13,     20,     28,     39,     51,     64,     79,     95,    114,    133,    155,    177,
+       202,    228,    255,    284,    315,    347,    381,    416,    453,    491,    531,    572,    615,    660,    705,    753,
+       802,    852,    904,    958,   1013,   1069,   1127,   1186,   1247,   1309,   1373,   1438,   1505,   1573,   1643,   1713,
+      1786,   1859,   1935,   2011,   2089,   2168,   2249,   2331,   2414,   2499,   2585,   2672,   2761,   2851,   2943,   3035,
+      3129,   3224,   3321,   3418,   3517,   3618,   3719,   3822,   3926,   4031,   4137,   4244,   4353,   4463,   4574,   4686,
+      4799,   4913,   5028,   5145,   5263,   5381,   5501,   5622,   5743,   5866,   5990,   6115,   6241,   6368,   6495,   6624,
+      6754,   6884,   7016,   7148,   7282,   7416,   7551,   7687,   7823,   7961,   8099,   8238,   8378,   8519,   8661,   8803,
+      8946,   9089,   9234,   9379,   9525,   9671,   9818,   9966,  10114,  10263,  10413,  10563,  10713,  10864,  11016,  11168,
+     11321,  11474,  11628,  11782,  11937,  12092,  12247,  12403,  12559,  12716,  12873,  13030,  13188,  13346,  13504,  13662,
+     13821,  13980,  14139,  14299,  14458,  14618,  14778,  14938,  15099,  15259,  15419,  15580,  15741,  15902,  16062,  16223,
+     16384,  16545,  16706,  16866,  17027,  17188,  17349,  17509,  17669,  17830,  17990,  18150,  18310,  18469,  18629,  18788,
+     18947,  19106,  19264,  19422,  19580,  19738,  19895,  20052,  20209,  20365,  20521,  20676,  20831,  20986,  21140,  21294,
+     21447,  21600,  21752,  21904,  22055,  22205,  22355,  22505,  22654,  22802,  22950,  23097,  23243,  23389,  23534,  23679,
+     23822,  23965,  24107,  24249,  24390,  24530,  24669,  24807,  24945,  25081,  25217,  25352,  25486,  25620,  25752,  25884,
+     26014,  26144,  26273,  26400,  26527,  26653,  26778,  26902,  27025,  27146,  27267,  27387,  27505,  27623,  27740,  27855,
+     27969,  28082,  28194,  28305,  28415,  28524,  28631,  28737,  28842,  28946,  29049,  29150,  29251,  29350,  29447,  29544,
+     29639,  29733,  29825,  29917,  30007,  30096,  30183,  30269,  30354,  30437,  30519,  30600,  30679,  30757,  30833,  30909,
+     30982,  31055,  31125,  31195,  31263,  31330,  31395,  31459,  31521,  31582,  31641,  31699,  31755,  31810,  31864,  31916,
+     31966,  32015,  32063,  32108,  32153,  32196,  32237,  32277,  32315,  32352,  32387,  32421,  32453,  32484,  32513,  32540,
+     32566,  32591,  32613,  32635,  32654,  32673,  32689,  32704,  32717,  32729,  32740,  32748,  32755,  32761,  32765,  32767,
+     32767,  32767,  32765,  32761,  32755,  32748,  32740,  32729,  32717,  32704,  32689,  32673,  32654,  32635,  32613,  32591,
+     32566,  32540,  32513,  32484,  32453,  32421,  32387,  32352,  32315,  32277,  32237,  32196,  32153,  32108,  32063,  32015,
+     31966,  31916,  31864,  31810,  31755,  31699,  31641,  31582,  31521,  31459,  31395,  31330,  31263,  31195,  31125,  31055,
+     30982,  30909,  30833,  30757,  30679,  30600,  30519,  30437,  30354,  30269,  30183,  30096,  30007,  29917,  29825,  29733,
+     29639,  29544,  29447,  29350,  29251,  29150,  29049,  28946,  28842,  28737,  28631,  28524,  28415,  28305,  28194,  28082,
+     27969,  27855,  27740,  27623,  27505,  27387,  27267,  27146,  27025,  26902,  26778,  26653,  26527,  26400,  26273,  26144,
+     26014,  25884,  25752,  25620,  25486,  25352,  25217,  25081,  24945,  24807,  24669,  24530,  24390,  24249,  24107,  23965,
+     23822,  23679,  23534,  23389,  23243,  23097,  22950,  22802,  22654,  22505,  22355,  22205,  22055,  21904,  21752,  21600,
+     21447,  21294,  21140,  20986,  20831,  20676,  20521,  20365,  20209,  20052,  19895,  19738,  19580,  19422,  19264,  19106,
+     18947,  18788,  18629,  18469,  18310,  18150,  17990,  17830,  17669,  17509,  17349,  17188,  17027,  16866,  16706,  16545,
+     16384,  16223,  16062,  15902,  15741,  15580,  15419,  15259,  15099,  14938,  14778,  14618,  14458,  14299,  14139,  13980,
+     13821,  13662,  13504,  13346,  13188,  13030,  12873,  12716,  12559,  12403,  12247,  12092,  11937,  11782,  11628,  11474,
+     11321,  11168,  11016,  10864,  10713,  10563,  10413,  10263,  10114,   9966,   9818,   9671,   9525,   9379,   9234,   9089,
+      8946,   8803,   8661,   8519,   8378,   8238,   8099,   7961,   7823,   7687,   7551,   7416,   7282,   7148,   7016,   6884,
+      6754,   6624,   6495,   6368,   6241,   6115,   5990,   5866,   5743,   5622,   5501,   5381,   5263,   5145,   5028,   4913,
+      4799,   4686,   4574,   4463,   4353,   4244,   4137,   4031,   3926,   3822,   3719,   3618,   3517,   3418,   3321,   3224,
+      3129,   3035,   2943,   2851,   2761,   2672,   2585,   2499,   2414,   2331,   2249,   2168,   2089,   2011,   1935,   1859,
+      1786,   1713,   1643,   1573,   1505,   1438,   1373,   1309,   1247,   1186,   1127,   1069,   1013,    958,    904,    852,
+       802,    753,    705,    660,    615,    572,    531,    491,    453,    416,    381,    347,    315,    284,    255,    228,
+       202,    177,    155,    133,    114,     95,     79,     64,     51,     39,     28,     20,     13,      7,      3,      1,
+};
+
+static const uint8_t kws_mel_segment [KWS_MEL_NB_BINS] =
+{
+     0,  0,  1,  1,  2,  2,  2,  3,  3,  4,  4,  4,  5,  5,  6,  6,  6,  7,  7,  7,
+     8,  8,  8,  9,  9,  9,  9, 10, 10, 10, 11, 11, 11, 12, 12, 12, 12, 13, 13, 13,
+    13, 14, 14, 14, 14, 15, 15, 15, 15, 15, 16, 16, 16, 16, 17, 17, 17, 17, 17, 18,
+    18, 18, 18, 18, 19, 19, 19, 19, 19, 20, 20, 20, 20, 20, 21, 21, 21, 21, 21, 21,
+    22, 22, 22, 22, 22, 22, 23, 23, 23, 23, 23, 23, 24, 24, 24, 24, 24, 24, 25, 25,
+    25, 25, 25, 25, 25, 26, 26, 26, 26, 26, 26, 26, 27, 27, 27, 27, 27, 27, 27, 27,
+    28, 28, 28, 28, 28, 28, 28, 29, 29, 29, 29, 29, 29, 29, 29, 29, 30, 30, 30, 30,
+    30, 30, 30, 30, 31, 31, 31, 31, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 33, 33, 33, 33, 33, 33, 33, 33, 33, 33, 34, 34, 34, 34, 34, 34, 34, 34,
+    34, 34, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 35, 36, 36, 36, 36, 36, 36, 36,
+    36, 36, 36, 36, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 38, 38, 38, 38,
+    38, 38, 38, 38, 38, 38, 38, 38, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
+    39, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,
+};
+
+static const int16_t kws_mel_weight [KWS_MEL_NB_BINS] =
+{
+     21833,   6645,  24607,  10098,  28555,  14695,    835,  20326,   7086,  26890,  14242,   1595,  22209,  10127,  30901,  19359,
+      7818,  29211,  18185,   7160,  29075,  18543,   8011,  30359,  20298,  10237,    176,  23325,  13714,   4103,  27506,  18325,
+      9143,  32732,  23961,  15190,   6420,  30522,  22144,  13766,   5387,  29911,  21907,  13903,   5900,  30758,  23113,  15467,
+      7821,    176,  25632,  18328,  11025,   3721,  29346,  22369,  15392,   8415,   1438,  27476,  20811,  14146,   7482,    817,
+     27181,  20814,  14447,   8081,   1714,  28323,  22241,  16159,  10077,   3995,  30774,  24964,  19154,  13344,   7534,   1724,
+     28864,  23314,  17764,  12214,   6664,   1113,  28530,  23228,  17926,  12624,   7322,   2020,  29633,  24568,  19503,  14438,
+      9374,   4309,  32046,  27207,  22369,  17531,  12693,   7854,   3016,  31027,  26405,  21784,  17162,  12540,   7918,   3296,
+     31501,  27086,  22671,  18256,  13841,   9426,   5011,    595,  29119,  24901,  20684,  16466,  12248,   8031,   3813,  32381,
+     28352,  24323,  20294,  16265,  12236,   8207,   4178,    149,  29062,  25213,  21364,  17515,  13666,   9817,   5969,   2120,
+     31116,  27440,  23763,  20086,  16409,  12733,   9056,   5379,   1703,  30882,  27370,  23858,  20346,  16833,  13321,   9809,
+      6297,   2784,  32073,  28718,  25362,  22007,  18652,  15297,  11942,   8587,   5231,   1876,  31355,  28150,  24945,  21740,
+     18535,  15330,  12125,   8920,   5715,   2509,  32104,  29042,  25980,  22918,  19857,  16795,  13733,  10671,   7610,   4548,
+      1486,  31263,  28338,  25413,  22489,  19564,  16639,  13714,  10789,   7865,   4940,   2015,  31899,  29105,  26311,  23517,
+     20723,  17929,  15135,  12341,   9547,   6753,   3959,   1165,  31212,  28543,  25874,  23205,  20536,  17867,  15198,  12529,
+      9860,   7191,   4522,   1853,  31988,  29439,  26889,  24339,  21790,  19240,  16691,  14141,  11591,   9042,   6492,   3942,
+      1393,  31663,  29227,  26792,  24356,  21920,  19485,  17049,  14614,  12178,   9742,   7307,   4871,   2436,
+};
+
+/* orthonormal DCT-II, Q15 */
+static const int16_t kws_dct [KWS_NB_MFCC][KWS_NB_MEL] =
+{
+    {  5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,
+       5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181,   5181},
+    {  7321,   7276,   7186,   7052,   6874,   6654,   6393,   6092,   5754,   5380,   4974,   4536,   4071,   3580,   3068,   2536,   1989,   1429,    861,    288,
+       -288,   -861,  -1429,  -1989,  -2536,  -3068,  -3580,  -4071,  -4536,  -4974,  -5380,  -5754,  -6092,  -6393,  -6654,  -6874,  -7052,  -7186,  -7276,  -7321},
+    {  7305,   7125,   6769,   6247,   5572,   4759,   3828,   2804,   1710,    575,   -575,  -1710,  -2804,  -3828,  -4759,  -5572,  -6247,  -6769,  -7125,  -7305,
+      -7305,  -7125,  -6769,  -6247,  -5572,  -4759,  -3828,  -2804,  -1710,   -575,    575,   1710,   2804,   3828,   4759,   5572,   6247,   6769,   7125,   7305},
+    {  7276,   6874,   6092,   4974,   3580,   1989,    288,  -1429,  -3068,  -4536,  -5754,  -6654,  -7186,  -7321,  -7052,  -6393,  -5380,  -4071,  -2536,   -861,
+        861,   2536,   4071,   5380,   6393,   7052,   7321,   7186,   6654,   5754,   4536,   3068,   1429,   -288,  -1989,  -3580,  -4974,  -6092,  -6874,  -7276},
+    {  7237,   6529,   5181,   3326,   1146,  -1146,  -3326,  -5181,  -6529,  -7237,  -7237,  -6529,  -5181,  -3326,  -1146,   1146,   3326,   5181,   6529,   7237,
+       7237,   6529,   5181,   3326,   1146,  -1146,  -3326,  -5181,  -6529,  -7237,  -7237,  -6529,  -5181,  -3326,  -1146,   1146,   3326,   5181,   6529,   7237},
+    {  7186,   6092,   4071,   1429,  -1429,  -4071,  -6092,  -7186,  -7186,  -6092,  -4071,  -1429,   1429,   4071,   6092,   7186,   7186,   6092,   4071,   1429,
+      -1429,  -4071,  -6092,  -7186,  -7186,  -6092,  -4071,  -1429,   1429,   4071,   6092,   7186,   7186,   6092,   4071,   1429,  -1429,  -4071,  -6092,  -7186},
+    {  7125,   5572,   2804,   -575,  -3828,  -6247,  -7305,  -6769,  -4759,  -1710,   1710,   4759,   6769,   7305,   6247,   3828,    575,  -2804,  -5572,  -7125,
+      -7125,  -5572,  -2804,    575,   3828,   6247,   7305,   6769,   4759,   1710,  -1710,  -4759,  -6769,  -7305,  -6247,  -3828,   -575,   2804,   5572,   7125},
+    {  7052,   4974,   1429,  -2536,  -5754,  -7276,  -6654,  -4071,   -288,   3580,   6393,   7321,   6092,   3068,   -861,  -4536,  -6874,  -7186,  -5380,  -1989,
+       1989,   5380,   7186,   6874,   4536,    861,  -3068,  -6092,  -7321,  -6393,  -3580,    288,   4071,   6654,   7276,   5754,   2536,  -1429,  -4974,  -7052},
+    {  6969,   4307,      0,  -4307,  -6969,  -6969,  -4307,      0,   4307,   6969,   6969,   4307,      0,  -4307,  -6969,  -6969,  -4307,      0,   4307,   6969,
+       6969,   4307,      0,  -4307,  -6969,  -6969,  -4307,      0,   4307,   6969,   6969,   4307,      0,  -4307,  -6969,  -6969,  -4307,      0,   4307,   6969},
+    {  6874,   3580,  -1429,  -5754,  -7321,  -5380,   -861,   4071,   7052,   6654,   3068,  -1989,  -6092,  -7276,  -4974,   -288,   4536,   7186,   6393,   2536,
+      -2536,  -6393,  -7186,  -4536,    288,   4974,   7276,   6092,   1989,  -3068,  -6654,  -7052,  -4071,    861,   5380,   7321,   5754,   1429,  -3580,  -6874},
+};
+
+#endif
@@ -43,7 +43,8 @@
     data format conversion
 ---------------------------------------
 */
-extern void sigp_stream_resampler_process (sigp_stream_resampler_instance *instance, uint8_t TAG_CMD, stream_xdmbuffer_t *in_out);
+extern uint8_t sigp_stream_resampler_init (sigp_stream_resampler_instance *instance, uint32_t *format_in, uint32_t *format_out, uint32_t bufsize_in);
+extern void sigp_stream_resampler_process (sigp_stream_resampler_instance *instance, stream_xdmbuffer_t *in_out);
 
 /*
 ;----------------------------------------------------------------------------------------
@@ -59,10 +60,18 @@ extern void sigp_stream_resampler_process (sigp_stream_resampler_instance *insta
           ASRC (2) asynchronous rate converter using time-stamps (in) to synchronous FS (out)
           unused(3)
 ;
+;   SSRC : polyphase FIR with L/M from the sampling rates of the arcs (ratios 1:6 .. 6:1),
+;       coefficients computed at reset, S16 / S32 / FP32 interleaved, up to 8 channels
+;       node_mem 1 = coefficients, node_mem 2 = delay-line (RESAMPLER_DELAY_FRAMES per channel)
+;
 ;   drift compensation managed with STREAM_SET_PARAMETER command:
 ;   TAG_CMD = 0 to stop drift compensation
 ;   TAG_CMD = 1 to apply a drift compensation of +100ppm
 ;   TAG_CMD = 2 to apply a drift compensation of -100ppm
+;   TAG_CMD = 3 to track the fill level of the input arc (+/-1000ppm)
+;
+;   the reset returns NODE_TASKS_ERROR and the node is disabled when L or M is above 6, or
+;       when STREAM_FLOAT_ALLOWED is 0 and the rates are different or the arcs are FP32
 ;
     sigp_stream_resampler; 0 instance; 0 raw conversion; 0 no parameter; 
 */
@@ -98,6 +107,26 @@ void sigp_stream_resampler (unsigned int command, void *instance, void *data, un
             uint16_t preset = RD(command, PRESET_CMD);
 
             sigp_stream_resampler_instance *pinstance = (sigp_stream_resampler_instance *) *memresults;
+
+            pinstance->stream_entry = stream_entry;
+            pinstance->preset = (uint8_t)preset;
+            pinstance->drift = RESAMPLER_DRIFT_OFF;
+            pinstance->disabled = 0;
+
+            /* SSRC : memresults = {instance, node_mem 1, node_mem 2, 4 format words of arc 0, 4 format words of arc 1,
+                buffer size of arc 0, buffer size of arc 1} */
+            if (preset == RESAMPLER_PRESET_SSRC)
+            {   uint32_t format[8];
+                uint8_t i;
+
+                for (i = 0; i < 8; i++) { format[i] = (uint32_t)memresults[3 + i]; }
+                pinstance->coef.q = (int32_t *)(memresults[1]);
+                pinstance->delay = (void *)(memresults[2]);
+                if (0 == sigp_stream_resampler_init(pinstance, &(format[0]), &(format[4]), (uint32_t)memresults[3 + 8]))
+                {   pinstance->disabled = 1;
+                    *status = NODE_TASKS_ERROR;
+                }
+            }
             break;
         }    
 
@@ -111,10 +140,21 @@ void sigp_stream_resampler (unsigned int command, void *instance, void *data, un
             
             sigp_stream_resampler_instance *pinstance = (sigp_stream_resampler_instance *) instance;
 
-            /* copy the parameters from preset or from the graph */
-            if (RD(command, PRESET_CMD) == 0)
-            { 
-            //sigp_stream_resampler_process ()
+            /* drift compensation selected with the TAG */
+            pinstance->drift = (uint8_t)RD(command, NODE_TAG_CMD);
+            switch (pinstance->drift)
+            {
+            case RESAMPLER_DRIFT_PLUS_100PPM:
+                pinstance->step = pinstance->step_nominal + pinstance->step_nominal / 10000u; break;
+            case RESAMPLER_DRIFT_MINUS_100PPM:
+                pinstance->step = pinstance->step_nominal - pinstance->step_nominal / 10000u; break;
+            case RESAMPLER_DRIFT_FILL:                  /* new pre-roll */
+                stream_fill_control_reset(&(pinstance->fill), pinstance->fill.fill_target, pinstance->fill.fill_max, 
+                    pinstance->fill.range, 0, 0);
+                pinstance->step = pinstance->step_nominal; break;
+            default:
+                pinstance->drift = RESAMPLER_DRIFT_OFF;
+                pinstance->step = pinstance->step_nominal; break;
             }
             break;
         }
@@ -126,12 +166,16 @@ void sigp_stream_resampler (unsigned int command, void *instance, void *data, un
         case STREAM_RUN:   
         {
             sigp_stream_resampler_instance *pinstance = (sigp_stream_resampler_instance *) instance;
-            //intptr_t nb_data, stream_xdmbuffer_size, bufferout_free;
-            //stream_xdmbuffer_t *pt_pt;
+            stream_xdmbuffer_t *pt_pt = (stream_xdmbuffer_t *)data;
 
-            //pt_pt = data;
-            //router_processing (pinstance, pt_pt);
-            //break;
+            if (pinstance->disabled)
+            {   pt_pt[0].size = 0;                      /* nothing consumed, nothing produced */
+                pt_pt[1].size = 0;
+            }
+            else if (pinstance->preset == RESAMPLER_PRESET_SSRC)
+            {   sigp_stream_resampler_process (pinstance, pt_pt);
+            }
+            break;
         }
 
         default :
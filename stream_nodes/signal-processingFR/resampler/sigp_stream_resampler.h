@@ -35,6 +35,53 @@
 
 
 
+#define RESAMPLER_PRESET_CONVERSION 0       /* raw data conversion */
+#define RESAMPLER_PRESET_SSRC       1       /* synchronous rate converter L/M */
+#define RESAMPLER_PRESET_ASRC       2       /* time-stamps to synchronous FS */
+
+/*
+    SSRC : polyphase FIR interpolation by L and decimation by M (L, M <= 6) of the rates given
+    by the formats of the two arcs. The prototype is a Kaiser-windowed sinc designed at reset
+    at the rate Fs_in x L x RESAMPLER_SUBPHASES, with a cut-off at the Nyquist of the lower rate.
+    Only half of the branches are stored (branch Q-q is branch q time-reversed), branches 0 and
+    Q/2 are symmetric and folded, zero coefficients are skipped (branch 0 of the interpolators
+    is a single tap, every other coefficient of the half-band decimator is null).
+    The sub-phases are used by the drift compensation : the output is interpolated between two
+    adjacent sub-phases when the step is not the nominal one.
+    The reset returns NODE_TASKS_ERROR and the node is disabled when L or M is above 6 (44.1kHz
+    to 48kHz for example), or when the design needs floating-point (L/M different from 1, FP32
+    arcs) and STREAM_FLOAT_ALLOWED is 0. Unknown or equal rates are copied with L = M = 1.
+*/
+#define RESAMPLER_MAX_LM            6       /* ratios 1:6 .. 6:1 */
+#define RESAMPLER_SUBPHASES         8       /* sub-phases per phase, for the drift compensation */
+#define RESAMPLER_TAPS              16      /* taps per branch at the higher of the two rates */
+#define RESAMPLER_MAX_TAPS          96      /* taps per branch : RESAMPLER_TAPS x RESAMPLER_MAX_LM */
+#define RESAMPLER_MAX_PHASES        (RESAMPLER_MAX_LM * RESAMPLER_SUBPHASES)
+#define RESAMPLER_MAX_COEFS         512     /* node_mem 1 : 2kB */
+#define RESAMPLER_BLOCK             32      /* frames appended to the delay-line before a move */
+#define RESAMPLER_DELAY_FRAMES      (RESAMPLER_MAX_TAPS + 2 + RESAMPLER_BLOCK)
+#define RESAMPLER_MAX_NCHAN         8
+
+#define RESAMPLER_BRANCH_DIRECT     0       /* contiguous taps */
+#define RESAMPLER_BRANCH_FOLD_ODD   1       /* branch 0 : center tap + pairs of taps */
+#define RESAMPLER_BRANCH_FOLD_EVEN  2       /* branch Q/2 : pairs of taps */
+
+/* drift compensation (STREAM_SET_PARAMETER TAG) */
+#define RESAMPLER_DRIFT_OFF         0
+#define RESAMPLER_DRIFT_PLUS_100PPM 1       /* input consumed 100ppm faster */
+#define RESAMPLER_DRIFT_MINUS_100PPM 2
+#define RESAMPLER_DRIFT_FILL        3       /* step corrected from the fill level of the input arc */
+
+#define RESAMPLER_DRIFT_RANGE_SHIFT 10      /* correction limited to +/- 1/1024 (~1000ppm) */
+
+typedef struct
+{   uint16_t offset;                /* first coefficient in the table */
+    uint8_t first;                  /* DIRECT : first tap, FOLD : first pair */
+    uint8_t count;                  /* coefficients (DIRECT) or pairs (FOLD) */
+    uint8_t stride;                 /* tap increment of the pairs of FOLD_ODD (2 for the half-band) */
+    uint8_t kind;                   /* RESAMPLER_BRANCH_xx */
+} sigp_resampler_branch;
+
 /*
     converter INSTANCE :
 
@@ -43,6 +90,30 @@ typedef struct
 {
     stream_services *stream_entry;  /* calls to computing services */
     uint32_t configuration;
+
+    uint8_t preset;
+    uint8_t raw;                    /* STREAM_S16, STREAM_S32, STREAM_FP32 */
+    uint8_t nchan;
+    uint8_t L, M;                   /* Fs_out / Fs_in = L / M */
+    uint8_t drift;                  /* RESAMPLER_DRIFT_xx */
+    uint8_t disabled;               /* reset failed (ratio or arithmetics not supported) : no processing */
+    uint8_t T;                      /* taps of the branches (branch 0 : T+1) */
+    uint16_t Q;                     /* number of sub-phases L x RESAMPLER_SUBPHASES */
+    uint16_t n0;                    /* delay-line index of the newest sample used by the next output */
+    uint16_t wr;                    /* frames in the delay-line */
+    uint16_t out_frames;            /* frame size of the output arc */
+
+    uint64_t phase;                 /* sub-phase of the next output, Q32 */
+    uint64_t step_nominal;          /* M x RESAMPLER_SUBPHASES in Q32 */
+    uint64_t step;
+    stream_fill_control_t fill;     /* RESAMPLER_DRIFT_FILL : input arc fill level in frames, Q8 */
+
+    sigp_resampler_branch branch[RESAMPLER_MAX_PHASES/2 + 1];
+    union
+    {   int32_t *q;                 /* Q30 (S16 and S32) */
+        float *f;
+    } coef;                         /* node_mem 1 */
+    void *delay;                    /* node_mem 2 : int32_t (S16 << 16, S32) or float, interleaved */
 } sigp_stream_resampler_instance;
 
 
@@ -46,6 +46,516 @@
 #define FREE_MEMORY 1
 #define REGISTER_ME 2
 
+#define RESAMPLER_ONE   ((uint64_t)1 << 32)
+
+
+/*
+    Fs in Hz from FMT2 (IEEE-754), 0 when the rate is not an integer below 2^24
+*/
+static uint32_t resampler_fs (uint32_t fmt2)
+{
+    uint32_t m = (fmt2 & 0x7FFFFFu) | 0x800000u;
+    int32_t e = (int32_t)((fmt2 >> 23) & 0xFFu) - 150;
+
+    if (0 == (fmt2 & 0x7FFFFFFFu) || e > 0 || e < -23 || 0 != (m & ((1u << (-e)) - 1u)))
+    {   return 0;
+    }
+    return m >> (-e);
+}
+
+static uint32_t resampler_gcd (uint32_t a, uint32_t b)
+{
+    while (b != 0)
+    {   uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+
+#if STREAM_FLOAT_ALLOWED==1
+#include <math.h>
+
+#define RESAMPLER_PI    3.14159265358979f
+#define RESAMPLER_BETA  7.0f                /* Kaiser window : ~70dB stop-band */
+
+/* modified Bessel function of order 0 */
+static float resampler_i0 (float x)
+{
+    float sum = 1.0f, term = 1.0f, k;
+
+    x = 0.25f * x * x;
+    for (k = 1.0f; k < 30.0f; k = k + 1.0f)
+    {   term = term * x / (k * k);
+        sum = sum + term;
+    }
+    return sum;
+}
+
+/*
+    tap n in [0 .. T x Q] of the prototype, the center is c = T x Q / 2 and the cut-off is
+    the Nyquist of the lower rate : h(c + k) = 0 when k x min(L,M) is a multiple of M x Q
+*/
+static float resampler_tap (const sigp_stream_resampler_instance *S, int32_t n)
+{
+    int32_t k = n - ((int32_t)S->T * S->Q) / 2;
+    int32_t minLM = MIN(S->L, S->M), MQ = S->M * S->Q;
+    float fc2, x, w;
+
+    if (k == 0)
+    {   return (float)minLM / (float)MQ;
+    }
+    if (0 == (k * minLM) % MQ)
+    {   return 0.0f;
+    }
+    fc2 = (float)minLM / (float)MQ;
+    x = RESAMPLER_PI * fc2 * (float)k;
+    w = 2.0f * (float)k / (float)(S->T * S->Q);
+    w = resampler_i0(RESAMPLER_BETA * sqrtf(MAX(0.0f, 1.0f - w * w))) / resampler_i0(RESAMPLER_BETA);
+    return fc2 * w * sinf(x) / x;
+}
+
+/*
+    Coefficients of the branches 0 .. Q/2, each branch has a unity gain at DC.
+    Returns 0 when the table is too small.
+*/
+static uint8_t resampler_design (sigp_stream_resampler_instance *S)
+{
+    uint32_t Q = S->Q, T = S->T, q, i, d, first, last, offset, ncoef;
+    float h[RESAMPLER_MAX_TAPS + 1], sum;
+
+    offset = 0;
+    for (q = 0; q <= Q / 2; q++)
+    {   sigp_resampler_branch *b = &(S->branch[q]);
+
+        if (q == 0)
+        {   /* center tap and pairs c +/- d Q, the half-band has all the even pairs null */
+            first = 0; last = 0; b->stride = 2;
+            for (d = 1; d <= T / 2; d++)
+            {   if (0.0f != resampler_tap(S, (int32_t)((T / 2 + d) * Q)))
+                {   if (first == 0) { first = d; }
+                    last = d;
+                    if (0 == (d & 1u)) { b->stride = 1; }
+                }
+            }
+            if (first == 0) { first = 1; }
+            b->kind = RESAMPLER_BRANCH_FOLD_ODD;
+            b->first = (uint8_t)first;
+            b->count = (uint8_t)((last < first) ? 0 : 1 + (last - first) / b->stride);
+            ncoef = 1u + b->count;
+            h[0] = resampler_tap(S, (int32_t)((T / 2) * Q));
+            sum = h[0];
+            for (i = 0; i < b->count; i++)
+            {   h[1 + i] = resampler_tap(S, (int32_t)((T / 2 + first + i * b->stride) * Q));
+                sum = sum + 2.0f * h[1 + i];
+            }
+        }
+        else if (2 * q == Q)
+        {   /* pairs of taps T/2-1-j and T/2+j */
+            b->kind = RESAMPLER_BRANCH_FOLD_EVEN;
+            b->stride = 1;
+            for (first = 0; first < T / 2 && 0.0f == resampler_tap(S, (int32_t)(q + Q * (T / 2 + first))); first++) {;}
+            for (last = T / 2; last > first && 0.0f == resampler_tap(S, (int32_t)(q + Q * (T / 2 + last - 1))); last--) {;}
+            b->first = (uint8_t)first;
+            b->count = (uint8_t)(last - first);
+            ncoef = b->count;
+            sum = 0.0f;
+            for (i = 0; i < ncoef; i++)
+            {   h[i] = resampler_tap(S, (int32_t)(q + Q * (T / 2 + first + i)));
+                sum = sum + 2.0f * h[i];
+            }
+        }
+        else
+        {   /* taps t = 0 .. T-1, the branch Q-q uses the same coefficients in the reverse order */
+            b->kind = RESAMPLER_BRANCH_DIRECT;
+            b->stride = 1;
+            for (first = 0; first < T && 0.0f == resampler_tap(S, (int32_t)(q + Q * first)); first++) {;}
+            for (last = T; last > first && 0.0f == resampler_tap(S, (int32_t)(q + Q * (last - 1))); last--) {;}
+            b->first = (uint8_t)first;
+            b->count = (uint8_t)(last - first);
+            ncoef = b->count;
+            sum = 0.0f;
+            for (i = 0; i < ncoef; i++)
+            {   h[i] = resampler_tap(S, (int32_t)(q + Q * (first + i)));
+                sum = sum + h[i];
+            }
+        }
+
+        if (offset + ncoef > RESAMPLER_MAX_COEFS)
+        {   return 0;
+        }
+        b->offset = (uint16_t)offset;
+        for (i = 0; i < ncoef; i++, offset++)
+        {   if (S->raw == STREAM_FP32)
+            {   S->coef.f[offset] = h[i] / sum;
+            }
+            else
+            {   float c = MIN(MAX(h[i] / sum * 1073741824.0f, -2147483648.0f), 2147483520.0f);
+                S->coef.q[offset] = (int32_t)((c >= 0.0f) ? (c + 0.5f) : (c - 0.5f));
+            }
+        }
+    }
+    return 1;
+}
+#endif
+
+
+/**
+  @brief         SSRC initialization from the formats of the input and output arcs
+  @param[in/out] S           instance, the coefficient and delay-line pointers are set
+  @param[in]     format_in   the 4 format words of arc 0 (FRAMESZ_FMT0 .. DOMAINSPECIFIC_FMT3)
+  @param[in]     format_out  the 4 format words of arc 1
+  @param[in]     bufsize_in  buffer size of arc 0 in Bytes, 0 when unknown
+  @return        0 when the ratio or the arithmetics is not supported
+ */
+uint8_t sigp_stream_resampler_init (sigp_stream_resampler_instance *S, uint32_t *format_in, uint32_t *format_out, uint32_t bufsize_in)
+{
+    uint32_t fs_in, fs_out, g, i, frame_bytes, in_frames;
+    int32_t target, fill_max;
+
+    S->raw = (uint8_t)RD(format_in[NCHANDOMAIN_FMT1], RAW_FMT1);
+    S->nchan = (uint8_t)MIN(1 + RD(format_in[NCHANDOMAIN_FMT1], NCHANM1_FMT1), RESAMPLER_MAX_NCHAN);
+    frame_bytes = S->nchan * ((S->raw == STREAM_S16) ? sizeof(int16_t) : sizeof(int32_t));
+    S->out_frames = (uint16_t)(RD(format_out[FRAMESZ_FMT0], FRAMESIZE_FMT0) / frame_bytes);
+
+    /* L/M from the sampling rates, unknown rates are converted with L = M = 1 */
+    fs_in = resampler_fs(format_in[SAMPLINGRATE_FMT2]);
+    fs_out = resampler_fs(format_out[SAMPLINGRATE_FMT2]);
+    S->L = S->M = 1;
+    if (fs_in != 0 && fs_out != 0)
+    {   g = resampler_gcd(fs_in, fs_out);
+        if (fs_out / g > RESAMPLER_MAX_LM || fs_in / g > RESAMPLER_MAX_LM)
+        {   return 0;
+        }
+        S->L = (uint8_t)(fs_out / g);
+        S->M = (uint8_t)(fs_in / g);
+    }
+
+    /* RESAMPLER_TAPS at the higher rate, even number of taps */
+    S->Q = (uint16_t)(S->L * RESAMPLER_SUBPHASES);
+    S->T = (uint8_t)MIN(RESAMPLER_MAX_TAPS, 2 * ((RESAMPLER_TAPS * MAX(S->L, S->M) + 2 * S->L - 1) / (2 * S->L)));
+
+    S->step_nominal = (uint64_t)(S->M * RESAMPLER_SUBPHASES) << 32;
+    S->step = S->step_nominal;
+    S->phase = 0;
+    S->n0 = S->T;                           /* the delay-line starts with T+1 null frames */
+    S->wr = (uint16_t)(S->T + 1);
+    for (i = 0; i < (uint32_t)(S->wr * S->nchan); i++) { ((int32_t *)(S->delay))[i] = 0; }
+
+    /* the input consumed by one output frame + two input frames of margin, in Q8, limited to 
+        the capacity of the arc minus one frame (see stream_common_fill_control.c) */
+    in_frames = RD(format_in[FRAMESZ_FMT0], FRAMESIZE_FMT0) / frame_bytes;
+    target = (int32_t)(in_frames << 9) + (int32_t)(((uint32_t)S->out_frames * S->M << 8) / S->L);
+    fill_max = 0;
+    if (bufsize_in / frame_bytes > in_frames)
+    {   fill_max = (int32_t)((bufsize_in / frame_bytes - in_frames) << 8);
+    }
+    stream_fill_control_reset(&(S->fill), target, fill_max, (int64_t)(RESAMPLER_ONE >> RESAMPLER_DRIFT_RANGE_SHIFT), 0, 0);
+
+#if STREAM_FLOAT_ALLOWED==1
+    return resampler_design(S);
+#else
+    /* no floating-point : equal rates are copied with a single tap */
+    if (S->L != 1 || S->M != 1 || S->raw == STREAM_FP32)
+    {   return 0;
+    }
+    S->Q = 1;
+    S->T = 0;
+    S->n0 = 0;
+    S->wr = 1;
+    S->step_nominal = S->step = RESAMPLER_ONE;
+    S->branch[0].kind = RESAMPLER_BRANCH_FOLD_ODD;
+    S->branch[0].offset = 0;
+    S->branch[0].count = 0;
+    S->coef.q[0] = 0x40000000;
+    return 1;
+#endif
+}
+
+
+/*
+    Branch q at the delay-line position x (x[0] = newest sample, x[-nchan] = previous one),
+    the branches above Q/2 are the time-reversed branches Q-q.
+*/
+static int32_t resampler_branch_q31 (const sigp_stream_resampler_instance *S, const int32_t *x, uint32_t q)
+{
+    const sigp_resampler_branch *b;
+    const int32_t *c, *hi, *lo;
+    int32_t nch = S->nchan, s;
+    int64_t acc = 0;
+    uint32_t i, T = S->T, mirror = (q > S->Q / 2u);
+
+    b = &(S->branch[mirror ? S->Q - q : q]);
+    c = &(S->coef.q[b->offset]);
+
+    switch (b->kind)
+    {
+    case RESAMPLER_BRANCH_FOLD_ODD:
+        lo = x - (int32_t)(T / 2) * nch;
+        acc = (int64_t)c[0] * lo[0];
+        hi = lo + (int32_t)b->first * nch;
+        lo = lo - (int32_t)b->first * nch;
+        s = b->stride * nch;
+        for (i = 0; i < b->count; i++)
+        {   acc += (int64_t)c[1 + i] * ((int64_t)hi[0] + lo[0]);
+            hi += s;
+            lo -= s;
+        }
+        break;
+    case RESAMPLER_BRANCH_FOLD_EVEN:
+        hi = x - (int32_t)(T / 2 - 1 - b->first) * nch;
+        lo = x - (int32_t)(T / 2 + b->first) * nch;
+        for (i = 0; i < b->count; i++)
+        {   acc += (int64_t)c[i] * ((int64_t)hi[0] + lo[0]);
+            hi += nch;
+            lo -= nch;
+        }
+        break;
+    default:
+        if (mirror)
+        {   hi = x - (int32_t)(T - 1 - b->first) * nch;
+            s = nch;
+        }
+        else
+        {   hi = x - (int32_t)b->first * nch;
+            s = -nch;
+        }
+        for (i = 0; i < b->count; i++)
+        {   acc += (int64_t)c[i] * hi[0];
+            hi += s;
+        }
+        break;
+    }
+    acc = acc >> 30;
+    return (int32_t)MIN(MAX(acc, -0x7FFFFFFFLL - 1), 0x7FFFFFFFLL);
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static float resampler_branch_f32 (const sigp_stream_resampler_instance *S, const float *x, uint32_t q)
+{
+    const sigp_resampler_branch *b;
+    const float *c, *hi, *lo;
+    int32_t nch = S->nchan, s;
+    float acc = 0.0f;
+    uint32_t i, T = S->T, mirror = (q > S->Q / 2u);
+
+    b = &(S->branch[mirror ? S->Q - q : q]);
+    c = &(S->coef.f[b->offset]);
+
+    switch (b->kind)
+    {
+    case RESAMPLER_BRANCH_FOLD_ODD:
+        lo = x - (int32_t)(T / 2) * nch;
+        acc = c[0] * lo[0];
+        hi = lo + (int32_t)b->first * nch;
+        lo = lo - (int32_t)b->first * nch;
+        s = b->stride * nch;
+        for (i = 0; i < b->count; i++)
+        {   acc += c[1 + i] * (hi[0] + lo[0]);
+            hi += s;
+            lo -= s;
+        }
+        break;
+    case RESAMPLER_BRANCH_FOLD_EVEN:
+        hi = x - (int32_t)(T / 2 - 1 - b->first) * nch;
+        lo = x - (int32_t)(T / 2 + b->first) * nch;
+        for (i = 0; i < b->count; i++)
+        {   acc += c[i] * (hi[0] + lo[0]);
+            hi += nch;
+            lo -= nch;
+        }
+        break;
+    default:
+        if (mirror)
+        {   hi = x - (int32_t)(T - 1 - b->first) * nch;
+            s = nch;
+        }
+        else
+        {   hi = x - (int32_t)b->first * nch;
+            s = -nch;
+        }
+        for (i = 0; i < b->count; i++)
+        {   acc += c[i] * hi[0];
+            hi += s;
+        }
+        break;
+    }
+    return acc;
+}
+#endif
+
+
+/*
+    Delay-line : x[n0 - T] .. x[n0 + 1] are used by the next output. The input frames needed
+    by the nout next outputs are appended, the T+1 older frames are moved to the beginning
+    when the end of the buffer is reached. Returns the number of frames appended.
+*/
+static uint32_t resampler_append (sigp_stream_resampler_instance *S, const uint8_t *in, uint32_t nin, uint32_t *iin, uint32_t nout)
+{
+    uint32_t nch = S->nchan, shift, need, i;
+    int32_t *d = (int32_t *)(S->delay);     /* int32_t and float have the same size */
+    uint64_t last = S->phase + (uint64_t)(nout - 1) * S->step;
+
+    need = S->n0 + 2u + (uint32_t)((last >> 32) / S->Q);
+    need = (need > S->wr) ? need - S->wr : 0;
+    if (S->wr + need > RESAMPLER_DELAY_FRAMES)
+    {   shift = S->n0 - S->T;
+        for (i = 0; i < (S->wr - shift) * nch; i++) { d[i] = d[i + shift * nch]; }
+        S->n0 = (uint16_t)(S->n0 - shift);
+        S->wr = (uint16_t)(S->wr - shift);
+    }
+    need = MIN(MIN(need, (uint32_t)(RESAMPLER_DELAY_FRAMES - S->wr)), nin - *iin);
+
+    d = d + S->wr * nch;
+    if (S->raw == STREAM_S16)
+    {   const int16_t *x = (const int16_t *)in + (*iin) * nch;
+        for (i = 0; i < need * nch; i++) { d[i] = (int32_t)((uint32_t)x[i] << 16); }
+    }
+    else
+    {   const int32_t *x = (const int32_t *)in + (*iin) * nch;
+        for (i = 0; i < need * nch; i++) { d[i] = x[i]; }
+    }
+    S->wr = (uint16_t)(S->wr + need);
+    *iin += need;
+    return need;
+}
+
+static void resampler_advance (sigp_stream_resampler_instance *S)
+{
+    uint64_t end = (uint64_t)S->Q << 32;
+
+    S->phase += S->step;
+    while (S->phase >= end)
+    {   S->phase -= end;
+        S->n0++;
+    }
+}
+
+
+/*
+    Interpolation loops : stop when the output is full or the input is empty, 
+    a fractional sub-phase (drift compensation) interpolates the two adjacent sub-phases.
+    Returns the frames produced.
+*/
+static uint32_t resampler_q31 (sigp_stream_resampler_instance *S, const uint8_t *in, uint32_t nin, uint32_t *consumed, uint8_t *out, uint32_t nout)
+{
+    uint32_t nch = S->nchan, ch, iin = 0, iout = 0, q, frac;
+    int32_t *out32 = (int32_t *)out;
+    int16_t *out16 = (int16_t *)out;
+
+    while (iout < nout)
+    {   if (0 == resampler_append(S, in, nin, &iin, nout - iout) && S->n0 + 2u > S->wr)
+        {   break;
+        }
+        for ( ; iout < nout && S->n0 + 2u <= S->wr; iout++)
+        {   q = (uint32_t)(S->phase >> 32);
+            frac = (uint32_t)(S->phase);
+
+            for (ch = 0; ch < nch; ch++)
+            {   const int32_t *x = (const int32_t *)(S->delay) + S->n0 * nch + ch;
+                int32_t y = resampler_branch_q31(S, x, q);
+
+                if (frac != 0)
+                {   int32_t y1 = (q + 1 < S->Q) ? resampler_branch_q31(S, x, q + 1) : resampler_branch_q31(S, x + nch, 0);
+                    y = (int32_t)(y + ((((int64_t)y1 - y) * (frac >> 1)) >> 31));
+                }
+                if (S->raw == STREAM_S16)
+                {   *out16++ = (int16_t)((MIN(y, 0x7FFF7FFF) + 0x8000) >> 16);
+                }
+                else
+                {   *out32++ = y;
+                }
+            }
+            resampler_advance(S);
+        }
+    }
+    *consumed = iin;
+    return iout;
+}
+
+#if STREAM_FLOAT_ALLOWED==1
+static uint32_t resampler_f32 (sigp_stream_resampler_instance *S, const uint8_t *in, uint32_t nin, uint32_t *consumed, float *out, uint32_t nout)
+{
+    uint32_t nch = S->nchan, ch, iin = 0, iout = 0, q, frac;
+
+    while (iout < nout)
+    {   if (0 == resampler_append(S, in, nin, &iin, nout - iout) && S->n0 + 2u > S->wr)
+        {   break;
+        }
+        for ( ; iout < nout && S->n0 + 2u <= S->wr; iout++)
+        {   q = (uint32_t)(S->phase >> 32);
+            frac = (uint32_t)(S->phase);
+
+            for (ch = 0; ch < nch; ch++)
+            {   const float *x = (const float *)(S->delay) + S->n0 * nch + ch;
+                float y = resampler_branch_f32(S, x, q);
+
+                if (frac != 0)
+                {   float y1 = (q + 1 < S->Q) ? resampler_branch_f32(S, x, q + 1) : resampler_branch_f32(S, x + nch, 0);
+                    y = y + (y1 - y) * ((float)frac * (1.0f / 4294967296.0f));
+                }
+                *out++ = y;
+            }
+            resampler_advance(S);
+        }
+    }
+    *consumed = iin;
+    return iout;
+}
+#endif
+
+
+/**
+  @brief         SSRC processing of arc 0 to arc 1
+  @param[in]     S           instance
+  @param[in/out] in_out      XDM buffers of arc 0 (data available) and arc 1 (free space)
+                             updated with the amount of data consumed and produced
+  @return        none
+ */
+void sigp_stream_resampler_process (sigp_stream_resampler_instance *S, stream_xdmbuffer_t *in_out)
+{
+    uint32_t frame_bytes = S->nchan * ((S->raw == STREAM_S16) ? sizeof(int16_t) : sizeof(int32_t));
+    uint32_t nin = (uint32_t)(in_out[0].size) / frame_bytes;
+    uint32_t nout = (uint32_t)(in_out[1].size) / frame_bytes;
+    uint32_t consumed = 0, produced = 0;
+    int64_t corr;
+
+    if (S->drift == RESAMPLER_DRIFT_FILL)
+    {   if (S->out_frames != 0)
+        {   nout = MIN(nout, S->out_frames);
+        }
+        /* step corrected from the fill level of the input arc, see stream_common_fill_control.c */
+        if (0 == stream_fill_control(&(S->fill), nin, &corr))
+        {   uint8_t *pt8 = (uint8_t *)(in_out[1].address);
+            uint32_t i;
+
+            for (i = 0; i < nout * frame_bytes; i++) { pt8[i] = 0; }  /* pre-roll : silence */
+            in_out[0].size = 0;
+            in_out[1].size = nout * frame_bytes;
+            return;
+        }
+        S->step = (uint64_t)((int64_t)S->step_nominal + corr * (int64_t)(S->step_nominal >> 32));
+    }
+
+    switch (S->raw)
+    {
+    case STREAM_S16:
+    case STREAM_S32:
+        produced = resampler_q31(S, (const uint8_t *)(in_out[0].address), nin, &consumed, (uint8_t *)(in_out[1].address), nout);
+        break;
+#if STREAM_FLOAT_ALLOWED==1
+    case STREAM_FP32:
+        produced = resampler_f32(S, (const uint8_t *)(in_out[0].address), nin, &consumed, (float *)(in_out[1].address), nout);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    in_out[0].size = consumed * frame_bytes;    /* amount of data consumed */
+    in_out[1].size = produced * frame_bytes;    /* amount of data produced */
+}
 
 
 #ifdef __cplusplus
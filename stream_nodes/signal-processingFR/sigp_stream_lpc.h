@@ -0,0 +1,77 @@
+/* ----------------------------------------------------------------------
+ * Title:        sigp_stream_lpc.h
+ *
+ * Description:  frame format of the lossless LPC encoder and decoder
+ *
+ * $Date:        15 February 2024
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2013-2024 signal-processing.fr. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ */
+
+#ifndef cSIGP_STREAM_LPC_H
+#define cSIGP_STREAM_LPC_H
+
+
+/*
+    Frame (byte aligned) :
+        0xFF 0xF8                               sync
+        uint16 samples per channel, uint24 bytes of the frame, uint8 nchan, CRC-8 of the 8 first bytes
+        one subframe per channel, MSB first bit-stream, zero padding to the byte
+        CRC-16 of the frame (MSB first)
+
+    Subframe :
+        2 bits type
+        LPC_SUB_CONSTANT : 16 bits value
+        LPC_SUB_VERBATIM : 16 bits x samples
+        LPC_SUB_FIXED    : 3 bits order (0..4), order x 16 bits warm-up, residual
+        LPC_SUB_LPC      : 3 bits order-1 (1..8), 4 bits shift, order x LPC_COEF_BITS coefficients,
+                           order x 16 bits warm-up, residual
+    Residual :
+        4 bits partition order p, 2^p partitions of samples/2^p residuals (minus the warm-up for the first)
+        per partition : 5 bits Rice parameter k, or LPC_RICE_ESCAPE + 5 bits w and w bits signed residuals
+        Rice code of u = zigzag(e) : u>>k zeros, a one, the k LSB of u
+*/
+
+#define LPC_SYNC0               0xFF
+#define LPC_SYNC1               0xF8
+#define LPC_HEADER_BYTES        9
+#define LPC_CRC_BYTES           2
+
+#define LPC_SUB_CONSTANT        0
+#define LPC_SUB_VERBATIM        1
+#define LPC_SUB_FIXED           2
+#define LPC_SUB_LPC             3
+
+#define LPC_FIXED_MAX_ORDER     4
+#define LPC_MAX_ORDER           8
+#define LPC_COEF_BITS           12      /* quantized coefficients, signed */
+#define LPC_MAX_SHIFT           15
+#define LPC_MAX_PARTITION_ORDER 6
+#define LPC_RICE_ESCAPE         31
+
+#define LPC_MAX_NCHAN           16
+#define LPC_BLOCK               1024    /* default samples per channel and per frame */
+#define LPC_MIN_BLOCK           16
+#define LPC_MAX_BLOCK           2048    /* size of the scratch area (int32) in the TCM bank */
+
+/* worst case : verbatim subframes */
+#define LPC_MAX_FRAME_BYTES(nchan, nsamp) (LPC_HEADER_BYTES + (nchan) * (2 * (nsamp) + 1) + LPC_CRC_BYTES)
+
+#endif
@@ -44,6 +44,12 @@
 
 #define NODE_TASKS_COMPLETED 0u
 #define NODE_TASKS_NOT_COMPLETED 1u
+#define NODE_TASKS_ERROR 2u             /* reset : format or configuration not supported, the node is disabled */
+
+/* fill-level control of the asynchronous rate converters (stream_common_fill_control.c) */
+#define STREAM_FILL_AVG_SHIFT 8u        /* fill level smoothing 1/256 */
+#define STREAM_FILL_KP_SHIFT 6u         /* 1 frame of error (Q8) corrects the step by 2^-18 */
+#define STREAM_FILL_KI_SHIFT 8u         /* integral gain : 1 frame = 2^-32 per call */
 
 
 #define MAX_NB_STREAM_PER_NODE 8
@@ -903,6 +909,11 @@ enum stream_processor_sub_arch_fpu
     #define SERV_DSP_DFT_F32            10u
     #define SERV_DSP_CASCADE_DF1_Q15    3u   /* IIR filters, use SERV_CHECK_COPROCESSOR */
     #define SERV_DSP_CASCADE_DF1_F32    4u         
+    #define SERV_DSP_CASCADE_MC_Q15     11u  /* multichannel interleaved IIR filters, state per channel */
+    #define SERV_DSP_CASCADE_MC_Q31     12u
+    #define SERV_DSP_CASCADE_MC_F32     13u
+    #define SERV_DSP_CASCADE_DF2T_F32   14u  /* transposed DF2 IIR filters with denormal flushing */
+    #define SERV_DSP_CASCADE_DF2T_F64   15u  /* computer platforms */
 
             /* COMMAND_SSRV */
     #define SERV_DSP_RUN                0u   /* run = default */
@@ -920,6 +931,51 @@ enum stream_processor_sub_arch_fpu
                                    
     #define SERV_DSP_cFFT_Q15           7u   /* cFFT windowing, module, dB */
     #define SERV_DSP_cFFT_F32           8u
+    #define SERV_DSP_rFFT_Q31           16u
+    #define SERV_DSP_cFFT_Q31           17u
+
+            /* vector math, TAG_SSRV = base or option, ptr1 = src, ptr2 = dst (can be src), n = nb of results */
+    #define SERV_DSP_LOG_Q15            18u  /* Q15 -> Q4.11, TAG = GENERIC_MATH_BASE_ */
+    #define SERV_DSP_LOG_Q31            19u  /* Q31 -> Q5.26 */
+    #define SERV_DSP_LOG_F32            20u
+    #define SERV_DSP_EXP_Q15            21u  /* Q4.11 -> Q15, TAG = GENERIC_MATH_BASE_ */
+    #define SERV_DSP_EXP_Q31            22u  /* Q5.26 -> Q31 */
+    #define SERV_DSP_EXP_F32            23u
+    #define SERV_DSP_SQRT_Q15           24u
+    #define SERV_DSP_SQRT_Q31           25u
+    #define SERV_DSP_SQRT_F32           26u
+    #define SERV_DSP_RSQRT_Q15          27u  /* 1/sqrt, Q15 -> Q4.11 */
+    #define SERV_DSP_RSQRT_Q31          28u  /* Q31 -> Q5.26 */
+    #define SERV_DSP_RSQRT_F32          29u
+    #define SERV_DSP_ATAN2_Q15          30u  /* {x, y} interleaved -> Q2.13 radian */
+    #define SERV_DSP_ATAN2_Q31          31u  /* -> Q2.29 radian */
+    #define SERV_DSP_ATAN2_F32          32u
+    #define SERV_DSP_SIN_Q15            33u  /* full scale = 2 pi */
+    #define SERV_DSP_SIN_Q31            34u
+    #define SERV_DSP_SIN_F32            35u  /* radian */
+    #define SERV_DSP_COS_Q15            36u
+    #define SERV_DSP_COS_Q31            37u
+    #define SERV_DSP_COS_F32            38u
+    #define SERV_DSP_DB_Q15             39u  /* Q15 -> Q7.8, TAG = GENERIC_MATH_DB_ */
+    #define SERV_DSP_DB_Q31             40u  /* Q31 -> Q8.23 */
+    #define SERV_DSP_DB_F32             41u
+    #define SERV_DSP_MAG_Q15            42u  /* {x, y} interleaved -> Q2.14 */
+    #define SERV_DSP_MAG_Q31            43u  /* -> Q2.30 */
+    #define SERV_DSP_MAG_F32            44u
+
+            /* FFT plans : SERV_DSP_INIT returns a plan, twiddles are shared between plans of the same arithmetic */
+    #define GENERIC_FFT_Q15             0u
+    #define GENERIC_FFT_Q31             1u
+    #define GENERIC_FFT_F32             2u
+    #define GENERIC_FFT_MIN_LEN         16u
+    #define GENERIC_FFT_MAX_LEN         8192u
+
+            /* vector math : TAG_SSRV of the log, exp and dB services */
+    #define GENERIC_MATH_BASE_2         0u
+    #define GENERIC_MATH_BASE_E         1u
+    #define GENERIC_MATH_BASE_10        2u
+    #define GENERIC_MATH_DB_POWER       0u   /* 10 log10(x) */
+    #define GENERIC_MATH_DB_AMPLITUDE   1u   /* 20 log10(x) */
                                        
 
 
@@ -0,0 +1,131 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS Stream
+ * Title:        stream_common_fill_control.c
+ * Description:  fill-level control of the asynchronous rate converters
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "presets.h"
+#if defined(CODE_ARM_STREAM_ROUTER) || defined(CODE_SIGP_STREAM_RESAMPLER)
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+
+/*
+    Fill control : the number of frames waiting on the input arc when the node is called drifts
+    when the producer clock is faster or slower than Fs_in x (consumer clock / Fs_out).
+    The smoothed fill is compared to the target, the error gives the step correction with a
+    PI loop. The fill seen at each call has a slow sawtooth of one input frame (beat between
+    the two clocks) : the loop is slow (time constant ~10k calls) to keep the step jitter in
+    the range of 10ppm, an optional acquisition "gear" makes it faster after the pre-roll.
+    Used by the ASRC preset of arm_stream_router and the SSRC of sigp_stream_resampler.
+*/
+
+/**
+  @brief         fill control initialization
+  @param[out]    F           state
+  @param[in]     target      fill target in frames Q8
+  @param[in]     fill_max    arc capacity minus one frame in frames Q8, 0 when unknown
+  @param[in]     range       limit of the correction (Q32 for a step of 1)
+  @param[in]     acq_calls   number of calls with the acquisition loop after the pre-roll
+  @param[in]     acq_gear    acquisition : KP x2^gear, integral gain x4^gear, smoothing x2^gear
+  @return        none
+ */
+void stream_fill_control_reset (stream_fill_control_t *F, int32_t target, int32_t fill_max,
+                                int64_t range, uint16_t acq_calls, uint8_t acq_gear)
+{
+    F->integral = 0;
+    F->range = range;
+    F->fill_avg = 0;
+    F->fill_max = fill_max;
+    F->ncall = 0;
+    F->acq_calls = acq_calls;
+    F->acq_gear = acq_gear;
+    F->primed = 0;
+    stream_fill_control_target(F, target);
+}
+
+/**
+  @brief         new fill target, limited to the arc capacity minus one frame : the producer
+                 of the arc stops writing before a larger target is reached (no end of pre-roll)
+  @param[in/out] F           state
+  @param[in]     target      fill target in frames Q8
+  @return        none
+ */
+void stream_fill_control_target (stream_fill_control_t *F, int32_t target)
+{
+    if (F->fill_max > 0)
+    {   target = MIN(target, F->fill_max);
+    }
+    F->fill_target = MAX(target, 1 << 8);
+}
+
+/**
+  @brief         fill control, once per call of the node
+  @param[in/out] F           state
+  @param[in]     nin         number of frames on the input arc
+  @param[out]    corr        step correction in Q32 for a step of 1, within +/- range
+  @return        0 during the pre-roll
+ */
+uint8_t stream_fill_control (stream_fill_control_t *F, uint32_t nin, int64_t *corr)
+{
+    int32_t fill = (int32_t)(nin << 8);
+    int64_t err, ilim;
+    uint8_t gear;
+
+    if (F->primed == 0)
+    {   if (fill < F->fill_target)
+        {   return 0;
+        }
+        F->primed = 1;
+        F->fill_avg = fill;
+    }
+
+    /* faster loop during the acquisition, the integral is shared by the two gears */
+    gear = 0;
+    if (F->ncall < F->acq_calls)
+    {   F->ncall++;
+        gear = F->acq_gear;
+    }
+
+    F->fill_avg += (fill - F->fill_avg) >> (STREAM_FILL_AVG_SHIFT - gear);
+    err = (int64_t)(F->fill_avg - F->fill_target);
+    ilim = F->range << STREAM_FILL_KI_SHIFT;
+
+    F->integral = MIN(MAX(F->integral + err * ((int64_t)1 << (2 * gear)), -ilim), ilim);
+    *corr = MIN(MAX(err * ((int64_t)1 << (STREAM_FILL_KP_SHIFT + gear)) + (F->integral >> STREAM_FILL_KI_SHIFT), -(F->range)), F->range);
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CODE_ARM_STREAM_ROUTER || CODE_SIGP_STREAM_RESAMPLER
@@ -58,6 +58,27 @@ typedef void    (stream_services)(uint32_t service_command, intptr_t ptr1, intpt
 typedef void (*p_stream_services) (uint32_t service_command, intptr_t ptr1, intptr_t ptr2, intptr_t ptr3, intptr_t n);
 
 
+/* ------------------------------------------------------------------------------------------
+    fill-level control of the asynchronous rate converters, see stream_common_fill_control.c
+*/
+typedef struct
+{   int64_t integral;                       /* integral term */
+    int64_t range;                          /* limit of the correction, Q32 for a step of 1 */
+    int32_t fill_avg;                       /* smoothed fill of the input arc, frames in Q8 */
+    int32_t fill_target;                    /* Q8 */
+    int32_t fill_max;                       /* Q8, arc capacity minus one frame, 0 = unknown */
+    uint16_t ncall;                         /* calls after the pre-roll, up to acq_calls */
+    uint16_t acq_calls;                     /* calls with the faster acquisition loop */
+    uint8_t acq_gear;
+    uint8_t primed;                         /* pre-roll done */
+} stream_fill_control_t;
+
+extern void stream_fill_control_reset (stream_fill_control_t *F, int32_t target, int32_t fill_max, 
+                                       int64_t range, uint16_t acq_calls, uint8_t acq_gear);
+extern void stream_fill_control_target (stream_fill_control_t *F, int32_t target);
+extern uint8_t stream_fill_control (stream_fill_control_t *F, uint32_t nin, int64_t *corr);
+
+
 /* ------------------------------------------------------------------------------------------
     floating-point emulation
 */
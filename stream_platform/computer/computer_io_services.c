@@ -91,7 +91,6 @@ FILE* ptf_data_in_1;
 FILE* ptf_sensor_0;
 FILE* ptf_analog_0;
 FILE* ptf_audio_in_0;
-FILE* ptf_debug_detector;
 FILE* ptf_line_out_0;
 FILE* ptf_gpio_out_0;
 FILE* ptf_gpio_out_1;
@@ -0,0 +1,42 @@
+//--------------------------------------
+//  AUTOMATICALLY GENERATED CODES
+//  DO NOT MODIFY !
+//--------------------------------------
+#include "presets.h"
+#ifdef CODE_ARM_STREAM_SCRIPT
+
+#include <stdint.h>
+#include "stream_common_const.h"
+#include "stream_common_types.h"
+#include "arm_stream_script.h"
+#include "arm_stream_script_instructions.h"
+
+#define R(n)   (I->REGS[n].v_i32[REGS_DATA])
+#define STK(k) (I->REGS[I->SP - 1 - (k)].v_i32[REGS_DATA])
+#define POP()  (I->REGS[--(I->SP)].v_i32[REGS_DATA])
+#define PUSH() (I->REGS[(I->SP)++].v_i32[REGS_DATA])
+#define CHECK_POP(n)  if (I->SP < I->nregs + (n)) { I->errors |= ERROR_STACK_UNDERFLOW; return; }
+#define CHECK_PUSH(n) if (I->SP + (n) > I->nregs + I->nstack) { I->errors |= ERROR_STACK_OVERFLOW; return; }
+#define CHECK_CYCLES  if (0 == --(I->cycles_downcounter)) { I->errors |= ERROR_TIME_UNDERFLOW; return; }
+
+static void script_native_0 (arm_script_instance_t *I)
+{
+    /*   0  18220876 */ {   int32_t s1, s2; s2 = (int32_t)0x00000003; s1 = R(2); R(1) = s1 + s2; }
+    /*   2  18043B70 */ {   int32_t s1, s2; s2 = 0; s1 = (int32_t)0xFFFFDCD8; (void)s2; R(2) = s1; }
+    /*   4  1D7C3870 */ {   if (I->SP == I->nregs) return; goto L_return; }
+    return;
+L_return:
+    switch (I->REGS[--(I->SP)].v_i32[REGS_DATA])
+    {
+    default: return;
+    }
+}
+
+const p_script_native arm_stream_script_native[] = 
+{
+    script_native_0,
+};
+
+const uint8_t arm_stream_script_nb_native = 1;
+
+#endif //CODE_ARM_STREAM_SCRIPT
@@ -23,6 +23,9 @@
 // to test the multiprocessing macro
 #define MULTIPROCESSING 1     
 
+/* debug traces of the nodes saved in memory : "_trace" node manifests in top_manifest_computer.txt */
+#define PLATFORM_NODE_TRACES 1
+
 /*
  * --- maximum number of processors using STREAM in parallel - read by the graph compiler
  */
@@ -72,6 +75,7 @@
 
 /*----- NODES ENABLED FOR "COMPUTER" ------------------------------------------------------------------------*/
 #define CODE_ARM_STREAM_SCRIPT          /* byte-code interpreter, index "arm_stream_script_INDEX" */
+#define PLATFORM_SCRIPT_NATIVE          /* link graph_computer_scripts.c : scripts translated to C by the graph compiler */
 #define CODE_ARM_STREAM_ROUTER          /* copy input arcs and subchannel and output arcs and subchannels   */     
 #define CODE_ARM_STREAM_MODULATOR       /* signal generator with modulation */
 #define CODE_ARM_FIXEDBF                /* audio fixed direction beamformer */
@@ -155,6 +159,7 @@
     //#undef PLATFORM_SERV_SERV_rFFT_F32             /* default FFT with tables rebuilded */
     //#undef PLATFORM_SERV_SERV_cFFT_Q15             /* cFFT windowing, module, dB */
     //#undef PLATFORM_SERV_SERV_cFFT_F32           
+    #define PLATFORM_FFT_ARENA_BYTES 65536          /* shared twiddle tables of the FFT plans (F32 8192 = 32kB) */
 
 //#undef SERV_GROUP_DEEPL              /* 6  cmsis-nn */
     //#undef PLATFORM_SERV_STREAM_FC                 /* fully connected layer Mat x Vec */
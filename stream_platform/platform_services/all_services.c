@@ -419,6 +419,84 @@ void arm_stream_command_interpreter (uint32_t command, intptr_t ptr1, intptr_t p
 
 
 
+/* ------------------------------------------------------------------------------------------------------------
+  @brief        FFT plan cache
+  @param[in]    arith      GENERIC_FFT_Q15/Q31/F32
+  @param[in]    fftLen     power of 2 in [GENERIC_FFT_MIN_LEN .. GENERIC_FFT_MAX_LEN]
+  @return       plan, or 0 when the length is wrong or the cache is full
+      
+  @remark       The twiddle tables are computed once in a static arena of PLATFORM_FFT_ARENA_BYTES.
+                A table of length L serves all the plans of the same arithmetic with fftLen <= L
+                (stride L/fftLen) : the nodes asking for the largest FFT first avoid building
+                intermediate tables. Plans are never freed, they are requested at node reset.
+ */
+#ifndef PLATFORM_FFT_ARENA_BYTES
+#define PLATFORM_FFT_ARENA_BYTES    16384
+#endif
+#define FFT_CACHE_NB_TABLES         6
+#define FFT_CACHE_NB_PLANS          12
+
+static struct
+{   uint32_t used;                                  /* bytes used in the arena */
+    uint8_t ntable, nplan;
+    struct {
+        uint8_t arith;
+        uint16_t len;
+        void *pTable;
+    } table[FFT_CACHE_NB_TABLES];
+    generic_fft_plan plan[FFT_CACHE_NB_PLANS];
+    uint32_t arena[PLATFORM_FFT_ARENA_BYTES / 4];
+} fft_cache;
+
+static generic_fft_plan * arm_stream_services_fft_plan (uint8_t arith, uint32_t fftLen)
+{
+    extern fft_table_init generic_fft_table_init;
+    extern fft_plan_init generic_fft_plan_init;
+    uint32_t i, bytes;
+    int32_t t;
+
+    if (fftLen < GENERIC_FFT_MIN_LEN || fftLen > GENERIC_FFT_MAX_LEN || 0 != (fftLen & (fftLen - 1u)))
+    {   return 0;
+    }
+
+    for (i = 0; i < fft_cache.nplan; i++)
+    {   if (fft_cache.plan[i].arith == arith && fft_cache.plan[i].fftLen == fftLen)
+        {   return &(fft_cache.plan[i]);
+        }
+    }
+    if (fft_cache.nplan >= FFT_CACHE_NB_PLANS)
+    {   return 0;
+    }
+
+    /* smallest table of this arithmetic serving fftLen */
+    for (t = -1, i = 0; i < fft_cache.ntable; i++)
+    {   if (fft_cache.table[i].arith == arith && fft_cache.table[i].len >= fftLen &&
+            (t < 0 || fft_cache.table[i].len < fft_cache.table[t].len))
+        {   t = (int32_t)i;
+        }
+    }
+
+    if (t < 0)
+    {   /* fftLen/2 x {cos, -sin} */
+        bytes = fftLen * ((arith == GENERIC_FFT_Q15) ? sizeof(int16_t) : sizeof(int32_t));
+        if (fft_cache.ntable >= FFT_CACHE_NB_TABLES || fft_cache.used + bytes > sizeof(fft_cache.arena))
+        {   return 0;
+        }
+        t = fft_cache.ntable++;
+        fft_cache.table[t].arith = arith;
+        fft_cache.table[t].len = (uint16_t)fftLen;
+        fft_cache.table[t].pTable = (uint8_t *)(fft_cache.arena) + fft_cache.used;
+        fft_cache.used += bytes;
+        generic_fft_table_init(fft_cache.table[t].pTable, fftLen, arith);
+    }
+
+    generic_fft_plan_init(&(fft_cache.plan[fft_cache.nplan]), (uint16_t)fftLen, arith, 
+        fft_cache.table[t].pTable, fft_cache.table[t].len);
+    return &(fft_cache.plan[fft_cache.nplan++]);
+}
+
+
+
 
 
 /* 
@@ -592,38 +670,189 @@ void arm_stream_services (uint32_t command, intptr_t ptr1, intptr_t ptr2, intptr
                 #endif
 
 
+                break;
+
+            case SERV_DSP_CASCADE_MC_Q15:           /* multichannel interleaved IIR filters, one channel per lane */
+            case SERV_DSP_CASCADE_MC_Q31:
+            case SERV_DSP_CASCADE_MC_F32:
+                if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
+                {   extern mc_init generic_biquad_cascade_mc_init;
+                    generic_biquad_cascade_mc_init(                         // void generic_biquad_cascade_mc_init(
+                        (generic_biquad_cascade_mc_inst *) ptr1,            //         generic_biquad_cascade_mc_inst * S,
+                        (uint8_t)(n >> 8),                                  //         uint8_t numStages,
+                        (uint8_t)(n >> 16),                                 //         uint8_t numChannels,
+                        (const void *) ptr2,                                //   const void * pCoeffs,
+                        (void *) ptr3,                                      //         void * pState,
+                        (int8_t)n,                                          //         int8_t postShift,
+                        (RD(command, FUNCTION_SSRV) == SERV_DSP_CASCADE_MC_Q15) ? 2u : 4u);
+
+                } else //(RD(command,  COMMAND_SSRV) == SERV_DSP_RUN)
+                {   extern mc_q15 generic_biquad_cascade_mc_q15;
+                    extern mc_q31 generic_biquad_cascade_mc_q31;
+                    extern mc_f32 generic_biquad_cascade_mc_f32;
+
+                    /* ptr1 = instance, ptr2 = interleaved input, ptr3 = interleaved output, n = nb of frames */
+                    switch (RD(command, FUNCTION_SSRV))
+                    {
+                    case SERV_DSP_CASCADE_MC_Q15:
+                        generic_biquad_cascade_mc_q15((const generic_biquad_cascade_mc_inst *)ptr1, (const int16_t *)ptr2, (int16_t *)ptr3, (uint32_t)n);
+                        break;
+                    case SERV_DSP_CASCADE_MC_Q31:
+                        generic_biquad_cascade_mc_q31((const generic_biquad_cascade_mc_inst *)ptr1, (const int32_t *)ptr2, (int32_t *)ptr3, (uint32_t)n);
+                        break;
+                    default:
+                        generic_biquad_cascade_mc_f32((const generic_biquad_cascade_mc_inst *)ptr1, (const float *)ptr2, (float *)ptr3, (uint32_t)n);
+                        break;
+                    }
+                }
+                break;
+
+            case SERV_DSP_CASCADE_DF2T_F32:         /* transposed DF2, ptr1 = instance, ptr2/ptr3 = coefs/state or src/dst */
+                if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
+                {   extern df2T_init_f32 generic_biquad_cascade_df2T_init_f32;
+                    generic_biquad_cascade_df2T_init_f32((generic_biquad_cascade_df2T_inst_f32 *)ptr1, (uint8_t)(n >> 8), (const float *)ptr2, (float *)ptr3);
+                } else
+                {   extern df2T_f32 generic_biquad_cascade_df2T_f32;
+                    generic_biquad_cascade_df2T_f32((const generic_biquad_cascade_df2T_inst_f32 *)ptr1, (const float *)ptr2, (float *)ptr3, (uint32_t)n);
+                }
+                break;
+
+            case SERV_DSP_CASCADE_DF2T_F64:
+                #ifdef PLATFORM_COMPUTER
+                if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
+                {   extern df2T_init_f64 generic_biquad_cascade_df2T_init_f64;
+                    generic_biquad_cascade_df2T_init_f64((generic_biquad_cascade_df2T_inst_f64 *)ptr1, (uint8_t)(n >> 8), (const double *)ptr2, (double *)ptr3);
+                } else
+                {   extern df2T_f64 generic_biquad_cascade_df2T_f64;
+                    generic_biquad_cascade_df2T_f64((const generic_biquad_cascade_df2T_inst_f64 *)ptr1, (const double *)ptr2, (double *)ptr3, (uint32_t)n);
+                }
+                #endif
                 break;
             /* ------------------------- */
+            case SERV_DSP_rFFT_Q15:                 /* INIT : ptr1 = &plan, n = fftLen */
+            case SERV_DSP_rFFT_Q31:                 /* RUN rFFT : ptr1 = plan, ptr2 = src, ptr3 = dst (can be src), n = ifftFlag (F32 only) */
+            case SERV_DSP_rFFT_F32:                 /* RUN cFFT : ptr1 = plan, ptr2 = in-place data, n = ifftFlag */
+            case SERV_DSP_cFFT_Q15:                 /* q15/q31 results are scaled by 1/fftLen */
+            case SERV_DSP_cFFT_Q31:
+            case SERV_DSP_cFFT_F32:
+                if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
+                {   uint8_t arith;
+                    switch (RD(command, FUNCTION_SSRV))
+                    {
+                    case SERV_DSP_rFFT_Q15: case SERV_DSP_cFFT_Q15: arith = GENERIC_FFT_Q15; break;
+                    case SERV_DSP_rFFT_Q31: case SERV_DSP_cFFT_Q31: arith = GENERIC_FFT_Q31; break;
+                    default:                                        arith = GENERIC_FFT_F32; break;
+                    }
+                    *(generic_fft_plan **)ptr1 = arm_stream_services_fft_plan(arith, (uint32_t)n);
+                } else //(RD(command,  COMMAND_SSRV) == SERV_DSP_RUN)
+                {   extern rfft_q15 generic_rfft_q15;
+                    extern rfft_q31 generic_rfft_q31;
+                    extern rfft_f32 generic_rfft_f32;
+                    extern cfft_q15 generic_cfft_q15;
+                    extern cfft_q31 generic_cfft_q31;
+                    extern cfft_f32 generic_cfft_f32;
+                    const generic_fft_plan *plan = (const generic_fft_plan *)ptr1;
+
+                    switch (RD(command, FUNCTION_SSRV))
+                    {
+                    case SERV_DSP_rFFT_Q15: generic_rfft_q15(plan, (const int16_t *)ptr2, (int16_t *)ptr3); break;
+                    case SERV_DSP_rFFT_Q31: generic_rfft_q31(plan, (const int32_t *)ptr2, (int32_t *)ptr3); break;
+                    case SERV_DSP_rFFT_F32: generic_rfft_f32(plan, (const float *)ptr2, (float *)ptr3, (uint8_t)n); break;
+                    case SERV_DSP_cFFT_Q15: generic_cfft_q15(plan, (int16_t *)ptr2, (uint8_t)n); break;
+                    case SERV_DSP_cFFT_Q31: generic_cfft_q31(plan, (int32_t *)ptr2, (uint8_t)n); break;
+                    default:
+                    case SERV_DSP_cFFT_F32: generic_cfft_f32(plan, (float *)ptr2, (uint8_t)n); break;
+                    }
+                }
+                break;
+
+            /* ------------------------- */
+            case SERV_DSP_LOG_Q15:                  /* ptr1 = src, ptr2 = dst (can be src), n = nb of results */
+            case SERV_DSP_LOG_Q31:                  /* TAG = GENERIC_MATH_BASE_ (log, exp) or GENERIC_MATH_DB_ (dB) */
+            case SERV_DSP_LOG_F32:                  /* atan2 and magnitude : src = {x, y} interleaved */
+            case SERV_DSP_EXP_Q15:
+            case SERV_DSP_EXP_Q31:
+            case SERV_DSP_EXP_F32:
+            case SERV_DSP_DB_Q15:
+            case SERV_DSP_DB_Q31:
+            case SERV_DSP_DB_F32:
+                {   extern vmath_option_q15 generic_vlog_q15, generic_vexp_q15, generic_vdb_q15;
+                    extern vmath_option_q31 generic_vlog_q31, generic_vexp_q31, generic_vdb_q31;
+                    extern vmath_option_f32 generic_vlog_f32, generic_vexp_f32, generic_vdb_f32;
+                    uint8_t option = (uint8_t)RD(command, TAG_SSRV);
+
+                    switch (RD(command, FUNCTION_SSRV))
+                    {
+                    case SERV_DSP_LOG_Q15: generic_vlog_q15((const int16_t *)ptr1, (int16_t *)ptr2, option, (uint32_t)n); break;
+                    case SERV_DSP_LOG_Q31: generic_vlog_q31((const int32_t *)ptr1, (int32_t *)ptr2, option, (uint32_t)n); break;
+                    case SERV_DSP_LOG_F32: generic_vlog_f32((const float *)ptr1, (float *)ptr2, option, (uint32_t)n); break;
+                    case SERV_DSP_EXP_Q15: generic_vexp_q15((const int16_t *)ptr1, (int16_t *)ptr2, option, (uint32_t)n); break;
+                    case SERV_DSP_EXP_Q31: generic_vexp_q31((const int32_t *)ptr1, (int32_t *)ptr2, option, (uint32_t)n); break;
+                    case SERV_DSP_EXP_F32: generic_vexp_f32((const float *)ptr1, (float *)ptr2, option, (uint32_t)n); break;
+                    case SERV_DSP_DB_Q15:  generic_vdb_q15((const int16_t *)ptr1, (int16_t *)ptr2, option, (uint32_t)n); break;
+                    case SERV_DSP_DB_Q31:  generic_vdb_q31((const int32_t *)ptr1, (int32_t *)ptr2, option, (uint32_t)n); break;
+                    default:
+                    case SERV_DSP_DB_F32:  generic_vdb_f32((const float *)ptr1, (float *)ptr2, option, (uint32_t)n); break;
+                    }
+                }
+                break;
+
+            case SERV_DSP_SQRT_Q15:
+            case SERV_DSP_SQRT_Q31:
+            case SERV_DSP_SQRT_F32:
+            case SERV_DSP_RSQRT_Q15:
+            case SERV_DSP_RSQRT_Q31:
+            case SERV_DSP_RSQRT_F32:
+            case SERV_DSP_ATAN2_Q15:
+            case SERV_DSP_ATAN2_Q31:
+            case SERV_DSP_ATAN2_F32:
+            case SERV_DSP_SIN_Q15:
+            case SERV_DSP_SIN_Q31:
+            case SERV_DSP_SIN_F32:
+            case SERV_DSP_COS_Q15:
+            case SERV_DSP_COS_Q31:
+            case SERV_DSP_COS_F32:
+            case SERV_DSP_MAG_Q15:
+            case SERV_DSP_MAG_Q31:
+            case SERV_DSP_MAG_F32:
+                {   extern vmath_q15 generic_vsqrt_q15, generic_vrsqrt_q15, generic_vatan2_q15, generic_vsin_q15, generic_vcos_q15, generic_vmag_q15;
+                    extern vmath_q31 generic_vsqrt_q31, generic_vrsqrt_q31, generic_vatan2_q31, generic_vsin_q31, generic_vcos_q31, generic_vmag_q31;
+                    extern vmath_f32 generic_vsqrt_f32, generic_vrsqrt_f32, generic_vatan2_f32, generic_vsin_f32, generic_vcos_f32, generic_vmag_f32;
+
+                    switch (RD(command, FUNCTION_SSRV))
+                    {
+                    case SERV_DSP_SQRT_Q15:  generic_vsqrt_q15((const int16_t *)ptr1, (int16_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_SQRT_Q31:  generic_vsqrt_q31((const int32_t *)ptr1, (int32_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_SQRT_F32:  generic_vsqrt_f32((const float *)ptr1, (float *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_RSQRT_Q15: generic_vrsqrt_q15((const int16_t *)ptr1, (int16_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_RSQRT_Q31: generic_vrsqrt_q31((const int32_t *)ptr1, (int32_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_RSQRT_F32: generic_vrsqrt_f32((const float *)ptr1, (float *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_ATAN2_Q15: generic_vatan2_q15((const int16_t *)ptr1, (int16_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_ATAN2_Q31: generic_vatan2_q31((const int32_t *)ptr1, (int32_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_ATAN2_F32: generic_vatan2_f32((const float *)ptr1, (float *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_SIN_Q15:   generic_vsin_q15((const int16_t *)ptr1, (int16_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_SIN_Q31:   generic_vsin_q31((const int32_t *)ptr1, (int32_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_SIN_F32:   generic_vsin_f32((const float *)ptr1, (float *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_COS_Q15:   generic_vcos_q15((const int16_t *)ptr1, (int16_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_COS_Q31:   generic_vcos_q31((const int32_t *)ptr1, (int32_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_COS_F32:   generic_vcos_f32((const float *)ptr1, (float *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_MAG_Q15:   generic_vmag_q15((const int16_t *)ptr1, (int16_t *)ptr2, (uint32_t)n); break;
+                    case SERV_DSP_MAG_Q31:   generic_vmag_q31((const int32_t *)ptr1, (int32_t *)ptr2, (uint32_t)n); break;
+                    default:
+                    case SERV_DSP_MAG_F32:   generic_vmag_f32((const float *)ptr1, (float *)ptr2, (uint32_t)n); break;
+                    }
+                }
+                break;
+
+            /* ------------------------- */
             case 0:              
                 // SERV_LOW_MEMORY_rFFT      /* inplace RFFT with sin/cos recomputed in each loop */
                 // 
-                // SERV_INIT_rFFT_Q15        /* RFFT + windowing, module, dB */
-                // SERV_rFFT_Q15
-                // SERV_INIT_rFFT_F32        
-                // SERV_rFFT_F32
-                // 
-                // SERV_INIT_cFFT_Q15        /* cFFT + windowing, module, dB */
-                // SERV_cFFT_Q15
-                // SERV_INIT_cFFT_F32             
-                // SERV_cFFT_F32
-                // 
                 // SERV_INIT_DFT_Q15         /* DFT/Goertzel + windowing, module, dB */
                 // SERV_DFT_Q15
                 // SERV_INIT_DFT_F32             
                 // SERV_DFT_F32
             /* ------------------------- */
-                // SERV_SQRT_Q15 
-                // SERV_SQRT_F32 
-                // SERV_LOG_Q15  
-                // SERV_LOG_F32  
-            /* ------------------------- */
-                // SERV_SINE_Q15 
-                // SERV_SINE_F32 
-                // SERV_COS_Q15  
-                // SERV_COS_F32  
-                // SERV_ATAN2_Q15
-                // SERV_ATAN2_F32
-            /* ------------------------- */
 
             default: 
                 break;
@@ -129,6 +129,122 @@ extern "C"
         float32_t * pDst,
         uint32_t blockSize);
 
+
+  /**
+   * @brief Instance structure for the multichannel interleaved Biquad cascade filters (q15, q31, f32).
+   */
+  typedef struct
+  {
+          void *pState;            /**< Points to the array of state samples.  The array is of length 4*numStages*numChannels. */
+    const void *pCoeffs;           /**< Points to the array of coefficients.  6*numStages (q15) or 5*numStages (q31, f32). */
+          uint8_t numStages;       /**< number of 2nd order stages in the filter.  Overall order is 2*numStages. */
+          uint8_t numChannels;     /**< number of interleaved channels. */
+          int8_t postShift;        /**< Additional shift, in bits, applied to each output sample (q15, q31). */
+  } generic_biquad_cascade_mc_inst;
+
+
+  /**
+   * @brief  Initialization function for the multichannel Biquad cascade filters.
+   * @param[in,out] S            points to an instance of the multichannel Biquad cascade structure.
+   * @param[in]     numStages    number of 2nd order stages in the filter.
+   * @param[in]     numChannels  number of interleaved channels.
+   * @param[in]     pCoeffs      points to the filter coefficients.
+   * @param[in]     pState       points to the state buffer.
+   * @param[in]     postShift    Shift to be applied to the output (q15, q31).
+   * @param[in]     sampleSize   size in bytes of one state sample.
+   */
+  void generic_biquad_cascade_mc_init(
+        generic_biquad_cascade_mc_inst * S,
+        uint8_t numStages,
+        uint8_t numChannels,
+  const void * pCoeffs,
+        void * pState,
+        int8_t postShift,
+        uint8_t sampleSize);
+
+  /**
+   * @brief Processing functions for the multichannel interleaved Biquad cascade filters.
+   * @param[in]  S          points to an instance of the multichannel Biquad cascade structure.
+   * @param[in]  pSrc       points to the block of interleaved input data.
+   * @param[out] pDst       points to the block of interleaved output data.
+   * @param[in]  blockSize  number of samples per channel to process.
+   */
+  void generic_biquad_cascade_mc_q15(
+  const generic_biquad_cascade_mc_inst * S,
+  const q15_t * pSrc,
+        q15_t * pDst,
+        uint32_t blockSize);
+
+  void generic_biquad_cascade_mc_q31(
+  const generic_biquad_cascade_mc_inst * S,
+  const q31_t * pSrc,
+        q31_t * pDst,
+        uint32_t blockSize);
+
+  void generic_biquad_cascade_mc_f32(
+  const generic_biquad_cascade_mc_inst * S,
+  const float32_t * pSrc,
+        float32_t * pDst,
+        uint32_t blockSize);
+
+  /**
+   * @brief Instance structure for the floating-point transposed direct form II Biquad cascade filter.
+   */
+  typedef struct
+  {
+          uint8_t numStages;       /**< number of 2nd order stages in the filter.  Overall order is 2*numStages. */
+          float32_t *pState;       /**< points to the array of state coefficients.  The array is of length 2*numStages. */
+    const float32_t *pCoeffs;      /**< points to the array of coefficients.  The array is of length 5*numStages. */
+  } generic_biquad_cascade_df2T_inst_f32;
+
+  /**
+   * @brief Instance structure for the double precision transposed direct form II Biquad cascade filter.
+   */
+  typedef struct
+  {
+          uint8_t numStages;       /**< number of 2nd order stages in the filter.  Overall order is 2*numStages. */
+          float64_t *pState;       /**< points to the array of state coefficients.  The array is of length 2*numStages. */
+    const float64_t *pCoeffs;      /**< points to the array of coefficients.  The array is of length 5*numStages. */
+  } generic_biquad_cascade_df2T_inst_f64;
+
+  /**
+   * @brief  Initialization function for the floating-point transposed direct form II Biquad cascade filter.
+   * @param[in,out] S          points to an instance of the filter data structure.
+   * @param[in]     numStages  number of 2nd order stages in the filter.
+   * @param[in]     pCoeffs    points to the filter coefficients.
+   * @param[in]     pState     points to the state buffer.
+   */
+  void generic_biquad_cascade_df2T_init_f32(
+        generic_biquad_cascade_df2T_inst_f32 * S,
+        uint8_t numStages,
+  const float32_t * pCoeffs,
+        float32_t * pState);
+
+  /**
+   * @brief Processing function for the floating-point transposed direct form II Biquad cascade filter.
+   * @param[in]  S          points to an instance of the filter data structure.
+   * @param[in]  pSrc       points to the block of input data.
+   * @param[out] pDst       points to the block of output data.
+   * @param[in]  blockSize  number of samples to process.
+   */
+  void generic_biquad_cascade_df2T_f32(
+  const generic_biquad_cascade_df2T_inst_f32 * S,
+  const float32_t * pSrc,
+        float32_t * pDst,
+        uint32_t blockSize);
+
+  void generic_biquad_cascade_df2T_init_f64(
+        generic_biquad_cascade_df2T_inst_f64 * S,
+        uint8_t numStages,
+  const float64_t * pCoeffs,
+        float64_t * pState);
+
+  void generic_biquad_cascade_df2T_f64(
+  const generic_biquad_cascade_df2T_inst_f64 * S,
+  const float64_t * pSrc,
+        float64_t * pDst,
+        uint32_t blockSize);
+
 #ifdef   __cplusplus
 }
 #endif
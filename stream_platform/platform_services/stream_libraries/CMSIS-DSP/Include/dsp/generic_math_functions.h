@@ -0,0 +1,101 @@
+/******************************************************************************
+ * @file     generic_math_functions.h
+ * @brief    Public header file for the vector math services of the DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ * Target Processor: Cortex-M and Cortex-A cores
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2020 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _GENERIC_MATH_FUNCTIONS_H_
+#define _GENERIC_MATH_FUNCTIONS_H_
+
+#include "../arm_math_types.h"
+#include "stream_common_const.h"     /* GENERIC_MATH_BASE_xx, GENERIC_MATH_DB_xx */
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+  /*
+   * Formats and maximum errors (measured on all the q15 inputs and on 2.10^6 q31 / f32 inputs) :
+   *
+   *                 q15                          q31                           f32
+   * log   Q15 -> Q4.11  0.8 LSB           Q31 -> Q5.26  0.9 LSB           1.2 ulp (2.3 ulp base 10)
+   * exp   Q4.11 -> Q15  0.6 LSB           Q5.26 -> Q31  1.2 LSB           2 ulp
+   * sqrt  Q15 -> Q15    0.5 LSB           Q31 -> Q31    1.3 LSB           sqrtf()
+   * rsqrt Q15 -> Q4.11  0.5 LSB           Q31 -> Q5.26  2 LSB             3 ulp
+   * sin   turns -> Q15  1.2 LSB           turns -> Q31  2 LSB             9e-8 (|x| < 8192)
+   * cos   turns -> Q15  1.2 LSB           turns -> Q31  2 LSB             9e-8 (|x| < 8192)
+   * atan2 -> Q2.13 rad  1.1 LSB           -> Q2.29 rad  1.2 LSB           2.6e-7 radian
+   * dB    Q15 -> Q7.8   0.9 LSB           Q31 -> Q8.23  0.9 LSB           3.8 ulp
+   * mag   -> Q2.14      0.5 LSB           -> Q2.30      1.2 LSB           sqrtf()
+   *
+   * The f32 log and dB errors are absolute (1.4e-7 and 2.4e-7) when the result is below 1.
+   * "turns" : the full scale is 2 pi, the phase wraps. The results saturate : x <= 0 gives the
+   * most negative log and dB (log(FLT_MIN) in f32), a sqrt of 0 and the largest 1/sqrt (3.4e38
+   * in f32), exp of a large input gives the largest q15/q31 value and +inf in f32.
+   */
+
+  void generic_vlog_q15(const q15_t *pSrc, q15_t *pDst, uint8_t base, uint32_t blockSize);
+  void generic_vlog_q31(const q31_t *pSrc, q31_t *pDst, uint8_t base, uint32_t blockSize);
+  void generic_vlog_f32(const float32_t *pSrc, float32_t *pDst, uint8_t base, uint32_t blockSize);
+
+  void generic_vexp_q15(const q15_t *pSrc, q15_t *pDst, uint8_t base, uint32_t blockSize);
+  void generic_vexp_q31(const q31_t *pSrc, q31_t *pDst, uint8_t base, uint32_t blockSize);
+  void generic_vexp_f32(const float32_t *pSrc, float32_t *pDst, uint8_t base, uint32_t blockSize);
+
+  void generic_vsqrt_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+  void generic_vsqrt_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+  void generic_vsqrt_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+  void generic_vrsqrt_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+  void generic_vrsqrt_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+  void generic_vrsqrt_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+  void generic_vsin_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+  void generic_vsin_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+  void generic_vsin_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+  void generic_vcos_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+  void generic_vcos_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+  void generic_vcos_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+  /**
+   * @brief  atan2 and magnitude read {x, y} interleaved and write one result per pair.
+   */
+  void generic_vatan2_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+  void generic_vatan2_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+  void generic_vatan2_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+  void generic_vdb_q15(const q15_t *pSrc, q15_t *pDst, uint8_t option, uint32_t blockSize);
+  void generic_vdb_q31(const q31_t *pSrc, q31_t *pDst, uint8_t option, uint32_t blockSize);
+  void generic_vdb_f32(const float32_t *pSrc, float32_t *pDst, uint8_t option, uint32_t blockSize);
+
+  void generic_vmag_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+  void generic_vmag_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+  void generic_vmag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* ifndef _GENERIC_MATH_FUNCTIONS_H_ */
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * @file     generic_transform_functions.h
+ * @brief    Public header file for the FFT services of the DSP Library
+ * @version  V1.10.0
+ * @date     08 July 2021
+ * Target Processor: Cortex-M and Cortex-A cores
+ ******************************************************************************/
+/*
+ * Copyright (c) 2010-2020 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _GENERIC_TRANSFORM_FUNCTIONS_H_
+#define _GENERIC_TRANSFORM_FUNCTIONS_H_
+
+#include "../arm_math_types.h"
+#include "stream_common_const.h"     /* GENERIC_FFT_xx */
+
+#ifdef   __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * @brief Plan of the complex and real FFT (q15, q31, f32).
+   *        The twiddle table built for tableLen serves all the power-of-2 sizes up to tableLen.
+   */
+  typedef struct
+  {
+          uint16_t fftLen;         /**< number of complex samples (cFFT) or real samples (rFFT). */
+          uint16_t stride;         /**< twiddle stride = tableLen / fftLen. */
+          uint8_t arith;           /**< GENERIC_FFT_Q15, _Q31, _F32. */
+    const void *pTwiddle;          /**< {cos(2pi k/tableLen), -sin(2pi k/tableLen)} k = 0 .. tableLen/2-1. */
+  } generic_fft_plan;
+
+
+  /**
+   * @brief  Size in bytes of a twiddle table.
+   * @param[in]  tableLen   largest FFT size served by the table.
+   * @param[in]  arith      GENERIC_FFT_Q15, _Q31, _F32.
+   */
+  uint32_t generic_fft_table_bytes(uint32_t tableLen, uint8_t arith);
+
+  /**
+   * @brief  Computation of a twiddle table.
+   * @param[out] pTable     table of generic_fft_table_bytes() bytes.
+   * @param[in]  tableLen   largest FFT size served by the table.
+   * @param[in]  arith      GENERIC_FFT_Q15, _Q31, _F32.
+   */
+  void generic_fft_table_init(void *pTable, uint32_t tableLen, uint8_t arith);
+
+  /**
+   * @brief  Initialization of a plan using an existing twiddle table.
+   * @param[out] S          plan.
+   * @param[in]  fftLen     FFT size (power of 2, <= tableLen).
+   * @param[in]  arith      GENERIC_FFT_Q15, _Q31, _F32.
+   * @param[in]  pTable     twiddle table.
+   * @param[in]  tableLen   size of the twiddle table.
+   */
+  void generic_fft_plan_init(generic_fft_plan *S, uint16_t fftLen, uint8_t arith, const void *pTable, uint32_t tableLen);
+
+  /**
+   * @brief In-place complex FFT of fftLen interleaved {re, im} samples.
+   * @param[in]     S         plan.
+   * @param[in,out] p         data.
+   * @param[in]     ifftFlag  0 = forward, 1 = inverse.
+   *                          f32 : the inverse is scaled by 1/fftLen,
+   *                          q15/q31 : forward and inverse are scaled by 1/fftLen.
+   */
+  void generic_cfft_f32(const generic_fft_plan *S, float32_t *p, uint8_t ifftFlag);
+  void generic_cfft_q31(const generic_fft_plan *S, q31_t *p, uint8_t ifftFlag);
+  void generic_cfft_q15(const generic_fft_plan *S, q15_t *p, uint8_t ifftFlag);
+
+  /**
+   * @brief Real FFT of fftLen samples.
+   * @param[in]     S         plan.
+   * @param[in]     pSrc      forward : fftLen real samples, inverse : packed spectrum.
+   * @param[out]    pDst      forward : packed spectrum {X0, X(N/2), re X1, im X1, .. re X(N/2-1), im X(N/2-1)},
+   *                          inverse : fftLen real samples. pDst can be pSrc.
+   * @param[in]     ifftFlag  0 = forward, 1 = inverse (f32 only).
+   *                          q15/q31 : the spectrum is scaled by 1/fftLen.
+   */
+  void generic_rfft_f32(const generic_fft_plan *S, const float32_t *pSrc, float32_t *pDst, uint8_t ifftFlag);
+  void generic_rfft_q31(const generic_fft_plan *S, const q31_t *pSrc, q31_t *pDst);
+  void generic_rfft_q15(const generic_fft_plan *S, const q15_t *pSrc, q15_t *pDst);
+
+#ifdef   __cplusplus
+}
+#endif
+
+#endif /* ifndef _GENERIC_TRANSFORM_FUNCTIONS_H_ */
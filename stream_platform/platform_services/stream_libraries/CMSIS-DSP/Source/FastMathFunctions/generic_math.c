@@ -0,0 +1,929 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        generic_math.c
+ * Description:  Vector log, exp, sqrt, 1/sqrt, sin, cos, atan2, dB and magnitude (q15, q31, f32)
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V1.9.0
+ *
+ * Target Processor: Cortex-M and Cortex-A cores
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2021 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include "../../Include/dsp/generic_math_functions.h"
+
+#define VM_MIN(a,b) (((a) < (b)) ? (a) : (b))
+#define VM_MAX(a,b) (((a) > (b)) ? (a) : (b))
+
+/**
+  @ingroup groupFastMath
+ */
+
+/**
+  @defgroup GenericMath Vector math functions
+
+  Batch versions of the elementary functions, one result per input (two interleaved inputs
+  {x, y} for atan2 and the magnitude), the destination can be the source.
+
+  @par           Algorithm
+                   - log : normalization to m in [1, 2) and 2^e, 16-segment table of 1/c and
+                     log2(c) for the segments of m, Taylor series of log2(1+u) with |u| < 1/32
+                     (f32 : series of atanh((m-1)/(m+1)) with m in [0.707, 1.414))
+                   - exp : the input is scaled to the base 2, 2^-n by shifts (f32 : by the
+                     exponent), table of 2^(k/16) and Taylor series of 2^r with r < 1/16
+                     (f32 : Cody-Waite reduction and Taylor series of e^r with |r| < ln2/2)
+                   - sqrt, 1/sqrt : normalization by an even shift to m in [0.25, 1),
+                     interpolated table of 1/sqrt(m) followed by one (q15) or two (q31)
+                     Newton iterations, sqrt(m) = m / sqrt(m)
+                   - sin, cos : quadrant symmetries, odd minimax polynomial of sin(pi/2 x)
+                     (f32 : Cody-Waite reduction to [-pi/4, pi/4] and Taylor series)
+                   - atan2 : octant symmetries and atan(z) = pi/4 - atan((1-z)/(1+z)) to have
+                     |z| <= tan(pi/8), odd minimax polynomial of atan(z)
+  The loops have no data-dependent branches (selections only). The compilers vectorize the
+  q31 log and dB and the q15 / q31 sin and cos, the other loops stay scalar because of the
+  64-bit products, the divisions of atan2 and the table lookups with computed indexes.
+ */
+
+/**
+  @addtogroup GenericMath
+  @{
+ */
+
+/* log : 1/c and log2(c) of the 16 segments of the mantissa, c = 1 + (k + 0.5)/16 */
+static const uint32_t vm_log_inv32[16] =
+{
+    0xF83E0F84UL, 0xEA0EA0EAUL, 0xDD67C8A6UL, 0xD20D20D2UL,
+    0xC7CE0C7DUL, 0xBE82FA0CUL, 0xB60B60B6UL, 0xAE4C415DUL,
+    0xA72F0539UL, 0xA0A0A0A1UL, 0x9A90E7D9UL, 0x94F2094FUL,
+    0x8FB823EEUL, 0x8AD8F2FCUL, 0x864B8A7EUL, 0x82082082UL
+};
+static const uint32_t vm_log_c31[16] =
+{
+    0x05AEB4DDUL, 0x108C588DUL, 0x1ACF5E2EUL, 0x24880F56UL,
+    0x2DC4439BUL, 0x368FD7EEUL, 0x3EF50AD2UL, 0x46FCC47AUL,
+    0x4EAECFEBUL, 0x5612089AUL, 0x5D2C7F5AUL, 0x64039858UL,
+    0x6A9C23D6UL, 0x70FA728BUL, 0x772266ADUL, 0x7D17822FUL
+};
+static const uint16_t vm_log_inv16[16] =
+{
+    63550, 59919, 56680, 53773, 51150, 48771, 46603, 44620,
+    42799, 41121, 39569, 38130, 36792, 35545, 34380, 33288
+};
+static const int16_t vm_log_c15[16] =
+{
+    1455, 4236, 6863, 9352, 11716, 13968, 16117, 18173,
+    20143, 22034, 23852, 25604, 27292, 28922, 30498, 32024
+};
+
+/* exp : 2^(k/16) in Q31 */
+static const uint32_t vm_exp2_31[16] =
+{
+    0x80000000UL, 0x85AAC368UL, 0x8B95C1E4UL, 0x91C3D374UL,
+    0x9837F052UL, 0x9EF53261UL, 0xA5FED6AAUL, 0xAD583EEAUL,
+    0xB504F334UL, 0xBD08A39FUL, 0xC5672A11UL, 0xCE248C15UL,
+    0xD744FCCBUL, 0xE0CCDEECUL, 0xEAC0C6E8UL, 0xF5257D15UL
+};
+
+/* 1/sqrt(i/64) in Q31, i = 16 .. 64 (2.0 saturated) */
+static const uint32_t vm_rsqrt31[49] =
+{
+    0xFFFFFFFFUL, 0xF85B4247UL, 0xF15BEEF0UL, 0xEAEBF549UL,
+    0xE4F92E2EUL, 0xDF7482B8UL, 0xDA5149E1UL, 0xD584CD74UL,
+    0xD105EB80UL, 0xCCCCCCCDUL, 0xC8D2AB0BUL, 0xC511A2E6UL,
+    0xC1848F35UL, 0xBE26EB32UL, 0xBAF4BA35UL, 0xB7EA73CAUL,
+    0xB504F334UL, 0xB24169BDUL, 0xAF9D533AUL, 0xAD166C63UL,
+    0xAAAAAAABUL, 0xA8583548UL, 0xA61D5F4AUL, 0xA3F8A27FUL,
+    0xA1E89B12UL, 0x9FEC03BFUL, 0x9E01B287UL, 0x9C2895D1UL,
+    0x9A5FB1E9UL, 0x98A61EC9UL, 0x96FB062FUL, 0x955DA1E0UL,
+    0x93CD3A2DUL, 0x92492492UL, 0x90D0C290UL, 0x8F638092UL,
+    0x8E00D502UL, 0x8CA83F68UL, 0x8B5947ABUL, 0x8A137D60UL,
+    0x88D6772BUL, 0x87A1D22EUL, 0x8675318CUL, 0x85503DECUL,
+    0x8432A517UL, 0x831C1990UL, 0x820C5240UL, 0x81030A23UL,
+    0x80000000UL
+};
+
+/* minimax polynomials in w = z^2 : atan(z)/z for z^2 <= tan(pi/8)^2, sin(pi/2 x)/x for x^2 <= 1 */
+static const int32_t vm_atan15[4] = { 32768, -10919, 6448, -3637 };
+static const int64_t vm_atan30[7] = { 1073741824, -357913928, 214747118, -153347392, 118546351, -90797682, 50544770 };
+static const float32_t vm_atanf[6] = { 9.999999994e-01f, -3.333330689e-01f, 1.999818304e-01f, -1.423953267e-01f, 1.056982881e-01f, -6.026305238e-02f };
+static const int32_t vm_sin16[4] = { 102944, -42331, 5210, -286 };
+static const int64_t vm_sin32[6] = { 6746518852LL, -2774394665LL, 342277127, -20107567, 688288, -14739 };
+
+/* log2(x) to log_b(x) and dB : {multiplier, right shift} of the q15 (Q12) and q31 (Q26) logarithms */
+static const int32_t vm_log_scale15[5][2] = {{ 32768, 16 }, { 22713, 16 }, { 9864, 16 }, { 24660, 17 }, { 24660, 16 }};
+static const int64_t vm_log_scale31[5][2] = {{ 1073741824, 30 }, { 1488522236, 31 }, { 646456993, 31 }, { 1616142483, 32 }, { 1616142483, 31 }};
+static const float32_t vm_log_scalef[5][2] = {{ 1.0f, 1.442695041f }, { 0.693147181f, 1.0f }, { 0.301029996f, 0.434294482f },
+                                              { 3.010299957f, 4.342944819f }, { 6.020599913f, 8.685889638f }};
+#define VM_LOG_DB 3     /* dB power and amplitude follow the three bases in the scaling tables */
+
+/* x log2(b) : {multiplier, right shift} to Q35 */
+static const int32_t vm_exp_scale15[3][2] = {{ 16384, 6 }, { 23637, 6 }, { 27213, 5 }};     /* Q19, then << 16 */
+static const int64_t vm_exp_scale31[3][2] = {{ 1073741824, 21 }, { 1549082005, 21 }, { 1783446566, 20 }};
+
+
+/*
+    number of leading zeros (31 for x = 0)
+*/
+static uint32_t vm_clz (uint32_t x)
+{
+    uint32_t n, t;
+
+    t = (uint32_t)(x < 0x00010000UL) << 4;  n = t;     x <<= t;
+    t = (uint32_t)(x < 0x01000000UL) << 3;  n += t;    x <<= t;
+    t = (uint32_t)(x < 0x10000000UL) << 2;  n += t;    x <<= t;
+    t = (uint32_t)(x < 0x40000000UL) << 1;  n += t;    x <<= t;
+    n += (uint32_t)(x < 0x80000000UL);
+    return n;
+}
+
+
+/*
+    log2(x / 2^31) in Q30, x > 0
+*/
+static int64_t vm_log2_q31 (uint32_t x)
+{
+    uint32_t c, k, m;
+    int64_t u, p;
+
+    c = vm_clz(x);
+    m = x << c;                                 /* m / 2^31 in [1, 2) */
+    k = (m >> 27) & 15u;
+    u = (int64_t)(((uint64_t)m * vm_log_inv32[k]) >> 32) - 0x80000000LL;     /* m/c - 1, Q31 */
+    p = 309816401;                              /* log2(1+u) = u/ln2 - u^2/2ln2 + .. Q30 */
+    p = -387270501 + ((p * u) >> 31);
+    p =  516360668 + ((p * u) >> 31);
+    p = -774541002 + ((p * u) >> 31);
+    p = 1549082005 + ((p * u) >> 31);
+    p = (p * u) >> 31;
+    return p + (int64_t)(vm_log_c31[k] >> 1) - ((int64_t)c << 30);
+}
+
+
+/*
+    log2(x / 2^15) in Q12, x > 0
+*/
+static int32_t vm_log2_q15 (uint32_t x)
+{
+    uint32_t c, k, m;
+    int32_t u, p;
+
+    x = x << 16;
+    c = vm_clz(x);
+    m = x << c;
+    k = (m >> 27) & 15u;
+    u = (int32_t)(((m >> 16) * vm_log_inv16[k]) >> 16) - 32768;   /* Q15 */
+    p = 7879;                                   /* Q14 */
+    p = -11819 + ((p * u) >> 15);
+    p = 23637 + ((p * u) >> 15);
+    p = (p * u) >> 15;
+    p = p + (vm_log_c15[k] >> 1) - (int32_t)(c << 14);
+    return (p + 2) >> 2;
+}
+
+
+/*
+    1/sqrt(m / 2^32) in Q31, m in [2^30, 2^32), interpolated table and Newton iterations
+*/
+static uint32_t vm_rsqrt (uint32_t m, uint32_t iterations)
+{
+    uint32_t i;
+    uint64_t r, a;
+    int64_t d;
+
+    i = (m >> 26) - 16u;
+    r = vm_rsqrt31[i] - (((uint64_t)(vm_rsqrt31[i] - vm_rsqrt31[i + 1u]) * ((m >> 10) & 0xFFFFu)) >> 16);
+    for (; iterations > 0; iterations--)
+    {   a = ((uint64_t)m * r) >> 32;            /* sqrt(m), Q31 */
+        d = 0x80000000LL - (int64_t)((a * r) >> 31);    /* 1 - m r^2, Q31 */
+        r = (uint64_t)VM_MIN(0xFFFFFFFFLL, (int64_t)r + (((int64_t)r * d) >> 32));
+    }
+    return (uint32_t)r;
+}
+
+
+/*
+    sqrt(v / 2^32) x 2^(63 - shift) rounded, v = 0 gives 0
+*/
+static uint32_t vm_sqrt (uint32_t v, uint32_t shift, uint32_t iterations)
+{
+    uint32_t c, m;
+    uint64_t s;
+
+    c = vm_clz(v) & ~1u;
+    m = v << c;
+    s = (uint64_t)m * vm_rsqrt(VM_MAX(m, 0x40000000UL), iterations);  /* sqrt(m) = m / sqrt(m) */
+    shift = VM_MIN(63u, shift + (c >> 1));
+    return (uint32_t)((s + (1ULL << (shift - 1u))) >> shift);
+}
+
+
+/*
+    1/sqrt(v / 2^32) x 2^(31 - shift), saturated to "limit"
+*/
+static uint32_t vm_invsqrt (uint32_t v, uint32_t shift, uint32_t iterations, uint32_t limit)
+{
+    uint32_t c, m;
+    uint64_t r;
+
+    c = vm_clz(v) & ~1u;
+    m = v << c;
+    r = (uint64_t)vm_rsqrt(VM_MAX(m, 0x40000000UL), iterations) << (c >> 1);
+    r = (r + (1ULL << (shift - 1u))) >> shift;
+    return (uint32_t)VM_MIN(r, (uint64_t)limit);
+}
+
+
+/*
+    2^(z / 2^35) x 2^(62 - shift) rounded, z < 0
+*/
+static uint64_t vm_exp2 (int64_t z, int64_t shift)
+{
+    int64_t r, p;
+    uint64_t v;
+
+    r = z & 0x7FFFFFFF;                         /* z = -n + k/16 + r */
+    p = 2863360;                                /* 2^r = 1 + r ln2 + (r ln2)^2/2 + .. Q31 */
+    p = 20654775 + ((p * r) >> 35);
+    p = 119194166 + ((p * r) >> 35);
+    p = 515882496 + ((p * r) >> 35);
+    p = 1488522236 + ((p * r) >> 35);
+    p = 0x80000000LL + ((p * r + (1LL << 34)) >> 35);
+    v = (uint64_t)vm_exp2_31[(z >> 31) & 15] * (uint64_t)p;    /* Q62 */
+    shift = shift - (z >> 35);
+    v = (v + (1ULL << (VM_MIN(63, shift) - 1))) >> VM_MIN(63, shift);
+    return (shift > 63) ? 0 : v;
+}
+
+
+/*
+    sin(2 pi phase / 2^32) in Q15 and Q31
+*/
+static int32_t vm_sin_q15 (uint32_t phase)
+{
+    int32_t x, w, p;
+
+    x = (int32_t)(phase & 0x3FFFFFFFUL);
+    x = (phase & 0x40000000UL) ? 0x40000000L - x : x;       /* second and fourth quadrants */
+    x = x >> 15;                                /* Q15 of the quarter wave */
+    w = (x * x) >> 15;
+    p = vm_sin16[3];                            /* Q16 */
+    p = vm_sin16[2] + ((p * w) >> 15);
+    p = vm_sin16[1] + ((p * w) >> 15);
+    p = vm_sin16[0] + ((p * w) >> 15);
+    p = (int32_t)VM_MIN(32767u, ((uint32_t)x * (uint32_t)p + 32768u) >> 16);
+    return (phase & 0x80000000UL) ? -p : p;
+}
+
+static int32_t vm_sin_q31 (uint32_t phase)
+{
+    int64_t x, w, p;
+
+    x = (int64_t)(phase & 0x3FFFFFFFUL);
+    x = (phase & 0x40000000UL) ? 0x40000000LL - x : x;
+    x = x << 1;                                 /* Q31 */
+    w = (x * x) >> 31;
+    p = vm_sin32[5];                            /* Q32 */
+    p = vm_sin32[4] + ((p * w) >> 31);
+    p = vm_sin32[3] + ((p * w) >> 31);
+    p = vm_sin32[2] + ((p * w) >> 31);
+    p = vm_sin32[1] + ((p * w + (1LL << 30)) >> 31);
+    p = vm_sin32[0] + ((p * w + (1LL << 30)) >> 31);
+    p = (int64_t)VM_MIN(0x7FFFFFFFULL, ((uint64_t)x * (uint64_t)p + 0x80000000ULL) >> 32);
+    return (int32_t)((phase & 0x80000000UL) ? -p : p);
+}
+
+
+/*
+    sin(x) and cos(x), f32 radians : reduction to r = x - n pi/2 in [-pi/4, pi/4]
+*/
+static float32_t vm_sincos_f32 (float32_t x, uint32_t quadrant)
+{
+    float32_t y, r, r2, s, c;
+    int32_t n;
+
+    y = x * 0.636619772f;
+    n = (int32_t)(y + ((y >= 0.0f) ? 0.5f : -0.5f));
+    r = ((x - (float32_t)n * 1.5703125f) - (float32_t)n * 4.837512969970703125e-4f) - (float32_t)n * 7.54978995489188216e-8f;
+    r2 = r * r;
+    s = r + r * r2 * (-1.666666666e-1f + r2 * (8.333333333e-3f + r2 * (-1.984126984e-4f + r2 * (2.755731922e-6f + r2 * -2.505210839e-8f))));
+    c = 1.0f + r2 * (-0.5f + r2 * (4.166666667e-2f + r2 * (-1.388888889e-3f + r2 * (2.480158730e-5f + r2 * -2.755731922e-7f))));
+    n = n + (int32_t)quadrant;
+    s = (n & 1) ? c : s;
+    return (n & 2) ? -s : s;
+}
+
+
+/**
+  @brief         Logarithm of a q15 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives the smallest output)
+  @param[out]    pDst       points to the output vector, Q4.11 (can be pSrc)
+  @param[in]     base       GENERIC_MATH_BASE_2, _E, _10
+  @param[in]     blockSize  number of samples
+ */
+void generic_vlog_q15(const q15_t *pSrc, q15_t *pDst, uint8_t base, uint32_t blockSize)
+{
+    int32_t K = vm_log_scale15[base % 3u][0], s = vm_log_scale15[base % 3u][1];
+    uint32_t i;
+    int32_t x, l;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        l = (vm_log2_q15((uint32_t)VM_MAX(x, 1)) * K + (1L << (s - 1))) >> s;
+        pDst[i] = (q15_t)((x > 0) ? l : -32768);
+    }
+}
+
+
+/**
+  @brief         Logarithm of a q31 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives the smallest output)
+  @param[out]    pDst       points to the output vector, Q5.26 (can be pSrc)
+  @param[in]     base       GENERIC_MATH_BASE_2, _E, _10
+  @param[in]     blockSize  number of samples
+ */
+void generic_vlog_q31(const q31_t *pSrc, q31_t *pDst, uint8_t base, uint32_t blockSize)
+{
+    int64_t K = vm_log_scale31[base % 3u][0], s = vm_log_scale31[base % 3u][1];
+    uint32_t i;
+    int32_t x, l;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        l = (int32_t)((vm_log2_q31((uint32_t)VM_MAX(x, 1)) + 8) >> 4);     /* Q26 */
+        l = (int32_t)((l * K + (1LL << (s - 1))) >> s);
+        pDst[i] = (x > 0) ? l : (q31_t)0x80000000UL;
+    }
+}
+
+
+/*
+    log_b(x) = e A + ln(m) B, x = m 2^e with m in [0.707, 1.414)
+*/
+static void vm_log_f32(const float32_t *pSrc, float32_t *pDst, float32_t A, float32_t B, uint32_t blockSize)
+{
+    union { float32_t f; uint32_t u; } v;
+    uint32_t i;
+    int32_t e;
+    float32_t s, s2, l;
+
+    for (i = 0; i < blockSize; i++)
+    {   v.f = pSrc[i];
+        v.u = (v.u >= 0x00800000UL && v.u < 0x80000000UL) ? v.u : 0x00800000UL;   /* x <= FLT_MIN */
+        e = (int32_t)(v.u >> 23) - 127;
+        v.u = (v.u & 0x007FFFFFUL) | 0x3F800000UL;
+        e = (v.f > 1.414213562f) ? e + 1 : e;
+        v.f = (v.f > 1.414213562f) ? v.f * 0.5f : v.f;
+        s = (v.f - 1.0f) / (v.f + 1.0f);
+        s2 = s * s;
+        l = 2.0f * s * (1.0f + s2 * (3.333333333e-1f + s2 * (2.0e-1f + s2 * (1.428571429e-1f + s2 * 1.111111111e-1f))));
+        pDst[i] = (float32_t)e * A + l * B;
+    }
+}
+
+
+/**
+  @brief         Logarithm of a f32 vector
+  @param[in]     pSrc       points to the input vector (x <= 1.18e-38 gives log(1.18e-38))
+  @param[out]    pDst       points to the output vector (can be pSrc)
+  @param[in]     base       GENERIC_MATH_BASE_2, _E, _10
+  @param[in]     blockSize  number of samples
+ */
+void generic_vlog_f32(const float32_t *pSrc, float32_t *pDst, uint8_t base, uint32_t blockSize)
+{
+    vm_log_f32(pSrc, pDst, vm_log_scalef[base % 3u][0], vm_log_scalef[base % 3u][1], blockSize);
+}
+
+
+/**
+  @brief         Exponential of a q15 vector, saturated
+  @param[in]     pSrc       points to the input vector, Q4.11
+  @param[out]    pDst       points to the output vector, Q15 (can be pSrc)
+  @param[in]     base       GENERIC_MATH_BASE_2, _E, _10
+  @param[in]     blockSize  number of samples
+ */
+void generic_vexp_q15(const q15_t *pSrc, q15_t *pDst, uint8_t base, uint32_t blockSize)
+{
+    int32_t K = vm_exp_scale15[base % 3u][0], s = vm_exp_scale15[base % 3u][1];
+    uint32_t i;
+    int32_t z;
+
+    for (i = 0; i < blockSize; i++)
+    {   z = (pSrc[i] * K) >> s;                 /* x log2(b), Q19 */
+        pDst[i] = (q15_t)((z >= 0) ? 32767u : VM_MIN(32767u, vm_exp2((int64_t)z << 16, 47)));
+    }
+}
+
+
+/**
+  @brief         Exponential of a q31 vector, saturated
+  @param[in]     pSrc       points to the input vector, Q5.26
+  @param[out]    pDst       points to the output vector, Q31 (can be pSrc)
+  @param[in]     base       GENERIC_MATH_BASE_2, _E, _10
+  @param[in]     blockSize  number of samples
+ */
+void generic_vexp_q31(const q31_t *pSrc, q31_t *pDst, uint8_t base, uint32_t blockSize)
+{
+    int64_t K = vm_exp_scale31[base % 3u][0], s = vm_exp_scale31[base % 3u][1];
+    uint32_t i;
+    int64_t z;
+
+    for (i = 0; i < blockSize; i++)
+    {   z = (pSrc[i] * K) >> s;                 /* x log2(b), Q35 */
+        pDst[i] = (q31_t)((z >= 0) ? 0x7FFFFFFFULL : VM_MIN(0x7FFFFFFFULL, vm_exp2(z, 31)));
+    }
+}
+
+
+/**
+  @brief         Exponential of a f32 vector
+  @param[in]     pSrc       points to the input vector
+  @param[out]    pDst       points to the output vector, +inf from 2^128 (can be pSrc)
+  @param[in]     base       GENERIC_MATH_BASE_2, _E, _10
+  @param[in]     blockSize  number of samples
+ */
+void generic_vexp_f32(const float32_t *pSrc, float32_t *pDst, uint8_t base, uint32_t blockSize)
+{
+    /* log2(b), log_b(2) in two parts (n x hi is exact), ln(b) */
+    static const float32_t C[3][4] = {{ 1.0f, 1.0f, 0.0f, 0.693147181f },
+                                      { 1.442695041f, 0.693359375f, -2.12194440e-4f, 1.0f },
+                                      { 3.321928095f, 0.301025390625f, 4.605038981e-6f, 2.302585093f }};
+    const float32_t *c = C[base % 3u];
+    union { float32_t f; uint32_t u; } v;
+    uint32_t i;
+    int32_t n;
+    float32_t x, y, r;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        y = x * c[0];
+        n = (int32_t)VM_MAX(-127.0f, VM_MIN(128.0f, y + ((y >= 0.0f) ? 0.5f : -0.5f)));
+        r = ((x - (float32_t)n * c[1]) - (float32_t)n * c[2]) * c[3];     /* |r| <= ln2/2 */
+        r = 1.0f + r * (1.0f + r * (0.5f + r * (1.666666667e-1f + r * (4.166666667e-2f +
+            r * (8.333333333e-3f + r * (1.388888889e-3f + r * 1.984126984e-4f))))));
+        v.u = (uint32_t)(VM_MAX(1, VM_MIN(254, n + 127))) << 23;
+        v.f = r * v.f * ((n > 127) ? 2.0f : ((n < -126) ? 0.5f : 1.0f));
+        v.u = (y > 129.0f) ? 0x7F800000UL : v.u;
+        pDst[i] = (y < -128.0f) ? 0.0f : v.f;
+    }
+}
+
+
+/**
+  @brief         Square root of a q15 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives 0)
+  @param[out]    pDst       points to the output vector, Q15 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vsqrt_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    int32_t x;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = VM_MAX(0, pSrc[i]);
+        pDst[i] = (q15_t)VM_MIN(32767u, vm_sqrt((uint32_t)x << 17, 48, 1));
+    }
+}
+
+
+/**
+  @brief         Square root of a q31 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives 0)
+  @param[out]    pDst       points to the output vector, Q31 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vsqrt_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    int32_t x;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = VM_MAX(0, pSrc[i]);
+        pDst[i] = (q31_t)VM_MIN(0x7FFFFFFFUL, vm_sqrt((uint32_t)x << 1, 32, 2));
+    }
+}
+
+
+/**
+  @brief         Square root of a f32 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives 0)
+  @param[out]    pDst       points to the output vector (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vsqrt_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < blockSize; i++)
+    {   pDst[i] = sqrtf(VM_MAX(0.0f, pSrc[i]));
+    }
+}
+
+
+/**
+  @brief         Inverse square root of a q15 vector, saturated
+  @param[in]     pSrc       points to the input vector (x <= 0 gives the largest output)
+  @param[out]    pDst       points to the output vector, Q4.11 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vrsqrt_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    int32_t x;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        pDst[i] = (q15_t)((x > 0) ? vm_invsqrt((uint32_t)x << 17, 20, 1, 32767u) : 32767);
+    }
+}
+
+
+/**
+  @brief         Inverse square root of a q31 vector, saturated
+  @param[in]     pSrc       points to the input vector (x <= 0 gives the largest output)
+  @param[out]    pDst       points to the output vector, Q5.26 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vrsqrt_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    int32_t x;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        pDst[i] = (q31_t)((x > 0) ? vm_invsqrt((uint32_t)x << 1, 5, 2, 0x7FFFFFFFUL) : 0x7FFFFFFFUL);
+    }
+}
+
+
+/**
+  @brief         Inverse square root of a f32 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives 3.4e38)
+  @param[out]    pDst       points to the output vector (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vrsqrt_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    union { float32_t f; uint32_t u; } v;
+    uint32_t i;
+    float32_t x, h, r;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        v.f = x;
+        v.u = 0x5F375A86UL - (v.u >> 1);        /* initial estimate, 3.4% */
+        h = 0.5f * x;
+        r = v.f;
+        r = r * (1.5f - h * r * r);
+        r = r * (1.5f - h * r * r);
+        r = r * (1.5f - h * r * r);
+        pDst[i] = (x > 0.0f) ? r : 3.402823466e38f;
+    }
+}
+
+
+/**
+  @brief         Sine of a q15 vector
+  @param[in]     pSrc       points to the input vector, turns (1.0 = 2 pi, wrapped)
+  @param[out]    pDst       points to the output vector, Q15 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vsin_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < blockSize; i++)
+    {   pDst[i] = (q15_t)vm_sin_q15((uint32_t)pSrc[i] << 17);
+    }
+}
+
+
+/**
+  @brief         Sine of a q31 vector
+  @param[in]     pSrc       points to the input vector, turns (1.0 = 2 pi, wrapped)
+  @param[out]    pDst       points to the output vector, Q31 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vsin_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < blockSize; i++)
+    {   pDst[i] = vm_sin_q31((uint32_t)pSrc[i] << 1);
+    }
+}
+
+
+/**
+  @brief         Sine of a f32 vector
+  @param[in]     pSrc       points to the input vector, radians (|x| < 8192)
+  @param[out]    pDst       points to the output vector (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vsin_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < blockSize; i++)
+    {   pDst[i] = vm_sincos_f32(pSrc[i], 0);
+    }
+}
+
+
+/**
+  @brief         Cosine of a q15 vector
+  @param[in]     pSrc       points to the input vector, turns (1.0 = 2 pi, wrapped)
+  @param[out]    pDst       points to the output vector, Q15 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vcos_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < blockSize; i++)
+    {   pDst[i] = (q15_t)vm_sin_q15(((uint32_t)pSrc[i] << 17) + 0x40000000UL);
+    }
+}
+
+
+/**
+  @brief         Cosine of a q31 vector
+  @param[in]     pSrc       points to the input vector, turns (1.0 = 2 pi, wrapped)
+  @param[out]    pDst       points to the output vector, Q31 (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vcos_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < blockSize; i++)
+    {   pDst[i] = vm_sin_q31(((uint32_t)pSrc[i] << 1) + 0x40000000UL);
+    }
+}
+
+
+/**
+  @brief         Cosine of a f32 vector
+  @param[in]     pSrc       points to the input vector, radians (|x| < 8192)
+  @param[out]    pDst       points to the output vector (can be pSrc)
+  @param[in]     blockSize  number of samples
+ */
+void generic_vcos_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+
+    for (i = 0; i < blockSize; i++)
+    {   pDst[i] = vm_sincos_f32(pSrc[i], 1);
+    }
+}
+
+
+/**
+  @brief         Angle of a q15 complex vector
+  @param[in]     pSrc       points to the input vector {x, y} interleaved
+  @param[out]    pDst       points to the output vector atan2(y, x), Q2.13 radians (can be pSrc)
+  @param[in]     blockSize  number of complex samples
+ */
+void generic_vatan2_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    int32_t x, y, ax, ay, mn, mx, big, num, den, z, w, p, a;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[2*i];
+        y = pSrc[2*i + 1];
+        ax = (x < 0) ? -x : x;
+        ay = (y < 0) ? -y : y;
+        mn = VM_MIN(ax, ay);
+        mx = VM_MAX(ax, ay);
+        big = (mn * 32768 > 13573 * mx);       /* mn/mx > tan(pi/8) */
+        num = big ? mx - mn : mn;
+        den = big ? mx + mn : mx;
+        z = (num << 15) / VM_MAX(1, den);       /* Q15, <= tan(pi/8) */
+        w = (z * z) >> 15;
+        p = vm_atan15[3];
+        p = vm_atan15[2] + ((p * w) >> 15);
+        p = vm_atan15[1] + ((p * w) >> 15);
+        p = vm_atan15[0] + ((p * w) >> 15);
+        a = (z * p) >> 15;                      /* Q15 radians */
+        a = big ? 25736 - a : a;                /* pi/4 */
+        a = (ay > ax) ? 51472 - a : a;          /* pi/2 */
+        a = (x < 0) ? 102944 - a : a;           /* pi */
+        a = (y < 0) ? -a : a;
+        pDst[i] = (q15_t)((a + 2) >> 2);
+    }
+}
+
+
+/**
+  @brief         Angle of a q31 complex vector
+  @param[in]     pSrc       points to the input vector {x, y} interleaved
+  @param[out]    pDst       points to the output vector atan2(y, x), Q2.29 radians (can be pSrc)
+  @param[in]     blockSize  number of complex samples
+ */
+void generic_vatan2_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    int32_t x, y;
+    uint64_t ax, ay, mn, mx, num, den;
+    int64_t z, w, p, a, big;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[2*i];
+        y = pSrc[2*i + 1];
+        ax = (x < 0) ? (uint64_t)(-(int64_t)x) : (uint64_t)x;
+        ay = (y < 0) ? (uint64_t)(-(int64_t)y) : (uint64_t)y;
+        mn = VM_MIN(ax, ay);
+        mx = VM_MAX(ax, ay);
+        big = ((mn << 31) > 889516852u * mx);
+        num = big ? mx - mn : mn;
+        den = big ? mx + mn : mx;
+        z = (int64_t)((num << 31) / VM_MAX(1u, den));
+        w = (z * z) >> 31;
+        p = vm_atan30[6];
+        p = vm_atan30[5] + ((p * w) >> 31);
+        p = vm_atan30[4] + ((p * w) >> 31);
+        p = vm_atan30[3] + ((p * w) >> 31);
+        p = vm_atan30[2] + ((p * w) >> 31);
+        p = vm_atan30[1] + ((p * w) >> 31);
+        p = vm_atan30[0] + ((p * w) >> 31);
+        a = (z * p) >> 30;                      /* Q31 radians */
+        a = big ? 1686629713LL - a : a;
+        a = (ay > ax) ? 3373259426LL - a : a;
+        a = (x < 0) ? 6746518852LL - a : a;
+        a = (y < 0) ? -a : a;
+        pDst[i] = (q31_t)((a + 2) >> 2);
+    }
+}
+
+
+/**
+  @brief         Angle of a f32 complex vector
+  @param[in]     pSrc       points to the input vector {x, y} interleaved
+  @param[out]    pDst       points to the output vector atan2(y, x), radians (can be pSrc)
+  @param[in]     blockSize  number of complex samples
+ */
+void generic_vatan2_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    float32_t x, y, ax, ay, mn, mx, z, w, a;
+    int32_t big;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[2*i];
+        y = pSrc[2*i + 1];
+        ax = (x < 0.0f) ? -x : x;
+        ay = (y < 0.0f) ? -y : y;
+        mn = VM_MIN(ax, ay);
+        mx = VM_MAX(ax, ay);
+        big = (mn > 0.414213562f * mx);
+        z = (big ? mx - mn : mn) / VM_MAX(1.0e-37f, big ? mx + mn : mx);
+        w = z * z;
+        a = z * (vm_atanf[0] + w * (vm_atanf[1] + w * (vm_atanf[2] + w * (vm_atanf[3] + w * (vm_atanf[4] + w * vm_atanf[5])))));
+        a = big ? 0.785398163f - a : a;
+        a = (ay > ax) ? 1.570796327f - a : a;
+        a = (x < 0.0f) ? 3.141592654f - a : a;
+        pDst[i] = (y < 0.0f) ? -a : a;
+    }
+}
+
+
+/**
+  @brief         Decibels of a q15 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives the smallest output)
+  @param[out]    pDst       points to the output vector, Q7.8 dB (can be pSrc)
+  @param[in]     option     GENERIC_MATH_DB_POWER (10 log10(x)), GENERIC_MATH_DB_AMPLITUDE (20 log10(x))
+  @param[in]     blockSize  number of samples
+ */
+void generic_vdb_q15(const q15_t *pSrc, q15_t *pDst, uint8_t option, uint32_t blockSize)
+{
+    int32_t K = vm_log_scale15[VM_LOG_DB + (option & 1u)][0], s = vm_log_scale15[VM_LOG_DB + (option & 1u)][1];
+    uint32_t i;
+    int32_t x, l;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        l = (vm_log2_q15((uint32_t)VM_MAX(x, 1)) * K + (1L << (s - 1))) >> s;
+        pDst[i] = (q15_t)((x > 0) ? l : -32768);
+    }
+}
+
+
+/**
+  @brief         Decibels of a q31 vector
+  @param[in]     pSrc       points to the input vector (x <= 0 gives the smallest output)
+  @param[out]    pDst       points to the output vector, Q8.23 dB (can be pSrc)
+  @param[in]     option     GENERIC_MATH_DB_POWER (10 log10(x)), GENERIC_MATH_DB_AMPLITUDE (20 log10(x))
+  @param[in]     blockSize  number of samples
+ */
+void generic_vdb_q31(const q31_t *pSrc, q31_t *pDst, uint8_t option, uint32_t blockSize)
+{
+    int64_t K = vm_log_scale31[VM_LOG_DB + (option & 1u)][0], s = vm_log_scale31[VM_LOG_DB + (option & 1u)][1];
+    uint32_t i;
+    int32_t x, l;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[i];
+        l = (int32_t)((vm_log2_q31((uint32_t)VM_MAX(x, 1)) + 8) >> 4);
+        l = (int32_t)((l * K + (1LL << (s - 1))) >> s);
+        pDst[i] = (x > 0) ? l : (q31_t)0x80000000UL;
+    }
+}
+
+
+/**
+  @brief         Decibels of a f32 vector
+  @param[in]     pSrc       points to the input vector (x <= 1.18e-38 gives the dB of 1.18e-38)
+  @param[out]    pDst       points to the output vector (can be pSrc)
+  @param[in]     option     GENERIC_MATH_DB_POWER (10 log10(x)), GENERIC_MATH_DB_AMPLITUDE (20 log10(x))
+  @param[in]     blockSize  number of samples
+ */
+void generic_vdb_f32(const float32_t *pSrc, float32_t *pDst, uint8_t option, uint32_t blockSize)
+{
+    vm_log_f32(pSrc, pDst, vm_log_scalef[VM_LOG_DB + (option & 1u)][0], vm_log_scalef[VM_LOG_DB + (option & 1u)][1], blockSize);
+}
+
+
+/**
+  @brief         Magnitude of a q15 complex vector
+  @param[in]     pSrc       points to the input vector {x, y} interleaved
+  @param[out]    pDst       points to the output vector sqrt(x^2 + y^2), Q2.14 (can be pSrc)
+  @param[in]     blockSize  number of complex samples
+ */
+void generic_vmag_q15(const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    int32_t x, y;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[2*i];
+        y = pSrc[2*i + 1];
+        pDst[i] = (q15_t)vm_sqrt((uint32_t)(x * x) + (uint32_t)(y * y), 48, 1);
+    }
+}
+
+
+/**
+  @brief         Magnitude of a q31 complex vector
+  @param[in]     pSrc       points to the input vector {x, y} interleaved
+  @param[out]    pDst       points to the output vector sqrt(x^2 + y^2), Q2.30 (can be pSrc)
+  @param[in]     blockSize  number of complex samples
+ */
+void generic_vmag_q31(const q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    uint32_t i, c, t;
+    int64_t x, y;
+    uint64_t e;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[2*i];
+        y = pSrc[2*i + 1];
+        e = (uint64_t)(x * x) + (uint64_t)(y * y);         /* Q62 */
+        c = ((e >> 32) != 0) ? 0u : 16u;        /* even normalization of the 64 bits */
+        e = ((e >> 32) != 0) ? e : e << 32;
+        t = vm_clz((uint32_t)(e >> 32)) >> 1;
+        e = e << (2u * t);
+        c = c + t;
+        pDst[i] = (q31_t)VM_MIN(0x7FFFFFFFUL, vm_sqrt((uint32_t)(e >> 32), 32 + c, 2));
+    }
+}
+
+
+/**
+  @brief         Magnitude of a f32 complex vector
+  @param[in]     pSrc       points to the input vector {x, y} interleaved
+  @param[out]    pDst       points to the output vector sqrt(x^2 + y^2) (can be pSrc)
+  @param[in]     blockSize  number of complex samples
+ */
+void generic_vmag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t i;
+    float32_t x, y;
+
+    for (i = 0; i < blockSize; i++)
+    {   x = pSrc[2*i];
+        y = pSrc[2*i + 1];
+        pDst[i] = sqrtf(x * x + y * y);
+    }
+}
+
+/**
+  @} end of GenericMath group
+ */
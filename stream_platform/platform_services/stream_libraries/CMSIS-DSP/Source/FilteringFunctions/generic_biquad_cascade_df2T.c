@@ -0,0 +1,248 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        generic_biquad_cascade_df2T.c
+ * Description:  Floating-point Biquad cascade transposed DirectFormII(TDF2) filters
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V1.9.0
+ *
+ * Target Processor: Cortex-M and Cortex-A cores
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2021 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Include/dsp/generic_filtering_functions.h"
+
+/**
+  @ingroup groupFilters
+ */
+
+/**
+  @defgroup BiquadCascadeDF2T Biquad Cascade IIR Filters Using a Direct Form II Transposed Structure
+
+  Each Biquad stage implements a second order filter using the equations:
+  <pre>
+      y[n] = b0 * x[n] + d1
+      d1   = b1 * x[n] + a1 * y[n] + d2
+      d2   = b2 * x[n] + a2 * y[n]
+  </pre>
+  The feedback coefficients follow the DF1 convention : a1 and a2 have the opposite sign given by Matlab.
+  The TDF2 structure uses 2 state variables per stage (DF1 uses 4) and has 2 loads per stage and sample
+  less than DF1 when the state is kept in registers.
+
+  @par           Coefficient and State Ordering
+  <pre>
+      pCoeffs = {b10, b11, b12, a11, a12, b20, b21, b22, a21, a22, ...}  5*numStages values
+      pState  = {d11, d12, d21, d22, ...}                                2*numStages values
+  </pre>
+
+  @par           Multi-section processing
+                   The stages are computed two at a time : the output of the first section of the
+                   pair is used directly by the second section without going through the output buffer,
+                   with the 4 states and 10 coefficients of the pair held in registers.
+
+  @par           Denormal protection
+                   When the input stops, the states decay to subnormal values which are processed by
+                   microcode or trap handlers on many cores (x86 hosts in particular) and can cost 100x
+                   the time of a normal multiply-add. The states are flushed to zero when their magnitude
+                   is below BIQUAD_DF2T_FLUSH_F32 (resp. _F64), far below the quantization noise of the
+                   signal path.
+ */
+
+#define BIQUAD_DF2T_FLUSH_F32 (1.0e-30f)
+#define BIQUAD_DF2T_FLUSH_F64 (1.0e-300)
+
+#define FLUSH_F32(d) (d) = (((d) < BIQUAD_DF2T_FLUSH_F32) && ((d) > -BIQUAD_DF2T_FLUSH_F32)) ? 0.0f : (d)
+#define FLUSH_F64(d) (d) = (((d) < BIQUAD_DF2T_FLUSH_F64) && ((d) > -BIQUAD_DF2T_FLUSH_F64)) ? 0.0  : (d)
+
+/**
+  @addtogroup BiquadCascadeDF2T
+  @{
+ */
+
+/**
+  @brief         Initialization function for the floating-point transposed direct form II Biquad cascade filter.
+  @param[in,out] S           points to an instance of the filter data structure.
+  @param[in]     numStages   number of 2nd order stages in the filter.
+  @param[in]     pCoeffs     points to the filter coefficients.
+  @param[in]     pState      points to the state buffer.
+  @return        none
+ */
+
+void generic_biquad_cascade_df2T_init_f32(
+        generic_biquad_cascade_df2T_inst_f32 * S,
+        uint8_t numStages,
+  const float32_t * pCoeffs,
+        float32_t * pState)
+{
+  uint32_t i;
+
+  S->numStages = numStages;
+  S->pCoeffs = pCoeffs;
+  for (i = 0; i < 2U * numStages; i++) { pState[i] = 0.0f; }
+  S->pState = pState;
+}
+
+
+/**
+  @brief         Processing function for the floating-point transposed direct form II Biquad cascade filter.
+  @param[in]     S         points to an instance of the filter data structure
+  @param[in]     pSrc      points to the block of input data
+  @param[out]    pDst      points to the block of output data (can be pSrc)
+  @param[in]     blockSize number of samples to process
+  @return        none
+ */
+
+void generic_biquad_cascade_df2T_f32(
+  const generic_biquad_cascade_df2T_inst_f32 * S,
+  const float32_t * pSrc,
+        float32_t * pDst,
+        uint32_t blockSize)
+{
+  const float32_t *pCoeffs = S->pCoeffs;
+        float32_t *pState = S->pState;
+  const float32_t *pIn = pSrc;
+        uint32_t stage = S->numStages;
+        uint32_t sample;
+
+  /* pairs of sections */
+  while (stage >= 2U)
+  {
+    const float32_t b10 = pCoeffs[0], b11 = pCoeffs[1], b12 = pCoeffs[2], a11 = pCoeffs[3], a12 = pCoeffs[4];
+    const float32_t b20 = pCoeffs[5], b21 = pCoeffs[6], b22 = pCoeffs[7], a21 = pCoeffs[8], a22 = pCoeffs[9];
+          float32_t d11 = pState[0], d12 = pState[1], d21 = pState[2], d22 = pState[3];
+
+    for (sample = 0; sample < blockSize; sample++)
+    {
+      float32_t x = pIn[sample];
+      float32_t y1 = b10 * x + d11;
+      float32_t y2;
+
+      d11 = b11 * x + a11 * y1 + d12;
+      d12 = b12 * x + a12 * y1;
+
+      y2 = b20 * y1 + d21;
+      d21 = b21 * y1 + a21 * y2 + d22;
+      d22 = b22 * y1 + a22 * y2;
+
+      FLUSH_F32(d11);   FLUSH_F32(d12);
+      FLUSH_F32(d21);   FLUSH_F32(d22);
+      pDst[sample] = y2;
+    }
+
+    pState[0] = d11;  pState[1] = d12;  pState[2] = d21;  pState[3] = d22;
+    pCoeffs += 10;
+    pState += 4;
+    pIn = pDst;
+    stage -= 2U;
+  }
+
+  /* last single section */
+  if (stage > 0U)
+  {
+    const float32_t b0 = pCoeffs[0], b1 = pCoeffs[1], b2 = pCoeffs[2], a1 = pCoeffs[3], a2 = pCoeffs[4];
+          float32_t d1 = pState[0], d2 = pState[1];
+
+    for (sample = 0; sample < blockSize; sample++)
+    {
+      float32_t x = pIn[sample];
+      float32_t y = b0 * x + d1;
+
+      d1 = b1 * x + a1 * y + d2;
+      d2 = b2 * x + a2 * y;
+
+      FLUSH_F32(d1);    FLUSH_F32(d2);
+      pDst[sample] = y;
+    }
+
+    pState[0] = d1;   pState[1] = d2;
+  }
+}
+
+
+/**
+  @brief         Initialization function for the double precision transposed direct form II Biquad cascade filter.
+  @param[in,out] S           points to an instance of the filter data structure.
+  @param[in]     numStages   number of 2nd order stages in the filter.
+  @param[in]     pCoeffs     points to the filter coefficients.
+  @param[in]     pState      points to the state buffer.
+  @return        none
+ */
+
+void generic_biquad_cascade_df2T_init_f64(
+        generic_biquad_cascade_df2T_inst_f64 * S,
+        uint8_t numStages,
+  const float64_t * pCoeffs,
+        float64_t * pState)
+{
+  uint32_t i;
+
+  S->numStages = numStages;
+  S->pCoeffs = pCoeffs;
+  for (i = 0; i < 2U * numStages; i++) { pState[i] = 0.0; }
+  S->pState = pState;
+}
+
+
+/**
+  @brief         Processing function for the double precision transposed direct form II Biquad cascade filter.
+  @param[in]     S         points to an instance of the filter data structure
+  @param[in]     pSrc      points to the block of input data
+  @param[out]    pDst      points to the block of output data (can be pSrc)
+  @param[in]     blockSize number of samples to process
+  @return        none
+ */
+
+void generic_biquad_cascade_df2T_f64(
+  const generic_biquad_cascade_df2T_inst_f64 * S,
+  const float64_t * pSrc,
+        float64_t * pDst,
+        uint32_t blockSize)
+{
+  const float64_t *pCoeffs = S->pCoeffs;
+        float64_t *pState = S->pState;
+  const float64_t *pIn = pSrc;
+        uint32_t stage, sample;
+
+  for (stage = 0; stage < S->numStages; stage++)
+  {
+    const float64_t b0 = pCoeffs[0], b1 = pCoeffs[1], b2 = pCoeffs[2], a1 = pCoeffs[3], a2 = pCoeffs[4];
+          float64_t d1 = pState[0], d2 = pState[1];
+
+    for (sample = 0; sample < blockSize; sample++)
+    {
+      float64_t x = pIn[sample];
+      float64_t y = b0 * x + d1;
+
+      d1 = b1 * x + a1 * y + d2;
+      d2 = b2 * x + a2 * y;
+
+      FLUSH_F64(d1);    FLUSH_F64(d2);
+      pDst[sample] = y;
+    }
+
+    pState[0] = d1;   pState[1] = d2;
+    pCoeffs += 5;
+    pState += 2;
+    pIn = pDst;
+  }
+}
+
+/**
+  @} end of BiquadCascadeDF2T group
+ */
@@ -0,0 +1,271 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        generic_biquad_cascade_mc.c
+ * Description:  Multichannel interleaved Biquad cascade DirectFormI(DF1) filters
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V1.9.0
+ *
+ * Target Processor: Cortex-M and Cortex-A cores
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2021 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Include/dsp/generic_filtering_functions.h"
+
+/**
+  @ingroup groupFilters
+ */
+
+/**
+  @defgroup BiquadCascadeMC Multichannel Biquad Cascade IIR Filters Using Direct Form I Structure
+
+  The same cascade of Biquads is applied to all the channels of an interleaved buffer
+  {x0[n], x1[n], .. xC-1[n], x0[n+1], ..}. The channels are processed side by side :
+  the inner loop runs over the channels with the coefficients kept in registers, and the
+  state of each channel is in its own lane of a channel-contiguous state array. The inner
+  loop has no dependency between iterations and is mapped by the compiler on the SIMD lanes
+  (Helium, Neon, SSE), one channel per lane.
+
+  @par           State Ordering
+                   The state is arranged per stage in four arrays of <code>numChannels</code> values :
+  <pre>
+      {x[n-1] of ch 0..C-1, x[n-2] of ch 0..C-1, y[n-1] of ch 0..C-1, y[n-2] of ch 0..C-1, (next stage) ..}
+  </pre>
+                   The state array has a total length of <code>4*numStages*numChannels</code> samples.
+
+  @par           Processing order
+                   The first stage reads <code>pSrc</code> and writes <code>pDst</code>, the next
+                   stages are computed in-place in <code>pDst</code>. <code>pSrc</code> and
+                   <code>pDst</code> may be the same buffer.
+ */
+
+/**
+  @addtogroup BiquadCascadeMC
+  @{
+ */
+
+/**
+  @brief         Initialization function for the multichannel Biquad cascade filters.
+  @param[in,out] S            points to an instance of the multichannel Biquad cascade structure.
+  @param[in]     numStages    number of 2nd order stages in the filter.
+  @param[in]     numChannels  number of interleaved channels.
+  @param[in]     pCoeffs      points to the filter coefficients.
+  @param[in]     pState       points to the state buffer.
+  @param[in]     postShift    Shift to be applied to the accumulator result (q15 and q31).
+  @param[in]     sampleSize   size in bytes of one sample of state (2 for q15, 4 for q31 and f32).
+  @return        none
+
+  @par           Coefficient Ordering
+                   q15 : {b10, 0, b11, b12, a11, a12, b20, 0, b21, b22, a21, a22, ...} (same as DF1 q15)
+                   q31 and f32 : {b10, b11, b12, a11, a12, b20, b21, b22, a21, a22, ...}
+                   a1 and a2 have the opposite sign given by Matlab.
+ */
+
+void generic_biquad_cascade_mc_init(
+        generic_biquad_cascade_mc_inst * S,
+        uint8_t numStages,
+        uint8_t numChannels,
+  const void * pCoeffs,
+        void * pState,
+        int8_t postShift,
+        uint8_t sampleSize)
+{
+  uint8_t *pt8 = (uint8_t *)pState;
+  uint32_t i, n;
+
+  S->numStages = numStages;
+  S->numChannels = numChannels;
+  S->postShift = postShift;
+  S->pCoeffs = pCoeffs;
+  S->pState = pState;
+
+  /* Clear state buffer, size is always 4 * numStages * numChannels */
+  n = 4U * (uint32_t)numStages * (uint32_t)numChannels * (uint32_t)sampleSize;
+  for (i = 0; i < n; i++) { pt8[i] = 0; }
+}
+
+
+/**
+  @brief         Processing function for the multichannel Q15 Biquad cascade filter (fast variant).
+  @param[in]     S         points to an instance of the multichannel Biquad cascade structure
+  @param[in]     pSrc      points to the block of interleaved input data
+  @param[out]    pDst      points to the block of interleaved output data
+  @param[in]     blockSize number of samples per channel to process
+  @return        none
+
+  @par           Scaling and Overflow Behavior
+                   Same as \ref arm_biquad_cascade_df1_fast_q15() : 32-bit accumulator in 2.30 format,
+                   shifted by <code>postShift</code> and saturated to 1.15 format.
+ */
+
+void generic_biquad_cascade_mc_q15(
+  const generic_biquad_cascade_mc_inst * S,
+  const q15_t * pSrc,
+        q15_t * pDst,
+        uint32_t blockSize)
+{
+  const q15_t *pCoeffs = (const q15_t *)S->pCoeffs;    /* Coefficient pointer */
+        q15_t *pState = (q15_t *)S->pState;            /* State pointer */
+  const q15_t *pIn = pSrc;                             /* Source pointer, first stage */
+        uint32_t nch = S->numChannels;
+        int32_t shift = (int32_t) (15 - S->postShift); /* Post shift */
+        uint32_t sample, stage, ch;
+
+  for (stage = 0; stage < S->numStages; stage++)
+  {
+    const q31_t b0 = pCoeffs[0], b1 = pCoeffs[2], b2 = pCoeffs[3];
+    const q31_t a1 = pCoeffs[4], a2 = pCoeffs[5];
+          q15_t *x1 = pState, *x2 = x1 + nch, *y1 = x2 + nch, *y2 = y1 + nch;
+    const q15_t *px = pIn;
+          q15_t *py = pDst;
+
+    for (sample = 0; sample < blockSize; sample++)
+    {
+      for (ch = 0; ch < nch; ch++)
+      {
+        q31_t in = px[ch];
+        q31_t acc = (b0 * in) + (b1 * x1[ch]) + (b2 * x2[ch]) + (a1 * y1[ch]) + (a2 * y2[ch]);
+        q31_t out = acc >> shift;
+
+        out = (out > 32767) ? 32767 : ((out < -32768) ? -32768 : out);
+        x2[ch] = x1[ch];   x1[ch] = (q15_t)in;
+        y2[ch] = y1[ch];   y1[ch] = (q15_t)out;
+        py[ch] = (q15_t)out;
+      }
+      px += nch;
+      py += nch;
+    }
+
+    pCoeffs += 6;
+    pState += 4 * nch;
+    pIn = pDst;                                        /* next stages are in-place */
+  }
+}
+
+
+/**
+  @brief         Processing function for the multichannel Q31 Biquad cascade filter.
+  @param[in]     S         points to an instance of the multichannel Biquad cascade structure
+  @param[in]     pSrc      points to the block of interleaved input data
+  @param[out]    pDst      points to the block of interleaved output data
+  @param[in]     blockSize number of samples per channel to process
+  @return        none
+
+  @par           Scaling and Overflow Behavior
+                   64-bit accumulator in 2.62 format, shifted by <code>postShift</code> and truncated
+                   to 1.31 format.
+ */
+
+void generic_biquad_cascade_mc_q31(
+  const generic_biquad_cascade_mc_inst * S,
+  const q31_t * pSrc,
+        q31_t * pDst,
+        uint32_t blockSize)
+{
+  const q31_t *pCoeffs = (const q31_t *)S->pCoeffs;    /* Coefficient pointer */
+        q31_t *pState = (q31_t *)S->pState;            /* State pointer */
+  const q31_t *pIn = pSrc;                             /* Source pointer, first stage */
+        uint32_t nch = S->numChannels;
+        int32_t shift = (int32_t) (31 - S->postShift); /* Post shift */
+        uint32_t sample, stage, ch;
+
+  for (stage = 0; stage < S->numStages; stage++)
+  {
+    const q63_t b0 = pCoeffs[0], b1 = pCoeffs[1], b2 = pCoeffs[2];
+    const q63_t a1 = pCoeffs[3], a2 = pCoeffs[4];
+          q31_t *x1 = pState, *x2 = x1 + nch, *y1 = x2 + nch, *y2 = y1 + nch;
+    const q31_t *px = pIn;
+          q31_t *py = pDst;
+
+    for (sample = 0; sample < blockSize; sample++)
+    {
+      for (ch = 0; ch < nch; ch++)
+      {
+        q31_t in = px[ch];
+        q63_t acc = (b0 * in) + (b1 * x1[ch]) + (b2 * x2[ch]) + (a1 * y1[ch]) + (a2 * y2[ch]);
+        q31_t out = (q31_t)(acc >> shift);
+
+        x2[ch] = x1[ch];   x1[ch] = in;
+        y2[ch] = y1[ch];   y1[ch] = out;
+        py[ch] = out;
+      }
+      px += nch;
+      py += nch;
+    }
+
+    pCoeffs += 5;
+    pState += 4 * nch;
+    pIn = pDst;
+  }
+}
+
+
+/**
+  @brief         Processing function for the multichannel floating-point Biquad cascade filter.
+  @param[in]     S         points to an instance of the multichannel Biquad cascade structure
+  @param[in]     pSrc      points to the block of interleaved input data
+  @param[out]    pDst      points to the block of interleaved output data
+  @param[in]     blockSize number of samples per channel to process
+  @return        none
+ */
+
+void generic_biquad_cascade_mc_f32(
+  const generic_biquad_cascade_mc_inst * S,
+  const float32_t * pSrc,
+        float32_t * pDst,
+        uint32_t blockSize)
+{
+  const float32_t *pCoeffs = (const float32_t *)S->pCoeffs;
+        float32_t *pState = (float32_t *)S->pState;
+  const float32_t *pIn = pSrc;
+        uint32_t nch = S->numChannels;
+        uint32_t sample, stage, ch;
+
+  for (stage = 0; stage < S->numStages; stage++)
+  {
+    const float32_t b0 = pCoeffs[0], b1 = pCoeffs[1], b2 = pCoeffs[2];
+    const float32_t a1 = pCoeffs[3], a2 = pCoeffs[4];
+          float32_t *x1 = pState, *x2 = x1 + nch, *y1 = x2 + nch, *y2 = y1 + nch;
+    const float32_t *px = pIn;
+          float32_t *py = pDst;
+
+    for (sample = 0; sample < blockSize; sample++)
+    {
+      for (ch = 0; ch < nch; ch++)
+      {
+        float32_t in = px[ch];
+        float32_t out = (b0 * in) + (b1 * x1[ch]) + (b2 * x2[ch]) + (a1 * y1[ch]) + (a2 * y2[ch]);
+
+        x2[ch] = x1[ch];   x1[ch] = in;
+        y2[ch] = y1[ch];   y1[ch] = out;
+        py[ch] = out;
+      }
+      px += nch;
+      py += nch;
+    }
+
+    pCoeffs += 5;
+    pState += 4 * nch;
+    pIn = pDst;
+  }
+}
+
+/**
+  @} end of BiquadCascadeMC group
+ */
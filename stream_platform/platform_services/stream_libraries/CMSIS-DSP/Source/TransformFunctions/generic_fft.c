@@ -0,0 +1,452 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        generic_fft.c
+ * Description:  Complex and real FFT (q15, q31, f32) using shared twiddle tables
+ *
+ * $Date:        19 October 2026
+ * $Revision:    V1.9.0
+ *
+ * Target Processor: Cortex-M and Cortex-A cores
+ * -------------------------------------------------------------------- */
+/*
+ * Copyright (C) 2010-2021 ARM Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include "../../Include/dsp/generic_transform_functions.h"
+
+#define FFT_TWIDDLE_SAT(x,m) (((x) > (m)) ? (m) : (x))
+
+/**
+  @ingroup groupTransforms
+ */
+
+/**
+  @defgroup GenericFFT Complex and Real FFT with shared twiddle tables
+
+  The twiddle factors are computed at initialization time instead of being linked as constant
+  tables. One table built for the size L holds W_L^k = exp(-2j pi k/L), k = 0 .. L/2-1, and serves
+  all the power-of-2 sizes N <= L with a stride L/N :
+  - the complex FFT of N samples reads W_N^k = W_L^(k L/N)
+  - the real FFT of N samples is a complex FFT of N/2 samples (stride 2L/N) followed by a split
+    stage reading W_N^k.
+  The caller (the services) keeps the tables in a shared memory bank and gives plans to the nodes.
+
+  @par           Algorithm
+                   Iterative radix-2 decimation in time, bit reversal first, the butterflies of
+                   a stage are grouped by twiddle to load each twiddle once.
+                   The q15 and q31 butterflies are scaled by 1/2, the result is scaled by 1/N.
+ */
+
+/**
+  @addtogroup GenericFFT
+  @{
+ */
+
+/**
+  @brief         Size in bytes of a twiddle table
+  @param[in]     tableLen   largest FFT size served by the table
+  @param[in]     arith      GENERIC_FFT_Q15, _Q31, _F32
+  @return        size in bytes
+ */
+uint32_t generic_fft_table_bytes(uint32_t tableLen, uint8_t arith)
+{
+    return (tableLen / 2U) * 2U * ((arith == GENERIC_FFT_Q15) ? sizeof(q15_t) : sizeof(q31_t));
+}
+
+
+/**
+  @brief         Computation of a twiddle table {cos, -sin}
+  @param[out]    pTable     table of generic_fft_table_bytes() bytes
+  @param[in]     tableLen   largest FFT size served by the table
+  @param[in]     arith      GENERIC_FFT_Q15, _Q31, _F32
+  @return        none
+ */
+void generic_fft_table_init(void *pTable, uint32_t tableLen, uint8_t arith)
+{
+    uint32_t k;
+
+    for (k = 0; k < tableLen / 2U; k++)
+    {
+        double c = cos(6.283185307179586 * (double)k / (double)tableLen);
+        double s = -sin(6.283185307179586 * (double)k / (double)tableLen);
+
+        switch (arith)
+        {
+        case GENERIC_FFT_Q15:       /* cos(2pi k/L) rounds to 1.0 for small k : saturation */
+            ((q15_t *)pTable)[2*k]   = (q15_t)FFT_TWIDDLE_SAT(lround(c * 32768.0), 32767);
+            ((q15_t *)pTable)[2*k+1] = (q15_t)FFT_TWIDDLE_SAT(lround(s * 32768.0), 32767);
+            break;
+        case GENERIC_FFT_Q31:
+            ((q31_t *)pTable)[2*k]   = (q31_t)FFT_TWIDDLE_SAT(llround(c * 2147483648.0), 0x7FFFFFFFLL);
+            ((q31_t *)pTable)[2*k+1] = (q31_t)FFT_TWIDDLE_SAT(llround(s * 2147483648.0), 0x7FFFFFFFLL);
+            break;
+        default:
+            ((float32_t *)pTable)[2*k]   = (float32_t)c;
+            ((float32_t *)pTable)[2*k+1] = (float32_t)s;
+            break;
+        }
+    }
+}
+
+
+/**
+  @brief         Initialization of a plan
+  @param[out]    S          plan
+  @param[in]     fftLen     FFT size (power of 2, <= tableLen)
+  @param[in]     arith      GENERIC_FFT_Q15, _Q31, _F32
+  @param[in]     pTable     twiddle table
+  @param[in]     tableLen   size of the twiddle table
+  @return        none
+ */
+void generic_fft_plan_init(generic_fft_plan *S, uint16_t fftLen, uint8_t arith, const void *pTable, uint32_t tableLen)
+{
+    S->fftLen = fftLen;
+    S->stride = (uint16_t)(tableLen / fftLen);
+    S->arith = arith;
+    S->pTwiddle = pTable;
+}
+
+
+/* in-place bit reversal of n complex samples of 1 (q15) or 2 (q31, f32) words */
+static void bit_reversal(uint32_t *p, uint32_t n, uint32_t words)
+{
+    uint32_t i, j, bit, t;
+
+    for (i = 1, j = 0; i < n; i++)
+    {
+        for (bit = n >> 1; j & bit; bit >>= 1)
+        {   j ^= bit;
+        }
+        j ^= bit;
+
+        if (i < j)
+        {   t = p[i*words];     p[i*words] = p[j*words];     p[j*words] = t;
+            if (words == 2U)
+            {   t = p[i*2+1];   p[i*2+1] = p[j*2+1];         p[j*2+1] = t;
+            }
+        }
+    }
+}
+
+
+static void cfft_f32_core(float32_t *p, uint32_t n, const float32_t *tw, uint32_t stride, uint8_t ifftFlag)
+{
+    uint32_t len, half, step, i, j, k;
+
+    bit_reversal((uint32_t *)p, n, 2);
+
+    for (len = 2; len <= n; len <<= 1)
+    {   half = len >> 1;
+        step = stride * (n / len);
+
+        for (j = 0; j < half; j++)
+        {   float32_t wr = tw[2*j*step];
+            float32_t wi = (ifftFlag) ? -tw[2*j*step+1] : tw[2*j*step+1];
+
+            for (i = j; i < n; i += len)
+            {   float32_t tr, ti;
+                k = i + half;
+                tr = p[2*k] * wr - p[2*k+1] * wi;
+                ti = p[2*k] * wi + p[2*k+1] * wr;
+                p[2*k]   = p[2*i]   - tr;
+                p[2*k+1] = p[2*i+1] - ti;
+                p[2*i]   += tr;
+                p[2*i+1] += ti;
+            }
+        }
+    }
+}
+
+
+static void cfft_q31_core(q31_t *p, uint32_t n, const q31_t *tw, uint32_t stride, uint8_t ifftFlag)
+{
+    uint32_t len, half, step, i, j, k;
+
+    bit_reversal((uint32_t *)p, n, 2);
+
+    for (len = 2; len <= n; len <<= 1)
+    {   half = len >> 1;
+        step = stride * (n / len);
+
+        for (j = 0; j < half; j++)
+        {   q63_t wr = tw[2*j*step];
+            q63_t wi = (ifftFlag) ? -(q63_t)tw[2*j*step+1] : tw[2*j*step+1];
+
+            for (i = j; i < n; i += len)
+            {   q63_t tr, ti, ar = p[2*i], ai = p[2*i+1];
+                k = i + half;
+                tr = (p[2*k] * wr - p[2*k+1] * wi) >> 31;
+                ti = (p[2*k] * wi + p[2*k+1] * wr) >> 31;
+                p[2*k]   = (q31_t)((ar - tr) >> 1);
+                p[2*k+1] = (q31_t)((ai - ti) >> 1);
+                p[2*i]   = (q31_t)((ar + tr) >> 1);
+                p[2*i+1] = (q31_t)((ai + ti) >> 1);
+            }
+        }
+    }
+}
+
+
+static void cfft_q15_core(q15_t *p, uint32_t n, const q15_t *tw, uint32_t stride, uint8_t ifftFlag)
+{
+    uint32_t len, half, step, i, j, k;
+
+    bit_reversal((uint32_t *)p, n, 1);
+
+    for (len = 2; len <= n; len <<= 1)
+    {   half = len >> 1;
+        step = stride * (n / len);
+
+        for (j = 0; j < half; j++)
+        {   q31_t wr = tw[2*j*step];
+            q31_t wi = (ifftFlag) ? -(q31_t)tw[2*j*step+1] : tw[2*j*step+1];
+
+            for (i = j; i < n; i += len)
+            {   q31_t tr, ti, ar = p[2*i], ai = p[2*i+1];
+                k = i + half;
+                tr = (p[2*k] * wr - p[2*k+1] * wi) >> 15;
+                ti = (p[2*k] * wi + p[2*k+1] * wr) >> 15;
+                p[2*k]   = (q15_t)((ar - tr) >> 1);
+                p[2*k+1] = (q15_t)((ai - ti) >> 1);
+                p[2*i]   = (q15_t)((ar + tr) >> 1);
+                p[2*i+1] = (q15_t)((ai + ti) >> 1);
+            }
+        }
+    }
+}
+
+
+/**
+  @brief         In-place complex FFT, floating-point
+  @param[in]     S          plan
+  @param[in,out] p          fftLen complex samples {re, im}
+  @param[in]     ifftFlag   0 = forward, 1 = inverse scaled by 1/fftLen
+  @return        none
+ */
+void generic_cfft_f32(const generic_fft_plan *S, float32_t *p, uint8_t ifftFlag)
+{
+    uint32_t i;
+
+    cfft_f32_core(p, S->fftLen, (const float32_t *)S->pTwiddle, S->stride, ifftFlag);
+
+    if (ifftFlag)
+    {   float32_t scale = 1.0f / (float32_t)S->fftLen;
+        for (i = 0; i < 2U * S->fftLen; i++) { p[i] *= scale; }
+    }
+}
+
+
+/**
+  @brief         In-place complex FFT, Q31, the result is scaled by 1/fftLen
+  @param[in]     S          plan
+  @param[in,out] p          fftLen complex samples {re, im}
+  @param[in]     ifftFlag   0 = forward, 1 = inverse
+  @return        none
+ */
+void generic_cfft_q31(const generic_fft_plan *S, q31_t *p, uint8_t ifftFlag)
+{
+    cfft_q31_core(p, S->fftLen, (const q31_t *)S->pTwiddle, S->stride, ifftFlag);
+}
+
+
+/**
+  @brief         In-place complex FFT, Q15, the result is scaled by 1/fftLen
+  @param[in]     S          plan
+  @param[in,out] p          fftLen complex samples {re, im}
+  @param[in]     ifftFlag   0 = forward, 1 = inverse
+  @return        none
+ */
+void generic_cfft_q15(const generic_fft_plan *S, q15_t *p, uint8_t ifftFlag)
+{
+    cfft_q15_core(p, S->fftLen, (const q15_t *)S->pTwiddle, S->stride, ifftFlag);
+}
+
+
+/**
+  @brief         Real FFT, floating-point
+  @param[in]     S          plan, fftLen = number of real samples
+  @param[in]     pSrc       forward : real samples, inverse : packed spectrum
+  @param[out]    pDst       forward : packed spectrum, inverse : real samples (can be pSrc)
+  @param[in]     ifftFlag   0 = forward, 1 = inverse scaled by 1/fftLen
+  @return        none
+
+  @par           Algorithm
+                   The even and odd samples are the real and imaginary parts of a complex
+                   signal z of N/2 samples, Z = FFT(z). With E[k] = (Z[k] + Z*[N/2-k])/2
+                   and O[k] = (Z[k] - Z*[N/2-k])/2j :
+  <pre>
+      X[k]     = E[k] + W_N^k O[k]
+      X[N/2-k] = conj(E[k] - W_N^k O[k])
+  </pre>
+ */
+void generic_rfft_f32(const generic_fft_plan *S, const float32_t *pSrc, float32_t *pDst, uint8_t ifftFlag)
+{
+    const float32_t *tw = (const float32_t *)S->pTwiddle;
+    uint32_t n = S->fftLen >> 1, k, kk, i;
+    float32_t *d = pDst;
+
+    if (pDst != pSrc)
+    {   for (i = 0; i < S->fftLen; i++) { pDst[i] = pSrc[i]; }
+    }
+
+    if (ifftFlag == 0)
+    {   float32_t z0r, z0i;
+
+        cfft_f32_core(d, n, tw, 2U * S->stride, 0);
+
+        z0r = d[0];     z0i = d[1];
+        d[0] = z0r + z0i;
+        d[1] = z0r - z0i;
+
+        for (k = 1; k <= n / 2U; k++)
+        {   float32_t er, ei, orr, oi, tr, ti, wr, wi;
+            kk = n - k;
+            er  = 0.5f * (d[2*k]   + d[2*kk]);      /* E = (A + conj(B))/2 */
+            ei  = 0.5f * (d[2*k+1] - d[2*kk+1]);
+            orr = 0.5f * (d[2*k+1] + d[2*kk+1]);    /* O = (A - conj(B))/2j */
+            oi  = 0.5f * (d[2*kk]  - d[2*k]);
+            wr = tw[2*k*S->stride];
+            wi = tw[2*k*S->stride+1];
+            tr = wr * orr - wi * oi;
+            ti = wr * oi  + wi * orr;
+            d[2*kk]   = er - tr;
+            d[2*kk+1] = ti - ei;
+            d[2*k]    = er + tr;
+            d[2*k+1]  = ei + ti;
+        }
+    }
+    else
+    {   float32_t x0, xn2, scale;
+
+        x0 = d[0];      xn2 = d[1];
+        d[0] = 0.5f * (x0 + xn2);
+        d[1] = 0.5f * (x0 - xn2);
+
+        for (k = 1; k <= n / 2U; k++)
+        {   float32_t er, ei, dr, di, orr, oi, wr, wi;
+            kk = n - k;
+            er = 0.5f * (d[2*k]   + d[2*kk]);       /* E = (X[k] + conj(X[N/2-k]))/2 */
+            ei = 0.5f * (d[2*k+1] - d[2*kk+1]);
+            dr = 0.5f * (d[2*k]   - d[2*kk]);       /* D = (X[k] - conj(X[N/2-k]))/2 */
+            di = 0.5f * (d[2*k+1] + d[2*kk+1]);
+            wr = tw[2*k*S->stride];
+            wi = tw[2*k*S->stride+1];
+            orr = wr * dr + wi * di;                /* O = conj(W) D */
+            oi  = wr * di - wi * dr;
+            d[2*kk]   = er + oi;                    /* Z[N/2-k] = conj(E) + j conj(O) */
+            d[2*kk+1] = orr - ei;
+            d[2*k]    = er - oi;                    /* Z[k] = E + j O */
+            d[2*k+1]  = ei + orr;
+        }
+
+        cfft_f32_core(d, n, tw, 2U * S->stride, 1);
+
+        scale = 1.0f / (float32_t)n;
+        for (i = 0; i < S->fftLen; i++) { d[i] *= scale; }
+    }
+}
+
+
+/**
+  @brief         Real FFT, Q31, the spectrum is scaled by 1/fftLen
+  @param[in]     S          plan, fftLen = number of real samples
+  @param[in]     pSrc       real samples
+  @param[out]    pDst       packed spectrum (can be pSrc)
+  @return        none
+ */
+void generic_rfft_q31(const generic_fft_plan *S, const q31_t *pSrc, q31_t *pDst)
+{
+    const q31_t *tw = (const q31_t *)S->pTwiddle;
+    uint32_t n = S->fftLen >> 1, k, kk, i;
+    q31_t *d = pDst;
+    q63_t z0r, z0i;
+
+    if (pDst != pSrc)
+    {   for (i = 0; i < S->fftLen; i++) { pDst[i] = pSrc[i]; }
+    }
+
+    cfft_q31_core(d, n, tw, 2U * S->stride, 0);
+
+    z0r = d[0];     z0i = d[1];
+    d[0] = (q31_t)((z0r + z0i) >> 1);
+    d[1] = (q31_t)((z0r - z0i) >> 1);
+
+    for (k = 1; k <= n / 2U; k++)
+    {   q63_t er, ei, orr, oi, tr, ti, wr, wi;
+        kk = n - k;
+        er  = ((q63_t)d[2*k]   + d[2*kk])   >> 1;
+        ei  = ((q63_t)d[2*k+1] - d[2*kk+1]) >> 1;
+        orr = ((q63_t)d[2*k+1] + d[2*kk+1]) >> 1;
+        oi  = ((q63_t)d[2*kk]  - d[2*k])    >> 1;
+        wr = tw[2*k*S->stride];
+        wi = tw[2*k*S->stride+1];
+        tr = (wr * orr - wi * oi)  >> 31;
+        ti = (wr * oi  + wi * orr) >> 31;
+        d[2*kk]   = (q31_t)((er - tr) >> 1);
+        d[2*kk+1] = (q31_t)((ti - ei) >> 1);
+        d[2*k]    = (q31_t)((er + tr) >> 1);
+        d[2*k+1]  = (q31_t)((ei + ti) >> 1);
+    }
+}
+
+
+/**
+  @brief         Real FFT, Q15, the spectrum is scaled by 1/fftLen
+  @param[in]     S          plan, fftLen = number of real samples
+  @param[in]     pSrc       real samples
+  @param[out]    pDst       packed spectrum (can be pSrc)
+  @return        none
+ */
+void generic_rfft_q15(const generic_fft_plan *S, const q15_t *pSrc, q15_t *pDst)
+{
+    const q15_t *tw = (const q15_t *)S->pTwiddle;
+    uint32_t n = S->fftLen >> 1, k, kk, i;
+    q15_t *d = pDst;
+    q31_t z0r, z0i;
+
+    if (pDst != pSrc)
+    {   for (i = 0; i < S->fftLen; i++) { pDst[i] = pSrc[i]; }
+    }
+
+    cfft_q15_core(d, n, tw, 2U * S->stride, 0);
+
+    z0r = d[0];     z0i = d[1];
+    d[0] = (q15_t)((z0r + z0i) >> 1);
+    d[1] = (q15_t)((z0r - z0i) >> 1);
+
+    for (k = 1; k <= n / 2U; k++)
+    {   q31_t er, ei, orr, oi, tr, ti, wr, wi;
+        kk = n - k;
+        er  = ((q31_t)d[2*k]   + d[2*kk])   >> 1;
+        ei  = ((q31_t)d[2*k+1] - d[2*kk+1]) >> 1;
+        orr = ((q31_t)d[2*k+1] + d[2*kk+1]) >> 1;
+        oi  = ((q31_t)d[2*kk]  - d[2*k])    >> 1;
+        wr = tw[2*k*S->stride];
+        wi = tw[2*k*S->stride+1];
+        tr = (wr * orr - wi * oi)  >> 15;
+        ti = (wr * oi  + wi * orr) >> 15;
+        d[2*kk]   = (q15_t)((er - tr) >> 1);
+        d[2*kk+1] = (q15_t)((ti - ei) >> 1);
+        d[2*k]    = (q15_t)((er + tr) >> 1);
+        d[2*k+1]  = (q15_t)((ei + ti) >> 1);
+    }
+}
+
+/**
+  @} end of GenericFFT group
+ */
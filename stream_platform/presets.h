@@ -57,6 +57,7 @@
 #undef NB_NODE_ENTRY_POINTS         /* max number of nodes installed at compilation time */
 #undef MAX_NB_APP_CALLBACKS         /* max number of application callbacks used from NODE and scripts */
 #undef MULTIPROCESSING              /* single processor by default */
+#undef PLATFORM_NODE_TRACES         /* debug traces of the nodes saved in memory ("_trace" node manifests) */
 
 /*----- PLATFORM DEFAULT CALLBACKS ------------------------------------------------------------------------*/
 #undef CALLBACK_USE_CASE_CONTROL    // S->application_callbacks[USE_CASE_CONTROL] 
@@ -211,12 +212,92 @@
           uint32_t blockSize);
 
 
+    //#define SERV_DSP_CASCADE_MC_Q15/Q31/F32   /* multichannel interleaved, one channel per SIMD lane */
+    //use #define PLATFORM_SERV_DSP_CASCADE_MC for specific implmentations
+    typedef struct
+    {       void *pState;           /* 4 x numStages x numChannels samples */
+      const void *pCoeffs;          /* 6 x numStages (q15) or 5 x numStages (q31, f32) */
+            uint8_t numStages;
+            uint8_t numChannels;
+            int8_t postShift;
+    } generic_biquad_cascade_mc_inst;
+
+    typedef void (mc_init) (
+        generic_biquad_cascade_mc_inst * S,
+          uint8_t numStages,
+          uint8_t numChannels,
+    const void * pCoeffs,
+          void * pState,
+          int8_t postShift,
+          uint8_t sampleSize);
+
+    typedef void (mc_q15) (         /* platform-accelerated multichannel DF1 will use these templates */
+    const generic_biquad_cascade_mc_inst * S,
+    const int16_t * pSrc,
+          int16_t * pDst,
+          uint32_t blockSize);
+
+    typedef void (mc_q31) (
+    const generic_biquad_cascade_mc_inst * S,
+    const int32_t * pSrc,
+          int32_t * pDst,
+          uint32_t blockSize);
+
+    typedef void (mc_f32) (
+    const generic_biquad_cascade_mc_inst * S,
+    const float * pSrc,
+          float * pDst,
+          uint32_t blockSize);
+
+
+    //#define SERV_DSP_CASCADE_DF2T_F32/F64     /* transposed DF2 with denormal flushing, F64 on computer platforms */
+    typedef struct
+    {       uint8_t numStages;
+            float *pState;          /* 2 x numStages */
+      const float *pCoeffs;         /* 5 x numStages */
+    } generic_biquad_cascade_df2T_inst_f32;
+
+    typedef struct
+    {       uint8_t numStages;
+            double *pState;
+      const double *pCoeffs;
+    } generic_biquad_cascade_df2T_inst_f64;
+
+    typedef void (df2T_init_f32) (generic_biquad_cascade_df2T_inst_f32 * S, uint8_t numStages, const float * pCoeffs, float * pState);
+    typedef void (df2T_f32) (const generic_biquad_cascade_df2T_inst_f32 * S, const float * pSrc, float * pDst, uint32_t blockSize);
+    typedef void (df2T_init_f64) (generic_biquad_cascade_df2T_inst_f64 * S, uint8_t numStages, const double * pCoeffs, double * pState);
+    typedef void (df2T_f64) (const generic_biquad_cascade_df2T_inst_f64 * S, const double * pSrc, double * pDst, uint32_t blockSize);
+
+
     //#define SERV_DSP_WINDOW                
     //#define SERV_DSP_WINDOW_DB             
-    //#define SERV_DSP_rFFT_Q15           /* RFFT windowing, module, dB , use SERV_CHECK_COPROCESSOR */
-    //#define SERV_DSP_rFFT_F32           /* default FFT with tables rebuilded */
-    //#define SERV_DSP_cFFT_Q15           /* cFFT windowing, module, dB */
-    //#define SERV_DSP_cFFT_F32           
+    //#define SERV_DSP_rFFT_Q15/Q31/F32   /* real FFT, plan from SERV_DSP_INIT, twiddles cached in the services */
+    //#define SERV_DSP_cFFT_Q15/Q31/F32   /* complex FFT */
+    typedef struct
+    {       uint16_t fftLen;        /* number of complex (cFFT) or real (rFFT) samples */
+            uint16_t stride;        /* twiddle stride = table length / fftLen */
+            uint8_t arith;          /* GENERIC_FFT_Q15/Q31/F32 */
+      const void *pTwiddle;         /* shared table {cos, -sin} */
+    } generic_fft_plan;
+
+    typedef void (fft_table_init) (void * pTable, uint32_t tableLen, uint8_t arith);
+    typedef void (fft_plan_init) (generic_fft_plan * S, uint16_t fftLen, uint8_t arith, const void * pTable, uint32_t tableLen);
+    typedef void (cfft_q15) (const generic_fft_plan * S, int16_t * p, uint8_t ifftFlag);
+    typedef void (cfft_q31) (const generic_fft_plan * S, int32_t * p, uint8_t ifftFlag);
+    typedef void (cfft_f32) (const generic_fft_plan * S, float * p, uint8_t ifftFlag);
+    typedef void (rfft_q15) (const generic_fft_plan * S, const int16_t * pSrc, int16_t * pDst);
+    typedef void (rfft_q31) (const generic_fft_plan * S, const int32_t * pSrc, int32_t * pDst);
+    typedef void (rfft_f32) (const generic_fft_plan * S, const float * pSrc, float * pDst, uint8_t ifftFlag);
+
+    //#define SERV_DSP_LOG/EXP/DB_Q15/Q31/F32     /* TAG_SSRV = GENERIC_MATH_BASE_ or GENERIC_MATH_DB_ */
+    //#define SERV_DSP_SQRT/RSQRT/SIN/COS_Q15/Q31/F32
+    //#define SERV_DSP_ATAN2/MAG_Q15/Q31/F32     /* {x, y} interleaved */
+    typedef void (vmath_q15) (const int16_t * pSrc, int16_t * pDst, uint32_t blockSize);
+    typedef void (vmath_q31) (const int32_t * pSrc, int32_t * pDst, uint32_t blockSize);
+    typedef void (vmath_f32) (const float * pSrc, float * pDst, uint32_t blockSize);
+    typedef void (vmath_option_q15) (const int16_t * pSrc, int16_t * pDst, uint8_t option, uint32_t blockSize);
+    typedef void (vmath_option_q31) (const int32_t * pSrc, int32_t * pDst, uint8_t option, uint32_t blockSize);
+    typedef void (vmath_option_f32) (const float * pSrc, float * pDst, uint8_t option, uint32_t blockSize);
 
 // SERV_GROUP_DEEPL              /* 5  cmsis-nn */
     //#define SERV_ML_FC                  /* fully connected layer Mat x Vec */
@@ -248,6 +248,9 @@
 #define  OFFSET_SCROFF0_MSB U(17) /* 17 offset in the W32 script table */
 #define  OFFSET_SCROFF0_LSB U( 0) /*    placed at    */
 
+#define SCRIPT_FORMAT_BYTECODE  0u      /* FORMAT_SCROFF0 : byte codes interpreted by arm_stream_script_interpreter() */
+#define SCRIPT_FORMAT_NATIVE_C  1u      /*   byte codes translated to C by the graph compiler, the VM is the fallback */
+
          
 /* 
     arc descriptors used to address the working area : registers and stack
@@ -273,6 +276,8 @@
 
 //#define          READ_ARCW2_MSB U(21) /*    data read index  Byte-acurate up to 4MBytes starting from base address */
 //#define          READ_ARCW2_LSB U( 0) /* 22 this is incremented by "frame_size" FRAMESIZE_FMT0  */
+#define    PARAMSIZE_SCRARCW2_MSB U(15) /*    */
+#define    PARAMSIZE_SCRARCW2_LSB U( 0) /* 16 size in W32 of the parameters following the code */
 
 #define    COLLISION_SCRARCW3_MSB U(31) /*  8  */
 #define    COLLISION_SCRARCW3_LSB U(24) /*     */
@@ -857,20 +862,21 @@
 /*                                            FLOAT                                                               */
 /*================================================================================================================*/    
 
-#define FADD(tmp, src1, src2)  tmp=src1+src2
-#define FSUB(tmp, src1, src2)  
-#define FMUL(tmp, src1, src2)  
-#define FDIV(tmp, src1, src2)  
-#define FMAX(tmp, src2, src1)  
-#define FMIN(tmp, src2, src1)  
-#define FAMAX(tmp, src2, src1) 
-#define FAMAX(tmp, src2, src1) 
-#define FTESTEQU(tmp, dst) 0
-#define FTESTLEQ(tmp, dst) 0
-#define FTESTLT(tmp, dst)  0
-#define FTESTNEQ(tmp, dst) 0
-#define FTESTGEQ(tmp, dst) 0
-#define FTESTGT(tmp, dst)  0
+#define FABS(src)              (((src) < 0) ? -(src) : (src))
+#define FADD(tmp, src1, src2)  tmp = (src1) + (src2)
+#define FSUB(tmp, src1, src2)  tmp = (src1) - (src2)
+#define FMUL(tmp, src1, src2)  tmp = (src1) * (src2)
+#define FDIV(tmp, src1, src2)  tmp = ((src2) == 0) ? 0 : (src1) / (src2)    /* no infinity in the scripts */
+#define FMAX(tmp, src2, src1)  tmp = ((src1) > (src2)) ? (src1) : (src2)
+#define FMIN(tmp, src2, src1)  tmp = ((src1) < (src2)) ? (src1) : (src2)
+#define FAMAX(tmp, src2, src1) tmp = (FABS(src1) > FABS(src2)) ? FABS(src1) : FABS(src2)
+#define FAMIN(tmp, src2, src1) tmp = (FABS(src1) < FABS(src2)) ? FABS(src1) : FABS(src2)
+#define FTESTEQU(tmp, dst) ((dst) == (tmp))
+#define FTESTLEQ(tmp, dst) ((dst) <= (tmp))
+#define FTESTLT(tmp, dst)  ((dst) <  (tmp))
+#define FTESTNEQ(tmp, dst) ((dst) != (tmp))
+#define FTESTGEQ(tmp, dst) ((dst) >= (tmp))
+#define FTESTGT(tmp, dst)  ((dst) >  (tmp))
 
 #define F2I(src) ((uint32_t)(src))
 #define I2F(src) ((float_t)(src))
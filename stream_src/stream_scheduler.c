@@ -1126,7 +1126,7 @@ static void reset_component (arm_stream_instance_t *S)
     uint8_t imem, j, iformat, narc, imem_graph, *pt8;
     uint32_t *memreq, check, *key;
     
-    #define MEMRESET (MAX_NB_MEM_REQ_PER_NODE + (STREAM_FORMAT_SIZE_W32*MAX_NB_STREAM_PER_NODE))
+    #define MEMRESET (MAX_NB_MEM_REQ_PER_NODE + ((STREAM_FORMAT_SIZE_W32 + 1)*MAX_NB_STREAM_PER_NODE))
     intptr_t memreq_physical[MEMRESET];
 
     /* does the node was already RESET by another thread/processor ? */
@@ -1176,6 +1176,12 @@ static void reset_component (arm_stream_instance_t *S)
         }
     }
 
+    /* followed by the buffer size of the arcs in Bytes (fill-level targets of the nodes) */
+    for (j = 0; j < narc; j++)
+    {   uint32_t *arc = &(S->all_arcs[SIZEOF_ARCDESC_W32 * (ARC_RX0TX1_CLEAR & (S->arcID)[j])]);
+        memreq_physical[imem++] = RD(arc[BUFSIZE_ARCW1], BUFF_SIZE_ARCW1);
+    }
+
     nbmem = (uint8_t)RD(S->node_header[0], NALLOCM1_LW0) +1;
 
     /* the SWC is asking for dynamic allocation of memory instead of preallocated */
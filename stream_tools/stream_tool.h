@@ -376,6 +376,7 @@ struct stream_script
     uint32_t nbw32_allocated;                               // static address, size
     uint32_t stack_memory_shared, ram_heap_size;            // flag, heap size
     uint32_t script_nb_instruction, nb_reg, nb_stack;       // memory allocation parameters
+    uint32_t script_nb_code;                                // code size in w32, the parameters follow the code
     uint32_t code_param32;                                  // size of code + parameters in w32
     uint32_t stack_memory_script, mem_VID;
     uint32_t script_offset;
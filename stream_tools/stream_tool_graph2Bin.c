@@ -330,7 +330,8 @@ void arm_stream_graphTxt2Bin (struct stream_platform_manifest *platform, struct
 
             for (j = 0; j < graph->all_scripts[iscript].script_nb_instruction; j++)
             {   int32_t  cond, opcode, opar, dst, src1, src2, K;
-                //FMT0 = graph->all_scripts[iscript].script_program[j];
+                FMT0 = graph->all_scripts[iscript].script_program[j];
+                sprintf(tmpstring, "Script %d word %d", iscript, j);
                 //cond =  RD(FMT0, OP_COND_INST);   dst  =  RD(FMT0, OP_DST_INST);
                 //opcode= RD(FMT0, OP_INST);        src1 =  RD(FMT0, OP_SRC1_INST);
                 //opar =  RD(FMT0, OP_OPAR_INST);   src2 =  RD(FMT0, OP_SRC2_INST);
@@ -801,7 +802,10 @@ void arm_stream_graphTxt2Bin (struct stream_platform_manifest *platform, struct
             }
 
             ST(ARCW[    SCRIPT_SCRARCW1], BUFF_SIZE_SCRARCW1, m);        
-            ST(ARCW[    SCRIPT_SCRARCW1], CODESIZE_SCRARCW1, pscript->script_nb_instruction);        
+            /* the code size is also the offset of the parameters, they follow the code */
+            ST(ARCW[    SCRIPT_SCRARCW1], CODESIZE_SCRARCW1, 
+                (pscript->script_nb_code) ? pscript->script_nb_code : pscript->script_nb_instruction);        
+            ST(ARCW[     RDFLOW_SCRARCW2], PARAMSIZE_SCRARCW2, pscript->script_nb_instruction - RD(ARCW[SCRIPT_SCRARCW1], CODESIZE_SCRARCW1));        
             ST(ARCW[    DBGFMT_SCRARCW4], RAMTOTALW32_SCRARCW4, 2*(pscript->nb_reg + pscript->nb_stack) + pscript->ram_heap_size);        
             ST(ARCW[    DBGFMT_SCRARCW4], NREGS_SCRARCW4, pscript->nb_reg);        
             ST(ARCW[    DBGFMT_SCRARCW4], NSTACK_SCRARCW4, pscript->nb_stack);        
@@ -814,7 +818,8 @@ void arm_stream_graphTxt2Bin (struct stream_platform_manifest *platform, struct
             {   sprintf(tmpstring, "ARC%d  from script%d   sizeW32 %Xh (%Xh)", iarc, iscript, m/4, m);  GTEXTINC(tmpstring); 
             }
            
-            sprintf(tmpstring, "      nb instructions 0x%x", pscript->script_nb_instruction);           GTEXTINC(tmpstring); 
+            sprintf(tmpstring, "      nb instructions 0x%x code 0x%x", pscript->script_nb_instruction, 
+                RD(ARCW[SCRIPT_SCRARCW1], CODESIZE_SCRARCW1));                                      GTEXTINC(tmpstring); 
             sprintf(tmpstring, "      nregs+r12 %d x2   stack %d x2  heap %xh", RD(ARCW[DBGFMT_SCRARCW4], NREGS_SCRARCW4), 
                 RD(ARCW[DBGFMT_SCRARCW4], NSTACK_SCRARCW4), pscript->ram_heap_size); HCTEXT(tmpstring); GTEXTINC(tmpstring); 
             
@@ -78,6 +78,8 @@ extern void stream_tool_read_code(char **pt_line, struct stream_platform_manifes
                             struct stream_graph_linkedlist *graph, struct stream_script *script);
 extern void stream_tool_read_assembler(char **pt_line, struct stream_platform_manifest *platform,
                             struct stream_graph_linkedlist *graph, struct stream_script *script);
+extern void stream_tool_script_to_c(struct stream_graph_linkedlist *graph, FILE *ptf);
+extern void stream_tool_script_optimize(struct stream_graph_linkedlist *graph, struct stream_script *script);
 
 //extern void pack_AUDIO_IN_IO_setting(struct arcStruct *arc);
 //extern void pack_AUDIO_OUT_IO_setting(struct arcStruct *arc);
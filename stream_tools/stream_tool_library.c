@@ -570,7 +570,7 @@ int fields_extract(char **pt_line, char *types,  ...)
 {
     char *ptstart, *ptstart0, S[200], *vaS;
     int ifield, nchar, n, nfields;
-    long IL,*vaIL;
+    int32_t IL,*vaIL;
     int64_t ILL,*vaILL;
     va_list vl;
     float F, *vaF;
@@ -37,6 +37,7 @@
 #define GRAPH_TOP_MANIFEST  "../../../stream_platform/ra8e1/top_manifest_ra8e1.txt"
 #define GRAPH_HEADER        "../../../stream_platform/ra8e1/graphs/graph_ra8_header.h"         /* list of labels to do "set_parameter" from scripts */
 #define GRAPH_DEBUG         "../../../stream_platform/ra8e1/graphs/graph_ra8_debug.txt"        /* comments made during graph conversion  */
+#define GRAPH_SCRIPT_C      "../../../stream_platform/ra8e1/graphs/graph_ra8_scripts.c"        /* scripts translated to C */
 #endif //PLATFORM_RA8E1FPB
 
 #ifdef PLATFORM_ALIF1 
@@ -48,6 +49,7 @@
 #define GRAPH_TOP_MANIFEST  "../../../stream_platform/alif1/top_manifest_alif1.txt"
 #define GRAPH_HEADER        "../../../stream_platform/alif1/graphs/graph_alif_header.h"         /* list of labels to do "set_parameter" from scripts */
 #define GRAPH_DEBUG         "../../../stream_platform/alif1/graphs/graph_alif_debug.txt"        /* comments made during graph conversion  */
+#define GRAPH_SCRIPT_C      "../../../stream_platform/alif1/graphs/graph_alif_scripts.c"        /* scripts translated to C */
 #endif //PLATFORM_ALIF1
 
 #ifdef PLATFORM_COMPUTER 
@@ -66,6 +68,7 @@
 #define GRAPH_TOP_MANIFEST  "../../../stream_platform/computer/top_manifest_computer.txt"
 #define GRAPH_HEADER        "../../../stream_platform/computer/graphs/graph_computer_header.h"  /* list of labels to do "set_parameter" from scripts */
 #define GRAPH_DEBUG         "../../../stream_platform/computer/graphs/graph_computer_debug.txt" /* comments made during graph conversion  */
+#define GRAPH_SCRIPT_C      "../../../stream_platform/computer/graphs/graph_computer_scripts.c" /* scripts translated to C */
 #endif
 
 #ifdef PLATFORM_LPC55S69EVK 
@@ -74,6 +77,7 @@
 #define GRAPH_BIN           "../../../stream_platform/lpc55s69evk/graphs/graph_lpc55s69evk_bin.txt" /* binary graph file */
 #define GRAPH_HEADER        "../../../stream_platform/lpc55s69evk/graphs/graph_lpc55s69evk_header.h"  /* list of labels to do "set_parameter" from scripts */
 #define GRAPH_DEBUG         "../../../stream_platform/lpc55s69evk/graphs/graph_lpc55s69evk_debug.txt" /* comments made during graph conversion  */
+#define GRAPH_SCRIPT_C      "../../../stream_platform/lpc55s69evk/graphs/graph_lpc55s69evk_scripts.c" /* scripts translated to C */
 #endif
 
 #ifdef PLATFORM_MSPM0L1306 
@@ -82,6 +86,7 @@
 #define GRAPH_BIN           "../../../stream_platform/lp-mspm0l1306/graphs/graph_lp-mspm0l1306_bin.txt" /* binary graph file */
 #define GRAPH_HEADER        "../../../stream_platform/lp-mspm0l1306/graphs/graph_lp-mspm0l1306_header.h"  /* list of labels to do "set_parameter" from scripts */
 #define GRAPH_DEBUG         "../../../stream_platform/lp-mspm0l1306/graphs/graph_lp-mspm0l1306_debug.txt" /* comments made during graph conversion  */
+#define GRAPH_SCRIPT_C      "../../../stream_platform/lp-mspm0l1306/graphs/graph_lp-mspm0l1306_scripts.c" /* scripts translated to C */
 #endif
 
 extern void arm_stream_read_manifests (struct stream_platform_manifest *platform, char *all_files);
@@ -194,6 +199,18 @@ void main(void)
         Convert the structure to the binary format
             used by the graph interpreter and scheduler
     */
+#ifdef GRAPH_SCRIPT_C
+    /* scripts compiled ahead of time, before the binary graph receives their format */
+    {   FILE * ptf_script_c;
+
+        if (0 == (ptf_script_c = fopen(GRAPH_SCRIPT_C, "wt"))) exit( 1);
+
+        stream_tool_script_to_c(graph, ptf_script_c);
+
+        fclose(ptf_script_c); 
+    }
+#endif
+
     {   FILE * ptf_graph_bin;
 
         if (0 == (ptf_graph_bin = fopen(GRAPH_BIN, "wt"))) exit( 1);
@@ -844,8 +844,8 @@ void arm_stream_read_graph (struct stream_platform_manifest *platform,
         }
         /* ----------------------------------------------- SCRIPTS ----------------------------------------------------------*/
         if (COMPARE(common_script))
-        {   fields_extract(&pt_line, "ci", ctmp, &(graph->all_scripts[graph->idx_script].script_ID)); /* instance number (its identification) */
-            graph->idx_script = graph->nb_scripts;
+        {   graph->idx_script = graph->nb_scripts;
+            fields_extract(&pt_line, "ci", ctmp, &(graph->all_scripts[graph->idx_script].script_ID)); /* instance number (its identification) */
             graph->all_scripts[graph->idx_script].nb_reg = 16;       /* default number of registers  + R12 + stack size */
             graph->all_scripts[graph->idx_script].nb_stack = 6;
             graph->all_scripts[graph->idx_script].ram_heap_size = 0;
@@ -121,21 +121,26 @@ script 0
 void stream_tool_read_assembler(char **pt_line, struct stream_platform_manifest *platform,
                             struct stream_graph_linkedlist *graph, struct stream_script *script)
 {
-//    uint8_t raw_type;
-//    uint32_t nb_raw, nbytes, nbits;
-//
-//    while (1)
-//    {
-//        read_binary_param(pt_line, &(script->script_program[script->script_nb_instruction]), &raw_type, &nb_raw);
-//        if (nb_raw == 0)
-//            break;
-//        nbits = stream_bitsize_of_raw(raw_type);
-//        nbytes = (nbits * nb_raw)/8;
-//        script->script_nb_instruction += nbytes;
-//    }
-//
-//    script->script_nb_instruction = (3+(script->script_nb_instruction)) & 0xFFFFFFFC;   // round it to W32
-//
+    uint8_t raw_type, *pt8;
+    uint32_t nb_raw, nbytes;
+
+    pt8 = (uint8_t *)&(script->script_program[script->script_nb_instruction]);
+    nbytes = 0;
+    while (1)
+    {
+        read_binary_param(pt_line, &(pt8[nbytes]), &raw_type, &nb_raw);
+        if (nb_raw == 0)
+            break;
+        nbytes += (stream_bitsize_of_raw(raw_type) * nb_raw)/8;
+    }
+
+    script->script_nb_instruction += (3 + nbytes) / 4;     // round it to W32
+    script->script_nb_code = script->script_nb_instruction;
+
+    /* byte codes of the interpreter, not the binary codes of a native architecture */
+    if (script->script_format == SCRIPT_FORMAT_BYTECODE || script->script_format == SCRIPT_FORMAT_NATIVE_C)
+    {   stream_tool_script_optimize(graph, script);
+    }
 }
 
 /* --------------------------- instruction coding ----------------------------*/
@@ -494,6 +499,473 @@ void read_para_heap_labels (char **pt_line, struct stream_script *script,
 //    *idx_l = idx_label;
 //    *total_nbytes = (int)(ptr_param - pt0); 
 }
+/* ====================================================================================   
+    Optimization of the byte codes, applied after the assembler
+
+    - jump threading : jumps to an unconditional jump are redirected to its destination
+    - dead branches  : jumps to the next instruction and code following an unconditional
+                       jump/return without label are removed
+    - constant folding and propagation : ALU operations on known constants are replaced by 
+                       a load, loads of a value already in the register are removed
+    - dead stores    : register writes overwritten in the same basic block without being read
+    - register allocation : "push rX" followed by "rY = pop" become "rY = rX", no stack access
+
+    Scripts using instructions with unknown extension words (bit-fields, setptr, ..) are not 
+    modified. The instruction counts before and after are printed in the debug file.
+
+    jump, banz and call are single words : the destination is the address of the instruction
+    plus the signed {K7} of the DST/SRC0 field (see OPLJ_JUMP).
+*/
+#define OPT_MAXEXT 3
+#define OPT_NONE (-1)
+#define OPT_ALLREGS ((1u << RegNoneK) - 1u)
+
+#define JUMP_K7_MIN (-64)
+#define JUMP_K7_MAX 63
+
+/* signed {K7} offset of jump, banz and call */
+static int32_t jump_offset (uint32_t instruction)
+{   return ((int32_t)RD(instruction, OP_SRC0_INST) ^ 0x40) - 0x40;
+}
+
+typedef struct 
+{   uint32_t w[1 + OPT_MAXEXT];     /* instruction and extension words */
+    uint32_t nbw;                   /* number of words */
+    uint32_t pc;                    /* position in the original code */
+    int32_t  target;                /* index of the jump destination, or OPT_NONE */
+    int32_t  konst[3];              /* index of the extension word of SRC0/1/2 constants, or OPT_NONE */
+    uint8_t  removed, leader;
+} opt_inst_t;
+
+static opt_inst_t opt_code[AVG_SCRIPT_LEN];
+
+/* number of extension words of a register field, OPT_NONE when unknown */
+static int opt_field_ext (uint32_t field)
+{   uint32_t reg = RD(field, REG_INDEX), ab = RD(field, AB_FIELD);
+
+    if (reg == RegNoneK) return (ab == K_INT32 || ab == K_FP32) ? 1 : 0;
+    return (ab == 3) ? 1 : 0;       /* stack[K] and P[K32] */
+}
+
+static int opt_is_reg (uint32_t field)   /* plain register access R0..R13 */
+{   return RD(field, REG_INDEX) < RegNoneK && RD(field, AB_FIELD) == 0 && RD(field, C_FIELD) == 0;
+}
+
+static int opt_is_stack (uint32_t field)
+{   return RD(field, REG_INDEX) == Stack;
+}
+
+static int opt_is_pop_push (uint32_t field)  /* top of stack with post-increment/decrement */
+{   return opt_is_stack(field) && RD(field, AB_FIELD) == 0 && RD(field, C_FIELD) == 1;
+}
+
+static int opt_is_vector (uint32_t opar)
+{   return opar == OPAR_VCOPY || opar == OPAR_VADD || (opar >= OPAR_VMUL && opar <= OPAR_VSCALE);
+}
+
+/* decode one instruction, returns 0 when the format of the extension words is unknown */
+static int opt_decode (uint32_t *code, uint32_t pc, uint32_t codesize, opt_inst_t *X)
+{   uint32_t opcode, opar, cond, i, field[3];
+    int n;
+
+    memset(X, 0, sizeof(opt_inst_t));
+    X->pc = pc;
+    X->target = OPT_NONE;
+    X->konst[0] = X->konst[1] = X->konst[2] = OPT_NONE;
+    X->w[0] = code[pc];
+    X->nbw = 1;
+
+    cond   = RD(X->w[0], OP_COND_INST);
+    opcode = RD(X->w[0], OP_INST);
+    opar   = RD(X->w[0], OP_OPAR_INST);
+    field[0] = RD(X->w[0], OP_SRC0_INST);
+    field[1] = RD(X->w[0], OP_SRC1_INST);
+    field[2] = RD(X->w[0], OP_SRC2_INST);
+
+    if (cond >= NO_COND_EXE_PACK)
+    {   return 0;
+    }
+
+    if (opcode == OP_SETJUMP)
+    {   switch (opar)
+        {
+        case OPLJ_JUMP: case OPLJ_BANZ: case OPLJ_CALL:
+            X->target = (int32_t)pc + jump_offset(X->w[0]);     /* code position, translated later */
+            return 1;
+        case OPLJ_RETURN: case OPLJ_SAVE: case OPLJ_RESTORE: case OPLJ_SYSCALL:
+            return 1;
+        default: 
+            return 0;
+        }
+    }
+
+    if (opar == OPAR_WR2BF || opar == OPAR_RDBF)
+    {   return 0;
+    }
+    if (opt_is_vector(opar))                    /* vector length */
+    {   if (pc + 1 >= codesize) return 0;
+        X->w[X->nbw++] = code[pc + 1];
+        return 1;
+    }
+
+    if (opar == OPAR_SQRT || opar == OPAR_LOG10) /* SRC2 is a function code */
+    {   field[2] = 0;
+    }
+    for (i = 3; i > 0; i--)                     /* SRC2, SRC1, SRC0 */
+    {   n = opt_field_ext(field[i-1]);
+        if (n)
+        {   if (pc + X->nbw >= codesize) return 0;
+            if (RD(field[i-1], REG_INDEX) == RegNoneK && RD(field[i-1], AB_FIELD) == K_INT32)
+            {   X->konst[i-1] = X->nbw;
+            }
+            X->w[X->nbw] = code[pc + X->nbw];
+            X->nbw++;
+        }
+    }
+    return 1;
+}
+
+/* registers read and written by the instruction, barrier = 1 when all the registers are concerned */
+static void opt_regs (opt_inst_t *X, uint32_t *rd, uint32_t *wr, int *barrier)
+{   uint32_t opcode, opar, i, field[3];
+
+    opcode = RD(X->w[0], OP_INST);
+    opar   = RD(X->w[0], OP_OPAR_INST);
+    field[0] = RD(X->w[0], OP_SRC0_INST);
+    field[1] = RD(X->w[0], OP_SRC1_INST);
+    field[2] = RD(X->w[0], OP_SRC2_INST);
+    *rd = *wr = 0;
+    *barrier = 0;
+
+    if (opcode == OP_SETJUMP)
+    {   if (RD(X->w[0], OP_OPAR_INST) == OPLJ_RESTORE)
+        {   for (i = 0; i < 3; i++) if (RD(field[i], REG_INDEX) < RegNoneK) *wr |= 1u << RD(field[i], REG_INDEX);
+        } 
+        else 
+        {   for (i = 0; i < 3; i++) if (RD(field[i], REG_INDEX) < RegNoneK) *rd |= 1u << RD(field[i], REG_INDEX);
+        }
+        if (opar == OPLJ_CALL || opar == OPLJ_SYSCALL || opar == OPLJ_RETURN || opar == OPLJ_JUMP || opar == OPLJ_BANZ)
+        {   *barrier = 1;
+        }
+        return;
+    }
+    if (opt_is_vector(opar) || opar == OPAR_SWAP || opar == OPAR_SCATTER || opar == OPAR_GATHER)
+    {   *barrier = 1;
+        return;
+    }
+    for (i = 0; i < 3; i++)
+    {   if (RD(field[i], REG_INDEX) >= RegNoneK) continue;
+        if (i == 2 && (opar == OPAR_SQRT || opar == OPAR_LOG10)) continue;
+        if (0 == opt_is_reg(field[i]))                  /* pointer : memory access */
+        {   *barrier = 1;
+            return;
+        }
+        if (i == 0 && opcode == OP_ALU) *wr |= 1u << RD(field[i], REG_INDEX);
+        else                            *rd |= 1u << RD(field[i], REG_INDEX);
+    }
+}
+
+/* constant value of a source operand */
+static int opt_source (opt_inst_t *X, uint32_t ifield, int32_t *known, uint32_t knownmask, int32_t *value)
+{   uint32_t field = (ifield == 1) ? RD(X->w[0], OP_SRC1_INST) : RD(X->w[0], OP_SRC2_INST);
+    uint32_t reg = RD(field, REG_INDEX);
+
+    if (X->konst[ifield] != OPT_NONE)      { *value = (int32_t)(X->w[X->konst[ifield]]); return 1; }
+    if (reg == RegNoneK && RD(field, AB_FIELD) == 0) { *value = 0; return 1; }
+    if (opt_is_reg(field) && (knownmask & (1u << reg))) { *value = known[reg]; return 1; }
+    return 0;
+}
+
+static int opt_fold (uint32_t opar, int32_t a, int32_t b, int32_t *r)
+{
+    switch (opar)
+    {
+    case OPAR_NOP:    *r = a; break;
+    case OPAR_ADD:    *r = (int32_t)((uint32_t)a + (uint32_t)b); break;
+    case OPAR_SUB:    *r = (int32_t)((uint32_t)a - (uint32_t)b); break;
+    case OPAR_MUL:    *r = (int32_t)((uint32_t)a * (uint32_t)b); break;
+    case OPAR_DIV:    *r = (b == 0) ? 0 : a / b; break;
+    case OPAR_MOD:    *r = (b == 0) ? 0 : a % b; break;
+    case OPAR_LRSHFT: *r = (int32_t)((uint32_t)a >> (31 & b)); break;
+    case OPAR_OR:     *r = a | b; break;
+    case OPAR_NOR:    *r = ~(a | b); break;
+    case OPAR_AND:    *r = a & b; break;
+    case OPAR_XOR:    *r = a ^ b; break;
+    case OPAR_MAX:    *r = MAX(a, b); break;
+    case OPAR_MIN:    *r = MIN(a, b); break;
+    case OPAR_ABS:    *r = (a < 0) ? -a : a; break;
+    default: return 0;
+    }
+    return 1;
+}
+
+/* next instruction not removed */
+static int32_t opt_next (uint32_t ninst, int32_t i)
+{   for (i = i + 1; i < (int32_t)ninst; i++) 
+    {   if (0 == opt_code[i].removed) return i;
+    }
+    return OPT_NONE;
+}
+
+/* the removed instructions are replaced by the next one */
+static int32_t opt_resolve (uint32_t ninst, int32_t i)
+{   if (i == OPT_NONE || i >= (int32_t)ninst) return OPT_NONE;
+    return (opt_code[i].removed) ? opt_next(ninst, i) : i;
+}
+
+static int opt_is_jump (opt_inst_t *X)     /* plain jump without register save */
+{   return RD(X->w[0], OP_INST) == OP_SETJUMP && RD(X->w[0], OP_OPAR_INST) == OPLJ_JUMP &&
+           RD(RD(X->w[0], OP_SRC1_INST), REG_INDEX) >= RegNoneK && RD(RD(X->w[0], OP_SRC2_INST), REG_INDEX) >= RegNoneK;
+}
+
+/* load of a constant : DST = K */
+static void opt_load_constant (opt_inst_t *X, int32_t K)
+{   uint32_t w0 = X->w[0], field = 0;
+
+    ST(w0, OP_OPAR_INST, OPAR_NOP);
+    ST(field, REG_INDEX, RegNoneK); ST(field, AB_FIELD, K_INT32);
+    ST(w0, OP_SRC1_INST, field);
+    field = 0; ST(field, REG_INDEX, RegNoneK);
+    ST(w0, OP_SRC2_INST, field);
+    X->w[0] = w0;
+    X->w[1] = (uint32_t)K;
+    X->nbw = 2;
+    X->konst[0] = X->konst[2] = OPT_NONE;
+    X->konst[1] = 1;
+}
+
+void stream_tool_script_optimize(struct stream_graph_linkedlist *graph, struct stream_script *script)
+{   uint32_t codesize, pc, ninst, i, j, nbw_before, nbw_after, iteration, changed;
+    int32_t t;
+    uint32_t new_program[AVG_SCRIPT_LEN];
+    char new_comments[AVG_SCRIPT_LEN][NBCHAR_LINE];
+    uint32_t new_pos[AVG_SCRIPT_LEN];
+
+    codesize = (script->script_nb_code) ? script->script_nb_code : script->script_nb_instruction;
+    if (codesize == 0 || codesize > AVG_SCRIPT_LEN)
+    {   return;
+    }
+
+    /* decode, translate the jump positions to instruction indexes */
+    for (pc = ninst = 0; pc < codesize; ninst++)
+    {   if (0 == opt_decode(script->script_program, pc, codesize, &(opt_code[ninst])))
+        {   fprintf(graph->ptf_debug, "\n script %d : not optimized (instruction %d) \n", script->script_ID, pc);
+            return;
+        }
+        pc += opt_code[ninst].nbw;
+    }
+    for (i = 0; i < ninst; i++)
+    {   if (opt_code[i].target == OPT_NONE) continue;
+        for (j = 0; j < ninst; j++) 
+        {   if ((int32_t)opt_code[j].pc == opt_code[i].target) break;
+        }
+        if (j == ninst)
+        {   fprintf(graph->ptf_debug, "\n script %d : not optimized (jump at %d) \n", script->script_ID, opt_code[i].pc);
+            return;
+        }
+        opt_code[i].target = j;
+    }
+    nbw_before = codesize;
+
+    for (iteration = 0, changed = 1; changed && iteration < 8; iteration++)
+    {   changed = 0;
+
+        /* leaders : first instruction, jump destinations, return addresses, code labels */
+        for (i = 0; i < ninst; i++) opt_code[i].leader = 0;
+        opt_code[0].leader = 1;
+        for (i = 0; i < ninst; i++)
+        {   if (opt_code[i].removed) continue;
+            t = opt_resolve(ninst, opt_code[i].target);
+            if (t != OPT_NONE) opt_code[t].leader = 1;
+            if (RD(opt_code[i].w[0], OP_INST) == OP_SETJUMP && 
+                (RD(opt_code[i].w[0], OP_OPAR_INST) == OPLJ_CALL || RD(opt_code[i].w[0], OP_OPAR_INST) == OPLJ_SYSCALL || 
+                 RD(opt_code[i].w[0], OP_COND_INST) != NO_COND_EXE))
+            {   t = opt_next(ninst, i);
+                if (t != OPT_NONE) opt_code[t].leader = 1;
+            }
+        }
+        for (j = 0; j < script->idx_label; j++)
+        {   if (script->Label_positions[j].label_type != LABEL_CODE_DECLARE) continue;
+            for (i = 0; i < ninst; i++) 
+            {   if ((int32_t)opt_code[i].pc == script->Label_positions[j].offset) 
+                {   t = opt_resolve(ninst, i); 
+                    if (t != OPT_NONE) opt_code[t].leader = 1;
+                }
+            }
+        }
+
+        /* jump threading and jumps to the next instruction */
+        for (i = 0; i < ninst; i++)
+        {   uint32_t hop;
+            if (opt_code[i].removed || opt_code[i].target == OPT_NONE) continue;
+            opt_code[i].target = opt_resolve(ninst, opt_code[i].target);
+            for (hop = 0; hop < ninst; hop++)
+            {   t = opt_code[i].target;
+                if (t == OPT_NONE || t == (int32_t)i || 0 == opt_is_jump(&(opt_code[t])) || 
+                    RD(opt_code[t].w[0], OP_COND_INST) != NO_COND_EXE) break;
+                t = opt_resolve(ninst, opt_code[t].target);
+                if (t == opt_code[i].target || t == OPT_NONE) break;
+                if ((int32_t)opt_code[t].pc - (int32_t)opt_code[i].pc < JUMP_K7_MIN || 
+                    (int32_t)opt_code[t].pc - (int32_t)opt_code[i].pc > JUMP_K7_MAX) break;
+                opt_code[i].target = t; changed = 1;
+            }
+            if (opt_is_jump(&(opt_code[i])) && opt_code[i].target == opt_next(ninst, i) && opt_code[i].target != OPT_NONE)
+            {   opt_code[i].removed = 1; changed = 1;
+            }
+        }
+
+        /* unreachable code after an unconditional jump or return */
+        for (i = 0; i < ninst; i++)
+        {   uint32_t opar = RD(opt_code[i].w[0], OP_OPAR_INST);
+            if (opt_code[i].removed || RD(opt_code[i].w[0], OP_INST) != OP_SETJUMP ||
+                RD(opt_code[i].w[0], OP_COND_INST) != NO_COND_EXE || (opar != OPLJ_JUMP && opar != OPLJ_RETURN)) continue;
+            for (j = i + 1; j < ninst && 0 == opt_code[j].leader; j++)
+            {   if (0 == opt_code[j].removed) { opt_code[j].removed = 1; changed = 1; }
+            }
+        }
+
+        /* constant folding and propagation in the basic blocks */
+        {   int32_t known[RegNoneK], a, b, r;
+            uint32_t knownmask = 0, rd, wr, opar, dst, cond;
+            int barrier;
+
+            for (i = 0; i < ninst; i++)
+            {   opt_inst_t *X = &(opt_code[i]);
+                if (X->removed) continue;
+                if (X->leader) knownmask = 0;
+
+                opt_regs(X, &rd, &wr, &barrier);
+                opar = RD(X->w[0], OP_OPAR_INST);
+                cond = RD(X->w[0], OP_COND_INST);
+                dst = RD(RD(X->w[0], OP_SRC0_INST), REG_INDEX);
+
+                if (barrier) { knownmask = 0; continue; }
+                if (RD(X->w[0], OP_INST) != OP_ALU || wr == 0) { knownmask &= ~wr; continue; }
+
+                if (opt_source(X, 1, known, knownmask, &a) && opt_source(X, 2, known, knownmask, &b) && opt_fold(opar, a, b, &r))
+                {   if ((knownmask & wr) && known[dst] == r)            /* value already in the register */
+                    {   X->removed = 1; changed = 1;
+                        continue;
+                    }
+                    if (X->nbw > 2 || (X->nbw == 2 && opar != OPAR_NOP))
+                    {   opt_load_constant(X, r); changed = 1;
+                    }
+                    if (cond == NO_COND_EXE) { known[dst] = r; knownmask |= wr; }
+                    else                     { knownmask &= ~wr; }
+                }
+                else
+                {   knownmask &= ~wr;
+                    /* r = r (self move) */
+                    if (opar == OPAR_NOP && opt_is_reg(RD(X->w[0], OP_SRC1_INST)) && RD(RD(X->w[0], OP_SRC1_INST), REG_INDEX) == dst)
+                    {   X->removed = 1; changed = 1;
+                    }
+                }
+            }
+        }
+
+        /* dead stores, backward in the basic blocks, all registers are alive at the end of the blocks */
+        {   uint32_t live = OPT_ALLREGS, rd, wr, field0, field1, field2;
+            int barrier;
+
+            for (t = (int32_t)ninst - 1; t >= 0; t--)
+            {   opt_inst_t *X = &(opt_code[t]);
+                if (X->removed) continue;
+                opt_regs(X, &rd, &wr, &barrier);
+                field0 = RD(X->w[0], OP_SRC0_INST); 
+                field1 = RD(X->w[0], OP_SRC1_INST); 
+                field2 = RD(X->w[0], OP_SRC2_INST);
+
+                if (barrier || RD(X->w[0], OP_INST) == OP_SETJUMP)
+                {   live = OPT_ALLREGS;
+                } 
+                else if (RD(X->w[0], OP_INST) == OP_ALU && wr != 0 && 0 == (live & wr) &&
+                    0 == opt_is_stack(field1) && 0 == opt_is_stack(field2))
+                {   X->removed = 1; changed = 1;
+                    continue;
+                }
+                else
+                {   if (RD(X->w[0], OP_COND_INST) == NO_COND_EXE) live &= ~wr;
+                    live |= rd;
+                    if (opt_is_stack(field0) || opt_is_stack(field1) || opt_is_stack(field2)) live |= rd;
+                }
+                if (X->leader) live = OPT_ALLREGS;
+            }
+        }
+
+        /* "push = rX" followed by "rY = pop" : rY = rX */
+        for (i = 0; i < ninst; i++)
+        {   opt_inst_t *X = &(opt_code[i]), *Y;
+            if (X->removed || RD(X->w[0], OP_INST) != OP_ALU || RD(X->w[0], OP_COND_INST) != NO_COND_EXE ||
+                RD(X->w[0], OP_OPAR_INST) != OPAR_NOP || 0 == opt_is_pop_push(RD(X->w[0], OP_SRC0_INST)) ||
+                0 == opt_is_reg(RD(X->w[0], OP_SRC1_INST)) || X->nbw != 1) continue;
+            t = opt_next(ninst, i);
+            if (t == OPT_NONE) continue;
+            Y = &(opt_code[t]);
+            if (Y->leader || RD(Y->w[0], OP_INST) != OP_ALU || RD(Y->w[0], OP_COND_INST) != NO_COND_EXE ||
+                RD(Y->w[0], OP_OPAR_INST) != OPAR_NOP || 0 == opt_is_pop_push(RD(Y->w[0], OP_SRC1_INST)) ||
+                0 == opt_is_reg(RD(Y->w[0], OP_SRC0_INST)) || Y->nbw != 1) continue;
+
+            ST(Y->w[0], OP_SRC1_INST, RD(X->w[0], OP_SRC1_INST));
+            X->removed = 1; changed = 1;
+            if (RD(Y->w[0], OP_SRC0_INST) == RD(Y->w[0], OP_SRC1_INST))
+            {   Y->removed = 1;
+            }
+        }
+    }
+
+    /* new positions, jump offsets, labels, parameters after the code */
+    for (i = pc = 0; i < ninst; i++)
+    {   new_pos[i] = pc;
+        if (0 == opt_code[i].removed) pc += opt_code[i].nbw;
+    }
+    nbw_after = pc;
+
+    for (i = 0; i < ninst; i++)
+    {   opt_inst_t *X = &(opt_code[i]);
+        if (X->removed) continue;
+        if (X->target != OPT_NONE)
+        {   int32_t K;
+            t = opt_resolve(ninst, X->target);
+            K = (t == OPT_NONE) ? (int32_t)(nbw_after - new_pos[i]) : (int32_t)(new_pos[t] - new_pos[i]);
+            if (K < JUMP_K7_MIN || K > JUMP_K7_MAX)
+            {   fprintf(graph->ptf_debug, "\n script %d : not optimized (jump at %d) \n", script->script_ID, X->pc);
+                return;
+            }
+            ST(X->w[0], OP_SRC0_INST, K);
+        }
+        for (j = 0; j < X->nbw; j++)
+        {   new_program[new_pos[i] + j] = X->w[j];
+            strcpy(new_comments[new_pos[i] + j], script->script_comments[X->pc + j]);
+        }
+    }
+
+    for (j = 0; j < script->idx_label; j++)
+    {   labelPos_t *L = &(script->Label_positions[j]);
+        if (L->label_type == LABEL_CODE_DECLARE || L->label_type == LABEL_CODE_USE)
+        {   for (i = 0; i < ninst; i++) 
+            {   if ((int32_t)opt_code[i].pc == L->offset) break;
+            }
+            t = opt_resolve(ninst, i);
+            L->offset = (t == OPT_NONE) ? nbw_after : new_pos[t];
+        }
+        if (L->label_type == LABEL_PARAM_USE || L->label_type == LABEL_HEAP_USE || L->label_type == LABEL_GRAPH_USE)
+        {   if (L->offset >= (int32_t)codesize) L->offset -= codesize - nbw_after;
+        }
+    }
+
+    memcpy(script->script_program, new_program, nbw_after * sizeof(uint32_t));
+    memcpy(script->script_comments, new_comments, nbw_after * NBCHAR_LINE);
+    memmove(&(script->script_program[nbw_after]), &(script->script_program[codesize]), 
+        (script->script_nb_instruction - codesize) * sizeof(uint32_t));
+    script->script_nb_instruction -= codesize - nbw_after;
+    script->script_nb_code = nbw_after;
+
+    for (i = j = 0; i < ninst; i++) if (0 == opt_code[i].removed) j++;
+    fprintf(graph->ptf_debug, "\n script %d : %d instructions %d words before optimization, %d instructions %d words after \n", 
+        script->script_ID, ninst, nbw_before, j, nbw_after);
+}
+
+
 /* ====================================================================================   
     Read and pack the macro assembler
 
@@ -507,6 +979,19 @@ void stream_tool_read_code(char **pt_line, struct stream_platform_manifest *plat
                             struct stream_graph_linkedlist *graph, 
                             struct stream_script *script)
 {
+    /* the mnemonic assembler below is not updated to the current instruction layout : the
+        code, parameters and heap are skipped up to "end" and the script stays empty, the byte 
+        codes are given in hexadecimal with "script_assembler" */
+    jump2next_valid_line(pt_line);                  // remove   "script_code"
+    while (globalEndFile != FOUND_END_OF_FILE)
+    {   jump2next_valid_line(pt_line);
+    }
+    if ('\0' != **pt_line)
+    {   jump2next_valid_line(pt_line);              // remove   "end"
+    }
+    fprintf(graph->ptf_debug, "\n script %d : mnemonic code not assembled, use script_assembler \n", script->script_ID);
+    return;
+
 //    char s[cNFIELDS][cASM], *pdbg, dbg;
 //    uint32_t INST[INST_WORDS], nWord;
 //    uint8_t thereIsHash, thereAreBrackets, thereAreVerticals, thereIsLoad, thereIsTest;
@@ -985,6 +1470,374 @@ void stream_tool_read_code(char **pt_line, struct stream_platform_manifest *plat
 }
 
 
+/* ====================================================================================   
+    Ahead-of-time translation of the byte codes to C  (script_assembler 1 = SCRIPT_FORMAT_NATIVE_C)
+
+    Each instruction becomes a C statement working on the same register file and stack than
+    arm_stream_script_interpreter() : I->REGS[], I->SP, I->test_flag. Jumps are translated
+    to "goto", calls push the return address on the stack and "return" uses a switch on the 
+    list of return addresses. The jumps are decoded like in the virtual machine : single word,
+    destination = address of the instruction + signed {K7} of the DST/SRC0 field. A destination
+    outside of the code, or inside the extension words of an instruction, leaves the script 
+    interpreted. Only the code is translated (script_nb_code), the parameters follow it.
+    Scripts using instructions without C translation (pointers, syscall, float constants, 
+    packed formats) get a null entry in arm_stream_script_native[] and remain interpreted.
+*/
+
+#define AOT_READ  0
+#define AOT_WRITE 1
+
+typedef struct 
+{   FILE *ptf;                          /* 0 during the first pass (labels and checks) */
+    uint32_t *code;
+    uint32_t codesize;
+    uint32_t pc;                        /* read index of the extension words */
+    uint32_t npop, npush;               /* stack accesses of the instruction */
+    uint8_t start[AVG_SCRIPT_LEN];      /* 1 : first word of an instruction */
+    uint8_t target[AVG_SCRIPT_LEN];     /* 1 : the instruction is a jump destination */
+    uint8_t retaddr[AVG_SCRIPT_LEN];    /* 1 : the instruction is a return address */
+} aot_script_t;
+
+static void aot_print (aot_script_t *A, const char *format, ...)
+{   va_list args;
+    if (A->ptf)
+    {   va_start(args, format);
+        vfprintf(A->ptf, format, args);
+        va_end(args);
+    }
+}
+
+/* 
+    C expression of a register field, extension words are read from right to left (SRC2, SRC1, SRC0)
+    returns 0 when the operand has no translation
+*/
+static int aot_operand (aot_script_t *A, char *text, uint32_t field, uint32_t R0W1)
+{   uint32_t reg, ab, c;
+
+    reg = RD(field, REG_INDEX);
+    ab  = RD(field, AB_FIELD);
+    c   = RD(field, C_FIELD);
+
+    if (reg < RegNoneK)                             /* R0 .. R13, pointer accesses are interpreted */
+    {   if (ab != 0 || c != 0) return 0;
+        sprintf(text, "R(%d)", reg);
+        return 1;
+    }
+    if (reg == RegNoneK)                            /* constant or null register */
+    {   if (R0W1 == AOT_WRITE) 
+        {   return 0;
+        }
+        if (ab == K_FP32)
+        {   return 0;                               /* float constants are interpreted */
+        }
+        if (ab == K_INT32)
+        {   if (A->pc >= A->codesize) return 0;
+            sprintf(text, "(int32_t)0x%08X", A->code[A->pc++]);
+            return 1;
+        }
+        sprintf(text, "0");
+        return 1;
+    }
+                                                    /* stack : top, pop/push, stack[K] */
+    if (ab == 3)
+    {   if (c != 0 || A->pc >= A->codesize) return 0;
+        sprintf(text, "STK(%d)", A->code[A->pc++]);
+        return 1;
+    }
+    if (ab != 0) 
+    {   return 0;
+    }
+    if (c == 0)
+    {   sprintf(text, "STK(0)");
+    }
+    else if (R0W1 == AOT_READ)
+    {   sprintf(text, "POP()");   A->npop++;
+    }
+    else
+    {   sprintf(text, "PUSH()");  A->npush++;
+    }
+    return 1;
+}
+
+/* 
+    C expression of the ALU operators 
+*/
+static int aot_alu (char *text, uint32_t opar)
+{
+    switch (opar)
+    {
+    case OPAR_NOP:    sprintf(text, "s1"); break;
+    case OPAR_ADD:    sprintf(text, "s1 + s2"); break;
+    case OPAR_SUB:    sprintf(text, "s1 - s2"); break;
+    case OPAR_MUL:    sprintf(text, "s1 * s2"); break;
+    case OPAR_DIV:    sprintf(text, "(s2 == 0) ? 0 : s1 / s2"); break;
+    case OPAR_MOD:    sprintf(text, "(s2 == 0) ? 0 : s1 %% s2"); break;
+    case OPAR_LRSHFT: sprintf(text, "(int32_t)((uint32_t)s1 >> (31 & s2))"); break;
+    case OPAR_OR:     sprintf(text, "s1 | s2"); break;
+    case OPAR_NOR:    sprintf(text, "~(s1 | s2)"); break;
+    case OPAR_AND:    sprintf(text, "s1 & s2"); break;
+    case OPAR_XOR:    sprintf(text, "s1 ^ s2"); break;
+    case OPAR_MAX:    sprintf(text, "MAX(s1, s2)"); break;
+    case OPAR_MIN:    sprintf(text, "MIN(s1, s2)"); break;
+    case OPAR_ABS:    sprintf(text, "(s1 < 0) ? -s1 : s1"); break;
+    default: return 0;
+    }
+    return 1;
+}
+
+/* 
+    jump destination = address of the instruction + signed {K7}, the destination must be the 
+    first word of an instruction : checked during the first pass when all the instructions are
+    decoded, and again during the second pass
+*/
+static int aot_label (aot_script_t *A, uint32_t pc0, uint32_t instruction, uint32_t *label)
+{   int32_t K;
+
+    K = (int32_t)pc0 + jump_offset(instruction);
+    if (K < 0 || K >= (int32_t)A->codesize) return 0;
+    if (A->ptf && 0 == A->start[K]) return 0;
+    *label = (uint32_t)K;
+    return 1;
+}
+
+/* 
+    translation of the instruction at A->pc, returns 0 when there is no C translation 
+*/
+static int aot_instruction (aot_script_t *A)
+{   uint32_t instruction, pc0, cond, opcode, opar, label, field[3], i;
+    char s0[NBCHAR_LINE], s1[NBCHAR_LINE], s2[NBCHAR_LINE], alu[NBCHAR_LINE];
+    static const char *test[] = { "==", "<=", "<", "!=", ">=", ">" };
+
+    pc0 = A->pc;
+    A->start[pc0] = 1;
+    instruction = A->code[A->pc++];
+    cond   = RD(instruction, OP_COND_INST);
+    opcode = RD(instruction, OP_INST);
+    opar   = RD(instruction, OP_OPAR_INST);
+    field[0] = RD(instruction, OP_SRC0_INST);
+    field[1] = RD(instruction, OP_SRC1_INST);
+    field[2] = RD(instruction, OP_SRC2_INST);
+    A->npop = A->npush = 0;
+
+    if (cond == NO_COND_EXE_PACK || cond == IF_YES_PACK || cond == IF_NOT_PACK)
+    {   return 0;
+    }
+
+    if (A->target[pc0])
+    {   aot_print(A, "L_%d:\n", pc0);
+    }
+    aot_print(A, "    /* %3d  %08X */ ", pc0, instruction);
+    if (cond == IF_YES) { aot_print(A, "if (I->test_flag == TEST_OK) "); }
+    if (cond == IF_NOT) { aot_print(A, "if (I->test_flag == TEST_KO) "); }
+
+    /* ------------------------------------------------------------ OP_TESTxx  */
+    if (opcode <= OP_TESTGT)
+    {   if (0 == aot_operand(A, s2, field[2], AOT_READ)) return 0;
+        if (0 == aot_operand(A, s1, field[1], AOT_READ)) return 0;
+        if (0 == aot_operand(A, s0, field[0], AOT_READ)) return 0;
+        if (0 == aot_alu(alu, opar)) return 0;
+
+        aot_print(A, "{   int32_t s0, s1, s2, t; ");
+        if (A->npop) aot_print(A, "CHECK_POP(%d) ", A->npop);
+        aot_print(A, "s2 = %s; s1 = %s; s0 = %s; t = (s0 %s (%s)); ", s2, s1, s0, test[opcode], alu);
+        if (opar == OPAR_NOP || opar == OPAR_ABS) aot_print(A, "(void)s2; ");
+        if (cond == AND_IF)         aot_print(A, "I->test_flag = (uint8_t)(I->test_flag && t); }\n");
+        else if (cond == OR_IF)     aot_print(A, "I->test_flag = (uint8_t)(I->test_flag || t); }\n");
+        else                        aot_print(A, "I->test_flag = (uint8_t)t; }\n");
+        return 1;
+    }
+
+    if (cond == AND_IF || cond == OR_IF)
+    {   return 0;
+    }
+
+    /* ------------------------------------------------------------ OP_ALU  */
+    if (opcode == OP_ALU)
+    {   if (opar == OPAR_SWAP)
+        {   if (RD(field[0], REG_INDEX) >= RegNoneK || RD(field[1], REG_INDEX) >= RegNoneK) return 0;
+            aot_print(A, "{   regdata_t t = I->REGS[%d]; I->REGS[%d] = I->REGS[%d]; I->REGS[%d] = t; }\n",
+                RD(field[0], REG_INDEX), RD(field[0], REG_INDEX), RD(field[1], REG_INDEX), RD(field[1], REG_INDEX));
+            return 1;
+        }
+        if (0 == aot_operand(A, s2, field[2], AOT_READ)) return 0;
+        if (0 == aot_operand(A, s1, field[1], AOT_READ)) return 0;
+        if (0 == aot_operand(A, s0, field[0], AOT_WRITE)) return 0;
+        if (0 == aot_alu(alu, opar)) return 0;
+
+        aot_print(A, "{   int32_t s1, s2; ");
+        if (A->npop)  aot_print(A, "CHECK_POP(%d) ", A->npop);
+        aot_print(A, "s2 = %s; s1 = %s; ", s2, s1);
+        if (opar == OPAR_NOP || opar == OPAR_ABS) aot_print(A, "(void)s2; ");
+        if (A->npush) aot_print(A, "CHECK_PUSH(%d) ", A->npush);
+        aot_print(A, "%s = %s; }\n", s0, alu);
+        return 1;
+    }
+
+    /* ------------------------------------------------------------ OP_SETJUMP  */
+    switch (opar)
+    {
+    case OPLJ_JUMP:
+        if (0 == aot_label(A, pc0, instruction, &label)) return 0;
+        A->target[label] = 1;
+        aot_print(A, "{   ");
+        for (i = 1; i < 3; i++)                             /* optional register save */
+        {   if (RD(field[i], REG_INDEX) < RegNoneK) 
+            {   aot_print(A, "CHECK_PUSH(1) PUSH() = R(%d); ", RD(field[i], REG_INDEX));
+            }
+        }
+        if (label <= pc0)   
+        {   aot_print(A, "CHECK_CYCLES ");                  /* loops are controlled like in the VM */
+        }
+        aot_print(A, "goto L_%d; }\n", label);
+        return 1;
+
+    case OPLJ_BANZ:                                         /* the loop counter is SRC1 */
+        if (RD(field[1], REG_INDEX) >= RegNoneK) return 0;
+        if (0 == aot_label(A, pc0, instruction, &label)) return 0;
+        A->target[label] = 1;
+        aot_print(A, "{   R(%d)--; if (R(%d) != 0) { ", RD(field[1], REG_INDEX), RD(field[1], REG_INDEX));
+        if (label <= pc0)   
+        {   aot_print(A, "CHECK_CYCLES ");
+        }
+        aot_print(A, "goto L_%d; } }\n", label);
+        return 1;
+
+    case OPLJ_CALL:                                         /* register saves would be popped by "return" */
+        if (RD(field[1], REG_INDEX) < RegNoneK || RD(field[2], REG_INDEX) < RegNoneK) return 0;
+        if (0 == aot_label(A, pc0, instruction, &label)) return 0;
+        if (A->pc >= A->codesize) return 0;
+        A->target[label] = 1;
+        A->target[A->pc] = 1;
+        A->retaddr[A->pc] = 1;
+        aot_print(A, "{   CHECK_PUSH(1) PUSH() = %d; CHECK_CYCLES goto L_%d; }\n", A->pc, label);
+        return 1;
+
+    case OPLJ_RETURN:
+        aot_print(A, "{   if (I->SP == I->nregs) return; goto L_return; }\n");
+        return 1;
+
+    case OPLJ_SAVE:
+        aot_print(A, "{   ");
+        for (i = 0; i < 3; i++)
+        {   if (RD(field[i], REG_INDEX) < RegNoneK) 
+            {   aot_print(A, "CHECK_PUSH(1) PUSH() = R(%d); ", RD(field[i], REG_INDEX));
+            }
+        }
+        aot_print(A, "}\n");
+        return 1;
+
+    case OPLJ_RESTORE:
+        aot_print(A, "{   ");
+        for (i = 3; i > 0; i--)                             /* reverse order of the save */
+        {   if (RD(field[i-1], REG_INDEX) < RegNoneK) 
+            {   aot_print(A, "CHECK_POP(1) R(%d) = POP(); ", RD(field[i-1], REG_INDEX));
+            }
+        }
+        aot_print(A, "}\n");
+        return 1;
+
+    default:                                                /* setreg, setptr, syscall, delete .. */
+        return 0;
+    }
+}
+
+
+/* ====================================================================================   
+    Generates the C translation of the scripts declared with "script_assembler 1"
+
+    static void script_native_N (arm_script_instance_t *I) { .. }
+    const p_script_native arm_stream_script_native[] = { .. };
+
+    The file is compiled with the graph when PLATFORM_SCRIPT_NATIVE is defined
+*/
+void stream_tool_script_to_c(struct stream_graph_linkedlist *graph, FILE *ptf)
+{   uint32_t iscript, i, label;
+    struct stream_script *pscript;
+    static aot_script_t A;
+    uint8_t native[1<<(SCRIPT_LW0_MSB-SCRIPT_LW0_LSB-1)];
+
+    fprintf(ptf, "//--------------------------------------\n"); 
+    fprintf(ptf, "//  AUTOMATICALLY GENERATED CODES\n"); 
+    fprintf(ptf, "//  DO NOT MODIFY !\n"); 
+    fprintf(ptf, "//--------------------------------------\n");
+    fprintf(ptf, "#include \"presets.h\"\n");
+    fprintf(ptf, "#ifdef CODE_ARM_STREAM_SCRIPT\n\n");
+    fprintf(ptf, "#include <stdint.h>\n");
+    fprintf(ptf, "#include \"stream_common_const.h\"\n");
+    fprintf(ptf, "#include \"stream_common_types.h\"\n");
+    fprintf(ptf, "#include \"arm_stream_script.h\"\n");
+    fprintf(ptf, "#include \"arm_stream_script_instructions.h\"\n\n");
+    fprintf(ptf, "#define R(n)   (I->REGS[n].v_i32[REGS_DATA])\n");
+    fprintf(ptf, "#define STK(k) (I->REGS[I->SP - 1 - (k)].v_i32[REGS_DATA])\n");
+    fprintf(ptf, "#define POP()  (I->REGS[--(I->SP)].v_i32[REGS_DATA])\n");
+    fprintf(ptf, "#define PUSH() (I->REGS[(I->SP)++].v_i32[REGS_DATA])\n");
+    fprintf(ptf, "#define CHECK_POP(n)  if (I->SP < I->nregs + (n)) { I->errors |= ERROR_STACK_UNDERFLOW; return; }\n");
+    fprintf(ptf, "#define CHECK_PUSH(n) if (I->SP + (n) > I->nregs + I->nstack) { I->errors |= ERROR_STACK_OVERFLOW; return; }\n");
+    fprintf(ptf, "#define CHECK_CYCLES  if (0 == --(I->cycles_downcounter)) { I->errors |= ERROR_TIME_UNDERFLOW; return; }\n\n");
+
+    for (iscript = 0; iscript < graph->nb_scripts; iscript++)
+    {   pscript = &(graph->all_scripts[iscript]);
+        native[iscript] = 0;
+
+        if (pscript->script_format != SCRIPT_FORMAT_NATIVE_C || pscript->script_nb_instruction == 0)
+        {   continue;
+        }
+
+        /* first pass : check all the instructions have a translation, find the labels */
+        memset(&A, 0, sizeof(A));
+        A.code = pscript->script_program;
+        A.codesize = (pscript->script_nb_code) ? pscript->script_nb_code : pscript->script_nb_instruction;
+        for (i = 0; A.pc < A.codesize; )
+        {   i = A.pc;
+            if (0 == aot_instruction(&A))
+            {   A.pc = A.codesize + 1;      /* translation failure */
+            }
+        }
+        for (label = 0; A.pc == A.codesize && label < A.codesize; label++)
+        {   if (A.target[label] && 0 == A.start[label])
+            {   i = label;                  /* jump in the middle of an instruction */
+                A.pc = A.codesize + 1;
+            }
+        }
+        if (A.pc > A.codesize)
+        {   fprintf(graph->ptf_debug, "\n script %d : no C translation for the instruction (or jump destination) %d, the script is interpreted \n", iscript, i);
+            fprintf(ptf, "/* script %d : interpreted, no C translation for the instruction (or jump destination) %d */\n\n", iscript, i);
+            pscript->script_format = SCRIPT_FORMAT_BYTECODE;
+            continue;
+        }
+
+        /* second pass : C code */
+        native[iscript] = 1;
+        A.ptf = ptf;
+        A.pc = 0;
+        fprintf(ptf, "static void script_native_%d (arm_script_instance_t *I)\n{\n", iscript);
+        while (A.pc < A.codesize)
+        {   aot_instruction(&A);
+        }
+        fprintf(ptf, "    return;\n");
+        fprintf(ptf, "L_return:\n");
+        fprintf(ptf, "    switch (I->REGS[--(I->SP)].v_i32[REGS_DATA])\n    {\n");
+        for (i = 0; i < A.codesize; i++)
+        {   if (A.retaddr[i]) 
+            {   fprintf(ptf, "    case %d: goto L_%d;\n", i, i);
+            }
+        }
+        fprintf(ptf, "    default: return;\n    }\n}\n\n");
+    }
+
+    fprintf(ptf, "const p_script_native arm_stream_script_native[] = \n{\n");
+    for (iscript = 0; iscript < graph->nb_scripts; iscript++)
+    {   if (native[iscript]) fprintf(ptf, "    script_native_%d,\n", iscript);
+        else                 fprintf(ptf, "    0,\n");
+    }
+    if (graph->nb_scripts == 0) 
+    {   fprintf(ptf, "    0,\n");
+    }
+    fprintf(ptf, "};\n\n");
+    fprintf(ptf, "const uint8_t arm_stream_script_nb_native = %d;\n\n", graph->nb_scripts);
+    fprintf(ptf, "#endif //CODE_ARM_STREAM_SCRIPT\n");
+}
+
 
 #ifdef __cplusplus
 }